@@ -33,6 +33,20 @@ void printAll(const std::vector<BinaryFunction *> &BinaryFunctions);
 double extTSPScore(uint64_t SrcAddr, uint64_t SrcSize, uint64_t DstAddr,
                    uint64_t Count);
 
+/// A data object placed by data reordering.
+struct DataObjectPlacement {
+  uint64_t InputAddress;
+  uint64_t OutputAddress;
+  uint64_t Size;
+  /// The number of sampled memory accesses to the object.
+  uint64_t Count;
+};
+
+/// Calculate metrics related to data cache and d-TLB performance of the
+/// objects in \p Objects, comparing their input and output placement.
+void printDataMetrics(const std::vector<DataObjectPlacement> &Objects,
+                      uint64_t CacheLineSize);
+
 } // namespace CacheMetrics
 } // namespace bolt
 } // namespace llvm
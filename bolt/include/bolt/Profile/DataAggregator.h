@@ -131,6 +131,15 @@ private:
   /// and use them later for processing and assigning profile.
   std::unordered_map<Trace, BranchInfo, TraceHash> BranchLBRs;
   std::unordered_map<Trace, FTInfo, TraceHash> FallthroughLBRs;
+
+  /// Branches and traces aggregated from a subset of the branch samples.
+  struct LBRAggregate {
+    std::unordered_map<Trace, BranchInfo, TraceHash> BranchLBRs;
+    std::unordered_map<Trace, FTInfo, TraceHash> FallthroughLBRs;
+    uint64_t NumTraces{0};
+    uint64_t NumInvalidTraces{0};
+    uint64_t NumLongRangeTraces{0};
+  };
   std::vector<AggregatedLBREntry> AggregatedLBRs;
   std::unordered_map<uint64_t, uint64_t> BasicSamples;
   std::vector<PerfMemSample> MemSamples;
@@ -244,6 +253,11 @@ private:
   /// disassembled BinaryFunctions
   BinaryFunction *getBinaryFunctionContainingAddress(uint64_t Address) const;
 
+  /// Aggregate the LBR entries of \p Samples into \p Aggr. Only reads the
+  /// state of the aggregator, so that it can run on several threads at once.
+  void aggregateBranchSamples(ArrayRef<PerfBranchSample> Samples,
+                              bool NeedsSkylakeFix, LBRAggregate &Aggr) const;
+
   /// Retrieve the location name to be used for samples recorded in \p Func.
   /// If doing BAT translation, link cold parts to the hot part  names (used by
   /// the original binary).  \p Count specifies how many samples were recorded
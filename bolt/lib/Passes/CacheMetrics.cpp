@@ -16,6 +16,7 @@
 #include "bolt/Core/BinaryFunction.h"
 #include "llvm/Support/CommandLine.h"
 #include <unordered_map>
+#include <unordered_set>
 
 using namespace llvm;
 using namespace bolt;
@@ -35,6 +36,45 @@ extern cl::opt<unsigned> ITLBEntries;
 
 namespace {
 
+using DataObjectPlacement = CacheMetrics::DataObjectPlacement;
+
+/// Page size used to estimate d-TLB usage of data objects.
+constexpr uint64_t DataPageSize = 4096;
+
+/// Cache lines and pages spanned by a set of data objects.
+struct DataLayoutStats {
+  size_t NumLines{0};
+  size_t NumPages{0};
+  /// The number of accesses to objects that cross a cache line boundary.
+  uint64_t SplitCount{0};
+};
+
+DataLayoutStats
+calcDataLayoutStats(const std::vector<DataObjectPlacement> &Objects,
+                    uint64_t CacheLineSize, bool UseOutput) {
+  DataLayoutStats Stats;
+  std::unordered_set<uint64_t> Lines;
+  std::unordered_set<uint64_t> Pages;
+  for (const DataObjectPlacement &Object : Objects) {
+    if (!Object.Size)
+      continue;
+    const uint64_t Start =
+        UseOutput ? Object.OutputAddress : Object.InputAddress;
+    const uint64_t End = Start + Object.Size - 1;
+    for (uint64_t Line = Start / CacheLineSize; Line <= End / CacheLineSize;
+         ++Line)
+      Lines.insert(Line);
+    for (uint64_t Page = Start / DataPageSize; Page <= End / DataPageSize;
+         ++Page)
+      Pages.insert(Page);
+    if (Start / CacheLineSize != End / CacheLineSize)
+      Stats.SplitCount += Object.Count;
+  }
+  Stats.NumLines = Lines.size();
+  Stats.NumPages = Pages.size();
+  return Stats;
+}
+
 /// Initialize and return a position map for binary basic blocks
 void extractBasicBlockInfo(
     const std::vector<BinaryFunction *> &BinaryFunctions,
@@ -309,3 +349,31 @@ void CacheMetrics::printAll(const std::vector<BinaryFunction *> &BFs) {
   outs() << "  ExtTSP score: "
          << format("%.0lf\n", calcExtTSPScore(BFs, BBAddr, BBSize));
 }
+
+void CacheMetrics::printDataMetrics(
+    const std::vector<DataObjectPlacement> &Objects, uint64_t CacheLineSize) {
+  uint64_t TotalSize = 0;
+  uint64_t TotalCount = 0;
+  for (const DataObjectPlacement &Object : Objects) {
+    TotalSize += Object.Size;
+    TotalCount += Object.Count;
+  }
+  if (Objects.empty() || !TotalCount)
+    return;
+
+  const DataLayoutStats Before =
+      calcDataLayoutStats(Objects, CacheLineSize, /*UseOutput=*/false);
+  const DataLayoutStats After =
+      calcDataLayoutStats(Objects, CacheLineSize, /*UseOutput=*/true);
+
+  outs() << "  Hot data: " << Objects.size() << " objects, " << TotalSize
+         << " bytes\n";
+  outs() << "  " << CacheLineSize << "-byte cache lines: " << Before.NumLines
+         << " -> " << After.NumLines << '\n';
+  outs() << "  " << DataPageSize << "-byte pages: " << Before.NumPages
+         << " -> " << After.NumPages << '\n';
+  outs() << format("  Accesses to objects split across cache lines: "
+                   "%.2lf%% -> %.2lf%%\n",
+                   100.0 * Before.SplitCount / TotalCount,
+                   100.0 * After.SplitCount / TotalCount);
+}
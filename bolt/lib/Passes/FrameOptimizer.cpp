@@ -56,10 +56,10 @@ RemoveStores("frame-opt-rm-stores",
 namespace llvm {
 namespace bolt {
 
-void FrameOptimizerPass::removeUnnecessaryLoads(const RegAnalysis &RA,
-                                                const FrameAnalysis &FA,
-                                                BinaryFunction &BF) {
-  StackAvailableExpressions SAE(RA, FA, BF);
+void FrameOptimizerPass::removeUnnecessaryLoads(
+    const RegAnalysis &RA, const FrameAnalysis &FA, BinaryFunction &BF,
+    MCPlusBuilder::AllocatorIdTy AllocatorId) {
+  StackAvailableExpressions SAE(RA, FA, BF, AllocatorId);
   SAE.run();
 
   LLVM_DEBUG(dbgs() << "Performing unnecessary loads removal\n");
@@ -160,9 +160,10 @@ void FrameOptimizerPass::removeUnnecessaryLoads(const RegAnalysis &RA,
     I.first->eraseInstruction(I.first->findInstruction(I.second));
 }
 
-void FrameOptimizerPass::removeUnusedStores(const FrameAnalysis &FA,
-                                            BinaryFunction &BF) {
-  StackReachingUses SRU(FA, BF);
+void FrameOptimizerPass::removeUnusedStores(
+    const FrameAnalysis &FA, BinaryFunction &BF,
+    MCPlusBuilder::AllocatorIdTy AllocatorId) {
+  StackReachingUses SRU(FA, BF, AllocatorId);
   SRU.run();
 
   LLVM_DEBUG(dbgs() << "Performing unused stores removal\n");
@@ -249,35 +250,10 @@ void FrameOptimizerPass::runOnFunctions(BinaryContext &BC) {
 
   // Perform caller-saved register optimizations, then callee-saved register
   // optimizations (shrink wrapping)
-  for (auto &I : BC.getBinaryFunctions()) {
-    if (!FA->hasFrameInfo(I.second))
-      continue;
-    // Restrict pass execution if user asked to only run on hot functions
-    if (opts::FrameOptimization == FOP_HOT) {
-      if (I.second.getKnownExecutionCount() < BC.getHotThreshold())
-        continue;
-      LLVM_DEBUG(
-          dbgs() << "Considering " << I.second.getPrintName()
-                 << " for frame optimizations because its execution count ( "
-                 << I.second.getKnownExecutionCount()
-                 << " ) exceeds our hotness threshold ( "
-                 << BC.getHotThreshold() << " )\n");
-    }
-
-    {
-      NamedRegionTimer T1("removeloads", "remove loads", "FOP", "FOP breakdown",
-                          opts::TimeOpts);
-      removeUnnecessaryLoads(*RA, *FA, I.second);
-    }
-
-    if (opts::RemoveStores) {
-      NamedRegionTimer T1("removestores", "remove stores", "FOP",
-                          "FOP breakdown", opts::TimeOpts);
-      removeUnusedStores(*FA, I.second);
-    }
-    // Don't even start shrink wrapping if no profiling info is available
-    if (I.second.getKnownExecutionCount() == 0)
-      continue;
+  {
+    NamedRegionTimer T1("removeloads", "remove loads and stores", "FOP",
+                        "FOP breakdown", opts::TimeOpts);
+    performFrameAccessOptimizations(*RA, *FA, BC);
   }
 
   {
@@ -298,6 +274,37 @@ void FrameOptimizerPass::runOnFunctions(BinaryContext &BC) {
   ShrinkWrapping::printStats();
 }
 
+void FrameOptimizerPass::performFrameAccessOptimizations(
+    const RegAnalysis &RA, const FrameAnalysis &FA, BinaryContext &BC) {
+  // Initialize necessary annotations to allow safe parallel accesses to
+  // annotation index in MIB
+  BC.MIB->getOrCreateAnnotationIndex("StackAvailableExpressions");
+  BC.MIB->getOrCreateAnnotationIndex("StackReachingUses");
+
+  ParallelUtilities::PredicateTy SkipPredicate = [&](const BinaryFunction &BF) {
+    if (!FA.hasFrameInfo(BF))
+      return true;
+
+    // Restrict pass execution if user asked to only run on hot functions
+    if (opts::FrameOptimization == FOP_HOT &&
+        BF.getKnownExecutionCount() < BC.getHotThreshold())
+      return true;
+
+    return false;
+  };
+
+  ParallelUtilities::WorkFuncWithAllocTy WorkFunction =
+      [&](BinaryFunction &BF, MCPlusBuilder::AllocatorIdTy AllocatorId) {
+        removeUnnecessaryLoads(RA, FA, BF, AllocatorId);
+        if (opts::RemoveStores)
+          removeUnusedStores(FA, BF, AllocatorId);
+      };
+
+  ParallelUtilities::runOnEachFunctionWithUniqueAllocId(
+      BC, ParallelUtilities::SchedulingPolicy::SP_INST_LINEAR, WorkFunction,
+      SkipPredicate, "frame-access-optimizations");
+}
+
 void FrameOptimizerPass::performShrinkWrapping(const RegAnalysis &RA,
                                                const FrameAnalysis &FA,
                                                BinaryContext &BC) {
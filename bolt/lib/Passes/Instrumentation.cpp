@@ -74,6 +74,13 @@ cl::opt<bool>
                       cl::init(false), cl::Optional,
                       cl::cat(BoltInstrCategory));
 
+cl::opt<bool> InstrumentationAtomicCounters(
+    "instrumentation-atomic-counters",
+    cl::desc("increment counters with atomic instructions. Plain increments "
+             "have lower overhead but may lose counts in multithreaded "
+             "programs (default: true)"),
+    cl::init(true), cl::Optional, cl::cat(BoltInstrCategory));
+
 cl::opt<bool> InstrumentCalls("instrument-calls",
                               cl::desc("record profile for inter-function "
                                        "control flow activity (default: true)"),
@@ -177,7 +184,8 @@ Instrumentation::createInstrumentationSnippet(BinaryContext &BC, bool IsLeaf) {
   Label = BC.Ctx->createNamedTempSymbol("InstrEntry");
   Summary->Counters.emplace_back(Label);
   InstructionListType CounterInstrs;
-  BC.MIB->createInstrIncMemory(CounterInstrs, Label, &*BC.Ctx, IsLeaf);
+  BC.MIB->createInstrIncMemory(CounterInstrs, Label, &*BC.Ctx, IsLeaf,
+                               opts::InstrumentationAtomicCounters);
   return CounterInstrs;
 }
 
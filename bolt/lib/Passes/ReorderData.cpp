@@ -16,6 +16,7 @@
 // - estimate temporal locality by looking at CFG?
 
 #include "bolt/Passes/ReorderData.h"
+#include "bolt/Passes/CacheMetrics.h"
 #include <algorithm>
 
 #undef  DEBUG_TYPE
@@ -92,6 +93,14 @@ SkipSymbols("reorder-skip-symbols",
   cl::Hidden,
   cl::cat(BoltCategory));
 
+static cl::opt<unsigned>
+ReorderDataCacheLineSize("reorder-data-cache-line-size",
+  cl::desc("cache line size used when placing hot data; objects that fit in "
+           "a cache line are not split across two (0 to disable)"),
+  cl::init(0),
+  cl::ZeroOrMore,
+  cl::cat(BoltOptCategory));
+
 static cl::opt<bool>
 ReorderInplace("reorder-data-inplace",
   cl::desc("reorder data sections in place"),
@@ -108,6 +117,9 @@ namespace {
 
 static constexpr uint16_t MinAlignment = 16;
 
+/// Cache line size for reporting data cache metrics when the option is unset.
+static constexpr uint64_t DefaultCacheLineSize = 64;
+
 bool isSupported(const BinarySection &BS) { return BS.isData() && !BS.isTLS(); }
 
 bool filterSymbol(const BinaryData *BD) {
@@ -338,14 +350,13 @@ ReorderData::sortedByCount(BinaryContext &BC,
   return std::make_pair(Order, SplitPoint);
 }
 
-// TODO
-// add option for cache-line alignment (or just use cache-line when section
-// is writeable)?
 void ReorderData::setSectionOrder(BinaryContext &BC,
                                   BinarySection &OutputSection,
                                   DataOrder::iterator Begin,
                                   DataOrder::iterator End) {
   std::vector<BinaryData *> NewOrder;
+  std::vector<CacheMetrics::DataObjectPlacement> HotObjects;
+  const uint64_t CacheLineSize = opts::ReorderDataCacheLineSize;
   unsigned NumReordered = 0;
   uint64_t Offset = 0;
   uint64_t Count = 0;
@@ -376,6 +387,11 @@ void ReorderData::setSectionOrder(BinaryContext &BC,
     uint16_t Alignment = std::max(BD->getAlignment(), MinAlignment);
     Offset = alignTo(Offset, Alignment);
 
+    // Start objects that would straddle a cache line on the next one.
+    if (CacheLineSize && BD->getSize() <= CacheLineSize &&
+        Offset / CacheLineSize != (Offset + BD->getSize() - 1) / CacheLineSize)
+      Offset = alignTo(Offset, CacheLineSize);
+
     if ((Offset + BD->getSize()) > opts::ReorderDataMaxBytes) {
       if (!NewOrder.empty())
         LLVM_DEBUG(dbgs() << "BOLT-DEBUG: processing ending on symbol "
@@ -400,6 +416,11 @@ void ReorderData::setSectionOrder(BinaryContext &BC,
       }
     }
 
+    if (Begin->second)
+      HotObjects.push_back(
+          {BD->getAddress(), OutputSection.getAddress() + Offset,
+           BD->getSize(), Begin->second});
+
     Offset += BD->getSize();
     Count += Begin->second;
     NewOrder.push_back(BD);
@@ -410,6 +431,8 @@ void ReorderData::setSectionOrder(BinaryContext &BC,
   outs() << "BOLT-INFO: reorder-data: " << Count << "/" << TotalCount
          << format(" (%.1f%%)", 100.0 * Count / TotalCount) << " events, "
          << Offset << " hot bytes\n";
+  CacheMetrics::printDataMetrics(
+      HotObjects, CacheLineSize ? CacheLineSize : DefaultCacheLineSize);
 }
 
 bool ReorderData::markUnmoveableSymbols(BinaryContext &BC,
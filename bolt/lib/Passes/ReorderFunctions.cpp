@@ -62,6 +62,14 @@ ReorderFunctionsUseHotSize("reorder-functions-use-hot-size",
   cl::ZeroOrMore,
   cl::cat(BoltOptCategory));
 
+static cl::opt<bool>
+ReorderFunctionsPackHugePages("reorder-functions-pack-huge-pages",
+  cl::desc("pull smaller hot clusters forward so that hot clusters do not "
+           "straddle 2MB page boundaries"),
+  cl::init(false),
+  cl::ZeroOrMore,
+  cl::cat(BoltOptCategory));
+
 static cl::opt<std::string>
 FunctionOrderFile("function-order",
   cl::desc("file containing an ordered list of functions to use for function "
@@ -159,6 +167,8 @@ void ReorderFunctions::reorder(std::vector<Cluster> &&Clusters,
   double TotalCalls64B = 0;
   double TotalCalls4KB = 0;
   double TotalCalls2MB = 0;
+  uint64_t TotalSamples = 0;
+  uint64_t SamplesInFirstHugePage = 0;
   if (PrintDetailed)
     outs() << "BOLT-INFO: Function reordering page layout\n"
            << "BOLT-INFO: ============== page 0 ==============\n";
@@ -171,6 +181,9 @@ void ReorderFunctions::reorder(std::vector<Cluster> &&Clusters,
     for (NodeId FuncId : Cluster.targets()) {
       if (Cg.samples(FuncId) > 0) {
         Hotfuncs++;
+        TotalSamples += Cg.samples(FuncId);
+        if (FuncAddr[FuncId] < HugePageSize)
+          SamplesInFirstHugePage += Cg.samples(FuncId);
 
         if (PrintDetailed)
           outs() << "BOLT-INFO: hot func " << *Cg.nodeIdToFunc(FuncId) << " ("
@@ -232,7 +245,15 @@ void ReorderFunctions::reorder(std::vector<Cluster> &&Clusters,
                    "(%.0lf / %.0lf)\n",
                    TotalCalls ? TotalDistance / TotalCalls : 0, TotalDistance,
                    TotalCalls)
-         << format("BOLT-INFO:  Total Calls = %.0lf\n", TotalCalls);
+         << format("BOLT-INFO:  Total Calls = %.0lf\n", TotalCalls)
+         << format("BOLT-INFO:  Hot code size = %lu bytes (%lu 4KB pages, "
+                   "%lu 2MB pages)\n",
+                   TotalSize, divideCeil(TotalSize, 4096),
+                   divideCeil(TotalSize, HugePageSize));
+  if (TotalSamples)
+    outs() << format("BOLT-INFO:  Samples within the first 2MB page = "
+                     "%.2lf%%\n",
+                     100.0 * SamplesInFirstHugePage / TotalSamples);
   if (TotalCalls)
     outs() << format("BOLT-INFO:  Total Calls within 64B = %.0lf (%.2lf%%)\n",
                      TotalCalls64B, 100 * TotalCalls64B / TotalCalls)
@@ -244,6 +265,52 @@ void ReorderFunctions::reorder(std::vector<Cluster> &&Clusters,
 
 namespace {
 
+/// Reorder hot clusters so that a cluster that would cross a huge page
+/// boundary is deferred in favor of the next hot cluster that still fits in
+/// the current huge page. The relative order of the clusters is otherwise
+/// kept, and cold clusters stay at the end.
+void packClustersIntoHugePages(std::vector<Cluster> &Clusters) {
+  // Limit the search for a cluster that fits to keep this linear.
+  constexpr size_t MaxLookahead = 1024;
+
+  std::vector<Cluster> Packed;
+  Packed.reserve(Clusters.size());
+  std::vector<bool> Placed(Clusters.size(), false);
+  size_t Next = 0;
+  uint64_t PageOffset = 0;
+  while (Next < Clusters.size() && Clusters[Next].samples() > 0) {
+    size_t Candidate = Next;
+    size_t Lookahead = 0;
+    while (Candidate < Clusters.size() && Clusters[Candidate].samples() > 0 &&
+           Lookahead < MaxLookahead) {
+      if (!Placed[Candidate]) {
+        if (PageOffset + Clusters[Candidate].size() <= HugePageSize)
+          break;
+        ++Lookahead;
+      }
+      ++Candidate;
+    }
+    // Start a new huge page with the next cluster if none fits.
+    if (Candidate == Clusters.size() || !Clusters[Candidate].samples() ||
+        Lookahead == MaxLookahead) {
+      Candidate = Next;
+      PageOffset = 0;
+    }
+
+    PageOffset = (PageOffset + Clusters[Candidate].size()) % HugePageSize;
+    Placed[Candidate] = true;
+    Packed.emplace_back(std::move(Clusters[Candidate]));
+    while (Next < Clusters.size() && Placed[Next])
+      ++Next;
+  }
+
+  for (size_t I = Next, E = Clusters.size(); I != E; ++I)
+    if (!Placed[I])
+      Packed.emplace_back(std::move(Clusters[I]));
+
+  Clusters = std::move(Packed);
+}
+
 std::vector<std::string> readFunctionOrderFile() {
   std::vector<std::string> FunctionNames;
   std::ifstream FuncsFile(opts::FunctionOrderFile, std::ios::in);
@@ -382,6 +449,9 @@ void ReorderFunctions::runOnFunctions(BinaryContext &BC) {
     break;
   }
 
+  if (opts::ReorderFunctionsPackHugePages && !Clusters.empty())
+    packClustersIntoHugePages(Clusters);
+
   reorder(std::move(Clusters), BFs);
 
   std::unique_ptr<std::ofstream> FuncsFile;
@@ -14,6 +14,7 @@
 #include "bolt/Profile/DataAggregator.h"
 #include "bolt/Core/BinaryContext.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Profile/BoltAddressTranslation.h"
 #include "bolt/Profile/Heatmap.h"
 #include "bolt/Utils/CommandLineOpts.h"
@@ -25,6 +26,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Regex.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -1357,44 +1359,10 @@ std::error_code DataAggregator::printLBRHeatMap() {
   return std::error_code();
 }
 
-std::error_code DataAggregator::parseBranchEvents() {
-  outs() << "PERF2BOLT: parse branch events...\n";
-  NamedRegionTimer T("parseBranch", "Parsing branch events", TimerGroupName,
-                     TimerGroupDesc, opts::TimeAggregator);
-
-  uint64_t NumTotalSamples = 0;
-  uint64_t NumEntries = 0;
-  uint64_t NumSamples = 0;
-  uint64_t NumSamplesNoLBR = 0;
-  uint64_t NumTraces = 0;
-  bool NeedsSkylakeFix = false;
-
-  while (hasData() && NumTotalSamples < opts::MaxSamples) {
-    ++NumTotalSamples;
-
-    ErrorOr<PerfBranchSample> SampleRes = parseBranchSample();
-    if (std::error_code EC = SampleRes.getError()) {
-      if (EC == errc::no_such_process)
-        continue;
-      return EC;
-    }
-    ++NumSamples;
-
-    PerfBranchSample &Sample = SampleRes.get();
-    if (opts::WriteAutoFDOData)
-      ++BasicSamples[Sample.PC];
-
-    if (Sample.LBR.empty()) {
-      ++NumSamplesNoLBR;
-      continue;
-    }
-
-    NumEntries += Sample.LBR.size();
-    if (BAT && Sample.LBR.size() == 32 && !NeedsSkylakeFix) {
-      errs() << "PERF2BOLT-WARNING: using Intel Skylake bug workaround\n";
-      NeedsSkylakeFix = true;
-    }
-
+void DataAggregator::aggregateBranchSamples(ArrayRef<PerfBranchSample> Samples,
+                                            bool NeedsSkylakeFix,
+                                            LBRAggregate &Aggr) const {
+  for (const PerfBranchSample &Sample : Samples) {
     // LBRs are stored in reverse execution order. NextPC refers to the next
     // recorded executed PC.
     uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
@@ -1416,7 +1384,7 @@ std::error_code DataAggregator::parseBranchEvents() {
         const BinaryFunction *TraceBF =
             getBinaryFunctionContainingAddress(TraceFrom);
         if (TraceBF && TraceBF->containsAddress(TraceTo)) {
-          FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
+          FTInfo &Info = Aggr.FallthroughLBRs[Trace(TraceFrom, TraceTo)];
           if (TraceBF->containsAddress(LBR.From))
             ++Info.InternCount;
           else
@@ -1429,7 +1397,7 @@ std::error_code DataAggregator::parseBranchEvents() {
                        << Twine::utohexstr(TraceFrom - TraceBF->getAddress())
                        << " and ending @ " << Twine::utohexstr(TraceTo)
                        << '\n');
-            ++NumInvalidTraces;
+            ++Aggr.NumInvalidTraces;
           } else {
             LLVM_DEBUG(dbgs()
                        << "Out of range trace starting in "
@@ -1449,10 +1417,10 @@ std::error_code DataAggregator::parseBranchEvents() {
                                          ->getAddress()
                                    : 0))
                        << '\n');
-            ++NumLongRangeTraces;
+            ++Aggr.NumLongRangeTraces;
           }
         }
-        ++NumTraces;
+        ++Aggr.NumTraces;
       }
       NextPC = LBR.From;
 
@@ -1464,11 +1432,117 @@ std::error_code DataAggregator::parseBranchEvents() {
         To = 0;
       if (!From && !To)
         continue;
-      BranchInfo &Info = BranchLBRs[Trace(From, To)];
+      BranchInfo &Info = Aggr.BranchLBRs[Trace(From, To)];
       ++Info.TakenCount;
       Info.MispredCount += LBR.Mispred;
     }
   }
+}
+
+std::error_code DataAggregator::parseBranchEvents() {
+  outs() << "PERF2BOLT: parse branch events...\n";
+  NamedRegionTimer T("parseBranch", "Parsing branch events", TimerGroupName,
+                     TimerGroupDesc, opts::TimeAggregator);
+
+  uint64_t NumTotalSamples = 0;
+  uint64_t NumEntries = 0;
+  uint64_t NumSamples = 0;
+  uint64_t NumSamplesNoLBR = 0;
+  uint64_t NumTraces = 0;
+  bool NeedsSkylakeFix = false;
+
+  // Samples are parsed here and handed over in batches to a fixed number of
+  // lanes, which aggregate them on the thread pool while parsing continues.
+  // Each lane has its own maps, which are merged once all samples are read,
+  // and at most one batch in flight, which bounds the memory used by samples.
+  const unsigned NumLanes =
+      opts::NoThreads ? 1 : std::max(1u, unsigned(opts::ThreadCount));
+  const size_t BatchSize = 4096;
+  std::vector<LBRAggregate> Lanes(NumLanes);
+  std::vector<std::shared_future<void>> LaneTasks(NumLanes);
+  unsigned NextLane = 0;
+  std::vector<PerfBranchSample> Batch;
+  auto WaitForLanes = make_scope_exit([&] {
+    for (std::shared_future<void> &Task : LaneTasks)
+      if (Task.valid())
+        Task.wait();
+  });
+  auto flushBatch = [&]() {
+    if (Batch.empty())
+      return;
+    if (opts::NoThreads) {
+      aggregateBranchSamples(Batch, NeedsSkylakeFix, Lanes[0]);
+      Batch.clear();
+      return;
+    }
+    std::shared_future<void> &Task = LaneTasks[NextLane];
+    if (Task.valid())
+      Task.wait();
+    auto Samples =
+        std::make_shared<std::vector<PerfBranchSample>>(std::move(Batch));
+    Batch = std::vector<PerfBranchSample>();
+    LBRAggregate &Aggr = Lanes[NextLane];
+    const bool SkylakeFix = NeedsSkylakeFix;
+    Task = ParallelUtilities::getThreadPool().async(
+        [this, Samples, &Aggr, SkylakeFix] {
+          aggregateBranchSamples(*Samples, SkylakeFix, Aggr);
+        });
+    NextLane = (NextLane + 1) % NumLanes;
+  };
+
+  while (hasData() && NumTotalSamples < opts::MaxSamples) {
+    ++NumTotalSamples;
+
+    ErrorOr<PerfBranchSample> SampleRes = parseBranchSample();
+    if (std::error_code EC = SampleRes.getError()) {
+      if (EC == errc::no_such_process)
+        continue;
+      return EC;
+    }
+    ++NumSamples;
+
+    PerfBranchSample &Sample = SampleRes.get();
+    if (opts::WriteAutoFDOData)
+      ++BasicSamples[Sample.PC];
+
+    if (Sample.LBR.empty()) {
+      ++NumSamplesNoLBR;
+      continue;
+    }
+
+    NumEntries += Sample.LBR.size();
+    if (BAT && Sample.LBR.size() == 32 && !NeedsSkylakeFix) {
+      // The workaround applies from this sample on.
+      flushBatch();
+      errs() << "PERF2BOLT-WARNING: using Intel Skylake bug workaround\n";
+      NeedsSkylakeFix = true;
+    }
+
+    Batch.push_back(std::move(Sample));
+    if (Batch.size() >= BatchSize)
+      flushBatch();
+  }
+  flushBatch();
+  for (std::shared_future<void> &Task : LaneTasks)
+    if (Task.valid())
+      Task.wait();
+
+  for (LBRAggregate &Aggr : Lanes) {
+    for (const auto &LBR : Aggr.BranchLBRs) {
+      BranchInfo &Info = BranchLBRs[LBR.first];
+      Info.TakenCount += LBR.second.TakenCount;
+      Info.MispredCount += LBR.second.MispredCount;
+    }
+    for (const auto &FT : Aggr.FallthroughLBRs) {
+      FTInfo &Info = FallthroughLBRs[FT.first];
+      Info.InternCount += FT.second.InternCount;
+      Info.ExternCount += FT.second.ExternCount;
+    }
+    NumTraces += Aggr.NumTraces;
+    NumInvalidTraces += Aggr.NumInvalidTraces;
+    NumLongRangeTraces += Aggr.NumLongRangeTraces;
+    Aggr = LBRAggregate();
+  }
 
   for (const auto &LBR : BranchLBRs) {
     const Trace &Trace = LBR.first;
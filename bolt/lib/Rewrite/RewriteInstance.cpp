@@ -49,13 +49,19 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <fstream>
+#include <mutex>
 #include <system_error>
 
+#if defined(LLVM_ON_UNIX)
+#include <sys/resource.h>
+#endif
+
 #undef  DEBUG_TYPE
 #define DEBUG_TYPE "bolt"
 
@@ -319,6 +325,32 @@ namespace bolt {
 
 extern const char *BoltRevision;
 
+namespace {
+
+/// With -time-rewrite, print the peak resident set size of the process and
+/// the current heap usage after rewrite phase \p Phase.
+void reportMemoryUsage(StringRef Phase) {
+  if (!opts::TimeRewrite)
+    return;
+
+  constexpr double MB = 1024.0 * 1024.0;
+  outs() << "BOLT-INFO: memory usage after " << Phase << ":";
+#if defined(LLVM_ON_UNIX)
+  struct rusage Usage;
+  if (!getrusage(RUSAGE_SELF, &Usage)) {
+#if defined(__APPLE__)
+    const uint64_t MaxRSS = Usage.ru_maxrss;
+#else
+    const uint64_t MaxRSS = Usage.ru_maxrss * 1024ULL;
+#endif
+    outs() << format(" peak RSS = %.1lf MB,", MaxRSS / MB);
+  }
+#endif
+  outs() << format(" heap = %.1lf MB\n", sys::Process::GetMallocUsage() / MB);
+}
+
+} // anonymous namespace
+
 MCPlusBuilder *createMCPlusBuilder(const Triple::ArchType Arch,
                                    const MCInstrAnalysis *Analysis,
                                    const MCInstrInfo *Info,
@@ -754,10 +786,12 @@ void RewriteInstance::run() {
   readDebugInfo();
 
   disassembleFunctions();
+  reportMemoryUsage("disassembly");
 
   processProfileDataPreCFG();
 
   buildFunctionsCFG();
+  reportMemoryUsage("CFG construction");
 
   processProfileData();
 
@@ -767,8 +801,10 @@ void RewriteInstance::run() {
     return;
 
   runOptimizationPasses();
+  reportMemoryUsage("optimizations");
 
   emitAndLink();
+  reportMemoryUsage("emission");
 
   updateMetadata();
 
@@ -782,6 +818,7 @@ void RewriteInstance::run() {
 
   // Rewrite allocatable contents and copy non-allocatable parts with mods.
   rewriteFile();
+  reportMemoryUsage("writing the output file");
 }
 
 void RewriteInstance::discoverFileObjects() {
@@ -2727,31 +2764,51 @@ void RewriteInstance::disassembleFunctions() {
 
   BC->adjustCodePadding();
 
+  // Fill in CFI information. This only reads the parsed .eh_frame and updates
+  // the function itself, so it is done in parallel. Failures are handled
+  // afterwards in address order, to keep the output deterministic.
+  std::mutex CFIFailuresMutex;
+  std::vector<BinaryFunction *> CFIFailures;
+  ParallelUtilities::WorkFuncTy FillCFI = [&](BinaryFunction &Function) {
+    if (Function.trapsOnEntry() || CFIRdWrt->fillCFIInfoFor(Function))
+      return;
+    std::lock_guard<std::mutex> Lock(CFIFailuresMutex);
+    CFIFailures.push_back(&Function);
+  };
+  ParallelUtilities::PredicateTy SkipFillCFI = [&](const BinaryFunction &BF) {
+    if (!shouldDisassemble(BF))
+      return true;
+    if (!BF.isSimple()) {
+      assert((!BC->HasRelocations || BF.getSize() == 0) &&
+             "unexpected non-simple function in relocation mode");
+      return true;
+    }
+    return false;
+  };
+  ParallelUtilities::runOnEachFunction(
+      *BC, ParallelUtilities::SchedulingPolicy::SP_INST_LINEAR, FillCFI,
+      SkipFillCFI, "fillCFIInfo",
+      /*ForceSequential*/ opts::SequentialDisassembly);
+
+  llvm::sort(CFIFailures, [](const BinaryFunction *A, const BinaryFunction *B) {
+    return A->getAddress() < B->getAddress();
+  });
+  for (BinaryFunction *Function : CFIFailures) {
+    if (BC->HasRelocations)
+      BC->exitWithBugReport("unable to fill CFI.", *Function);
+    errs() << "BOLT-WARNING: unable to fill CFI for function " << *Function
+           << ". Skipping.\n";
+    Function->setSimple(false);
+  }
+
+  // Parse LSDA. This creates symbols in the shared MCContext, so it stays
+  // sequential.
   for (auto &BFI : BC->getBinaryFunctions()) {
     BinaryFunction &Function = BFI.second;
 
-    if (!shouldDisassemble(Function))
-      continue;
-
-    if (!Function.isSimple()) {
-      assert((!BC->HasRelocations || Function.getSize() == 0) &&
-             "unexpected non-simple function in relocation mode");
+    if (!shouldDisassemble(Function) || !Function.isSimple())
       continue;
-    }
-
-    // Fill in CFI information for this function
-    if (!Function.trapsOnEntry() && !CFIRdWrt->fillCFIInfoFor(Function)) {
-      if (BC->HasRelocations) {
-        BC->exitWithBugReport("unable to fill CFI.", Function);
-      } else {
-        errs() << "BOLT-WARNING: unable to fill CFI for function " << Function
-               << ". Skipping.\n";
-        Function.setSimple(false);
-        continue;
-      }
-    }
 
-    // Parse LSDA.
     if (Function.getLSDAAddress() != 0)
       Function.parseLSDA(getLSDAData(), getLSDAAddress());
   }
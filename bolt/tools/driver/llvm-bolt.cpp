@@ -25,6 +25,7 @@
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
 
 #define DEBUG_TYPE "bolt"
 
@@ -75,6 +76,13 @@ InputFilename2(
   cl::Optional,
   cl::cat(BoltDiffCategory));
 
+static cl::opt<std::string>
+TimeOptsJSON("time-opts-json",
+  cl::desc("write the times reported by -time-opts and -time-rewrite to a "
+           "file in JSON format (implies -time-opts)"),
+  cl::value_desc("filename"),
+  cl::cat(BoltOptCategory));
+
 } // namespace opts
 
 static StringRef ToolName;
@@ -92,6 +100,20 @@ static void report_error(StringRef Message, Error E) {
   exit(1);
 }
 
+/// Write the values of all timers to the file given by -time-opts-json.
+static void writeTimersJSON() {
+  if (opts::TimeOptsJSON.empty())
+    return;
+
+  std::error_code EC;
+  raw_fd_ostream OS(opts::TimeOptsJSON, EC, sys::fs::OF_Text);
+  if (EC)
+    report_error(opts::TimeOptsJSON, EC);
+  OS << "{\n";
+  TimerGroup::printAllJSONValues(OS, "");
+  OS << "\n}\n";
+}
+
 static void printBoltRevision(llvm::raw_ostream &OS) {
   OS << "BOLT revision " << BoltRevision << "\n";
 }
@@ -240,6 +262,9 @@ int main(int argc, char **argv) {
   else
     boltMode(argc, argv);
 
+  if (!opts::TimeOptsJSON.empty())
+    opts::TimeOpts = true;
+
   if (!sys::fs::exists(opts::InputFilename))
     report_error(opts::InputFilename, errc::no_such_file_or_directory);
 
@@ -274,6 +299,7 @@ int main(int argc, char **argv) {
       }
 
       RI.run();
+      writeTimersJSON();
     } else if (auto *O = dyn_cast<MachOObjectFile>(&Binary)) {
       MachORewriteInstance MachORI(O, ToolPath);
 
@@ -282,6 +308,7 @@ int main(int argc, char **argv) {
           report_error(opts::InputDataFilename, std::move(E));
 
       MachORI.run();
+      writeTimersJSON();
     } else {
       report_error(opts::InputFilename, object_error::invalid_file_type);
     }
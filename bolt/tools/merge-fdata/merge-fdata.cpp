@@ -10,6 +10,11 @@
 //
 //   $ merge-fdata 1.fdata 2.fdata 3.fdata > merged.fdata
 //
+// Profiles collected over time can be merged with older ones weighted down
+// and stale function profiles replaced by newer ones:
+//
+//   $ merge-fdata -weights=0.5,1 -replace-stale old.yaml new.yaml > merged.yaml
+//
 //===----------------------------------------------------------------------===//
 
 #include "bolt/Profile/ProfileYAMLMapping.h"
@@ -56,6 +61,22 @@ PrintFunctionList("print",
       "print functions sorted by total branch count")),
   cl::cat(MergeFdataCategory));
 
+static cl::list<double>
+InputWeights("weights",
+  cl::CommaSeparated,
+  cl::desc("scale the counts of each input by the corresponding weight, "
+           "e.g. to age profiles collected earlier"),
+  cl::ZeroOrMore,
+  cl::cat(MergeFdataCategory));
+
+static cl::opt<bool>
+ReplaceStaleProfiles("replace-stale",
+  cl::desc("when the profile of a function does not match the one merged "
+           "from a previous input, use the profile from the later input "
+           "instead of failing"),
+  cl::init(false),
+  cl::cat(MergeFdataCategory));
+
 static cl::opt<bool>
 SuppressMergedDataOutput("q",
   cl::desc("do not print merged data to stdout"),
@@ -80,6 +101,41 @@ static void report_error(Twine Message, StringRef CustomError) {
   exit(1);
 }
 
+/// Returns the weight for the input with index \p I.
+double getInputWeight(size_t I) {
+  if (opts::InputWeights.empty())
+    return 1.0;
+  return opts::InputWeights[I];
+}
+
+uint64_t scaleCount(uint64_t Count, double Weight) {
+  return static_cast<uint64_t>(Count * Weight + 0.5);
+}
+
+void scaleFunctionProfile(BinaryFunctionProfile &BF, double Weight) {
+  BF.ExecCount = scaleCount(BF.ExecCount, Weight);
+  for (BinaryBasicBlockProfile &BB : BF.Blocks) {
+    BB.ExecCount = scaleCount(BB.ExecCount, Weight);
+    BB.EventCount = scaleCount(BB.EventCount, Weight);
+    for (CallSiteInfo &CS : BB.CallSites) {
+      CS.Count = scaleCount(CS.Count, Weight);
+      CS.Mispreds = scaleCount(CS.Mispreds, Weight);
+    }
+    for (SuccessorInfo &SI : BB.Successors) {
+      SI.Count = scaleCount(SI.Count, Weight);
+      SI.Mispreds = scaleCount(SI.Mispreds, Weight);
+    }
+  }
+}
+
+/// Returns true if the profiles were collected for the same version of the
+/// function and can be merged.
+bool isSameFunction(const BinaryFunctionProfile &A,
+                    const BinaryFunctionProfile &B) {
+  return A.NumBasicBlocks == B.NumBasicBlocks && A.Id == B.Id &&
+         A.Hash == B.Hash;
+}
+
 void mergeProfileHeaders(BinaryProfileHeader &MergedHeader,
                          const BinaryProfileHeader &Header) {
   if (MergedHeader.FileName.empty())
@@ -240,7 +296,9 @@ void mergeLegacyProfiles(const cl::list<std::string> &Filenames) {
   bool BoltedCollection = false;
   bool First = true;
   StringMap<uint64_t> Entries;
-  for (const std::string &Filename : Filenames) {
+  for (size_t I = 0, E = Filenames.size(); I != E; ++I) {
+    const std::string &Filename = Filenames[I];
+    const double Weight = getInputWeight(I);
     if (isYAML(Filename))
       report_error(Filename, "cannot mix YAML and legacy formats");
     ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
@@ -276,6 +334,8 @@ void mergeLegacyProfiles(const cl::list<std::string> &Filenames) {
       uint64_t Count;
       if (Line.substr(Pos + 1, Line.size() - Pos).getAsInteger(10, Count))
         report_error(Filename, "Malformed / corrupted profile counter");
+      if (Weight != 1.0)
+        Count = scaleCount(Count, Weight);
       Count += Entries.lookup(Signature);
       Entries.insert_or_assign(Signature, Count);
     }
@@ -304,6 +364,13 @@ int main(int argc, char **argv) {
 
   ToolName = argv[0];
 
+  if (!opts::InputWeights.empty() &&
+      opts::InputWeights.size() != opts::InputDataFilenames.size())
+    report_error("-weights", "expected one weight per input file");
+  for (double Weight : opts::InputWeights)
+    if (Weight < 0)
+      report_error("-weights", "weights must not be negative");
+
   if (!isYAML(opts::InputDataFilenames.front())) {
     mergeLegacyProfiles(opts::InputDataFilenames);
     return 0;
@@ -316,7 +383,12 @@ int main(int argc, char **argv) {
   // Merged information for all functions.
   StringMap<BinaryFunctionProfile> MergedBFs;
 
-  for (std::string &InputDataFilename : opts::InputDataFilenames) {
+  // Number of function profiles replaced with the ones from a later input.
+  uint64_t NumReplaced = 0;
+
+  for (size_t I = 0, E = opts::InputDataFilenames.size(); I != E; ++I) {
+    const std::string &InputDataFilename = opts::InputDataFilenames[I];
+    const double Weight = getInputWeight(I);
     ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
         MemoryBuffer::getFileOrSTDIN(InputDataFilename);
     if (std::error_code EC = MB.getError())
@@ -342,12 +414,20 @@ int main(int argc, char **argv) {
 
     // Do the function merge.
     for (BinaryFunctionProfile &BF : BP.Functions) {
+      if (Weight != 1.0)
+        scaleFunctionProfile(BF, Weight);
+
       if (!MergedBFs.count(BF.Name)) {
         MergedBFs.insert(std::make_pair(BF.Name, BF));
         continue;
       }
 
       BinaryFunctionProfile &MergedBF = MergedBFs.find(BF.Name)->second;
+      if (opts::ReplaceStaleProfiles && !isSameFunction(MergedBF, BF)) {
+        MergedBF = std::move(BF);
+        ++NumReplaced;
+        continue;
+      }
       mergeFunctionProfile(MergedBF, std::move(BF));
     }
   }
@@ -372,6 +452,9 @@ int main(int argc, char **argv) {
 
   errs() << "Data for " << MergedBFs.size()
          << " unique objects successfully merged.\n";
+  if (NumReplaced)
+    errs() << "Replaced " << NumReplaced
+           << " stale function profiles with newer ones.\n";
 
   if (opts::PrintFunctionList != opts::ST_NONE) {
     // List of function names with execution count.
@@ -41,6 +41,9 @@
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/Process.h"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 #if CLANG_TIDY_ENABLE_STATIC_ANALYZER
@@ -415,6 +418,8 @@ ClangTidyASTConsumerFactory::createASTConsumer(
     Profiling = std::make_unique<ClangTidyProfiling>(
         Context.getProfileStorageParams());
     FinderOptions.CheckProfiling.emplace(Profiling->Records);
+    FinderOptions.CheckProfiling->PerMatcher =
+        Context.getEnableMatcherProfiling();
   }
 
   std::unique_ptr<ast_matchers::MatchFinder> Finder(
@@ -509,6 +514,83 @@ getCheckOptions(const ClangTidyOptions &Options,
   return Factory.getCheckOptions();
 }
 
+namespace {
+// Adds the extra arguments passed by the clang-tidy command-line and configs.
+ArgumentsAdjuster getPerFileExtraArgumentsInserter(ClangTidyContext &Context) {
+  return [&Context](const CommandLineArguments &Args, StringRef Filename) {
+    ClangTidyOptions Opts = Context.getOptionsForFile(Filename);
+    CommandLineArguments AdjustedArgs = Args;
+    if (Opts.ExtraArgsBefore) {
+      auto I = AdjustedArgs.begin();
+      if (I != AdjustedArgs.end() && !StringRef(*I).startswith("-"))
+        ++I; // Skip compiler binary name, if it is there.
+      AdjustedArgs.insert(I, Opts.ExtraArgsBefore->begin(),
+                          Opts.ExtraArgsBefore->end());
+    }
+    if (Opts.ExtraArgs)
+      AdjustedArgs.insert(AdjustedArgs.end(), Opts.ExtraArgs->begin(),
+                          Opts.ExtraArgs->end());
+    return AdjustedArgs;
+  };
+}
+
+class ActionFactory : public FrontendActionFactory {
+public:
+  ActionFactory(ClangTidyContext &Context,
+                IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
+      : ConsumerFactory(Context, std::move(BaseFS)) {}
+  std::unique_ptr<FrontendAction> create() override {
+    return std::make_unique<Action>(&ConsumerFactory);
+  }
+
+  bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
+                     FileManager *Files,
+                     std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+                     DiagnosticConsumer *DiagConsumer) override {
+    // Explicitly ask to define __clang_analyzer__ macro.
+    Invocation->getPreprocessorOpts().SetUpStaticAnalyzer = true;
+    return FrontendActionFactory::runInvocation(Invocation, Files,
+                                                PCHContainerOps, DiagConsumer);
+  }
+
+private:
+  class Action : public ASTFrontendAction {
+  public:
+    Action(ClangTidyASTConsumerFactory *Factory) : Factory(Factory) {}
+    std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &Compiler,
+                                                   StringRef File) override {
+      return Factory->createASTConsumer(Compiler, File);
+    }
+
+  private:
+    ClangTidyASTConsumerFactory *Factory;
+  };
+
+  ClangTidyASTConsumerFactory ConsumerFactory;
+};
+
+// Serves the options of a ClangTidyContext shared by several threads. Options
+// providers cache configuration files, so access to them is serialized.
+class SharedContextOptionsProvider : public ClangTidyOptionsProvider {
+public:
+  SharedContextOptionsProvider(const ClangTidyContext &Context, std::mutex &Mu)
+      : Context(Context), Mu(Mu) {}
+
+  const ClangTidyGlobalOptions &getGlobalOptions() override {
+    return Context.getGlobalOptions();
+  }
+
+  std::vector<OptionsSource> getRawOptions(StringRef FileName) override {
+    std::lock_guard<std::mutex> Lock(Mu);
+    return {{Context.getOptionsForFile(FileName), "shared context"}};
+  }
+
+private:
+  const ClangTidyContext &Context;
+  std::mutex &Mu;
+};
+} // namespace
+
 std::vector<ClangTidyError>
 runClangTidy(clang::tidy::ClangTidyContext &Context,
              const CompilationDatabase &Compilations,
@@ -519,25 +601,7 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   ClangTool Tool(Compilations, InputFiles,
                  std::make_shared<PCHContainerOperations>(), BaseFS);
 
-  // Add extra arguments passed by the clang-tidy command-line.
-  ArgumentsAdjuster PerFileExtraArgumentsInserter =
-      [&Context](const CommandLineArguments &Args, StringRef Filename) {
-        ClangTidyOptions Opts = Context.getOptionsForFile(Filename);
-        CommandLineArguments AdjustedArgs = Args;
-        if (Opts.ExtraArgsBefore) {
-          auto I = AdjustedArgs.begin();
-          if (I != AdjustedArgs.end() && !StringRef(*I).startswith("-"))
-            ++I; // Skip compiler binary name, if it is there.
-          AdjustedArgs.insert(I, Opts.ExtraArgsBefore->begin(),
-                              Opts.ExtraArgsBefore->end());
-        }
-        if (Opts.ExtraArgs)
-          AdjustedArgs.insert(AdjustedArgs.end(), Opts.ExtraArgs->begin(),
-                              Opts.ExtraArgs->end());
-        return AdjustedArgs;
-      };
-
-  Tool.appendArgumentsAdjuster(PerFileExtraArgumentsInserter);
+  Tool.appendArgumentsAdjuster(getPerFileExtraArgumentsInserter(Context));
   Tool.appendArgumentsAdjuster(getStripPluginsAdjuster());
   Context.setEnableProfiling(EnableCheckProfile);
   Context.setProfileStoragePrefix(StoreCheckProfile);
@@ -548,44 +612,60 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   Context.setDiagnosticsEngine(&DE);
   Tool.setDiagnosticConsumer(&DiagConsumer);
 
-  class ActionFactory : public FrontendActionFactory {
-  public:
-    ActionFactory(ClangTidyContext &Context,
-                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
-        : ConsumerFactory(Context, std::move(BaseFS)) {}
-    std::unique_ptr<FrontendAction> create() override {
-      return std::make_unique<Action>(&ConsumerFactory);
-    }
+  ActionFactory Factory(Context, std::move(BaseFS));
+  Tool.run(&Factory);
+  return DiagConsumer.take();
+}
 
-    bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
-                       FileManager *Files,
-                       std::shared_ptr<PCHContainerOperations> PCHContainerOps,
-                       DiagnosticConsumer *DiagConsumer) override {
-      // Explicitly ask to define __clang_analyzer__ macro.
-      Invocation->getPreprocessorOpts().SetUpStaticAnalyzer = true;
-      return FrontendActionFactory::runInvocation(
-          Invocation, Files, PCHContainerOps, DiagConsumer);
+std::vector<ClangTidyError> runClangTidyParallel(
+    ClangTidyContext &Context, const CompilationDatabase &Compilations,
+    ArrayRef<std::string> InputFiles,
+    ArrayRef<IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem>> WorkerFS,
+    bool ApplyAnyFix, bool EnableCheckProfile,
+    llvm::StringRef StoreCheckProfile) {
+  assert(!WorkerFS.empty() && "No file systems for the worker threads");
+  std::mutex OptionsMu;
+  std::mutex ResultsMu;
+  std::atomic<size_t> NextFile{0};
+  // Merges the results of all workers; computes the same deduplication and
+  // fix conflict detection as a single-threaded run over all files.
+  ClangTidyDiagnosticConsumer Results(Context, nullptr, true, ApplyAnyFix);
+  auto Worker = [&](IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> FS) {
+    ClangTidyContext WorkerContext(
+        std::make_unique<SharedContextOptionsProvider>(Context, OptionsMu),
+        Context.canEnableAnalyzerAlphaCheckers());
+    WorkerContext.setEnableProfiling(EnableCheckProfile);
+    WorkerContext.setEnableMatcherProfiling(
+        Context.getEnableMatcherProfiling());
+    WorkerContext.setProfileStoragePrefix(StoreCheckProfile);
+    ClangTidyDiagnosticConsumer DiagConsumer(WorkerContext, nullptr,
+                                             /*RemoveIncompatibleErrors=*/false,
+                                             ApplyAnyFix);
+    DiagnosticsEngine DE(new DiagnosticIDs(), new DiagnosticOptions(),
+                         &DiagConsumer, /*ShouldOwnClient=*/false);
+    WorkerContext.setDiagnosticsEngine(&DE);
+    ActionFactory Factory(WorkerContext, FS);
+    auto PCHContainerOps = std::make_shared<PCHContainerOperations>();
+    for (size_t I = NextFile++; I < InputFiles.size(); I = NextFile++) {
+      ClangTool Tool(Compilations, InputFiles[I], PCHContainerOps, FS);
+      Tool.appendArgumentsAdjuster(
+          getPerFileExtraArgumentsInserter(WorkerContext));
+      Tool.appendArgumentsAdjuster(getStripPluginsAdjuster());
+      Tool.setDiagnosticConsumer(&DiagConsumer);
+      Tool.run(&Factory);
     }
-
-  private:
-    class Action : public ASTFrontendAction {
-    public:
-      Action(ClangTidyASTConsumerFactory *Factory) : Factory(Factory) {}
-      std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &Compiler,
-                                                     StringRef File) override {
-        return Factory->createASTConsumer(Compiler, File);
-      }
-
-    private:
-      ClangTidyASTConsumerFactory *Factory;
-    };
-
-    ClangTidyASTConsumerFactory ConsumerFactory;
+    std::vector<ClangTidyError> Errors = DiagConsumer.take();
+    std::lock_guard<std::mutex> Lock(ResultsMu);
+    Results.addErrors(std::move(Errors), WorkerContext.getStats());
   };
 
-  ActionFactory Factory(Context, std::move(BaseFS));
-  Tool.run(&Factory);
-  return DiagConsumer.take();
+  std::vector<std::thread> Threads;
+  for (const auto &FS : WorkerFS.drop_front())
+    Threads.emplace_back(Worker, FS);
+  Worker(WorkerFS.front());
+  for (auto &Thread : Threads)
+    Thread.join();
+  return Results.take();
 }
 
 void handleErrors(llvm::ArrayRef<ClangTidyError> Errors,
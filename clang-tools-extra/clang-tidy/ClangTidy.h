@@ -82,6 +82,19 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
              bool ApplyAnyFix, bool EnableCheckProfile = false,
              llvm::StringRef StoreCheckProfile = StringRef());
 
+/// Same as runClangTidy(), but processes \p InputFiles on one thread per
+/// element of \p WorkerFS. ClangTool changes the working directory of its file
+/// system, so each thread needs its own one, and none of them may change the
+/// working directory of the process (e.g. use vfs::createPhysicalFileSystem()
+/// rather than vfs::getRealFileSystem()).
+std::vector<ClangTidyError> runClangTidyParallel(
+    clang::tidy::ClangTidyContext &Context,
+    const tooling::CompilationDatabase &Compilations,
+    ArrayRef<std::string> InputFiles,
+    ArrayRef<llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem>> WorkerFS,
+    bool ApplyAnyFix, bool EnableCheckProfile = false,
+    llvm::StringRef StoreCheckProfile = StringRef());
+
 /// Controls what kind of fixes clang-tidy is allowed to apply.
 enum FixBehaviour {
   /// Don't try to apply any fix.
@@ -721,8 +721,19 @@ struct EqualClangTidyError {
 };
 } // end anonymous namespace
 
+void ClangTidyDiagnosticConsumer::addErrors(std::vector<ClangTidyError> Other,
+                                            const ClangTidyStats &OtherStats) {
+  AddedErrors.insert(AddedErrors.end(), std::make_move_iterator(Other.begin()),
+                     std::make_move_iterator(Other.end()));
+  Context.Stats += OtherStats;
+}
+
 std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
   finalizeLastError();
+  // Added errors went through the filters of their consumer already.
+  Errors.insert(Errors.end(), std::make_move_iterator(AddedErrors.begin()),
+                std::make_move_iterator(AddedErrors.end()));
+  AddedErrors.clear();
 
   llvm::stable_sort(Errors, LessClangTidyError());
   Errors.erase(std::unique(Errors.begin(), Errors.end(), EqualClangTidyError()),
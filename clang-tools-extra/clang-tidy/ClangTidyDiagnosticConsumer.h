@@ -52,6 +52,15 @@ struct ClangTidyStats {
     return ErrorsIgnoredNOLINT + ErrorsIgnoredCheckFilter +
            ErrorsIgnoredNonUserCode + ErrorsIgnoredLineFilter;
   }
+
+  ClangTidyStats &operator+=(const ClangTidyStats &Other) {
+    ErrorsDisplayed += Other.ErrorsDisplayed;
+    ErrorsIgnoredCheckFilter += Other.ErrorsIgnoredCheckFilter;
+    ErrorsIgnoredNOLINT += Other.ErrorsIgnoredNOLINT;
+    ErrorsIgnoredNonUserCode += Other.ErrorsIgnoredNonUserCode;
+    ErrorsIgnoredLineFilter += Other.ErrorsIgnoredLineFilter;
+    return *this;
+  }
 };
 
 /// Every \c ClangTidyCheck reports errors through a \c DiagnosticsEngine
@@ -166,6 +175,10 @@ public:
   void setEnableProfiling(bool Profile);
   bool getEnableProfiling() const { return Profile; }
 
+  /// Control whether profiles also time each AST matcher of a check.
+  void setEnableMatcherProfiling(bool Profile) { MatcherProfile = Profile; }
+  bool getEnableMatcherProfiling() const { return MatcherProfile; }
+
   /// Control storage of profile date.
   void setProfileStoragePrefix(StringRef ProfilePrefix);
   llvm::Optional<ClangTidyProfiling::StorageParams>
@@ -219,6 +232,7 @@ private:
   llvm::DenseMap<unsigned, std::string> CheckNamesByDiagnosticID;
 
   bool Profile;
+  bool MatcherProfile = false;
   std::string ProfilePrefix;
 
   bool AllowEnablingAnalyzerAlphaCheckers;
@@ -256,6 +270,12 @@ public:
   // Retrieve the diagnostics that were captured.
   std::vector<ClangTidyError> take();
 
+  // Adds diagnostics captured by another consumer, e.g. one processing other
+  // translation units on another thread, and its statistics. take() will
+  // deduplicate them together with the diagnostics captured here.
+  void addErrors(std::vector<ClangTidyError> Other,
+                 const ClangTidyStats &OtherStats);
+
 private:
   void finalizeLastError();
   void removeIncompatibleErrors();
@@ -278,6 +298,7 @@ private:
   bool GetFixesFromNotes;
   bool EnableNolintBlocks;
   std::vector<ClangTidyError> Errors;
+  std::vector<ClangTidyError> AddedErrors;
   std::unique_ptr<llvm::Regex> HeaderFilter;
   bool LastErrorRelatesToUserCode;
   bool LastErrorPassesLineFilter;
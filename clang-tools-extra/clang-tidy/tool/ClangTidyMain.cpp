@@ -24,6 +24,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 
 using namespace clang::tooling;
@@ -207,6 +208,16 @@ report to stderr.
                                         cl::init(false),
                                         cl::cat(ClangTidyCategory));
 
+static cl::opt<bool> EnableMatcherProfile("enable-matcher-profile",
+                                          cl::desc(R"(
+With -enable-check-profile, additionally time
+each AST matcher of a check. The matchers of a
+check are reported as <check>#0, <check>#1, ...
+in registration order.
+)"),
+                                          cl::init(false), cl::Hidden,
+                                          cl::cat(ClangTidyCategory));
+
 static cl::opt<std::string> StoreCheckProfile("store-check-profile",
                                               cl::desc(R"(
 By default reports are printed in tabulated
@@ -241,6 +252,13 @@ options are specified.
                            cl::init(false),
                            cl::cat(ClangTidyCategory));
 
+static cl::opt<unsigned> Jobs("j", cl::desc(R"(
+Number of translation units to process in
+parallel, each on its own thread. 0 uses all
+available hardware threads.
+)"),
+                              cl::init(1), cl::cat(ClangTidyCategory));
+
 static cl::opt<std::string> VfsOverlay("vfsoverlay", cl::desc(R"(
 Overlay the virtual filesystem described by file
 over the real file system.
@@ -365,7 +383,9 @@ static std::unique_ptr<ClangTidyOptionsProvider> createOptionsProvider(
 
 llvm::IntrusiveRefCntPtr<vfs::FileSystem>
 getVfsFromFile(const std::string &OverlayFile,
-               llvm::IntrusiveRefCntPtr<vfs::FileSystem> BaseFS) {
+               llvm::IntrusiveRefCntPtr<vfs::FileSystem> BaseFS,
+               llvm::IntrusiveRefCntPtr<vfs::FileSystem> ExternalFS =
+                   vfs::getRealFileSystem()) {
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
       BaseFS->getBufferForFile(OverlayFile);
   if (!Buffer) {
@@ -375,8 +395,9 @@ getVfsFromFile(const std::string &OverlayFile,
     return nullptr;
   }
 
-  IntrusiveRefCntPtr<vfs::FileSystem> FS = vfs::getVFSFromYAML(
-      std::move(Buffer.get()), /*DiagHandler*/ nullptr, OverlayFile);
+  IntrusiveRefCntPtr<vfs::FileSystem> FS =
+      vfs::getVFSFromYAML(std::move(Buffer.get()), /*DiagHandler*/ nullptr,
+                          OverlayFile, /*DiagContext*/ nullptr, ExternalFS);
   if (!FS) {
     llvm::errs() << "Error: invalid virtual filesystem overlay file '"
                  << OverlayFile << "'.\n";
@@ -496,9 +517,37 @@ int clangTidyMain(int argc, const char **argv) {
 
   ClangTidyContext Context(std::move(OwningOptionsProvider),
                            AllowEnablingAnalyzerAlphaCheckers);
-  std::vector<ClangTidyError> Errors =
-      runClangTidy(Context, OptionsParser->getCompilations(), PathList, BaseFS,
-                   FixNotes, EnableCheckProfile, ProfilePrefix);
+  Context.setEnableMatcherProfiling(EnableMatcherProfile);
+  size_t NumJobs =
+      std::min<size_t>(llvm::hardware_concurrency(Jobs).compute_thread_count(),
+                       PathList.size());
+  std::vector<ClangTidyError> Errors;
+  if (NumJobs <= 1) {
+    Errors =
+        runClangTidy(Context, OptionsParser->getCompilations(), PathList,
+                     BaseFS, FixNotes, EnableCheckProfile, ProfilePrefix);
+  } else {
+    // Each worker needs a file system of its own, as ClangTool changes its
+    // working directory.
+    std::vector<IntrusiveRefCntPtr<vfs::OverlayFileSystem>> WorkerFS;
+    for (size_t I = 0; I < NumJobs; ++I) {
+      IntrusiveRefCntPtr<vfs::FileSystem> PhysicalFS =
+          vfs::createPhysicalFileSystem().release();
+      IntrusiveRefCntPtr<vfs::OverlayFileSystem> FS(
+          new vfs::OverlayFileSystem(PhysicalFS));
+      if (!VfsOverlay.empty()) {
+        IntrusiveRefCntPtr<vfs::FileSystem> VfsFromFile =
+            getVfsFromFile(VfsOverlay, FS, PhysicalFS);
+        if (!VfsFromFile)
+          return 1;
+        FS->pushOverlay(std::move(VfsFromFile));
+      }
+      WorkerFS.push_back(std::move(FS));
+    }
+    Errors = runClangTidyParallel(Context, OptionsParser->getCompilations(),
+                                  PathList, WorkerFS, FixNotes,
+                                  EnableCheckProfile, ProfilePrefix);
+  }
   bool FoundErrors = llvm::find_if(Errors, [](const ClangTidyError &E) {
                        return E.DiagLevel == ClangTidyError::Error;
                      }) != Errors.end();
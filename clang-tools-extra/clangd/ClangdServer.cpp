@@ -145,6 +145,8 @@ ClangdServer::Options::operator TUScheduler::Options() const {
   Opts.AsyncThreadsCount = AsyncThreadsCount;
   Opts.RetentionPolicy = RetentionPolicy;
   Opts.StorePreamblesInMemory = StorePreamblesInMemory;
+  Opts.SharePreambles = SharePreambles;
+  Opts.PreambleBuildsCount = PreambleBuildsCount;
   Opts.UpdateDebounce = UpdateDebounce;
   Opts.ContextProvider = ContextProvider;
   return Opts;
@@ -379,13 +381,27 @@ void ClangdServer::codeComplete(PathRef File, Position Pos,
     CodeCompleteOpts.AllScopes = Config::current().Completion.AllScopes;
     // FIXME(ibiryukov): even if Preamble is non-null, we may want to check
     // both the old and the new version in case only one of them matches.
+    std::unique_ptr<CompletionResultCache> ResultCache;
+    if (CodeCompleteOpts.ReuseResults) {
+      {
+        std::lock_guard<std::mutex> Lock(CachedCompletionResultsMutex);
+        ResultCache = std::move(CachedCompletionResults);
+      }
+      if (!ResultCache)
+        ResultCache = std::make_unique<CompletionResultCache>();
+    }
     CodeCompleteResult Result = clangd::codeComplete(
         File, Pos, IP->Preamble, ParseInput, CodeCompleteOpts,
-        SpecFuzzyFind ? SpecFuzzyFind.getPointer() : nullptr);
+        SpecFuzzyFind ? SpecFuzzyFind.getPointer() : nullptr,
+        ResultCache.get());
     {
       clang::clangd::trace::Span Tracer("Completion results callback");
       CB(std::move(Result));
     }
+    if (ResultCache) {
+      std::lock_guard<std::mutex> Lock(CachedCompletionResultsMutex);
+      CachedCompletionResults = std::move(ResultCache);
+    }
     if (SpecFuzzyFind && SpecFuzzyFind->NewReq.hasValue()) {
       std::lock_guard<std::mutex> Lock(CachedCompletionFuzzyFindRequestMutex);
       CachedCompletionFuzzyFindRequestByFile[File] =
@@ -107,6 +107,13 @@ public:
 
     /// Cached preambles are potentially large. If false, store them on disk.
     bool StorePreamblesInMemory = true;
+    /// Let open files with identical preamble sections and compile commands
+    /// share a single preamble. See TUScheduler::Options::SharePreambles.
+    bool SharePreambles = false;
+
+    /// Max number of preambles built at once, 0 for no limit.
+    /// See TUScheduler::Options::PreambleBuildsCount.
+    unsigned PreambleBuildsCount = 0;
 
     /// If true, ClangdServer builds a dynamic in-memory index for symbols in
     /// opened files and uses the index to augment code completion results.
@@ -425,6 +432,12 @@ private:
       CachedCompletionFuzzyFindRequestByFile;
   mutable std::mutex CachedCompletionFuzzyFindRequestMutex;
 
+  // Candidates of the last code completion, if CodeCompleteOptions.ReuseResults
+  // is set. Requests take it while running, concurrent ones start afresh.
+  // GUARDED_BY(CachedCompletionResultsMutex)
+  std::unique_ptr<CompletionResultCache> CachedCompletionResults;
+  std::mutex CachedCompletionResultsMutex;
+
   llvm::Optional<std::string> WorkspaceRoot;
   llvm::Optional<TUScheduler> WorkScheduler;
   // Invalidation policy used for actions that we assume are "transient".
@@ -1378,10 +1378,16 @@ FuzzyFindRequest speculativeFuzzyFindRequestForCompletion(
 //   - FuzzyMatcher scores how the candidate matches the partial identifier.
 //     This score is combined with the result quality score for the final score.
 //   - TopN determines the results with the best score.
+// Upper bound on the candidates kept in a CompletionResultCache. Results with
+// more candidates are not cached, as rendering all of them would slow down the
+// original request too much.
+constexpr size_t MaxReusableCandidates = 2000;
+
 class CodeCompleteFlow {
   PathRef FileName;
   IncludeStructure Includes;           // Complete once the compiler runs.
   SpeculativeFuzzyFind *SpecFuzzyFind; // Can be nullptr.
+  CompletionResultCache *ResultCache;  // Can be nullptr.
   const CodeCompleteOptions &Opts;
 
   // Sema takes ownership of Recorder. Recorder is valid until Sema cleanup.
@@ -1395,6 +1401,8 @@ class CodeCompleteFlow {
   // Counters for logging.
   int NSema = 0, NIndex = 0, NSemaAndIndex = 0, NIdent = 0;
   bool Incomplete = false; // Would more be available with a higher limit?
+  // Whether all scored candidates are recorded in ResultCache.
+  bool CollectCandidates = false;
   CompletionPrefix HeuristicPrefix;
   llvm::Optional<FuzzyMatcher> Filter; // Initialized once Sema runs.
   Range ReplacedRange;
@@ -1419,9 +1427,10 @@ public:
   // A CodeCompleteFlow object is only useful for calling run() exactly once.
   CodeCompleteFlow(PathRef FileName, const IncludeStructure &Includes,
                    SpeculativeFuzzyFind *SpecFuzzyFind,
+                   CompletionResultCache *ResultCache,
                    const CodeCompleteOptions &Opts)
       : FileName(FileName), Includes(Includes), SpecFuzzyFind(SpecFuzzyFind),
-        Opts(Opts) {}
+        ResultCache(ResultCache), Opts(Opts) {}
 
   CodeCompleteResult run(const SemaCompleteInput &SemaCCInput) && {
     trace::Span Tracer("CodeCompleteFlow");
@@ -1497,8 +1506,22 @@ public:
 
     Recorder = RecorderOwner.get();
 
+    if (ResultCache)
+      ResultCache->Valid = false;
     semaCodeComplete(std::move(RecorderOwner), Opts.getClangCompleteOpts(),
                      SemaCCInput, &Includes);
+    if (CollectCandidates) {
+      const auto &Contents = SemaCCInput.ParseInput.Contents;
+      ResultCache->Valid = true;
+      ResultCache->FileName = FileName.str();
+      ResultCache->Preamble = &SemaCCInput.Preamble;
+      ResultCache->Command = SemaCCInput.ParseInput.CompileCommand;
+      ResultCache->Contents = Contents;
+      ResultCache->Offset = SemaCCInput.Offset;
+      ResultCache->PrefixOffset = HeuristicPrefix.Name.begin() - Contents.data();
+      ResultCache->Context = Output.Context;
+      ResultCache->CompletionRange = Output.CompletionRange.getValueOr(Range());
+    }
     logResults(Output, Tracer);
     return Output;
   }
@@ -1636,9 +1659,16 @@ private:
     //        explicitly request symbols corresponding to Sema results.
     //        We can use their signals even if the index can't suggest them.
     // We must copy index results to preserve them, but there are at most Limit.
-    auto IndexResults = (Opts.Index && allowIndex(Recorder->CCContext))
-                            ? queryIndex()
-                            : SymbolSlab();
+    bool QueryIndex = Opts.Index && allowIndex(Recorder->CCContext);
+    auto IndexResults = QueryIndex ? queryIndex() : SymbolSlab();
+    // Sema results don't depend on the filter text, so they can be re-filtered
+    // when the user keeps typing. Index results for a longer query are not
+    // guaranteed to be a subset of these, so only cache Sema-only results.
+    if (ResultCache && !QueryIndex &&
+        Filter->pattern() == HeuristicPrefix.Name) {
+      CollectCandidates = true;
+      ResultCache->Candidates.clear();
+    }
     trace::Span Tracer("Populate CodeCompleteResult");
     // Merge Sema and Index results, score them, and pick the winners.
     auto Top =
@@ -1773,13 +1803,16 @@ private:
     return std::move(Top).items();
   }
 
+  static bool isMacro(const CompletionCandidate &C) {
+    return (C.SemaResult &&
+            C.SemaResult->Kind == CodeCompletionResult::RK_Macro) ||
+           (C.IndexResult &&
+            C.IndexResult->SymInfo.Kind == index::SymbolKind::Macro);
+  }
+
   llvm::Optional<float> fuzzyScore(const CompletionCandidate &C) {
     // Macros can be very spammy, so we only support prefix completion.
-    if (((C.SemaResult &&
-          C.SemaResult->Kind == CodeCompletionResult::RK_Macro) ||
-         (C.IndexResult &&
-          C.IndexResult->SymInfo.Kind == index::SymbolKind::Macro)) &&
-        !C.Name.startswith_insensitive(Filter->pattern()))
+    if (isMacro(C) && !C.Name.startswith_insensitive(Filter->pattern()))
       return None;
     return Filter->match(C.Name);
   }
@@ -1874,6 +1907,18 @@ private:
     if (Opts.RecordCCResult)
       Opts.RecordCCResult(toCodeCompletion(Bundle), Quality, Relevance,
                           Scores.Total);
+    if (CollectCandidates) {
+      if (ResultCache->Candidates.size() < MaxReusableCandidates) {
+        CompletionResultCache::Candidate Cached;
+        Cached.Completion = toCodeCompletion(Bundle);
+        Cached.Completion.Score = Scores;
+        Cached.PrefixMatchOnly = isMacro(First);
+        ResultCache->Candidates.push_back(std::move(Cached));
+      } else {
+        CollectCandidates = false;
+        ResultCache->Candidates.clear();
+      }
+    }
 
     dlog("CodeComplete: {0} ({1}) = {2}\n{3}{4}\n", First.Name,
          llvm::to_string(Origin), Scores.Total, llvm::to_string(Quality),
@@ -2001,11 +2046,83 @@ maybeFunctionArgumentCommentStart(llvm::StringRef Content) {
   return None;
 }
 
+// Answers a request from the candidates of the previous one, if the user has
+// only typed more characters of the identifier being completed since then.
+// Context words and similar signals of the cached request are kept, only the
+// name match is recomputed.
+llvm::Optional<CodeCompleteResult>
+reuseCachedCompletions(const CompletionResultCache &Cache, PathRef FileName,
+                       unsigned Offset, const PreambleData &Preamble,
+                       const ParseInputs &ParseInput,
+                       const CodeCompleteOptions &Opts) {
+  llvm::StringRef Contents = ParseInput.Contents;
+  llvm::StringRef CachedContents = Cache.Contents;
+  if (!Cache.Valid || Cache.FileName != FileName ||
+      Cache.Preamble != &Preamble ||
+      !(Cache.Command == ParseInput.CompileCommand) || Offset < Cache.Offset)
+    return None;
+  // Everything before the cached completion point and after the current one
+  // must be unchanged.
+  if (Contents.take_front(Cache.Offset) !=
+          CachedContents.take_front(Cache.Offset) ||
+      Contents.drop_front(Offset) != CachedContents.drop_front(Cache.Offset))
+    return None;
+  // The inserted text must extend the identifier being completed.
+  auto Prefix = guessCompletionPrefix(Contents, Offset);
+  if (Prefix.Name.begin() - Contents.data() != Cache.PrefixOffset)
+    return None;
+
+  trace::Span Tracer("Reuse cached completions");
+  FuzzyMatcher Filter(Prefix.Name);
+  struct ScoredCompletionGreater {
+    bool operator()(const CodeCompletion &L, const CodeCompletion &R) {
+      if (L.Score.Total != R.Score.Total)
+        return L.Score.Total > R.Score.Total;
+      return L.Name < R.Name; // Earlier name is better.
+    }
+  };
+  TopN<CodeCompletion, ScoredCompletionGreater> Top(
+      Opts.Limit == 0 ? std::numeric_limits<size_t>::max() : Opts.Limit);
+  bool Incomplete = false;
+  // Added characters are ASCII identifier characters on the same line, so the
+  // replaced token grows by as many columns.
+  Range CompletionRange = Cache.CompletionRange;
+  CompletionRange.end.character += Offset - Cache.Offset;
+  for (const auto &Cached : Cache.Candidates) {
+    const auto &Name = Cached.Completion.Name;
+    if (Cached.PrefixMatchOnly && !llvm::StringRef(Name).startswith_insensitive(
+                                      Filter.pattern()))
+      continue;
+    auto NameMatch = Filter.match(Name);
+    if (!NameMatch)
+      continue;
+    CodeCompletion C = Cached.Completion;
+    // Both ranking models use NameMatch as a multiplier on the total score.
+    C.Score.Total = *NameMatch * C.Score.ExcludingName;
+    C.CompletionTokenRange = CompletionRange;
+    if (Top.push(std::move(C)))
+      Incomplete = true;
+  }
+
+  CodeCompleteResult Output;
+  Output.Completions = std::move(Top).items();
+  Output.HasMore = Incomplete;
+  Output.Context = Cache.Context;
+  Output.CompletionRange = CompletionRange;
+  SPAN_ATTACH(Tracer, "cached_candidates", int64_t(Cache.Candidates.size()));
+  SPAN_ATTACH(Tracer, "results", int64_t(Output.Completions.size()));
+  log("Code complete: re-filtered {0} cached candidates for \"{1}\", {2} "
+      "results",
+      Cache.Candidates.size(), Prefix.Name, Output.Completions.size());
+  return Output;
+}
+
 CodeCompleteResult codeComplete(PathRef FileName, Position Pos,
                                 const PreambleData *Preamble,
                                 const ParseInputs &ParseInput,
                                 CodeCompleteOptions Opts,
-                                SpeculativeFuzzyFind *SpecFuzzyFind) {
+                                SpeculativeFuzzyFind *SpecFuzzyFind,
+                                CompletionResultCache *ResultCache) {
   auto Offset = positionToOffset(ParseInput.Contents, Pos);
   if (!Offset) {
     elog("Code completion position was invalid {0}", Offset.takeError());
@@ -2024,17 +2141,25 @@ CodeCompleteResult codeComplete(PathRef FileName, Position Pos,
                                Preamble, ParseInput);
   }
 
+  bool RunSema = Preamble && Opts.RunParser != CodeCompleteOptions::NeverParse;
+  if (!RunSema)
+    ResultCache = nullptr;
+  if (ResultCache) {
+    if (auto Reused = reuseCachedCompletions(*ResultCache, FileName, *Offset,
+                                             *Preamble, ParseInput, Opts))
+      return std::move(*Reused);
+  }
+
   auto Flow = CodeCompleteFlow(
       FileName, Preamble ? Preamble->Includes : IncludeStructure(),
-      SpecFuzzyFind, Opts);
-  return (!Preamble || Opts.RunParser == CodeCompleteOptions::NeverParse)
-             ? std::move(Flow).runWithoutSema(ParseInput.Contents, *Offset,
-                                              *ParseInput.TFS)
-             : std::move(Flow).run({FileName, *Offset, *Preamble,
-                                    /*PreamblePatch=*/
-                                    PreamblePatch::createMacroPatch(
-                                        FileName, ParseInput, *Preamble),
-                                    ParseInput});
+      SpecFuzzyFind, ResultCache, Opts);
+  return !RunSema ? std::move(Flow).runWithoutSema(ParseInput.Contents, *Offset,
+                                                   *ParseInput.TFS)
+                  : std::move(Flow).run({FileName, *Offset, *Preamble,
+                                         /*PreamblePatch=*/
+                                         PreamblePatch::createMacroPatch(
+                                             FileName, ParseInput, *Preamble),
+                                         ParseInput});
 }
 
 SignatureHelp signatureHelp(PathRef FileName, Position Pos,
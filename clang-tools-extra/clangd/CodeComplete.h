@@ -151,6 +151,11 @@ struct CodeCompleteOptions {
   /// Semantics: E.g. For Base = 1.3, if the Prediciton score reduces by 2.6
   /// points then completion score reduces by 50% or 1.3^(-2.6).
   float DecisionForestBase = 1.3f;
+
+  /// Whether to keep the candidates of a request around and re-filter them
+  /// when the user only types more characters of the same identifier, instead
+  /// of running Sema again. Honored by ClangdServer.
+  bool ReuseResults = false;
 };
 
 // Semi-structured representation of a code-complete suggestion for our C++ API.
@@ -265,6 +270,33 @@ struct SpeculativeFuzzyFind {
   std::future<SymbolSlab> Result;
 };
 
+/// Candidates of a past completion request. If the next request only extends
+/// the identifier being completed, `codeComplete()` re-filters and re-ranks
+/// these instead of running Sema again. Both filled and consumed by
+/// `codeComplete()`, callers only need to keep it around between requests.
+struct CompletionResultCache {
+  struct Candidate {
+    /// Scores are those of the cached request, Score.ExcludingName is reused.
+    CodeCompletion Completion;
+    /// Macros are only offered when their name starts with the filter text.
+    bool PrefixMatchOnly = false;
+  };
+  /// Whether Candidates hold every candidate matching the cached request.
+  bool Valid = false;
+  /// Inputs of the cached request.
+  std::string FileName;
+  const PreambleData *Preamble = nullptr;
+  tooling::CompileCommand Command;
+  std::string Contents;
+  unsigned Offset = 0;
+  /// Offset of the start of the identifier being completed.
+  unsigned PrefixOffset = 0;
+  /// Output of the cached request.
+  CodeCompletionContext::Kind Context = CodeCompletionContext::CCC_Other;
+  Range CompletionRange;
+  std::vector<Candidate> Candidates;
+};
+
 /// Gets code completions at a specified \p Pos in \p FileName.
 ///
 /// If \p Preamble is nullptr, this runs code completion without compiling the
@@ -275,11 +307,15 @@ struct SpeculativeFuzzyFind {
 /// the speculative result is used by code completion (e.g. speculation failed),
 /// the speculative result is not consumed, and `SpecFuzzyFind` is only
 /// destroyed when the async request finishes.
+///
+/// If \p ResultCache is set, it is used to answer the request without running
+/// Sema when possible, and updated with the candidates of this request.
 CodeCompleteResult codeComplete(PathRef FileName, Position Pos,
                                 const PreambleData *Preamble,
                                 const ParseInputs &ParseInput,
                                 CodeCompleteOptions Opts,
-                                SpeculativeFuzzyFind *SpecFuzzyFind = nullptr);
+                                SpeculativeFuzzyFind *SpecFuzzyFind = nullptr,
+                                CompletionResultCache *ResultCache = nullptr);
 
 /// Get signature help at a specified \p Pos in \p FileName.
 SignatureHelp signatureHelp(PathRef FileName, Position Pos,
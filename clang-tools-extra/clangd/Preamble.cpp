@@ -66,6 +66,23 @@ bool compileCommandsAreEqual(const tooling::CompileCommand &LHS,
          llvm::makeArrayRef(LHS.CommandLine).equals(RHS.CommandLine);
 }
 
+// Like compileCommandsAreEqual, but treats occurrences of each command's own
+// file name as equal.
+bool compileCommandsAreEqualExceptFile(const tooling::CompileCommand &LHS,
+                                       const tooling::CompileCommand &RHS) {
+  if (LHS.Directory != RHS.Directory ||
+      LHS.CommandLine.size() != RHS.CommandLine.size())
+    return false;
+  for (size_t I = 0; I < LHS.CommandLine.size(); ++I) {
+    if (LHS.CommandLine[I] == RHS.CommandLine[I])
+      continue;
+    if (LHS.CommandLine[I] != LHS.Filename ||
+        RHS.CommandLine[I] != RHS.Filename)
+      return false;
+  }
+  return true;
+}
+
 class CppFilePreambleCallbacks : public PreambleCallbacks {
 public:
   CppFilePreambleCallbacks(PathRef File, PreambleParsedCallback ParsedCallback)
@@ -422,6 +439,33 @@ bool isPreambleCompatible(const PreambleData &Preamble,
          Preamble.Preamble.CanReuse(CI, *ContentsBuffer, Bounds, *VFS);
 }
 
+bool canSharePreamble(const PreambleData &Preamble, const ParseInputs &Inputs,
+                      PathRef FileName, const CompilerInvocation &CI) {
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+  auto Bounds = ComputePreambleBounds(*CI.getLangOpts(), *ContentsBuffer, 0);
+  auto VFS = Inputs.TFS->view(Inputs.CompileCommand.Directory);
+  return compileCommandsAreEqualExceptFile(Inputs.CompileCommand,
+                                           Preamble.CompileCommand) &&
+         Preamble.Preamble.CanReuse(CI, *ContentsBuffer, Bounds, *VFS);
+}
+
+llvm::hash_code preambleSharingKey(const ParseInputs &Inputs,
+                                   PathRef FileName,
+                                   const CompilerInvocation &CI) {
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+  auto Bounds = ComputePreambleBounds(*CI.getLangOpts(), *ContentsBuffer, 0);
+  const tooling::CompileCommand &Cmd = Inputs.CompileCommand;
+  llvm::hash_code Hash = llvm::hash_combine(
+      Cmd.Directory, llvm::StringRef(Inputs.Contents).take_front(Bounds.Size),
+      Bounds.PreambleEndsAtStartOfLine);
+  for (const std::string &Arg : Cmd.CommandLine)
+    Hash = llvm::hash_combine(
+        Hash, Arg == Cmd.Filename ? llvm::StringRef() : llvm::StringRef(Arg));
+  return Hash;
+}
+
 void escapeBackslashAndQuotes(llvm::StringRef Text, llvm::raw_ostream &OS) {
   for (char C : Text) {
     switch (C) {
@@ -33,6 +33,7 @@
 #include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/Lex/Lexer.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringRef.h"
 
 #include <memory>
@@ -91,6 +92,19 @@ bool isPreambleCompatible(const PreambleData &Preamble,
                           const ParseInputs &Inputs, PathRef FileName,
                           const CompilerInvocation &CI);
 
+/// Returns true if \p Preamble, which may have been built for another file, is
+/// usable for \p FileName. The compile commands must only differ in the file
+/// name, the preamble sections must be identical and the headers unchanged.
+bool canSharePreamble(const PreambleData &Preamble, const ParseInputs &Inputs,
+                      PathRef FileName, const CompilerInvocation &CI);
+
+/// Returns a hash of the compile command (except for the file name) and the
+/// preamble section of \p Inputs. Preambles are only shareable between files
+/// with equal keys, see canSharePreamble().
+llvm::hash_code preambleSharingKey(const ParseInputs &Inputs,
+                                   PathRef FileName,
+                                   const CompilerInvocation &CI);
+
 /// Stores information required to parse a TU using a (possibly stale) Baseline
 /// preamble. Later on this information can be injected into the main file by
 /// updating compiler invocation with \c apply. This injected section
@@ -82,6 +82,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -116,33 +117,42 @@ class TUScheduler::ASTCache {
 public:
   using Key = const ASTWorker *;
 
-  ASTCache(unsigned MaxRetainedASTs) : MaxRetainedASTs(MaxRetainedASTs) {}
+  ASTCache(const ASTRetentionPolicy &Policy)
+      : MaxRetainedASTs(Policy.MaxRetainedASTs),
+        MaxRetainedBytes(Policy.MaxRetainedBytes) {}
 
   /// Returns result of getUsedBytes() for the AST cached by \p K.
   /// If no AST is cached, 0 is returned.
   std::size_t getUsedBytes(Key K) {
     std::lock_guard<std::mutex> Lock(Mut);
     auto It = findByKey(K);
-    if (It == LRU.end() || !It->second)
+    if (It == LRU.end() || !It->AST)
       return 0;
-    return It->second->getUsedBytes();
+    return It->AST->getUsedBytes();
   }
 
-  /// Store the value in the pool, possibly removing the last used AST.
+  /// Store the value in the pool, possibly removing the least recently used
+  /// ASTs.
   /// The value should not be in the pool when this function is called.
   void put(Key K, std::unique_ptr<ParsedAST> V) {
+    std::size_t Bytes = V ? V->getUsedBytes() : 0;
     std::unique_lock<std::mutex> Lock(Mut);
     assert(findByKey(K) == LRU.end());
 
-    LRU.insert(LRU.begin(), {K, std::move(V)});
-    if (LRU.size() <= MaxRetainedASTs)
-      return;
-    // We're past the limit, remove the last element.
-    std::unique_ptr<ParsedAST> ForCleanup = std::move(LRU.back().second);
-    LRU.pop_back();
+    LRU.insert(LRU.begin(), {K, std::move(V), Bytes});
+    RetainedBytes += Bytes;
+    std::vector<std::unique_ptr<ParsedAST>> ForCleanup;
+    // We're past the limits, remove the last elements.
+    while (LRU.size() > MaxRetainedASTs ||
+           (MaxRetainedBytes && RetainedBytes > MaxRetainedBytes &&
+            LRU.size() > 1)) {
+      ForCleanup.push_back(std::move(LRU.back().AST));
+      RetainedBytes -= LRU.back().Bytes;
+      LRU.pop_back();
+    }
     // Run the expensive destructor outside the lock.
     Lock.unlock();
-    ForCleanup.reset();
+    ForCleanup.clear();
   }
 
   /// Returns the cached value for \p K, or llvm::None if the value is not in
@@ -161,7 +171,8 @@ public:
     }
     if (AccessMetric)
       AccessMetric->record(1, "hit");
-    std::unique_ptr<ParsedAST> V = std::move(Existing->second);
+    std::unique_ptr<ParsedAST> V = std::move(Existing->AST);
+    RetainedBytes -= Existing->Bytes;
     LRU.erase(Existing);
     // GCC 4.8 fails to compile `return V;`, as it tries to call the copy
     // constructor of unique_ptr, so we call the move ctor explicitly to avoid
@@ -170,17 +181,23 @@ public:
   }
 
 private:
-  using KVPair = std::pair<Key, std::unique_ptr<ParsedAST>>;
+  struct Entry {
+    Key K;
+    std::unique_ptr<ParsedAST> AST;
+    std::size_t Bytes; // getUsedBytes() when the AST was put.
+  };
 
-  std::vector<KVPair>::iterator findByKey(Key K) {
-    return llvm::find_if(LRU, [K](const KVPair &P) { return P.first == K; });
+  std::vector<Entry>::iterator findByKey(Key K) {
+    return llvm::find_if(LRU, [K](const Entry &E) { return E.K == K; });
   }
 
   std::mutex Mut;
   unsigned MaxRetainedASTs;
+  std::size_t MaxRetainedBytes;
+  std::size_t RetainedBytes = 0; /* GUARDED_BY(Mut) */
   /// Items sorted in LRU order, i.e. first item is the most recently accessed
   /// one.
-  std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
+  std::vector<Entry> LRU; /* GUARDED_BY(Mut) */
 };
 
 /// A map from header files to an opened "proxy" file that includes them.
@@ -307,6 +324,106 @@ public:
   }
 };
 
+/// Preambles are keyed by preambleSharingKey(), and are candidates for files
+/// with the same key only if canSharePreamble() agrees.
+///
+/// Preambles are held weakly, they stay alive only while some file uses them.
+/// All methods are threadsafe, and called from preamble threads.
+class TUScheduler::SharedPreambleCache {
+  std::mutex Mu;
+  llvm::DenseMap<llvm::hash_code, std::vector<std::weak_ptr<const PreambleData>>>
+      Preambles;
+
+public:
+  /// Returns a live preamble with \p Key that satisfies \p CanUse, if any.
+  std::shared_ptr<const PreambleData>
+  get(llvm::hash_code Key,
+      llvm::function_ref<bool(const PreambleData &)> CanUse) {
+    std::vector<std::shared_ptr<const PreambleData>> Candidates;
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      auto It = Preambles.find(Key);
+      if (It == Preambles.end())
+        return nullptr;
+      for (const auto &Preamble : It->second)
+        if (auto Candidate = Preamble.lock())
+          Candidates.push_back(std::move(Candidate));
+    }
+    // Checking headers for changes does IO, so don't hold the lock.
+    for (auto &Candidate : Candidates)
+      if (CanUse(*Candidate))
+        return std::move(Candidate);
+    return nullptr;
+  }
+
+  void put(llvm::hash_code Key, std::shared_ptr<const PreambleData> Preamble) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto &Entries = Preambles[Key];
+    llvm::erase_if(Entries, [](const std::weak_ptr<const PreambleData> &P) {
+      return P.expired();
+    });
+    Entries.push_back(std::move(Preamble));
+  }
+};
+
+/// A counting semaphore for preamble builds that hands free slots to the
+/// active file first, and to the other files in the order they asked.
+/// Waiting can be abandoned, e.g. when the queued build becomes obsolete.
+///
+/// All methods are threadsafe.
+class TUScheduler::PreambleThrottler {
+  std::mutex Mu;
+  std::condition_variable SlotsChanged;
+  size_t FreeSlots;
+  std::string ActiveFile;
+  std::deque<PathRef> Waiting; // Files waiting for a slot, oldest first.
+
+  // Whether File should get the next free slot.
+  bool isNext(PathRef File) const {
+    if (llvm::is_contained(Waiting, ActiveFile))
+      return File == ActiveFile;
+    return File == Waiting.front();
+  }
+
+public:
+  PreambleThrottler(size_t MaxBuilds) : FreeSlots(MaxBuilds) {}
+
+  /// Blocks until \p File may build its preamble, and returns true. Returns
+  /// false without acquiring a slot if \p Cancelled becomes true first.
+  /// Anything that can change \p Cancelled must call wake() afterwards.
+  bool acquire(PathRef File, llvm::function_ref<bool()> Cancelled) {
+    std::unique_lock<std::mutex> Lock(Mu);
+    Waiting.push_back(File);
+    SlotsChanged.wait(Lock, [&] {
+      return Cancelled() || (FreeSlots > 0 && isNext(File));
+    });
+    Waiting.erase(llvm::find(Waiting, File));
+    // Others may be next now.
+    SlotsChanged.notify_all();
+    if (Cancelled())
+      return false;
+    --FreeSlots;
+    return true;
+  }
+
+  void release() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    ++FreeSlots;
+    SlotsChanged.notify_all();
+  }
+
+  void setActiveFile(PathRef File) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    ActiveFile = File.str();
+    SlotsChanged.notify_all();
+  }
+
+  void wake() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    SlotsChanged.notify_all();
+  }
+};
+
 namespace {
 
 bool isReliable(const tooling::CompileCommand &Cmd) {
@@ -356,10 +473,12 @@ public:
                  bool StorePreambleInMemory, bool RunSync,
                  SynchronizedTUStatus &Status,
                  TUScheduler::HeaderIncluderCache &HeaderIncluders,
-                 ASTWorker &AW)
+                 TUScheduler::SharedPreambleCache *SharedPreambles,
+                 TUScheduler::PreambleThrottler *Throttler, ASTWorker &AW)
       : FileName(FileName), Callbacks(Callbacks),
         StoreInMemory(StorePreambleInMemory), RunSync(RunSync), Status(Status),
-        ASTPeer(AW), HeaderIncluders(HeaderIncluders) {}
+        ASTPeer(AW), HeaderIncluders(HeaderIncluders),
+        SharedPreambles(SharedPreambles), Throttler(Throttler) {}
 
   /// It isn't guaranteed that each requested version will be built. If there
   /// are multiple update requests while building a preamble, only the last one
@@ -389,6 +508,9 @@ public:
     // Let the worker thread know there's a request, notify_one is safe as there
     // should be a single worker thread waiting on it.
     ReqCV.notify_all();
+    // A build waiting for its turn may be obsolete now.
+    if (Throttler)
+      Throttler->wake();
   }
 
   void run() {
@@ -404,7 +526,13 @@ public:
         NextReq.reset();
       }
 
-      {
+      // Wait for our turn to build. Skip the build if a newer request makes
+      // it obsolete in the meantime, unless diagnostics for it are required.
+      if (!Throttler || Throttler->acquire(FileName, [this] {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            return Done ||
+                   (NextReq && CurrentReq->WantDiags != WantDiagnostics::Yes);
+          })) {
         WithContext Guard(std::move(CurrentReq->Ctx));
         // Note that we don't make use of the ContextProvider here.
         // Preamble tasks are always scheduled by ASTWorker tasks, and we
@@ -412,6 +540,8 @@ public:
 
         // Build the preamble and let the waiters know about it.
         build(std::move(*CurrentReq));
+        if (Throttler)
+          Throttler->release();
       }
       bool IsEmpty = false;
       {
@@ -442,6 +572,8 @@ public:
     }
     // Let the worker thread know that it should stop.
     ReqCV.notify_all();
+    if (Throttler)
+      Throttler->wake();
   }
 
   bool blockUntilIdle(Deadline Timeout) const {
@@ -487,6 +619,8 @@ private:
   SynchronizedTUStatus &Status;
   ASTWorker &ASTPeer;
   TUScheduler::HeaderIncluderCache &HeaderIncluders;
+  TUScheduler::SharedPreambleCache *SharedPreambles; // May be null.
+  TUScheduler::PreambleThrottler *Throttler;         // May be null.
 };
 
 class ASTWorkerHandle;
@@ -506,7 +640,9 @@ class ASTWorker {
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
             TUScheduler::ASTCache &LRUCache,
             TUScheduler::HeaderIncluderCache &HeaderIncluders,
-            Semaphore &Barrier, bool RunSync, const TUScheduler::Options &Opts,
+            TUScheduler::SharedPreambleCache *SharedPreambles,
+            TUScheduler::PreambleThrottler *Throttler, Semaphore &Barrier,
+            bool RunSync, const TUScheduler::Options &Opts,
             ParsingCallbacks &Callbacks);
 
 public:
@@ -519,8 +655,10 @@ public:
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
          TUScheduler::ASTCache &IdleASTs,
          TUScheduler::HeaderIncluderCache &HeaderIncluders,
-         AsyncTaskRunner *Tasks, Semaphore &Barrier,
-         const TUScheduler::Options &Opts, ParsingCallbacks &Callbacks);
+         TUScheduler::SharedPreambleCache *SharedPreambles,
+         TUScheduler::PreambleThrottler *Throttler, AsyncTaskRunner *Tasks,
+         Semaphore &Barrier, const TUScheduler::Options &Opts,
+         ParsingCallbacks &Callbacks);
   ~ASTWorker();
 
   void update(ParseInputs Inputs, WantDiagnostics, bool ContentChanged);
@@ -716,12 +854,14 @@ ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
                   TUScheduler::ASTCache &IdleASTs,
                   TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                  TUScheduler::SharedPreambleCache *SharedPreambles,
+                  TUScheduler::PreambleThrottler *Throttler,
                   AsyncTaskRunner *Tasks, Semaphore &Barrier,
                   const TUScheduler::Options &Opts,
                   ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, HeaderIncluders, Barrier,
-                    /*RunSync=*/!Tasks, Opts, Callbacks));
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, HeaderIncluders, SharedPreambles, Throttler,
+      Barrier, /*RunSync=*/!Tasks, Opts, Callbacks));
   if (Tasks) {
     Tasks->runAsync("ASTWorker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -735,6 +875,8 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
                      TUScheduler::ASTCache &LRUCache,
                      TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                     TUScheduler::SharedPreambleCache *SharedPreambles,
+                     TUScheduler::PreambleThrottler *Throttler,
                      Semaphore &Barrier, bool RunSync,
                      const TUScheduler::Options &Opts,
                      ParsingCallbacks &Callbacks)
@@ -743,7 +885,8 @@ ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
       ContextProvider(Opts.ContextProvider), CDB(CDB), Callbacks(Callbacks),
       Barrier(Barrier), Done(false), Status(FileName, Callbacks),
       PreamblePeer(FileName, Callbacks, Opts.StorePreamblesInMemory, RunSync,
-                   Status, HeaderIncluders, *this) {
+                   Status, HeaderIncluders, SharedPreambles, Throttler,
+                   *this) {
   // Set a fallback command because compile command can be accessed before
   // `Inputs` is initialized. Other fields are only used after initialization
   // from client inputs.
@@ -969,17 +1112,36 @@ void PreambleThread::build(Request Req) {
          FileName, Inputs.Version, LatestBuild->Version);
   }
 
-  ThreadCrashReporter ScopedReporter([&Inputs]() {
-    llvm::errs() << "Signalled while building preamble\n";
-    crashDumpParseInputs(llvm::errs(), Inputs);
-  });
-
-  LatestBuild = clang::clangd::buildPreamble(
-      FileName, *Req.CI, Inputs, StoreInMemory,
-      [this, Version(Inputs.Version)](ASTContext &Ctx, Preprocessor &PP,
-                                      const CanonicalIncludes &CanonIncludes) {
-        Callbacks.onPreambleAST(FileName, Version, Ctx, PP, CanonIncludes);
+  llvm::hash_code SharingKey = 0;
+  std::shared_ptr<const PreambleData> Shared;
+  if (SharedPreambles) {
+    SharingKey = preambleSharingKey(Inputs, FileName, *Req.CI);
+    if (!Inputs.ForceRebuild)
+      Shared = SharedPreambles->get(SharingKey, [&](const PreambleData &P) {
+        return canSharePreamble(P, Inputs, FileName, *Req.CI);
       });
+  }
+
+  if (Shared) {
+    vlog("Using preamble of {0} for version {1} of {2}",
+         Shared->CompileCommand.Filename, Inputs.Version, FileName);
+    LatestBuild = std::move(Shared);
+  } else {
+    ThreadCrashReporter ScopedReporter([&Inputs]() {
+      llvm::errs() << "Signalled while building preamble\n";
+      crashDumpParseInputs(llvm::errs(), Inputs);
+    });
+
+    LatestBuild = clang::clangd::buildPreamble(
+        FileName, *Req.CI, Inputs, StoreInMemory,
+        [this, Version(Inputs.Version)](
+            ASTContext &Ctx, Preprocessor &PP,
+            const CanonicalIncludes &CanonIncludes) {
+          Callbacks.onPreambleAST(FileName, Version, Ctx, PP, CanonIncludes);
+        });
+    if (LatestBuild && SharedPreambles)
+      SharedPreambles->put(SharingKey, LatestBuild);
+  }
   if (LatestBuild && isReliable(LatestBuild->CompileCommand))
     HeaderIncluders.update(FileName, LatestBuild->Includes.allHeaders());
 }
@@ -1507,7 +1669,7 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
                           : std::make_unique<ParsingCallbacks>()),
       Barrier(Opts.AsyncThreadsCount), QuickRunBarrier(Opts.AsyncThreadsCount),
       IdleASTs(
-          std::make_unique<ASTCache>(Opts.RetentionPolicy.MaxRetainedASTs)),
+          std::make_unique<ASTCache>(Opts.RetentionPolicy)),
       HeaderIncluders(std::make_unique<HeaderIncluderCache>()) {
   // Avoid null checks everywhere.
   if (!Opts.ContextProvider) {
@@ -1515,9 +1677,13 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
       return Context::current().clone();
     };
   }
+  if (Opts.SharePreambles)
+    SharedPreambles = std::make_unique<SharedPreambleCache>();
   if (0 < Opts.AsyncThreadsCount) {
     PreambleTasks.emplace();
     WorkerThreads.emplace();
+    if (Opts.PreambleBuildsCount)
+      Throttler = std::make_unique<PreambleThrottler>(Opts.PreambleBuildsCount);
   }
 }
 
@@ -1551,6 +1717,7 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker =
         ASTWorker::create(File, CDB, *IdleASTs, *HeaderIncluders,
+                          SharedPreambles.get(), Throttler.get(),
                           WorkerThreads ? WorkerThreads.getPointer() : nullptr,
                           Barrier, Opts, *Callbacks);
     FD = std::unique_ptr<FileData>(
@@ -1563,8 +1730,11 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
   FD->Worker->update(std::move(Inputs), WantDiags, ContentChanged);
   // There might be synthetic update requests, don't change the LastActiveFile
   // in such cases.
-  if (ContentChanged)
+  if (ContentChanged) {
     LastActiveFile = File.str();
+    if (Throttler)
+      Throttler->setActiveFile(File);
+  }
   return NewFile;
 }
 
@@ -1623,6 +1793,8 @@ void TUScheduler::runWithAST(
     return;
   }
   LastActiveFile = File.str();
+  if (Throttler)
+    Throttler->setActiveFile(File);
 
   It->second->Worker->runWithAST(Name, std::move(Action), Invalidation);
 }
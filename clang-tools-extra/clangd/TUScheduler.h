@@ -64,6 +64,9 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum total size of the retained ASTs, in bytes. The most recently used
+  /// AST is retained regardless. If 0, only MaxRetainedASTs applies.
+  size_t MaxRetainedBytes = 0;
 };
 
 /// Clangd may wait after an update to see if another one comes along.
@@ -194,6 +197,18 @@ public:
     /// Cache (large) preamble data in RAM rather than temporary files on disk.
     bool StorePreamblesInMemory = false;
 
+    /// Let files with the same compile command (up to the file name) and the
+    /// same preamble section use a single preamble, rather than each building
+    /// its own. Positions in the shared section refer to the file that built
+    /// it, and its symbols are only indexed once.
+    bool SharePreambles = false;
+
+    /// Max number of preambles built concurrently across all files. Once the
+    /// limit is reached, the most recently edited file is built first, and
+    /// queued builds are skipped when a newer version of the file arrives.
+    /// If 0, preamble builds are not limited.
+    unsigned PreambleBuildsCount = 0;
+
     /// Time to wait after an update to see if another one comes along.
     /// This tries to ensure we rebuild once the user stops typing.
     DebouncePolicy UpdateDebounce;
@@ -314,6 +329,10 @@ public:
   class ASTCache;
   /// Tracks headers included by open files, to get known-good compile commands.
   class HeaderIncluderCache;
+  /// Tracks preambles of open files, so other files can use them.
+  class SharedPreambleCache;
+  /// Limits concurrent preamble builds, see Options::PreambleBuildsCount.
+  class PreambleThrottler;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -337,6 +356,8 @@ private:
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
   std::unique_ptr<HeaderIncluderCache> HeaderIncluders;
+  std::unique_ptr<SharedPreambleCache> SharedPreambles; // If enabled.
+  std::unique_ptr<PreambleThrottler> Throttler;           // If enabled.
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
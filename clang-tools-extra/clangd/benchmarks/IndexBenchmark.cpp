@@ -8,11 +8,14 @@
 
 #include "../index/Serialization.h"
 #include "../index/dex/Dex.h"
+#include "../index/dex/Iterator.h"
+#include "../index/dex/PostingList.h"
 #include "benchmark/benchmark.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Regex.h"
+#include <random>
 #include <string>
 
 const char *IndexFilename;
@@ -97,6 +100,37 @@ static void dexBuild(benchmark::State &State) {
 }
 BENCHMARK(dexBuild);
 
+// Returns a sorted list of Count distinct DocIDs below Size. The same seed
+// always yields the same list so runs are comparable.
+std::vector<dex::DocID> generateDocIDs(dex::DocID Size, size_t Count,
+                                       unsigned Seed) {
+  std::mt19937 Generator(Seed);
+  std::uniform_int_distribution<dex::DocID> Distribution(0, Size - 1);
+  std::vector<dex::DocID> IDs;
+  IDs.reserve(Count);
+  for (size_t I = 0; I < Count; ++I)
+    IDs.push_back(Distribution(Generator));
+  llvm::sort(IDs);
+  IDs.erase(std::unique(IDs.begin(), IDs.end()), IDs.end());
+  return IDs;
+}
+
+// Intersects a dense posting list with a sparse one, which is the common shape
+// of trigram queries. Uses synthetic posting lists instead of the index.
+static void dexIntersectPostingLists(benchmark::State &State) {
+  constexpr dex::DocID CorpusSize = 1 << 20;
+  const dex::PostingList Dense(generateDocIDs(CorpusSize, CorpusSize / 4, 1));
+  const dex::PostingList Sparse(generateDocIDs(CorpusSize, State.range(0), 2));
+  const dex::Corpus C(CorpusSize);
+  for (auto _ : State) {
+    std::vector<std::unique_ptr<dex::Iterator>> Children;
+    Children.push_back(Dense.iterator());
+    Children.push_back(Sparse.iterator());
+    benchmark::DoNotOptimize(consume(*C.intersect(std::move(Children))));
+  }
+}
+BENCHMARK(dexIntersectPostingLists)->Range(64, 64 << 10);
+
 } // namespace
 } // namespace clangd
 } // namespace clang
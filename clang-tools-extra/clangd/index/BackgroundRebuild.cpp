@@ -16,6 +16,7 @@
 #include "index/FileIndex.h"
 #include "index/IndexAction.h"
 #include "index/MemIndex.h"
+#include "index/Merge.h"
 #include "index/Ref.h"
 #include "index/Relation.h"
 #include "index/Serialization.h"
@@ -48,6 +49,23 @@
 
 namespace clang {
 namespace clangd {
+namespace {
+
+// Serves the shards updated since a full build on top of that full build.
+class LayeredIndex : public MergedIndex {
+public:
+  LayeredIndex(std::unique_ptr<SymbolIndex> Delta,
+               std::shared_ptr<SymbolIndex> Full)
+      : MergedIndex(Delta.get(), Full.get()), Delta(std::move(Delta)),
+        Full(std::move(Full)) {}
+
+private:
+  std::unique_ptr<SymbolIndex> Delta;
+  // Shared with the other layered indexes built since the full build.
+  std::shared_ptr<SymbolIndex> Full;
+};
+
+} // namespace
 
 bool BackgroundIndexRebuilder::enoughTUsToRebuild() const {
   if (!ActiveVersion)                         // never built
@@ -105,20 +123,35 @@ void BackgroundIndexRebuilder::shutdown() {
 void BackgroundIndexRebuilder::maybeRebuild(const char *Reason,
                                             std::function<bool()> Check) {
   unsigned BuildVersion = 0;
+  std::shared_ptr<SymbolIndex> Full;
+  size_t FullVersion = 0;
   {
     std::lock_guard<std::mutex> Lock(Mu);
     if (!ShouldStop && Check()) {
       BuildVersion = ++StartedVersion;
       IndexedTUsAtLastRebuild = IndexedTUs;
+      Full = FullIndex;
+      FullVersion = FullIndexVersion;
     }
   }
   if (BuildVersion) {
     std::unique_ptr<SymbolIndex> NewIndex;
+    size_t SourceVersion = 0;
     {
       vlog("BackgroundIndex: building version {0} {1}", BuildVersion, Reason);
       trace::Span Tracer("RebuildBackgroundIndex");
       SPAN_ATTACH(Tracer, "reason", Reason);
-      NewIndex = Source->buildIndex(IndexType::Heavy, DuplicateHandling::Merge);
+      if (Full) {
+        if (auto Delta = Source->buildDeltaIndex(
+                FullVersion, ShardsBeforeFullBuild, IndexType::Heavy,
+                DuplicateHandling::Merge))
+          NewIndex =
+              std::make_unique<LayeredIndex>(std::move(Delta), std::move(Full));
+      }
+      SPAN_ATTACH(Tracer, "full", !NewIndex);
+      if (!NewIndex)
+        NewIndex = Source->buildIndex(IndexType::Heavy,
+                                      DuplicateHandling::Merge, &SourceVersion);
     }
     {
       std::lock_guard<std::mutex> Lock(Mu);
@@ -128,6 +161,10 @@ void BackgroundIndexRebuilder::maybeRebuild(const char *Reason,
         vlog("BackgroundIndex: serving version {0} ({1} bytes)", BuildVersion,
              NewIndex->estimateMemoryUsage());
         Target->reset(std::move(NewIndex));
+        if (SourceVersion) {
+          FullIndex = Target->snapshot();
+          FullIndexVersion = SourceVersion;
+        }
       }
     }
   }
@@ -40,6 +40,10 @@ namespace clangd {
 //
 // The index is rebuilt every time the queue goes idle, if it's stale.
 //
+// Rebuilding everything is O(index), so once a full build is being served,
+// further rebuilds only build the shards updated since then and layer them over
+// the full build. A full build is done again when too many shards were updated.
+//
 // All methods are threadsafe. They're called after FileSymbols is updated
 // etc. Without external locking, the rebuilt index may include more updates
 // than intended, which is fine.
@@ -73,6 +77,8 @@ public:
   // Thresholds for rebuilding as TUs get indexed. Exposed for testing.
   const unsigned TUsBeforeFirstBuild; // Typically one per worker thread.
   const unsigned TUsBeforeRebuild = 100;
+  // Max number of updated shards layered over the last full build.
+  const size_t ShardsBeforeFullBuild = 1000;
 
 private:
   // Run Check under the lock, and rebuild if it returns true.
@@ -91,6 +97,9 @@ private:
   // Are we loading shards? May be multiple concurrent sessions.
   unsigned Loading = 0;
   unsigned LoadedShards; // In the current loading session.
+  // The last full build that was served, and the Source version it reflects.
+  std::shared_ptr<SymbolIndex> FullIndex;
+  size_t FullIndexVersion = 0;
 
   SwapIndex *Target;
   FileSymbols *Source;
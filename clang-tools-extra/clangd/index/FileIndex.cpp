@@ -121,6 +121,123 @@ IncludeGraph getSubGraph(llvm::StringRef URI, const IncludeGraph &FullGraph) {
   }
   return IG;
 }
+
+// Builds an index owning the given slabs. Symbols are merged or deduplicated
+// according to DuplicateHandle, and refs in MainFileRefs are counted towards
+// Symbol::References when merging.
+std::unique_ptr<SymbolIndex>
+buildIndexFromSlabs(IndexType Type, DuplicateHandling DuplicateHandle,
+                    IndexContents IdxContents,
+                    std::vector<std::shared_ptr<SymbolSlab>> SymbolSlabs,
+                    std::vector<std::shared_ptr<RefSlab>> RefSlabs,
+                    std::vector<std::shared_ptr<RelationSlab>> RelationSlabs,
+                    llvm::StringSet<> Files,
+                    llvm::ArrayRef<RefSlab *> MainFileRefs) {
+  std::vector<const Symbol *> AllSymbols;
+  std::vector<Symbol> SymsStorage;
+  switch (DuplicateHandle) {
+  case DuplicateHandling::Merge: {
+    llvm::DenseMap<SymbolID, Symbol> Merged;
+    for (const auto &Slab : SymbolSlabs) {
+      for (const auto &Sym : *Slab) {
+        assert(Sym.References == 0 &&
+               "Symbol with non-zero references sent to FileSymbols");
+        auto I = Merged.try_emplace(Sym.ID, Sym);
+        if (!I.second)
+          I.first->second = mergeSymbol(I.first->second, Sym);
+      }
+    }
+    for (const RefSlab *Refs : MainFileRefs)
+      for (const auto &Sym : *Refs) {
+        auto It = Merged.find(Sym.first);
+        // This might happen while background-index is still running.
+        if (It == Merged.end())
+          continue;
+        It->getSecond().References += Sym.second.size();
+      }
+    SymsStorage.reserve(Merged.size());
+    for (auto &Sym : Merged) {
+      SymsStorage.push_back(std::move(Sym.second));
+      AllSymbols.push_back(&SymsStorage.back());
+    }
+    break;
+  }
+  case DuplicateHandling::PickOne: {
+    llvm::DenseSet<SymbolID> AddedSymbols;
+    for (const auto &Slab : SymbolSlabs)
+      for (const auto &Sym : *Slab) {
+        assert(Sym.References == 0 &&
+               "Symbol with non-zero references sent to FileSymbols");
+        if (AddedSymbols.insert(Sym.ID).second)
+          AllSymbols.push_back(&Sym);
+      }
+    break;
+  }
+  }
+
+  std::vector<Ref> RefsStorage; // Contiguous ranges for each SymbolID.
+  llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> AllRefs;
+  {
+    llvm::DenseMap<SymbolID, llvm::SmallVector<Ref, 4>> MergedRefs;
+    size_t Count = 0;
+    for (const auto &RefSlab : RefSlabs)
+      for (const auto &Sym : *RefSlab) {
+        MergedRefs[Sym.first].append(Sym.second.begin(), Sym.second.end());
+        Count += Sym.second.size();
+      }
+    RefsStorage.reserve(Count);
+    AllRefs.reserve(MergedRefs.size());
+    for (auto &Sym : MergedRefs) {
+      auto &SymRefs = Sym.second;
+      // Sorting isn't required, but yields more stable results over rebuilds.
+      llvm::sort(SymRefs);
+      llvm::copy(SymRefs, back_inserter(RefsStorage));
+      AllRefs.try_emplace(
+          Sym.first,
+          llvm::ArrayRef<Ref>(&RefsStorage[RefsStorage.size() - SymRefs.size()],
+                              SymRefs.size()));
+    }
+  }
+
+  std::vector<Relation> AllRelations;
+  for (const auto &RelationSlab : RelationSlabs) {
+    for (const auto &R : *RelationSlab)
+      AllRelations.push_back(R);
+  }
+  // Sort relations and remove duplicates that could arise due to
+  // relations being stored in both the shards containing their
+  // subject and object.
+  llvm::sort(AllRelations);
+  AllRelations.erase(std::unique(AllRelations.begin(), AllRelations.end()),
+                     AllRelations.end());
+
+  size_t StorageSize =
+      RefsStorage.size() * sizeof(Ref) + SymsStorage.size() * sizeof(Symbol);
+  for (const auto &Slab : SymbolSlabs)
+    StorageSize += Slab->bytes();
+  for (const auto &RefSlab : RefSlabs)
+    StorageSize += RefSlab->bytes();
+
+  // Index must keep the slabs and contiguous ranges alive.
+  switch (Type) {
+  case IndexType::Light:
+    return std::make_unique<MemIndex>(
+        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
+        std::move(AllRelations), std::move(Files), IdxContents,
+        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
+                        std::move(RefsStorage), std::move(SymsStorage)),
+        StorageSize);
+  case IndexType::Heavy:
+    return std::make_unique<dex::Dex>(
+        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
+        std::move(AllRelations), std::move(Files), IdxContents,
+        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
+                        std::move(RefsStorage), std::move(SymsStorage)),
+        StorageSize);
+  }
+  llvm_unreachable("Unknown clangd::IndexType");
+}
+
 } // namespace
 
 FileShardedIndex::FileShardedIndex(IndexFileIn Input)
@@ -247,7 +364,7 @@ void FileSymbols::update(llvm::StringRef Key,
                          std::unique_ptr<RelationSlab> Relations,
                          bool CountReferences) {
   std::lock_guard<std::mutex> Lock(Mutex);
-  ++Version;
+  LastUpdate[Key] = ++Version;
   if (!Symbols)
     SymbolsSnapshot.erase(Key);
   else
@@ -294,109 +411,53 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle,
     if (Version)
       *Version = this->Version;
   }
-  std::vector<const Symbol *> AllSymbols;
-  std::vector<Symbol> SymsStorage;
-  switch (DuplicateHandle) {
-  case DuplicateHandling::Merge: {
-    llvm::DenseMap<SymbolID, Symbol> Merged;
-    for (const auto &Slab : SymbolSlabs) {
-      for (const auto &Sym : *Slab) {
-        assert(Sym.References == 0 &&
-               "Symbol with non-zero references sent to FileSymbols");
-        auto I = Merged.try_emplace(Sym.ID, Sym);
-        if (!I.second)
-          I.first->second = mergeSymbol(I.first->second, Sym);
-      }
-    }
-    for (const RefSlab *Refs : MainFileRefs)
-      for (const auto &Sym : *Refs) {
-        auto It = Merged.find(Sym.first);
-        // This might happen while background-index is still running.
-        if (It == Merged.end())
-          continue;
-        It->getSecond().References += Sym.second.size();
-      }
-    SymsStorage.reserve(Merged.size());
-    for (auto &Sym : Merged) {
-      SymsStorage.push_back(std::move(Sym.second));
-      AllSymbols.push_back(&SymsStorage.back());
-    }
-    break;
-  }
-  case DuplicateHandling::PickOne: {
-    llvm::DenseSet<SymbolID> AddedSymbols;
-    for (const auto &Slab : SymbolSlabs)
-      for (const auto &Sym : *Slab) {
-        assert(Sym.References == 0 &&
-               "Symbol with non-zero references sent to FileSymbols");
-        if (AddedSymbols.insert(Sym.ID).second)
-          AllSymbols.push_back(&Sym);
-      }
-    break;
-  }
-  }
+  return buildIndexFromSlabs(Type, DuplicateHandle, IdxContents,
+                             std::move(SymbolSlabs), std::move(RefSlabs),
+                             std::move(RelationSlabs), std::move(Files),
+                             MainFileRefs);
+}
 
-  std::vector<Ref> RefsStorage; // Contiguous ranges for each SymbolID.
-  llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> AllRefs;
+std::unique_ptr<SymbolIndex>
+FileSymbols::buildDeltaIndex(size_t SinceVersion, size_t MaxKeys,
+                             IndexType Type, DuplicateHandling DuplicateHandle,
+                             size_t *Version) {
+  std::vector<std::shared_ptr<SymbolSlab>> SymbolSlabs;
+  std::vector<std::shared_ptr<RefSlab>> RefSlabs;
+  std::vector<std::shared_ptr<RelationSlab>> RelationSlabs;
+  llvm::StringSet<> Files;
+  std::vector<RefSlab *> MainFileRefs;
   {
-    llvm::DenseMap<SymbolID, llvm::SmallVector<Ref, 4>> MergedRefs;
-    size_t Count = 0;
-    for (const auto &RefSlab : RefSlabs)
-      for (const auto &Sym : *RefSlab) {
-        MergedRefs[Sym.first].append(Sym.second.begin(), Sym.second.end());
-        Count += Sym.second.size();
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (const auto &KeyAndVersion : LastUpdate) {
+      if (KeyAndVersion.second <= SinceVersion)
+        continue;
+      if (Files.size() == MaxKeys)
+        return nullptr;
+      llvm::StringRef Key = KeyAndVersion.first();
+      // Removed keys are still recorded in Files, so that the delta hides
+      // their stale data in the older index.
+      Files.insert(Key);
+      auto Symbols = SymbolsSnapshot.find(Key);
+      if (Symbols != SymbolsSnapshot.end())
+        SymbolSlabs.push_back(Symbols->second);
+      auto Refs = RefsSnapshot.find(Key);
+      if (Refs != RefsSnapshot.end()) {
+        RefSlabs.push_back(Refs->second.Slab);
+        if (Refs->second.CountReferences)
+          MainFileRefs.push_back(RefSlabs.back().get());
       }
-    RefsStorage.reserve(Count);
-    AllRefs.reserve(MergedRefs.size());
-    for (auto &Sym : MergedRefs) {
-      auto &SymRefs = Sym.second;
-      // Sorting isn't required, but yields more stable results over rebuilds.
-      llvm::sort(SymRefs);
-      llvm::copy(SymRefs, back_inserter(RefsStorage));
-      AllRefs.try_emplace(
-          Sym.first,
-          llvm::ArrayRef<Ref>(&RefsStorage[RefsStorage.size() - SymRefs.size()],
-                              SymRefs.size()));
+      auto Relations = RelationsSnapshot.find(Key);
+      if (Relations != RelationsSnapshot.end())
+        RelationSlabs.push_back(Relations->second);
     }
-  }
-
-  std::vector<Relation> AllRelations;
-  for (const auto &RelationSlab : RelationSlabs) {
-    for (const auto &R : *RelationSlab)
-      AllRelations.push_back(R);
-  }
-  // Sort relations and remove duplicates that could arise due to
-  // relations being stored in both the shards containing their
-  // subject and object.
-  llvm::sort(AllRelations);
-  AllRelations.erase(std::unique(AllRelations.begin(), AllRelations.end()),
-                     AllRelations.end());
 
-  size_t StorageSize =
-      RefsStorage.size() * sizeof(Ref) + SymsStorage.size() * sizeof(Symbol);
-  for (const auto &Slab : SymbolSlabs)
-    StorageSize += Slab->bytes();
-  for (const auto &RefSlab : RefSlabs)
-    StorageSize += RefSlab->bytes();
-
-  // Index must keep the slabs and contiguous ranges alive.
-  switch (Type) {
-  case IndexType::Light:
-    return std::make_unique<MemIndex>(
-        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
-        std::move(AllRelations), std::move(Files), IdxContents,
-        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
-                        std::move(RefsStorage), std::move(SymsStorage)),
-        StorageSize);
-  case IndexType::Heavy:
-    return std::make_unique<dex::Dex>(
-        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
-        std::move(AllRelations), std::move(Files), IdxContents,
-        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
-                        std::move(RefsStorage), std::move(SymsStorage)),
-        StorageSize);
+    if (Version)
+      *Version = this->Version;
   }
-  llvm_unreachable("Unknown clangd::IndexType");
+  return buildIndexFromSlabs(Type, DuplicateHandle, IdxContents,
+                             std::move(SymbolSlabs), std::move(RefSlabs),
+                             std::move(RelationSlabs), std::move(Files),
+                             MainFileRefs);
 }
 
 void FileSymbols::profile(MemoryTree &MT) const {
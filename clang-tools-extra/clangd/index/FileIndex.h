@@ -89,6 +89,17 @@ public:
              DuplicateHandling DuplicateHandle = DuplicateHandling::PickOne,
              size_t *Version = nullptr);
 
+  /// Builds an index of only the keys updated after \p SinceVersion, which is
+  /// a Version returned by an earlier build. Keys removed since then are
+  /// included without data, so the result can be layered over the older index
+  /// with MergedIndex to hide their stale contents.
+  /// Returns nullptr if more than \p MaxKeys keys were updated, as a full
+  /// rebuild is then cheaper to serve.
+  std::unique_ptr<SymbolIndex>
+  buildDeltaIndex(size_t SinceVersion, size_t MaxKeys, IndexType,
+                  DuplicateHandling DuplicateHandle = DuplicateHandling::PickOne,
+                  size_t *Version = nullptr);
+
   void profile(MemoryTree &MT) const;
 
 private:
@@ -104,6 +115,8 @@ private:
   llvm::StringMap<std::shared_ptr<SymbolSlab>> SymbolsSnapshot;
   llvm::StringMap<RefSlabAndCountReferences> RefsSnapshot;
   llvm::StringMap<std::shared_ptr<RelationSlab>> RelationsSnapshot;
+  // Version of the last update to each key, including removed keys.
+  llvm::StringMap<size_t> LastUpdate;
 };
 
 /// This manages symbols from files and an in-memory index on all symbols.
@@ -182,8 +182,10 @@ public:
 
   size_t estimateMemoryUsage() const override;
 
-private:
+  // Returns the current index, which is kept alive as long as it's referenced.
   std::shared_ptr<SymbolIndex> snapshot() const;
+
+private:
   mutable std::mutex Mutex;
   std::shared_ptr<SymbolIndex> Index;
 };
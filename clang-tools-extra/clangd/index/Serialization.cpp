@@ -191,7 +191,7 @@ public:
     }
     if (llvm::zlib::isAvailable()) {
       llvm::SmallString<1> Compressed;
-      llvm::cantFail(llvm::zlib::compress(RawTable, Compressed));
+      llvm::cantFail(llvm::zlib::compressParallel(RawTable, Compressed));
       write32(RawTable.size(), OS);
       OS << Compressed;
     } else {
@@ -208,7 +208,9 @@ public:
 };
 
 struct StringTableIn {
-  llvm::BumpPtrAllocator Arena;
+  // Holds the decompressed table, if it was compressed. Otherwise the strings
+  // point directly into the index data, which outlives the table.
+  llvm::SmallString<0> UncompressedStorage;
   std::vector<llvm::StringRef> Strings;
 };
 
@@ -218,8 +220,8 @@ llvm::Expected<StringTableIn> readStringTable(llvm::StringRef Data) {
   if (R.err())
     return error("Truncated string table");
 
+  StringTableIn Table;
   llvm::StringRef Uncompressed;
-  llvm::SmallString<1> UncompressedStorage;
   if (UncompressedSize == 0) // No compression
     Uncompressed = R.rest();
   else if (llvm::zlib::isAvailable()) {
@@ -232,21 +234,22 @@ llvm::Expected<StringTableIn> readStringTable(llvm::StringRef Data) {
       return error("Bad stri table: uncompress {0} -> {1} bytes is implausible",
                    R.rest().size(), UncompressedSize);
 
-    if (llvm::Error E = llvm::zlib::uncompress(R.rest(), UncompressedStorage,
-                                               UncompressedSize))
+    if (llvm::Error E = llvm::zlib::uncompress(
+            R.rest(), Table.UncompressedStorage, UncompressedSize))
       return std::move(E);
-    Uncompressed = UncompressedStorage;
+    Uncompressed = Table.UncompressedStorage;
   } else
     return error("Compressed string table, but zlib is unavailable");
 
-  StringTableIn Table;
-  llvm::StringSaver Saver(Table.Arena);
+  // The strings are only referenced while the index is read: the symbol, ref
+  // and include graph builders intern their own copies. So there's no need to
+  // copy them out of the table, which is null terminated as they require.
   R = Reader(Uncompressed);
   for (Reader R(Uncompressed); !R.eof();) {
     auto Len = R.rest().find(0);
     if (Len == llvm::StringRef::npos)
       return error("Bad string table: not null terminated");
-    Table.Strings.push_back(Saver.save(R.consume(Len)));
+    Table.Strings.push_back(R.consume(Len));
     R.consume8();
   }
   if (R.err())
@@ -724,6 +727,8 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
       return nullptr;
     }
   }
+  // Everything was copied out of the file, don't keep it while building.
+  Buffer->reset();
 
   size_t NumSym = Symbols.size();
   size_t NumRefs = Refs.numRefs();
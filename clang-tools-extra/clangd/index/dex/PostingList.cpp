@@ -26,7 +26,7 @@ public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
     if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -94,21 +94,31 @@ private:
     ++CurrentChunk;
     if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
       return;
-    DecompressedChunk = CurrentChunk->decompress();
+    CurrentChunk->decompress(DecompressedChunk);
     CurrentID = DecompressedChunk.begin();
   }
 
   /// Advances CurrentChunk to the chunk which might contain ID.
+  ///
+  /// Intersections mostly advance to IDs close to the current position, so
+  /// gallop forward from the current chunk to bracket ID before falling back
+  /// to binary search. This is O(log distance) instead of O(log size).
   void advanceToChunk(DocID ID) {
-    if ((CurrentChunk != Chunks.end() - 1) &&
-        ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
+    if ((CurrentChunk == Chunks.end() - 1) || ((CurrentChunk + 1)->Head > ID))
+      return;
+    auto Low = CurrentChunk + 1;
+    size_t Step = 1;
+    while (static_cast<size_t>(Chunks.end() - Low) > Step &&
+           Low[Step].Head <= ID) {
+      Low += Step;
+      Step *= 2;
     }
+    auto High = Low + std::min<size_t>(Step, Chunks.end() - Low);
+    CurrentChunk = std::partition_point(
+        Low + 1, High, [&](const Chunk &C) { return C.Head <= ID; });
+    --CurrentChunk;
+    CurrentChunk->decompress(DecompressedChunk);
+    CurrentID = DecompressedChunk.begin();
   }
 
   const Token *Tok;
@@ -182,38 +192,33 @@ std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
   return std::vector<Chunk>(Result); // no move, shrink-to-fit
 }
 
-/// Reads variable length DocID from the buffer and updates the buffer size. If
-/// the stream is terminated, return None.
-llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
-  if (Bytes.front() == 0 || Bytes.empty())
-    return None;
-  DocID Result = 0;
-  bool HasNextByte = true;
-  for (size_t Length = 0; HasNextByte && !Bytes.empty(); ++Length) {
-    assert(Length <= 5 && "Malformed VByte encoding sequence.");
-    // Write meaningful bits to the correct place in the document decoding.
-    Result |= (Bytes.front() & 0x7f) << (BitsPerEncodingByte * Length);
-    if ((Bytes.front() & 0x80) == 0)
-      HasNextByte = false;
-    Bytes = Bytes.drop_front();
+} // namespace
+
+void Chunk::decompress(llvm::SmallVectorImpl<DocID> &Out) const {
+  Out.clear();
+  Out.push_back(Head);
+  // Decode the VByte deltas in a single pass over the payload. A zero byte
+  // terminates the stream, as no delta is zero. Most deltas fit in one byte so
+  // that case is kept cheap.
+  DocID Current = Head;
+  const uint8_t *Byte = Payload.data(), *End = Byte + Payload.size();
+  while (Byte != End && *Byte != 0) {
+    DocID Delta = *Byte & 0x7f;
+    for (unsigned Shift = BitsPerEncodingByte; (*Byte++ & 0x80) && Byte != End;
+         Shift += BitsPerEncodingByte) {
+      assert(Shift < 5 * BitsPerEncodingByte &&
+             "Malformed VByte encoding sequence.");
+      Delta |= static_cast<DocID>(*Byte & 0x7f) << Shift;
+    }
+    Current += Delta;
+    Out.push_back(Current);
   }
-  return Result;
 }
 
-} // namespace
-
 llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
-  llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
-    auto MaybeDelta = readVByte(Bytes);
-    if (!MaybeDelta)
-      break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
-  }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
+  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result;
+  decompress(Result);
+  return Result;
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
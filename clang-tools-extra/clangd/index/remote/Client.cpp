@@ -28,6 +28,10 @@ namespace clangd {
 namespace remote {
 namespace {
 
+constexpr trace::Metric RemoteIndexLatency("remote_index_latency",
+                                           trace::Metric::Distribution,
+                                           "request");
+
 llvm::StringRef toString(const grpc_connectivity_state &State) {
   switch (State) {
   case GRPC_CHANNEL_IDLE:
@@ -106,6 +110,7 @@ class IndexClient : public clangd::SymbolIndex {
                       .count();
     vlog("Remote index [{0}]: {1} => {2} results in {3}ms.", ServerAddress,
          RequestT::descriptor()->name(), Successful, Millis);
+    RemoteIndexLatency.record(Millis, RequestT::descriptor()->name());
     SPAN_ATTACH(Tracer, "Status", Reader->Finish().ok());
     SPAN_ATTACH(Tracer, "Successful", Successful);
     SPAN_ATTACH(Tracer, "Failed to parse", FailedToParse);
@@ -23,6 +23,7 @@
 #include "support/Trace.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/None.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Chrono.h"
 #include "llvm/Support/CommandLine.h"
@@ -33,13 +34,17 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
+#include <algorithm>
 #include <chrono>
 #include <grpc++/grpc++.h>
 #include <grpc++/health_check_service_interface.h>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #if ENABLE_GRPC_REFLECTION
 #include <grpc++/ext/proto_server_reflection_plugin.h>
@@ -111,12 +116,130 @@ llvm::cl::opt<size_t> LimitResults(
                    "single request. Limit is to keep the server from being "
                    "DOS'd. Defaults to 10000."));
 
+llvm::cl::opt<size_t> FuzzyFindCacheSize(
+    "fuzzyfind-cache-size", llvm::cl::init(0),
+    llvm::cl::desc("Number of recent FuzzyFind responses to keep in memory and "
+                   "serve without querying the index. The cache is dropped "
+                   "whenever the index is reloaded. 0 disables the cache."));
+
+llvm::cl::opt<bool> CompressResponses{
+    "compress-responses",
+    llvm::cl::desc("Compress responses with gzip for clients supporting it. "
+                   "Trades server CPU time for network bandwidth."),
+    llvm::cl::init(false),
+};
+
 static Key<grpc::ServerContext *> CurrentRequest;
 
+// Accumulates latency of the served requests, reported via Monitor.
+class RequestLatencyStats {
+public:
+  void record(llvm::StringRef Method, uint64_t Millis) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto &S = PerMethod[Method];
+    ++S.Count;
+    S.TotalMillis += Millis;
+    S.MaxMillis = std::max(S.MaxMillis, Millis);
+  }
+
+  void fill(v1::MonitoringInfoReply &Reply) const {
+    std::lock_guard<std::mutex> Lock(Mu);
+    for (const auto &Entry : PerMethod) {
+      auto *Latency = Reply.add_request_latency();
+      Latency->set_method(Entry.first().str());
+      Latency->set_count(Entry.second.Count);
+      Latency->set_total_milliseconds(Entry.second.TotalMillis);
+      Latency->set_max_milliseconds(Entry.second.MaxMillis);
+    }
+  }
+
+private:
+  struct Stats {
+    uint64_t Count = 0;
+    uint64_t TotalMillis = 0;
+    uint64_t MaxMillis = 0;
+  };
+  mutable std::mutex Mu;
+  llvm::StringMap<Stats> PerMethod;
+};
+
+// LRU cache of FuzzyFind responses keyed by the serialized request. Code
+// completion issues the same few queries over and over (especially when many
+// clients work on the same project), so the hottest ones are answered without
+// reaching the index at all.
+class FuzzyFindCache {
+public:
+  using Replies = std::vector<FuzzyFindReply>;
+
+  FuzzyFindCache(size_t MaxEntries) : MaxEntries(MaxEntries) {}
+
+  bool enabled() const { return MaxEntries != 0; }
+
+  // Returns the cached replies for \p Key or nullptr.
+  std::shared_ptr<const Replies> get(llvm::StringRef Key) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto It = Lookup.find(Key);
+    if (It == Lookup.end())
+      return nullptr;
+    Entries.splice(Entries.begin(), Entries, It->second);
+    ++Hits;
+    return It->second->Value;
+  }
+
+  // Identifies the current index version. Queries should grab it before
+  // accessing the index and pass it to put(), so that replies computed against
+  // an index that was replaced in the meantime are not cached.
+  uint64_t generation() const {
+    std::lock_guard<std::mutex> Lock(Mu);
+    return Generation;
+  }
+
+  void put(llvm::StringRef Key, std::shared_ptr<const Replies> Value,
+           uint64_t ComputedAt) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    if (!enabled() || ComputedAt != Generation || Lookup.count(Key))
+      return;
+    Entries.push_front({Key.str(), std::move(Value)});
+    Lookup[Key] = Entries.begin();
+    if (Entries.size() > MaxEntries) {
+      Lookup.erase(Entries.back().Key);
+      Entries.pop_back();
+    }
+  }
+
+  // Drops all the entries, called when the index changes.
+  void clear() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    ++Generation;
+    Lookup.clear();
+    Entries.clear();
+  }
+
+  uint64_t hits() const {
+    std::lock_guard<std::mutex> Lock(Mu);
+    return Hits;
+  }
+
+private:
+  struct Entry {
+    std::string Key;
+    std::shared_ptr<const Replies> Value;
+  };
+
+  const size_t MaxEntries;
+  mutable std::mutex Mu;
+  // Most recently used entries first.
+  std::list<Entry> Entries;
+  llvm::StringMap<std::list<Entry>::iterator> Lookup;
+  uint64_t Generation = 0;
+  uint64_t Hits = 0;
+};
+
 class RemoteIndexServer final : public v1::SymbolIndex::Service {
 public:
-  RemoteIndexServer(clangd::SymbolIndex &Index, llvm::StringRef IndexRoot)
-      : Index(Index) {
+  RemoteIndexServer(clangd::SymbolIndex &Index, llvm::StringRef IndexRoot,
+                    RequestLatencyStats &Stats, FuzzyFindCache &Cache)
+      : Index(Index), Stats(Stats), Cache(Cache) {
     llvm::SmallString<256> NativePath = IndexRoot;
     llvm::sys::path::native(NativePath);
     ProtobufMarshaller = std::unique_ptr<Marshaller>(new Marshaller(
@@ -190,6 +313,22 @@ private:
           Req->Limit, LimitResults);
       Req->Limit = LimitResults;
     }
+    std::string CacheKey;
+    if (Cache.enabled()) {
+      CacheKey = Request->SerializeAsString();
+      if (auto Cached = Cache.get(CacheKey)) {
+        for (const auto &Message : *Cached) {
+          logResponse(Message);
+          Reply->Write(Message);
+        }
+        SPAN_ATTACH(Tracer, "Cached", true);
+        SPAN_ATTACH(Tracer, "Sent", Cached->size() - 1);
+        logRequestSummary("v1/FuzzyFind", Cached->size() - 1, StartTime);
+        return grpc::Status::OK;
+      }
+    }
+    uint64_t Generation = Cache.generation();
+    auto Replies = std::make_shared<FuzzyFindCache::Replies>();
     unsigned Sent = 0;
     unsigned FailedToSend = 0;
     bool HasMore = Index.fuzzyFind(*Req, [&](const clangd::Symbol &Item) {
@@ -204,12 +343,19 @@ private:
       *NextMessage.mutable_stream_result() = *SerializedItem;
       logResponse(NextMessage);
       Reply->Write(NextMessage);
+      if (Cache.enabled())
+        Replies->push_back(std::move(NextMessage));
       ++Sent;
     });
     FuzzyFindReply LastMessage;
     LastMessage.mutable_final_result()->set_has_more(HasMore);
     logResponse(LastMessage);
     Reply->Write(LastMessage);
+    // Partial responses are not worth caching.
+    if (Cache.enabled() && !FailedToSend) {
+      Replies->push_back(std::move(LastMessage));
+      Cache.put(CacheKey, std::move(Replies), Generation);
+    }
     SPAN_ATTACH(Tracer, "Sent", Sent);
     SPAN_ATTACH(Tracer, "Failed to send", FailedToSend);
     logRequestSummary("v1/FuzzyFind", Sent, StartTime);
@@ -326,16 +472,21 @@ private:
         std::chrono::duration_cast<std::chrono::milliseconds>(Duration).count();
     log("[public] request {0} => OK: {1} results in {2}ms", RequestName, Sent,
         Millis);
+    Stats.record(RequestName, Millis);
   }
 
   std::unique_ptr<Marshaller> ProtobufMarshaller;
   clangd::SymbolIndex &Index;
+  RequestLatencyStats &Stats;
+  FuzzyFindCache &Cache;
 };
 
 class Monitor final : public v1::Monitor::Service {
 public:
-  Monitor(llvm::sys::TimePoint<> IndexAge)
-      : StartTime(std::chrono::system_clock::now()), IndexBuildTime(IndexAge) {}
+  Monitor(llvm::sys::TimePoint<> IndexAge, const RequestLatencyStats &Stats,
+          const FuzzyFindCache &Cache)
+      : StartTime(std::chrono::system_clock::now()), IndexBuildTime(IndexAge),
+        Stats(Stats), Cache(Cache) {}
 
   void updateIndex(llvm::sys::TimePoint<> UpdateTime) {
     IndexBuildTime.exchange(UpdateTime);
@@ -359,11 +510,15 @@ private:
         std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::system_clock::now() - IndexBuildTime.load())
             .count());
+    Stats.fill(*Reply);
+    Reply->set_fuzzy_find_cache_hits(Cache.hits());
     return grpc::Status::OK;
   }
 
   const llvm::sys::TimePoint<> StartTime;
   std::atomic<llvm::sys::TimePoint<>> IndexBuildTime;
+  const RequestLatencyStats &Stats;
+  const FuzzyFindCache &Cache;
 };
 
 void maybeTrimMemory() {
@@ -377,7 +532,7 @@ void maybeTrimMemory() {
 void hotReload(clangd::SwapIndex &Index, llvm::StringRef IndexPath,
                llvm::vfs::Status &LastStatus,
                llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> &FS,
-               Monitor &Monitor) {
+               Monitor &Monitor, FuzzyFindCache &Cache) {
   // glibc malloc doesn't shrink an arena if there are items living at the end,
   // which might happen since we destroy the old index after building new one.
   // Trim more aggresively to keep memory usage of the server low.
@@ -402,14 +557,16 @@ void hotReload(clangd::SwapIndex &Index, llvm::StringRef IndexPath,
     return;
   }
   Index.reset(std::move(NewIndex));
+  Cache.clear();
   Monitor.updateIndex(Status->getLastModificationTime());
   log("New index version loaded. Last modification time: {0}, size: {1} bytes.",
       Status->getLastModificationTime(), Status->getSize());
 }
 
 void runServerAndWait(clangd::SymbolIndex &Index, llvm::StringRef ServerAddress,
-                      llvm::StringRef IndexPath, Monitor &Monitor) {
-  RemoteIndexServer Service(Index, IndexRoot);
+                      llvm::StringRef IndexPath, Monitor &Monitor,
+                      RequestLatencyStats &Stats, FuzzyFindCache &Cache) {
+  RemoteIndexServer Service(Index, IndexRoot, Stats, Cache);
 
   grpc::EnableDefaultHealthCheckService(true);
 #if ENABLE_GRPC_REFLECTION
@@ -420,6 +577,8 @@ void runServerAndWait(clangd::SymbolIndex &Index, llvm::StringRef ServerAddress,
                            grpc::InsecureServerCredentials());
   Builder.AddChannelArgument(GRPC_ARG_MAX_CONNECTION_IDLE_MS,
                              IdleTimeoutSeconds * 1000);
+  if (CompressResponses)
+    Builder.SetDefaultCompressionAlgorithm(GRPC_COMPRESS_GZIP);
   Builder.RegisterService(&Service);
   Builder.RegisterService(&Monitor);
   std::unique_ptr<grpc::Server> Server(Builder.BuildAndStart());
@@ -542,18 +701,21 @@ int main(int argc, char *argv[]) {
   }
   clang::clangd::SwapIndex Index(std::move(SymIndex));
 
-  Monitor Monitor(Status->getLastModificationTime());
+  RequestLatencyStats Stats;
+  FuzzyFindCache Cache(FuzzyFindCacheSize);
+  Monitor Monitor(Status->getLastModificationTime(), Stats, Cache);
 
-  std::thread HotReloadThread([&Index, &Status, &FS, &Monitor]() {
+  std::thread HotReloadThread([&Index, &Status, &FS, &Monitor, &Cache]() {
     llvm::vfs::Status LastStatus = *Status;
     static constexpr auto RefreshFrequency = std::chrono::seconds(30);
     while (!clang::clangd::shutdownRequested()) {
-      hotReload(Index, llvm::StringRef(IndexPath), LastStatus, FS, Monitor);
+      hotReload(Index, llvm::StringRef(IndexPath), LastStatus, FS, Monitor,
+                Cache);
       std::this_thread::sleep_for(RefreshFrequency);
     }
   });
 
-  runServerAndWait(Index, ServerAddress, IndexPath, Monitor);
+  runServerAndWait(Index, ServerAddress, IndexPath, Monitor, Stats, Cache);
 
   HotReloadThread.join();
 }
@@ -204,6 +204,15 @@ opt<CodeCompleteOptions::CodeCompletionRankingModel> RankingModel{
     Hidden,
 };
 
+opt<bool> ReuseCompletionResults{
+    "reuse-completion-results",
+    cat(Features),
+    desc("Re-filter the results of the previous code completion instead of "
+         "parsing again while the same identifier is being typed"),
+    init(CodeCompleteOptions().ReuseResults),
+    Hidden,
+};
+
 // FIXME: also support "plain" style where signatures are always omitted.
 enum CompletionStyleFlag { Detailed, Bundled };
 opt<CompletionStyleFlag> CompletionStyle{
@@ -398,6 +407,33 @@ opt<PCHStorageFlag> PCHStorage{
     init(PCHStorageFlag::Disk),
 };
 
+opt<bool> SharePreambles{
+    "share-preambles",
+    cat(Misc),
+    desc("Build a preamble once for open files that have the same includes "
+         "and compile flags"),
+    init(false),
+    Hidden,
+};
+
+opt<unsigned> PreambleBuilds{
+    "preamble-builds",
+    cat(Misc),
+    desc("Max number of preambles built concurrently, files being edited are "
+         "built first. 0 means no limit"),
+    init(0),
+    Hidden,
+};
+
+opt<unsigned> RetainedASTMemory{
+    "retained-ast-memory",
+    cat(Misc),
+    desc("Max memory in MB used by ASTs of files that are not being worked "
+         "on. Evicted ASTs are rebuilt on demand. 0 means no limit"),
+    init(0),
+    Hidden,
+};
+
 opt<bool> Sync{
     "sync",
     cat(Misc),
@@ -848,6 +884,9 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     Opts.StorePreamblesInMemory = false;
     break;
   }
+  Opts.SharePreambles = SharePreambles;
+  Opts.PreambleBuildsCount = PreambleBuilds;
+  Opts.RetentionPolicy.MaxRetainedBytes = size_t(RetainedASTMemory) << 20;
   if (!ResourceDir.empty())
     Opts.ResourceDir = ResourceDir;
   Opts.BuildDynamicSymbolIndex = true;
@@ -896,6 +935,7 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
   Opts.CodeComplete.EnableFunctionArgSnippets = EnableFunctionArgSnippets;
   Opts.CodeComplete.RunParser = CodeCompletionParse;
   Opts.CodeComplete.RankingModel = RankingModel;
+  Opts.CodeComplete.ReuseResults = ReuseCompletionResults;
 
   RealThreadsafeFS TFS;
   std::vector<std::unique_ptr<config::Provider>> ProviderStack;
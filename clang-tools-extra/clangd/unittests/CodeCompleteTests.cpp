@@ -2569,6 +2569,55 @@ TEST(CompletionTest, EnableSpeculativeIndexRequest) {
   ASSERT_EQ(Reqs3.size(), 2u);
 }
 
+TEST(CompletionTest, ReuseCachedResults) {
+  Annotations Test(R"cpp(
+    struct Foo { int alpha; int alphabet; int beta; };
+    void f(Foo F) { F.al^; }
+  )cpp");
+  auto TU = TestTU::withCode(Test.code());
+  MockFS FS;
+  auto Inputs = TU.inputs(FS);
+  IgnoreDiagnostics Diags;
+  auto CI = buildCompilerInvocation(Inputs, Diags);
+  ASSERT_TRUE(CI);
+  auto Preamble = buildPreamble(testPath(TU.Filename), *CI, Inputs,
+                                /*InMemory=*/true, /*Callback=*/nullptr);
+  CompletionResultCache Cache;
+  auto Complete = [&](llvm::StringRef Code) {
+    Annotations Point(Code);
+    Inputs.Contents = Point.code().str();
+    return codeComplete(testPath(TU.Filename), Point.point(), Preamble.get(),
+                        Inputs, {}, /*SpecFuzzyFind=*/nullptr, &Cache);
+  };
+
+  auto Results = Complete(Test.code());
+  EXPECT_THAT(Results.Completions,
+              UnorderedElementsAre(named("alpha"), named("alphabet")));
+  ASSERT_TRUE(Cache.Valid);
+  // Tag the cached candidates to observe whether they are reused.
+  for (auto &Candidate : Cache.Candidates)
+    Candidate.Completion.Signature = "cached";
+
+  Annotations Extended(R"cpp(
+    struct Foo { int alpha; int alphabet; int beta; };
+    void f(Foo F) { F.$tok[[alphab^]]; }
+  )cpp");
+  Results = Complete(Extended.code());
+  EXPECT_THAT(Results.Completions,
+              ElementsAre(AllOf(named("alphabet"), signature("cached"))));
+  EXPECT_EQ(Results.Completions.front().CompletionTokenRange,
+            Extended.range("tok"));
+  EXPECT_EQ(Results.CompletionRange, Extended.range("tok"));
+
+  // Other edits require running Sema again.
+  Results = Complete(R"cpp(
+    struct Foo { int alpha; int alphabet; int beta; };
+    void f(Foo F) { F.b^; }
+  )cpp");
+  EXPECT_THAT(Results.Completions,
+              ElementsAre(AllOf(named("beta"), Not(signature("cached")))));
+}
+
 TEST(CompletionTest, InsertTheMostPopularHeader) {
   std::string DeclFile = URI::create(testPath("foo")).toString();
   Symbol Sym = func("Func");
@@ -19,6 +19,7 @@
 #include "index/CanonicalIncludes.h"
 #include "index/FileIndex.h"
 #include "index/Index.h"
+#include "index/Merge.h"
 #include "index/Ref.h"
 #include "index/Relation.h"
 #include "index/Serialization.h"
@@ -144,6 +145,37 @@ TEST(FileSymbolsTest, MergeOverlap) {
             AllOf(qName("x"), declURI("file:///x1"), defURI("file:///x2"))));
 }
 
+TEST(FileSymbolsTest, DeltaIndex) {
+  FileSymbols FS(IndexContents::All);
+  auto FileSlab = [](llvm::StringRef ID, const char *FileURI) {
+    SymbolSlab::Builder Slab;
+    Symbol Sym = symbol(ID);
+    Sym.CanonicalDeclaration.FileURI = FileURI;
+    Slab.insert(Sym);
+    return std::make_unique<SymbolSlab>(std::move(Slab).build());
+  };
+  FS.update("f1", FileSlab("1", "f1"), nullptr, nullptr, false);
+  FS.update("f2", FileSlab("2", "f2"), nullptr, nullptr, false);
+
+  size_t Version = 0;
+  auto Full = FS.buildIndex(IndexType::Light, DuplicateHandling::PickOne,
+                            &Version);
+  EXPECT_THAT(runFuzzyFind(*FS.buildDeltaIndex(Version, 10, IndexType::Light),
+                           ""),
+              IsEmpty());
+
+  FS.update("f1", nullptr, nullptr, nullptr, false);
+  FS.update("f3", FileSlab("3", "f3"), nullptr, nullptr, false);
+  auto Delta = FS.buildDeltaIndex(Version, 10, IndexType::Light);
+  EXPECT_THAT(runFuzzyFind(*Delta, ""), UnorderedElementsAre(qName("3")));
+  // The removed file hides its symbols in the full index.
+  MergedIndex Merged(Delta.get(), Full.get());
+  EXPECT_THAT(runFuzzyFind(Merged, ""),
+              UnorderedElementsAre(qName("2"), qName("3")));
+
+  EXPECT_EQ(FS.buildDeltaIndex(Version, 1, IndexType::Light), nullptr);
+}
+
 TEST(FileSymbolsTest, SnapshotAliveAfterRemove) {
   FileSymbols FS(IndexContents::All);
 
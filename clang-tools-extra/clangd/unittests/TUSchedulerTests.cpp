@@ -635,6 +635,27 @@ TEST_F(TUSchedulerTests, EvictedAST) {
 // We send "empty" changes to TUScheduler when we think some external event
 // *might* have invalidated current state (e.g. a header was edited).
 // Verify that this doesn't evict our cache entries.
+TEST_F(TUSchedulerTests, EvictedASTOverMemoryLimit) {
+  auto Opts = optsForTest();
+  Opts.AsyncThreadsCount = 1;
+  Opts.RetentionPolicy.MaxRetainedASTs = 3;
+  // Less than any AST, so only the most recently used one is retained.
+  Opts.RetentionPolicy.MaxRetainedBytes = 1;
+  TUScheduler S(CDB, Opts);
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  updateWithDiags(S, Foo, "int a;", WantDiagnostics::Yes,
+                  [](std::vector<Diag>) {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), ElementsAre(Foo));
+
+  updateWithDiags(S, Bar, "int b;", WantDiagnostics::Yes,
+                  [](std::vector<Diag>) {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), ElementsAre(Bar));
+}
+
 TEST_F(TUSchedulerTests, NoopChangesDontThrashCache) {
   auto Opts = optsForTest();
   Opts.RetentionPolicy.MaxRetainedASTs = 1;
@@ -773,6 +794,47 @@ TEST_F(TUSchedulerTests, RunWaitsForPreamble) {
   ASSERT_THAT(Preambles, Each(Preambles[0]));
 }
 
+TEST_F(TUSchedulerTests, SharedPreambles) {
+  auto Opts = optsForTest();
+  Opts.SharePreambles = true;
+  TUScheduler S(CDB, Opts);
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  auto Baz = testPath("baz.cpp");
+  auto Header = testPath("foo.h");
+  FS.Files[Header] = "int a;";
+  FS.Timestamps[Header] = time_t(0);
+
+  auto GetPreamble = [&](PathRef File) {
+    const void *Preamble = nullptr;
+    S.runWithPreamble("test", File, TUScheduler::Stale,
+                      [&](Expected<InputsAndPreamble> IP) {
+                        Preamble = cantFail(std::move(IP)).Preamble;
+                      });
+    EXPECT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    return Preamble;
+  };
+
+  S.update(Foo, getInputs(Foo, "#include \"foo.h\"\nint x = a;"),
+           WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  S.update(Bar, getInputs(Bar, "#include \"foo.h\"\nint y = a;"),
+           WantDiagnostics::Auto);
+  S.update(Baz, getInputs(Baz, "#include \"foo.h\"\n#define Z\nint z;"),
+           WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  ASSERT_NE(GetPreamble(Foo), nullptr);
+  EXPECT_EQ(GetPreamble(Foo), GetPreamble(Bar));
+  EXPECT_NE(GetPreamble(Foo), GetPreamble(Baz));
+
+  // Changing the header invalidates the shared preamble.
+  FS.Timestamps[Header] = time_t(1);
+  S.update(Bar, getInputs(Bar, "#include \"foo.h\"\nint y = a + 1;"),
+           WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_NE(GetPreamble(Foo), GetPreamble(Bar));
+}
+
 TEST_F(TUSchedulerTests, NoopOnEmptyChanges) {
   TUScheduler S(CDB, optsForTest(), captureDiags());
 
@@ -1164,6 +1226,69 @@ TEST_F(TUSchedulerTests, AsyncPreambleThread) {
   Ready.notify();
 }
 
+TEST_F(TUSchedulerTests, PreambleThrottle) {
+  // Records versions of built preambles, and blocks while building \p Block
+  // until \p Unblock is notified.
+  class RecordPreambleBuilds : public ParsingCallbacks {
+  public:
+    RecordPreambleBuilds(llvm::StringRef Block, Notification &Started,
+                         Notification &Unblock)
+        : Block(Block), Started(Started), Unblock(Unblock) {}
+    void onPreambleAST(PathRef Path, llvm::StringRef Version, ASTContext &Ctx,
+                       Preprocessor &, const CanonicalIncludes &) override {
+      {
+        std::lock_guard<std::mutex> Lock(Mu);
+        Built.push_back(Version.str());
+        MaxActive = std::max(MaxActive, ++Active);
+      }
+      if (Version == Block) {
+        Started.notify();
+        Unblock.wait();
+      }
+      std::lock_guard<std::mutex> Lock(Mu);
+      --Active;
+    }
+
+    std::mutex Mu;
+    std::vector<std::string> Built;
+    unsigned Active = 0;
+    unsigned MaxActive = 0;
+
+  private:
+    llvm::StringRef Block;
+    Notification &Started;
+    Notification &Unblock;
+  };
+
+  Notification Started, Unblock;
+  auto Opts = optsForTest();
+  Opts.PreambleBuildsCount = 1;
+  auto Callbacks =
+      std::make_unique<RecordPreambleBuilds>("foo0", Started, Unblock);
+  auto *Recorder = Callbacks.get();
+  TUScheduler S(CDB, Opts, std::move(Callbacks));
+  auto Update = [&](PathRef File, llvm::StringRef Version,
+                    llvm::StringRef Contents) {
+    auto PI = getInputs(File, Contents.str());
+    PI.Version = Version.str();
+    S.update(File, PI, WantDiagnostics::Auto);
+  };
+
+  // Hold the only slot while the other files queue up.
+  Update(testPath("foo.cpp"), "foo0", "#define FOO\n");
+  Started.wait();
+  Update(testPath("bar.cpp"), "bar0", "#define BAR\n");
+  Update(testPath("baz.cpp"), "baz0", "#define BAZ 0\n");
+  // Makes the queued build of baz0 obsolete.
+  Update(testPath("baz.cpp"), "baz1", "#define BAZ 1\n");
+  Unblock.notify();
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+
+  std::lock_guard<std::mutex> Lock(Recorder->Mu);
+  EXPECT_EQ(Recorder->MaxActive, 1u);
+  EXPECT_THAT(Recorder->Built, UnorderedElementsAre("foo0", "bar0", "baz1"));
+}
+
 TEST_F(TUSchedulerTests, OnlyPublishWhenPreambleIsBuilt) {
   struct PreamblePublishCounter : public ParsingCallbacks {
     PreamblePublishCounter(int &PreamblePublishCount)
@@ -0,0 +1,23 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/include %t/a %t/b
+// RUN: echo 'int *HP = 0;' > %t/include/header.h
+// RUN: echo '#include "header.h"' > %t/a/a.cpp
+// RUN: echo 'int *AA = 0;' >> %t/a/a.cpp
+// RUN: echo '#include "header.h"' > %t/b/b.cpp
+// RUN: echo 'int *BB = 0;' >> %t/b/b.cpp
+// RUN: echo '[{"directory":"%/t/a","command":"clang++ -c a.cpp -I../include","file":"%/t/a/a.cpp"},{"directory":"%/t/b","command":"clang++ -c b.cpp -I../include","file":"%/t/b/b.cpp"}]' > %t/compile_commands.json
+
+// Warnings in a header included by several TUs are only reported once.
+// RUN: clang-tidy -j 2 --checks=-*,modernize-use-nullptr -header-filter=.* -p %t %t/a/a.cpp %t/b/b.cpp 2>&1 | FileCheck %s -implicit-check-not=warning:
+// CHECK-DAG: a.cpp:2:11: warning: use nullptr
+// CHECK-DAG: b.cpp:2:11: warning: use nullptr
+// CHECK-DAG: header.h:1:11: warning: use nullptr
+
+// RUN: clang-tidy -j 2 --checks=-*,modernize-use-nullptr -header-filter=.* -p %t %t/a/a.cpp %t/b/b.cpp -fix
+// RUN: FileCheck -input-file=%t/a/a.cpp %s -check-prefix=CHECK-FIX1
+// RUN: FileCheck -input-file=%t/b/b.cpp %s -check-prefix=CHECK-FIX2
+// RUN: FileCheck -input-file=%t/include/header.h %s -check-prefix=CHECK-FIX3
+
+// CHECK-FIX1: int *AA = nullptr;
+// CHECK-FIX2: int *BB = nullptr;
+// CHECK-FIX3: int *HP = nullptr;
@@ -132,6 +132,12 @@ public:
 
       /// Per bucket timing information.
       llvm::StringMap<llvm::TimeRecord> &Records;
+
+      /// Additionally time each \c Decl and \c Stmt matcher on its own.
+      ///
+      /// The time is recorded in a bucket named "<callback ID>#<N>", where N
+      /// counts the matchers added with the same callback.
+      bool PerMatcher = false;
     };
 
     /// Enables per-check timers.
@@ -357,6 +357,11 @@ public:
   virtual llvm::Optional<clang::TraversalKind> TraversalKind() const {
     return llvm::None;
   }
+
+  /// Returns false if this matcher can never match nodes of \p Kind, which
+  /// the caller already checked to be within its restrict kind. Composite
+  /// matchers such as anyOf() can be more precise than their restrict kind.
+  virtual bool canMatchNodesOfKind(ASTNodeKind Kind) const { return true; }
 };
 
 /// Generic interface for matchers on an AST node of type T.
@@ -203,9 +203,10 @@ private:
                                                      StringRef CrossTUDir,
                                                      StringRef IndexName,
                                                      bool DisplayCTUProgress);
+  void collectDefsInDeclContext(const DeclContext *DC,
+                                llvm::StringMap<const Decl *> &Defs);
   template <typename T>
-  const T *findDefInDeclContext(const DeclContext *DC,
-                                StringRef LookupName);
+  const T *findDefInUnit(ASTUnit *Unit, StringRef LookupName);
   template <typename T>
   llvm::Expected<const T *> importDefinitionImpl(const T *D, ASTUnit *Unit);
 
@@ -214,6 +215,11 @@ private:
 
   ImporterMapTy ASTUnitImporterMap;
 
+  /// The definitions of the functions and variables of each loaded unit by
+  /// their lookup name, collected when the unit is first looked up.
+  llvm::DenseMap<TranslationUnitDecl *, llvm::StringMap<const Decl *>>
+      DefinitionsByUnit;
+
   ASTContext &Context;
   std::shared_ptr<ASTImporterSharedState> ImporterSharedSt;
 
@@ -249,6 +249,13 @@ public:
   /// Output time trace profile.
   unsigned TimeTrace : 1;
 
+  /// Record the AST memory allocated by each section of the time trace.
+  unsigned TimeTraceMemory : 1;
+
+  /// Share the file manager and the module cache with the other cc1 jobs run
+  /// in the same process.
+  unsigned ReuseInProcessCaches : 1;
+
   /// Show the -version text.
   unsigned ShowVersion : 1;
 
@@ -461,8 +468,9 @@ public:
 public:
   FrontendOptions()
       : DisableFree(false), RelocatablePCH(false), ShowHelp(false),
-        ShowStats(false), TimeTrace(false), ShowVersion(false),
-        FixWhatYouCan(false), FixOnlyWarnings(false), FixAndRecompile(false),
+        ShowStats(false), TimeTrace(false), TimeTraceMemory(false),
+        ReuseInProcessCaches(false), ShowVersion(false), FixWhatYouCan(false),
+        FixOnlyWarnings(false), FixAndRecompile(false),
         FixToTemporaries(false), ARCMTMigrateEmitARCErrors(false),
         SkipFunctionBodies(false), UseGlobalModuleIndex(true),
         GenerateGlobalModuleIndex(true), ASTDumpDecls(false),
@@ -20,6 +20,8 @@
 #include "clang/Lex/ModuleMap.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallString.h"
@@ -30,6 +32,7 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -162,6 +165,39 @@ struct FrameworkCacheEntry {
   bool IsUserSpecifiedSystemFramework;
 };
 
+/// A thread-safe cache of \#include search results that can be shared by all
+/// the compilations a batch tool performs, e.g. the dependency scanner.
+///
+/// Entries are keyed on a hash of the search path configuration, so header
+/// searches with different search directories never see each other's results.
+/// The cache assumes that the file system doesn't change while it is in use.
+class SharedHeaderLookupCache {
+public:
+  /// Look up the result of searching for \p Filename starting at the search
+  /// directory with index \p StartIdx.
+  ///
+  /// \returns the index of the search directory containing the file, the
+  /// number of search directories if the file wasn't found, or None if no such
+  /// search has been recorded.
+  Optional<unsigned> lookup(llvm::hash_code SearchConfig, unsigned StartIdx,
+                            StringRef Filename) const;
+
+  /// Record the result of a search, see \c lookup.
+  void insert(llvm::hash_code SearchConfig, unsigned StartIdx,
+              StringRef Filename, unsigned HitIdx);
+
+  /// Forget all recorded searches, e.g. because headers may have been added
+  /// or removed since they were recorded.
+  void clear() {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Entries.clear();
+  }
+
+private:
+  mutable std::mutex Mutex;
+  llvm::StringMap<unsigned> Entries;
+};
+
 /// Encapsulates the information needed to find the file referenced
 /// by a \#include or \#include_next, (sub-)framework lookup, etc.
 class HeaderSearch {
@@ -232,6 +268,13 @@ class HeaderSearch {
   };
   llvm::StringMap<LookupFileCacheInfo, llvm::BumpPtrAllocator> LookupFileCache;
 
+  /// Lookup results shared with other compilations, if any. Unowned.
+  SharedHeaderLookupCache *SharedLookups = nullptr;
+
+  /// Hash of the search path configuration, used to key \c SharedLookups.
+  /// Computed on first use and reset whenever the search paths change.
+  Optional<llvm::hash_code> SearchConfigHash;
+
   /// Collection mapping a framework or subframework
   /// name like "Carbon" to the Carbon.framework directory.
   llvm::StringMap<FrameworkCacheEntry, llvm::BumpPtrAllocator> FrameworkMap;
@@ -295,6 +338,13 @@ public:
   void AddSystemSearchPath(const DirectoryLookup &dir) {
     SearchDirs.push_back(dir);
     SearchDirsUsage.push_back(false);
+    SearchConfigHash = None;
+  }
+
+  /// Set a cache of lookup results shared with other compilations that use
+  /// the same search paths. The cache is unowned.
+  void setSharedLookupCache(SharedHeaderLookupCache *Cache) {
+    SharedLookups = Cache;
   }
 
   /// Set the list of system header prefixes.
@@ -707,6 +757,10 @@ private:
   /// using the search path at index `HitIdx`.
   void cacheLookupSuccess(LookupFileCacheInfo &CacheLookup, unsigned HitIdx,
                           SourceLocation IncludeLoc);
+
+  /// Compute the key under which this header search's results are stored in
+  /// the shared lookup cache.
+  llvm::hash_code getSearchConfigHash();
   /// Note that a lookup at the given include location was successful using the
   /// search path at index `HitIdx`.
   void noteLookupUsage(unsigned HitIdx, SourceLocation IncludeLoc);
@@ -30,6 +30,8 @@ class MemoryBuffer;
 
 namespace clang {
 
+class SharedHeaderLookupCache;
+
 /// Enumerate the kinds of standard library that
 enum ObjCXXARCStandardLibraryKind {
   ARCXX_nolib,
@@ -207,6 +209,13 @@ public:
   ExcludedPreprocessorDirectiveSkipMapping
       *ExcludedConditionalDirectiveSkipMappings = nullptr;
 
+  /// A cache of \#include search results shared with other compilations.
+  ///
+  /// The pointer is passed to the HeaderSearch when the Preprocessor is
+  /// constructed. The pointer is unowned, the client is responsible for its
+  /// lifetime.
+  SharedHeaderLookupCache *SharedHeaderLookups = nullptr;
+
   /// Set up preprocessor for RunAnalysis action.
   bool SetUpStaticAnalyzer = false;
 
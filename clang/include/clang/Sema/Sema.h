@@ -6905,6 +6905,36 @@ private:
   llvm::ContextualFoldingSet<ConstraintSatisfaction, const ASTContext &>
       SatisfactionCache;
 
+  /// A failed substitution of deduced template arguments into the declaration
+  /// of a function template, together with the diagnostic explaining it.
+  struct CachedSubstitutionFailure : public llvm::FoldingSetNode {
+    FunctionTemplateDecl *Template;
+    SmallVector<TemplateArgument, 4> TemplateArgs;
+    Optional<PartialDiagnosticAt> Diag;
+
+    CachedSubstitutionFailure(FunctionTemplateDecl *Template,
+                              ArrayRef<TemplateArgument> TemplateArgs)
+        : Template(Template),
+          TemplateArgs(TemplateArgs.begin(), TemplateArgs.end()) {}
+
+    void Profile(llvm::FoldingSetNodeID &ID, const ASTContext &C) {
+      Profile(ID, C, Template, TemplateArgs);
+    }
+
+    static void Profile(llvm::FoldingSetNodeID &ID, const ASTContext &C,
+                        const FunctionTemplateDecl *Template,
+                        ArrayRef<TemplateArgument> TemplateArgs);
+  };
+
+  /// Caches the function template substitutions that failed, so that
+  /// overload resolution does not repeat them for the same template arguments.
+  llvm::ContextualFoldingSet<CachedSubstitutionFailure, const ASTContext &>
+      SubstitutionFailureCache;
+
+  /// The number of entries added to and found in SubstitutionFailureCache.
+  unsigned NumSubstitutionFailuresCached = 0;
+  unsigned NumSubstitutionFailureCacheHits = 0;
+
 public:
   const NormalizedConstraint *
   getNormalizedAssociatedConstraints(
@@ -974,6 +974,16 @@ private:
   /// The number of source location entries in the chain.
   unsigned TotalNumSLocEntries = 0;
 
+  /// The number of input files that have been looked up in the file manager.
+  unsigned NumInputFilesLoaded = 0;
+
+  /// The number of input files referenced by the chain.
+  unsigned TotalNumInputFiles = 0;
+
+  /// The number of identifiers that were eagerly marked out of date when
+  /// the module file providing them was loaded.
+  unsigned NumIdentifiersPreloaded = 0;
+
   /// The number of statements (and expressions) de-serialized
   /// from the chain.
   unsigned NumStatementsRead = 0;
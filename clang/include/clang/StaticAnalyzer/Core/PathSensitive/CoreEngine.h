@@ -96,6 +96,9 @@ private:
   /// (This data is owned by AnalysisConsumer.)
   FunctionSummariesTy *FunctionSummaries;
 
+  /// The memory budget of the exploded graph in bytes, or 0 if unlimited.
+  uint64_t MaxGraphBytes;
+
   /// Add path tags with some useful data along the path when we see that
   /// something interesting is happening. This field is the allocator for such
   /// tags.
@@ -451,6 +451,19 @@ public:
   /// was called.
   void reclaimRecentlyAllocatedNodes();
 
+  /// Reclaim "uninteresting" nodes created since the last reclamation right
+  /// away, regardless of the reclamation interval.
+  ///
+  /// \returns The number of reclaimed nodes.
+  unsigned reclaimChangedNodes();
+
+  /// Returns true if there are reclaimed nodes left to be reused.
+  bool hasFreeNodes() const { return !FreeNodes.empty(); }
+
+  /// Returns the number of bytes allocated for the nodes of the graph and for
+  /// everything else sharing its allocator, such as the program states.
+  size_t getBytesAllocated() { return getAllocator().getBytesAllocated(); }
+
   /// Returns true if nodes for the given expression kind are always
   ///        kept around.
   static bool isInterestingLValueExpr(const Expr *Ex);
@@ -40,6 +40,9 @@ struct CachedFileContents {
   /// Skipped range mapping of the minimized contents.
   /// This is initialized iff `MinimizedAccess != nullptr`.
   PreprocessorSkippedRangeMapping PPSkippedRangeMapping;
+  /// Owning storage for minimized contents loaded from the on-disk cache.
+  /// `MinimizedStorage` refers into this buffer when it's set.
+  std::unique_ptr<llvm::MemoryBuffer> OnDiskStorage;
 };
 
 /// An in-memory representation of a file system entity that is of interest to
@@ -204,9 +207,30 @@ public:
   CacheShard &getShardForFilename(StringRef Filename) const;
   CacheShard &getShardForUID(llvm::sys::fs::UniqueID UID) const;
 
+  /// Sets the directory used to persist minimized file contents across
+  /// scanner invocations. Entries are keyed on the hash of the original
+  /// contents, so they never need to be invalidated. An empty path disables
+  /// the on-disk cache.
+  void setOnDiskCachePath(StringRef Path) { OnDiskCachePath = Path.str(); }
+
+  /// Returns the on-disk cache directory, or an empty string if disabled.
+  StringRef getOnDiskCachePath() const { return OnDiskCachePath; }
+
+  /// Drops the entries that may no longer reflect the underlying file system
+  /// \p FS: files whose unique ID, size or modification time changed, files
+  /// that no longer exist, and all cached errors and directories. Entries of
+  /// unchanged files, including their minimized contents, are kept.
+  ///
+  /// This must not be called while any worker is using the cache. The storage
+  /// of dropped entries is only released when the cache is destroyed.
+  ///
+  /// \returns The number of filenames whose entries were dropped.
+  unsigned invalidateChangedEntries(llvm::vfs::FileSystem &FS);
+
 private:
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
+  std::string OnDiskCachePath;
 };
 
 /// This class is a local cache, that caches the 'stat' and 'open' calls to the
@@ -9,6 +9,7 @@
 #ifndef LLVM_CLANG_TOOLING_DEPENDENCYSCANNING_DEPENDENCYSCANNINGSERVICE_H
 #define LLVM_CLANG_TOOLING_DEPENDENCYSCANNING_DEPENDENCYSCANNINGSERVICE_H
 
+#include "clang/Lex/HeaderSearch.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 
 namespace clang {
@@ -65,6 +66,19 @@ public:
     return SharedCache;
   }
 
+  SharedHeaderLookupCache &getSharedHeaderLookups() {
+    return SharedHeaderLookups;
+  }
+
+  /// Prepares the shared caches for another round of scans after files on
+  /// disk may have changed. Cached entries of changed files and all header
+  /// search results are dropped, while unchanged files keep their cached (and
+  /// minimized) contents.
+  ///
+  /// This must not be called while a scan is in progress. Workers keep their
+  /// own caches, so workers created before this call must not be reused.
+  void invalidateChangedFiles();
+
 private:
   const ScanningMode Mode;
   const ScanningOutputFormat Format;
@@ -77,6 +91,8 @@ private:
   const bool OptimizeArgs;
   /// The global file system cache.
   DependencyScanningFilesystemSharedCache SharedCache;
+  /// The global cache of header search results.
+  SharedHeaderLookupCache SharedHeaderLookups;
 };
 
 } // end namespace dependencies
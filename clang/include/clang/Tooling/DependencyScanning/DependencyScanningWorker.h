@@ -82,6 +82,8 @@ private:
   /// The file manager that is reused across multiple invocations by this
   /// worker. If null, the file manager will not be reused.
   llvm::IntrusiveRefCntPtr<FileManager> Files;
+  /// The header search results shared by all the workers.
+  SharedHeaderLookupCache &SharedHeaderLookups;
   ScanningOutputFormat Format;
   /// Whether to optimize the modules' command-line arguments.
   bool OptimizeArgs;
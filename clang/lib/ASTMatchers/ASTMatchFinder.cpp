@@ -847,20 +847,33 @@ private:
       return;
 
     const bool EnableCheckProfiling = Options.CheckProfiling.hasValue();
+    const bool EnableMatcherProfiling =
+        EnableCheckProfiling && Options.CheckProfiling->PerMatcher;
     TimeBucketRegion Timer;
+    TimeBucketRegion MatcherTimer;
     auto &Matchers = this->Matchers->DeclOrStmt;
+    // Most matchers share the default traversal kind, so only ask once per
+    // run of equal kinds whether the node is skipped by it.
+    llvm::Optional<llvm::Optional<TraversalKind>> LastTK;
+    bool IgnoredByLastTK = false;
     for (unsigned short I : Filter) {
       auto &MP = Matchers[I];
       if (EnableCheckProfiling)
         Timer.setBucket(&TimeByBucket[MP.second->getID()]);
+      if (EnableMatcherProfiling)
+        MatcherTimer.setBucket(&TimeByBucket[getMatcherBucketName(I)]);
       BoundNodesTreeBuilder Builder;
 
-      {
-        TraversalKindScope RAII(getASTContext(), MP.first.getTraversalKind());
-        if (getASTContext().getParentMapContext().traverseIgnored(DynNode) !=
-            DynNode)
-          continue;
+      llvm::Optional<TraversalKind> TK = MP.first.getTraversalKind();
+      if (!LastTK || *LastTK != TK) {
+        TraversalKindScope RAII(getASTContext(), TK);
+        IgnoredByLastTK =
+            getASTContext().getParentMapContext().traverseIgnored(DynNode) !=
+            DynNode;
+        LastTK = TK;
       }
+      if (IgnoredByLastTK)
+        continue;
 
       if (MP.first.matches(DynNode, this, &Builder)) {
         MatchVisitor Visitor(ActiveASTContext, MP.second);
@@ -869,6 +882,20 @@ private:
     }
   }
 
+  /// Returns the name of the per-matcher profiling bucket of the \p I-th
+  /// \c Decl or \c Stmt matcher.
+  StringRef getMatcherBucketName(unsigned I) {
+    if (MatcherBucketNames.empty()) {
+      llvm::StringMap<unsigned> MatchersPerCallback;
+      for (const auto &MP : Matchers->DeclOrStmt) {
+        StringRef ID = MP.second->getID();
+        MatcherBucketNames.push_back(
+            (ID + "#" + Twine(MatchersPerCallback[ID]++)).str());
+      }
+    }
+    return MatcherBucketNames[I];
+  }
+
   const std::vector<unsigned short> &getFilterForKind(ASTNodeKind Kind) {
     auto &Filter = MatcherFiltersMap[Kind];
     auto &Matchers = this->Matchers->DeclOrStmt;
@@ -1106,6 +1133,9 @@ private:
   /// Used to get the appropriate bucket for each matcher.
   llvm::StringMap<llvm::TimeRecord> TimeByBucket;
 
+  /// Per-matcher bucket names, indexed like \c Matchers->DeclOrStmt.
+  std::vector<std::string> MatcherBucketNames;
+
   const MatchFinder::MatchersByType *Matchers;
 
   /// Filtered list of matcher indices for each matcher kind.
@@ -115,15 +115,41 @@ using VariadicOperatorFunction = bool (*)(
 template <VariadicOperatorFunction Func>
 class VariadicMatcher : public DynMatcherInterface {
 public:
-  VariadicMatcher(std::vector<DynTypedMatcher> InnerMatchers)
-      : InnerMatchers(std::move(InnerMatchers)) {}
+  VariadicMatcher(DynTypedMatcher::VariadicOperator Op,
+                  std::vector<DynTypedMatcher> InnerMatchers)
+      : Op(Op), InnerMatchers(std::move(InnerMatchers)) {}
 
   bool dynMatches(const DynTypedNode &DynNode, ASTMatchFinder *Finder,
                   BoundNodesTreeBuilder *Builder) const override {
     return Func(DynNode, Finder, Builder, InnerMatchers);
   }
 
+  bool canMatchNodesOfKind(ASTNodeKind Kind) const override {
+    // Inner matchers with a traversal kind of their own may be matched against
+    // another node than the one passed in, e.g. the expression below an
+    // implicit cast, so their kinds don't tell whether this one can match.
+    if (llvm::any_of(InnerMatchers, [](const DynTypedMatcher &M) {
+          return M.getTraversalKind().hasValue();
+        }))
+      return true;
+    auto CanMatch = [Kind](const DynTypedMatcher &M) {
+      return M.canMatchNodesOfKind(Kind);
+    };
+    switch (Op) {
+    case DynTypedMatcher::VO_AllOf:
+      return llvm::all_of(InnerMatchers, CanMatch);
+    case DynTypedMatcher::VO_AnyOf:
+    case DynTypedMatcher::VO_EachOf:
+      return llvm::any_of(InnerMatchers, CanMatch);
+    case DynTypedMatcher::VO_Optionally:
+    case DynTypedMatcher::VO_UnaryNot:
+      return true;
+    }
+    llvm_unreachable("Invalid Op value.");
+  }
+
 private:
+  const DynTypedMatcher::VariadicOperator Op;
   std::vector<DynTypedMatcher> InnerMatchers;
 };
 
@@ -144,6 +170,10 @@ public:
     return InnerMatcher->TraversalKind();
   }
 
+  bool canMatchNodesOfKind(ASTNodeKind Kind) const override {
+    return InnerMatcher->canMatchNodesOfKind(Kind);
+  }
+
 private:
   const std::string ID;
   const IntrusiveRefCntPtr<DynMatcherInterface> InnerMatcher;
@@ -180,6 +210,10 @@ public:
     return TK;
   }
 
+  bool canMatchNodesOfKind(ASTNodeKind Kind) const override {
+    return InnerMatcher->canMatchNodesOfKind(Kind);
+  }
+
 private:
   clang::TraversalKind TK;
   IntrusiveRefCntPtr<DynMatcherInterface> InnerMatcher;
@@ -219,31 +253,31 @@ DynTypedMatcher::constructVariadic(DynTypedMatcher::VariadicOperator Op,
       RestrictKind =
           ASTNodeKind::getMostDerivedType(RestrictKind, IM.RestrictKind);
     }
-    return DynTypedMatcher(
-        SupportedKind, RestrictKind,
-        new VariadicMatcher<allOfVariadicOperator>(std::move(InnerMatchers)));
+    return DynTypedMatcher(SupportedKind, RestrictKind,
+                           new VariadicMatcher<allOfVariadicOperator>(
+                               Op, std::move(InnerMatchers)));
 
   case VO_AnyOf:
-    return DynTypedMatcher(
-        SupportedKind, RestrictKind,
-        new VariadicMatcher<anyOfVariadicOperator>(std::move(InnerMatchers)));
+    return DynTypedMatcher(SupportedKind, RestrictKind,
+                           new VariadicMatcher<anyOfVariadicOperator>(
+                               Op, std::move(InnerMatchers)));
 
   case VO_EachOf:
-    return DynTypedMatcher(
-        SupportedKind, RestrictKind,
-        new VariadicMatcher<eachOfVariadicOperator>(std::move(InnerMatchers)));
+    return DynTypedMatcher(SupportedKind, RestrictKind,
+                           new VariadicMatcher<eachOfVariadicOperator>(
+                               Op, std::move(InnerMatchers)));
 
   case VO_Optionally:
     return DynTypedMatcher(SupportedKind, RestrictKind,
                            new VariadicMatcher<optionallyVariadicOperator>(
-                               std::move(InnerMatchers)));
+                               Op, std::move(InnerMatchers)));
 
   case VO_UnaryNot:
     // FIXME: Implement the Not operator to take a single matcher instead of a
     // vector.
     return DynTypedMatcher(
         SupportedKind, RestrictKind,
-        new VariadicMatcher<notUnaryOperator>(std::move(InnerMatchers)));
+        new VariadicMatcher<notUnaryOperator>(Op, std::move(InnerMatchers)));
   }
   llvm_unreachable("Invalid Op value.");
 }
@@ -273,7 +307,8 @@ DynTypedMatcher DynTypedMatcher::trueMatcher(ASTNodeKind NodeKind) {
 }
 
 bool DynTypedMatcher::canMatchNodesOfKind(ASTNodeKind Kind) const {
-  return RestrictKind.isBaseOf(Kind);
+  return RestrictKind.isBaseOf(Kind) &&
+         Implementation->canMatchNodesOfKind(Kind);
 }
 
 DynTypedMatcher DynTypedMatcher::dynCastTo(const ASTNodeKind Kind) const {
@@ -502,7 +502,13 @@ static void setVisibilityFromDLLStorageClass(const clang::LangOptions &LO,
 }
 
 void CodeGenModule::Release() {
-  EmitDeferred();
+  llvm::TimeTraceScope TimeScope("CodeGen Release");
+  {
+    // This is where the bodies of most inline and template functions are
+    // emitted, after the whole translation unit has been parsed.
+    llvm::TimeTraceScope DeferredScope("CodeGen Deferred Decls");
+    EmitDeferred();
+  }
   EmitVTablesOpportunistically();
   applyGlobalValReplacements();
   applyReplacements();
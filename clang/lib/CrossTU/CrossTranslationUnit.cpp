@@ -226,29 +226,52 @@ CrossTranslationUnitContext::getLookupName(const NamedDecl *ND) {
   return std::string(DeclUSR.str());
 }
 
-/// Recursively visits the decls of a DeclContext, and returns one with the
-/// given USR.
-template <typename T>
-const T *
-CrossTranslationUnitContext::findDefInDeclContext(const DeclContext *DC,
-                                                  StringRef LookupName) {
+/// Recursively visits the decls of a DeclContext, and adds the function and
+/// variable definitions to \p Defs by their USR. The first definition found
+/// for a USR wins.
+void CrossTranslationUnitContext::collectDefsInDeclContext(
+    const DeclContext *DC, llvm::StringMap<const Decl *> &Defs) {
   assert(DC && "Declaration Context must not be null");
   for (const Decl *D : DC->decls()) {
     const auto *SubDC = dyn_cast<DeclContext>(D);
     if (SubDC)
-      if (const auto *ND = findDefInDeclContext<T>(SubDC, LookupName))
-        return ND;
-
-    const auto *ND = dyn_cast<T>(D);
-    const T *ResultDecl;
-    if (!ND || !hasBodyOrInit(ND, ResultDecl))
-      continue;
-    llvm::Optional<std::string> ResultLookupName = getLookupName(ResultDecl);
-    if (!ResultLookupName || *ResultLookupName != LookupName)
+      collectDefsInDeclContext(SubDC, Defs);
+
+    const Decl *ResultDecl = nullptr;
+    if (const auto *FD = dyn_cast<FunctionDecl>(D)) {
+      const FunctionDecl *DefD;
+      if (hasBodyOrInit(FD, DefD))
+        ResultDecl = DefD;
+    } else if (const auto *VD = dyn_cast<VarDecl>(D)) {
+      const VarDecl *DefD;
+      if (hasBodyOrInit(VD, DefD))
+        ResultDecl = DefD;
+    }
+    if (!ResultDecl)
       continue;
-    return ResultDecl;
+    llvm::Optional<std::string> ResultLookupName =
+        getLookupName(cast<NamedDecl>(ResultDecl));
+    if (ResultLookupName)
+      Defs.try_emplace(*ResultLookupName, ResultDecl);
+  }
+}
+
+/// Returns the definition with the given USR from \p Unit. The definitions
+/// of a unit are indexed once, so that repeated lookups, including the ones
+/// that fail to import, do not walk the whole unit again.
+template <typename T>
+const T *CrossTranslationUnitContext::findDefInUnit(ASTUnit *Unit,
+                                                    StringRef LookupName) {
+  TranslationUnitDecl *TU = Unit->getASTContext().getTranslationUnitDecl();
+  auto It = DefinitionsByUnit.find(TU);
+  if (It == DefinitionsByUnit.end()) {
+    It = DefinitionsByUnit.try_emplace(TU).first;
+    collectDefsInDeclContext(TU, It->second);
   }
-  return nullptr;
+  auto DefIt = It->second.find(LookupName);
+  if (DefIt == It->second.end())
+    return nullptr;
+  return dyn_cast<T>(DefIt->second);
 }
 
 template <typename T>
@@ -319,8 +342,7 @@ llvm::Expected<const T *> CrossTranslationUnitContext::getCrossTUDefinitionImpl(
         index_error_code::lang_dialect_mismatch);
   }
 
-  TranslationUnitDecl *TU = Unit->getASTContext().getTranslationUnitDecl();
-  if (const T *ResultDecl = findDefInDeclContext<T>(TU, *LookupName))
+  if (const T *ResultDecl = findDefInUnit<T>(Unit, *LookupName))
     return importDefinition(ResultDecl, Unit);
   return llvm::make_error<IndexError>(index_error_code::failed_import);
 }
@@ -1439,8 +1439,14 @@ static bool compileModuleAndReadASTBehindLock(
     }
 
     // Someone else is responsible for building the module. Wait for them to
-    // finish.
-    switch (Locked.waitForUnlock()) {
+    // finish. Time spent here is time this compile is serialized behind
+    // another process, so make it visible in -ftime-trace.
+    llvm::LockFileManager::WaitForUnlockResult WaitResult;
+    {
+      llvm::TimeTraceScope TimeScope("Module Lock Wait", Module->Name);
+      WaitResult = Locked.waitForUnlock();
+    }
+    switch (WaitResult) {
     case llvm::LockFileManager::Res_Success:
       break; // The interesting case.
     case llvm::LockFileManager::Res_OwnerDied:
@@ -37,6 +37,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
@@ -79,6 +80,35 @@ HeaderFileInfo::getControllingMacro(ExternalPreprocessorSource *External) {
 
 ExternalHeaderFileInfoSource::~ExternalHeaderFileInfoSource() = default;
 
+static void makeSharedLookupKey(SmallVectorImpl<char> &Key,
+                                llvm::hash_code SearchConfig,
+                                unsigned StartIdx, StringRef Filename) {
+  llvm::raw_svector_ostream OS(Key);
+  OS << static_cast<size_t>(SearchConfig) << ':' << StartIdx << ':'
+     << Filename;
+}
+
+Optional<unsigned> SharedHeaderLookupCache::lookup(llvm::hash_code SearchConfig,
+                                                   unsigned StartIdx,
+                                                   StringRef Filename) const {
+  SmallString<128> Key;
+  makeSharedLookupKey(Key, SearchConfig, StartIdx, Filename);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto It = Entries.find(Key);
+  if (It == Entries.end())
+    return None;
+  return It->second;
+}
+
+void SharedHeaderLookupCache::insert(llvm::hash_code SearchConfig,
+                                     unsigned StartIdx, StringRef Filename,
+                                     unsigned HitIdx) {
+  SmallString<128> Key;
+  makeSharedLookupKey(Key, SearchConfig, StartIdx, Filename);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Entries.try_emplace(Key, HitIdx);
+}
+
 HeaderSearch::HeaderSearch(std::shared_ptr<HeaderSearchOptions> HSOpts,
                            SourceManager &SourceMgr, DiagnosticsEngine &Diags,
                            const LangOptions &LangOpts,
@@ -115,6 +145,7 @@ void HeaderSearch::SetSearchPaths(
   SystemDirIdx = systemDirIdx;
   NoCurDirSearch = noCurDirSearch;
   SearchDirToHSEntry = std::move(searchDirToHSEntry);
+  SearchConfigHash = None;
   //LookupFileCache.clear();
 }
 
@@ -125,6 +156,7 @@ void HeaderSearch::AddSearchPath(const DirectoryLookup &dir, bool isAngled) {
   if (!isAngled)
     AngledDirIdx++;
   SystemDirIdx++;
+  SearchConfigHash = None;
 }
 
 std::vector<bool> HeaderSearch::computeUserEntryUsage() const {
@@ -700,6 +732,27 @@ void HeaderSearch::cacheLookupSuccess(LookupFileCacheInfo &CacheLookup,
   noteLookupUsage(HitIdx, Loc);
 }
 
+llvm::hash_code HeaderSearch::getSearchConfigHash() {
+  if (SearchConfigHash)
+    return *SearchConfigHash;
+
+  // Relative search paths and VFS overlays change what a search directory
+  // refers to, so they are part of the configuration as well.
+  llvm::hash_code Hash =
+      llvm::hash_combine(AngledDirIdx, SystemDirIdx,
+                         FileMgr.getFileSystemOpts().WorkingDir);
+  if (auto CWD = FileMgr.getVirtualFileSystem().getCurrentWorkingDirectory())
+    Hash = llvm::hash_combine(Hash, *CWD);
+  for (const std::string &Overlay : HSOpts->VFSOverlayFiles)
+    Hash = llvm::hash_combine(Hash, Overlay);
+  for (const DirectoryLookup &DL : SearchDirs)
+    Hash = llvm::hash_combine(Hash, DL.getLookupType(),
+                              DL.getDirCharacteristic(), DL.isIndexHeaderMap(),
+                              DL.getName());
+  SearchConfigHash = Hash;
+  return Hash;
+}
+
 void HeaderSearch::noteLookupUsage(unsigned HitIdx, SourceLocation Loc) {
   SearchDirsUsage[HitIdx] = true;
 
@@ -961,6 +1014,8 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
   // file was found in.
   if (FromDir)
     i = FromDir-&SearchDirs[0];
+  unsigned StartIdx = i;
+  bool RecordSharedLookup = SharedLookups != nullptr;
 
   // Cache all of the lookups performed by this method.  Many headers are
   // multiply included, and the "pragma once" optimization prevents them from
@@ -974,6 +1029,7 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
   if (!SkipCache && CacheLookup.StartIdx == i+1) {
     // Skip querying potentially lots of directories for this lookup.
     i = CacheLookup.HitIdx;
+    RecordSharedLookup = false;
     if (CacheLookup.MappedName) {
       Filename = CacheLookup.MappedName;
       if (IsMapped)
@@ -984,6 +1040,16 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
     // our search start.  We will fill in our found location below, so prime the
     // start point value.
     CacheLookup.reset(/*StartIdx=*/i+1);
+
+    // Another compilation with the same search paths may already have done
+    // this search.
+    if (!SkipCache && SharedLookups) {
+      if (Optional<unsigned> HitIdx = SharedLookups->lookup(
+              getSearchConfigHash(), StartIdx, Filename)) {
+        i = *HitIdx;
+        RecordSharedLookup = false;
+      }
+    }
   }
 
   SmallString<64> MappedName;
@@ -1063,6 +1129,10 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
 
     // Remember this location for the next lookup we do.
     cacheLookupSuccess(CacheLookup, i, IncludeLoc);
+    // Results that depend on a header map remapping aren't shared, since the
+    // remapped name is needed to redo the search from the hit index.
+    if (RecordSharedLookup && !CacheLookup.MappedName)
+      SharedLookups->insert(getSearchConfigHash(), StartIdx, Filename, i);
     return File;
   }
 
@@ -1108,6 +1178,9 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
 
   // Otherwise, didn't find it. Remember we didn't find this.
   CacheLookup.HitIdx = SearchDirs.size();
+  if (RecordSharedLookup && !CacheLookup.MappedName)
+    SharedLookups->insert(getSearchConfigHash(), StartIdx, Filename,
+                          CacheLookup.HitIdx);
   return None;
 }
 
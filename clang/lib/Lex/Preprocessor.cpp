@@ -163,6 +163,9 @@ Preprocessor::Preprocessor(std::shared_ptr<PreprocessorOptions> PPOpts,
   if (ExcludedConditionalDirectiveSkipMappings)
     ExcludedConditionalDirectiveSkipMappings->clear();
 
+  if (this->PPOpts->SharedHeaderLookups)
+    HeaderInfo.setSharedLookupCache(this->PPOpts->SharedHeaderLookups);
+
   MaxTokens = LangOpts.MaxTokens;
 }
 
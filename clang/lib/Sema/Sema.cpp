@@ -207,7 +207,8 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
       TUKind(TUKind), NumSFINAEErrors(0),
       FullyCheckedComparisonCategories(
           static_cast<unsigned>(ComparisonCategoryType::Last) + 1),
-      SatisfactionCache(Context), AccessCheckingSFINAE(false),
+      SatisfactionCache(Context), SubstitutionFailureCache(Context),
+      AccessCheckingSFINAE(false),
       InNonInstantiationSFINAEContext(false), NonInstantiationEntries(0),
       ArgumentPackSubstitutionIndex(-1), CurrentInstantiationScope(nullptr),
       DisableTypoCorrection(false), TyposCorrected(0), AnalysisWarnings(*this),
@@ -475,6 +476,13 @@ Sema::~Sema() {
   for (auto *Node : Satisfactions)
     delete Node;
 
+  // Delete cached substitution failures.
+  std::vector<CachedSubstitutionFailure *> SubstitutionFailures;
+  for (auto &Node : SubstitutionFailureCache)
+    SubstitutionFailures.push_back(&Node);
+  for (auto *Node : SubstitutionFailures)
+    delete Node;
+
   threadSafety::threadSafetyCleanup(ThreadSafetyDeclCache);
 
   // Destroys data sharing attributes stack for OpenMP
@@ -552,6 +560,9 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumSubstitutionFailuresCached
+               << " function template substitution failures cached, "
+               << NumSubstitutionFailureCacheHits << " reused.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
@@ -3420,6 +3420,16 @@ static unsigned getPackIndexForParam(Sema &S,
   llvm_unreachable("parameter index would not be produced from template");
 }
 
+void Sema::CachedSubstitutionFailure::Profile(
+    llvm::FoldingSetNodeID &ID, const ASTContext &C,
+    const FunctionTemplateDecl *Template,
+    ArrayRef<TemplateArgument> TemplateArgs) {
+  ID.AddPointer(Template);
+  ID.AddInteger(TemplateArgs.size());
+  for (auto &Arg : TemplateArgs)
+    Arg.Profile(ID, C);
+}
+
 /// Finish template argument deduction for a function template,
 /// checking the deduced template arguments for completeness and forming
 /// the function template specialization.
@@ -3476,16 +3486,49 @@ Sema::TemplateDeductionResult Sema::FinishTemplateArgumentDeduction(
     = TemplateArgumentList::CreateCopy(Context, Builder);
   Info.reset(DeducedArgumentList);
 
+  // Successful substitutions are found again as existing specializations, but
+  // failed ones would be repeated for every call with the same arguments.
+  llvm::FoldingSetNodeID FailureID;
+  bool ShouldCacheFailure =
+      LangOpts.TemplateSubstitutionFailureCaching && !PartialOverloading;
+  if (ShouldCacheFailure) {
+    void *InsertPos;
+    CachedSubstitutionFailure::Profile(FailureID, Context, FunctionTemplate,
+                                       Builder);
+    if (CachedSubstitutionFailure *Failure =
+            SubstitutionFailureCache.FindNodeOrInsertPos(FailureID,
+                                                         InsertPos)) {
+      ++NumSubstitutionFailureCacheHits;
+      if (Failure->Diag)
+        Info.addSFINAEDiagnostic(Failure->Diag->first, Failure->Diag->second);
+      return TDK_SubstitutionFailure;
+    }
+  }
+
   // Substitute the deduced template arguments into the function template
   // declaration to produce the function template specialization.
   DeclContext *Owner = FunctionTemplate->getDeclContext();
   if (FunctionTemplate->getFriendObjectKind())
     Owner = FunctionTemplate->getLexicalDeclContext();
   MultiLevelTemplateArgumentList SubstArgs(*DeducedArgumentList);
+  unsigned NumErrorsBefore = getDiagnostics().getNumErrors();
   Specialization = cast_or_null<FunctionDecl>(
       SubstDecl(FunctionTemplate->getTemplatedDecl(), Owner, SubstArgs));
-  if (!Specialization || Specialization->isInvalidDecl())
+  if (!Specialization || Specialization->isInvalidDecl()) {
+    // Only remember failures that were entirely trapped; anything that was
+    // diagnosed as a hard error must be diagnosed again on the next attempt.
+    if (ShouldCacheFailure && !Specialization &&
+        getDiagnostics().getNumErrors() == NumErrorsBefore) {
+      auto *Failure = new CachedSubstitutionFailure(FunctionTemplate, Builder);
+      if (Info.hasSFINAEDiagnostic())
+        Failure->Diag = Info.peekSFINAEDiagnostic();
+      // We cannot use the insert position computed above because the
+      // substitution might have invalidated it.
+      SubstitutionFailureCache.InsertNode(Failure);
+      ++NumSubstitutionFailuresCached;
+    }
     return TDK_SubstitutionFailure;
+  }
 
   assert(Specialization->getPrimaryTemplate()->getCanonicalDecl() ==
          FunctionTemplate->getCanonicalDecl());
@@ -2457,6 +2457,7 @@ InputFile ASTReader::getInputFile(ModuleFile &F, unsigned ID, bool Complain) {
 
   // Note that we've loaded this input file.
   F.InputFilesLoaded[ID-1] = IF;
+  ++NumInputFilesLoaded;
   return IF;
 }
 
@@ -2953,6 +2954,7 @@ ASTReader::ReadControlBlock(ModuleFile &F,
           (const llvm::support::unaligned_uint64_t *)Blob.data();
       F.InputFilesLoaded.resize(NumInputs);
       F.NumUserInputFiles = NumUserInputs;
+      TotalNumInputFiles += NumInputs;
       break;
     }
   }
@@ -4324,6 +4326,7 @@ ASTReader::ASTReadResult ASTReader::ReadAST(StringRef FileName,
       auto ID = Trait.ReadIdentifierID(Data + KeyDataLen.first);
       SetIdentifierInfo(ID, &II);
     }
+    NumIdentifiersPreloaded += F.PreloadIdentifierOffsets.size();
   }
 
   // Setup the import locations and notify the module manager that we've
@@ -7723,6 +7726,10 @@ void ASTReader::StartTranslationUnit(ASTConsumer *Consumer) {
 void ASTReader::PrintStats() {
   std::fprintf(stderr, "*** AST File Statistics:\n");
 
+  if (unsigned NumModuleFiles = ModuleMgr.size())
+    std::fprintf(stderr, "  %u module files loaded, %u submodules read\n",
+                 NumModuleFiles, getTotalNumSubmodules());
+
   unsigned NumTypesLoaded =
       TypesLoaded.size() - llvm::count(TypesLoaded, QualType());
   unsigned NumDeclsLoaded =
@@ -7739,6 +7746,10 @@ void ASTReader::PrintStats() {
     std::fprintf(stderr, "  %u/%u source location entries read (%f%%)\n",
                  NumSLocEntriesRead, TotalNumSLocEntries,
                  ((float)NumSLocEntriesRead/TotalNumSLocEntries * 100));
+  if (TotalNumInputFiles)
+    std::fprintf(stderr, "  %u/%u input files loaded (%f%%)\n",
+                 NumInputFilesLoaded, TotalNumInputFiles,
+                 ((float)NumInputFilesLoaded/TotalNumInputFiles * 100));
   if (!TypesLoaded.empty())
     std::fprintf(stderr, "  %u/%u types read (%f%%)\n",
                  NumTypesLoaded, (unsigned)TypesLoaded.size(),
@@ -7751,6 +7762,9 @@ void ASTReader::PrintStats() {
     std::fprintf(stderr, "  %u/%u identifiers read (%f%%)\n",
                  NumIdentifiersLoaded, (unsigned)IdentifiersLoaded.size(),
                  ((float)NumIdentifiersLoaded/IdentifiersLoaded.size() * 100));
+  if (NumIdentifiersPreloaded)
+    std::fprintf(stderr, "  %u identifiers preloaded\n",
+                 NumIdentifiersPreloaded);
   if (!MacrosLoaded.empty())
     std::fprintf(stderr, "  %u/%u macros read (%f%%)\n",
                  NumMacrosLoaded, (unsigned)MacrosLoaded.size(),
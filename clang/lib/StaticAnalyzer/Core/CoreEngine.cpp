@@ -47,6 +47,12 @@ STATISTIC(NumReachedMaxSteps,
             "The # of times we reached the max number of steps.");
 STATISTIC(NumPathsExplored,
             "The # of paths explored by the analyzer.");
+STATISTIC(NumReachedMaxGraphMemory,
+            "The # of times we reached the max memory of the exploded graph.");
+STATISTIC(MaxGraphNodes,
+            "The maximum # of nodes retained in an exploded graph.");
+STATISTIC(MaxGraphBytesAllocated,
+            "The maximum # of bytes allocated for an exploded graph.");
 
 //===----------------------------------------------------------------------===//
 // Core analysis engine.
@@ -73,7 +79,8 @@ static std::unique_ptr<WorkList> generateWorkList(AnalyzerOptions &Opts) {
 CoreEngine::CoreEngine(ExprEngine &exprengine, FunctionSummariesTy *FS,
                        AnalyzerOptions &Opts)
     : ExprEng(exprengine), WList(generateWorkList(Opts)),
-      BCounterFactory(G.getAllocator()), FunctionSummaries(FS) {}
+      BCounterFactory(G.getAllocator()), FunctionSummaries(FS),
+      MaxGraphBytes(uint64_t(Opts.MaxGraphMemoryMB) << 20) {}
 
 /// ExecuteWorkList - Run the worklist algorithm for a maximum number of steps.
 bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
@@ -134,6 +141,15 @@ bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
       --Steps;
     }
 
+    // Over the memory budget, the graph may only grow by reusing reclaimed
+    // nodes. Reclaim the nodes created since the last time whenever those run
+    // out, and give up once nothing can be reclaimed.
+    if (MaxGraphBytes && G.getBytesAllocated() > MaxGraphBytes &&
+        !G.hasFreeNodes() && G.reclaimChangedNodes() == 0) {
+      NumReachedMaxGraphMemory++;
+      break;
+    }
+
     NumSteps++;
 
     const WorkListUnit& WU = WList->dequeue();
@@ -146,6 +162,8 @@ bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
 
     dispatchWorkItem(Node, Node->getLocation(), WU);
   }
+  MaxGraphNodes.updateMax(G.size());
+  MaxGraphBytesAllocated.updateMax(G.getBytesAllocated());
   ExprEng.processEndWorklist();
   return WList->hasWork();
 }
@@ -28,6 +28,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Casting.h"
 #include <cassert>
 #include <memory>
@@ -35,6 +36,12 @@
 using namespace clang;
 using namespace ento;
 
+#define DEBUG_TYPE "ExplodedGraph"
+
+STATISTIC(NumReclaimedNodes, "The # of exploded nodes reclaimed.");
+STATISTIC(NumReclaimedNodeBytes,
+          "The # of bytes of exploded nodes reclaimed for reuse.");
+
 //===----------------------------------------------------------------------===//
 // Cleanup.
 //===----------------------------------------------------------------------===//
@@ -178,10 +185,20 @@ void ExplodedGraph::reclaimRecentlyAllocatedNodes() {
     return;
   ReclaimCounter = ReclaimNodeInterval;
 
+  reclaimChangedNodes();
+}
+
+unsigned ExplodedGraph::reclaimChangedNodes() {
+  unsigned NumCollected = 0;
   for (const auto node : ChangedNodes)
-    if (shouldCollect(node))
+    if (shouldCollect(node)) {
       collectNode(node);
+      ++NumCollected;
+    }
   ChangedNodes.clear();
+  NumReclaimedNodes += NumCollected;
+  NumReclaimedNodeBytes += NumCollected * sizeof(ExplodedNode);
+  return NumCollected;
 }
 
 //===----------------------------------------------------------------------===//
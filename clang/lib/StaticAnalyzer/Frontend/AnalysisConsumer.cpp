@@ -79,6 +79,8 @@ class AnalysisConsumer : public AnalysisASTConsumer,
 
   /// Mode of the analyzes while recursively visiting Decls.
   AnalysisMode RecVisitorMode;
+  /// The number of function definitions visited with \c AM_Path so far.
+  unsigned NumRecVisitorRoots = 0;
   /// Bug Reporter to use while recursively visiting Decls.
   BugReporter *RecVisitorBR;
 
@@ -322,27 +324,27 @@ public:
     // only determined when they are instantiated.
     if (FD->isThisDeclarationADefinition() &&
         !FD->isDependentContext()) {
-      assert(RecVisitorMode == AM_Syntax || Mgr->shouldInlineCall() == false);
-      HandleCode(FD, RecVisitorMode);
+      assert(!(RecVisitorMode & AM_Path) || Mgr->shouldInlineCall() == false);
+      HandleCode(FD, getRecVisitorModeForNextRoot());
     }
     return true;
   }
 
   bool VisitObjCMethodDecl(ObjCMethodDecl *MD) {
     if (MD->isThisDeclarationADefinition()) {
-      assert(RecVisitorMode == AM_Syntax || Mgr->shouldInlineCall() == false);
-      HandleCode(MD, RecVisitorMode);
+      assert(!(RecVisitorMode & AM_Path) || Mgr->shouldInlineCall() == false);
+      HandleCode(MD, getRecVisitorModeForNextRoot());
     }
     return true;
   }
 
   bool VisitBlockDecl(BlockDecl *BD) {
     if (BD->hasBody()) {
-      assert(RecVisitorMode == AM_Syntax || Mgr->shouldInlineCall() == false);
+      assert(!(RecVisitorMode & AM_Path) || Mgr->shouldInlineCall() == false);
       // Since we skip function template definitions, we should skip blocks
       // declared in those functions as well.
       if (!BD->isDependentContext()) {
-        HandleCode(BD, RecVisitorMode);
+        HandleCode(BD, getRecVisitorModeForNextRoot());
       }
     }
     return true;
@@ -362,6 +364,22 @@ private:
 
   /// Check if we should skip (not analyze) the given function.
   AnalysisMode getModeForDecl(Decl *D, AnalysisMode Mode);
+
+  /// Whether the top-level function with the given ordinal number belongs to
+  /// the shard analyzed path-sensitively by this invocation.
+  bool isInAnalyzedShard(unsigned Ordinal) const {
+    return Opts->ShardCount <= 1 ||
+           Ordinal % Opts->ShardCount == Opts->ShardIndex;
+  }
+
+  /// The RecursiveASTVisitor mode to use for the next function definition,
+  /// without path-sensitive analysis if the function belongs to another shard.
+  AnalysisMode getRecVisitorModeForNextRoot() {
+    if ((RecVisitorMode & AM_Path) && !isInAnalyzedShard(NumRecVisitorRoots++))
+      return RecVisitorMode & ~AM_Path;
+    return RecVisitorMode;
+  }
+
   void runAnalysisOnTranslationUnit(ASTContext &C);
 
   /// Print \p S to stderr if \c Opts->AnalyzerDisplayProgress is set.
@@ -461,6 +479,7 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
   // often.
   SetOfConstDecls Visited;
   SetOfConstDecls VisitedAsTopLevel;
+  unsigned Ordinal = 0;
   llvm::ReversePostOrderTraversal<clang::CallGraph*> RPOT(&CG);
   for (llvm::ReversePostOrderTraversal<clang::CallGraph*>::rpo_iterator
          I = RPOT.begin(), E = RPOT.end(); I != E; ++I) {
@@ -473,6 +492,12 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
     if (!D)
       continue;
 
+    // Skip the functions analyzed by other shards. The call graph order is
+    // the same in every shard, so the shards are disjoint; a function
+    // inlined by a root of another shard may be analyzed as a root here.
+    if (!isInAnalyzedShard(Ordinal++))
+      continue;
+
     // Skip the functions which have been processed already or previously
     // inlined.
     if (shouldSkipFunction(D, Visited, VisitedAsTopLevel))
@@ -504,16 +529,22 @@ static bool fileContainsString(StringRef Substring, ASTContext &C) {
 void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
   BugReporter BR(*Mgr);
   TranslationUnitDecl *TU = C.getTranslationUnitDecl();
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->startTimer();
-  checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->stopTimer();
+  // The AST-based checks are not split into shards; only the first shard
+  // runs them, so that their warnings are not duplicated.
+  const bool RunSyntaxChecks = Opts->ShardIndex == 0;
+  if (RunSyntaxChecks) {
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->startTimer();
+    checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->stopTimer();
+  }
 
   // Run the AST-only checks using the order in which functions are defined.
   // If inlining is not turned on, use the simplest function order for path
   // sensitive analyzes as well.
-  RecVisitorMode = AM_Syntax;
+  RecVisitorMode = RunSyntaxChecks ? AM_Syntax : AM_None;
+  NumRecVisitorRoots = 0;
   if (!Mgr->shouldInlineCall())
     RecVisitorMode |= AM_Path;
   RecVisitorBR = &BR;
@@ -533,7 +564,8 @@ void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
     HandleDeclsCallGraph(LocalTUDeclsSize);
 
   // After all decls handled, run checkers on the entire TranslationUnit.
-  checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
+  if (RunSyntaxChecks)
+    checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
 
   BR.FlushReports();
   RecVisitorBR = nullptr;
@@ -8,9 +8,15 @@
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "clang/Lex/DependencyDirectivesSourceMinimizer.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/xxhash.h"
 
 using namespace clang;
 using namespace tooling;
@@ -41,6 +47,85 @@ DependencyScanningWorkerFilesystem::readFile(StringRef Filename) {
   return TentativeEntry(Stat, std::move(Buffer));
 }
 
+/// The on-disk cache entries start with this magic, followed by the format
+/// version. Bump the version whenever the minimizer output or the skipped range
+/// computation change.
+static constexpr llvm::StringLiteral OnDiskCacheMagic = "CSDM";
+static constexpr uint32_t OnDiskCacheVersion = 1;
+
+/// Computes the path of the on-disk cache entry for the given original file
+/// contents.
+static void getOnDiskCacheEntryPath(StringRef CacheDir, StringRef Original,
+                                    SmallVectorImpl<char> &Path) {
+  Path.assign(CacheDir.begin(), CacheDir.end());
+  llvm::sys::path::append(Path, llvm::utohexstr(llvm::xxHash64(Original)) +
+                                    "-" + llvm::utostr(Original.size()) +
+                                    ".min");
+}
+
+/// Loads minimized contents and skipped ranges from an on-disk cache entry
+/// laid out as: magic, version, number of ranges, (offset, length) pairs and
+/// finally the minimized contents, which are null terminated by the mapped
+/// buffer.
+///
+/// \returns true if the entry was found and is valid.
+static bool loadOnDiskCacheEntry(StringRef Path, CachedFileContents &Contents) {
+  using namespace llvm::support;
+
+  auto MaybeBuffer = llvm::MemoryBuffer::getFile(
+      Path, /*IsText=*/false, /*RequiresNullTerminator=*/true);
+  if (!MaybeBuffer)
+    return false;
+  StringRef Data = (*MaybeBuffer)->getBuffer();
+
+  const size_t HeaderSize = OnDiskCacheMagic.size() + 2 * sizeof(uint32_t);
+  if (Data.size() < HeaderSize || !Data.startswith(OnDiskCacheMagic))
+    return false;
+  const char *Ptr = Data.data() + OnDiskCacheMagic.size();
+  if (endian::readNext<uint32_t, little, unaligned>(Ptr) != OnDiskCacheVersion)
+    return false;
+  uint32_t NumRanges = endian::readNext<uint32_t, little, unaligned>(Ptr);
+  if (Data.size() - HeaderSize < uint64_t(NumRanges) * 2 * sizeof(uint32_t))
+    return false;
+
+  PreprocessorSkippedRangeMapping Mapping;
+  for (uint32_t I = 0; I != NumRanges; ++I) {
+    uint32_t Offset = endian::readNext<uint32_t, little, unaligned>(Ptr);
+    Mapping[Offset] = endian::readNext<uint32_t, little, unaligned>(Ptr);
+  }
+
+  StringRef Minimized = Data.drop_front(Ptr - Data.data());
+  Contents.PPSkippedRangeMapping = std::move(Mapping);
+  Contents.MinimizedStorage = llvm::MemoryBuffer::getMemBuffer(
+      Minimized, (*MaybeBuffer)->getBufferIdentifier(),
+      /*RequiresNullTerminator=*/true);
+  Contents.OnDiskStorage = std::move(*MaybeBuffer);
+  return true;
+}
+
+/// Writes an on-disk cache entry, see \c loadOnDiskCacheEntry for the layout.
+/// Failures are ignored, the cache only exists to speed up later scans.
+static void
+writeOnDiskCacheEntry(StringRef Path, StringRef Minimized,
+                      const PreprocessorSkippedRangeMapping &Mapping) {
+  using namespace llvm::support;
+
+  SmallString<256> Data(OnDiskCacheMagic);
+  llvm::raw_svector_ostream OS(Data);
+  endian::Writer Writer(OS, little);
+  Writer.write<uint32_t>(OnDiskCacheVersion);
+  Writer.write<uint32_t>(Mapping.size());
+  for (const auto &Range : Mapping) {
+    Writer.write<uint32_t>(Range.first);
+    Writer.write<uint32_t>(Range.second);
+  }
+  OS << Minimized;
+
+  SmallString<256> TempPathModel(Path);
+  TempPathModel += "-%%%%%%%%.tmp";
+  llvm::consumeError(llvm::writeFileAtomically(TempPathModel, Path, Data));
+}
+
 EntryRef DependencyScanningWorkerFilesystem::minimizeIfNecessary(
     const CachedFileSystemEntry &Entry, StringRef Filename, bool Disable) {
   if (Entry.isError() || Entry.isDirectory() || Disable ||
@@ -60,6 +145,18 @@ EntryRef DependencyScanningWorkerFilesystem::minimizeIfNecessary(
   if (Contents->MinimizedAccess.load())
     return EntryRef(/*Minimized=*/true, Filename, Entry);
 
+  // Reuse the result of an earlier scanner invocation if there is one.
+  SmallString<256> OnDiskCacheEntryPath;
+  if (!SharedCache.getOnDiskCachePath().empty()) {
+    getOnDiskCacheEntryPath(SharedCache.getOnDiskCachePath(),
+                            Contents->Original->getBuffer(),
+                            OnDiskCacheEntryPath);
+    if (loadOnDiskCacheEntry(OnDiskCacheEntryPath, *Contents)) {
+      Contents->MinimizedAccess.store(Contents->MinimizedStorage.get());
+      return EntryRef(/*Minimized=*/true, Filename, Entry);
+    }
+  }
+
   llvm::SmallString<1024> MinimizedFileContents;
   // Minimize the file down to directives that might affect the dependencies.
   SmallVector<minimize_source_to_dependency_directives::Token, 64> Tokens;
@@ -95,6 +192,10 @@ EntryRef DependencyScanningWorkerFilesystem::minimizeIfNecessary(
   }
   Contents->PPSkippedRangeMapping = std::move(Mapping);
 
+  if (!OnDiskCacheEntryPath.empty())
+    writeOnDiskCacheEntry(OnDiskCacheEntryPath, MinimizedFileContents,
+                          Contents->PPSkippedRangeMapping);
+
   Contents->MinimizedStorage = std::make_unique<llvm::SmallVectorMemoryBuffer>(
       std::move(MinimizedFileContents));
   // This function performed double-checked locking using `MinimizedAccess`.
@@ -131,6 +232,63 @@ DependencyScanningFilesystemSharedCache::getShardForUID(
   return CacheShards[Hash % NumShards];
 }
 
+/// Returns true if \p Entry cached for \p Filename may differ from what \p FS
+/// would report now.
+static bool isEntryOutOfDate(StringRef Filename,
+                             const CachedFileSystemEntry &Entry,
+                             llvm::vfs::FileSystem &FS) {
+  // Errors and directories are cheap to recompute, and whether they are still
+  // accurate depends on files appearing or disappearing anywhere below them.
+  if (Entry.isError() || Entry.isDirectory())
+    return true;
+  // Relative filenames were resolved against the working directory of some
+  // earlier compilation, which we don't know here.
+  if (!llvm::sys::path::is_absolute(Filename))
+    return true;
+
+  llvm::ErrorOr<llvm::vfs::Status> Stat = FS.status(Filename);
+  if (!Stat)
+    return true;
+  llvm::vfs::Status Cached = Entry.getStatus();
+  return Stat->getUniqueID() != Cached.getUniqueID() ||
+         Stat->getSize() != Cached.getSize() ||
+         Stat->getLastModificationTime() != Cached.getLastModificationTime();
+}
+
+unsigned DependencyScanningFilesystemSharedCache::invalidateChangedEntries(
+    llvm::vfs::FileSystem &FS) {
+  llvm::DenseSet<const CachedFileSystemEntry *> StaleEntries;
+  unsigned NumInvalidated = 0;
+  for (unsigned I = 0; I < NumShards; ++I) {
+    CacheShard &Shard = CacheShards[I];
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    for (auto It = Shard.EntriesByFilename.begin(),
+              End = Shard.EntriesByFilename.end();
+         It != End;) {
+      auto Current = It++;
+      if (!isEntryOutOfDate(Current->getKey(), *Current->getValue(), FS))
+        continue;
+      StaleEntries.insert(Current->getValue());
+      Shard.EntriesByFilename.erase(Current);
+      ++NumInvalidated;
+    }
+  }
+
+  // Entries are shared between filenames that resolve to the same unique ID.
+  // Forget the stale ones so that the next lookup reads the file again.
+  for (unsigned I = 0; I < NumShards; ++I) {
+    CacheShard &Shard = CacheShards[I];
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    for (auto It = Shard.EntriesByUID.begin(), End = Shard.EntriesByUID.end();
+         It != End;) {
+      auto Current = It++;
+      if (StaleEntries.contains(Current->second))
+        Shard.EntriesByUID.erase(Current);
+    }
+  }
+  return NumInvalidated;
+}
+
 const CachedFileSystemEntry *
 DependencyScanningFilesystemSharedCache::CacheShard::findEntryByFilename(
     StringRef Filename) const {
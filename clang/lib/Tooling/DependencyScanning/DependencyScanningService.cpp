@@ -8,6 +8,7 @@
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningService.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/VirtualFileSystem.h"
 
 using namespace clang;
 using namespace tooling;
@@ -24,3 +25,9 @@ DependencyScanningService::DependencyScanningService(
   llvm::InitializeAllAsmPrinters();
   llvm::InitializeAllAsmParsers();
 }
+
+void DependencyScanningService::invalidateChangedFiles() {
+  SharedCache.invalidateChangedEntries(
+      *llvm::vfs::createPhysicalFileSystem());
+  SharedHeaderLookups.clear();
+}
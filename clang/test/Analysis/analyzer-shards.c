@@ -0,0 +1,45 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-ALL
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode %s \
+// RUN:   -analyzer-config shard-count=2,shard-index=0 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-SHARD0
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode %s \
+// RUN:   -analyzer-config shard-count=2,shard-index=1 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-SHARD1
+
+// Without inlining the functions are assigned to shards in source order.
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode %s \
+// RUN:   -analyzer-config ipa=none,shard-count=2,shard-index=1 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-NOIPA1
+
+// RUN: not %clang_analyze_cc1 -analyzer-checker=core %s \
+// RUN:   -analyzer-config shard-count=0 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-COUNT
+// CHECK-COUNT: (frontend): invalid input for analyzer-config option
+// CHECK-COUNT-SAME: 'shard-count', that expects a positive value
+
+// RUN: not %clang_analyze_cc1 -analyzer-checker=core %s \
+// RUN:   -analyzer-config shard-count=2,shard-index=2 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-INDEX
+// CHECK-INDEX: (frontend): invalid input for analyzer-config option
+// CHECK-INDEX-SAME: 'shard-index', that expects a [0, shard-count) value
+
+// Each path-sensitive warning is reported by exactly one shard, and the
+// AST-based dead store warning only by the first one.
+// CHECK-ALL: 3 warnings generated.
+// CHECK-SHARD0: 2 warnings generated.
+// CHECK-SHARD1: 1 warning generated.
+// CHECK-NOIPA1: analyzer-shards.c:[[@LINE+12]]:10: warning: Dereference of null
+// CHECK-NOIPA1-NOT: warning:
+
+int first(void) {
+  int X;
+  X = 1;
+  int *P = 0;
+  return *P;
+}
+
+int second(void) {
+  int *P = 0;
+  return *P;
+}
@@ -0,0 +1,26 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.Stats -verify %s \
+// RUN:   -analyzer-config max-nodes=0,max-graph-memory=1
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.Stats -verify %s \
+// RUN:   -analyzer-config max-nodes=0,max-graph-memory=1 \
+// RUN:   -analyzer-config graph-trim-interval=0
+
+int foo(void);
+
+#define BRANCH(X) if (foo()) X++;
+#define BRANCH4(X) BRANCH(X) BRANCH(X) BRANCH(X) BRANCH(X)
+#define BRANCH16(X) BRANCH4(X) BRANCH4(X) BRANCH4(X) BRANCH4(X)
+
+// The number of paths grows exponentially; without a node limit only the
+// memory budget stops the analysis.
+int manyPaths(void) { // expected-warning-re{{manyPaths -> Total CFGBlocks: {{[0-9]+}} | Unreachable CFGBlocks: {{[0-9]+}} | Exhausted Block: no | Empty WorkList: no}}
+  int X = 0;
+  BRANCH16(X)
+  BRANCH16(X)
+  return X;
+}
+
+int fewPaths(void) { // expected-warning-re{{fewPaths -> Total CFGBlocks: {{[0-9]+}} | Unreachable CFGBlocks: 0 | Exhausted Block: no | Empty WorkList: yes}}
+  int X = 0;
+  BRANCH4(X)
+  return X;
+}
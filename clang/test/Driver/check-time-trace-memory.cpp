@@ -0,0 +1,24 @@
+// RUN: %clangxx -S -ftime-trace -ftime-trace-memory -ftime-trace-granularity=0 -o %T/check-time-trace-memory %s
+// RUN: cat %T/check-time-trace-memory.json \
+// RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
+// RUN:   | FileCheck %s
+
+// CHECK:      "traceEvents": [
+// CHECK:      "args":
+// CHECK-NEXT: "bytes": {{[0-9]+}}
+// CHECK:      "name": "Total InstantiateClass"
+// CHECK:      "args":
+// CHECK:      "bytes": {{[0-9]+}}
+// CHECK:      "detail": "Struct<int>"
+// CHECK:      "name": "Top memory InstantiateClass"
+
+template <typename T>
+struct Struct {
+  T Num;
+};
+
+int main() {
+  Struct<int> S;
+
+  return 0;
+}
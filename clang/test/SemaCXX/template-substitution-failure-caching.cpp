@@ -0,0 +1,17 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -fsyntax-only -verify -fno-template-substitution-failure-caching %s
+
+// A substitution failure that is reused from the cache is still explained in
+// the notes of every failed call.
+template <typename T>
+typename T::type f(T); // expected-note 2{{candidate template ignored: substitution failure [with T = int]: type 'int' cannot be used prior to '::' because it has no members}}
+
+struct HasType {
+  typedef int type;
+};
+
+void test() {
+  f(1); // expected-error {{no matching function for call to 'f'}}
+  f(2); // expected-error {{no matching function for call to 'f'}}
+  f(HasType());
+}
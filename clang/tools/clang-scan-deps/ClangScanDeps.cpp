@@ -22,6 +22,7 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
+#include <cstdio>
 #include <mutex>
 #include <thread>
 
@@ -199,6 +200,13 @@ llvm::cl::opt<bool> SkipExcludedPPRanges(
         "until reaching the end directive."),
     llvm::cl::init(true), llvm::cl::cat(DependencyScannerCategory));
 
+llvm::cl::opt<std::string> MinimizationCacheDir(
+    "minimization-cache-dir", llvm::cl::Optional,
+    llvm::cl::desc("Directory in which minimized sources are cached across "
+                   "invocations, used by the preprocess-minimized-sources "
+                   "mode"),
+    llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<std::string> ModuleName(
     "module-name", llvm::cl::Optional,
     llvm::cl::desc("the module of which the dependencies are to be computed"),
@@ -223,6 +231,16 @@ static llvm::cl::opt<ResourceDirRecipeKind> ResourceDirRecipe(
     llvm::cl::init(RDRK_ModifyCompilerPath),
     llvm::cl::cat(DependencyScannerCategory));
 
+llvm::cl::opt<bool> ServerMode(
+    "server", llvm::cl::Optional,
+    llvm::cl::desc("Keep running after the initial scan and rescan whenever a "
+                   "line is read from STDIN, reusing the cached contents of "
+                   "the files that did not change. A non-empty line names the "
+                   "compilation database to scan instead of the initial one. "
+                   "The output of each scan ends with a "
+                   "'# clang-scan-deps: scan done' (or 'failed') line."),
+    llvm::cl::init(false), llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<bool> Verbose("v", llvm::cl::Optional,
                             llvm::cl::desc("Use verbose output."),
                             llvm::cl::init(false),
@@ -443,30 +461,21 @@ static bool handleFullDependencyToolResult(
   return false;
 }
 
-int main(int argc, const char **argv) {
-  llvm::InitLLVM X(argc, argv);
-  llvm::cl::HideUnrelatedOptions(DependencyScannerCategory);
-  if (!llvm::cl::ParseCommandLineOptions(argc, argv))
-    return 1;
-
-  std::string ErrorMessage;
+/// Loads the compilation database at \p Path and rewrites its commands to run
+/// Clang in preprocessor only mode.
+static std::unique_ptr<tooling::CompilationDatabase>
+loadCompilations(StringRef Path, ResourceDirectoryCache &ResourceDirCache,
+                 std::string &ErrorMessage) {
   std::unique_ptr<tooling::JSONCompilationDatabase> Compilations =
       tooling::JSONCompilationDatabase::loadFromFile(
-          CompilationDB, ErrorMessage,
-          tooling::JSONCommandLineSyntax::AutoDetect);
-  if (!Compilations) {
-    llvm::errs() << "error: " << ErrorMessage << "\n";
-    return 1;
-  }
-
-  llvm::cl::PrintOptionValues();
+          Path, ErrorMessage, tooling::JSONCommandLineSyntax::AutoDetect);
+  if (!Compilations)
+    return nullptr;
 
   // The command options are rewritten to run Clang in preprocessor only mode.
   auto AdjustingCompilations =
       std::make_unique<tooling::ArgumentsAdjustingCompilations>(
           std::move(Compilations));
-  ResourceDirectoryCache ResourceDirCache;
-
   AdjustingCompilations->appendArgumentsAdjuster(
       [&ResourceDirCache](const tooling::CommandLineArguments &Args,
                           StringRef FileName) {
@@ -526,19 +535,25 @@ int main(int argc, const char **argv) {
         return AdjustedArgs;
       });
 
+  return AdjustingCompilations;
+}
+
+/// Scans all the compile commands of \p Compilations and prints the results.
+///
+/// \returns True on error.
+static bool scanCompilations(const tooling::CompilationDatabase &Compilations,
+                             DependencyScanningService &Service,
+                             llvm::ThreadPool &Pool) {
   SharedStream Errs(llvm::errs());
   // Print out the dependency results to STDOUT by default.
   SharedStream DependencyOS(llvm::outs());
 
-  DependencyScanningService Service(ScanMode, Format, ReuseFileManager,
-                                    SkipExcludedPPRanges, OptimizeArgs);
-  llvm::ThreadPool Pool(llvm::hardware_concurrency(NumThreads));
   std::vector<std::unique_ptr<DependencyScanningTool>> WorkerTools;
   for (unsigned I = 0; I < Pool.getThreadCount(); ++I)
     WorkerTools.push_back(std::make_unique<DependencyScanningTool>(Service));
 
   std::vector<tooling::CompileCommand> Inputs =
-      AdjustingCompilations->getAllCompileCommands();
+      Compilations.getAllCompileCommands();
 
   std::atomic<bool> HadErrors(false);
   FullDeps FD;
@@ -595,3 +610,81 @@ int main(int argc, const char **argv) {
 
   return HadErrors;
 }
+
+/// Reads a line from STDIN without the trailing newline.
+///
+/// \returns False on end of input.
+static bool readLineFromStdin(std::string &Line) {
+  Line.clear();
+  int C;
+  while ((C = std::getchar()) != EOF) {
+    if (C == '\n')
+      return true;
+    Line.push_back(C);
+  }
+  return !Line.empty();
+}
+
+/// Marks the end of the output of one scan in server mode, so that clients
+/// know when to hand the results on.
+static void printServerScanEnd(bool HadErrors) {
+  llvm::errs().flush();
+  llvm::outs() << "# clang-scan-deps: scan " << (HadErrors ? "failed" : "done")
+               << "\n";
+  llvm::outs().flush();
+}
+
+int main(int argc, const char **argv) {
+  llvm::InitLLVM X(argc, argv);
+  llvm::cl::HideUnrelatedOptions(DependencyScannerCategory);
+  if (!llvm::cl::ParseCommandLineOptions(argc, argv))
+    return 1;
+
+  ResourceDirectoryCache ResourceDirCache;
+  std::string ErrorMessage;
+  std::unique_ptr<tooling::CompilationDatabase> Compilations =
+      loadCompilations(CompilationDB, ResourceDirCache, ErrorMessage);
+  if (!Compilations) {
+    llvm::errs() << "error: " << ErrorMessage << "\n";
+    return 1;
+  }
+
+  llvm::cl::PrintOptionValues();
+
+  DependencyScanningService Service(ScanMode, Format, ReuseFileManager,
+                                    SkipExcludedPPRanges, OptimizeArgs);
+  if (!MinimizationCacheDir.empty()) {
+    if (std::error_code EC =
+            llvm::sys::fs::create_directories(MinimizationCacheDir)) {
+      llvm::errs() << "error: " << EC.message() << "\n";
+      return 1;
+    }
+    Service.getSharedCache().setOnDiskCachePath(MinimizationCacheDir);
+  }
+  llvm::ThreadPool Pool(llvm::hardware_concurrency(NumThreads));
+
+  if (!ServerMode)
+    return scanCompilations(*Compilations, Service, Pool);
+
+  // Keep the service and its caches alive between scans. Every line read from
+  // STDIN requests another scan of the compilation database named on that
+  // line, or of the initial one if the line is empty. Before rescanning, the
+  // cached entries of files that changed on disk are dropped, so that only
+  // those are read and minimized again.
+  printServerScanEnd(scanCompilations(*Compilations, Service, Pool));
+  std::string Line;
+  while (readLineFromStdin(Line)) {
+    StringRef Path = StringRef(Line).trim();
+    if (Path.empty())
+      Path = CompilationDB;
+    Compilations = loadCompilations(Path, ResourceDirCache, ErrorMessage);
+    if (!Compilations) {
+      llvm::errs() << "error: " << ErrorMessage << "\n";
+      printServerScanEnd(/*HadErrors=*/true);
+      continue;
+    }
+    Service.invalidateChangedFiles();
+    printServerScanEnd(scanCompilations(*Compilations, Service, Pool));
+  }
+  return 0;
+}
@@ -12,6 +12,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "clang/AST/ASTContext.h"
+#include "clang/Basic/FileManager.h"
 #include "clang/Basic/Stack.h"
 #include "clang/Basic/TargetOptions.h"
 #include "clang/CodeGen/ObjectFilePCHContainerOperations.h"
@@ -25,6 +27,8 @@
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Frontend/Utils.h"
 #include "clang/FrontendTool/Utils.h"
+#include "clang/Serialization/InMemoryModuleCache.h"
+#include "clang/Serialization/PCHContainerOperations.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/LinkAllPasses.h"
@@ -181,14 +185,51 @@ static int PrintSupportedCPUs(std::string TargetStr) {
   return 0;
 }
 
+namespace {
+/// Caches shared by the cc1 jobs that the driver runs in this process one
+/// after another, see -freuse-in-process-caches.
+struct InProcessCaches {
+  /// The module files (and PCHs) loaded or built by earlier jobs.
+  IntrusiveRefCntPtr<InMemoryModuleCache> ModuleCache;
+
+  /// The file manager of the earlier jobs, and the working directory and VFS
+  /// overlays it was created for.
+  IntrusiveRefCntPtr<FileManager> Files;
+  std::string WorkingDir;
+  std::vector<std::string> VFSOverlayFiles;
+};
+} // namespace
+
+static InProcessCaches &getInProcessCaches() {
+  // Intentionally leaked, like the rest of the compiler state at exit.
+  static InProcessCaches *Caches = new InProcessCaches;
+  return *Caches;
+}
+
+/// Makes \p Clang use the file manager of the previous in-process job, unless
+/// that one sees the file system differently.
+static void reuseInProcessFileManager(CompilerInstance &Clang) {
+  InProcessCaches &Caches = getInProcessCaches();
+  const std::string &WorkingDir = Clang.getFileSystemOpts().WorkingDir;
+  const std::vector<std::string> &VFSOverlayFiles =
+      Clang.getHeaderSearchOpts().VFSOverlayFiles;
+  if (Caches.Files && Caches.WorkingDir == WorkingDir &&
+      Caches.VFSOverlayFiles == VFSOverlayFiles) {
+    Clang.setFileManager(Caches.Files.get());
+    return;
+  }
+  Caches.Files = Clang.createFileManager();
+  Caches.WorkingDir = WorkingDir;
+  Caches.VFSOverlayFiles = VFSOverlayFiles;
+}
+
 int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
   ensureSufficientStack();
 
-  std::unique_ptr<CompilerInstance> Clang(new CompilerInstance());
   IntrusiveRefCntPtr<DiagnosticIDs> DiagID(new DiagnosticIDs());
 
   // Register the support for object-file-wrapped Clang modules.
-  auto PCHOps = Clang->getPCHContainerOperations();
+  auto PCHOps = std::make_shared<PCHContainerOperations>();
   PCHOps->registerWriter(std::make_unique<ObjectFilePCHContainerWriter>());
   PCHOps->registerReader(std::make_unique<ObjectFilePCHContainerReader>());
 
@@ -209,12 +250,32 @@ int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
     Diags.setSeverity(diag::remark_cc1_round_trip_generated,
                       diag::Severity::Remark, {});
 
-  bool Success = CompilerInvocation::CreateFromArgs(Clang->getInvocation(),
-                                                    Argv, Diags, Argv0);
+  auto Invocation = std::make_shared<CompilerInvocation>();
+  bool Success =
+      CompilerInvocation::CreateFromArgs(*Invocation, Argv, Diags, Argv0);
+
+  InMemoryModuleCache *SharedModuleCache = nullptr;
+  if (Invocation->getFrontendOpts().ReuseInProcessCaches) {
+    InProcessCaches &Caches = getInProcessCaches();
+    if (!Caches.ModuleCache)
+      Caches.ModuleCache = new InMemoryModuleCache;
+    SharedModuleCache = Caches.ModuleCache.get();
+  }
+  std::unique_ptr<CompilerInstance> Clang(
+      new CompilerInstance(std::move(PCHOps), SharedModuleCache));
+  Clang->setInvocation(std::move(Invocation));
 
   if (Clang->getFrontendOpts().TimeTrace) {
     llvm::timeTraceProfilerInitialize(
         Clang->getFrontendOpts().TimeTraceGranularity, Argv0);
+    if (Clang->getFrontendOpts().TimeTraceMemory) {
+      CompilerInstance *CI = Clang.get();
+      llvm::timeTraceProfilerSetMemoryCounter([CI]() -> uint64_t {
+        return CI->hasASTContext()
+                   ? CI->getASTContext().getAllocator().getBytesAllocated()
+                   : 0;
+      });
+    }
   }
   // --print-supported-cpus takes priority over the actual compilation.
   if (Clang->getFrontendOpts().PrintSupportedCPUs)
@@ -242,6 +303,9 @@ int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
     return 1;
   }
 
+  if (Clang->getFrontendOpts().ReuseInProcessCaches)
+    reuseInProcessFileManager(*Clang);
+
   // Execute the frontend actions.
   {
     llvm::TimeTraceScope TimeScope("ExecuteCompiler");
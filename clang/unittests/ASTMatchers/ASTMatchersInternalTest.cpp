@@ -111,6 +111,29 @@ TEST(MatchFinder, CheckProfiling) {
   EXPECT_EQ("MyID", Records.begin()->getKey());
 }
 
+TEST(MatchFinder, PerMatcherProfiling) {
+  MatchFinder::MatchFinderOptions Options;
+  llvm::StringMap<llvm::TimeRecord> Records;
+  Options.CheckProfiling.emplace(Records);
+  Options.CheckProfiling->PerMatcher = true;
+  MatchFinder Finder(std::move(Options));
+
+  struct NamedCallback : public MatchFinder::MatchCallback {
+    void run(const MatchFinder::MatchResult &Result) override {}
+    StringRef getID() const override { return "MyID"; }
+  } Callback;
+  Finder.addMatcher(varDecl(), &Callback);
+  Finder.addMatcher(functionDecl(), &Callback);
+  std::unique_ptr<FrontendActionFactory> Factory(
+      newFrontendActionFactory(&Finder));
+  ASSERT_TRUE(tooling::runToolOnCode(Factory->create(), "int x; void f();"));
+
+  EXPECT_EQ(3u, Records.size());
+  EXPECT_EQ(1u, Records.count("MyID"));
+  EXPECT_EQ(1u, Records.count("MyID#0"));
+  EXPECT_EQ(1u, Records.count("MyID#1"));
+}
+
 class VerifyStartOfTranslationUnit : public MatchFinder::MatchCallback {
 public:
   VerifyStartOfTranslationUnit() : Called(false) {}
@@ -192,6 +215,21 @@ TEST(DynTypedMatcherTest, ConstructWithTraversalKindOverridesNestedTK) {
               llvm::ValueIs(TK_IgnoreUnlessSpelledInSource));
 }
 
+TEST(DynTypedMatcherTest, CanMatchNodesOfKindLooksThroughAnyOf) {
+  auto M = DynTypedMatcher(stmt(anyOf(callExpr(), cxxConstructExpr())));
+  EXPECT_TRUE(M.canMatchNodesOfKind(ASTNodeKind::getFromNodeKind<CallExpr>()));
+  EXPECT_TRUE(
+      M.canMatchNodesOfKind(ASTNodeKind::getFromNodeKind<CXXMemberCallExpr>()));
+  EXPECT_FALSE(M.canMatchNodesOfKind(ASTNodeKind::getFromNodeKind<IfStmt>()));
+
+  // Nested traversal kinds may change which node is matched, so they cannot
+  // be filtered out.
+  M = DynTypedMatcher(
+      stmt(anyOf(traverse(TK_IgnoreUnlessSpelledInSource, callExpr()),
+                 cxxConstructExpr())));
+  EXPECT_TRUE(M.canMatchNodesOfKind(ASTNodeKind::getFromNodeKind<IfStmt>()));
+}
+
 TEST(IsInlineMatcher, IsInline) {
   EXPECT_TRUE(matches("void g(); inline void f();",
                       functionDecl(isInline(), hasName("f"))));
@@ -254,5 +254,58 @@ TEST_F(HeaderSearchTest, HeaderMapFrameworkLookup) {
   EXPECT_EQ(FI->Framework.str(), "Foo");
 }
 
+TEST_F(HeaderSearchTest, SharedLookupCache) {
+  SharedHeaderLookupCache SharedLookups;
+  Search.setSharedLookupCache(&SharedLookups);
+  addSearchDir("/a");
+  addSearchDir("/b");
+  VFS->addFile("/b/x.h", 0, llvm::MemoryBuffer::getMemBuffer(""),
+               /*User=*/None, /*Group=*/None,
+               llvm::sys::fs::file_type::regular_file);
+
+  auto Lookup = [](HeaderSearch &HS) {
+    return HS.LookupFile(
+        "x.h", SourceLocation(), /*isAngled=*/false, /*FromDir=*/nullptr,
+        /*CurDir=*/nullptr, /*Includers=*/{}, /*SearchPath=*/nullptr,
+        /*RelativePath=*/nullptr, /*RequestingModule=*/nullptr,
+        /*SuggestedModule=*/nullptr, /*IsMapped=*/nullptr,
+        /*IsFrameworkFound=*/nullptr);
+  };
+  auto FoundFile = Lookup(Search);
+  ASSERT_TRUE(FoundFile.hasValue());
+  EXPECT_EQ(FoundFile->getName(), "/b/x.h");
+
+  // A header search with the same search paths reuses the result, so it
+  // doesn't probe "/a" again.
+  VFS->addFile("/a/x.h", 0, llvm::MemoryBuffer::getMemBuffer(""),
+               /*User=*/None, /*Group=*/None,
+               llvm::sys::fs::file_type::regular_file);
+  FileManager OtherFileMgr(FileMgrOpts, VFS);
+  SourceManager OtherSourceMgr(Diags, OtherFileMgr);
+  HeaderSearch Other(std::make_shared<HeaderSearchOptions>(), OtherSourceMgr,
+                     Diags, LangOpts, Target.get());
+  Other.setSharedLookupCache(&SharedLookups);
+  for (StringRef Dir : {"/a", "/b"})
+    Other.AddSearchPath(
+        DirectoryLookup(*OtherFileMgr.getOptionalDirectoryRef(Dir),
+                        SrcMgr::C_User, /*isFramework=*/false),
+        /*isAngled=*/false);
+  FoundFile = Lookup(Other);
+  ASSERT_TRUE(FoundFile.hasValue());
+  EXPECT_EQ(FoundFile->getName(), "/b/x.h");
+
+  // Without the shared cache the new file is found first.
+  HeaderSearch Unshared(std::make_shared<HeaderSearchOptions>(),
+                        OtherSourceMgr, Diags, LangOpts, Target.get());
+  for (StringRef Dir : {"/a", "/b"})
+    Unshared.AddSearchPath(
+        DirectoryLookup(*OtherFileMgr.getOptionalDirectoryRef(Dir),
+                        SrcMgr::C_User, /*isFramework=*/false),
+        /*isAngled=*/false);
+  FoundFile = Lookup(Unshared);
+  ASSERT_TRUE(FoundFile.hasValue());
+  EXPECT_EQ(FoundFile->getName(), "/a/x.h");
+}
+
 } // namespace
 } // namespace clang
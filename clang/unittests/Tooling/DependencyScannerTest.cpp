@@ -251,6 +251,86 @@ TEST(DependencyScanningFilesystem, IgnoredFilesAreCachedSeparately2) {
   EXPECT_EQ(StatusMinimized1->getName(), StringRef("/mod.h"));
 }
 
+TEST(DependencyScanningFilesystem, OnDiskCacheIsReused) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("scan-deps-cache", CacheDir));
+
+  auto Scan = [&]() {
+    auto VFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+    VFS->addFile("/mod.h", 0,
+                 llvm::MemoryBuffer::getMemBuffer("#include <foo.h>\n"
+                                                  "// hi there!\n"));
+
+    DependencyScanningFilesystemSharedCache SharedCache;
+    SharedCache.setOnDiskCachePath(CacheDir);
+    auto Mappings =
+        std::make_unique<ExcludedPreprocessorDirectiveSkipMapping>();
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, VFS, Mappings.get());
+    DepFS.enableMinimizationOfAllFiles();
+    auto File = DepFS.openFileForRead("/mod.h");
+    EXPECT_TRUE(File);
+    auto Buffer = (*File)->getBuffer("/mod.h");
+    EXPECT_TRUE(Buffer);
+    return (*Buffer)->getBuffer().str();
+  };
+
+  auto CountEntries = [&]() {
+    std::error_code EC;
+    unsigned Count = 0;
+    for (llvm::sys::fs::directory_iterator I(CacheDir, EC), E; I != E && !EC;
+         I.increment(EC))
+      ++Count;
+    return Count;
+  };
+
+  std::string Minimized = Scan();
+  EXPECT_EQ(Minimized, "#include <foo.h>\n");
+  EXPECT_EQ(CountEntries(), 1u);
+
+  // A fresh shared cache picks up the entry written by the first scan.
+  EXPECT_EQ(Scan(), Minimized);
+  EXPECT_EQ(CountEntries(), 1u);
+
+  ASSERT_FALSE(llvm::sys::fs::remove_directories(CacheDir));
+}
+
+TEST(DependencyScanningFilesystem, InvalidateChangedEntries) {
+  auto VFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  VFS->addFile("/changed.h", 0,
+               llvm::MemoryBuffer::getMemBuffer("#include <old.h>\n"));
+  VFS->addFile("/unchanged.h", 0,
+               llvm::MemoryBuffer::getMemBuffer("#include <foo.h>\n"));
+
+  DependencyScanningFilesystemSharedCache SharedCache;
+  auto Read = [&](llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS,
+                  StringRef Path) {
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, FS, nullptr);
+    auto File = DepFS.openFileForRead(Path);
+    EXPECT_TRUE(File);
+    auto Buffer = (*File)->getBuffer(Path);
+    EXPECT_TRUE(Buffer);
+    return (*Buffer)->getBuffer().str();
+  };
+  auto IsCached = [&](StringRef Path) {
+    return SharedCache.getShardForFilename(Path).findEntryByFilename(Path) !=
+           nullptr;
+  };
+  EXPECT_EQ(Read(VFS, "/changed.h"), "#include <old.h>\n");
+  EXPECT_EQ(Read(VFS, "/unchanged.h"), "#include <foo.h>\n");
+
+  auto NewVFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  NewVFS->addFile("/changed.h", 1,
+                  llvm::MemoryBuffer::getMemBuffer("#include <new.h>\n"));
+  NewVFS->addFile("/unchanged.h", 0,
+                  llvm::MemoryBuffer::getMemBuffer("#include <foo.h>\n"));
+  EXPECT_EQ(SharedCache.invalidateChangedEntries(*NewVFS), 1u);
+  EXPECT_FALSE(IsCached("/changed.h"));
+  EXPECT_TRUE(IsCached("/unchanged.h"));
+  EXPECT_EQ(Read(NewVFS, "/changed.h"), "#include <new.h>\n");
+  EXPECT_EQ(Read(NewVFS, "/unchanged.h"), "#include <foo.h>\n");
+}
+
 } // end namespace dependencies
 } // end namespace tooling
 } // end namespace clang
@@ -31,6 +31,12 @@
 #include "sanitizer_common/sanitizer_quarantine.h"
 #include "sanitizer_common/sanitizer_stackdepot.h"
 
+#ifdef GWP_ASAN_HOOKS
+#include "gwp_asan/guarded_pool_allocator.h"
+#include "gwp_asan/optional/backtrace.h"
+#include "gwp_asan/optional/segv_handler.h"
+#endif  // GWP_ASAN_HOOKS
+
 namespace __asan {
 
 // Valid redzone sizes are 16, 32, 64, ... 2048, so we encode them in 3 bits.
@@ -305,6 +311,14 @@ struct Allocator {
 
   uptr max_user_defined_malloc_size;
 
+#ifdef GWP_ASAN_HOOKS
+  // Sampled allocations are served from the guarded pool, which catches
+  // errors with guard pages rather than with shadow memory. Its memory is
+  // never poisoned, so instrumented accesses to it cost as little as accesses
+  // to any other addressable memory.
+  gwp_asan::GuardedPoolAllocator guarded_alloc;
+#endif  // GWP_ASAN_HOOKS
+
   // ------------------- Options --------------------------
   atomic_uint16_t min_redzone;
   atomic_uint16_t max_redzone;
@@ -341,6 +355,35 @@ struct Allocator {
                                        ? common_flags()->max_allocation_size_mb
                                              << 20
                                        : kMaxAllowedMallocSize;
+    InitGwpAsan();
+  }
+
+  void InitGwpAsan() {
+#ifdef GWP_ASAN_HOOKS
+    const Flags &fl = *flags();
+    gwp_asan::options::Options opt;
+    opt.Enabled = fl.gwp_asan;
+    opt.MaxSimultaneousAllocations = fl.gwp_asan_max_simultaneous_allocations;
+    opt.SampleRate = fl.gwp_asan_sample_rate;
+    opt.InstallSignalHandlers = common_flags()->handle_segv != kHandleSignalNo;
+    opt.Backtrace = gwp_asan::backtrace::getBacktraceFunction();
+    guarded_alloc.init(opt);
+    // The handler reports the errors in the guarded pool, and forwards any
+    // other signal to the ASan deadly signal handler installed before it.
+    if (opt.Enabled && opt.InstallSignalHandlers)
+      gwp_asan::segv_handler::installSignalHandlers(
+          &guarded_alloc, Printf,
+          gwp_asan::backtrace::getPrintBacktraceFunction(),
+          gwp_asan::backtrace::getSegvBacktraceFunction());
+#endif  // GWP_ASAN_HOOKS
+  }
+
+  bool IsGuarded(const void *ptr) const {
+#ifdef GWP_ASAN_HOOKS
+    return guarded_alloc.pointerIsMine(ptr);
+#else
+    return false;
+#endif  // GWP_ASAN_HOOKS
   }
 
   void RePoisonChunk(uptr chunk) {
@@ -481,6 +524,20 @@ struct Allocator {
     }
     Flags &fl = *flags();
     CHECK(stack);
+#ifdef GWP_ASAN_HOOKS
+    if (UNLIKELY(guarded_alloc.shouldSample())) {
+      if (void *res = guarded_alloc.allocate(size, alignment)) {
+        if (can_fill && fl.max_malloc_fill_size)
+          REAL(memset)(res, fl.malloc_fill_byte,
+                       Min(size, (uptr)fl.max_malloc_fill_size));
+        AsanStats &thread_stats = GetCurrentThreadStats();
+        thread_stats.mallocs++;
+        thread_stats.malloced += size;
+        ASAN_MALLOC_HOOK(res, size);
+        return res;
+      }
+    }
+#endif  // GWP_ASAN_HOOKS
     const uptr min_alignment = ASAN_SHADOW_GRANULARITY;
     const uptr user_requested_alignment_log =
         ComputeUserRequestedAlignmentLog(alignment);
@@ -666,6 +723,18 @@ struct Allocator {
     uptr p = reinterpret_cast<uptr>(ptr);
     if (p == 0) return;
 
+#ifdef GWP_ASAN_HOOKS
+    // Invalid and double frees of guarded allocations are reported by
+    // GWP-ASan itself.
+    if (UNLIKELY(guarded_alloc.pointerIsMine(ptr))) {
+      ASAN_FREE_HOOK(ptr);
+      AsanStats &thread_stats = GetCurrentThreadStats();
+      thread_stats.frees++;
+      guarded_alloc.deallocate(ptr);
+      return;
+    }
+#endif  // GWP_ASAN_HOOKS
+
     uptr chunk_beg = p - kChunkHeaderSize;
     AsanChunk *m = reinterpret_cast<AsanChunk *>(chunk_beg);
 
@@ -712,6 +781,18 @@ struct Allocator {
     thread_stats.reallocs++;
     thread_stats.realloced += new_size;
 
+#ifdef GWP_ASAN_HOOKS
+    if (UNLIKELY(guarded_alloc.pointerIsMine(old_ptr))) {
+      uptr old_size = GuardedAllocationSize(p);
+      void *new_ptr = Allocate(new_size, 8, stack, FROM_MALLOC, true);
+      if (new_ptr) {
+        REAL(memcpy)(new_ptr, old_ptr, Min(new_size, old_size));
+        Deallocate(old_ptr, 0, 0, stack, FROM_MALLOC);
+      }
+      return new_ptr;
+    }
+#endif  // GWP_ASAN_HOOKS
+
     void *new_ptr = Allocate(new_size, 8, stack, FROM_MALLOC, true);
     if (new_ptr) {
       u8 chunk_state = atomic_load(&m->chunk_state, memory_order_acquire);
@@ -735,8 +816,8 @@ struct Allocator {
     }
     void *ptr = Allocate(nmemb * size, 8, stack, FROM_MALLOC, false);
     // If the memory comes from the secondary allocator no need to clear it
-    // as it comes directly from mmap.
-    if (ptr && allocator.FromPrimary(ptr))
+    // as it comes directly from mmap. Guarded allocations may reuse a slot.
+    if (ptr && (allocator.FromPrimary(ptr) || IsGuarded(ptr)))
       REAL(memset)(ptr, 0, nmemb * size);
     return ptr;
   }
@@ -789,7 +870,23 @@ struct Allocator {
     return GetAsanChunk(alloc_beg);
   }
 
+#ifdef GWP_ASAN_HOOKS
+  // Returns 0 unless p is the beginning of a live guarded allocation.
+  uptr GuardedAllocationSize(uptr p) {
+    const gwp_asan::AllocationMetadata *meta =
+        &guarded_alloc.getMetadataRegion()
+             [guarded_alloc.getAllocatorState()->getNearestSlot(p)];
+    if (meta->Addr != p || meta->IsDeallocated)
+      return 0;
+    return meta->RequestedSize;
+  }
+#endif  // GWP_ASAN_HOOKS
+
   uptr AllocationSize(uptr p) {
+#ifdef GWP_ASAN_HOOKS
+    if (UNLIKELY(guarded_alloc.pointerIsMine(reinterpret_cast<void *>(p))))
+      return GuardedAllocationSize(p);
+#endif  // GWP_ASAN_HOOKS
     AsanChunk *m = GetAsanChunkByAddr(p);
     if (!m) return 0;
     if (atomic_load(&m->chunk_state, memory_order_acquire) != CHUNK_ALLOCATED)
@@ -124,6 +124,28 @@ void InitializeFlags() {
   ubsan_parser.ParseStringFromEnv("UBSAN_OPTIONS");
 #endif
 
+  // Production mode trades the checks which have a runtime cost (beyond the
+  // instrumentation itself) for sampled allocation guarding.
+  if (f->production_mode) {
+    f->quarantine_size_mb = 0;
+    f->thread_local_quarantine_size_kb = 0;
+    f->poison_heap = false;
+    f->max_malloc_fill_size = 0;
+    f->max_free_fill_size = 0;
+    f->report_globals = 0;
+    f->check_initialization_order = false;
+    f->strict_init_order = false;
+    f->detect_container_overflow = false;
+    f->detect_stack_use_after_return = false;
+    f->gwp_asan = true;
+    CommonFlags cf;
+    cf.CopyFrom(*common_flags());
+    cf.detect_leaks = false;
+    // GWP-ASan records its own stack traces for the sampled allocations.
+    cf.malloc_context_size = 1;
+    OverrideCommonFlags(cf);
+  }
+
   InitializeCommonFlags();
 
   // TODO(eugenis): dump all flags at verbosity>=2?
@@ -185,6 +207,20 @@ void InitializeFlags() {
            "quarantine_size_mb is set to 0\n", SanitizerToolName);
     Die();
   }
+  // LSan doesn't scan the allocations in the guarded pool, so pointers only
+  // stored there would be reported as leaks.
+  if (f->gwp_asan && common_flags()->detect_leaks) {
+    Report("%s: gwp_asan can be set to 1 only when detect_leaks is set to 0\n",
+           SanitizerToolName);
+    Die();
+  }
+  if (f->gwp_asan_sample_rate <= 0 ||
+      f->gwp_asan_max_simultaneous_allocations <= 0) {
+    Report("%s: gwp_asan_sample_rate and "
+           "gwp_asan_max_simultaneous_allocations must be positive\n",
+           SanitizerToolName);
+    Die();
+  }
   if (!f->replace_str && common_flags()->intercept_strlen) {
     Report("WARNING: strlen interceptor is enabled even though replace_str=0. "
            "Use intercept_strlen=0 to disable it.");
@@ -101,6 +101,14 @@
 // Include internal utility function declarations.
 #include "int_util.h"
 
+// Whether the target divides 32 bit integers in hardware, in which case 64 bit
+// divisions are faster done with a few 32 bit divisions than bit by bit.
+#if defined(__i386__) ||                                                       \
+    (defined(__arm__) && defined(__ARM_FEATURE_IDIV)) ||                       \
+    (defined(__riscv) && __riscv_xlen == 32 && defined(__riscv_div))
+#define CRT_HAS_HW_DIV32
+#endif
+
 COMPILER_RT_ABI int __paritysi2(si_int a);
 COMPILER_RT_ABI int __paritydi2(di_int a);
 
@@ -19,5 +19,9 @@ typedef di_int fixint_t;
 // Returns: a / b
 
 COMPILER_RT_ABI du_int __udivdi3(du_int a, du_int b) {
+#if defined(CRT_HAS_HW_DIV32)
+  return __udivmoddi4(a, b, 0);
+#else
   return __udivXi3(a, b);
+#endif
 }
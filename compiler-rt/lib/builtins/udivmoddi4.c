@@ -12,6 +12,149 @@
 
 #include "int_lib.h"
 
+#if defined(CRT_HAS_HW_DIV32)
+
+// Returns the 64 bit division result by 32 bit. Result must fit in 32 bits.
+// Remainder stored in r.
+// Same algorithm as udiv128by64to64default in udivmodti4.c, with 16 bit
+// digits. For a correctness proof see the reference for this algorithm in
+// Knuth, Volume 2, section 4.3.1, Algorithm D.
+static inline su_int udiv64by32to32(su_int u1, su_int u0, su_int v,
+                                    su_int *r) {
+#if defined(__i386__)
+  su_int result;
+  __asm__("divl %[v]"
+          : "=a"(result), "=d"(*r)
+          : [ v ] "r"(v), "a"(u0), "d"(u1));
+  return result;
+#else
+  const unsigned n_uword_bits = sizeof(su_int) * CHAR_BIT;
+  const su_int b = (1U << (n_uword_bits / 2)); // Number base (16 bits)
+  su_int un1, un0;                             // Norm. dividend LSD's
+  su_int vn1, vn0;                             // Norm. divisor digits
+  su_int q1, q0;                               // Quotient digits
+  su_int un32, un21, un10;                     // Dividend digit pairs
+  su_int rhat;                                 // A remainder
+  si_int s;                                    // Shift amount for normalization
+
+  s = clzsi(v);
+  if (s > 0) {
+    // Normalize the divisor.
+    v = v << s;
+    un32 = (u1 << s) | (u0 >> (n_uword_bits - s));
+    un10 = u0 << s; // Shift dividend left
+  } else {
+    // Avoid undefined behavior of (u0 >> 32).
+    un32 = u1;
+    un10 = u0;
+  }
+
+  // Break divisor up into two 16-bit digits.
+  vn1 = v >> (n_uword_bits / 2);
+  vn0 = v & 0xFFFF;
+
+  // Break right half of dividend into two digits.
+  un1 = un10 >> (n_uword_bits / 2);
+  un0 = un10 & 0xFFFF;
+
+  // Compute the first quotient digit, q1.
+  q1 = un32 / vn1;
+  rhat = un32 - q1 * vn1;
+
+  // q1 has at most error 2. No more than 2 iterations.
+  while (q1 >= b || q1 * vn0 > b * rhat + un1) {
+    q1 = q1 - 1;
+    rhat = rhat + vn1;
+    if (rhat >= b)
+      break;
+  }
+
+  un21 = un32 * b + un1 - q1 * v;
+
+  // Compute the second quotient digit.
+  q0 = un21 / vn1;
+  rhat = un21 - q0 * vn1;
+
+  // q0 has at most error 2. No more than 2 iterations.
+  while (q0 >= b || q0 * vn0 > b * rhat + un0) {
+    q0 = q0 - 1;
+    rhat = rhat + vn1;
+    if (rhat >= b)
+      break;
+  }
+
+  *r = (un21 * b + un0 - q0 * v) >> s;
+  return q1 * b + q0;
+#endif
+}
+
+// Effects: if rem != 0, *rem = a % b
+// Returns: a / b
+
+COMPILER_RT_ABI du_int __udivmoddi4(du_int a, du_int b, du_int *rem) {
+  udwords dividend;
+  dividend.all = a;
+  udwords divisor;
+  divisor.all = b;
+  udwords quotient;
+  udwords remainder;
+  if (divisor.all > dividend.all) {
+    if (rem)
+      *rem = dividend.all;
+    return 0;
+  }
+  // When the divisor fits in 32 bits, we can use an optimized path.
+  if (divisor.s.high == 0) {
+    remainder.s.high = 0;
+    if (dividend.s.high == 0) {
+      if (rem)
+        *rem = dividend.s.low % divisor.s.low;
+      return dividend.s.low / divisor.s.low;
+    }
+    if (dividend.s.high < divisor.s.low) {
+      // The result fits in 32 bits.
+      quotient.s.low = udiv64by32to32(dividend.s.high, dividend.s.low,
+                                      divisor.s.low, &remainder.s.low);
+      quotient.s.high = 0;
+    } else {
+      // First, divide with the high part to get the remainder in
+      // dividend.s.high. After that dividend.s.high < divisor.s.low.
+      quotient.s.high = dividend.s.high / divisor.s.low;
+      dividend.s.high = dividend.s.high % divisor.s.low;
+      quotient.s.low = udiv64by32to32(dividend.s.high, dividend.s.low,
+                                      divisor.s.low, &remainder.s.low);
+    }
+    if (rem)
+      *rem = remainder.all;
+    return quotient.all;
+  }
+  // The divisor has more than 32 bits, so the result fits in 32 bits. Estimate
+  // it by dividing by the top 32 bits of the normalized divisor, which is at
+  // most one too large once decremented (Hacker's Delight, section 9-5).
+  // 0 <= shift <= 31.
+  const si_int shift = clzsi(divisor.s.high);
+  const su_int vn = (su_int)((divisor.all << shift) >> 32);
+  // Halve the dividend so that the 64 by 32 bit division doesn't overflow.
+  udwords un;
+  un.all = dividend.all >> 1;
+  su_int unused;
+  du_int q = udiv64by32to32(un.s.high, un.s.low, vn, &unused);
+  // Undo the normalization and the halving.
+  q = (q << shift) >> 31;
+  if (q != 0)
+    q--;
+  remainder.all = dividend.all - q * divisor.all;
+  if (remainder.all >= divisor.all) {
+    q++;
+    remainder.all -= divisor.all;
+  }
+  if (rem)
+    *rem = remainder.all;
+  return q;
+}
+
+#else // !defined(CRT_HAS_HW_DIV32)
+
 // Effects: if rem != 0, *rem = a % b
 // Returns: a / b
 
@@ -198,3 +341,5 @@ COMPILER_RT_ABI du_int __udivmoddi4(du_int a, du_int b, du_int *rem) {
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(pop)
 #endif
+
+#endif // defined(CRT_HAS_HW_DIV32)
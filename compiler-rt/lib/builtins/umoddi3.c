@@ -19,5 +19,11 @@ typedef di_int fixint_t;
 // Returns: a % b
 
 COMPILER_RT_ABI du_int __umoddi3(du_int a, du_int b) {
+#if defined(CRT_HAS_HW_DIV32)
+  du_int r;
+  __udivmoddi4(a, b, &r);
+  return r;
+#else
   return __umodXi3(a, b);
+#endif
 }
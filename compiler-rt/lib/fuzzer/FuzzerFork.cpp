@@ -29,6 +29,15 @@
 
 namespace fuzzer {
 
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+              "the shared feature set must be usable across processes");
+
+bool SharedFeatureSet::Open(const std::string &Path) {
+  Words = static_cast<std::atomic<uint64_t> *>(
+      MapSharedFile(Path, kFeatureSetSize / 8));
+  return Words != nullptr;
+}
+
 struct Stats {
   size_t number_of_executed_units = 0;
   size_t peak_rss_mb = 0;
@@ -93,6 +102,7 @@ struct GlobalEnv {
   std::string DFTDir;
   std::string DataFlowBinary;
   std::set<uint32_t> Features, Cov;
+  SharedFeatureSet SharedFeatures;
   std::set<std::string> FilesWithDFT;
   std::vector<std::string> Files;
   std::vector<std::size_t> FilesSizes;
@@ -110,6 +120,9 @@ struct GlobalEnv {
   size_t NumRuns = 0;
 
   std::string StopFile() { return DirPlusFile(TempDir, "STOP"); }
+  std::string SharedFeaturesFile() {
+    return DirPlusFile(TempDir, "features.bitmap");
+  }
 
   size_t secondsSinceProcessStartUp() const {
     return std::chrono::duration_cast<std::chrono::seconds>(
@@ -129,6 +142,8 @@ struct GlobalEnv {
     Cmd.addFlag("print_funcs", "0");  // no need to spend time symbolizing.
     Cmd.addFlag("max_total_time", std::to_string(std::min((size_t)300, JobId)));
     Cmd.addFlag("stop_file", StopFile());
+    if (SharedFeatures.IsOpen())
+      Cmd.addFlag("shared_features", SharedFeaturesFile());
     if (!DataFlowBinary.empty()) {
       Cmd.addFlag("data_flow_trace", DFTDir);
       if (!Cmd.hasFlag("focus_function"))
@@ -251,6 +266,7 @@ struct GlobalEnv {
       }
     }
     Features.insert(NewFeatures.begin(), NewFeatures.end());
+    SharedFeatures.Add(NewFeatures);
     Cov.insert(NewCov.begin(), NewCov.end());
     for (auto Idx : NewCov)
       if (auto *TE = TPC.PCTableEntryByIdx(Idx))
@@ -358,6 +374,12 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
       Env.FilesSizes.push_back(FileSize(path));
   }
 
+  if (Env.SharedFeatures.Open(Env.SharedFeaturesFile()))
+    Env.SharedFeatures.Add(Env.Features);
+  else
+    Printf("INFO: -fork=%d: failed to map the shared feature set, the jobs "
+           "will report all their new inputs\n", NumJobs);
+
   Printf("INFO: -fork=%d: %zd seed inputs, starting to fuzz in %s\n", NumJobs,
          Env.Files.size(), Env.TempDir.c_str());
 
@@ -13,9 +13,47 @@
 #include "FuzzerOptions.h"
 #include "FuzzerRandom.h"
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 namespace fuzzer {
+
+// The features found by all the jobs of -fork mode, in a bit set shared
+// through a memory mapped file. The jobs only write out the inputs with
+// features that no job found before, since the parent would drop the others
+// when merging anyway. The jobs update the set without locking.
+class SharedFeatureSet {
+public:
+  // Same as InputCorpus::kFeatureSetSize.
+  static const uint32_t kFeatureSetSize = 1 << 21;
+
+  bool Open(const std::string &Path);
+  bool IsOpen() const { return Words != nullptr; }
+
+  // Adds Features to the set, and returns whether any of them was not in it
+  // already. Returns true if the set is not open.
+  template <class Container> bool Add(const Container &Features) {
+    if (!Words)
+      return true;
+    bool HasNewFeatures = false;
+    for (uint32_t Feature : Features) {
+      Feature %= kFeatureSetSize;
+      auto &Word = Words[Feature / 64];
+      const uint64_t Bit = 1ULL << (Feature % 64);
+      // Most features are known already: avoid writing to the shared lines.
+      if (Word.load(std::memory_order_relaxed) & Bit)
+        continue;
+      if (!(Word.fetch_or(Bit, std::memory_order_relaxed) & Bit))
+        HasNewFeatures = true;
+    }
+    return HasNewFeatures;
+  }
+
+private:
+  std::atomic<uint64_t> *Words = nullptr;
+};
+
 void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
                   const std::vector<std::string> &Args,
                   const std::vector<std::string> &CorpusDirs, int NumJobs);
@@ -14,6 +14,7 @@
 #include "FuzzerDataFlowTrace.h"
 #include "FuzzerDefs.h"
 #include "FuzzerExtFunctions.h"
+#include "FuzzerFork.h"
 #include "FuzzerInterface.h"
 #include "FuzzerOptions.h"
 #include "FuzzerSHA1.h"
@@ -144,6 +145,11 @@ private:
 
   std::vector<uint32_t> UniqFeatureSetTmp;
 
+  // In -fork mode, the features found by all the jobs, and whether the last
+  // unit added to the corpus had none that other jobs didn't find before.
+  SharedFeatureSet SharedFeatures;
+  bool UnitIsKnownToAllJobs = false;
+
   // Need to know our own thread.
   static thread_local bool IsMyThread;
 };
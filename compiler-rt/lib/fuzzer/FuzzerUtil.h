@@ -84,6 +84,11 @@ inline std::pair<std::string, std::string> SplitBefore(std::string X,
 
 void DiscardOutput(int Fd);
 
+// Maps the file at Path, created or extended to Size bytes if needed, so that
+// the processes mapping it share its contents. Returns nullptr on failure, or
+// if the platform doesn't support it.
+void *MapSharedFile(const std::string &Path, size_t Size);
+
 std::string DisassembleCmd(const std::string &FileName);
 
 std::string SearchRegexCmd(const std::string &Regex);
@@ -539,6 +539,9 @@ const void *SearchMemory(const void *Data, size_t DataLen, const void *Patt,
   return memmem(Data, DataLen, Patt, PattLen);
 }
 
+// Fork mode is not supported on Fuchsia.
+void *MapSharedFile(const std::string &Path, size_t Size) { return nullptr; }
+
 // In fuchsia, accessing /dev/null is not supported. There's nothing
 // similar to a file that discards everything that is written to it.
 // The way of doing something similar in fuchsia is by using
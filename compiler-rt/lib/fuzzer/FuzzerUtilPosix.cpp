@@ -16,11 +16,13 @@
 #include <chrono>
 #include <cstring>
 #include <errno.h>
+#include <fcntl.h>
 #include <iomanip>
 #include <signal.h>
 #include <stdio.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/types.h>
@@ -183,6 +185,21 @@ std::string SearchRegexCmd(const std::string &Regex) {
   return "grep '" + Regex + "'";
 }
 
+void *MapSharedFile(const std::string &Path, size_t Size) {
+  int Fd = open(Path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (Fd < 0)
+    return nullptr;
+  struct stat St;
+  if (fstat(Fd, &St) != 0 ||
+      ((size_t)St.st_size < Size && ftruncate(Fd, Size) != 0)) {
+    close(Fd);
+    return nullptr;
+  }
+  void *Ptr = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+  close(Fd);
+  return Ptr == MAP_FAILED ? nullptr : Ptr;
+}
+
 }  // namespace fuzzer
 
 #endif // LIBFUZZER_POSIX
@@ -216,6 +216,25 @@ std::string SearchRegexCmd(const std::string &Regex) {
   return "findstr /r \"" + Regex + "\"";
 }
 
+void *MapSharedFile(const std::string &Path, size_t Size) {
+  HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (File == INVALID_HANDLE_VALUE)
+    return nullptr;
+  HANDLE Mapping =
+      CreateFileMappingA(File, NULL, PAGE_READWRITE,
+                         static_cast<DWORD>((uint64_t)Size >> 32),
+                         static_cast<DWORD>(Size), NULL);
+  CloseHandle(File);
+  if (!Mapping)
+    return nullptr;
+  // The view keeps the mapping alive.
+  void *Ptr = MapViewOfFile(Mapping, FILE_MAP_ALL_ACCESS, 0, 0, Size);
+  CloseHandle(Mapping);
+  return Ptr;
+}
+
 void DiscardOutput(int Fd) {
   FILE* Temp = fopen("nul", "w");
   if (!Temp)
@@ -1201,6 +1201,28 @@ TEST(Fuzzer, ForEachNonZeroByte) {
   EXPECT_EQ(Res, Expected);
 }
 
+TEST(Fuzzer, SharedFeatureSet) {
+  SharedFeatureSet Closed;
+  EXPECT_FALSE(Closed.IsOpen());
+  EXPECT_TRUE(Closed.Add(std::vector<uint32_t>{1}));
+
+  std::string Path = TempPath("SharedFeatureSet", ".bitmap");
+  RemoveFile(Path);
+  // Two mappings of the same file, as in two jobs of a -fork run.
+  SharedFeatureSet Job1, Job2;
+  ASSERT_TRUE(Job1.Open(Path));
+  ASSERT_TRUE(Job2.Open(Path));
+  EXPECT_TRUE(Job1.Add(std::vector<uint32_t>{1, 64, 1000}));
+  EXPECT_FALSE(Job1.Add(std::vector<uint32_t>{64}));
+  EXPECT_FALSE(Job2.Add(std::vector<uint32_t>{1, 1000}));
+  EXPECT_TRUE(Job2.Add(std::set<uint32_t>{1, 65}));
+  EXPECT_FALSE(Job1.Add(std::vector<uint32_t>{65}));
+  // Features wrap around, as in the corpus.
+  EXPECT_FALSE(
+      Job1.Add(std::vector<uint32_t>{SharedFeatureSet::kFeatureSetSize + 1}));
+  RemoveFile(Path);
+}
+
 // FuzzerCommand unit tests. The arguments in the two helper methods below must
 // match.
 static void makeCommandArgs(std::vector<std::string> *ArgsToAdd) {
@@ -27,6 +27,7 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #if defined(__linux__)
+#include <fcntl.h>
 #include <sys/types.h>
 #endif
 #endif
@@ -564,6 +565,82 @@ static int writeProfileWithFileObject(const char *Filename, FILE *File) {
   return rc;
 }
 
+#if defined(__linux__)
+static const int LockFreeMergePool = 1;
+/* Open the merge pool file \p Filename for continuous mode without locking
+ * it. The file is either opened as is, or written in full under a private
+ * name and published with link(), which fails if another process published it
+ * first, so processes only ever see complete profiles. Since the counters of
+ * all the processes are then mapped from the same file, there is nothing left
+ * to merge at exit; build with -fprofile-update=atomic so that concurrent
+ * increments from different processes aren't lost. Returns NULL on failure. */
+static FILE *openMergePoolFileLockFree(const char *Filename) {
+  size_t TmpLength = strlen(Filename) + 32;
+  char *TmpFilename = (char *)COMPILER_RT_ALLOCA(TmpLength);
+  snprintf(TmpFilename, TmpLength, "%s.tmp.%d", Filename, (int)getpid());
+
+  for (;;) {
+    int Fd = open(Filename, O_RDWR);
+    if (Fd != -1) {
+      FILE *File = fdopen(Fd, "r+b");
+      if (!File) {
+        close(Fd);
+        return NULL;
+      }
+      /* Check that the published profile is compatible with the data in this
+       * process. */
+      uint64_t ProfileFileSize = 0;
+      char *ProfileBuffer;
+      if (getProfileFileSizeForMerging(File, &ProfileFileSize) == -1 ||
+          mmapProfileForMerging(File, ProfileFileSize, &ProfileBuffer) == -1) {
+        fclose(File);
+        return NULL;
+      }
+      (void)munmap(ProfileBuffer, ProfileFileSize);
+      return File;
+    }
+    if (errno != ENOENT) {
+      PROF_ERR("Unable to open profile \"%s\": %s\n", Filename,
+               strerror(errno));
+      return NULL;
+    }
+
+    FILE *File = fopen(TmpFilename, "w+b");
+    if (!File) {
+      PROF_ERR("Unable to create profile \"%s\": %s\n", TmpFilename,
+               strerror(errno));
+      return NULL;
+    }
+    FreeHook = &free;
+    setupIOBuffer();
+    ProfDataWriter fileWriter;
+    initFileWriter(&fileWriter, File);
+    if (lprofWriteData(&fileWriter, 0, 0) || fflush(File)) {
+      PROF_ERR("Failed to write file \"%s\": %s\n", TmpFilename,
+               strerror(errno));
+      unlink(TmpFilename);
+      fclose(File);
+      return NULL;
+    }
+    int Published = link(TmpFilename, Filename) == 0;
+    int LinkErrno = errno;
+    unlink(TmpFilename);
+    if (Published)
+      return File;
+    fclose(File);
+    if (LinkErrno != EEXIST) {
+      PROF_ERR("Unable to publish profile \"%s\": %s\n", Filename,
+               strerror(LinkErrno));
+      return NULL;
+    }
+    /* Another process published the profile first, use it instead. */
+  }
+}
+#else
+static const int LockFreeMergePool = 0;
+static FILE *openMergePoolFileLockFree(const char *Filename) { return NULL; }
+#endif
+
 static void initializeProfileForContinuousMode(void) {
   if (!__llvm_profile_is_continuous_mode_enabled())
     return;
@@ -588,7 +665,13 @@ static void initializeProfileForContinuousMode(void) {
 
   FILE *File = NULL;
   uint64_t CurrentFileOffset = 0;
-  if (doMerging()) {
+  if (doMerging() && LockFreeMergePool) {
+    /* Map the counter section from the shared profile, without serializing
+     * the start up of the participating processes on a file lock. */
+    File = openMergePoolFileLockFree(Filename);
+    if (!File)
+      return;
+  } else if (doMerging()) {
     /* We are merging profiles. Map the counter section as shared memory into
      * the profile, i.e. into each participating process. An increment in one
      * process should be visible to every other process with the same counter
@@ -647,7 +730,8 @@ static void initializeProfileForContinuousMode(void) {
     mmapForContinuousMode(CurrentFileOffset, File);
 
   if (doMerging()) {
-    lprofUnlockFileHandle(File);
+    if (!LockFreeMergePool)
+      lprofUnlockFileHandle(File);
     fclose(File);
   }
 }
@@ -994,8 +1078,12 @@ void __llvm_profile_initialize_file(void) {
 COMPILER_RT_VISIBILITY
 void __llvm_profile_initialize(void) {
   __llvm_profile_initialize_file();
-  if (!__llvm_profile_is_continuous_mode_enabled())
+  /* In continuous mode the counters are mapped from the profile, and must be
+   * incremented in place. */
+  if (!__llvm_profile_is_continuous_mode_enabled()) {
+    lprofInitCounterShards();
     __llvm_profile_register_write_file_atexit();
+  }
 }
 
 /* This API is directly called by the user application code. It has the
@@ -192,6 +192,14 @@ COMPILER_RT_VISIBILITY extern ValueProfNode *CurrentVNode;
 COMPILER_RT_VISIBILITY extern ValueProfNode *EndVNode;
 extern void (*VPMergeHook)(struct ValueProfData *, __llvm_profile_data *);
 
+/* Set up the shards of the counters if the instrumented code increments them
+ * in per-thread shards. The shards are then folded into the counters through
+ * FoldCounterShardsHook before the counters are written, and cleared through
+ * ResetCounterShardsHook when the counters are reset. */
+void lprofInitCounterShards(void);
+COMPILER_RT_VISIBILITY extern void (*FoldCounterShardsHook)(void);
+COMPILER_RT_VISIBILITY extern void (*ResetCounterShardsHook)(void);
+
 /*
  * Write binary ids into profiles if writer is given.
  * Return -1 if an error occurs, otherwise, return total size of binary ids.
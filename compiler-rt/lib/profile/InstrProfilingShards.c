@@ -0,0 +1,121 @@
+/*===- InstrProfilingShards.c - Per-thread shards of the profile counters -===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+#include "InstrProfilingPort.h"
+
+#if defined(__ELF__)
+
+/* Code built with -mllvm -instrprof-counter-shards increments its counters at
+ * counter + bias + shard * size, where the shard is picked by hashing the
+ * address of a thread local variable, so that threads running the same hot
+ * code don't keep bouncing the cache lines of its counters. The copies of the
+ * counter section are allocated here, and folded into the counters before the
+ * profile is written. */
+
+#define INSTR_PROF_PROFILE_COUNTER_SHARDS_DEFAULT_VAR                          \
+  INSTR_PROF_CONCAT(INSTR_PROF_PROFILE_COUNTER_SHARDS_VAR, _default)
+uint64_t INSTR_PROF_PROFILE_COUNTER_SHARDS_DEFAULT_VAR[3] = {0, 0, 0};
+
+/* This variable is a weak external reference which could be used to detect
+ * whether or not the compiler defined this symbol. */
+COMPILER_RT_VISIBILITY extern uint64_t INSTR_PROF_PROFILE_COUNTER_SHARDS_VAR[3]
+    __attribute__((weak, alias(INSTR_PROF_QUOTE(
+                             INSTR_PROF_PROFILE_COUNTER_SHARDS_DEFAULT_VAR))));
+
+/* The fields of the shards variable, as read by the instrumented code. */
+enum { ShardsBias = 0, ShardsSize = 1, ShardsMask = 2 };
+
+#define DEFAULT_NUM_SHARDS 16
+#define MAX_NUM_SHARDS 256
+/* Keep the counters of different shards in different cache lines. */
+#define SHARD_ALIGNMENT 64
+
+static char *Shards = NULL;
+static uint64_t NumShards = 0;
+static uint64_t ShardSize = 0;
+
+static void foldCounterShards(void) {
+  uint64_t *Counters = (uint64_t *)__llvm_profile_begin_counters();
+  uint64_t NumCounters =
+      (__llvm_profile_end_counters() - __llvm_profile_begin_counters()) /
+      sizeof(uint64_t);
+  uint64_t S, I;
+  for (S = 0; S < NumShards; ++S) {
+    uint64_t *Shard = (uint64_t *)(Shards + S * ShardSize);
+    for (I = 0; I < NumCounters; ++I)
+      if (Shard[I])
+        Counters[I] += __atomic_exchange_n(&Shard[I], 0, __ATOMIC_RELAXED);
+  }
+}
+
+static void resetCounterShards(void) {
+  memset(Shards, 0, NumShards * ShardSize);
+}
+
+static uint64_t getNumShards(void) {
+  const char *Str = getenv("LLVM_PROFILE_COUNTER_SHARDS");
+  if (!Str || !Str[0])
+    return DEFAULT_NUM_SHARDS;
+  uint64_t N = strtoull(Str, NULL, 10);
+  if (N > MAX_NUM_SHARDS || (N & (N - 1)) != 0) {
+    PROF_WARN("LLVM_PROFILE_COUNTER_SHARDS=%s is not a power of two up to %d, "
+              "using %d shards.\n",
+              Str, MAX_NUM_SHARDS, DEFAULT_NUM_SHARDS);
+    return DEFAULT_NUM_SHARDS;
+  }
+  return N;
+}
+
+COMPILER_RT_VISIBILITY void lprofInitCounterShards(void) {
+  uint64_t *Vars = INSTR_PROF_PROFILE_COUNTER_SHARDS_VAR;
+  if (Vars == INSTR_PROF_PROFILE_COUNTER_SHARDS_DEFAULT_VAR || Shards)
+    return;
+  /* Byte coverage counters are never sharded. */
+  if (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE)
+    return;
+  const char *CountersBegin = __llvm_profile_begin_counters();
+  const char *CountersEnd = __llvm_profile_end_counters();
+  uint64_t N = getNumShards();
+  /* A single shard would only move the contention elsewhere. */
+  if (CountersBegin == CountersEnd || N <= 1)
+    return;
+
+  uint64_t Size = (CountersEnd - CountersBegin + SHARD_ALIGNMENT - 1) &
+                  ~(uint64_t)(SHARD_ALIGNMENT - 1);
+  char *Allocation = (char *)calloc(1, N * Size + SHARD_ALIGNMENT);
+  if (!Allocation) {
+    PROF_WARN("Unable to allocate %" PRIu64 " counter shards, the counters "
+              "are shared by all threads.\n",
+              N);
+    return;
+  }
+  Shards = (char *)(((uintptr_t)Allocation + SHARD_ALIGNMENT - 1) &
+                    ~(uintptr_t)(SHARD_ALIGNMENT - 1));
+  NumShards = N;
+  ShardSize = Size;
+  FoldCounterShardsHook = foldCounterShards;
+  ResetCounterShardsHook = resetCounterShards;
+
+  /* The instrumented code reads these once per function invocation. Only set
+   * the mask once the shards are usable, as with a zero mask every thread
+   * uses the first shard. */
+  Vars[ShardsBias] = (uint64_t)(Shards - CountersBegin);
+  Vars[ShardsSize] = ShardSize;
+  __atomic_store_n(&Vars[ShardsMask], NumShards - 1, __ATOMIC_RELEASE);
+}
+
+#else
+
+COMPILER_RT_VISIBILITY void lprofInitCounterShards(void) {}
+
+#endif
@@ -12,9 +12,19 @@
 
 #include "benchmark/benchmark.h"
 
+#include <fstream>
 #include <memory>
 #include <vector>
 
+#if SCUDO_LINUX
+// Same as the Android configuration, but with per-CPU caches instead of shared
+// ones.
+struct PerCPUConfig : scudo::AndroidConfig {
+  template <class A>
+  using TSDRegistryT = scudo::TSDRegistryPerCPUT<A, 64U, 8U>;
+};
+#endif
+
 void *CurrentAllocator;
 template <typename Config> void PostInitCallback() {
   reinterpret_cast<scudo::Allocator<Config> *>(CurrentAllocator)->initGwpAsan();
@@ -54,6 +64,9 @@ BENCHMARK_TEMPLATE(BM_malloc_free, scudo::AndroidConfig)
     ->Range(MinSize, MaxSize);
 BENCHMARK_TEMPLATE(BM_malloc_free, scudo::AndroidSvelteConfig)
     ->Range(MinSize, MaxSize);
+#if SCUDO_LINUX
+BENCHMARK_TEMPLATE(BM_malloc_free, PerCPUConfig)->Range(MinSize, MaxSize);
+#endif
 #if SCUDO_CAN_USE_PRIMARY64
 BENCHMARK_TEMPLATE(BM_malloc_free, scudo::FuchsiaConfig)
     ->Range(MinSize, MaxSize);
@@ -101,9 +114,72 @@ BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::AndroidConfig)
     ->Range(MinIters, MaxIters);
 BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::AndroidSvelteConfig)
     ->Range(MinIters, MaxIters);
+#if SCUDO_LINUX
+BENCHMARK_TEMPLATE(BM_malloc_free_loop, PerCPUConfig)
+    ->Range(MinIters, MaxIters);
+#endif
 #if SCUDO_CAN_USE_PRIMARY64
 BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::FuchsiaConfig)
     ->Range(MinIters, MaxIters);
 #endif
 
+#if SCUDO_LINUX
+static size_t getResidentMemorySize() {
+  size_t Size, Resident;
+  std::ifstream IFS("/proc/self/statm");
+  IFS >> Size >> Resident;
+  return Resident * scudo::getPageSizeCached();
+}
+
+// Compares the throughput and the memory footprint of the shared and per-CPU
+// caches when many threads concurrently allocate and free batches of chunks.
+// The RSS counter reports the growth of the resident memory of the process
+// while the allocator was running.
+template <typename Config>
+static void BM_malloc_free_threaded(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config, PostInitCallback<Config>>;
+  static AllocatorT *Allocator;
+  static size_t RssOnStart;
+  if (State.thread_index() == 0) {
+    RssOnStart = getResidentMemorySize();
+    Allocator = new AllocatorT;
+    CurrentAllocator = Allocator;
+  }
+
+  const size_t NBytes = State.range(0);
+  std::vector<void *> Ptrs(64);
+
+  for (auto _ : State) {
+    for (void *&Ptr : Ptrs) {
+      Ptr = Allocator->allocate(NBytes, scudo::Chunk::Origin::Malloc);
+      benchmark::DoNotOptimize(Ptr);
+    }
+    for (void *Ptr : Ptrs)
+      Allocator->deallocate(Ptr, scudo::Chunk::Origin::Malloc);
+  }
+
+  State.SetItemsProcessed(uint64_t(State.iterations()) *
+                          uint64_t(Ptrs.size()));
+  if (State.thread_index() == 0) {
+    const size_t Rss = getResidentMemorySize();
+    const size_t RssGrowth = Rss - scudo::Min(Rss, RssOnStart);
+    State.counters["RSS"] =
+        benchmark::Counter(static_cast<double>(RssGrowth),
+                           benchmark::Counter::kDefaults,
+                           benchmark::Counter::OneK::kIs1024);
+    Allocator->unmapTestOnly();
+    delete Allocator;
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, scudo::AndroidConfig)
+    ->Arg(64)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, PerCPUConfig)
+    ->Arg(64)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+#endif
+
 BENCHMARK_MAIN();
@@ -69,6 +69,12 @@ void *map(void *Addr, uptr Size, UNUSED const char *Name, uptr Flags,
 #if SCUDO_ANDROID
   if (Name)
     prctl(ANDROID_PR_SET_VMA, ANDROID_PR_SET_VMA_ANON_NAME, P, Size, Name);
+#endif
+#if defined(MADV_HUGEPAGE)
+  // This fails if transparent huge pages are not supported by the kernel, which
+  // is fine as it's only a hint.
+  if (Flags & MAP_HUGEPAGES)
+    madvise(P, Size, MADV_HUGEPAGE);
 #endif
   return P;
 }
@@ -143,6 +149,54 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+#if defined(__NR_rseq)
+// The area registered with the kernel through the rseq (restartable sequences)
+// system call. The kernel keeps CpuId up to date for the registered thread, so
+// reading the current CPU is a plain thread-local load. We don't use rseq
+// critical sections, so RseqCs is always 0.
+struct alignas(32) RseqArea {
+  u32 CpuIdStart;
+  u32 CpuId;
+  u64 RseqCs;
+  u32 Flags;
+};
+
+enum RseqStatus : u8 { RseqUnregistered = 0, RseqRegistered, RseqUnavailable };
+
+static thread_local RseqArea ThreadRseq = {0, ~0U, 0, 0};
+static thread_local RseqStatus ThreadRseqStatus = RseqUnregistered;
+
+// The signature is only checked when aborting rseq critical sections, we use
+// the same value as glibc.
+static const u32 RseqSignature = 0x53053053;
+
+static NOINLINE bool registerRseq() {
+  // This fails with EBUSY if the C library already registered an area for this
+  // thread (glibc 2.35+), in which case sched_getcpu reads the CPU number from
+  // that area and is just as cheap.
+  if (syscall(__NR_rseq, &ThreadRseq, sizeof(ThreadRseq), 0, RseqSignature) !=
+      0) {
+    ThreadRseqStatus = RseqUnavailable;
+    return false;
+  }
+  ThreadRseqStatus = RseqRegistered;
+  return true;
+}
+#endif
+
+s32 getCurrentCPU() {
+#if defined(__NR_rseq)
+  if (LIKELY(ThreadRseqStatus == RseqRegistered) ||
+      (ThreadRseqStatus == RseqUnregistered && registerRseq())) {
+    const u32 CPU = *reinterpret_cast<volatile u32 *>(&ThreadRseq.CpuId);
+    if (LIKELY(static_cast<s32>(CPU) >= 0))
+      return static_cast<s32>(CPU);
+  }
+#endif
+  const int CPU = sched_getcpu();
+  return CPU < 0 ? -1 : CPU;
+}
+
 u32 getThreadID() {
 #if SCUDO_ANDROID
   return static_cast<u32>(gettid());
@@ -40,6 +40,12 @@ namespace scudo {
 //
 // The memory used by this allocator is never unmapped, but can be partially
 // released if the platform allows for it.
+//
+// If PrimaryEnableHugePages is set, Regions start on a huge page boundary and
+// are mapped by whole huge pages with a transparent huge pages hint. Periodic
+// releases then only return whole free huge pages to the OS, so that partially
+// used huge pages are not broken up into small pages; only explicit releases
+// go down to page granularity.
 
 template <typename Config> class SizeClassAllocator64 {
 public:
@@ -73,11 +79,19 @@ public:
     for (uptr I = 0; I < NumClasses; I++) {
       RegionInfo *Region = getRegionInfo(I);
       // The actual start of a region is offset by a random number of pages
-      // when PrimaryEnableRandomOffset is set.
-      Region->RegionBeg = getRegionBaseByClassId(I) +
-                          (Config::PrimaryEnableRandomOffset
-                               ? ((getRandomModN(&Seed, 16) + 1) * PageSize)
-                               : 0);
+      // when PrimaryEnableRandomOffset is set. With huge pages, the region
+      // starts on a huge page boundary and is offset by up to 3 huge pages.
+      if (EnableHugePages)
+        Region->RegionBeg =
+            roundUpTo(getRegionBaseByClassId(I), HugePageSize) +
+            (Config::PrimaryEnableRandomOffset
+                 ? (getRandomModN(&Seed, 4) * HugePageSize)
+                 : 0);
+      else
+        Region->RegionBeg = getRegionBaseByClassId(I) +
+                            (Config::PrimaryEnableRandomOffset
+                                 ? ((getRandomModN(&Seed, 16) + 1) * PageSize)
+                                 : 0);
       Region->RandState = getRandomU32(&Seed);
       Region->ReleaseInfo.LastReleaseAtNs = Time;
     }
@@ -168,6 +182,8 @@ public:
                 "allocations; remains %zu\n",
                 TotalMapped >> 20, 0U, PoppedBlocks,
                 PoppedBlocks - PushedBlocks);
+    if (EnableHugePages)
+      getHugePagesStats(Str);
 
     for (uptr I = 0; I < NumClasses; I++)
       getStats(Str, I, 0);
@@ -272,7 +288,16 @@ private:
   static const uptr NumClasses = SizeClassMap::NumClasses;
   static const uptr PrimarySize = RegionSize * NumClasses;
 
-  static const uptr MapSizeIncrement = Config::PrimaryMapSizeIncrement;
+  static const bool EnableHugePages = Config::PrimaryEnableHugePages;
+  // The size of a transparent huge page on x86_64 and on AArch64 with 4K pages.
+  static const uptr HugePageSize = 1UL << 21;
+  // Leave room for the random offset of the Regions, see init().
+  static_assert(!EnableHugePages || Config::PrimaryRegionSizeLog >= 26U,
+                "Regions are too small to be backed by huge pages");
+  static const uptr MapSizeIncrement =
+      EnableHugePages
+          ? roundUpTo(Config::PrimaryMapSizeIncrement, HugePageSize)
+          : Config::PrimaryMapSizeIncrement;
   // Fill at most this number of batches from the newly map'd memory.
   static const u32 MaxNumBatches = SCUDO_ANDROID ? 4U : 8U;
 
@@ -286,6 +311,10 @@ private:
     uptr RangesReleased;
     uptr LastReleasedBytes;
     u64 LastReleaseAtNs;
+    // Only used with huge pages.
+    uptr LastReleasedHugePages;
+    uptr LastSplitHugePages;
+    uptr LastRetainedBytes;
   };
 
   struct UnpaddedRegionInfo {
@@ -360,7 +389,8 @@ private:
               reinterpret_cast<void *>(RegionBeg + MappedUser), MapSize,
               "scudo:primary",
               MAP_ALLOWNOMEM | MAP_RESIZABLE |
-                  (useMemoryTagging<Config>(Options.load()) ? MAP_MEMTAG : 0),
+                  (useMemoryTagging<Config>(Options.load()) ? MAP_MEMTAG : 0) |
+                  (EnableHugePages ? MAP_HUGEPAGES : 0),
               &Region->Data)))
         return nullptr;
       Region->MappedUser += MapSize;
@@ -422,18 +452,51 @@ private:
                 TotalChunks, Rss >> 10, Region->ReleaseInfo.RangesReleased,
                 Region->ReleaseInfo.LastReleasedBytes >> 10, Region->RegionBeg,
                 getRegionBaseByClassId(ClassId));
+    if (EnableHugePages)
+      Str->append("   huge pages: mapped: %6zu last released: %6zu last "
+                  "split: %6zu last retained: %6zuK\n",
+                  Region->MappedUser / HugePageSize,
+                  Region->ReleaseInfo.LastReleasedHugePages,
+                  Region->ReleaseInfo.LastSplitHugePages,
+                  Region->ReleaseInfo.LastRetainedBytes >> 10);
+  }
+
+  void getHugePagesStats(ScopedString *Str) {
+    uptr MappedHugePages = 0;
+    uptr ReleasedHugePages = 0;
+    uptr SplitHugePages = 0;
+    uptr RetainedBytes = 0;
+    for (uptr I = 0; I < NumClasses; I++) {
+      RegionInfo *Region = getRegionInfo(I);
+      MappedHugePages += Region->MappedUser / HugePageSize;
+      ReleasedHugePages += Region->ReleaseInfo.LastReleasedHugePages;
+      SplitHugePages += Region->ReleaseInfo.LastSplitHugePages;
+      RetainedBytes += Region->ReleaseInfo.LastRetainedBytes;
+    }
+    // The released huge pages are free and can be backed by huge pages again
+    // when reused, the split ones were partially released by an explicit
+    // release and are backed by small pages until the kernel collapses them.
+    // The retained bytes are free, but can't be released without splitting the
+    // huge pages they belong to.
+    Str->append("Stats: SizeClassAllocator64: %zu huge pages mapped; last "
+                "releases: %zu huge pages released, %zu split, %zuK retained "
+                "in partially used huge pages\n",
+                MappedHugePages, ReleasedHugePages, SplitHugePages,
+                RetainedBytes >> 10);
   }
 
   NOINLINE uptr releaseToOSMaybe(RegionInfo *Region, uptr ClassId,
                                  bool Force = false) {
     const uptr BlockSize = getSizeByClassId(ClassId);
     const uptr PageSize = getPageSizeCached();
+    // Unless forced to, only whole huge pages are released with huge pages.
+    const bool WholeHugePagesOnly = EnableHugePages && !Force;
 
     DCHECK_GE(Region->Stats.PoppedBlocks, Region->Stats.PushedBlocks);
     const uptr BytesInFreeList =
         Region->AllocatedUser -
         (Region->Stats.PoppedBlocks - Region->Stats.PushedBlocks) * BlockSize;
-    if (BytesInFreeList < PageSize)
+    if (BytesInFreeList < (WholeHugePagesOnly ? HugePageSize : PageSize))
       return 0; // No chance to release anything.
     const uptr BytesPushed = (Region->Stats.PushedBlocks -
                               Region->ReleaseInfo.PushedBlocksAtLastRelease) *
@@ -470,8 +533,22 @@ private:
       return decompactPtrInternal(CompactPtrBase, CompactPtr);
     };
     auto SkipRegion = [](UNUSED uptr RegionIndex) { return false; };
-    releaseFreeMemoryToOS(Region->FreeList, Region->AllocatedUser, 1U,
-                          BlockSize, &Recorder, DecompactPtr, SkipRegion);
+    if (EnableHugePages) {
+      HugePageReleaseRecorder<ReleaseRecorder> HugePageRecorder(
+          &Recorder, HugePageSize, WholeHugePagesOnly);
+      releaseFreeMemoryToOS(Region->FreeList, Region->AllocatedUser, 1U,
+                            BlockSize, &HugePageRecorder, DecompactPtr,
+                            SkipRegion);
+      Region->ReleaseInfo.LastReleasedHugePages =
+          HugePageRecorder.getReleasedHugePagesCount();
+      Region->ReleaseInfo.LastSplitHugePages =
+          HugePageRecorder.getSplitHugePagesCount();
+      Region->ReleaseInfo.LastRetainedBytes =
+          HugePageRecorder.getRetainedBytes();
+    } else {
+      releaseFreeMemoryToOS(Region->FreeList, Region->AllocatedUser, 1U,
+                            BlockSize, &Recorder, DecompactPtr, SkipRegion);
+    }
 
     if (Recorder.getReleasedRangesCount() > 0) {
       Region->ReleaseInfo.PushedBlocksAtLastRelease =
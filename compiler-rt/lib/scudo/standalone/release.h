@@ -41,6 +41,63 @@ private:
   MapPlatformData *Data = nullptr;
 };
 
+// Wraps a recorder to avoid breaking up transparent huge pages. If
+// WholeHugePagesOnly is set, each range is trimmed to the huge pages it fully
+// covers, and the free bytes left over are accounted as retained. Otherwise the
+// ranges are released as is, and the huge pages they partially cover are
+// accounted as split.
+template <class ReleaseRecorderT> class HugePageReleaseRecorder {
+public:
+  HugePageReleaseRecorder(ReleaseRecorderT *Recorder, uptr HugePageSize,
+                          bool WholeHugePagesOnly)
+      : Recorder(Recorder), HugePageSize(HugePageSize),
+        WholeHugePagesOnly(WholeHugePagesOnly) {
+    DCHECK(isPowerOfTwo(HugePageSize));
+  }
+
+  uptr getReleasedHugePagesCount() const { return ReleasedHugePagesCount; }
+
+  uptr getSplitHugePagesCount() const { return SplitHugePagesCount; }
+
+  uptr getRetainedBytes() const { return RetainedBytes; }
+
+  uptr getBase() const { return Recorder->getBase(); }
+
+  void releasePageRangeToOS(uptr From, uptr To) {
+    // Huge pages are aligned in the address space, not relative to the base.
+    const uptr Base = getBase();
+    const uptr Beg = roundUpTo(Base + From, HugePageSize) - Base;
+    const uptr End = roundDownTo(Base + To, HugePageSize) - Base;
+    const bool HasHugePages = Beg < End;
+    if (HasHugePages)
+      ReleasedHugePagesCount += (End - Beg) / HugePageSize;
+    if (!WholeHugePagesOnly) {
+      if (HasHugePages)
+        SplitHugePagesCount += (From != Beg) + (To != End);
+      else
+        SplitHugePagesCount += (roundUpTo(Base + To, HugePageSize) -
+                                roundDownTo(Base + From, HugePageSize)) /
+                               HugePageSize;
+      Recorder->releasePageRangeToOS(From, To);
+      return;
+    }
+    if (!HasHugePages) {
+      RetainedBytes += To - From;
+      return;
+    }
+    RetainedBytes += (Beg - From) + (To - End);
+    Recorder->releasePageRangeToOS(Beg, End);
+  }
+
+private:
+  ReleaseRecorderT *const Recorder;
+  const uptr HugePageSize;
+  const bool WholeHugePagesOnly;
+  uptr ReleasedHugePagesCount = 0;
+  uptr SplitHugePagesCount = 0;
+  uptr RetainedBytes = 0;
+};
+
 // A packed array of Counters. Each counter occupies 2^N bits, enough to store
 // counter's MaxValue. Ctor will try to use a static buffer first, and if that
 // fails (the buffer is too small or already locked), will allocate the
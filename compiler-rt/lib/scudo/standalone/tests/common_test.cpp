@@ -13,6 +13,10 @@
 #include <algorithm>
 #include <fstream>
 
+#if SCUDO_LINUX
+#include <sched.h>
+#endif
+
 namespace scudo {
 
 static uptr getResidentMemorySize() {
@@ -69,4 +73,17 @@ TEST(ScudoCommonTest, Zeros) {
   unmap(P, Size, 0, &Data);
 }
 
+#if SCUDO_LINUX
+TEST(ScudoCommonTest, CurrentCPU) {
+  cpu_set_t CPUs;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(CPUs), &CPUs), 0);
+  // The first call registers the rseq area, the following ones read it.
+  for (uptr I = 0; I < 2U; I++) {
+    const s32 CPU = getCurrentCPU();
+    ASSERT_GE(CPU, 0);
+    EXPECT_TRUE(CPU_ISSET(CPU, &CPUs));
+  }
+}
+#endif
+
 } // namespace scudo
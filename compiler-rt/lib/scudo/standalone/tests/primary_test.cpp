@@ -31,6 +31,7 @@ struct TestConfig1 {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 };
 
 struct TestConfig2 {
@@ -47,6 +48,7 @@ struct TestConfig2 {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 };
 
 struct TestConfig3 {
@@ -63,6 +65,19 @@ struct TestConfig3 {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
+};
+
+struct TestConfig4 {
+  static const scudo::uptr PrimaryRegionSizeLog = 26U;
+  static const scudo::s32 PrimaryMinReleaseToOsIntervalMs = INT32_MIN;
+  static const scudo::s32 PrimaryMaxReleaseToOsIntervalMs = INT32_MAX;
+  static const bool MaySupportMemoryTagging = false;
+  typedef scudo::uptr PrimaryCompactPtrT;
+  static const scudo::uptr PrimaryCompactPtrScale = 0;
+  static const bool PrimaryEnableRandomOffset = true;
+  static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = true;
 };
 
 template <typename BaseConfig, typename SizeClassMapT>
@@ -95,12 +110,14 @@ template <class BaseConfig> struct ScudoPrimaryTest : public Test {};
 #if SCUDO_FUCHSIA
 #define SCUDO_TYPED_TEST_ALL_TYPES(FIXTURE, NAME)                              \
   SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig2)                            \
-  SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig3)
+  SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig3)                            \
+  SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig4)
 #else
 #define SCUDO_TYPED_TEST_ALL_TYPES(FIXTURE, NAME)                              \
   SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig1)                            \
   SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig2)                            \
-  SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig3)
+  SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig3)                            \
+  SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TestConfig4)
 #endif
 
 #define SCUDO_TYPED_TEST_TYPE(FIXTURE, NAME, TYPE)                             \
@@ -153,6 +170,7 @@ struct SmallRegionsConfig {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 };
 
 // The 64-bit SizeClassAllocator can be easily OOM'd with small region sizes.
@@ -294,3 +312,39 @@ SCUDO_TYPED_TEST(ScudoPrimaryTest, ReleaseToOS) {
   Cache.destroy(nullptr);
   EXPECT_GT(Allocator->releaseToOS(), 0U);
 }
+
+// With huge pages, periodic releases only return whole free huge pages, and the
+// corresponding statistics are reported.
+TEST(ScudoPrimaryTest, HugePagesRelease) {
+  using Primary = TestAllocator<TestConfig4, scudo::DefaultSizeClassMap>;
+  std::unique_ptr<Primary> Allocator(new Primary);
+  Allocator->init(/*ReleaseToOsInterval=*/0);
+  typename Primary::CacheT Cache;
+  Cache.init(nullptr, Allocator.get());
+  const scudo::uptr Size = scudo::getPageSizeCached() * 2;
+  const scudo::uptr ClassId = Primary::SizeClassMap::getClassIdBySize(Size);
+  const scudo::uptr BlockSize = Primary::getSizeByClassId(ClassId);
+  // Allocate a bit more than 4M worth of blocks, and keep the last one, so
+  // that the huge page it belongs to is only partially free.
+  std::vector<void *> V;
+  for (scudo::uptr I = 0; I < (4U << 20) / BlockSize + 1U; I++) {
+    void *P = Cache.allocate(ClassId);
+    ASSERT_NE(P, nullptr);
+    memset(P, 'B', BlockSize);
+    V.push_back(P);
+  }
+  void *Last = V.back();
+  V.pop_back();
+  for (void *P : V)
+    Cache.deallocate(ClassId, P);
+  Cache.drain();
+  for (scudo::uptr I = 0; I < BlockSize; I++)
+    EXPECT_EQ(reinterpret_cast<char *>(Last)[I], 'B');
+  Cache.deallocate(ClassId, Last);
+  Cache.destroy(nullptr);
+  Allocator->releaseToOS();
+  scudo::ScopedString Str;
+  Allocator->getStats(&Str);
+  EXPECT_NE(strstr(Str.data(), "huge pages mapped"), nullptr);
+  Str.output();
+}
@@ -128,6 +128,37 @@ public:
   scudo::uptr getBase() const { return 0; }
 };
 
+TEST(ScudoReleaseTest, HugePageReleaseRecorder) {
+  const scudo::uptr PageSize = scudo::getPageSizeCached();
+  // Pretend that huge pages are 4 pages.
+  const scudo::uptr HugePageSize = 4 * PageSize;
+  ReleasedPagesRecorder Recorder;
+  scudo::HugePageReleaseRecorder<ReleasedPagesRecorder> HugePageRecorder(
+      &Recorder, HugePageSize, /*WholeHugePagesOnly=*/true);
+  // Only the pages of the second huge page are released.
+  HugePageRecorder.releasePageRangeToOS(1 * PageSize, 10 * PageSize);
+  // Nothing is released from a range within a huge page.
+  HugePageRecorder.releasePageRangeToOS(13 * PageSize, 15 * PageSize);
+  EXPECT_EQ(Recorder.ReportedPages.size(), 4U);
+  for (scudo::uptr I = 4; I < 8; I++)
+    EXPECT_EQ(Recorder.ReportedPages.count(I * PageSize), 1U);
+  EXPECT_EQ(HugePageRecorder.getReleasedHugePagesCount(), 1U);
+  EXPECT_EQ(HugePageRecorder.getSplitHugePagesCount(), 0U);
+  EXPECT_EQ(HugePageRecorder.getRetainedBytes(), 7 * PageSize);
+
+  // When not limited to whole huge pages, everything is released, and the
+  // partially released huge pages are accounted for.
+  ReleasedPagesRecorder SplitRecorder;
+  scudo::HugePageReleaseRecorder<ReleasedPagesRecorder> SplitHugePageRecorder(
+      &SplitRecorder, HugePageSize, /*WholeHugePagesOnly=*/false);
+  SplitHugePageRecorder.releasePageRangeToOS(1 * PageSize, 10 * PageSize);
+  SplitHugePageRecorder.releasePageRangeToOS(13 * PageSize, 15 * PageSize);
+  EXPECT_EQ(SplitRecorder.ReportedPages.size(), 11U);
+  EXPECT_EQ(SplitHugePageRecorder.getReleasedHugePagesCount(), 1U);
+  EXPECT_EQ(SplitHugePageRecorder.getSplitHugePagesCount(), 3U);
+  EXPECT_EQ(SplitHugePageRecorder.getRetainedBytes(), 0U);
+}
+
 // Simplified version of a TransferBatch.
 template <class SizeClassMap> struct FreeBatch {
   static const scudo::u32 MaxCount = SizeClassMap::MaxNumCachedHint;
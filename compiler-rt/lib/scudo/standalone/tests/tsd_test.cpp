@@ -9,10 +9,15 @@
 #include "tests/scudo_unit_test.h"
 
 #include "tsd_exclusive.h"
+#include "tsd_per_cpu.h"
 #include "tsd_shared.h"
 
 #include <stdlib.h>
 
+#if SCUDO_LINUX
+#include <sched.h>
+#endif
+
 #include <condition_variable>
 #include <mutex>
 #include <set>
@@ -64,6 +69,11 @@ struct SharedCaches {
   using TSDRegistryT = scudo::TSDRegistrySharedT<Allocator, 16U, 8U>;
 };
 
+struct PerCPUCaches {
+  template <class Allocator>
+  using TSDRegistryT = scudo::TSDRegistryPerCPUT<Allocator, 16U, 8U>;
+};
+
 struct ExclusiveCaches {
   template <class Allocator>
   using TSDRegistryT = scudo::TSDRegistryExT<Allocator>;
@@ -116,6 +126,7 @@ template <class AllocatorT> static void testRegistry() {
 TEST(ScudoTSDTest, TSDRegistryBasic) {
   testRegistry<MockAllocator<OneCache>>();
   testRegistry<MockAllocator<SharedCaches>>();
+  testRegistry<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistry<MockAllocator<ExclusiveCaches>>();
 #endif
@@ -174,6 +185,7 @@ template <class AllocatorT> static void testRegistryThreaded() {
 TEST(ScudoTSDTest, TSDRegistryThreaded) {
   testRegistryThreaded<MockAllocator<OneCache>>();
   testRegistryThreaded<MockAllocator<SharedCaches>>();
+  testRegistryThreaded<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistryThreaded<MockAllocator<ExclusiveCaches>>();
 #endif
@@ -181,7 +193,8 @@ TEST(ScudoTSDTest, TSDRegistryThreaded) {
 
 static std::set<void *> Pointers;
 
-static void stressSharedRegistry(MockAllocator<SharedCaches> *Allocator) {
+template <class AllocatorT>
+static void stressSharedRegistry(AllocatorT *Allocator) {
   std::set<void *> Set;
   auto Registry = Allocator->getTSDRegistry();
   {
@@ -220,7 +233,7 @@ TEST(ScudoTSDTest, TSDRegistryTSDsCount) {
   // after we are done.
   std::thread Threads[32];
   for (scudo::uptr I = 0; I < ARRAY_SIZE(Threads); I++)
-    Threads[I] = std::thread(stressSharedRegistry, Allocator.get());
+    Threads[I] = std::thread(stressSharedRegistry<AllocatorT>, Allocator.get());
   {
     std::unique_lock<std::mutex> Lock(Mutex);
     Ready = true;
@@ -237,7 +250,7 @@ TEST(ScudoTSDTest, TSDRegistryTSDsCount) {
   Registry->setOption(scudo::Option::MaxTSDsCount, 16);
   Ready = false;
   for (scudo::uptr I = 0; I < ARRAY_SIZE(Threads); I++)
-    Threads[I] = std::thread(stressSharedRegistry, Allocator.get());
+    Threads[I] = std::thread(stressSharedRegistry<AllocatorT>, Allocator.get());
   {
     std::unique_lock<std::mutex> Lock(Mutex);
     Ready = true;
@@ -248,3 +261,66 @@ TEST(ScudoTSDTest, TSDRegistryTSDsCount) {
   // We should get 16 distinct TSDs back.
   EXPECT_EQ(Pointers.size(), 16U);
 }
+
+TEST(ScudoTSDTest, TSDRegistryPerCPUTSDsCount) {
+  Ready = false;
+  Pointers.clear();
+  using AllocatorT = MockAllocator<PerCPUCaches>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  std::thread Threads[32];
+  for (scudo::uptr I = 0; I < ARRAY_SIZE(Threads); I++)
+    Threads[I] = std::thread(stressSharedRegistry<AllocatorT>, Allocator.get());
+  {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    Ready = true;
+    Cv.notify_all();
+  }
+  for (auto &T : Threads)
+    T.join();
+  // Regardless of the number of threads, we shouldn't use more TSDs than there
+  // are CPUs.
+  const scudo::u32 NumberOfCPUs = scudo::getNumberOfCPUs();
+  EXPECT_LE(Pointers.size(), NumberOfCPUs ? scudo::Min(NumberOfCPUs, 16U) : 8U);
+}
+
+#if SCUDO_LINUX
+TEST(ScudoTSDTest, TSDRegistryPerCPUPinned) {
+  using AllocatorT = MockAllocator<PerCPUCaches>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  auto Registry = Allocator->getTSDRegistry();
+  // A thread pinned to a CPU always gets the TSD of that CPU.
+  std::thread Thread([&]() {
+    cpu_set_t CPUs;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(CPUs), &CPUs), 0);
+    int CPU = 0;
+    while (!CPU_ISSET(CPU, &CPUs))
+      CPU++;
+    CPU_ZERO(&CPUs);
+    CPU_SET(CPU, &CPUs);
+    ASSERT_EQ(sched_setaffinity(0, sizeof(CPUs), &CPUs), 0);
+    Registry->initThreadMaybe(Allocator.get(), /*MinimalInit=*/false);
+    bool UnlockRequired;
+    auto FirstTSD = Registry->getTSDAndLock(&UnlockRequired);
+    EXPECT_NE(FirstTSD, nullptr);
+    if (UnlockRequired)
+      FirstTSD->unlock();
+    for (scudo::uptr I = 0; I < 4096U; I++) {
+      auto TSD = Registry->getTSDAndLock(&UnlockRequired);
+      EXPECT_EQ(TSD, FirstTSD);
+      if (UnlockRequired)
+        TSD->unlock();
+    }
+  });
+  Thread.join();
+}
+#endif
@@ -0,0 +1,152 @@
+//===-- tsd_per_cpu.h -------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SCUDO_TSD_PER_CPU_H_
+#define SCUDO_TSD_PER_CPU_H_
+
+#include "tsd.h"
+
+namespace scudo {
+
+// A registry where each TSD is associated with a CPU rather than with a thread:
+// every allocation uses the TSD of the CPU the thread is currently running on,
+// as reported by getCurrentCPU (backed by rseq on Linux). The memory held in
+// the caches is thus bounded by the number of CPUs instead of the number of
+// threads, and since at most one thread runs on a CPU at a time, the TSD locks
+// are mostly uncontended. If the current CPU can't be determined, threads get
+// a TSD assigned in a round-robin fashion, as with the shared registry.
+template <class Allocator, u32 TSDsArraySize, u32 DefaultTSDCount>
+struct TSDRegistryPerCPUT {
+  void init(Allocator *Instance) {
+    DCHECK(!Initialized);
+    Instance->init();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].init(Instance);
+    const u32 NumberOfCPUs = getNumberOfCPUs();
+    setNumberOfTSDs((NumberOfCPUs == 0) ? DefaultTSDCount
+                                        : Min(NumberOfCPUs, TSDsArraySize));
+    Initialized = true;
+  }
+
+  void initOnceMaybe(Allocator *Instance) {
+    ScopedLock L(Mutex);
+    if (LIKELY(Initialized))
+      return;
+    init(Instance); // Sets Initialized.
+  }
+
+  void unmapTestOnly(Allocator *Instance) {
+    for (u32 I = 0; I < TSDsArraySize; I++) {
+      TSDs[I].commitBack(Instance);
+      TSDs[I] = {};
+    }
+    *getTlsPtr() = 0;
+    atomic_store_relaxed(&NumberOfTSDs, 0);
+    Initialized = false;
+  }
+
+  ALWAYS_INLINE void initThreadMaybe(Allocator *Instance,
+                                     UNUSED bool MinimalInit) {
+    if (LIKELY(*getTlsPtr() & InitializedBit))
+      return;
+    initThread(Instance);
+  }
+
+  ALWAYS_INLINE TSD<Allocator> *getTSDAndLock(bool *UnlockRequired) {
+    DCHECK(*getTlsPtr() & InitializedBit);
+    *UnlockRequired = true;
+    TSD<Allocator> *TSD = &TSDs[getTSDIndex()];
+    // The TSD of a CPU is only contended if its owner got preempted or
+    // migrated while holding it, in which case it will be released shortly.
+    if (LIKELY(TSD->tryLock()))
+      return TSD;
+    TSD->lock();
+    return TSD;
+  }
+
+  void disable() {
+    Mutex.lock();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].lock();
+  }
+
+  void enable() {
+    for (s32 I = static_cast<s32>(TSDsArraySize - 1); I >= 0; I--)
+      TSDs[I].unlock();
+    Mutex.unlock();
+  }
+
+  bool setOption(Option O, sptr Value) {
+    if (O == Option::MaxTSDsCount)
+      return setNumberOfTSDs(static_cast<u32>(Value));
+    if (O == Option::ThreadDisableMemInit)
+      setDisableMemInit(Value);
+    // Not supported by the TSD Registry, but not an error either.
+    return true;
+  }
+
+  bool getDisableMemInit() const { return *getTlsPtr() & DisableMemInitBit; }
+
+private:
+  // The thread-local word holds whether the thread was initialized, the
+  // ThreadDisableMemInit option, and the index of the TSD to fall back to when
+  // the current CPU is unknown.
+  static const uptr DisableMemInitBit = 1U;
+  static const uptr InitializedBit = 2U;
+  static const uptr FallbackIndexShift = 2U;
+
+  ALWAYS_INLINE uptr *getTlsPtr() const {
+    static thread_local uptr ThreadState;
+    return &ThreadState;
+  }
+
+  ALWAYS_INLINE u32 getTSDIndex() {
+    const u32 N = atomic_load_relaxed(&NumberOfTSDs);
+    DCHECK_NE(N, 0U);
+    if (TSDsArraySize == 1U)
+      return 0;
+    const s32 CPU = getCurrentCPU();
+    if (LIKELY(CPU >= 0))
+      return static_cast<u32>(CPU) % N;
+    return static_cast<u32>(*getTlsPtr() >> FallbackIndexShift) % N;
+  }
+
+  bool setNumberOfTSDs(u32 N) {
+    ScopedLock L(MutexTSDs);
+    if (N < atomic_load_relaxed(&NumberOfTSDs))
+      return false;
+    if (N > TSDsArraySize)
+      N = TSDsArraySize;
+    atomic_store_relaxed(&NumberOfTSDs, N);
+    return true;
+  }
+
+  void setDisableMemInit(bool B) {
+    *getTlsPtr() &= ~DisableMemInitBit;
+    *getTlsPtr() |= B ? DisableMemInitBit : 0;
+  }
+
+  NOINLINE void initThread(Allocator *Instance) {
+    initOnceMaybe(Instance);
+    const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
+    *getTlsPtr() = (static_cast<uptr>(Index) << FallbackIndexShift) |
+                   (*getTlsPtr() & DisableMemInitBit) | InitializedBit;
+    Instance->callPostInitCallback();
+  }
+
+  atomic_u32 CurrentIndex = {};
+  atomic_u32 NumberOfTSDs = {};
+  bool Initialized = false;
+  HybridMutex Mutex;
+  HybridMutex MutexTSDs;
+  TSD<Allocator> TSDs[TSDsArraySize];
+};
+
+} // namespace scudo
+
+#endif // SCUDO_TSD_PER_CPU_H_
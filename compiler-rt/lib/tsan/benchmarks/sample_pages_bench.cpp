@@ -0,0 +1,87 @@
+// Benchmark for tsan memory page sampling: threads mostly read a large shared
+// array, and occasionally write to it between barriers, which is the typical
+// pattern of long running services. Prints the elapsed time and the resident
+// memory of the process, to compare e.g.:
+//   TSAN_OPTIONS=sample_memory_pages=1
+//   TSAN_OPTIONS=sample_memory_pages=8
+//   TSAN_OPTIONS=sample_memory_pages=8:flush_memory_ms=500
+// Arguments are the number of threads and the size of the array in MB.
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+
+int n_threads;
+long len;
+long *a;
+pthread_barrier_t barrier;
+const int kNumIter = 20;
+const long kWriteStride = 4096;
+
+__attribute__((noinline))
+long Run(long idx) {
+  long sum = 0;
+  for (long i = 0; i < len; i++)
+    sum += a[i];
+  pthread_barrier_wait(&barrier);
+  // Each thread updates its own share of a few elements.
+  for (long i = idx * kWriteStride; i < len; i += n_threads * kWriteStride)
+    a[i]++;
+  pthread_barrier_wait(&barrier);
+  return sum;
+}
+
+void *Thread(void *arg) {
+  long idx = (long)arg;
+  long sum = 0;
+  for (int i = 0; i < kNumIter; i++)
+    sum += Run(idx);
+  return (void *)sum;
+}
+
+static long GetRSSInMB() {
+  long size = 0, resident = 0;
+  FILE *f = fopen("/proc/self/statm", "r");
+  if (!f)
+    return 0;
+  if (fscanf(f, "%ld %ld", &size, &resident) != 2)
+    resident = 0;
+  fclose(f);
+  return resident * sysconf(_SC_PAGESIZE) >> 20;
+}
+
+int main(int argc, char **argv) {
+  n_threads = 4;
+  long size_mb = 256;
+  if (argc == 3) {
+    n_threads = atoi(argv[1]);
+    assert(n_threads > 0 && n_threads <= 64);
+    size_mb = atol(argv[2]);
+    assert(size_mb > 0);
+  }
+  len = (size_mb << 20) / sizeof(long);
+  printf("%s: n_threads=%d size=%ldMB iter=%d\n", __FILE__, n_threads,
+         size_mb, kNumIter);
+  a = new long[len];
+  for (long i = 0; i < len; i++)
+    a[i] = i;
+  pthread_barrier_init(&barrier, 0, n_threads);
+  timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  pthread_t *t = new pthread_t[n_threads];
+  for (int i = 0; i < n_threads; i++)
+    pthread_create(&t[i], 0, Thread, (void *)(long)i);
+  for (int i = 0; i < n_threads; i++)
+    pthread_join(t[i], 0);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("time: %.3fs rss: %ldMB\n",
+         (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9,
+         GetRSSInMB());
+  pthread_barrier_destroy(&barrier);
+  delete [] t;
+  delete [] a;
+  return 0;
+}
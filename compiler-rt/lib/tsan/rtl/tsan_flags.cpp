@@ -115,6 +115,11 @@ void InitializeFlags(Flags *f, const char *env, const char *env_option_name) {
            " (must be [0..2])\n");
     Die();
   }
+  if (f->sample_memory_pages < 0 || f->sample_memory_pages > (1 << 16)) {
+    Printf("ThreadSanitizer: incorrect value for sample_memory_pages"
+           " (must be [0..65536])\n");
+    Die();
+  }
 }
 
 }  // namespace __tsan
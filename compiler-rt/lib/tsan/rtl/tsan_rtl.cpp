@@ -138,9 +138,16 @@ static void DoResetImpl(uptr epoch) {
   ctx->global_epoch++;
   CHECK(!ctx->resetting);
   ctx->resetting = true;
+  // Rotate the sampled memory pages. The shadow of the pages that are not
+  // sampled anymore is released below with the rest of the shadow.
+  const u32 sample_phase =
+      (atomic_load_relaxed(&ctx->sample_phase) + 1) & ctx->sample_mask;
+  atomic_store_relaxed(&ctx->sample_phase, sample_phase);
   for (u32 i = ctx->thread_registry.NumThreadsLocked(); i--;) {
     ThreadContext* tctx = (ThreadContext*)ctx->thread_registry.GetThreadLocked(
         static_cast<Tid>(i));
+    if (tctx->thr)
+      atomic_store_relaxed(&tctx->thr->sample_phase, sample_phase);
     // Potentially we could purge all ThreadStatusDead threads from the
     // registry. Since we reset all shadow, they can't race with anything
     // anymore. However, their tid's can still be stored in some aux places
@@ -645,6 +652,9 @@ void Initialize(ThreadState *thr) {
   CacheBinaryName();
   CheckASLR();
   InitializeFlags(&ctx->flags, options, env_name);
+  if (flags()->sample_memory_pages > 1)
+    ctx->sample_mask = static_cast<u32>(
+        RoundUpToPowerOfTwo(flags()->sample_memory_pages) - 1);
   AvoidCVE_2016_2143();
   __sanitizer::InitializePlatformEarly();
   __tsan::InitializePlatformEarly();
@@ -172,6 +172,11 @@ struct ThreadState {
   // but it is placed here in order to share cache line with previous fields.
   ThreadState* current;
 
+  // Memory page sampling, see Context::sample_mask. These are copies of the
+  // Context fields to keep them on the memory access fast path.
+  u32 sample_mask;
+  atomic_uint32_t sample_phase;
+
   atomic_sint32_t pending_signals;
 
   VectorClock clock;
@@ -325,6 +330,13 @@ struct Context {
   Flags flags;
   fd_t memprof_fd;
 
+  // Memory page sampling (see the sample_memory_pages flag): memory accesses
+  // are only checked on pages whose hash masked with sample_mask is equal to
+  // sample_phase. The phase is advanced on every reset, which rotates the set
+  // of sampled pages. A zero mask means that all pages are checked.
+  u32 sample_mask;
+  atomic_uint32_t sample_phase;
+
   // The last slot index (kFreeSid) is used to denote freed memory.
   TidSlot slots[kThreadSlotCount - 1];
 
@@ -346,6 +358,24 @@ ALWAYS_INLINE Flags *flags() {
   return &ctx->flags;
 }
 
+// The granularity of memory page sampling. The shadow of such a page spans
+// whole shadow pages, so that unchecked pages don't consume shadow memory.
+const uptr kSamplePageSizeLog = 12;
+
+ALWAYS_INLINE u32 SamplePageHash(uptr addr, u32 mask) {
+  return static_cast<u32>(((addr >> kSamplePageSizeLog) *
+                           0x9e3779b97f4a7c15ull) >> 32) & mask;
+}
+
+// Returns true if accesses to addr must not be checked because its page is
+// not sampled.
+ALWAYS_INLINE bool IsSampledOut(ThreadState *thr, uptr addr) {
+  const u32 mask = thr->sample_mask;
+  if (LIKELY(mask == 0))
+    return false;
+  return SamplePageHash(addr, mask) != atomic_load_relaxed(&thr->sample_phase);
+}
+
 struct ScopedIgnoreInterceptors {
   ScopedIgnoreInterceptors() {
 #if !SANITIZER_GO
@@ -152,6 +152,11 @@ struct OnStartedArgs {
 void ThreadStart(ThreadState *thr, Tid tid, tid_t os_id,
                  ThreadType thread_type) {
   ctx->thread_registry.StartThread(tid, os_id, thread_type, thr);
+  // Set after registering the thread, so that a concurrent reset either sees
+  // the thread or has already advanced the phase we load here.
+  thr->sample_mask = ctx->sample_mask;
+  atomic_store_relaxed(&thr->sample_phase,
+                       atomic_load_relaxed(&ctx->sample_phase));
   if (!thr->ignore_sync) {
     SlotAttachAndLock(thr);
     if (thr->tctx->sync_epoch == ctx->global_epoch)
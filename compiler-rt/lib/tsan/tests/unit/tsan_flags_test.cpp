@@ -46,6 +46,7 @@ static const char *options1 =
   " atexit_sleep_ms=222"
   " profile_memory=qqq"
   " flush_memory_ms=444"
+  " sample_memory_pages=8"
   " flush_symbolizer_ms=555"
   " memory_limit_mb=666"
   " stop_on_start=0"
@@ -70,6 +71,7 @@ static const char *options2 =
   " atexit_sleep_ms=123"
   " profile_memory=bbbbb"
   " flush_memory_ms=234"
+  " sample_memory_pages=1"
   " flush_symbolizer_ms=345"
   " memory_limit_mb=456"
   " stop_on_start=true"
@@ -94,6 +96,7 @@ void VerifyOptions1(Flags *f) {
   EXPECT_EQ(f->atexit_sleep_ms, 222);
   EXPECT_EQ(f->profile_memory, std::string("qqq"));
   EXPECT_EQ(f->flush_memory_ms, 444);
+  EXPECT_EQ(f->sample_memory_pages, 8);
   EXPECT_EQ(f->flush_symbolizer_ms, 555);
   EXPECT_EQ(f->memory_limit_mb, 666);
   EXPECT_EQ(f->stop_on_start, 0);
@@ -118,6 +121,7 @@ void VerifyOptions2(Flags *f) {
   EXPECT_EQ(f->atexit_sleep_ms, 123);
   EXPECT_EQ(f->profile_memory, std::string("bbbbb"));
   EXPECT_EQ(f->flush_memory_ms, 234);
+  EXPECT_EQ(f->sample_memory_pages, 1);
   EXPECT_EQ(f->flush_symbolizer_ms, 345);
   EXPECT_EQ(f->memory_limit_mb, 456);
   EXPECT_EQ(f->stop_on_start, true);
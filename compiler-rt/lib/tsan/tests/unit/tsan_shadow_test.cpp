@@ -176,4 +176,41 @@ struct MappingTest {
 
 TEST(Shadow, AllMappings) { ForEachMapping<MappingTest>(); }
 
+TEST(Shadow, SamplePages) {
+  ThreadState *thr = cur_thread();
+  const u32 mask = thr->sample_mask;
+  const u32 phase = atomic_load_relaxed(&thr->sample_phase);
+  const uptr kPageSize = 1 << kSamplePageSizeLog;
+  const uptr base = 0x7b0000000000ull;
+
+  // Without sampling, all pages are checked.
+  thr->sample_mask = 0;
+  for (uptr i = 0; i < 64; i++)
+    CHECK(!IsSampledOut(thr, base + i * kPageSize));
+
+  // With sampling, all the accesses to a page are either checked or not, and
+  // each phase checks a fair share of the pages.
+  thr->sample_mask = 7;
+  uptr sampled[8] = {};
+  for (uptr i = 0; i < 4096; i++) {
+    const uptr page = base + i * kPageSize;
+    const u32 hash = SamplePageHash(page, thr->sample_mask);
+    CHECK_LE(hash, 7);
+    CHECK_EQ(hash, SamplePageHash(page + kPageSize - 1, thr->sample_mask));
+    sampled[hash]++;
+    atomic_store_relaxed(&thr->sample_phase, hash);
+    CHECK(!IsSampledOut(thr, page));
+    CHECK(!IsSampledOut(thr, page + 8));
+    atomic_store_relaxed(&thr->sample_phase, (hash + 1) & 7);
+    CHECK(IsSampledOut(thr, page));
+  }
+  for (uptr i = 0; i < 8; i++) {
+    CHECK_GT(sampled[i], 4096 / 16);
+    CHECK_LT(sampled[i], 4096 / 4);
+  }
+
+  thr->sample_mask = mask;
+  atomic_store_relaxed(&thr->sample_phase, phase);
+}
+
 }  // namespace __tsan
@@ -230,5 +230,90 @@ TEST(BufferQueueTest, GenerationalSupportAcrossThreads) {
   ASSERT_EQ(Counter.load(std::memory_order_acquire), 0);
 }
 
+TEST(BufferQueueTest, ExclusiveOwnershipAcrossThreads) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 4, Success);
+  ASSERT_TRUE(Success);
+
+  // Each thread marks the buffers it holds; a buffer handed out to two threads
+  // at once would see the mark of the other thread.
+  std::atomic<bool> Clash{false};
+  auto F = [&](uint64_t Id) {
+    BufferQueue::Buffer B;
+    for (int I = 0; I < 20000; ++I) {
+      if (Buffers.getBuffer(B) != BufferQueue::ErrorCode::Ok)
+        continue;
+      auto *Mark = static_cast<std::atomic<uint64_t> *>(B.Data);
+      if (Mark->exchange(Id) != 0)
+        Clash = true;
+      if (Mark->exchange(0) != Id)
+        Clash = true;
+      ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+    }
+  };
+  std::thread T0(F, 1), T1(F, 2), T2(F, 3), T3(F, 4), T4(F, 5);
+  T0.join();
+  T1.join();
+  T2.join();
+  T3.join();
+  T4.join();
+  EXPECT_FALSE(Clash);
+
+  // All the buffers are available again.
+  BufferQueue::Buffer Bs[4];
+  for (auto &B : Bs)
+    ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+  BufferQueue::Buffer Extra;
+  EXPECT_EQ(Buffers.getBuffer(Extra), BufferQueue::ErrorCode::NotEnoughMemory);
+  for (auto &B : Bs)
+    ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+}
+
+TEST(BufferQueueTest, Streaming) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 2, Success, /*S=*/true);
+  ASSERT_TRUE(Success);
+  ASSERT_TRUE(Buffers.streaming());
+
+  BufferQueue::Buffer B0, B1, Consumed;
+  EXPECT_EQ(Buffers.getReleasedBuffer(Consumed),
+            BufferQueue::ErrorCode::NotEnoughMemory);
+  ASSERT_EQ(Buffers.getBuffer(B0), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.getBuffer(B1), BufferQueue::ErrorCode::Ok);
+  void *Data0 = B0.Data;
+  atomic_store(B0.Extents, 42, memory_order_release);
+  ASSERT_EQ(Buffers.releaseBuffer(B0), BufferQueue::ErrorCode::Ok);
+
+  // A released buffer is not handed out again until it was consumed.
+  BufferQueue::Buffer B2;
+  EXPECT_EQ(Buffers.getBuffer(B2), BufferQueue::ErrorCode::NotEnoughMemory);
+  ASSERT_EQ(Buffers.getReleasedBuffer(Consumed), BufferQueue::ErrorCode::Ok);
+  EXPECT_EQ(Consumed.Data, Data0);
+  EXPECT_EQ(atomic_load(Consumed.Extents, memory_order_acquire), 42u);
+  EXPECT_EQ(Buffers.getReleasedBuffer(B2),
+            BufferQueue::ErrorCode::NotEnoughMemory);
+  ASSERT_EQ(Buffers.recycleBuffer(Consumed), BufferQueue::ErrorCode::Ok);
+  EXPECT_EQ(Consumed.Data, nullptr);
+  ASSERT_EQ(Buffers.getBuffer(B2), BufferQueue::ErrorCode::Ok);
+  EXPECT_EQ(B2.Data, Data0);
+
+  // Only the buffers which are held or not consumed yet are "used".
+  ASSERT_EQ(Buffers.releaseBuffer(B2), BufferQueue::ErrorCode::Ok);
+  int Count = 0;
+  Buffers.apply([&](const BufferQueue::Buffer &B) { ++Count; });
+  EXPECT_EQ(Count, 2);
+  ASSERT_EQ(Buffers.getReleasedBuffer(Consumed), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.recycleBuffer(Consumed), BufferQueue::ErrorCode::Ok);
+  Count = 0;
+  Buffers.apply([&](const BufferQueue::Buffer &B) { ++Count; });
+  EXPECT_EQ(Count, 1);
+
+  // Released buffers can still be consumed after finalizing.
+  ASSERT_EQ(Buffers.finalize(), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.releaseBuffer(B1), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.getReleasedBuffer(Consumed), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.recycleBuffer(Consumed), BufferQueue::ErrorCode::Ok);
+}
+
 } // namespace
 } // namespace __xray
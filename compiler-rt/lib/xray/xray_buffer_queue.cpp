@@ -65,9 +65,93 @@ struct ExtentsPadded {
 
 constexpr size_t kExtentsSize = sizeof(ExtentsPadded);
 
+// The collocated rings and BufferRep instances of a generation, as laid out
+// in the RingsBackingStore.
+size_t ringsStoreSize(size_t Count) {
+  return sizeof(BufferQueue::Rings) +
+         2 * Count * sizeof(BufferQueue::IndexRing::Slot) +
+         Count * sizeof(BufferQueue::BufferRep);
+}
+
+BufferQueue::Rings *getRings(BufferQueue::ControlBlock *C) {
+  return reinterpret_cast<BufferQueue::Rings *>(&C->Data);
+}
+
+BufferQueue::IndexRing::Slot *getSlots(BufferQueue::ControlBlock *C) {
+  return reinterpret_cast<BufferQueue::IndexRing::Slot *>(getRings(C) + 1);
+}
+
+BufferQueue::BufferRep *getBufferReps(BufferQueue::ControlBlock *C,
+                                      size_t Count) {
+  return reinterpret_cast<BufferQueue::BufferRep *>(getSlots(C) + 2 * Count);
+}
+
 } // namespace
 
-BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
+void BufferQueue::IndexRing::init(Slot *S, size_t N, bool Full) {
+  Slots = S;
+  Count = N;
+  // A slot is ready to be written at position P when its sequence is P, and
+  // ready to be read at position P when its sequence is P + 1.
+  for (size_t I = 0; I < N; ++I) {
+    atomic_store(&Slots[I].Sequence, Full ? I + 1 : I, memory_order_relaxed);
+    Slots[I].Index = I;
+  }
+  atomic_store(&Head, 0, memory_order_relaxed);
+  atomic_store(&Tail, Full ? N : 0, memory_order_release);
+}
+
+bool BufferQueue::IndexRing::push(uint64_t Index) {
+  if (Count == 0)
+    return false;
+  u64 Pos = atomic_load(&Tail, memory_order_relaxed);
+  while (true) {
+    Slot &S = Slots[Pos % Count];
+    const uint64_t Sequence = atomic_load(&S.Sequence, memory_order_acquire);
+    const int64_t Diff = static_cast<int64_t>(Sequence - Pos);
+    if (Diff == 0) {
+      // On failure, Pos is updated to the current tail.
+      if (atomic_compare_exchange_weak(&Tail, &Pos, Pos + 1,
+                                       memory_order_relaxed)) {
+        S.Index = Index;
+        atomic_store(&S.Sequence, Pos + 1, memory_order_release);
+        return true;
+      }
+    } else if (Diff < 0) {
+      // The slot still holds the index pushed a lap before.
+      return false;
+    } else {
+      Pos = atomic_load(&Tail, memory_order_relaxed);
+    }
+  }
+}
+
+bool BufferQueue::IndexRing::pop(uint64_t &Index) {
+  if (Count == 0)
+    return false;
+  u64 Pos = atomic_load(&Head, memory_order_relaxed);
+  while (true) {
+    Slot &S = Slots[Pos % Count];
+    const uint64_t Sequence = atomic_load(&S.Sequence, memory_order_acquire);
+    const int64_t Diff = static_cast<int64_t>(Sequence - (Pos + 1));
+    if (Diff == 0) {
+      if (atomic_compare_exchange_weak(&Head, &Pos, Pos + 1,
+                                       memory_order_relaxed)) {
+        Index = S.Index;
+        // Make the slot ready to be written on the next lap.
+        atomic_store(&S.Sequence, Pos + Count, memory_order_release);
+        return true;
+      }
+    } else if (Diff < 0) {
+      // Nothing was pushed at this position yet.
+      return false;
+    } else {
+      Pos = atomic_load(&Head, memory_order_relaxed);
+    }
+  }
+}
+
+BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC, bool S) {
   SpinMutexLock Guard(&Mutex);
 
   if (!finalizing())
@@ -78,6 +162,7 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   bool Success = false;
   BufferSize = BS;
   BufferCount = BC;
+  Streaming = S;
 
   BackingStore = allocControlBlock(BufferSize, BufferCount);
   if (BackingStore == nullptr)
@@ -102,10 +187,22 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
     ExtentsBackingStore = nullptr;
   });
 
-  Buffers = initArray<BufferRep>(BufferCount);
-  if (Buffers == nullptr)
+  RingsBackingStore = allocControlBlock(ringsStoreSize(BufferCount), 1);
+  if (RingsBackingStore == nullptr)
     return BufferQueue::ErrorCode::NotEnoughMemory;
 
+  auto CleanupRingsBackingStore = at_scope_exit([&, this] {
+    if (Success)
+      return;
+    deallocControlBlock(RingsBackingStore, ringsStoreSize(BufferCount), 1);
+    RingsBackingStore = nullptr;
+    Queues = nullptr;
+    Buffers = nullptr;
+  });
+
+  Queues = getRings(RingsBackingStore);
+  Buffers = getBufferReps(RingsBackingStore, BufferCount);
+
   // At this point we increment the generation number to associate the buffers
   // to the new generation.
   atomic_fetch_add(&Generation, 1, memory_order_acq_rel);
@@ -114,12 +211,13 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   // being at the start of the BackingStore pointer.
   atomic_store(&BackingStore->RefCount, 1, memory_order_release);
   atomic_store(&ExtentsBackingStore->RefCount, 1, memory_order_release);
+  atomic_store(&RingsBackingStore->RefCount, 1, memory_order_release);
 
   // Then we initialise the individual buffers that sub-divide the whole backing
   // store. Each buffer will start at the `Data` member of the ControlBlock, and
   // will be offsets from these locations.
   for (size_t i = 0; i < BufferCount; ++i) {
-    auto &T = Buffers[i];
+    auto &T = *new (&Buffers[i]) BufferRep();
     auto &Buf = T.Buff;
     auto *E = reinterpret_cast<ExtentsPadded *>(&ExtentsBackingStore->Data +
                                                 (kExtentsSize * i));
@@ -130,91 +228,119 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
     Buf.Size = BufferSize;
     Buf.BackingStore = BackingStore;
     Buf.ExtentsBackingStore = ExtentsBackingStore;
+    Buf.RingsBackingStore = RingsBackingStore;
     Buf.Count = BufferCount;
     T.Used = false;
   }
 
-  Next = Buffers;
-  First = Buffers;
-  LiveBuffers = 0;
+  // All the buffers start out available, in order.
+  IndexRing::Slot *Slots = getSlots(RingsBackingStore);
+  Queues->Available.init(Slots, BufferCount, /*Full=*/true);
+  Queues->Released.init(Slots + BufferCount, BufferCount, /*Full=*/false);
+
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
 }
 
-BufferQueue::BufferQueue(size_t B, size_t N,
-                         bool &Success) XRAY_NEVER_INSTRUMENT
+BufferQueue::BufferQueue(size_t B, size_t N, bool &Success,
+                         bool S) XRAY_NEVER_INSTRUMENT
     : BufferSize(B),
       BufferCount(N),
       Mutex(),
       Finalizing{1},
+      Streaming(S),
       BackingStore(nullptr),
       ExtentsBackingStore(nullptr),
+      RingsBackingStore(nullptr),
+      Queues(nullptr),
       Buffers(nullptr),
-      Next(Buffers),
-      First(Buffers),
-      LiveBuffers(0),
       Generation{0} {
-  Success = init(B, N) == BufferQueue::ErrorCode::Ok;
+  Success = init(B, N, S) == BufferQueue::ErrorCode::Ok;
+}
+
+void BufferQueue::handOutBuffer(uint64_t Index, Buffer &Buf) {
+  incRefCount(BackingStore);
+  incRefCount(ExtentsBackingStore);
+  incRefCount(RingsBackingStore);
+  BufferRep &B = Buffers[Index];
+  Buf = B.Buff;
+  Buf.Generation = generation();
+  B.Used = true;
 }
 
 BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   if (atomic_load(&Finalizing, memory_order_acquire))
     return ErrorCode::QueueFinalizing;
 
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
-      return ErrorCode::NotEnoughMemory;
-    B = Next++;
-    if (Next == (Buffers + BufferCount))
-      Next = Buffers;
-    ++LiveBuffers;
-  }
-
-  incRefCount(BackingStore);
-  incRefCount(ExtentsBackingStore);
-  Buf = B->Buff;
-  Buf.Generation = generation();
-  B->Used = true;
+  uint64_t Index;
+  if (!Queues->Available.pop(Index))
+    return ErrorCode::NotEnoughMemory;
+  handOutBuffer(Index, Buf);
   return ErrorCode::Ok;
 }
 
-BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
-  // Check whether the buffer being referred to is within the bounds of the
-  // backing store's range.
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (Buf.Generation != generation() || LiveBuffers == 0) {
-      Buf = {};
-      decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
-      decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-      return BufferQueue::ErrorCode::Ok;
-    }
+BufferQueue::ErrorCode BufferQueue::getReleasedBuffer(Buffer &Buf) {
+  if (!Streaming || Queues == nullptr)
+    return ErrorCode::NotEnoughMemory;
+
+  uint64_t Index;
+  if (!Queues->Released.pop(Index))
+    return ErrorCode::NotEnoughMemory;
+  handOutBuffer(Index, Buf);
+  return ErrorCode::Ok;
+}
 
-    if (Buf.Data < &BackingStore->Data ||
-        Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
-      return BufferQueue::ErrorCode::UnrecognizedBuffer;
+BufferQueue::ErrorCode BufferQueue::returnBuffer(Buffer &Buf,
+                                                 IndexRing Rings::*Ring,
+                                                 bool Used) {
+  auto DropReferences = [&Buf] {
+    decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
+    decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
+    decRefCount(Buf.RingsBackingStore, ringsStoreSize(Buf.Count), 1);
+    Buf = {};
+  };
 
-    --LiveBuffers;
-    B = First++;
-    if (First == (Buffers + BufferCount))
-      First = Buffers;
+  if (Buf.Generation != generation()) {
+    DropReferences();
+    return BufferQueue::ErrorCode::Ok;
   }
 
-  // Now that the buffer has been released, we mark it as "used".
-  B->Buff = Buf;
-  B->Used = true;
-  decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
-  decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-  atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
-               memory_order_release);
-  Buf = {};
+  // Check whether the buffer being referred to is within the bounds of the
+  // backing store's range. The buffer goes back to the rings of the generation
+  // it was handed out from, which it holds a reference to, so that we don't
+  // race with a re-initialization of the queue.
+  if (Buf.BackingStore == nullptr || Buf.RingsBackingStore == nullptr ||
+      Buf.Size == 0)
+    return BufferQueue::ErrorCode::UnrecognizedBuffer;
+  const char *Base = Buf.BackingStore->Data;
+  const char *Data = static_cast<const char *>(Buf.Data);
+  if (Data < Base || Data >= Base + (Buf.Count * Buf.Size) ||
+      (Data - Base) % Buf.Size != 0)
+    return BufferQueue::ErrorCode::UnrecognizedBuffer;
+
+  const uint64_t Index = (Data - Base) / Buf.Size;
+  getBufferReps(Buf.RingsBackingStore, Buf.Count)[Index].Used = Used;
+  // There is a slot for every buffer in each ring, so this never fails.
+  bool Pushed = (getRings(Buf.RingsBackingStore)->*Ring).push(Index);
+  DCHECK(Pushed);
+  (void)Pushed;
+  DropReferences();
   return ErrorCode::Ok;
 }
 
+BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
+  // Now that the buffer has been released, we mark it as "used". In streaming
+  // mode, it becomes available again once consumed.
+  return returnBuffer(Buf, Streaming ? &Rings::Released : &Rings::Available,
+                      /*Used=*/true);
+}
+
+BufferQueue::ErrorCode BufferQueue::recycleBuffer(Buffer &Buf) {
+  // The contents of the buffer were exported, so they are not "used" anymore.
+  return returnBuffer(Buf, &Rings::Available, /*Used=*/false);
+}
+
 BufferQueue::ErrorCode BufferQueue::finalize() {
   if (atomic_exchange(&Finalizing, 1, memory_order_acq_rel))
     return ErrorCode::QueueFinalizing;
@@ -222,13 +348,15 @@ BufferQueue::ErrorCode BufferQueue::finalize() {
 }
 
 void BufferQueue::cleanupBuffers() {
-  for (auto B = Buffers, E = Buffers + BufferCount; B != E; ++B)
-    B->~BufferRep();
-  deallocateBuffer(Buffers, BufferCount);
+  // The BufferRep instances are trivially destructible, and live in the
+  // RingsBackingStore.
   decRefCount(BackingStore, BufferSize, BufferCount);
   decRefCount(ExtentsBackingStore, kExtentsSize, BufferCount);
+  decRefCount(RingsBackingStore, ringsStoreSize(BufferCount), 1);
   BackingStore = nullptr;
   ExtentsBackingStore = nullptr;
+  RingsBackingStore = nullptr;
+  Queues = nullptr;
   Buffers = nullptr;
   BufferCount = 0;
   BufferSize = 0;
@@ -28,6 +28,12 @@ namespace __xray {
 /// get from or return buffers to the queue. This is one key component of the
 /// "flight data recorder" (FDR) mode to support ongoing XRay function call
 /// trace collection.
+///
+/// Getting and returning buffers is lock-free, so that threads only contend on
+/// a single compare-and-swap when they switch buffers. In streaming mode, the
+/// released buffers are only handed out again once a consumer exported them,
+/// instead of being overwritten by the oldest-first recycling of the flight
+/// data recorder.
 class BufferQueue {
 public:
   /// ControlBlock represents the memory layout of how we interpret the backing
@@ -61,6 +67,7 @@ public:
     friend class BufferQueue;
     ControlBlock *BackingStore = nullptr;
     ControlBlock *ExtentsBackingStore = nullptr;
+    ControlBlock *RingsBackingStore = nullptr;
     size_t Count = 0;
   };
 
@@ -73,6 +80,47 @@ public:
     bool Used = false;
   };
 
+  /// IndexRing is a bounded multi-producer multi-consumer queue of buffer
+  /// indices, following Dmitry Vyukov's design: each slot carries a sequence
+  /// number which tells whether it is ready to be written or read for a given
+  /// position, so that producers and consumers only need a compare-and-swap on
+  /// the tail or on the head respectively.
+  struct IndexRing {
+    struct Slot {
+      atomic_uint64_t Sequence;
+      uint64_t Index;
+    };
+
+    Slot *Slots;
+    size_t Count;
+
+    union {
+      atomic_uint64_t Head;
+      char HeadStorage[kCacheLineSize];
+    };
+    union {
+      atomic_uint64_t Tail;
+      char TailStorage[kCacheLineSize];
+    };
+
+    /// Initializes the ring to hold up to |N| indices in |S|, starting with all
+    /// the indices in [0, N) when |Full| is true.
+    void init(Slot *S, size_t N, bool Full);
+
+    /// Returns false when the ring is full.
+    bool push(uint64_t Index);
+
+    /// Returns false when the ring is empty.
+    bool pop(uint64_t &Index);
+  };
+
+  /// The indices of the buffers which can be handed out, and in streaming mode,
+  /// the indices of the released buffers waiting to be exported.
+  struct Rings {
+    IndexRing Available;
+    IndexRing Released;
+  };
+
 private:
   // This models a ForwardIterator. |T| Must be either a `Buffer` or `const
   // Buffer`. Note that we only advance to the "used" buffers, when
@@ -137,27 +185,32 @@ private:
   // Amount of pre-allocated buffers.
   size_t BufferCount;
 
+  // Serializes the (re-)initialization of the queue with the iteration over its
+  // buffers. Getting and returning buffers doesn't take the lock.
   SpinMutex Mutex;
   atomic_uint8_t Finalizing;
 
+  // Whether released buffers go through the Released ring before being handed
+  // out again.
+  bool Streaming;
+
   // The collocated ControlBlock and buffer storage.
   ControlBlock *BackingStore;
 
   // The collocated ControlBlock and extents storage.
   ControlBlock *ExtentsBackingStore;
 
-  // A dynamically allocated array of BufferRep instances.
-  BufferRep *Buffers;
-
-  // Pointer to the next buffer to be handed out.
-  BufferRep *Next;
+  // The collocated ControlBlock, rings and BufferRep instances. Buffers keep a
+  // reference to it, as returning a buffer goes through the rings of its own
+  // generation.
+  ControlBlock *RingsBackingStore;
 
-  // Pointer to the entry in the array where the next released buffer will be
-  // placed.
-  BufferRep *First;
+  // The rings within RingsBackingStore.
+  Rings *Queues;
 
-  // Count of buffers that have been handed out through 'getBuffer'.
-  size_t LiveBuffers;
+  // The array of BufferRep instances within RingsBackingStore, indexed by the
+  // position of the buffers in the BackingStore.
+  BufferRep *Buffers;
 
   // We use a generation number to identify buffers and which generation they're
   // associated with.
@@ -166,6 +219,9 @@ private:
   /// Releases references to the buffers backed by the current buffer queue.
   void cleanupBuffers();
 
+  /// Hands out the buffer at |Index|, taking references to its backing stores.
+  void handOutBuffer(uint64_t Index, Buffer &Buf);
+
 public:
   enum class ErrorCode : unsigned {
     Ok,
@@ -194,9 +250,9 @@ public:
     return "unknown error";
   }
 
-  /// Initialise a queue of size |N| with buffers of size |B|. We report success
-  /// through |Success|.
-  BufferQueue(size_t B, size_t N, bool &Success);
+  /// Initialise a queue of size |N| with buffers of size |B|, in streaming mode
+  /// when |S| is true. We report success through |Success|.
+  BufferQueue(size_t B, size_t N, bool &Success, bool S = false);
 
   /// Updates |Buf| to contain the pointer to an appropriate buffer. Returns an
   /// error in case there are no available buffers to return when we will run
@@ -221,13 +277,36 @@ public:
   ErrorCode releaseBuffer(Buffer &Buf);
 
   /// Initializes the buffer queue, starting a new generation. We can re-set the
-  /// size of buffers with |BS| along with the buffer count with |BC|.
+  /// size of buffers with |BS| along with the buffer count with |BC|, and
+  /// whether the queue is in streaming mode with |S|.
   ///
   /// Returns:
   ///   - ErrorCode::Ok when we successfully initialize the buffer. This
   ///   requires that the buffer queue is previously finalized.
   ///   - ErrorCode::AlreadyInitialized when the buffer queue is not finalized.
-  ErrorCode init(size_t BS, size_t BC);
+  ErrorCode init(size_t BS, size_t BC, bool S = false);
+
+  /// In streaming mode, updates |Buf| to the buffer released the earliest among
+  /// the ones which haven't been consumed yet. The consumer exports the first
+  /// `*Buf.Extents` bytes of the buffer, then gives it back with
+  /// recycleBuffer(...).
+  ///
+  /// Returns:
+  ///   - ErrorCode::Ok when we find a released Buffer.
+  ///   - ErrorCode::NotEnoughMemory when there is no released Buffer to
+  ///     consume.
+  ErrorCode getReleasedBuffer(Buffer &Buf);
+
+  /// Makes |Buf|, obtained through getReleasedBuffer(...), available to be
+  /// handed out again, and updates |Buf| to point to nullptr, with size 0.
+  ///
+  /// Returns:
+  ///   - ErrorCode::Ok when we successfully recycle the buffer.
+  ///   - ErrorCode::UnrecognizedBuffer for when this BufferQueue does not own
+  ///     the buffer being recycled.
+  ErrorCode recycleBuffer(Buffer &Buf);
+
+  bool streaming() const { return Streaming; }
 
   bool finalizing() const {
     return atomic_load(&Finalizing, memory_order_acquire);
@@ -273,6 +352,11 @@ public:
 
   // Cleans up allocated buffers.
   ~BufferQueue();
+
+private:
+  /// Returns |Buf| to the |Ring| of its generation, marking it as |Used|, and
+  /// drops the references |Buf| holds to the backing stores.
+  ErrorCode returnBuffer(Buffer &Buf, IndexRing Rings::*Ring, bool Used);
 };
 
 } // namespace __xray
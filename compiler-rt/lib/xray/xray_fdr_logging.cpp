@@ -89,6 +89,12 @@ static atomic_uint64_t TicksPerSec{0};
 static atomic_sint32_t LogFlushStatus = {
     XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING};
 
+// In streaming mode, the log which the streamer thread writes the buffers
+// released by the threads to, while logging.
+static LogWriter *StreamWriter = nullptr;
+static void *StreamerThread = nullptr;
+static atomic_uint8_t StreamerRunning{0};
+
 // This function will initialize the thread-local data structure used by the FDR
 // logging implementation and return a reference to it. The implementation
 // details require a bit of care to maintain.
@@ -275,6 +281,91 @@ XRayBuffer fdrIterator(const XRayBuffer B) {
   return Result;
 }
 
+// Starting at version 2 of the FDR logging implementation, we only write the
+// records identified by the extents of the buffer. We use the Extents from the
+// Buffer and write that out as the first record in the buffer. We still use a
+// Metadata record, but fill in the extents instead for the data.
+static void writeBuffer(LogWriter *LW,
+                        const BufferQueue::Buffer &B) XRAY_NEVER_INSTRUMENT {
+  MetadataRecord ExtentsRecord;
+  auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
+  DCHECK(BufferExtents <= B.Size);
+  ExtentsRecord.Type = uint8_t(RecordType::Metadata);
+  ExtentsRecord.RecordKind =
+      uint8_t(MetadataRecord::RecordKinds::BufferExtents);
+  internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
+  if (BufferExtents > 0) {
+    LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
+                 reinterpret_cast<char *>(&ExtentsRecord) +
+                     sizeof(MetadataRecord));
+    LW->WriteAll(reinterpret_cast<char *>(B.Data),
+                 reinterpret_cast<char *>(B.Data) + BufferExtents);
+  }
+}
+
+// Writes the buffers released since the last call to the streaming log, then
+// makes them available to the threads again.
+static void streamReleasedBuffers() XRAY_NEVER_INSTRUMENT {
+  BufferQueue::Buffer B;
+  while (BQ->getReleasedBuffer(B) == BufferQueue::ErrorCode::Ok) {
+    writeBuffer(StreamWriter, B);
+    BQ->recycleBuffer(B); // ignore result.
+  }
+}
+
+static void *streamerThread(void *) XRAY_NEVER_INSTRUMENT {
+  while (atomic_load(&StreamerRunning, memory_order_acquire)) {
+    streamReleasedBuffers();
+    SleepForMillis(fdrFlags()->streaming_interval_ms);
+  }
+  return nullptr;
+}
+
+// Opens the streaming log and writes its header. The buffers are written as
+// they get released, in the same format as when flushing, so that the tools
+// can read the log once complete, or as it is written through a named pipe.
+static bool openStreamWriter(size_t BufferSize) XRAY_NEVER_INSTRUMENT {
+#if SANITIZER_FUCHSIA
+  Report("XRay FDR: Streaming mode is not supported on Fuchsia.\n");
+  return false;
+#else
+  const char *Path = fdrFlags()->streaming_path;
+  StreamWriter = Path[0] != '\0' ? LogWriter::Open(Path) : LogWriter::Open();
+  if (StreamWriter == nullptr)
+    return false;
+
+  XRayFileHeader Header = fdrCommonHeaderInfo();
+  Header.FdrData = FdrAdditionalHeaderData{BufferSize};
+  StreamWriter->WriteAll(reinterpret_cast<char *>(&Header),
+                         reinterpret_cast<char *>(&Header) + sizeof(Header));
+  return true;
+#endif
+}
+
+static bool startStreamerThread() XRAY_NEVER_INSTRUMENT {
+  atomic_store(&StreamerRunning, 1, memory_order_release);
+  StreamerThread = internal_start_thread(streamerThread, nullptr);
+  if (StreamerThread != nullptr)
+    return true;
+  atomic_store(&StreamerRunning, 0, memory_order_release);
+  LogWriter::Close(StreamWriter);
+  StreamWriter = nullptr;
+  return false;
+}
+
+// Stops the streamer thread, then writes the buffers it didn't get to, and the
+// ones still held by threads, before closing the streaming log.
+static void stopStreaming() XRAY_NEVER_INSTRUMENT {
+  atomic_store(&StreamerRunning, 0, memory_order_release);
+  internal_join_thread(StreamerThread);
+  StreamerThread = nullptr;
+  streamReleasedBuffers();
+  BQ->apply([](const BufferQueue::Buffer &B) { writeBuffer(StreamWriter, B); });
+  StreamWriter->Flush();
+  LogWriter::Close(StreamWriter);
+  StreamWriter = nullptr;
+}
+
 // Must finalize before flushing.
 XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (atomic_load(&LoggingStatus, memory_order_acquire) !=
@@ -319,6 +410,17 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
       TLD.Controller->flush();
   });
 
+  // In streaming mode, most of the log was written already.
+  if (StreamWriter != nullptr) {
+    auto &TLD = getThreadLocalData();
+    if (TLD.Controller != nullptr)
+      TLD.Controller->flush();
+    stopStreaming();
+    atomic_store(&LogFlushStatus, XRayLogFlushStatus::XRAY_LOG_FLUSHED,
+                 memory_order_release);
+    return XRayLogFlushStatus::XRAY_LOG_FLUSHED;
+  }
+
   if (fdrFlags()->no_file_flush) {
     if (Verbosity())
       Report("XRay FDR: Not flushing to file, 'no_file_flush=true'.\n");
@@ -356,27 +458,7 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (TLD.Controller != nullptr)
     TLD.Controller->flush();
 
-  BQ->apply([&](const BufferQueue::Buffer &B) {
-    // Starting at version 2 of the FDR logging implementation, we only write
-    // the records identified by the extents of the buffer. We use the Extents
-    // from the Buffer and write that out as the first record in the buffer.  We
-    // still use a Metadata record, but fill in the extents instead for the
-    // data.
-    MetadataRecord ExtentsRecord;
-    auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
-    DCHECK(BufferExtents <= B.Size);
-    ExtentsRecord.Type = uint8_t(RecordType::Metadata);
-    ExtentsRecord.RecordKind =
-        uint8_t(MetadataRecord::RecordKinds::BufferExtents);
-    internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
-    if (BufferExtents > 0) {
-      LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
-                   reinterpret_cast<char *>(&ExtentsRecord) +
-                       sizeof(MetadataRecord));
-      LW->WriteAll(reinterpret_cast<char *>(B.Data),
-                   reinterpret_cast<char *>(B.Data) + BufferExtents);
-    }
-  });
+  BQ->apply([&](const BufferQueue::Buffer &B) { writeBuffer(LW, B); });
 
   atomic_store(&LogFlushStatus, XRayLogFlushStatus::XRAY_LOG_FLUSHED,
                memory_order_release);
@@ -660,22 +742,43 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
   auto BufferSize = FDRFlags.buffer_size;
   auto BufferMax = FDRFlags.buffer_max;
 
+  // Streaming requires the log to be open before the buffers get released.
+  bool Streaming = false;
+  if (FDRFlags.streaming) {
+    if (FDRFlags.no_file_flush)
+      Report("XRay FDR: Not streaming, 'no_file_flush=true'.\n");
+    else
+      Streaming = openStreamWriter(BufferSize);
+  }
+
   if (BQ == nullptr) {
     bool Success = false;
     BQ = reinterpret_cast<BufferQueue *>(&BufferQueueStorage);
-    new (BQ) BufferQueue(BufferSize, BufferMax, Success);
+    new (BQ) BufferQueue(BufferSize, BufferMax, Success, Streaming);
     if (!Success) {
       Report("BufferQueue init failed.\n");
       return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
     }
   } else {
-    if (BQ->init(BufferSize, BufferMax) != BufferQueue::ErrorCode::Ok) {
+    if (BQ->init(BufferSize, BufferMax, Streaming) !=
+        BufferQueue::ErrorCode::Ok) {
       if (Verbosity())
         Report("Failed to re-initialize global buffer queue. Init failed.\n");
       return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
     }
   }
 
+  // No thread got a buffer yet, so we can still fall back to writing the log
+  // when flushing.
+  if (Streaming && !startStreamerThread()) {
+    Report("XRay FDR: Failed to start the streamer thread; not streaming.\n");
+    BQ->finalize();
+    if (BQ->init(BufferSize, BufferMax) != BufferQueue::ErrorCode::Ok) {
+      Report("Failed to re-initialize global buffer queue. Init failed.\n");
+      return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
+    }
+  }
+
   static pthread_once_t OnceInit = PTHREAD_ONCE_INIT;
   pthread_once(
       &OnceInit, +[] {
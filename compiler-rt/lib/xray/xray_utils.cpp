@@ -191,6 +191,23 @@ LogWriter *LogWriter::Open() XRAY_NEVER_INSTRUMENT {
   return LW;
 }
 
+LogWriter *LogWriter::Open(const char *Filename) XRAY_NEVER_INSTRUMENT {
+  // Opening an existing named pipe for writing blocks until a reader opens it,
+  // which lets the reader consume the log as it is being written.
+  int Fd = open(Filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (Fd == -1) {
+    Report("XRay: Failed opening file '%s'; errno = %d; not logging events.\n",
+           Filename, errno);
+    return nullptr;
+  }
+  if (Verbosity())
+    Report("XRay: Log file in '%s'\n", Filename);
+
+  LogWriter *LW = allocate<LogWriter>();
+  new (LW) LogWriter(Fd);
+  return LW;
+}
+
 void LogWriter::Close(LogWriter *LW) {
   LW->~LogWriter();
   deallocate(LW);
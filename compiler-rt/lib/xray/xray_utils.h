@@ -42,6 +42,10 @@ public:
 
  // Returns a new log instance initialized using the flag-provided values.
  static LogWriter *Open();
+#if !SANITIZER_FUCHSIA
+ // Returns a new log instance writing to |Filename|, which may be a named pipe.
+ static LogWriter *Open(const char *Filename);
+#endif
  // Closes and deallocates the log instance.
  static void Close(LogWriter *LogWriter);
 
@@ -8,6 +8,7 @@
 
 #include "terminator.h"
 #include "tools.h"
+#include "flang/Runtime/c-or-cpp.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
 #include "flang/Runtime/reduction.h"
@@ -47,6 +48,35 @@ private:
   Result sum_{};
 };
 
+// Contiguous numeric vectors.  The products are added into several
+// partial sums, which do not depend on each other, so that the additions
+// can overlap and be vectorized.
+template <TypeCategory RCAT, typename AccumType, typename XT, typename YT>
+static inline AccumType ContiguousDotProduct(
+    const XT *RESTRICT xp, const YT *RESTRICT yp, SubscriptValue n) {
+  constexpr SubscriptValue partialSums{4};
+  auto product{[&](SubscriptValue j) {
+    if constexpr (RCAT == TypeCategory::Complex) {
+      return std::conj(static_cast<AccumType>(xp[j])) *
+          static_cast<AccumType>(yp[j]);
+    } else {
+      return static_cast<AccumType>(xp[j]) * static_cast<AccumType>(yp[j]);
+    }
+  }};
+  AccumType accum[partialSums]{};
+  SubscriptValue j{0};
+  for (; j + partialSums <= n; j += partialSums) {
+    accum[0] += product(j);
+    accum[1] += product(j + 1);
+    accum[2] += product(j + 2);
+    accum[3] += product(j + 3);
+  }
+  for (; j < n; ++j) {
+    accum[0] += product(j);
+  }
+  return (accum[0] + accum[1]) + (accum[2] + accum[3]);
+}
+
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 static inline CppTypeFor<RCAT, RKIND> DoDotProduct(
     const Descriptor &x, const Descriptor &y, Terminator &terminator) {
@@ -74,22 +104,9 @@ static inline CppTypeFor<RCAT, RKIND> DoDotProduct(
           // TODO: call BLAS-1 ZDOTC
         }
       }
-      XT *xp{x.OffsetElement<XT>(0)};
-      YT *yp{y.OffsetElement<YT>(0)};
-      using AccumType = AccumulationType<RCAT, RKIND>;
-      AccumType accum{};
-      if constexpr (RCAT == TypeCategory::Complex) {
-        for (SubscriptValue j{0}; j < n; ++j) {
-          accum += std::conj(static_cast<AccumType>(*xp++)) *
-              static_cast<AccumType>(*yp++);
-        }
-      } else {
-        for (SubscriptValue j{0}; j < n; ++j) {
-          accum +=
-              static_cast<AccumType>(*xp++) * static_cast<AccumType>(*yp++);
-        }
-      }
-      return static_cast<Result>(accum);
+      return static_cast<Result>(
+          ContiguousDotProduct<RCAT, AccumulationType<RCAT, RKIND>>(
+              x.OffsetElement<XT>(0), y.OffsetElement<YT>(0), n));
     }
   }
   // Non-contiguous, heterogeneous, & LOGICAL cases
@@ -9,9 +9,17 @@
 #include "edit-output.h"
 #include "flang/Common/uint128.h"
 #include <algorithm>
+#include <cstring>
 
 namespace Fortran::runtime::io {
 
+// "00" to "99", for converting integers two decimal digits at a time
+static constexpr char decimalDigitPairs[]{
+    "0001020304050607080910111213141516171819202122232425262728293031"
+    "3233343536373839404142434445464748495051525354555657585960616263"
+    "6465666768697071727374757677787980818283848586878889909192939495"
+    "96979899"};
+
 template <int KIND>
 bool EditIntegerOutput(IoStatementState &io, const DataEdit &edit,
     common::HostSignedIntType<8 * KIND> n) {
@@ -30,11 +38,21 @@ bool EditIntegerOutput(IoStatementState &io, const DataEdit &edit,
     if (isNegative || (edit.modes.editingFlags & signPlus)) {
       signChars = 1; // '-' or '+'
     }
-    while (un > 0) {
-      auto quotient{un / 10u};
-      *--p = '0' + static_cast<int>(un - Unsigned{10} * quotient);
+    // Two digits per division
+    while (un >= 100u) {
+      auto quotient{un / 100u};
+      p -= 2;
+      std::memcpy(p,
+          &decimalDigitPairs[2 * static_cast<int>(un - Unsigned{100} * quotient)],
+          2);
       un = quotient;
     }
+    if (un >= 10u) {
+      p -= 2;
+      std::memcpy(p, &decimalDigitPairs[2 * static_cast<int>(un)], 2);
+    } else if (un > 0) {
+      *--p = '0' + static_cast<int>(un);
+    }
     break;
   case 'B':
     for (; un > 0; un >>= 1) {
@@ -90,6 +108,17 @@ bool EditIntegerOutput(IoStatementState &io, const DataEdit &edit,
     }
     leadingSpaces = 1;
   }
+  if (leadingSpaces + signChars + leadingZeroes <= p - buffer) {
+    // Usually the whole field fits in the buffer and is emitted at once.
+    p -= leadingZeroes;
+    std::memset(p, '0', leadingZeroes);
+    if (signChars) {
+      *--p = n < 0 ? '-' : '+';
+    }
+    p -= leadingSpaces;
+    std::memset(p, ' ', leadingSpaces);
+    return io.Emit(p, end - p);
+  }
   return io.EmitRepeated(' ', leadingSpaces) &&
       io.Emit(n < 0 ? "-" : "+", signChars) &&
       io.EmitRepeated('0', leadingZeroes) && io.Emit(p, digits);
@@ -323,6 +323,30 @@ public:
   template <typename A> bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  // Several independent extrema, combined at the end, with the same
+  // comparisons as Accumulate() so that NaNs are skipped in the same way.
+  template <typename A>
+  void AccumulateContiguous(const A *RESTRICT p, std::size_t n) {
+    constexpr std::size_t lanes{4};
+    Type extremum[lanes]{extremum_, extremum_, extremum_, extremum_};
+    std::size_t j{0};
+    for (; j + lanes <= n; j += lanes) {
+      for (std::size_t k{0}; k < lanes; ++k) {
+        Type x{p[j + k]};
+        if constexpr (IS_MAXVAL) {
+          extremum[k] = x > extremum[k] ? x : extremum[k];
+        } else {
+          extremum[k] = x < extremum[k] ? x : extremum[k];
+        }
+      }
+    }
+    for (std::size_t k{0}; k < lanes; ++k) {
+      Accumulate(extremum[k]);
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+  }
 
 private:
   const Descriptor &array_;
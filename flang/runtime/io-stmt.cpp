@@ -480,12 +480,20 @@ ExternalFileUnit *IoStatementState::GetExternalFileUnit() const {
 }
 
 bool IoStatementState::EmitRepeated(char ch, std::size_t n) {
+  if (n == 0) {
+    return true;
+  }
+  // Emit in chunks, since each Emit() checks and updates the record.
+  char chunk[64];
+  std::memset(chunk, ch, std::min(n, sizeof chunk));
   return std::visit(
-      [=](auto &x) {
-        for (std::size_t j{0}; j < n; ++j) {
-          if (!x.get().Emit(&ch, 1)) {
+      [&](auto &x) {
+        while (n > 0) {
+          std::size_t bytes{std::min(n, sizeof chunk)};
+          if (!x.get().Emit(chunk, bytes)) {
             return false;
           }
+          n -= bytes;
         }
         return true;
       },
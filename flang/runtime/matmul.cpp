@@ -25,6 +25,7 @@
 #include "flang/Runtime/c-or-cpp.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <algorithm>
 #include <cstring>
 
 namespace Fortran::runtime {
@@ -52,6 +53,48 @@ private:
   Result sum_{};
 };
 
+// The contiguous kernels below traverse their operands in blocks that fit
+// in the caches, and update each result element with several products at a
+// time to save loads and stores.  They add the products to each element
+// in the same order as the straightforward algorithms, so blocking does
+// not change the rounding of the results.  The unit-stride inner loops are
+// left to the compiler to vectorize.
+
+// The number of terms added to a result element by each pass.
+static constexpr SubscriptValue matmulUnroll{4};
+// A block of the columns of X, and its rows of Y, which are reused for
+// all of the columns of the result.
+static constexpr SubscriptValue matmulKBlock{64};
+// The number of bytes of a column of X in a block, which with matmulKBlock
+// sizes the block of X to fit in a second level cache.
+static constexpr std::size_t matmulRowBlockBytes{4096};
+
+// Adds X(I,K:K+TERMS-1)*Y(K:K+TERMS-1) to RES(I) for every I in [0, ROWS),
+// adding the terms in order; X has a leading dimension of LDX.
+template <int TERMS, typename ResultType, typename XT, typename YV>
+inline void AddColumnProducts(ResultType *RESTRICT product,
+    SubscriptValue rows, const XT *RESTRICT x, SubscriptValue ldx,
+    const YV &yv) {
+  if constexpr (TERMS == 1) {
+    for (SubscriptValue i{0}; i < rows; ++i) {
+      product[i] += static_cast<ResultType>(x[i]) * yv[0];
+    }
+  } else {
+    static_assert(TERMS == matmulUnroll);
+    const XT *RESTRICT x1{x + ldx};
+    const XT *RESTRICT x2{x1 + ldx};
+    const XT *RESTRICT x3{x2 + ldx};
+    for (SubscriptValue i{0}; i < rows; ++i) {
+      ResultType p{product[i]};
+      p += static_cast<ResultType>(x[i]) * yv[0];
+      p += static_cast<ResultType>(x1[i]) * yv[1];
+      p += static_cast<ResultType>(x2[i]) * yv[2];
+      p += static_cast<ResultType>(x3[i]) * yv[3];
+      product[i] = p;
+    }
+  }
+}
+
 // Contiguous numeric matrix*matrix multiplication
 //   matrix(rows,n) * matrix(n,cols) -> matrix(rows,cols)
 // Straightforward algorithm:
@@ -61,31 +104,48 @@ private:
 //     DO 1 K = 1, N
 //   1  RES(I,J) = RES(I,J) + X(I,K)*Y(K,J)
 // With loop distribution and transposition to avoid the inner sum
-// reduction and to avoid non-unit strides:
+// reduction and to avoid non-unit strides, and blocking of K and I so
+// that a block of X stays in the cache while it is used for every
+// column of the result:
 //   DO 1 I = 1, NROWS
 //    DO 1 J = 1, NCOLS
 //   1 RES(I,J) = 0
-//   DO 2 K = 1, N
-//    DO 2 J = 1, NCOLS
-//     DO 2 I = 1, NROWS
-//   2  RES(I,J) = RES(I,J) + X(I,K)*Y(K,J) ! loop-invariant last term
+//   DO 2 KB = 1, N, KBLOCK
+//    DO 2 IB = 1, NROWS, IBLOCK
+//     DO 2 J = 1, NCOLS
+//      DO 2 K = KB, MIN(N, KB+KBLOCK-1)
+//       DO 2 I = IB, MIN(NROWS, IB+IBLOCK-1)
+//   2    RES(I,J) = RES(I,J) + X(I,K)*Y(K,J) ! loop-invariant last term
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 inline void MatrixTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
     SubscriptValue rows, SubscriptValue cols, const XT *RESTRICT x,
     const YT *RESTRICT y, SubscriptValue n) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
+  constexpr SubscriptValue rowBlock{static_cast<SubscriptValue>(
+      matmulRowBlockBytes / std::max(sizeof(XT), sizeof(ResultType)))};
   std::memset(product, 0, rows * cols * sizeof *product);
-  const XT *RESTRICT xp0{x};
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    for (SubscriptValue j{0}; j < cols; ++j) {
-      const XT *RESTRICT xp{xp0};
-      auto yv{static_cast<ResultType>(y[k + j * n])};
-      for (SubscriptValue i{0}; i < rows; ++i) {
-        *p++ += static_cast<ResultType>(*xp++) * yv;
+  for (SubscriptValue kb{0}; kb < n; kb += matmulKBlock) {
+    SubscriptValue kEnd{std::min(n, kb + matmulKBlock)};
+    for (SubscriptValue ib{0}; ib < rows; ib += rowBlock) {
+      SubscriptValue iRows{std::min(rows - ib, rowBlock)};
+      for (SubscriptValue j{0}; j < cols; ++j) {
+        ResultType *RESTRICT p{product + j * rows + ib};
+        const YT *RESTRICT yp{y + j * n};
+        SubscriptValue k{kb};
+        for (; k + matmulUnroll <= kEnd; k += matmulUnroll) {
+          ResultType yv[matmulUnroll]{static_cast<ResultType>(yp[k]),
+              static_cast<ResultType>(yp[k + 1]),
+              static_cast<ResultType>(yp[k + 2]),
+              static_cast<ResultType>(yp[k + 3])};
+          AddColumnProducts<matmulUnroll>(
+              p, iRows, x + k * rows + ib, rows, yv);
+        }
+        for (; k < kEnd; ++k) {
+          ResultType yv[1]{static_cast<ResultType>(yp[k])};
+          AddColumnProducts<1>(p, iRows, x + k * rows + ib, rows, yv);
+        }
       }
     }
-    xp0 += rows;
   }
 }
 
@@ -109,12 +169,16 @@ inline void MatrixTimesVector(CppTypeFor<RCAT, RKIND> *RESTRICT product,
     const YT *RESTRICT y) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
   std::memset(product, 0, rows * sizeof *product);
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    auto yv{static_cast<ResultType>(*y++)};
-    for (SubscriptValue j{0}; j < rows; ++j) {
-      *p++ += static_cast<ResultType>(*x++) * yv;
-    }
+  SubscriptValue k{0};
+  for (; k + matmulUnroll <= n; k += matmulUnroll) {
+    ResultType yv[matmulUnroll]{static_cast<ResultType>(y[k]),
+        static_cast<ResultType>(y[k + 1]), static_cast<ResultType>(y[k + 2]),
+        static_cast<ResultType>(y[k + 3])};
+    AddColumnProducts<matmulUnroll>(product, rows, x + k * rows, rows, yv);
+  }
+  for (; k < n; ++k) {
+    ResultType yv[1]{static_cast<ResultType>(y[k])};
+    AddColumnProducts<1>(product, rows, x + k * rows, rows, yv);
   }
 }
 
@@ -125,27 +189,44 @@ inline void MatrixTimesVector(CppTypeFor<RCAT, RKIND> *RESTRICT product,
 //    RES(J) = 0
 //    DO 1 K = 1, N
 //   1 RES(J) = RES(J) + X(K)*Y(K,J)
-// With loop distribution and transposition to avoid the inner
-// sum reduction and one non-unit stride (the other remains):
-//   DO 1 J = 1, NCOLS
-//   1 RES(J) = 0
-//   DO 2 K = 1, N
-//    DO 2 J = 1, NCOLS
-//   2 RES(J) = RES(J) + X(K)*Y(K,J)
+// The columns of Y are contiguous, so this is kept as a sum reduction
+// over each column, which is computed for several columns at once to
+// share the loads of X:
+//   DO 1 J = 1, NCOLS, 4
+//    RES(J:J+3) = 0
+//    DO 1 K = 1, N
+//   1 RES(J:J+3) = RES(J:J+3) + X(K)*Y(K,J:J+3)
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 inline void VectorTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
     SubscriptValue n, SubscriptValue cols, const XT *RESTRICT x,
     const YT *RESTRICT y) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
-  std::memset(product, 0, cols * sizeof *product);
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    auto xv{static_cast<ResultType>(*x++)};
-    const YT *RESTRICT yp{&y[k]};
-    for (SubscriptValue j{0}; j < cols; ++j) {
-      *p++ += xv * static_cast<ResultType>(*yp);
-      yp += n;
+  SubscriptValue j{0};
+  for (; j + matmulUnroll <= cols; j += matmulUnroll) {
+    const YT *RESTRICT y0{y + j * n};
+    const YT *RESTRICT y1{y0 + n};
+    const YT *RESTRICT y2{y1 + n};
+    const YT *RESTRICT y3{y2 + n};
+    ResultType p0{}, p1{}, p2{}, p3{};
+    for (SubscriptValue k{0}; k < n; ++k) {
+      auto xv{static_cast<ResultType>(x[k])};
+      p0 += xv * static_cast<ResultType>(y0[k]);
+      p1 += xv * static_cast<ResultType>(y1[k]);
+      p2 += xv * static_cast<ResultType>(y2[k]);
+      p3 += xv * static_cast<ResultType>(y3[k]);
+    }
+    product[j] = p0;
+    product[j + 1] = p1;
+    product[j + 2] = p2;
+    product[j + 3] = p3;
+  }
+  for (; j < cols; ++j) {
+    const YT *RESTRICT yp{y + j * n};
+    ResultType p{};
+    for (SubscriptValue k{0}; k < n; ++k) {
+      p += static_cast<ResultType>(x[k]) * static_cast<ResultType>(yp[k]);
     }
+    product[j] = p;
   }
 }
 
@@ -27,6 +27,16 @@ public:
     product_ *= *array_.Element<A>(at);
     return product_ != 0;
   }
+  // Integer products stay zero once they are, so there is no need to stop
+  // early; a real product might not, as NaN or infinity times zero is NaN.
+  template <typename A, typename = std::enable_if_t<std::is_integral_v<A>>>
+  void AccumulateContiguous(const A *RESTRICT p, std::size_t n) {
+    INTERMEDIATE product{product_};
+    for (std::size_t j{0}; j < n; ++j) {
+      product *= p[j];
+    }
+    product_ = product;
+  }
 
 private:
   const Descriptor &array_;
@@ -23,8 +23,11 @@
 
 #include "terminator.h"
 #include "tools.h"
+#include "flang/Runtime/c-or-cpp.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <type_traits>
+#include <utility>
 
 namespace Fortran::runtime {
 
@@ -35,6 +38,20 @@ namespace Fortran::runtime {
 // AccumulateAt() member function that applies supplied subscripts to the
 // array and does something with a scalar element, and a GetResult()
 // member function that copies a final result into its destination.
+// An accumulator may also support an AccumulateContiguous() member
+// function template that reduces a run of consecutive elements; it is used
+// when the elements are contiguous in memory and unmasked, where it saves
+// the subscript arithmetic and leaves a loop that can be vectorized.
+
+template <typename ACCUMULATOR, typename TYPE, typename = void>
+struct HasAccumulateContiguous : std::false_type {};
+template <typename ACCUMULATOR, typename TYPE>
+struct HasAccumulateContiguous<ACCUMULATOR, TYPE,
+    std::void_t<decltype(std::declval<ACCUMULATOR &>()
+                             .template AccumulateContiguous<TYPE>(
+                                 std::declval<const TYPE *>(),
+                                 std::declval<std::size_t>()))>>
+    : std::true_type {};
 
 // Total reduction of the array argument to a scalar (or to a vector in the
 // cases of FINDLOC, MAXLOC, & MINLOC).  These are the cases without DIM= or
@@ -67,6 +84,13 @@ inline void DoTotalReduction(const Descriptor &x, int dim,
     }
   }
   // No MASK=, or scalar MASK=.TRUE.
+  if constexpr (HasAccumulateContiguous<ACCUMULATOR, TYPE>::value) {
+    if (x.IsContiguous()) {
+      accumulator.template AccumulateContiguous<TYPE>(
+          x.OffsetElement<TYPE>(), x.Elements());
+      return;
+    }
+  }
   for (auto elements{x.Elements()}; elements--; x.IncrementSubscripts(xAt)) {
     if (!accumulator.template AccumulateAt<TYPE>(xAt)) {
       break; // cut short, result is known
@@ -118,7 +142,15 @@ inline void ReduceDimToScalar(const Descriptor &x, int zeroBasedDim,
   GetExpandedSubscripts(xAt, x, zeroBasedDim, subscripts);
   const auto &dim{x.GetDimension(zeroBasedDim)};
   SubscriptValue at{dim.LowerBound()};
-  for (auto n{dim.Extent()}; n-- > 0; ++at) {
+  auto n{dim.Extent()};
+  if constexpr (HasAccumulateContiguous<ACCUMULATOR, TYPE>::value) {
+    if (dim.ByteStride() == static_cast<SubscriptValue>(sizeof(TYPE))) {
+      xAt[zeroBasedDim] = at;
+      accumulator.template AccumulateContiguous<TYPE>(x.Element<TYPE>(xAt), n);
+      n = 0;
+    }
+  }
+  for (; n-- > 0; ++at) {
     xAt[zeroBasedDim] = at;
     if (!accumulator.template AccumulateAt<TYPE>(xAt)) {
       break;
@@ -31,6 +31,14 @@ public:
     sum_ += *array_.Element<A>(at);
     return true;
   }
+  template <typename A>
+  void AccumulateContiguous(const A *RESTRICT p, std::size_t n) {
+    INTERMEDIATE sum{sum_};
+    for (std::size_t j{0}; j < n; ++j) {
+      sum += p[j];
+    }
+    sum_ = sum;
+  }
 
 private:
   const Descriptor &array_;
@@ -56,6 +64,31 @@ public:
   template <typename A> bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  // Kahan summation of a run of elements into several lanes, which are
+  // independent so that their additions can overlap, and which are then
+  // combined in a fixed order.  The rounding depends only on the data, so
+  // the results are reproducible.
+  template <typename A>
+  void AccumulateContiguous(const A *RESTRICT p, std::size_t n) {
+    constexpr std::size_t lanes{4};
+    INTERMEDIATE sum[lanes]{}, correction[lanes]{};
+    std::size_t j{0};
+    for (; j + lanes <= n; j += lanes) {
+      for (std::size_t k{0}; k < lanes; ++k) {
+        INTERMEDIATE next{p[j + k] + correction[k]};
+        INTERMEDIATE oldSum{sum[k]};
+        sum[k] += next;
+        correction[k] = (sum[k] - oldSum) - next;
+      }
+    }
+    for (std::size_t k{0}; k < lanes; ++k) {
+      correction_ += correction[k];
+      Accumulate(sum[k]);
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+  }
 
 private:
   const Descriptor &array_;
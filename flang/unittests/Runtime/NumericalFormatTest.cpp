@@ -657,6 +657,43 @@ TEST(IOApiTests, FormatDoubleValues) {
   }
 }
 
+//------------------------------------------------------------------------------
+/// Tests for output formatting integer values
+//------------------------------------------------------------------------------
+
+TEST(IOApiTests, FormatIntegerValues) {
+  using IndividualTestCaseTy = std::tuple<const char *, std::int64_t,
+      const char *>;
+  static const std::vector<IndividualTestCaseTy> individualTestCases{
+      {"(I0,';')", 0, "0;"},
+      {"(I0,';')", 7, "7;"},
+      {"(I0,';')", -10, "-10;"},
+      {"(I5,';')", 12345, "12345;"},
+      {"(I5,';')", -12345, "*****;"},
+      {"(I6,';')", -12345, "-12345;"},
+      {"(I8.6,';')", -42, " -000042;"},
+      {"(I3.0,';')", 0, "   ;"},
+      {"(SP,I4,';')", 7, "  +7;"},
+      {"(I20,';')", 9223372036854775807, " 9223372036854775807;"},
+      {"(I20,';')", -9223372036854775807 - 1, "-9223372036854775808;"},
+      {"(I120,';')", 99,
+          "                                                            "
+          "                                                          99;"},
+  };
+
+  for (auto const &[format, value, expect] : individualTestCases) {
+    char buffer[800];
+    auto cookie{IONAME(BeginInternalFormattedOutput)(
+        buffer, sizeof buffer, format, std::strlen(format))};
+    EXPECT_TRUE(IONAME(OutputInteger64)(cookie, value));
+    auto status{IONAME(EndIoStatement)(cookie)};
+    EXPECT_EQ(status, 0);
+    ASSERT_TRUE(
+        CompareFormattedStrings(expect, std::string{buffer, sizeof buffer}))
+        << "Failed to format " << format << ", expected " << expect;
+  }
+}
+
 //------------------------------------------------------------------------------
 /// Tests for input formatting real values
 //------------------------------------------------------------------------------
@@ -15,6 +15,7 @@
 #include "flang/Runtime/type-code.h"
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -53,6 +54,38 @@ TEST(Reductions, DimMaskProductInt4) {
   prod.Destroy();
 }
 
+TEST(Reductions, Contiguous) {
+  // Contiguous arrays, with extents that are not multiples of the lanes
+  // of the contiguous kernels
+  std::vector<int> shape{7, 3};
+  std::vector<std::int32_t> intData(21);
+  std::vector<double> realData(21);
+  for (int j{0}; j < 21; ++j) {
+    intData[j] = j % 2 ? -j : j;
+    realData[j] = 0.5 * intData[j];
+  }
+  realData[9] = std::numeric_limits<double>::quiet_NaN();
+  auto intArray{MakeArray<TypeCategory::Integer, 4>(shape, intData)};
+  auto realArray{MakeArray<TypeCategory::Real, 8>(shape, realData)};
+  EXPECT_EQ(RTNAME(SumInteger4)(*intArray, __FILE__, __LINE__), 10);
+  EXPECT_EQ(RTNAME(MaxvalInteger4)(*intArray, __FILE__, __LINE__), 20);
+  EXPECT_EQ(RTNAME(MinvalInteger4)(*intArray, __FILE__, __LINE__), -19);
+  EXPECT_EQ(RTNAME(MaxvalReal8)(*realArray, __FILE__, __LINE__), 10.0);
+  EXPECT_EQ(RTNAME(MinvalReal8)(*realArray, __FILE__, __LINE__), -9.5);
+  auto smallArray{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{6}, std::vector<std::int32_t>{1, -2, 3, 4, 5, 6})};
+  EXPECT_EQ(RTNAME(ProductInteger4)(*smallArray, __FILE__, __LINE__), -720);
+  StaticDescriptor<1, true> statDesc;
+  Descriptor &sums{statDesc.descriptor()};
+  RTNAME(SumDim)(sums, *intArray, 1, __FILE__, __LINE__, nullptr);
+  ASSERT_EQ(sums.rank(), 1);
+  ASSERT_EQ(sums.GetDimension(0).Extent(), 3);
+  EXPECT_EQ(*sums.ZeroBasedIndexedElement<std::int32_t>(0), 3);
+  EXPECT_EQ(*sums.ZeroBasedIndexedElement<std::int32_t>(1), -10);
+  EXPECT_EQ(*sums.ZeroBasedIndexedElement<std::int32_t>(2), 17);
+  sums.Destroy();
+}
+
 TEST(Reductions, DoubleMaxMinNorm2) {
   std::vector<int> shape{3, 4, 2}; // rows, columns, planes
   //   0  -3   6  -9     12 -15  18 -21
@@ -544,3 +577,34 @@ TEST(Reductions, DotProduct) {
   EXPECT_FALSE(RTNAME(DotProductLogical)(
       *logicalVector2, *logicalVector1, __FILE__, __LINE__));
 }
+
+TEST(Reductions, DotProductLong) {
+  // Long enough to use several partial sums, with a remainder.
+  std::vector<double> realData(103);
+  std::vector<std::complex<float>> complexData(103);
+  double realExpect{0};
+  std::complex<double> complexExpect{0};
+  for (int j{0}; j < 103; ++j) {
+    realData[j] = j % 9 - 4;
+    complexData[j] = {static_cast<float>(j % 4), static_cast<float>(j % 3 - 1)};
+    realExpect += realData[j] * realData[j];
+    complexExpect += std::conj(std::complex<double>{complexData[j]}) *
+        std::complex<double>{complexData[j]};
+  }
+  auto realVector{
+      MakeArray<TypeCategory::Real, 8>(std::vector<int>{103}, realData)};
+  auto complexVector{
+      MakeArray<TypeCategory::Complex, 4>(std::vector<int>{103}, complexData)};
+  EXPECT_EQ(
+      RTNAME(DotProductReal8)(*realVector, *realVector, __FILE__, __LINE__),
+      realExpect);
+  std::complex<float> result4;
+  RTNAME(CppDotProductComplex4)
+  (result4, *complexVector, *complexVector, __FILE__, __LINE__);
+  EXPECT_EQ(result4, (std::complex<float>{complexExpect}));
+  auto intVector{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{5}, std::vector<std::int32_t>{1, 2, 3, 4, 5})};
+  EXPECT_EQ(
+      RTNAME(DotProductInteger4)(*intVector, *intVector, __FILE__, __LINE__),
+      55);
+}
@@ -0,0 +1,99 @@
+//===-- Benchmark of the malloc family ------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The same benchmarks are linked with the allocator of llvm libc, and with the
+// one of the system libc, so that they can be compared.
+
+#include "benchmark/benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static constexpr size_t kMinSize = 8;
+static constexpr size_t kMaxSize = 128 * 1024;
+
+// Allocates, touches and frees a block of a single size.
+static void BM_MallocFree(benchmark::State &State) {
+  const size_t Size = State.range(0);
+  for (auto _ : State) {
+    auto *Ptr = static_cast<uint8_t *>(malloc(Size));
+    Ptr[0] = 1;
+    benchmark::DoNotOptimize(Ptr);
+    free(Ptr);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_MallocFree)->RangeMultiplier(4)->Range(kMinSize, kMaxSize);
+
+// Keeps a batch of blocks alive, with sizes mostly small as in the usual
+// programs, and frees them in a random order. Running it from several threads
+// shows how the allocator scales with the thread count.
+static void BM_MallocFreeBatch(benchmark::State &State) {
+  static constexpr size_t kBatchSize = 1024;
+  std::mt19937 Generator(State.thread_index());
+  // Sizes from a log-uniform distribution between kMinSize and 4KiB.
+  std::uniform_real_distribution<double> Log2Size(3, 12);
+  std::vector<size_t> Sizes(kBatchSize);
+  for (size_t &Size : Sizes)
+    Size = static_cast<size_t>(std::exp2(Log2Size(Generator)));
+  std::vector<size_t> FreeOrder(kBatchSize);
+  for (size_t I = 0; I < kBatchSize; ++I)
+    FreeOrder[I] = I;
+  std::shuffle(FreeOrder.begin(), FreeOrder.end(), Generator);
+  std::vector<void *> Ptrs(kBatchSize);
+  for (auto _ : State) {
+    for (size_t I = 0; I < kBatchSize; ++I)
+      Ptrs[I] = malloc(Sizes[I]);
+    benchmark::DoNotOptimize(Ptrs.data());
+    for (size_t I : FreeOrder)
+      free(Ptrs[I]);
+  }
+  State.SetItemsProcessed(State.iterations() * kBatchSize);
+}
+BENCHMARK(BM_MallocFreeBatch)->ThreadRange(1, 16)->UseRealTime();
+
+// Allocates zeroed blocks, which the allocator can avoid clearing when they
+// come from fresh pages.
+static void BM_CallocFree(benchmark::State &State) {
+  const size_t Size = State.range(0);
+  for (auto _ : State) {
+    void *Ptr = calloc(1, Size);
+    benchmark::DoNotOptimize(Ptr);
+    free(Ptr);
+  }
+  State.SetBytesProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_CallocFree)->RangeMultiplier(16)->Range(kMinSize, kMaxSize);
+
+// Grows a block one step at a time, as a vector does when it is appended to.
+static void BM_ReallocGrowth(benchmark::State &State) {
+  const size_t Step = State.range(0);
+  for (auto _ : State) {
+    void *Ptr = nullptr;
+    for (size_t Size = Step; Size <= kMaxSize; Size += Step)
+      Ptr = realloc(Ptr, Size);
+    benchmark::DoNotOptimize(Ptr);
+    free(Ptr);
+  }
+  State.SetItemsProcessed(State.iterations() * (kMaxSize / Step));
+}
+BENCHMARK(BM_ReallocGrowth)->Arg(256)->Arg(4096);
+
+static void BM_AlignedAllocFree(benchmark::State &State) {
+  const size_t Alignment = State.range(0);
+  for (auto _ : State) {
+    void *Ptr = aligned_alloc(Alignment, Alignment);
+    benchmark::DoNotOptimize(Ptr);
+    free(Ptr);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_AlignedAllocFree)->RangeMultiplier(8)->Range(16, 4096);
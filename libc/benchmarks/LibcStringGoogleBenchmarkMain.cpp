@@ -0,0 +1,111 @@
+//===-- Benchmark of the str* functions -----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Compares the str* functions of llvm libc with the ones of the system libc,
+// for strings of increasing lengths.
+
+#include "benchmark/benchmark.h"
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace __llvm_libc {
+
+extern size_t strlen(const char *);
+extern char *strchr(const char *, int);
+extern int strcmp(const char *, const char *);
+extern char *strstr(const char *, const char *);
+
+} // namespace __llvm_libc
+
+// The system functions, which the compiler can't replace by its builtins.
+static size_t system_strlen(const char *src) { return ::strlen(src); }
+static char *system_strchr(const char *src, int c) {
+  return const_cast<char *>(::strchr(src, c));
+}
+static int system_strcmp(const char *left, const char *right) {
+  return ::strcmp(left, right);
+}
+static char *system_strstr(const char *haystack, const char *needle) {
+  return const_cast<char *>(::strstr(haystack, needle));
+}
+
+static constexpr int64_t kMinLength = 1;
+static constexpr int64_t kMaxLength = 4096;
+
+static void setCounters(benchmark::State &State, size_t Length) {
+  State.SetBytesProcessed(State.iterations() * Length);
+}
+
+template <size_t (*Strlen)(const char *)>
+static void BM_Strlen(benchmark::State &State) {
+  const std::string Str(State.range(0), 'a');
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Strlen(Str.c_str()));
+  setCounters(State, Str.size());
+}
+BENCHMARK_TEMPLATE(BM_Strlen, __llvm_libc::strlen)
+    ->RangeMultiplier(4)
+    ->Range(kMinLength, kMaxLength);
+BENCHMARK_TEMPLATE(BM_Strlen, system_strlen)
+    ->RangeMultiplier(4)
+    ->Range(kMinLength, kMaxLength);
+
+// Looks for a character at the end of the string.
+template <char *(*Strchr)(const char *, int)>
+static void BM_Strchr(benchmark::State &State) {
+  std::string Str(State.range(0), 'a');
+  Str.back() = 'b';
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Strchr(Str.c_str(), 'b'));
+  setCounters(State, Str.size());
+}
+BENCHMARK_TEMPLATE(BM_Strchr, __llvm_libc::strchr)
+    ->RangeMultiplier(4)
+    ->Range(kMinLength, kMaxLength);
+BENCHMARK_TEMPLATE(BM_Strchr, system_strchr)
+    ->RangeMultiplier(4)
+    ->Range(kMinLength, kMaxLength);
+
+// Compares strings which differ by their last character, with different
+// alignments.
+template <int (*Strcmp)(const char *, const char *)>
+static void BM_Strcmp(benchmark::State &State) {
+  const std::string Left(State.range(0), 'a');
+  std::string Right = "x" + Left;
+  Right.back() = 'b';
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Strcmp(Left.c_str(), Right.c_str() + 1));
+  setCounters(State, Left.size());
+}
+BENCHMARK_TEMPLATE(BM_Strcmp, __llvm_libc::strcmp)
+    ->RangeMultiplier(4)
+    ->Range(kMinLength, kMaxLength);
+BENCHMARK_TEMPLATE(BM_Strcmp, system_strcmp)
+    ->RangeMultiplier(4)
+    ->Range(kMinLength, kMaxLength);
+
+// Looks for a word at the end of an english like text, so that most of the
+// characters of the haystack are tried.
+template <char *(*Strstr)(const char *, const char *)>
+static void BM_Strstr(benchmark::State &State) {
+  static const char kWords[] = "the quick brown fox jumps over a lazy dog ";
+  std::string Haystack;
+  while (Haystack.size() < static_cast<size_t>(State.range(0)))
+    Haystack += kWords;
+  Haystack += "needle";
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Strstr(Haystack.c_str(), "needle"));
+  setCounters(State, Haystack.size());
+}
+BENCHMARK_TEMPLATE(BM_Strstr, __llvm_libc::strstr)
+    ->RangeMultiplier(4)
+    ->Range(64, kMaxLength);
+BENCHMARK_TEMPLATE(BM_Strstr, system_strstr)
+    ->RangeMultiplier(4)
+    ->Range(64, kMaxLength);
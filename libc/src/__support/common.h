@@ -29,6 +29,19 @@
 #define LLVM_LIBC_FUNCTION(type, name, arglist) type name arglist
 #endif
 
+// Defines the entrypoint `name` as an indirect function: the loader calls
+// `resolver`, an extern "C" function defined in the same file, once, and binds
+// `name` to the implementation it returns.
+#ifdef LLVM_LIBC_PUBLIC_PACKAGING
+#define LLVM_LIBC_IFUNC(name, resolver)                                        \
+  decltype(__llvm_libc::name) __##name##_impl__ __asm__(#name)                 \
+      __attribute__((ifunc(#resolver)));                                       \
+  decltype(__llvm_libc::name) name __attribute__((ifunc(#resolver)))
+#else
+#define LLVM_LIBC_IFUNC(name, resolver)                                        \
+  decltype(__llvm_libc::name) name __attribute__((ifunc(#resolver)))
+#endif
+
 namespace __llvm_libc {
 namespace internal {
 constexpr bool same_string(char const *lhs, char const *rhs) {
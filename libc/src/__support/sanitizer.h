@@ -49,4 +49,12 @@
 #define SANITIZER_MEMORY_INITIALIZED(ptr, size)
 #endif
 
+// Disables AddressSanitizer in a function which reads bytes around its data,
+// from memory which is known to be mapped.
+#if LLVM_LIBC_HAVE_ADDRESS_SANITIZER
+#define LLVM_LIBC_NO_SANITIZE_ADDRESS __attribute__((no_sanitize("address")))
+#else
+#define LLVM_LIBC_NO_SANITIZE_ADDRESS
+#endif
+
 #endif // LLVM_LIBC_SRC_SUPPORT_SANITIZER_H
@@ -0,0 +1,155 @@
+//===-- Runtime selection of x86 memory functions ---------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_STRING_MEMORY_UTILS_DISPATCH_X86_H
+#define LLVM_LIBC_SRC_STRING_MEMORY_UTILS_DISPATCH_X86_H
+
+#include "src/__support/architectures.h"
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+
+#include "src/__support/common.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uint64_t
+
+// A memory function with runtime dispatch is built once per instruction set,
+// from the same source, with `LLVM_LIBC_DISPATCH_VARIANT` set to the name of
+// the variant. `LLVM_LIBC_DISPATCH_VARIANT_NAME(memcpy)` is then the name of
+// the function defined by each build, e.g. `memcpy_avx2`.
+#define LLVM_LIBC_DISPATCH_VARIANT_NAME(name)                                  \
+  LLVM_LIBC_DISPATCH_VARIANT_NAME__CONCAT(name, LLVM_LIBC_DISPATCH_VARIANT)
+#define LLVM_LIBC_DISPATCH_VARIANT_NAME__CONCAT(name, variant)                 \
+  LLVM_LIBC_DISPATCH_VARIANT_NAME__PASTE(name, variant)
+#define LLVM_LIBC_DISPATCH_VARIANT_NAME__PASTE(name, variant) name##_##variant
+
+namespace __llvm_libc {
+namespace x86 {
+
+// The features of the running CPU relevant to the memory functions. The vector
+// extensions are only reported when the OS also saves their registers.
+struct CpuFeatures {
+  bool avx2 = false;
+  bool avx512f = false;
+  bool avx512bw = false;
+  // Enhanced rep movsb, which is faster than vector loops for large copies.
+  bool erms = false;
+};
+
+static inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t (&regs)[4]) {
+  LIBC_INLINE_ASM("cpuid"
+                  : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+                  : "a"(leaf), "c"(subleaf));
+}
+
+// Returns the register states enabled by the OS in XCR0.
+static inline uint64_t xgetbv() {
+  uint32_t lo, hi;
+  LIBC_INLINE_ASM("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+// Queries the running CPU. This only executes cpuid and xgetbv, and touches no
+// global state, so that it can be called from an ifunc resolver, which runs
+// while the loader is still applying relocations.
+static inline CpuFeatures get_cpu_features() {
+  enum : uint32_t {
+    // cpuid(1).ecx
+    OSXSAVE = 1U << 27,
+    AVX = 1U << 28,
+    // cpuid(7, 0).ebx
+    AVX2 = 1U << 5,
+    ERMS = 1U << 9,
+    AVX512F = 1U << 16,
+    AVX512BW = 1U << 30,
+  };
+  enum : uint64_t {
+    // The XMM and YMM states.
+    XCR0_AVX = 0x6,
+    // The XMM, YMM, opmask and ZMM states.
+    XCR0_AVX512 = 0xE6,
+  };
+  CpuFeatures features;
+  uint32_t regs[4];
+  cpuid(0, 0, regs);
+  const uint32_t max_leaf = regs[0];
+  cpuid(1, 0, regs);
+  const uint32_t ecx1 = regs[2];
+  if (max_leaf < 7)
+    return features;
+  cpuid(7, 0, regs);
+  const uint32_t ebx7 = regs[1];
+  features.erms = ebx7 & ERMS;
+  if (!(ecx1 & OSXSAVE) || !(ecx1 & AVX))
+    return features;
+  const uint64_t xcr0 = xgetbv();
+  if ((xcr0 & XCR0_AVX) != XCR0_AVX)
+    return features;
+  features.avx2 = ebx7 & AVX2;
+  if ((xcr0 & XCR0_AVX512) != XCR0_AVX512)
+    return features;
+  features.avx512f = ebx7 & AVX512F;
+  features.avx512bw = ebx7 & AVX512BW;
+  return features;
+}
+
+// The builds of the memory functions, from the baseline x86-64 instruction set
+// to the widest vectors.
+enum class Variant {
+  SSE2,
+  AVX2,
+  // AVX2 for small and medium sizes, rep movsb for large ones.
+  AVX2_ERMS,
+  AVX512,
+};
+
+// The elements of elements_x86.h only use 64-byte vectors when both AVX512F
+// and AVX512BW are available.
+static inline bool has_avx512(const CpuFeatures &features) {
+  return features.avx512f && features.avx512bw;
+}
+
+static inline Variant select_memcpy_variant(const CpuFeatures &features) {
+  if (has_avx512(features))
+    return Variant::AVX512;
+  if (features.avx2)
+    return features.erms ? Variant::AVX2_ERMS : Variant::AVX2;
+  return Variant::SSE2;
+}
+
+static inline Variant select_memset_variant(const CpuFeatures &features) {
+  if (has_avx512(features))
+    return Variant::AVX512;
+  if (features.avx2)
+    return Variant::AVX2;
+  return Variant::SSE2;
+}
+
+static inline Variant select_bcmp_variant(const CpuFeatures &features) {
+  return select_memset_variant(features);
+}
+
+void *memcpy_sse2(void *__restrict, const void *__restrict, size_t);
+void *memcpy_avx2(void *__restrict, const void *__restrict, size_t);
+void *memcpy_avx2_erms(void *__restrict, const void *__restrict, size_t);
+void *memcpy_avx512(void *__restrict, const void *__restrict, size_t);
+
+void *memset_sse2(void *, int, size_t);
+void *memset_avx2(void *, int, size_t);
+void *memset_avx512(void *, int, size_t);
+
+int bcmp_sse2(const void *, const void *, size_t);
+int bcmp_avx2(const void *, const void *, size_t);
+int bcmp_avx512(const void *, const void *, size_t);
+
+} // namespace x86
+} // namespace __llvm_libc
+
+#endif // defined(LLVM_LIBC_ARCH_X86_64)
+
+#endif // LLVM_LIBC_SRC_STRING_MEMORY_UTILS_DISPATCH_X86_H
@@ -9,14 +9,18 @@
 #include "src/string/strchr.h"
 
 #include "src/__support/common.h"
+#include "src/string/string_vector_utils.h"
 
 namespace __llvm_libc {
 
-// TODO: Look at performance benefits of comparing words.
 LLVM_LIBC_FUNCTION(char *, strchr, (const char *src, int c)) {
   const char ch = c;
+#if defined(LLVM_LIBC_HAS_STRING_BLOCK)
+  src = internal::find_first_character_or_null(src, ch);
+#else
   for (; *src && *src != ch; ++src)
     ;
+#endif
   return *src == ch ? const_cast<char *>(src) : nullptr;
 }
 
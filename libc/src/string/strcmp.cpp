@@ -9,13 +9,19 @@
 #include "src/string/strcmp.h"
 
 #include "src/__support/common.h"
+#include "src/string/string_vector_utils.h"
 
 namespace __llvm_libc {
 
-// TODO: Look at benefits for comparing words at a time.
 LLVM_LIBC_FUNCTION(int, strcmp, (const char *left, const char *right)) {
+#if defined(LLVM_LIBC_HAS_STRING_BLOCK)
+  const size_t i = internal::first_difference_or_null(left, right);
+  left += i;
+  right += i;
+#else
   for (; *left && *left == *right; ++left, ++right)
     ;
+#endif
   return *reinterpret_cast<const unsigned char *>(left) -
          *reinterpret_cast<const unsigned char *>(right);
 }
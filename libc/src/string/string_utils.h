@@ -11,6 +11,7 @@
 
 #include "src/__support/CPP/Bitset.h"
 #include "src/__support/common.h"
+#include "src/string/string_vector_utils.h"
 #include <stddef.h> // size_t
 
 namespace __llvm_libc {
@@ -19,10 +20,14 @@ namespace internal {
 // Returns the length of a string, denoted by the first occurrence
 // of a null terminator.
 static inline size_t string_length(const char *src) {
+#if defined(LLVM_LIBC_HAS_STRING_BLOCK)
+  return find_null(src) - src;
+#else
   size_t length;
   for (length = 0; *src; ++src, ++length)
     ;
   return length;
+#endif
 }
 
 // Returns the first occurrence of 'ch' within the first 'n' characters of
@@ -0,0 +1,175 @@
+//===-- Vector scanning of null terminated strings --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIBC_SRC_STRING_STRING_VECTOR_UTILS_H
+#define LIBC_SRC_STRING_STRING_VECTOR_UTILS_H
+
+#include "src/__support/architectures.h"
+#include "src/__support/sanitizer.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t, uintptr_t
+
+#if defined(LLVM_LIBC_ARCH_X86) && defined(__SSE2__)
+#include <immintrin.h>
+#define LLVM_LIBC_HAS_STRING_BLOCK
+#elif defined(LLVM_LIBC_ARCH_AARCH64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LLVM_LIBC_HAS_STRING_BLOCK
+#endif
+
+#if defined(LLVM_LIBC_HAS_STRING_BLOCK)
+
+// The length of a string is not known until its terminator is found, so the
+// functions in this file read whole blocks of bytes, some of which may be past
+// the end of the string. This is safe as long as a block does not cross a page
+// boundary: pages are the unit of memory protection, and the page holding the
+// terminator is mapped.
+
+namespace __llvm_libc {
+namespace internal {
+
+// The smallest page size of the supported targets.
+static constexpr size_t PAGE_SIZE = 4096;
+
+// A block of bytes compared at once. A comparison returns a mask holding
+// BITS_PER_BYTE bits per byte, all set for the bytes that compare equal, the
+// first byte in the low bits.
+#if defined(LLVM_LIBC_ARCH_X86) && defined(__AVX2__)
+struct Block {
+  static constexpr size_t SIZE = 32;
+  static constexpr size_t BITS_PER_BYTE = 1;
+  static constexpr uint64_t ALL = 0xFFFFFFFF;
+
+  static Block load(const char *ptr) {
+    return {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr))};
+  }
+  uint64_t equals(const Block &other) const {
+    return static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(value, other.value)));
+  }
+  uint64_t equals(char c) const { return equals({_mm256_set1_epi8(c)}); }
+
+  __m256i value;
+};
+#elif defined(LLVM_LIBC_ARCH_X86)
+struct Block {
+  static constexpr size_t SIZE = 16;
+  static constexpr size_t BITS_PER_BYTE = 1;
+  static constexpr uint64_t ALL = 0xFFFF;
+
+  static Block load(const char *ptr) {
+    return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr))};
+  }
+  uint64_t equals(const Block &other) const {
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(value, other.value)));
+  }
+  uint64_t equals(char c) const { return equals({_mm_set1_epi8(c)}); }
+
+  __m128i value;
+};
+#elif defined(LLVM_LIBC_ARCH_AARCH64)
+struct Block {
+  static constexpr size_t SIZE = 16;
+  // NEON has no movemask, narrowing each 16-bit lane by 4 bits leaves a
+  // nibble per byte.
+  static constexpr size_t BITS_PER_BYTE = 4;
+  static constexpr uint64_t ALL = ~uint64_t(0);
+
+  static Block load(const char *ptr) {
+    return {vld1q_u8(reinterpret_cast<const uint8_t *>(ptr))};
+  }
+  uint64_t equals(const Block &other) const {
+    const uint8x16_t cmp = vceqq_u8(value, other.value);
+    return vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+  }
+  uint64_t equals(char c) const {
+    return equals({vdupq_n_u8(static_cast<uint8_t>(c))});
+  }
+
+  uint8x16_t value;
+};
+#endif
+
+// Returns the index of the first byte set in a non zero mask.
+static inline size_t first_byte(uint64_t mask) {
+  return __builtin_ctzll(mask) / Block::BITS_PER_BYTE;
+}
+
+// Returns whether reading a block at 'ptr' would cross a page boundary.
+static inline bool block_crosses_page(const char *ptr) {
+  const size_t page_offset = reinterpret_cast<uintptr_t>(ptr) % PAGE_SIZE;
+  return page_offset > PAGE_SIZE - Block::SIZE;
+}
+
+// Returns the first byte from 'src' for which 'matches' is true. 'matches'
+// takes a block and returns the mask of its matching bytes. The string must
+// hold a match, usually its terminator. Only aligned blocks are read, which
+// never cross a page boundary.
+template <typename Matches>
+LLVM_LIBC_NO_SANITIZE_ADDRESS static inline const char *
+find_first_match(const char *src, Matches matches) {
+  const size_t offset = reinterpret_cast<uintptr_t>(src) % Block::SIZE;
+  const char *block = src - offset;
+  // Ignores the bytes of the first block before 'src'.
+  uint64_t mask =
+      matches(Block::load(block)) >> (offset * Block::BITS_PER_BYTE);
+  if (mask)
+    return src + first_byte(mask);
+  for (;;) {
+    block += Block::SIZE;
+    mask = matches(Block::load(block));
+    if (mask)
+      return block + first_byte(mask);
+  }
+}
+
+// Returns the terminator of 'src'.
+static inline const char *find_null(const char *src) {
+  return find_first_match(
+      src, [](const Block &block) { return block.equals('\0'); });
+}
+
+// Returns the first occurrence of 'ch' or of the terminator in 'src'.
+static inline const char *find_first_character_or_null(const char *src,
+                                                       char ch) {
+  return find_first_match(src, [ch](const Block &block) {
+    return block.equals(ch) | block.equals('\0');
+  });
+}
+
+// Returns the first index at which 'left' and 'right' differ, or at which they
+// both end. The blocks are read from both strings at once, so they are not
+// aligned, and the ones which would cross a page are compared bytewise.
+LLVM_LIBC_NO_SANITIZE_ADDRESS static inline size_t
+first_difference_or_null(const char *left, const char *right) {
+  size_t i = 0;
+  for (;;) {
+    if (block_crosses_page(left + i) || block_crosses_page(right + i)) {
+      for (const size_t end = i + Block::SIZE; i < end; ++i)
+        if (left[i] == '\0' || left[i] != right[i])
+          return i;
+      continue;
+    }
+    const Block block = Block::load(left + i);
+    const uint64_t mask = (~block.equals(Block::load(right + i)) & Block::ALL) |
+                          block.equals('\0');
+    if (mask)
+      return i + first_byte(mask);
+    i += Block::SIZE;
+  }
+}
+
+} // namespace internal
+} // namespace __llvm_libc
+
+#endif // defined(LLVM_LIBC_HAS_STRING_BLOCK)
+
+#endif // LIBC_SRC_STRING_STRING_VECTOR_UTILS_H
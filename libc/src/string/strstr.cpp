@@ -9,21 +9,35 @@
 #include "src/string/strstr.h"
 
 #include "src/__support/common.h"
+#include "src/string/string_vector_utils.h"
 #include <stddef.h>
 
 namespace __llvm_libc {
 
-// TODO: This is a simple brute force implementation. This can be
-// improved upon using well known string matching algorithms.
+// TODO: The worst case is still quadratic, this can be improved upon using
+// well known string matching algorithms, e.g. Two-Way.
 LLVM_LIBC_FUNCTION(char *, strstr, (const char *haystack, const char *needle)) {
-  for (size_t i = 0; haystack[i]; ++i) {
+  if (!needle[0])
+    return const_cast<char *>(haystack);
+  for (;; ++haystack) {
+    // Only the occurrences of the first character of the needle are tried.
+#if defined(LLVM_LIBC_HAS_STRING_BLOCK)
+    haystack = internal::find_first_character_or_null(haystack, needle[0]);
+#else
+    for (; *haystack && *haystack != needle[0]; ++haystack)
+      ;
+#endif
+    if (!*haystack)
+      return nullptr;
     size_t j;
-    for (j = 0; haystack[i + j] && haystack[i + j] == needle[j]; ++j)
+    for (j = 1; haystack[j] && haystack[j] == needle[j]; ++j)
       ;
     if (!needle[j])
-      return const_cast<char *>(haystack + i);
+      return const_cast<char *>(haystack);
+    // The rest of the haystack is shorter than the needle.
+    if (!haystack[j])
+      return nullptr;
   }
-  return nullptr;
 }
 
 } // namespace __llvm_libc
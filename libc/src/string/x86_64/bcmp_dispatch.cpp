@@ -0,0 +1,30 @@
+//===-- Implementation of bcmp with runtime dispatch ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/bcmp.h"
+#include "src/__support/common.h"
+#include "src/string/memory_utils/dispatch_x86.h"
+
+namespace __llvm_libc {
+
+extern "C" decltype(&bcmp) __llvm_libc_bcmp_resolver() {
+  switch (x86::select_bcmp_variant(x86::get_cpu_features())) {
+  case x86::Variant::AVX512:
+    return x86::bcmp_avx512;
+  case x86::Variant::AVX2:
+  case x86::Variant::AVX2_ERMS:
+    return x86::bcmp_avx2;
+  case x86::Variant::SSE2:
+    break;
+  }
+  return x86::bcmp_sse2;
+}
+
+LLVM_LIBC_IFUNC(bcmp, __llvm_libc_bcmp_resolver);
+
+} // namespace __llvm_libc
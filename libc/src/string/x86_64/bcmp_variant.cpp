@@ -0,0 +1,22 @@
+//===-- Implementation of a bcmp variant for runtime dispatch -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memory_utils/bcmp_implementations.h"
+#include "src/string/memory_utils/dispatch_x86.h"
+
+namespace __llvm_libc {
+namespace x86 {
+
+int LLVM_LIBC_DISPATCH_VARIANT_NAME(bcmp)(const void *lhs, const void *rhs,
+                                          size_t count) {
+  return inline_bcmp(static_cast<const char *>(lhs),
+                     static_cast<const char *>(rhs), count);
+}
+
+} // namespace x86
+} // namespace __llvm_libc
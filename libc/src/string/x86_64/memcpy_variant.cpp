@@ -0,0 +1,24 @@
+//===-- Implementation of a memcpy variant for runtime dispatch -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memory_utils/dispatch_x86.h"
+#include "src/string/memory_utils/memcpy_implementations.h"
+
+namespace __llvm_libc {
+namespace x86 {
+
+void *LLVM_LIBC_DISPATCH_VARIANT_NAME(memcpy)(void *__restrict dst,
+                                              const void *__restrict src,
+                                              size_t size) {
+  inline_memcpy(reinterpret_cast<char *>(dst),
+                reinterpret_cast<const char *>(src), size);
+  return dst;
+}
+
+} // namespace x86
+} // namespace __llvm_libc
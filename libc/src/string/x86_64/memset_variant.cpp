@@ -0,0 +1,23 @@
+//===-- Implementation of a memset variant for runtime dispatch -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memory_utils/dispatch_x86.h"
+#include "src/string/memory_utils/memset_implementations.h"
+
+namespace __llvm_libc {
+namespace x86 {
+
+void *LLVM_LIBC_DISPATCH_VARIANT_NAME(memset)(void *dst, int value,
+                                              size_t count) {
+  inline_memset(reinterpret_cast<char *>(dst),
+                static_cast<unsigned char>(value), count);
+  return dst;
+}
+
+} // namespace x86
+} // namespace __llvm_libc
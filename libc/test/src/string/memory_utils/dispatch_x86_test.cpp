@@ -0,0 +1,55 @@
+//===-- Unittests for the runtime selection of x86 memory functions -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memory_utils/dispatch_x86.h"
+#include "utils/UnitTest/Test.h"
+
+namespace __llvm_libc {
+namespace x86 {
+
+TEST(LlvmLibcDispatchX86Test, CpuFeatures) {
+  const CpuFeatures features = get_cpu_features();
+  EXPECT_EQ(features.avx2, bool(__builtin_cpu_supports("avx2")));
+  EXPECT_EQ(features.avx512f, bool(__builtin_cpu_supports("avx512f")));
+  EXPECT_EQ(features.avx512bw, bool(__builtin_cpu_supports("avx512bw")));
+}
+
+TEST(LlvmLibcDispatchX86Test, SelectBaseline) {
+  CpuFeatures features;
+  features.erms = true;
+  EXPECT_TRUE(select_memcpy_variant(features) == Variant::SSE2);
+  EXPECT_TRUE(select_memset_variant(features) == Variant::SSE2);
+  EXPECT_TRUE(select_bcmp_variant(features) == Variant::SSE2);
+}
+
+TEST(LlvmLibcDispatchX86Test, SelectAvx2) {
+  CpuFeatures features;
+  features.avx2 = true;
+  EXPECT_TRUE(select_memcpy_variant(features) == Variant::AVX2);
+  features.erms = true;
+  EXPECT_TRUE(select_memcpy_variant(features) == Variant::AVX2_ERMS);
+  EXPECT_TRUE(select_memset_variant(features) == Variant::AVX2);
+  EXPECT_TRUE(select_bcmp_variant(features) == Variant::AVX2);
+}
+
+TEST(LlvmLibcDispatchX86Test, SelectAvx512) {
+  CpuFeatures features;
+  features.avx2 = true;
+  features.erms = true;
+  features.avx512f = true;
+  // The 64-byte elements also need AVX512BW.
+  EXPECT_TRUE(select_memcpy_variant(features) == Variant::AVX2_ERMS);
+  EXPECT_TRUE(select_memset_variant(features) == Variant::AVX2);
+  features.avx512bw = true;
+  EXPECT_TRUE(select_memcpy_variant(features) == Variant::AVX512);
+  EXPECT_TRUE(select_memset_variant(features) == Variant::AVX512);
+  EXPECT_TRUE(select_bcmp_variant(features) == Variant::AVX512);
+}
+
+} // namespace x86
+} // namespace __llvm_libc
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "CartesianBenchmarks.h"
+
+namespace {
+
+// The algorithms below scan the whole input: the elements are all 1, but for
+// the last one which is 0.
+template <class IntT>
+struct TestIntBase {
+  static std::vector<IntT> generateInput(size_t size) {
+    std::vector<IntT> Res(size, IntT(1));
+    Res.back() = IntT(0);
+    return Res;
+  }
+};
+
+struct TestInt8 : TestIntBase<std::int8_t> {
+  static constexpr const char* Name = "TestInt8";
+};
+
+struct TestInt16 : TestIntBase<std::int16_t> {
+  static constexpr const char* Name = "TestInt16";
+};
+
+struct TestInt32 : TestIntBase<std::int32_t> {
+  static constexpr const char* Name = "TestInt32";
+};
+
+struct TestInt64 : TestIntBase<std::int64_t> {
+  static constexpr const char* Name = "TestInt64";
+};
+
+using AllTestTypes = std::tuple<TestInt8, TestInt16, TestInt32, TestInt64>;
+
+struct FindAlg {
+  template <class V>
+  auto operator()(const V& Data, const V&) const {
+    return std::find(Data.begin(), Data.end(), typename V::value_type(0));
+  }
+
+  static constexpr const char* Name = "Find";
+};
+
+struct CountAlg {
+  template <class V>
+  auto operator()(const V& Data, const V&) const {
+    return std::count(Data.begin(), Data.end(), typename V::value_type(1));
+  }
+
+  static constexpr const char* Name = "Count";
+};
+
+struct MismatchAlg {
+  template <class V>
+  auto operator()(const V& Data, const V& Other) const {
+    return std::mismatch(Data.begin(), Data.end(), Other.begin());
+  }
+
+  static constexpr const char* Name = "Mismatch";
+};
+
+struct EqualAlg {
+  template <class V>
+  bool operator()(const V& Data, const V& Other) const {
+    return std::equal(Data.begin(), Data.end(), Other.begin(), Other.end());
+  }
+
+  static constexpr const char* Name = "Equal";
+};
+
+struct MinElementAlg {
+  template <class V>
+  auto operator()(const V& Data, const V&) const {
+    return std::min_element(Data.begin(), Data.end());
+  }
+
+  static constexpr const char* Name = "MinElement";
+};
+
+struct MaxElementAlg {
+  template <class V>
+  auto operator()(const V& Data, const V&) const {
+    return std::max_element(Data.begin(), Data.end());
+  }
+
+  static constexpr const char* Name = "MaxElement";
+};
+
+using AllAlgs = std::tuple<FindAlg, CountAlg, MismatchAlg, EqualAlg, MinElementAlg, MaxElementAlg>;
+
+template <class Alg, class TestType>
+struct VectorizedBench {
+  size_t Quantity;
+
+  std::string name() const {
+    return std::string("VectorizedBench_") + Alg::Name + "_" + TestType::Name + '/' + std::to_string(Quantity);
+  }
+
+  void run(benchmark::State& state) const {
+    const auto Data = TestType::generateInput(Quantity);
+    auto Other = Data;
+    Other.back() = 1;
+
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(Alg{}(Data, Other));
+    }
+    state.SetBytesProcessed(state.iterations() * Quantity * sizeof(Data[0]));
+  }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  const std::vector<size_t> Quantities = {1 << 4, 1 << 8, 1 << 12, 1 << 16};
+  makeCartesianProductBenchmark<VectorizedBench, AllAlgs, AllTestTypes>(Quantities);
+  benchmark::RunSpecifiedBenchmarks();
+}
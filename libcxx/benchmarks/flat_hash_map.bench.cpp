@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _LIBCPP_VERSION
+#include <ext/flat_hash_map>
+#endif
+
+#include "benchmark/benchmark.h"
+
+#include "GenerateInput.h"
+
+constexpr std::size_t TestNumInputs = 1024;
+
+// Compare the open addressing __gnu_cxx::flat_hash_map with the node based
+// std::unordered_map, on the same inputs and with the same hash functions.
+
+template <class Container, class GenInputs>
+void BM_InsertKey(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  for (auto _ : st) {
+    c.clear();
+    for (const auto& k : in)
+      benchmark::DoNotOptimize(&*c.try_emplace(k).first);
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+void BM_InsertKeyReserve(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  for (auto _ : st) {
+    c.clear();
+    c.reserve(in.size());
+    for (const auto& k : in)
+      benchmark::DoNotOptimize(&*c.try_emplace(k).first);
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+void BM_FindHit(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  for (const auto& k : in)
+    c.try_emplace(k);
+  for (auto _ : st) {
+    for (const auto& k : in)
+      benchmark::DoNotOptimize(&*c.find(k));
+    benchmark::ClobberMemory();
+  }
+}
+
+// The looked up keys are generated separately from the inserted ones, which
+// makes collisions very unlikely.
+template <class Container, class GenInputs>
+void BM_FindMiss(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  auto missing = gen(st.range(0));
+  for (const auto& k : in)
+    c.try_emplace(k);
+  for (auto _ : st) {
+    for (const auto& k : missing)
+      benchmark::DoNotOptimize(c.find(k) == c.end());
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+void BM_EraseKey(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  for (auto _ : st) {
+    st.PauseTiming();
+    for (const auto& k : in)
+      c.try_emplace(k);
+    st.ResumeTiming();
+    for (const auto& k : in)
+      benchmark::DoNotOptimize(c.erase(k));
+    benchmark::ClobberMemory();
+  }
+}
+
+#define BENCHMARK_MAP(Bench, Name, Container, GenInputs)                                                               \
+  BENCHMARK_CAPTURE(Bench, Name, Container{}, GenInputs)->Arg(TestNumInputs)->Arg(TestNumInputs * 64)
+
+using UnorderedMapUInt64 = std::unordered_map<uint64_t, uint64_t>;
+using UnorderedMapString = std::unordered_map<std::string, uint64_t>;
+
+BENCHMARK_MAP(BM_InsertKey, unordered_map_uint64, UnorderedMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_InsertKeyReserve, unordered_map_uint64, UnorderedMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_FindHit, unordered_map_uint64, UnorderedMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_FindMiss, unordered_map_uint64, UnorderedMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_EraseKey, unordered_map_uint64, UnorderedMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_InsertKey, unordered_map_string, UnorderedMapString, getRandomStringInputs);
+BENCHMARK_MAP(BM_FindHit, unordered_map_string, UnorderedMapString, getRandomStringInputs);
+BENCHMARK_MAP(BM_FindMiss, unordered_map_string, UnorderedMapString, getRandomStringInputs);
+
+#ifdef _LIBCPP_VERSION
+using FlatHashMapUInt64 = __gnu_cxx::flat_hash_map<uint64_t, uint64_t>;
+using FlatHashMapString = __gnu_cxx::flat_hash_map<std::string, uint64_t>;
+
+BENCHMARK_MAP(BM_InsertKey, flat_hash_map_uint64, FlatHashMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_InsertKeyReserve, flat_hash_map_uint64, FlatHashMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_FindHit, flat_hash_map_uint64, FlatHashMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_FindMiss, flat_hash_map_uint64, FlatHashMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_EraseKey, flat_hash_map_uint64, FlatHashMapUInt64, getRandomIntegerInputs<uint64_t>);
+BENCHMARK_MAP(BM_InsertKey, flat_hash_map_string, FlatHashMapString, getRandomStringInputs);
+BENCHMARK_MAP(BM_FindHit, flat_hash_map_string, FlatHashMapString, getRandomStringInputs);
+BENCHMARK_MAP(BM_FindMiss, flat_hash_map_string, FlatHashMapString, getRandomStringInputs);
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <format>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Compare the formatting functions with snprintf, for the same values and
+// equivalent format strings.
+
+template <class T>
+static std::vector<T> generate_values(size_t size) {
+  std::mt19937_64 generator;
+  std::vector<T> result;
+  result.reserve(size);
+  if constexpr (std::is_floating_point_v<T>) {
+    std::uniform_real_distribution<T> distribution(-1e6, 1e6);
+    for (size_t i = 0; i != size; ++i)
+      result.push_back(distribution(generator));
+  } else {
+    std::uniform_int_distribution<T> distribution(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+    for (size_t i = 0; i != size; ++i)
+      result.push_back(distribution(generator));
+  }
+  return result;
+}
+
+static constexpr size_t value_count = 1000;
+
+static void BM_snprintf_int(benchmark::State& state) {
+  auto values = generate_values<int64_t>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::snprintf(buffer.data(), buffer.size(), "%lld", static_cast<long long>(value)));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_snprintf_int);
+
+static void BM_format_to_n_int(benchmark::State& state) {
+  auto values = generate_values<int64_t>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::format_to_n(buffer.data(), buffer.size(), "{}", value));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_format_to_n_int);
+
+static void BM_format_to_int(benchmark::State& state) {
+  auto values = generate_values<int64_t>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::format_to(buffer.data(), "{}", value));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_format_to_int);
+
+static void BM_snprintf_double(benchmark::State& state) {
+  auto values = generate_values<double>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::snprintf(buffer.data(), buffer.size(), "%.6f", value));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_snprintf_double);
+
+static void BM_format_to_n_double(benchmark::State& state) {
+  auto values = generate_values<double>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::format_to_n(buffer.data(), buffer.size(), "{:.6f}", value));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_format_to_n_double);
+
+static void BM_format_to_double(benchmark::State& state) {
+  auto values = generate_values<double>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::format_to(buffer.data(), "{:.6f}", value));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_format_to_double);
+
+// A mix of text and replacement fields, the way format strings are often used
+// for logging.
+static void BM_snprintf_mixed(benchmark::State& state) {
+  auto values = generate_values<int64_t>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::snprintf(
+          buffer.data(), buffer.size(), "value %lld at %s:%d", static_cast<long long>(value), "file.cpp", 42));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_snprintf_mixed);
+
+static void BM_format_to_n_mixed(benchmark::State& state) {
+  auto values = generate_values<int64_t>(value_count);
+  std::array<char, 128> buffer;
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(
+          std::format_to_n(buffer.data(), buffer.size(), "value {} at {}:{}", value, "file.cpp", 42));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_format_to_n_mixed);
+
+static void BM_format_mixed(benchmark::State& state) {
+  auto values = generate_values<int64_t>(value_count);
+  for (auto _ : state)
+    for (auto value : values)
+      benchmark::DoNotOptimize(std::format("value {} at {}:{}", value, "file.cpp", 42));
+  state.SetItemsProcessed(state.iterations() * value_count);
+}
+BENCHMARK(BM_format_mixed);
+
+BENCHMARK_MAIN();
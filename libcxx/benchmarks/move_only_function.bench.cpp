@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "test_macros.h"
+
+// Compare the construction, move and call overhead of std::function and
+// std::move_only_function, for targets held in place and on the heap.
+
+namespace {
+
+struct S {
+  int field = 0;
+};
+
+int FunctionWithS(const S* s) { return s->field; }
+
+struct SmallFunctor {
+  int offset = 1;
+  int operator()(const S* s) const { return s->field + offset; }
+};
+
+struct LargeFunctor {
+  int padding[16] = {};
+  int operator()(const S* s) const { return s->field + padding[0]; }
+};
+
+// Captures a pointer and an int, like most lambdas do.
+auto MakeLambda(int* counter) {
+  return [counter, offset = 1](const S* s) { return s->field + *counter + offset; };
+}
+
+template <class Function, class Target>
+void BM_ConstructAndDestroy(benchmark::State& state, Target target) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(target);
+    Function f = target;
+    benchmark::DoNotOptimize(f);
+  }
+}
+
+template <class Function, class Target>
+void BM_Move(benchmark::State& state, Target target) {
+  Function values[2] = {Function(target), Function()};
+  int i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(values);
+    values[i ^ 1] = std::move(values[i]);
+    i ^= 1;
+  }
+}
+
+template <class Function, class Target>
+void BM_Invoke(benchmark::State& state, Target target) {
+  S s;
+  Function f = target;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f);
+    benchmark::DoNotOptimize(f(&s));
+  }
+}
+
+int counter = 0;
+
+using Function = std::function<int(const S*)>;
+
+#define BENCHMARK_FUNCTION(Bench, Name, Function)                                                                      \
+  BENCHMARK_CAPTURE(Bench<Function>, Name##_FuncPtr, &FunctionWithS);                                                 \
+  BENCHMARK_CAPTURE(Bench<Function>, Name##_SmallFunctor, SmallFunctor{});                                             \
+  BENCHMARK_CAPTURE(Bench<Function>, Name##_Lambda, MakeLambda(&counter));                                             \
+  BENCHMARK_CAPTURE(Bench<Function>, Name##_LargeFunctor, LargeFunctor{})
+
+BENCHMARK_FUNCTION(BM_ConstructAndDestroy, function, Function);
+BENCHMARK_FUNCTION(BM_Move, function, Function);
+BENCHMARK_FUNCTION(BM_Invoke, function, Function);
+
+#if TEST_STD_VER > 20
+using MoveOnlyFunction = std::move_only_function<int(const S*) const>;
+
+BENCHMARK_FUNCTION(BM_ConstructAndDestroy, move_only_function, MoveOnlyFunction);
+BENCHMARK_FUNCTION(BM_Move, move_only_function, MoveOnlyFunction);
+BENCHMARK_FUNCTION(BM_Invoke, move_only_function, MoveOnlyFunction);
+#endif
+
+} // namespace
+
+BENCHMARK_MAIN();
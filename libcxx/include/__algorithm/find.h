@@ -10,7 +10,10 @@
 #ifndef _LIBCPP___ALGORITHM_FIND_H
 #define _LIBCPP___ALGORITHM_FIND_H
 
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
+#include <type_traits>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #pragma GCC system_header
@@ -19,14 +22,39 @@
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 template <class _InputIterator, class _Tp>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 _InputIterator
-find(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
+inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 _InputIterator
+__find_constexpr(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
   for (; __first != __last; ++__first)
     if (*__first == __value_)
       break;
   return __first;
 }
 
+template <class _InputIterator, class _Tp>
+inline _LIBCPP_INLINE_VISIBILITY _InputIterator __find(_InputIterator __first, _InputIterator __last,
+                                                       const _Tp& __value_) {
+  return _VSTD::__find_constexpr(__first, __last, __value_);
+}
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+template <class _Tp, class _Up>
+inline _LIBCPP_INLINE_VISIBILITY typename enable_if<__is_simd_comparable_value<_Tp, _Up>::value, _Tp*>::type
+__find(_Tp* __first, _Tp* __last, const _Up& __value_) {
+  if (!_VSTD::__simd_is_representable<_Tp>(__value_))
+    return __last;
+  return _VSTD::__simd_find(__first, __last, static_cast<typename remove_cv<_Tp>::type>(__value_));
+}
+#endif
+
+template <class _InputIterator, class _Tp>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 _InputIterator
+find(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__find_constexpr(__first, __last, __value_);
+  return _VSTD::__rewrap_iter(
+      __first, _VSTD::__find(_VSTD::__unwrap_iter(__first), _VSTD::__unwrap_iter(__last), __value_));
+}
+
 _LIBCPP_END_NAMESPACE_STD
 
 #endif // _LIBCPP___ALGORITHM_FIND_H
@@ -11,8 +11,11 @@
 
 #include <__algorithm/comp.h>
 #include <__algorithm/comp_ref_type.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
+#include <type_traits>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #pragma GCC system_header
@@ -45,13 +48,33 @@ min_element(_ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
 }
 
 template <class _ForwardIterator>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_AFTER_CXX11 _ForwardIterator
-min_element(_ForwardIterator __first, _ForwardIterator __last)
+inline _LIBCPP_HIDE_FROM_ABI _ForwardIterator
+__min_element(_ForwardIterator __first, _ForwardIterator __last)
 {
     return _VSTD::min_element(__first, __last,
               __less<typename iterator_traits<_ForwardIterator>::value_type>());
 }
 
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI typename enable_if<__is_simd_integral<_Tp>::value, _Tp*>::type
+__min_element(_Tp* __first, _Tp* __last)
+{
+    return _VSTD::__simd_extremum_element<false>(__first, __last);
+}
+#endif
+
+template <class _ForwardIterator>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_AFTER_CXX11 _ForwardIterator
+min_element(_ForwardIterator __first, _ForwardIterator __last)
+{
+    if (__libcpp_is_constant_evaluated())
+        return _VSTD::min_element(__first, __last,
+                  __less<typename iterator_traits<_ForwardIterator>::value_type>());
+    return _VSTD::__rewrap_iter(__first,
+        _VSTD::__min_element(_VSTD::__unwrap_iter(__first), _VSTD::__unwrap_iter(__last)));
+}
+
 _LIBCPP_END_NAMESPACE_STD
 
 #endif // _LIBCPP___ALGORITHM_MIN_ELEMENT_H
@@ -11,8 +11,11 @@
 #define _LIBCPP___ALGORITHM_MISMATCH_H
 
 #include <__algorithm/comp.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
+#include <type_traits>
 #include <utility>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
@@ -31,13 +34,43 @@ _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
   return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
 }
 
+template <class _InputIterator1, class _InputIterator2>
+inline _LIBCPP_INLINE_VISIBILITY pair<_InputIterator1, _InputIterator2>
+__mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2) {
+  typedef typename iterator_traits<_InputIterator1>::value_type __v1;
+  typedef typename iterator_traits<_InputIterator2>::value_type __v2;
+  return _VSTD::mismatch(__first1, __last1, __first2, __equal_to<__v1, __v2>());
+}
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+template <class _Tp, class _Up>
+inline _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_simd_comparable_range<_Tp, _Up>::value, pair<_Tp*, _Up*> >::type
+    __mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2) {
+  const size_t __n = _VSTD::__simd_mismatch(__first1, __first2, static_cast<size_t>(__last1 - __first1));
+  return pair<_Tp*, _Up*>(__first1 + __n, __first2 + __n);
+}
+#endif
+
+template <class _InputIterator1, class _InputIterator2, class _UnwrappedIterator1, class _UnwrappedIterator2>
+inline _LIBCPP_INLINE_VISIBILITY pair<_InputIterator1, _InputIterator2>
+__rewrap_mismatch(_InputIterator1 __first1, _InputIterator2 __first2,
+                  pair<_UnwrappedIterator1, _UnwrappedIterator2> __result) {
+  return pair<_InputIterator1, _InputIterator2>(_VSTD::__rewrap_iter(__first1, __result.first),
+                                                _VSTD::__rewrap_iter(__first2, __result.second));
+}
+
 template <class _InputIterator1, class _InputIterator2>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
     _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
     mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2) {
   typedef typename iterator_traits<_InputIterator1>::value_type __v1;
   typedef typename iterator_traits<_InputIterator2>::value_type __v2;
-  return _VSTD::mismatch(__first1, __last1, __first2, __equal_to<__v1, __v2>());
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::mismatch(__first1, __last1, __first2, __equal_to<__v1, __v2>());
+  return _VSTD::__rewrap_mismatch(
+      __first1, __first2,
+      _VSTD::__mismatch(_VSTD::__unwrap_iter(__first1), _VSTD::__unwrap_iter(__last1), _VSTD::__unwrap_iter(__first2)));
 }
 
 #if _LIBCPP_STD_VER > 11
@@ -52,13 +85,36 @@ _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
   return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
 }
 
+template <class _InputIterator1, class _InputIterator2>
+inline _LIBCPP_INLINE_VISIBILITY pair<_InputIterator1, _InputIterator2>
+__mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2) {
+  typedef typename iterator_traits<_InputIterator1>::value_type __v1;
+  typedef typename iterator_traits<_InputIterator2>::value_type __v2;
+  return _VSTD::mismatch(__first1, __last1, __first2, __last2, __equal_to<__v1, __v2>());
+}
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+template <class _Tp, class _Up>
+inline _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_simd_comparable_range<_Tp, _Up>::value, pair<_Tp*, _Up*> >::type
+    __mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2, _Up* __last2) {
+  if (__last2 - __first2 < __last1 - __first1)
+    __last1 = __first1 + (__last2 - __first2);
+  return _VSTD::__mismatch(__first1, __last1, __first2);
+}
+#endif
+
 template <class _InputIterator1, class _InputIterator2>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
     _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
     mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2) {
   typedef typename iterator_traits<_InputIterator1>::value_type __v1;
   typedef typename iterator_traits<_InputIterator2>::value_type __v2;
-  return _VSTD::mismatch(__first1, __last1, __first2, __last2, __equal_to<__v1, __v2>());
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::mismatch(__first1, __last1, __first2, __last2, __equal_to<__v1, __v2>());
+  return _VSTD::__rewrap_mismatch(__first1, __first2,
+                                  _VSTD::__mismatch(_VSTD::__unwrap_iter(__first1), _VSTD::__unwrap_iter(__last1),
+                                                    _VSTD::__unwrap_iter(__first2), _VSTD::__unwrap_iter(__last2)));
 }
 #endif
 
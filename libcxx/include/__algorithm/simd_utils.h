@@ -0,0 +1,264 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___ALGORITHM_SIMD_UTILS_H
+#define _LIBCPP___ALGORITHM_SIMD_UTILS_H
+
+#include <__config>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#pragma GCC system_header
+#endif
+
+// The vectorized algorithms are written with the vector extensions of GCC and
+// Clang, which are lowered to SSE2, AVX2 or NEON instructions. The width of the
+// vectors is the widest one the target is compiled for.
+#if __has_attribute(__vector_size__) && (defined(__SSE2__) || defined(__ARM_NEON))
+#  define _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS 1
+#else
+#  define _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS 0
+#endif
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+
+#  if defined(__AVX2__)
+#    define _LIBCPP_NATIVE_SIMD_WIDTH_IN_BYTES 32
+#  else
+#    define _LIBCPP_NATIVE_SIMD_WIDTH_IN_BYTES 16
+#  endif
+
+// Before SSE4.2 and on 32 bit ARM, 64 bit lanes are compared with a sequence of
+// instructions which is slower than the scalar loops.
+#  if defined(__SSE4_2__) || defined(__aarch64__)
+#    define _LIBCPP_HAS_SIMD_64_BIT_COMPARE 1
+#  else
+#    define _LIBCPP_HAS_SIMD_64_BIT_COMPARE 0
+#  endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+// Whether the elements of type _Tp can be compared with vector instructions.
+template <class _Tp>
+struct __is_simd_integral
+    : integral_constant<bool, is_integral<_Tp>::value && !is_same<typename remove_cv<_Tp>::type, bool>::value &&
+                                  (sizeof(_Tp) < 8 || _LIBCPP_HAS_SIMD_64_BIT_COMPARE)> {};
+
+// Whether comparing an element of type _Tp with a value of type _Up is
+// equivalent to comparing their bits, once the value is converted to _Tp.
+template <class _Tp, class _Up>
+struct __is_simd_comparable_value
+    : integral_constant<bool, __is_simd_integral<_Tp>::value && __is_simd_integral<_Up>::value> {};
+
+// Whether comparing the elements of ranges of types _Tp and _Up is equivalent
+// to comparing their bits.
+template <class _Tp, class _Up>
+struct __is_simd_comparable_range
+    : integral_constant<bool, __is_simd_integral<_Tp>::value &&
+                                  is_same<typename remove_cv<_Tp>::type, typename remove_cv<_Up>::type>::value> {};
+
+// Whether __value compares equal to an element of type _Tp, which is then
+// static_cast<_Tp>(__value): the comparisons convert the elements to a type at
+// least as wide, which preserves their distinctness.
+template <class _Tp, class _Up>
+inline _LIBCPP_HIDE_FROM_ABI bool __simd_is_representable(const _Up& __value) {
+  return static_cast<typename remove_cv<_Tp>::type>(__value) == __value;
+}
+
+template <class _Tp>
+struct __simd_traits {
+  typedef typename remove_cv<_Tp>::type __value_type;
+  // The lanes which compare true are set to -1, and the others to 0.
+  typedef typename make_signed<__value_type>::type __mask_lane;
+
+  typedef __value_type __vec __attribute__((__vector_size__(_LIBCPP_NATIVE_SIMD_WIDTH_IN_BYTES)));
+  typedef __mask_lane __mask __attribute__((__vector_size__(_LIBCPP_NATIVE_SIMD_WIDTH_IN_BYTES)));
+
+  static const size_t __lanes = _LIBCPP_NATIVE_SIMD_WIDTH_IN_BYTES / sizeof(_Tp);
+  // The number of vectors which can be counted in a mask without overflowing
+  // its lanes.
+  static const size_t __max_count =
+      size_t(-1) >> (8 * (sizeof(size_t) - (sizeof(_Tp) < sizeof(size_t) ? sizeof(_Tp) : sizeof(size_t))) + 1);
+};
+
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI typename __simd_traits<_Tp>::__vec __simd_load(const _Tp* __p) {
+  typename __simd_traits<_Tp>::__vec __v;
+  __builtin_memcpy(&__v, __p, sizeof(__v));
+  return __v;
+}
+
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI typename __simd_traits<_Tp>::__vec
+__simd_splat(typename __simd_traits<_Tp>::__value_type __value) {
+  typename __simd_traits<_Tp>::__vec __v = {};
+  for (size_t __i = 0; __i != __simd_traits<_Tp>::__lanes; ++__i)
+    __v[__i] = __value;
+  return __v;
+}
+
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI typename __simd_traits<_Tp>::__mask
+__simd_equal(typename __simd_traits<_Tp>::__vec __x, typename __simd_traits<_Tp>::__vec __y) {
+  return (typename __simd_traits<_Tp>::__mask)(__x == __y);
+}
+
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI typename __simd_traits<_Tp>::__mask
+__simd_not_equal(typename __simd_traits<_Tp>::__vec __x, typename __simd_traits<_Tp>::__vec __y) {
+  return (typename __simd_traits<_Tp>::__mask)(__x != __y);
+}
+
+template <class _Mask>
+inline _LIBCPP_HIDE_FROM_ABI bool __simd_any(_Mask __m) {
+  unsigned long long __words[sizeof(_Mask) / sizeof(unsigned long long)];
+  __builtin_memcpy(__words, &__m, sizeof(__m));
+  unsigned long long __any = 0;
+  for (size_t __i = 0; __i != sizeof(_Mask) / sizeof(unsigned long long); ++__i)
+    __any |= __words[__i];
+  return __any != 0;
+}
+
+// Precondition: a lane of __m is set
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI size_t __simd_first_set(typename __simd_traits<_Tp>::__mask __m) {
+  size_t __i = 0;
+  while (!__m[__i])
+    ++__i;
+  return __i;
+}
+
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI _Tp* __simd_find(_Tp* __first, _Tp* __last, typename remove_cv<_Tp>::type __value) {
+  typedef __simd_traits<_Tp> _Traits;
+  typedef typename _Traits::__mask __mask;
+  const size_t __lanes = _Traits::__lanes;
+  const typename _Traits::__vec __needle = _VSTD::__simd_splat<_Tp>(__value);
+
+  // Look for the value in 4 vectors at a time, and in a vector at a time once
+  // found.
+  while (static_cast<size_t>(__last - __first) >= 4 * __lanes) {
+    __mask __m0 = _VSTD::__simd_equal<_Tp>(_VSTD::__simd_load(__first), __needle);
+    __mask __m1 = _VSTD::__simd_equal<_Tp>(_VSTD::__simd_load(__first + __lanes), __needle);
+    __mask __m2 = _VSTD::__simd_equal<_Tp>(_VSTD::__simd_load(__first + 2 * __lanes), __needle);
+    __mask __m3 = _VSTD::__simd_equal<_Tp>(_VSTD::__simd_load(__first + 3 * __lanes), __needle);
+    if (_VSTD::__simd_any((__m0 | __m1) | (__m2 | __m3)))
+      break;
+    __first += 4 * __lanes;
+  }
+  for (; static_cast<size_t>(__last - __first) >= __lanes; __first += __lanes) {
+    __mask __m = _VSTD::__simd_equal<_Tp>(_VSTD::__simd_load(__first), __needle);
+    if (_VSTD::__simd_any(__m))
+      return __first + _VSTD::__simd_first_set<_Tp>(__m);
+  }
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      break;
+  return __first;
+}
+
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI ptrdiff_t __simd_count(const _Tp* __first, const _Tp* __last,
+                                                    typename remove_cv<_Tp>::type __value) {
+  typedef __simd_traits<_Tp> _Traits;
+  const size_t __lanes = _Traits::__lanes;
+  const typename _Traits::__vec __needle = _VSTD::__simd_splat<_Tp>(__value);
+
+  ptrdiff_t __r = 0;
+  while (static_cast<size_t>(__last - __first) >= __lanes) {
+    size_t __n = static_cast<size_t>(__last - __first) / __lanes;
+    if (__n > _Traits::__max_count)
+      __n = _Traits::__max_count;
+    // The lanes which are equal to the value are -1, so subtracting the masks
+    // counts them.
+    typename _Traits::__mask __counts = {};
+    for (; __n != 0; --__n, __first += __lanes)
+      __counts -= _VSTD::__simd_equal<_Tp>(_VSTD::__simd_load(__first), __needle);
+    for (size_t __i = 0; __i != __lanes; ++__i)
+      __r += __counts[__i];
+  }
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      ++__r;
+  return __r;
+}
+
+// Return the index of the first elements of __x and __y which differ, or __n
+// if there are none.
+template <class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI size_t __simd_mismatch(const _Tp* __x, const _Tp* __y, size_t __n) {
+  typedef __simd_traits<_Tp> _Traits;
+  typedef typename _Traits::__mask __mask;
+  const size_t __lanes = _Traits::__lanes;
+
+  size_t __i = 0;
+  for (; __n - __i >= 4 * __lanes; __i += 4 * __lanes) {
+    __mask __m0 = _VSTD::__simd_not_equal<_Tp>(_VSTD::__simd_load(__x + __i), _VSTD::__simd_load(__y + __i));
+    __mask __m1 = _VSTD::__simd_not_equal<_Tp>(_VSTD::__simd_load(__x + __i + __lanes),
+                                               _VSTD::__simd_load(__y + __i + __lanes));
+    __mask __m2 = _VSTD::__simd_not_equal<_Tp>(_VSTD::__simd_load(__x + __i + 2 * __lanes),
+                                               _VSTD::__simd_load(__y + __i + 2 * __lanes));
+    __mask __m3 = _VSTD::__simd_not_equal<_Tp>(_VSTD::__simd_load(__x + __i + 3 * __lanes),
+                                               _VSTD::__simd_load(__y + __i + 3 * __lanes));
+    if (_VSTD::__simd_any((__m0 | __m1) | (__m2 | __m3)))
+      break;
+  }
+  for (; __n - __i >= __lanes; __i += __lanes) {
+    __mask __m = _VSTD::__simd_not_equal<_Tp>(_VSTD::__simd_load(__x + __i), _VSTD::__simd_load(__y + __i));
+    if (_VSTD::__simd_any(__m))
+      return __i + _VSTD::__simd_first_set<_Tp>(__m);
+  }
+  for (; __i != __n; ++__i)
+    if (__x[__i] != __y[__i])
+      break;
+  return __i;
+}
+
+// Return the smallest element of [__first, __last), or the largest one if
+// _Max is true.
+// Precondition: __first != __last
+template <bool _Max, class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI typename remove_cv<_Tp>::type __simd_extremum(const _Tp* __first, const _Tp* __last) {
+  typedef __simd_traits<_Tp> _Traits;
+  typedef typename _Traits::__vec __vec;
+  typedef typename _Traits::__mask __mask;
+  const size_t __lanes = _Traits::__lanes;
+
+  typename remove_cv<_Tp>::type __r = *__first;
+  if (static_cast<size_t>(__last - __first) >= __lanes) {
+    __vec __acc = _VSTD::__simd_load(__first);
+    for (__first += __lanes; static_cast<size_t>(__last - __first) >= __lanes; __first += __lanes) {
+      __vec __v = _VSTD::__simd_load(__first);
+      __mask __m = _Max ? (__mask)(__v > __acc) : (__mask)(__v < __acc);
+      __acc = (__vec)(((__mask)__v & __m) | ((__mask)__acc & ~__m));
+    }
+    for (size_t __i = 0; __i != __lanes; ++__i)
+      if (_Max ? __r < __acc[__i] : __acc[__i] < __r)
+        __r = __acc[__i];
+  }
+  for (; __first != __last; ++__first)
+    if (_Max ? __r < *__first : *__first < __r)
+      __r = *__first;
+  return __r;
+}
+
+// Return the first smallest element, or the first largest one if _Max is true.
+template <bool _Max, class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI _Tp* __simd_extremum_element(_Tp* __first, _Tp* __last) {
+  if (__first == __last)
+    return __last;
+  return _VSTD::__simd_find(__first, __last, _VSTD::__simd_extremum<_Max>(__first, __last));
+}
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+
+#endif // _LIBCPP___ALGORITHM_SIMD_UTILS_H
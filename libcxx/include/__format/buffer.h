@@ -0,0 +1,237 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___FORMAT_BUFFER_H
+#define _LIBCPP___FORMAT_BUFFER_H
+
+#include <__algorithm/copy_n.h>
+#include <__algorithm/min.h>
+#include <__config>
+#include <__format/format_to_n_result.h>
+#include <__iterator/back_insert_iterator.h>
+#include <__iterator/concepts.h>
+#include <__iterator/incrementable_traits.h>
+#include <__utility/move.h>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+_LIBCPP_PUSH_MACROS
+#include <__undef_macros>
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#if _LIBCPP_STD_VER > 17
+
+// TODO FMT Remove this once we require compilers with proper C++20 support.
+// If the compiler has no concepts support, the format header will be disabled.
+// Without concepts support enable_if needs to be used and that too much effort
+// to support compilers with partial C++20 support.
+#if !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+namespace __format {
+
+/// A "buffer" that handles writing to the proper iterator.
+///
+/// The formatting functions write through a back_insert_iterator of this
+/// buffer, whatever output iterator they are given. This type-erases the
+/// output iterator, so there is a single basic_format_context, and a single
+/// set of formatters, per character type.
+///
+/// The characters are written to a storage area. When it is full, the buffer
+/// calls the __flush member of its owner, which knows where the characters go.
+template <class _CharT>
+class _LIBCPP_TEMPLATE_VIS __output_buffer {
+public:
+  using value_type = _CharT;
+
+  template <class _Tp>
+  _LIBCPP_HIDE_FROM_ABI explicit __output_buffer(_CharT* __ptr, size_t __capacity, _Tp* __obj)
+      : __ptr_(__ptr), __capacity_(__capacity),
+        __flush_([](_CharT* __p, size_t __size, void* __o) { static_cast<_Tp*>(__o)->__flush(__p, __size); }),
+        __obj_(__obj) {}
+
+  /// Writes the next characters to another storage area.
+  ///
+  /// Only to be called by the owner, in its __flush member.
+  _LIBCPP_HIDE_FROM_ABI void __reset(_CharT* __ptr, size_t __capacity) {
+    __ptr_ = __ptr;
+    __capacity_ = __capacity;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI auto __make_output_iterator() { return back_insert_iterator{*this}; }
+
+  // Used in std::back_insert_iterator.
+  _LIBCPP_HIDE_FROM_ABI void push_back(_CharT __c) {
+    __ptr_[__size_++] = __c;
+    // Flushing once the storage is full, instead of before writing, makes the
+    // common path a single store and comparison.
+    if (__size_ == __capacity_)
+      __flush();
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush() {
+    __flush_(__ptr_, __size_, __obj_);
+    __size_ = 0;
+  }
+
+private:
+  _CharT* __ptr_;
+  size_t __capacity_;
+  size_t __size_{0};
+  void (*__flush_)(_CharT*, size_t, void*);
+  void* __obj_;
+};
+
+/// The storage of the buffers which can't write to their output directly.
+template <class _CharT>
+class _LIBCPP_TEMPLATE_VIS __internal_storage {
+public:
+  static constexpr size_t __buffer_size = 256 / sizeof(_CharT);
+
+  _LIBCPP_HIDE_FROM_ABI _CharT* __begin() { return __buffer_; }
+
+private:
+  _CharT __buffer_[__buffer_size];
+};
+
+/// The storage of the buffers which write to their output directly.
+class _LIBCPP_TEMPLATE_VIS __direct_storage {};
+
+/// Whether the characters can be written in place: the output is contiguous
+/// storage of the character type.
+template <class _OutIt, class _CharT>
+concept __enable_direct_output = same_as<_OutIt, _CharT*>;
+
+/// Whether the output appends to a container which can insert a range of
+/// characters at its end, which is cheaper than inserting them one by one.
+template <class _OutIt, class _CharT>
+concept __enable_container_output =
+    same_as<_OutIt, back_insert_iterator<typename _OutIt::container_type>> &&
+    same_as<typename _OutIt::container_type::value_type, _CharT> &&
+    requires(typename _OutIt::container_type& __c, _CharT* __ptr) { __c.insert(__c.end(), __ptr, __ptr); };
+
+/// The buffer of format_to, vformat_to and format.
+template <class _OutIt, class _CharT>
+requires(output_iterator<_OutIt, const _CharT&>) class _LIBCPP_TEMPLATE_VIS __format_buffer {
+public:
+  _LIBCPP_HIDE_FROM_ABI explicit __format_buffer(_OutIt __out_it) requires(__enable_direct_output<_OutIt, _CharT>)
+      // The user guarantees the output is large enough, so it is never flushed
+      // before the end.
+      : __output_(__out_it, size_t(-1), this), __out_it_(__out_it) {}
+
+  _LIBCPP_HIDE_FROM_ABI explicit __format_buffer(_OutIt __out_it) requires(!__enable_direct_output<_OutIt, _CharT>)
+      : __output_(__storage_.__begin(), __storage_.__buffer_size, this), __out_it_(_VSTD::move(__out_it)) {}
+
+  _LIBCPP_HIDE_FROM_ABI auto __make_output_iterator() { return __output_.__make_output_iterator(); }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT* __ptr, size_t __size) {
+    if constexpr (__enable_direct_output<_OutIt, _CharT>) {
+      __out_it_ += __size;
+      __output_.__reset(__out_it_, size_t(-1));
+    } else if constexpr (__enable_container_output<_OutIt, _CharT>) {
+      auto* __container = __out_it_.__get_container();
+      __container->insert(__container->end(), __ptr, __ptr + __size);
+    } else
+      __out_it_ = _VSTD::copy_n(__ptr, __size, _VSTD::move(__out_it_));
+  }
+
+  _LIBCPP_HIDE_FROM_ABI _OutIt __out_it() && {
+    __output_.__flush();
+    return _VSTD::move(__out_it_);
+  }
+
+private:
+  conditional_t<__enable_direct_output<_OutIt, _CharT>, __direct_storage, __internal_storage<_CharT>> __storage_;
+  __output_buffer<_CharT> __output_;
+  _OutIt __out_it_;
+};
+
+/// The buffer of format_to_n.
+///
+/// It writes the first __n characters to the output, and discards the next
+/// ones after counting them.
+template <class _OutIt, class _CharT>
+requires(output_iterator<_OutIt, const _CharT&>) class _LIBCPP_TEMPLATE_VIS __format_to_n_buffer {
+public:
+  _LIBCPP_HIDE_FROM_ABI explicit __format_to_n_buffer(_OutIt __out_it, iter_difference_t<_OutIt> __n)
+      : __output_(__storage_.__begin(), __storage_.__buffer_size, this), __out_it_(_VSTD::move(__out_it)),
+        __max_size_(__n < 0 ? 0 : static_cast<size_t>(__n)) {
+    // The direct output writes in place until the output is full. The buffer
+    // only writes to its storage when this is empty, as it never has a zero
+    // capacity.
+    if constexpr (__enable_direct_output<_OutIt, _CharT>)
+      if (__max_size_ != 0)
+        __output_.__reset(__out_it_, __max_size_);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI auto __make_output_iterator() { return __output_.__make_output_iterator(); }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT* __ptr, size_t __size) {
+    if (__size_ < __max_size_) {
+      if constexpr (__enable_direct_output<_OutIt, _CharT>) {
+        // Flushed when the output is full or at the end, after what the next
+        // characters are discarded.
+        __out_it_ += __size;
+        __output_.__reset(__storage_.__begin(), __storage_.__buffer_size);
+      } else
+        __out_it_ = _VSTD::copy_n(__ptr, _VSTD::min(__size, __max_size_ - __size_), _VSTD::move(__out_it_));
+    }
+    __size_ += __size;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI format_to_n_result<_OutIt> __result() && {
+    __output_.__flush();
+    return {_VSTD::move(__out_it_), static_cast<iter_difference_t<_OutIt>>(__size_)};
+  }
+
+private:
+  __internal_storage<_CharT> __storage_;
+  __output_buffer<_CharT> __output_;
+  _OutIt __out_it_;
+  size_t __max_size_;
+  size_t __size_{0};
+};
+
+/// The buffer of formatted_size, which only counts the characters.
+template <class _CharT>
+class _LIBCPP_TEMPLATE_VIS __formatted_size_buffer {
+public:
+  _LIBCPP_HIDE_FROM_ABI __formatted_size_buffer() : __output_(__storage_.__begin(), __storage_.__buffer_size, this) {}
+
+  _LIBCPP_HIDE_FROM_ABI auto __make_output_iterator() { return __output_.__make_output_iterator(); }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT*, size_t __size) { __size_ += __size; }
+
+  _LIBCPP_HIDE_FROM_ABI size_t __result() && {
+    __output_.__flush();
+    return __size_;
+  }
+
+private:
+  __internal_storage<_CharT> __storage_;
+  __output_buffer<_CharT> __output_;
+  size_t __size_{0};
+};
+
+} // namespace __format
+
+#endif // !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+#endif //_LIBCPP_STD_VER > 17
+
+_LIBCPP_END_NAMESPACE_STD
+
+_LIBCPP_POP_MACROS
+
+#endif // _LIBCPP___FORMAT_BUFFER_H
@@ -0,0 +1,110 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___FUNCTIONAL_MOVE_ONLY_FUNCTION_COMMON_H
+#define _LIBCPP___FUNCTIONAL_MOVE_ONLY_FUNCTION_COMMON_H
+
+#include <__config>
+#include <__utility/forward.h>
+#include <__utility/move.h>
+#include <new>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#if _LIBCPP_STD_VER > 20
+
+template <class...>
+class move_only_function;
+
+namespace __move_only_function {
+
+// The storage of the target of a move_only_function. Small targets are held
+// in place, the others are allocated on the heap.
+union __storage {
+  mutable char __small_[3 * sizeof(void*)];
+  void* __large_;
+};
+
+// True if _Fun can be held in __storage.__small_. Since moving a
+// move_only_function can't throw, the target must be nothrow movable too.
+template <class _Fun>
+inline constexpr bool __use_small_storage = sizeof(_Fun) <= sizeof(__storage) &&
+                                            alignof(_Fun) <= alignof(__storage) &&
+                                            is_nothrow_move_constructible_v<_Fun>;
+
+// Manages the lifetime of the target, in place of a vtable. A null member
+// means that the operation is a bitwise copy, or does nothing.
+struct __policy {
+  // Moves the target of the second storage to the first one, and destroys it.
+  void (*const __relocate_)(__storage*, __storage*) noexcept;
+
+  void (*const __destroy_)(__storage*) noexcept;
+};
+
+inline constexpr __policy __empty_policy = {nullptr, nullptr};
+
+template <class _Fun>
+struct __policy_for {
+  _LIBCPP_HIDE_FROM_ABI static _Fun* __get(const __storage* __s) noexcept {
+    if constexpr (__use_small_storage<_Fun>)
+      return reinterpret_cast<_Fun*>(__s->__small_);
+    else
+      return static_cast<_Fun*>(__s->__large_);
+  }
+
+  template <class... _Args>
+  _LIBCPP_HIDE_FROM_ABI static void __construct(__storage* __s, _Args&&... __args) {
+    if constexpr (__use_small_storage<_Fun>)
+      ::new ((void*)__s->__small_) _Fun(_VSTD::forward<_Args>(__args)...);
+    else
+      __s->__large_ = new _Fun(_VSTD::forward<_Args>(__args)...);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI static void __relocate(__storage* __dst, __storage* __src) noexcept {
+    _Fun* __f = __get(__src);
+    ::new ((void*)__dst->__small_) _Fun(_VSTD::move(*__f));
+    __f->~_Fun();
+  }
+
+  _LIBCPP_HIDE_FROM_ABI static void __destroy(__storage* __s) noexcept {
+    if constexpr (__use_small_storage<_Fun>)
+      __get(__s)->~_Fun();
+    else
+      delete __get(__s);
+  }
+
+  // The pointer to a large target is copied bitwise.
+  static constexpr bool __is_bitwise_relocatable =
+      !__use_small_storage<_Fun> ||
+      (is_trivially_move_constructible_v<_Fun> && is_trivially_destructible_v<_Fun>);
+
+  static constexpr bool __is_trivially_destroyed = __use_small_storage<_Fun> && is_trivially_destructible_v<_Fun>;
+
+  static constexpr __policy __value = {__is_bitwise_relocatable ? nullptr : &__relocate,
+                                       __is_trivially_destroyed ? nullptr : &__destroy};
+};
+
+template <class>
+inline constexpr bool __is_move_only_function_v = false;
+
+template <class... _Sig>
+inline constexpr bool __is_move_only_function_v<move_only_function<_Sig...>> = true;
+
+} // namespace __move_only_function
+
+#endif // _LIBCPP_STD_VER > 20
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP___FUNCTIONAL_MOVE_ONLY_FUNCTION_COMMON_H
@@ -0,0 +1,206 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// This header is unguarded on purpose. It defines the specialization of
+// move_only_function for the qualifiers given by the macros below, and is
+// included once for each of them by __functional/move_only_function.h.
+//
+// _LIBCPP_MOVE_ONLY_FUNCTION_CV        The cv-qualifier of the signature.
+// _LIBCPP_MOVE_ONLY_FUNCTION_REF       The ref-qualifier of the signature.
+// _LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT  Whether the signature is noexcept.
+//
+// The macros are undefined at the end of this header.
+
+#ifndef _LIBCPP_IN_MOVE_ONLY_FUNCTION_H
+#  error This header should only be included from __functional/move_only_function.h
+#endif
+
+#include <__config>
+#include <__debug>
+#include <__functional/invoke.h>
+#include <__functional/move_only_function_common.h>
+#include <__utility/forward.h>
+#include <__utility/in_place.h>
+#include <__utility/move.h>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+#ifndef _LIBCPP_MOVE_ONLY_FUNCTION_CV
+#  define _LIBCPP_MOVE_ONLY_FUNCTION_CV
+#endif
+
+#ifndef _LIBCPP_MOVE_ONLY_FUNCTION_REF
+#  define _LIBCPP_MOVE_ONLY_FUNCTION_REF
+#  define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS _LIBCPP_MOVE_ONLY_FUNCTION_CV&
+#else
+#  define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS _LIBCPP_MOVE_ONLY_FUNCTION_CV _LIBCPP_MOVE_ONLY_FUNCTION_REF
+#endif
+
+#ifndef _LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT
+#  define _LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT false
+#endif
+
+#define _LIBCPP_MOVE_ONLY_FUNCTION_CV_REF _LIBCPP_MOVE_ONLY_FUNCTION_CV _LIBCPP_MOVE_ONLY_FUNCTION_REF
+
+_LIBCPP_PUSH_MACROS
+#include <__undef_macros>
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+template <class _Rp, class... _ArgTypes>
+class _LIBCPP_TEMPLATE_VIS
+    move_only_function<_Rp(_ArgTypes...) _LIBCPP_MOVE_ONLY_FUNCTION_CV_REF noexcept(_LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT)> {
+  using __storage = __move_only_function::__storage;
+  using __policy = __move_only_function::__policy;
+  template <class _Fun>
+  using __policy_for = __move_only_function::__policy_for<_Fun>;
+
+  using __invoker = _Rp (*)(const __storage*, _ArgTypes&&...) noexcept(_LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT);
+
+  template <class _Fun>
+  _LIBCPP_HIDE_FROM_ABI static _Rp __invoke(const __storage* __s, _ArgTypes&&... __args) noexcept(
+      _LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT) {
+    return __invoke_void_return_wrapper<_Rp>::__call(
+        static_cast<_Fun _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS>(*__policy_for<_Fun>::__get(__s)),
+        _VSTD::forward<_ArgTypes>(__args)...);
+  }
+
+  template <class _VT>
+  static constexpr bool __is_callable_from =
+      _LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT
+          ? is_nothrow_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_CV_REF, _ArgTypes...> &&
+                is_nothrow_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS, _ArgTypes...>
+          : is_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_CV_REF, _ArgTypes...> &&
+                is_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS, _ArgTypes...>;
+
+  template <class _Fun, class... _Args>
+  _LIBCPP_HIDE_FROM_ABI void __construct(_Args&&... __args) {
+    __policy_for<_Fun>::__construct(&__storage_, _VSTD::forward<_Args>(__args)...);
+    __policy_ = &__policy_for<_Fun>::__value;
+    __invoker_ = &__invoke<_Fun>;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __move_from(move_only_function& __other) noexcept {
+    if (__other.__policy_->__relocate_)
+      __other.__policy_->__relocate_(&__storage_, &__other.__storage_);
+    else
+      __storage_ = __other.__storage_;
+    __policy_ = __other.__policy_;
+    __invoker_ = __other.__invoker_;
+    __other.__policy_ = &__move_only_function::__empty_policy;
+    __other.__invoker_ = nullptr;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __destroy() noexcept {
+    if (__policy_->__destroy_)
+      __policy_->__destroy_(&__storage_);
+  }
+
+public:
+  using result_type = _Rp;
+
+  // [func.wrap.move.ctor], constructors, assignment, and destructor
+  _LIBCPP_HIDE_FROM_ABI move_only_function() noexcept = default;
+  _LIBCPP_HIDE_FROM_ABI move_only_function(nullptr_t) noexcept {}
+  _LIBCPP_HIDE_FROM_ABI move_only_function(move_only_function&& __other) noexcept { __move_from(__other); }
+
+  template <class _Fp, class _VT = decay_t<_Fp>,
+            enable_if_t<!is_same_v<__uncvref_t<_Fp>, move_only_function> && !__is_inplace_type<_VT>::value &&
+                            __is_callable_from<_VT>,
+                        int> = 0>
+  _LIBCPP_HIDE_FROM_ABI move_only_function(_Fp&& __f) {
+    static_assert(is_constructible_v<_VT, _Fp>, "The target must be constructible from the argument");
+    if constexpr (is_member_pointer_v<_VT> || (is_pointer_v<_VT> && is_function_v<remove_pointer_t<_VT>>) ||
+                  __move_only_function::__is_move_only_function_v<_VT>) {
+      if (__f == nullptr)
+        return;
+    }
+    __construct<_VT>(_VSTD::forward<_Fp>(__f));
+  }
+
+  template <class _Tp, class... _Args,
+            enable_if_t<is_constructible_v<_Tp, _Args...> && __is_callable_from<_Tp>, int> = 0>
+  _LIBCPP_HIDE_FROM_ABI explicit move_only_function(in_place_type_t<_Tp>, _Args&&... __args) {
+    static_assert(is_same_v<decay_t<_Tp>, _Tp>, "The target type must not be cv-qualified, a reference or an array");
+    __construct<_Tp>(_VSTD::forward<_Args>(__args)...);
+  }
+
+  template <class _Tp, class _Up, class... _Args,
+            enable_if_t<is_constructible_v<_Tp, initializer_list<_Up>&, _Args...> && __is_callable_from<_Tp>, int> = 0>
+  _LIBCPP_HIDE_FROM_ABI explicit move_only_function(in_place_type_t<_Tp>, initializer_list<_Up> __il,
+                                                    _Args&&... __args) {
+    static_assert(is_same_v<decay_t<_Tp>, _Tp>, "The target type must not be cv-qualified, a reference or an array");
+    __construct<_Tp>(__il, _VSTD::forward<_Args>(__args)...);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI move_only_function& operator=(move_only_function&& __other) noexcept {
+    if (this != &__other) {
+      __destroy();
+      __move_from(__other);
+    }
+    return *this;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI move_only_function& operator=(nullptr_t) noexcept {
+    __destroy();
+    __policy_ = &__move_only_function::__empty_policy;
+    __invoker_ = nullptr;
+    return *this;
+  }
+
+  template <class _Fp>
+  _LIBCPP_HIDE_FROM_ABI move_only_function& operator=(_Fp&& __f) {
+    move_only_function(_VSTD::forward<_Fp>(__f)).swap(*this);
+    return *this;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI ~move_only_function() { __destroy(); }
+
+  // [func.wrap.move.inv], invocation
+  _LIBCPP_HIDE_FROM_ABI explicit operator bool() const noexcept { return __invoker_ != nullptr; }
+
+  _LIBCPP_HIDE_FROM_ABI _Rp operator()(_ArgTypes... __args) _LIBCPP_MOVE_ONLY_FUNCTION_CV_REF
+      noexcept(_LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT) {
+    _LIBCPP_ASSERT(__invoker_ != nullptr, "move_only_function::operator(): the function has no target");
+    return __invoker_(&__storage_, _VSTD::forward<_ArgTypes>(__args)...);
+  }
+
+  // [func.wrap.move.util], utility
+  _LIBCPP_HIDE_FROM_ABI void swap(move_only_function& __other) noexcept {
+    if (this == &__other)
+      return;
+    move_only_function __tmp(_VSTD::move(__other));
+    __other.__move_from(*this);
+    __move_from(__tmp);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI friend void swap(move_only_function& __x, move_only_function& __y) noexcept { __x.swap(__y); }
+
+  _LIBCPP_HIDE_FROM_ABI friend bool operator==(const move_only_function& __f, nullptr_t) noexcept { return !__f; }
+
+private:
+  __storage __storage_;
+  const __policy* __policy_ = &__move_only_function::__empty_policy;
+  __invoker __invoker_ = nullptr;
+};
+
+_LIBCPP_END_NAMESPACE_STD
+
+_LIBCPP_POP_MACROS
+
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_CV
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_REF
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_NOEXCEPT
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_CV_REF
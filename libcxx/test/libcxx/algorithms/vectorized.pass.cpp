@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// find, count, mismatch, equal, min_element and max_element are vectorized for
+// the contiguous ranges of integral types. Check their results around the
+// vector boundaries, and when the values are converted for the comparisons.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T>
+void test_size(std::size_t size) {
+  // Misalign the ranges, and put a sentinel value past their end.
+  std::vector<T> storage(size + 2, T(1));
+  T* first = &storage[1];
+  T* last = first + size;
+  *last = T(0);
+  std::vector<T> other(first, last);
+
+  assert(std::find(first, last, T(0)) == last);
+  assert(std::count(first, last, T(1)) == static_cast<std::ptrdiff_t>(size));
+  assert(std::mismatch(first, last, other.begin()).first == last);
+  assert(std::equal(first, last, other.begin()));
+  assert(std::min_element(first, last) == first);
+  assert(std::max_element(first, last) == first);
+
+  for (std::size_t i = 0; i != size; ++i) {
+    first[i] = T(0);
+    assert(std::find(first, last, T(0)) == first + i);
+    assert(std::count(first, last, T(0)) == 1);
+    assert(std::mismatch(first, last, other.begin()).first == first + i);
+    assert(!std::equal(first, last, other.begin()));
+    assert(std::min_element(first, last) == first + i);
+    assert(std::max_element(first, last) == (i == 0 && size > 1 ? first + 1 : first));
+
+    first[i] = T(2);
+    assert(std::max_element(first, last) == first + i);
+    first[i] = T(1);
+  }
+
+  // The first of the equal elements is found.
+  if (size > 2) {
+    first[size - 1] = first[size / 2] = T(0);
+    assert(std::find(first, last, T(0)) == first + size / 2);
+    assert(std::count(first, last, T(0)) == 2);
+    assert(std::min_element(first, last) == first + size / 2);
+    first[size - 1] = first[size / 2] = T(3);
+    assert(std::max_element(first, last) == first + size / 2);
+  }
+}
+
+template <class T>
+void test() {
+  for (std::size_t size = 0; size != 300; ++size)
+    test_size<T>(size);
+  test_size<T>(5000);
+
+  // The contiguous iterators are vectorized too.
+  std::vector<T> v(1000, T(7));
+  v[700] = T(8);
+  assert(std::find(v.begin(), v.end(), T(8)) == v.begin() + 700);
+  assert(std::count(v.begin(), v.end(), T(7)) == 999);
+  assert(std::max_element(v.begin(), v.end()) == v.begin() + 700);
+  const std::vector<T>& cv = v;
+  assert(std::min_element(cv.begin(), cv.end()) == cv.begin());
+  std::vector<T> w(v);
+  w[900] = T(6);
+  assert(std::mismatch(v.begin(), v.end(), w.begin()).second == w.begin() + 900);
+  assert(!std::equal(v.begin(), v.end(), w.begin()));
+#if TEST_STD_VER > 11
+  assert(std::mismatch(v.begin(), v.begin() + 800, w.begin(), w.end()).first == v.begin() + 800);
+  assert(std::equal(v.begin(), v.begin() + 800, w.begin(), w.begin() + 800));
+  assert(!std::equal(v.begin(), v.end(), w.begin(), w.begin() + 999));
+#endif
+}
+
+// A value which is not representable in the element type doesn't compare equal
+// to an element with the same bits, unless the usual arithmetic conversions say
+// so.
+void test_conversions() {
+  std::vector<unsigned char> uc(100, static_cast<unsigned char>(255));
+  assert(std::find(uc.begin(), uc.end(), -1) == uc.end());
+  assert(std::find(uc.begin(), uc.end(), static_cast<signed char>(-1)) == uc.end());
+  assert(std::find(uc.begin(), uc.end(), 255) == uc.begin());
+  assert(std::count(uc.begin(), uc.end(), 255 + 256) == 0);
+
+  std::vector<signed char> sc(100, static_cast<signed char>(-1));
+  assert(std::find(sc.begin(), sc.end(), 255) == sc.end());
+  assert(std::find(sc.begin(), sc.end(), -1L) == sc.begin());
+  assert(std::count(sc.begin(), sc.end(), static_cast<unsigned>(-1)) == 100);
+
+  std::vector<unsigned> u(100, static_cast<unsigned>(-1));
+  assert(std::count(u.begin(), u.end(), -1) == 100);
+  assert(std::find(u.begin(), u.end(), -1LL) == u.end());
+}
+
+int main(int, char**) {
+  test<char>();
+  test<signed char>();
+  test<unsigned char>();
+  test<short>();
+  test<unsigned short>();
+  test<int>();
+  test<unsigned>();
+  test<long>();
+  test<unsigned long>();
+  test<long long>();
+  test<unsigned long long>();
+#ifndef TEST_HAS_NO_WIDE_CHARACTERS
+  test<wchar_t>();
+#endif
+#if TEST_STD_VER >= 11
+  test<char16_t>();
+  test<char32_t>();
+#endif
+  test_conversions();
+
+  return 0;
+}
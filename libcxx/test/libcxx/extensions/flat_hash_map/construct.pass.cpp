@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03
+
+// <ext/flat_hash_map>
+
+// Check the constructors and the assignments of flat_hash_map, with the
+// allocators which propagate and those which don't.
+
+#include <ext/flat_hash_map>
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "min_allocator.h"
+#include "test_allocator.h"
+#include "test_macros.h"
+
+template <class Map>
+void check_contents(const Map& m, int n) {
+  assert(m.size() == static_cast<typename Map::size_type>(n));
+  for (int i = 0; i != n; ++i)
+    assert(m.at(i) == std::to_string(i));
+}
+
+template <class Map>
+Map make_map(int n, const typename Map::allocator_type& a = typename Map::allocator_type()) {
+  Map m(a);
+  for (int i = 0; i != n; ++i)
+    m.try_emplace(i, std::to_string(i));
+  return m;
+}
+
+template <class Alloc>
+void test() {
+  typedef __gnu_cxx::flat_hash_map<int, std::string, std::hash<int>, std::equal_to<int>, Alloc> Map;
+
+  {
+    Map m;
+    assert(m.empty());
+    assert(m.begin() == m.end());
+    assert(m.bucket_count() == 0);
+    assert(m.find(0) == m.end());
+    assert(m.load_factor() == 0.0f);
+    assert(m.max_load_factor() == 0.875f);
+  }
+  {
+    Map m(100);
+    assert(m.empty());
+    assert(m.bucket_count() >= 100);
+    // No rehash is needed for as many elements as the requested buckets.
+    typename Map::size_type buckets = m.bucket_count();
+    for (int i = 0; i != 87; ++i)
+      m.try_emplace(i);
+    assert(m.bucket_count() == buckets);
+  }
+  {
+    typename Map::value_type a[] = {{1, "1"}, {2, "2"}, {1, "one"}, {0, "0"}};
+    Map m(a, a + 4);
+    check_contents(m, 3);
+    Map l = {{0, "0"}, {2, "2"}, {1, "1"}};
+    assert(l == m);
+    l = {{5, "5"}};
+    assert(l.size() == 1 && l.at(5) == "5");
+  }
+  for (int n = 0; n < 100; n += 33) {
+    const Map m = make_map<Map>(n);
+    Map c(m);
+    check_contents(c, n);
+    assert(c == m);
+
+    Map d(std::move(c));
+    check_contents(d, n);
+    assert(c.empty());
+    assert(c.begin() == c.end());
+
+    c = d;
+    check_contents(c, n);
+    c = std::move(d);
+    check_contents(c, n);
+    assert(d.empty());
+    d = c;
+    d = *&d;
+    check_contents(d, n);
+
+    // The moved from maps can be used again.
+    d.try_emplace(1000, "1000");
+    assert(d.at(1000) == "1000");
+  }
+}
+
+void test_allocators() {
+  {
+    typedef test_allocator<std::pair<const int, std::string> > A;
+    typedef __gnu_cxx::flat_hash_map<int, std::string, std::hash<int>, std::equal_to<int>, A> Map;
+    const Map m = make_map<Map>(50, A(1));
+    assert(m.get_allocator() == A(1));
+
+    // test_allocator isn't propagated, and the elements are moved one by one
+    // when the allocators differ.
+    Map c(m, A(2));
+    check_contents(c, 50);
+    assert(c.get_allocator() == A(2));
+    Map d(std::move(c), A(3));
+    check_contents(d, 50);
+    assert(d.get_allocator() == A(3));
+    assert(c.empty());
+
+    Map e(A(4));
+    e = m;
+    check_contents(e, 50);
+    assert(e.get_allocator() == A(4));
+    e = std::move(d);
+    check_contents(e, 50);
+    assert(e.get_allocator() == A(4));
+  }
+  {
+    typedef other_allocator<std::pair<const int, std::string> > A;
+    typedef __gnu_cxx::flat_hash_map<int, std::string, std::hash<int>, std::equal_to<int>, A> Map;
+    const Map m = make_map<Map>(50, A(1));
+
+    // other_allocator is propagated on all the assignments and the swaps.
+    Map c(m);
+    assert(c.get_allocator() == A(-2));
+    Map e(A(4));
+    e = m;
+    check_contents(e, 50);
+    assert(e.get_allocator() == A(1));
+    Map f(A(5));
+    f = std::move(e);
+    check_contents(f, 50);
+    assert(f.get_allocator() == A(1));
+    Map g(A(6));
+    swap(f, g);
+    assert(f.empty() && f.get_allocator() == A(6));
+    check_contents(g, 50);
+    assert(g.get_allocator() == A(1));
+  }
+}
+
+int main(int, char**) {
+  test<std::allocator<std::pair<const int, std::string> > >();
+  test<min_allocator<std::pair<const int, std::string> > >();
+  test_allocators();
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03
+
+// <ext/flat_hash_map>
+
+// Check the lookups of flat_hash_map through its const and non-const members,
+// and that it uses the hash and the equality predicate it is given.
+
+#include <ext/flat_hash_map>
+#include <cassert>
+#include <cctype>
+#include <cstddef>
+#include <string>
+
+#include "test_macros.h"
+
+struct CaseInsensitiveHash {
+  std::size_t operator()(const std::string& s) const {
+    std::string l;
+    for (std::size_t i = 0; i != s.size(); ++i)
+      l += static_cast<char>(std::tolower(static_cast<unsigned char>(s[i])));
+    return std::hash<std::string>()(l);
+  }
+};
+
+struct CaseInsensitiveEqual {
+  bool operator()(const std::string& a, const std::string& b) const {
+    if (a.size() != b.size())
+      return false;
+    for (std::size_t i = 0; i != a.size(); ++i)
+      if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+        return false;
+    return true;
+  }
+};
+
+void test_lookup() {
+  typedef __gnu_cxx::flat_hash_map<long, long> Map;
+  Map m;
+  for (long i = 0; i != 5000; ++i)
+    m[i * 7919] = i;
+  const Map& cm = m;
+  for (long i = 0; i != 5000; ++i) {
+    Map::iterator it = m.find(i * 7919);
+    assert(it != m.end() && it->second == i);
+    Map::const_iterator cit = cm.find(i * 7919);
+    assert(cit == it);
+    assert(cm.contains(i * 7919));
+    assert(cm.count(i * 7919) == 1);
+    assert(cm.at(i * 7919) == i);
+    assert(!cm.contains(i * 7919 + 1));
+    assert(cm.find(i * 7919 + 1) == cm.end());
+  }
+
+  std::pair<Map::iterator, Map::iterator> r = m.equal_range(7919);
+  assert(r.first != r.second && r.first->second == 1);
+  ++r.first;
+  assert(r.first == r.second);
+  std::pair<Map::const_iterator, Map::const_iterator> cr = cm.equal_range(-1);
+  assert(cr.first == cm.end() && cr.second == cm.end());
+
+  // The iterators visit every element once.
+  long sum = 0;
+  for (Map::const_iterator i = cm.cbegin(); i != cm.cend(); ++i)
+    sum += i->second;
+  assert(sum == 5000L * 4999 / 2);
+}
+
+void test_custom_predicates() {
+  typedef __gnu_cxx::flat_hash_map<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> Map;
+  Map m;
+  m["Hello"] = 1;
+  m["WORLD"] = 2;
+  assert(!m.try_emplace("hello", 3).second);
+  assert(m.size() == 2);
+  assert(m.at("HELLO") == 1);
+  assert(m.find("world")->first == "WORLD");
+  assert(m.hash_function()("ABC") == m.hash_function()("abc"));
+  assert(m.key_eq()("ABC", "abc"));
+}
+
+void test_equality() {
+  typedef __gnu_cxx::flat_hash_map<int, int> Map;
+  Map a, b;
+  for (int i = 0; i != 100; ++i) {
+    a[i] = i;
+    b[99 - i] = 99 - i;
+  }
+  // The same elements are inserted in a different order, and in a table of a
+  // different size.
+  b.reserve(1000);
+  assert(a == b);
+  b[5] = 6;
+  assert(a != b);
+  b.erase(5);
+  assert(a != b);
+}
+
+int main(int, char**) {
+  test_lookup();
+  test_custom_predicates();
+  test_equality();
+
+  return 0;
+}
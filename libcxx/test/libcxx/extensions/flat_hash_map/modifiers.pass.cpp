@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03
+
+// <ext/flat_hash_map>
+
+// Check the insertions and the erasures of flat_hash_map, which leave deleted
+// slots behind them and rehash the table.
+
+#include <ext/flat_hash_map>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "test_macros.h"
+
+// All the keys are in the same group, or collide with each other.
+struct ConstantHash {
+  std::size_t operator()(int) const { return 42; }
+};
+
+struct ThrowingHash {
+  static int calls_left;
+  std::size_t operator()(int i) const {
+    if (calls_left-- == 0)
+      throw 1;
+    return static_cast<std::size_t>(i);
+  }
+};
+
+int ThrowingHash::calls_left = -1;
+
+template <class Hash>
+void test_insert_erase() {
+  typedef __gnu_cxx::flat_hash_map<int, std::string, Hash> Map;
+  Map m;
+  for (int i = 0; i != 1000; ++i) {
+    std::pair<typename Map::iterator, bool> r = m.try_emplace(i, std::to_string(i));
+    assert(r.second);
+    assert(r.first->first == i && r.first->second == std::to_string(i));
+  }
+  assert(m.size() == 1000);
+  assert(m.load_factor() <= m.max_load_factor());
+  assert(!m.try_emplace(7, "seven").second);
+  assert(m.at(7) == "7");
+
+  for (int i = 0; i != 1000; i += 2)
+    assert(m.erase(i) == 1);
+  assert(m.erase(0) == 0);
+  assert(m.size() == 500);
+  for (int i = 0; i != 1000; ++i)
+    assert(m.count(i) == static_cast<std::size_t>(i % 2));
+
+  // Inserting and erasing the same keys reuses the deleted slots, and the
+  // rehashes in place drop them.
+  typename Map::size_type buckets = m.bucket_count();
+  for (int round = 0; round != 20; ++round) {
+    for (int i = 2000; i != 2200; ++i)
+      m[i] = "x";
+    for (int i = 2000; i != 2200; ++i)
+      assert(m.erase(i) == 1);
+  }
+  assert(m.bucket_count() == buckets);
+  for (int i = 1; i < 1000; i += 2)
+    assert(m.at(i) == std::to_string(i));
+
+  std::size_t n = 0;
+  for (typename Map::iterator i = m.begin(); i != m.end(); ++i)
+    ++n;
+  assert(n == m.size());
+
+  for (typename Map::iterator i = m.begin(); i != m.end();)
+    i = m.erase(i);
+  assert(m.empty());
+  assert(m.begin() == m.end());
+}
+
+void test_insert_overloads() {
+  typedef __gnu_cxx::flat_hash_map<int, std::string> Map;
+  Map m;
+  const Map::value_type v(1, "1");
+  assert(m.insert(v).second);
+  assert(m.insert(Map::value_type(2, "2")).second);
+  assert(m.insert(std::make_pair(3, "3")).second);
+  assert(!m.insert(std::make_pair(3, "three")).second);
+  m.insert({{4, "4"}, {5, "5"}});
+  assert(m.emplace(6, "6").second);
+  assert(!m.emplace(6, "six").second);
+  assert(m.emplace(std::piecewise_construct, std::forward_as_tuple(7), std::forward_as_tuple(1, '7')).second);
+  for (int i = 1; i != 8; ++i)
+    assert(m.at(i) == std::to_string(i));
+
+  std::pair<Map::iterator, bool> r = m.insert_or_assign(1, "one");
+  assert(!r.second && r.first->second == "one");
+  r = m.insert_or_assign(8, "8");
+  assert(r.second && m.at(8) == "8");
+  m[9] = "9";
+  int k = 10;
+  m[std::move(k)] = "10";
+  assert(m.size() == 10);
+
+  Map::iterator first = m.begin();
+  Map::iterator last = first;
+  ++last;
+  ++last;
+  assert(m.erase(first, last) == last);
+  assert(m.size() == 8);
+
+  m.clear();
+  assert(m.empty());
+  assert(m.bucket_count() != 0);
+  m.rehash(0);
+  assert(m.bucket_count() == 0);
+  m.reserve(1000);
+  assert(m.bucket_count() * m.max_load_factor() >= 1000);
+}
+
+void test_swap() {
+  typedef __gnu_cxx::flat_hash_map<int, int> Map;
+  Map a = {{1, 1}, {2, 2}};
+  Map b = {{3, 3}};
+  a.swap(b);
+  assert(a.size() == 1 && a.at(3) == 3);
+  assert(b.size() == 2 && b.at(2) == 2);
+  swap(a, b);
+  assert(a.size() == 2 && b.size() == 1);
+}
+
+void test_exceptions() {
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  typedef __gnu_cxx::flat_hash_map<int, std::string, ThrowingHash> Map;
+  Map m;
+  for (int i = 0; i != 100; ++i)
+    m.try_emplace(i, std::to_string(i));
+  // A hash throwing during the rehash leaves the map empty.
+  ThrowingHash::calls_left = 50;
+  try {
+    m.rehash(1000);
+    assert(false);
+  } catch (int) {
+  }
+  ThrowingHash::calls_left = -1;
+  assert(m.empty());
+  m.try_emplace(1, "1");
+  assert(m.size() == 1 && m.at(1) == "1");
+
+  bool thrown = false;
+  try {
+    m.at(2);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  assert(thrown);
+#endif
+}
+
+int main(int, char**) {
+  test_insert_erase<std::hash<int> >();
+  test_insert_erase<ConstantHash>();
+  test_insert_overloads();
+  test_swap();
+  test_exceptions();
+
+  return 0;
+}
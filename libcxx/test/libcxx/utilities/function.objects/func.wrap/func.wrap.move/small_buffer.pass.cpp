@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// <functional>
+
+// The targets of up to three pointers which are nothrow move constructible are
+// stored in the move_only_function, without a heap allocation.
+
+#include <cassert>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "count_new.h"
+#include "test_macros.h"
+
+struct ThreePointers {
+  void* p[3] = {};
+  int operator()() const { return 1; }
+};
+
+struct FourPointers {
+  void* p[4] = {};
+  int operator()() const { return 2; }
+};
+
+struct ThrowingMove {
+  ThrowingMove() = default;
+  ThrowingMove(ThrowingMove&&) noexcept(false) {}
+  int operator()() const { return 3; }
+};
+
+struct NonTrivial {
+  int* destroyed;
+  explicit NonTrivial(int* d) : destroyed(d) {}
+  NonTrivial(NonTrivial&& other) noexcept : destroyed(std::exchange(other.destroyed, nullptr)) {}
+  ~NonTrivial() {
+    if (destroyed)
+      ++*destroyed;
+  }
+  int operator()() const { return 4; }
+};
+
+int function_pointer() { return 5; }
+
+template <class T>
+void test_allocations(T target, int expected_allocations) {
+  globalMemCounter.reset();
+  {
+    std::move_only_function<int()> f = std::move(target);
+    assert(globalMemCounter.checkNewCalledEq(expected_allocations));
+    std::move_only_function<int()> g = std::move(f);
+    std::move_only_function<int()> h;
+    h.swap(g);
+    assert(globalMemCounter.checkNewCalledEq(expected_allocations));
+    assert(h() != 0);
+  }
+  assert(globalMemCounter.checkOutstandingNewEq(0));
+}
+
+int main(int, char**) {
+  static_assert(sizeof(std::move_only_function<void()>) == 5 * sizeof(void*));
+
+  int i = 0, j = 0, k = 0;
+  test_allocations([] { return 1; }, 0);
+  test_allocations([&i, &j, &k] { return i + j + k + 1; }, 0);
+  test_allocations(function_pointer, 0);
+  test_allocations(ThreePointers{}, 0);
+  test_allocations(FourPointers{}, 1);
+  test_allocations(ThrowingMove{}, 1);
+
+  int destroyed = 0;
+  test_allocations(NonTrivial(&destroyed), 0);
+  assert(destroyed == 1);
+
+  return 0;
+}
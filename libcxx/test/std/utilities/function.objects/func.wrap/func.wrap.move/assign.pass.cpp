@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// <functional>
+
+// move_only_function& operator=(move_only_function&&);
+// move_only_function& operator=(nullptr_t) noexcept;
+// template<class F> move_only_function& operator=(F&&);
+// ~move_only_function();
+
+#include <cassert>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+
+struct Counted {
+  static int alive;
+  long padding[8] = {};
+  int value;
+  explicit Counted(int v) : value(v) { ++alive; }
+  Counted(const Counted& other) : value(other.value) { ++alive; }
+  ~Counted() { --alive; }
+  int operator()() const { return value; }
+};
+
+int Counted::alive = 0;
+
+struct SmallCounted {
+  static int alive;
+  int value;
+  explicit SmallCounted(int v) : value(v) { ++alive; }
+  SmallCounted(const SmallCounted& other) noexcept : value(other.value) { ++alive; }
+  ~SmallCounted() { --alive; }
+  int operator()() const { return value; }
+};
+
+int SmallCounted::alive = 0;
+
+template <class T>
+void test() {
+  using F = std::move_only_function<int()>;
+  static_assert(std::is_nothrow_move_assignable_v<F>);
+  static_assert(std::is_nothrow_assignable_v<F&, std::nullptr_t>);
+  static_assert(!std::is_copy_assignable_v<F>);
+  {
+    F f = T(1);
+    F g = T(2);
+    assert(T::alive == 2);
+    f = std::move(g);
+    assert(T::alive == 1);
+    assert(f() == 2);
+    assert(!g);
+
+    g = T(3);
+    assert(T::alive == 2);
+    assert(g() == 3);
+
+    g = [] { return 4; };
+    assert(T::alive == 1);
+    assert(g() == 4);
+
+    f = nullptr;
+    assert(T::alive == 0);
+    assert(!f);
+
+    f = T(5);
+    F& ref = f;
+    f = std::move(ref);
+    assert(T::alive == 1);
+    assert(f() == 5);
+
+    f = F();
+    assert(!f);
+    f = T(6);
+  }
+  assert(T::alive == 0);
+}
+
+int main(int, char**) {
+  test<Counted>();
+  test<SmallCounted>();
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// <functional>
+
+// R operator()(ArgTypes...) cv ref noexcept(noex);
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+
+enum class Called { Lvalue, ConstLvalue, Rvalue, ConstRvalue };
+
+struct Target {
+  Called operator()() & noexcept { return Called::Lvalue; }
+  Called operator()() const& noexcept { return Called::ConstLvalue; }
+  Called operator()() && noexcept { return Called::Rvalue; }
+  Called operator()() const&& noexcept { return Called::ConstRvalue; }
+};
+
+template <class Sig>
+void check(Called expected_lvalue, Called expected_rvalue) {
+  using F = std::move_only_function<Sig>;
+  F f = Target{};
+  if constexpr (std::is_invocable_v<F&>)
+    assert(f() == expected_lvalue);
+  if constexpr (std::is_invocable_v<F&&>)
+    assert(std::move(f)() == expected_rvalue);
+}
+
+// The target is invoked with the qualifiers of the signature, which are those
+// of operator() too. An unqualified signature calls an lvalue.
+void test_qualifiers() {
+  using F = std::move_only_function<void()>;
+  using CF = std::move_only_function<void() const>;
+  using LF = std::move_only_function<void() &>;
+  using CLF = std::move_only_function<void() const&>;
+  using RF = std::move_only_function<void() &&>;
+  using CRF = std::move_only_function<void() const&&>;
+
+  static_assert(std::is_invocable_v<F&> && std::is_invocable_v<F&&> && !std::is_invocable_v<const F&>);
+  static_assert(std::is_invocable_v<CF&> && std::is_invocable_v<const CF&> && std::is_invocable_v<const CF&&>);
+  static_assert(std::is_invocable_v<LF&> && !std::is_invocable_v<LF&&> && !std::is_invocable_v<const LF&>);
+  static_assert(std::is_invocable_v<CLF&> && std::is_invocable_v<CLF&&> && std::is_invocable_v<const CLF&>);
+  static_assert(!std::is_invocable_v<RF&> && std::is_invocable_v<RF&&> && !std::is_invocable_v<const RF&&>);
+  static_assert(!std::is_invocable_v<CRF&> && std::is_invocable_v<CRF&&> && std::is_invocable_v<const CRF&&>);
+
+  check<Called()>(Called::Lvalue, Called::Lvalue);
+  check<Called() const>(Called::ConstLvalue, Called::ConstLvalue);
+  check<Called() &>(Called::Lvalue, Called::Lvalue);
+  check<Called() const&>(Called::ConstLvalue, Called::ConstLvalue);
+  check<Called() &&>(Called::Rvalue, Called::Rvalue);
+  check<Called() const&&>(Called::ConstRvalue, Called::ConstRvalue);
+  check<Called() noexcept>(Called::Lvalue, Called::Lvalue);
+  check<Called() const noexcept>(Called::ConstLvalue, Called::ConstLvalue);
+  check<Called() & noexcept>(Called::Lvalue, Called::Lvalue);
+  check<Called() const& noexcept>(Called::ConstLvalue, Called::ConstLvalue);
+  check<Called() && noexcept>(Called::Rvalue, Called::Rvalue);
+  check<Called() const&& noexcept>(Called::ConstRvalue, Called::ConstRvalue);
+}
+
+void test_noexcept() {
+  static_assert(!std::is_nothrow_invocable_v<std::move_only_function<void()>&>);
+  static_assert(std::is_nothrow_invocable_v<std::move_only_function<void() noexcept>&>);
+  static_assert(std::is_nothrow_invocable_v<const std::move_only_function<void() const noexcept>&>);
+  static_assert(std::is_nothrow_invocable_v<std::move_only_function<void() && noexcept>>);
+}
+
+// The arguments are forwarded to the target, without copies.
+void test_arguments() {
+  std::move_only_function<int(std::unique_ptr<int>, int&, const int&)> f =
+      [](std::unique_ptr<int> p, int& out, const int& in) {
+        out = in;
+        return *p;
+      };
+  int out = 0;
+  assert(f(std::make_unique<int>(3), out, 7) == 3);
+  assert(out == 7);
+
+  std::move_only_function<std::unique_ptr<int>(std::unique_ptr<int>&&)> g = [](std::unique_ptr<int>&& p) {
+    return std::move(p);
+  };
+  auto p = std::make_unique<int>(5);
+  int* raw = p.get();
+  assert(g(std::move(p)).get() == raw);
+}
+
+void test_return_conversion() {
+  std::move_only_function<long(int)> f = [](int x) { return x * 2; };
+  assert(f(21) == 42L);
+  int calls = 0;
+  std::move_only_function<void()> g = [&calls] { return ++calls; };
+  g();
+  assert(calls == 1);
+  int value = 3;
+  std::move_only_function<int&()> h = [&value]() -> int& { return value; };
+  assert(&h() == &value);
+}
+
+int main(int, char**) {
+  test_qualifiers();
+  test_noexcept();
+  test_arguments();
+  test_return_conversion();
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// <functional>
+
+// move_only_function() noexcept;
+// move_only_function(nullptr_t) noexcept;
+// move_only_function(move_only_function&&) noexcept;
+// template<class F> move_only_function(F&&);
+// template<class T, class... Args>
+//   explicit move_only_function(in_place_type_t<T>, Args&&...);
+// template<class T, class U, class... Args>
+//   explicit move_only_function(in_place_type_t<T>, initializer_list<U>, Args&&...);
+
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+
+int add_one(int x) { return x + 1; }
+
+struct S {
+  int value = 5;
+  int get() const { return value; }
+};
+
+struct Large {
+  long padding[16] = {};
+  int operator()(int x) const { return x + 2; }
+};
+
+struct ThrowingMove {
+  ThrowingMove() = default;
+  ThrowingMove(ThrowingMove&&) noexcept(false) {}
+  int operator()(int x) const { return x + 3; }
+};
+
+struct ListAndValue {
+  int sum;
+  ListAndValue(std::initializer_list<int> il, int v) : sum(v) {
+    for (int i : il)
+      sum += i;
+  }
+  int operator()() const { return sum; }
+};
+
+struct MoveOnly {
+  std::unique_ptr<int> p = std::make_unique<int>(4);
+  int operator()(int x) { return *p + x; }
+};
+
+void test_empty() {
+  static_assert(std::is_nothrow_default_constructible_v<std::move_only_function<void()>>);
+  static_assert(std::is_nothrow_constructible_v<std::move_only_function<void()>, std::nullptr_t>);
+  static_assert(std::is_nothrow_move_constructible_v<std::move_only_function<void()>>);
+  static_assert(!std::is_copy_constructible_v<std::move_only_function<void()>>);
+
+  std::move_only_function<void()> f;
+  assert(!f);
+  std::move_only_function<void()> g = nullptr;
+  assert(!g);
+  std::move_only_function<void()> h = std::move(f);
+  assert(!h);
+}
+
+void test_callable() {
+  std::move_only_function<int(int)> f = add_one;
+  assert(f && f(1) == 2);
+  std::move_only_function<int(int)> g = &add_one;
+  assert(g && g(2) == 3);
+  std::move_only_function<int(int)> l = [](int x) { return x * 3; };
+  assert(l(2) == 6);
+  std::move_only_function<int(int)> large = Large{};
+  assert(large(1) == 3);
+  std::move_only_function<int(int)> throwing_move = ThrowingMove{};
+  assert(throwing_move(1) == 4);
+  std::move_only_function<int(int)> move_only = MoveOnly{};
+  assert(move_only(1) == 5);
+
+  std::move_only_function<int(S&)> mem_data = &S::value;
+  std::move_only_function<int(const S&)> mem_fn = &S::get;
+  S s;
+  assert(mem_data(s) == 5);
+  assert(mem_fn(s) == 5);
+
+  // The targets are moved with the move_only_function.
+  auto moved = std::move(move_only);
+  assert(!move_only);
+  assert(moved(2) == 6);
+  auto moved_large = std::move(large);
+  assert(!large);
+  assert(moved_large(2) == 4);
+  auto moved_throwing = std::move(throwing_move);
+  assert(!throwing_move);
+  assert(moved_throwing(2) == 5);
+}
+
+// The null function pointers, member pointers and move_only_functions make an
+// empty move_only_function.
+void test_null() {
+  int (*fp)(int) = nullptr;
+  std::move_only_function<int(int)> f = fp;
+  assert(!f);
+  int S::*mp = nullptr;
+  std::move_only_function<int(S&)> g = mp;
+  assert(!g);
+  int (S::*mfp)() const = nullptr;
+  std::move_only_function<int(const S&)> h = mfp;
+  assert(!h);
+  std::move_only_function<int(int) noexcept> empty;
+  std::move_only_function<int(int)> i = std::move(empty);
+  assert(!i);
+  std::move_only_function<int(int) noexcept> nonempty = [](int x) noexcept { return x; };
+  std::move_only_function<int(int)> j = std::move(nonempty);
+  assert(j && j(3) == 3);
+}
+
+void test_in_place() {
+  std::move_only_function<int(int)> f(std::in_place_type<Large>);
+  assert(f(1) == 3);
+  std::move_only_function<int()> g(std::in_place_type<ListAndValue>, {1, 2, 3}, 4);
+  assert(g() == 10);
+
+  static_assert(std::is_constructible_v<std::move_only_function<int(int)>, std::in_place_type_t<Large>>);
+  static_assert(!std::is_constructible_v<std::move_only_function<int(int)>, std::in_place_type_t<Large>, int>);
+  static_assert(!std::is_convertible_v<std::in_place_type_t<Large>, std::move_only_function<int(int)>>);
+}
+
+void test_constraints() {
+  static_assert(!std::is_constructible_v<std::move_only_function<int(int)>, int>);
+  static_assert(!std::is_constructible_v<std::move_only_function<int(int)>, int (*)()>);
+  static_assert(!std::is_constructible_v<std::move_only_function<int(int) noexcept>, int (*)(int)>);
+  static_assert(std::is_constructible_v<std::move_only_function<int(int)>, int (*)(int) noexcept>);
+  static_assert(std::is_constructible_v<std::move_only_function<long(int)>, int (*)(int)>);
+  static_assert(std::is_constructible_v<std::move_only_function<void(int)>, int (*)(int)>);
+
+  // The target must be invocable with the qualifiers of the signature.
+  struct NonConstCall {
+    void operator()() {}
+  };
+  static_assert(std::is_constructible_v<std::move_only_function<void()>, NonConstCall>);
+  static_assert(!std::is_constructible_v<std::move_only_function<void() const>, NonConstCall>);
+
+  // An unqualified signature requires the target to be invocable as an rvalue
+  // and as an lvalue.
+  struct LvalueCall {
+    void operator()() & {}
+  };
+  static_assert(!std::is_constructible_v<std::move_only_function<void()>, LvalueCall>);
+  static_assert(std::is_constructible_v<std::move_only_function<void() &>, LvalueCall>);
+  static_assert(!std::is_constructible_v<std::move_only_function<void() &&>, LvalueCall>);
+}
+
+int main(int, char**) {
+  test_empty();
+  test_callable();
+  test_null();
+  test_in_place();
+  test_constraints();
+
+  return 0;
+}
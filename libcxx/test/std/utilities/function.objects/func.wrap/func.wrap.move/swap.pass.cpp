@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// <functional>
+
+// explicit operator bool() const noexcept;
+// void swap(move_only_function&) noexcept;
+// friend void swap(move_only_function&, move_only_function&) noexcept;
+// friend bool operator==(const move_only_function&, nullptr_t) noexcept;
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+
+struct Large {
+  long padding[16] = {};
+  int value;
+  explicit Large(int v) : value(v) {}
+  int operator()() const { return value; }
+};
+
+int main(int, char**) {
+  using F = std::move_only_function<int()>;
+  static_assert(std::is_nothrow_swappable_v<F>);
+  static_assert(!std::is_convertible_v<F, bool>);
+  static_assert(noexcept(std::declval<F&>() == nullptr));
+
+  F small = [p = std::make_unique<int>(1)] { return *p; };
+  F large = Large(2);
+  F empty;
+
+  small.swap(large);
+  assert(small() == 2);
+  assert(large() == 1);
+
+  swap(small, empty);
+  assert(!small);
+  assert(small == nullptr);
+  assert(nullptr == small);
+  assert(empty() == 2);
+  assert(empty != nullptr);
+
+  large.swap(large);
+  assert(large() == 1);
+
+  using std::swap;
+  swap(large, empty);
+  assert(large() == 2);
+  assert(empty() == 1);
+
+  return 0;
+}
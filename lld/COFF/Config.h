@@ -121,6 +121,7 @@ struct Configuration {
   bool driverUponly = false;
   bool driverWdm = false;
   bool showTiming = false;
+  bool showTimingJSON = false;
   bool showSummary = false;
   unsigned debugTypes = static_cast<unsigned>(DebugType::None);
   std::vector<std::string> natvisFiles;
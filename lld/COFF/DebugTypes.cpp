@@ -28,6 +28,7 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
+#include <numeric>
 
 using namespace llvm;
 using namespace llvm::codeview;
@@ -1084,12 +1085,29 @@ void TypeMerger::mergeTypesWithGHash() {
   // - item records
   //   - source 0, type 1...
   //   - source 1, type 0...
-  std::vector<GHashCell> entries;
-  for (const GHashCell &cell :
-       makeArrayRef(ghashState.table.table, tableSize)) {
-    if (!cell.isEmpty())
-      entries.push_back(cell);
-  }
+  //
+  // The table is scanned in parallel: count the non-empty cells of each chunk,
+  // then copy them to their chunk's slot in the output.
+  ArrayRef<GHashCell> cells = makeArrayRef(ghashState.table.table, tableSize);
+  constexpr size_t cellsPerChunk = 1 << 16;
+  size_t numChunks = divideCeil(tableSize, cellsPerChunk);
+  auto getChunk = [&](size_t chunkIdx) {
+    return cells.slice(chunkIdx * cellsPerChunk).take_front(cellsPerChunk);
+  };
+  std::vector<size_t> chunkOffsets(numChunks + 1);
+  parallelForEachN(0, numChunks, [&](size_t chunkIdx) {
+    chunkOffsets[chunkIdx + 1] =
+        llvm::count_if(getChunk(chunkIdx),
+                       [](const GHashCell &cell) { return !cell.isEmpty(); });
+  });
+  std::partial_sum(chunkOffsets.begin(), chunkOffsets.end(),
+                   chunkOffsets.begin());
+  std::vector<GHashCell> entries(chunkOffsets.back());
+  parallelForEachN(0, numChunks, [&](size_t chunkIdx) {
+    std::copy_if(getChunk(chunkIdx).begin(), getChunk(chunkIdx).end(),
+                 entries.begin() + chunkOffsets[chunkIdx],
+                 [](const GHashCell &cell) { return !cell.isEmpty(); });
+  });
   parallelSort(entries, std::less<GHashCell>());
   log(formatv("ghash table load factor: {0:p} (size {1} / capacity {2})\n",
               tableSize ? double(entries.size()) / tableSize : 0,
@@ -1110,20 +1128,22 @@ void TypeMerger::mergeTypesWithGHash() {
   // merging will skip indices not on this list. Store the destination PDB type
   // index for these unique types in the tpiMap for each source. The entries for
   // non-unique types will be filled in prior to type merging.
-  for (uint32_t i = 0, e = entries.size(); i < e; ++i) {
-    auto &cell = entries[i];
-    uint32_t tpiSrcIdx = cell.getTpiSrcIdx();
-    TpiSource *source = ctx.tpiSourceList[tpiSrcIdx];
+  for (const GHashCell &cell : entries) {
+    TpiSource *source = ctx.tpiSourceList[cell.getTpiSrcIdx()];
     source->uniqueTypes.push_back(cell.getGHashIdx());
+  }
 
-    // Update the ghash table to store the destination PDB type index in the
-    // table.
+  // Update the ghash table to store the destination PDB type index in the
+  // table. Every entry owns a distinct cell, so this can be done in parallel.
+  parallelForEachN(0, entries.size(), [&](size_t i) {
+    const GHashCell &cell = entries[i];
+    TpiSource *source = ctx.tpiSourceList[cell.getTpiSrcIdx()];
     uint32_t pdbTypeIndex = i < numTypes ? i : i - numTypes;
     uint32_t ghashCellIndex =
         source->indexMapStorage[cell.getGHashIdx()].toArrayIndex();
     ghashState.table.table[ghashCellIndex] =
         GHashCell(cell.isItem(), cell.getTpiSrcIdx(), pdbTypeIndex);
-  }
+  });
 
   // In parallel, remap all types.
   for_each(dependencySources, [&](TpiSource *source) {
@@ -1294,8 +1294,17 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
     config->thinLTOJobs = v.str();
   }
 
-  if (args.hasArg(OPT_show_timing))
+  // Handle /time and /time:{text,json}
+  if (auto *arg = args.getLastArg(OPT_show_timing, OPT_show_timing_opt)) {
     config->showTiming = true;
+    if (arg->getOption().getID() == OPT_show_timing_opt) {
+      StringRef format = arg->getValue();
+      if (format == "json")
+        config->showTimingJSON = true;
+      else if (format != "text")
+        error("/time: unknown format: " + format);
+    }
+  }
 
   config->showSummary = args.hasArg(OPT_summary);
 
@@ -2262,7 +2271,9 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
 
   // Stop early so we can print the results.
   rootTimer.stop();
-  if (config->showTiming)
+  if (config->showTimingJSON)
+    ctx.rootTimer.printJSON(lld::outs());
+  else if (config->showTiming)
     ctx.rootTimer.print();
 }
 
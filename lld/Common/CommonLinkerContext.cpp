@@ -10,6 +10,8 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
 
+#include <atomic>
+
 using namespace llvm;
 using namespace lld;
 
@@ -20,7 +22,14 @@ using namespace lld;
 // state.
 static CommonLinkerContext *lctx;
 
-CommonLinkerContext::CommonLinkerContext() { lctx = this; }
+static uint64_t nextGeneration() {
+  static std::atomic<uint64_t> generation{0};
+  return ++generation;
+}
+
+CommonLinkerContext::CommonLinkerContext() : generation(nextGeneration()) {
+  lctx = this;
+}
 
 CommonLinkerContext::~CommonLinkerContext() {
   assert(lctx);
@@ -15,11 +15,16 @@ using namespace lld;
 SpecificAllocBase *
 lld::SpecificAllocBase::getOrCreate(void *tag, size_t size, size_t align,
                                     SpecificAllocBase *(&creator)(void *)) {
-  auto &instances = context().instances;
-  auto &instance = instances[tag];
+  CommonLinkerContext &ctx = context();
+  std::lock_guard<std::mutex> lock(ctx.instancesMutex);
+  auto &instance = ctx.instances[tag];
   if (instance == nullptr) {
-    void *storage = context().bAlloc.Allocate(size, align);
+    void *storage = ctx.bAlloc.Allocate(size, align);
     instance = creator(storage);
   }
   return instance;
 }
+
+uint64_t lld::SpecificAllocBase::getContextGeneration() {
+  return context().generation;
+}
@@ -9,27 +9,39 @@
 #include "lld/Common/Timer.h"
 #include "lld/Common/ErrorHandler.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
 #include <ratio>
 
 using namespace lld;
 using namespace llvm;
 
+static std::chrono::nanoseconds getProcessCPUTime() {
+  sys::TimePoint<> elapsed;
+  std::chrono::nanoseconds user, sys;
+  sys::Process::GetTimeUsage(elapsed, user, sys);
+  return user + sys;
+}
+
 ScopedTimer::ScopedTimer(Timer &t) : t(&t) {
   startTime = std::chrono::high_resolution_clock::now();
+  startCPUTime = getProcessCPUTime();
 }
 
 void ScopedTimer::stop() {
   if (!t)
     return;
   t->addToTotal(std::chrono::high_resolution_clock::now() - startTime);
+  t->addToCPUTotal(getProcessCPUTime() - startCPUTime);
   t = nullptr;
 }
 
 ScopedTimer::~ScopedTimer() { stop(); }
 
-Timer::Timer(llvm::StringRef name) : total(0), name(std::string(name)) {}
+Timer::Timer(llvm::StringRef name)
+    : total(0), cpuTotal(0), name(std::string(name)) {}
 Timer::Timer(llvm::StringRef name, Timer &parent)
-    : total(0), name(std::string(name)) {
+    : total(0), cpuTotal(0), name(std::string(name)) {
   parent.children.push_back(this);
 }
 
@@ -47,12 +59,36 @@ void Timer::print() {
   print(0, millis(), false);
 }
 
-double Timer::millis() const {
+static double toMillis(std::chrono::nanoseconds::rep ns) {
   return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(
-             std::chrono::nanoseconds(total))
+             std::chrono::nanoseconds(ns))
       .count();
 }
 
+double Timer::millis() const { return toMillis(total); }
+
+double Timer::cpuMillis() const { return toMillis(cpuTotal); }
+
+void Timer::printJSON(raw_ostream &os) const {
+  json::OStream j(os, 2);
+  printJSON(j);
+  os << "\n";
+}
+
+void Timer::printJSON(json::OStream &j) const {
+  j.object([&] {
+    j.attribute("name", name);
+    j.attribute("wall_ms", millis());
+    j.attribute("cpu_ms", cpuMillis());
+    j.attribute("parallelism", total > 0 ? cpuMillis() / millis() : 0.0);
+    j.attributeArray("children", [&] {
+      for (const Timer *child : children)
+        if (child->total > 0)
+          child->printJSON(j);
+    });
+  });
+}
+
 void Timer::print(int depth, double totalDuration, bool recurse) const {
   double p = 100.0 * millis() / totalDuration;
 
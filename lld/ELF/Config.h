@@ -114,6 +114,7 @@ struct Configuration {
   llvm::StringRef ltoCSProfileFile;
   llvm::StringRef ltoNewPmPasses;
   llvm::StringRef ltoObjPath;
+  llvm::StringRef ltoPartitionPasses;
   llvm::StringRef ltoSampleProfile;
   llvm::StringRef mapFile;
   llvm::StringRef outputFile;
@@ -164,6 +165,7 @@ struct Configuration {
   bool demangle = true;
   bool dependentLibraries;
   bool disableVerify;
+  bool earlyWriteBack;
   bool ehFrameHdr;
   bool emitLLVM;
   bool emitRelocs;
@@ -181,6 +183,8 @@ struct Configuration {
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool incremental;
+  bool lowMemory;
   bool ltoCSProfileGenerate;
   bool ltoPGOWarnMismatch;
   bool ltoDebugPassManager;
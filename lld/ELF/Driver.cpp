@@ -60,6 +60,7 @@
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include <cstdlib>
 #include <utility>
 
@@ -812,17 +813,36 @@ static void readCallGraph(MemoryBufferRef mb) {
   };
 
   for (StringRef line : args::getLines(mb)) {
-    SmallVector<StringRef, 3> fields;
+    SmallVector<StringRef, 8> fields;
     line.split(fields, ' ');
+    StringRef fromName, toName;
     uint64_t count;
 
-    if (fields.size() != 3 || !to_integer(fields[2], count)) {
+    if (fields.size() == 3 && to_integer(fields[2], count)) {
+      // "<from> <to> <count>"
+      fromName = fields[0];
+      toName = fields[1];
+    } else if (fields.size() == 8 && to_integer(fields[7], count)) {
+      // A branch record of a BOLT profile (.fdata):
+      // "<is_sym> <from> <offset> <is_sym> <to> <offset> <mispreds> <count>"
+      // Only calls to the entry of another function are of interest. Records
+      // whose locations are plain addresses (is_sym is 0) cannot be mapped
+      // to sections. Local symbols are qualified as <name>/<file>/<id>.
+      if (fields[0] == "0" || fields[3] == "0" || fields[5] != "0")
+        continue;
+      fromName = fields[1].split('/').first;
+      toName = fields[4].split('/').first;
+      if (fromName == toName)
+        continue;
+    } else if (line == "boltedcollection") {
+      continue;
+    } else {
       error(mb.getBufferIdentifier() + ": parse error");
       return;
     }
 
-    if (InputSectionBase *from = findSection(fields[0]))
-      if (InputSectionBase *to = findSection(fields[1]))
+    if (InputSectionBase *from = findSection(fromName))
+      if (InputSectionBase *to = findSection(toName))
         config->callGraphProfile[std::make_pair(from, to)] += count;
   }
 }
@@ -1006,6 +1026,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->discard = getDiscard(args);
   config->dwoDir = args.getLastArgValue(OPT_plugin_opt_dwo_dir_eq);
   config->dynamicLinker = getDynamicLinker(args);
+  config->earlyWriteBack =
+      args.hasFlag(OPT_early_write_back, OPT_no_early_write_back, false);
   config->ehFrameHdr =
       args.hasFlag(OPT_eh_frame_hdr, OPT_no_eh_frame_hdr, false);
   config->emitLLVM = args.hasArg(OPT_plugin_opt_emit_llvm, false);
@@ -1039,7 +1061,10 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasArg(OPT_ignore_data_address_equality);
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  config->incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false);
   config->init = args.getLastArgValue(OPT_init, "_init");
+  config->lowMemory = args.hasFlag(OPT_low_memory, OPT_no_low_memory, false);
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
   config->ltoCSProfileFile = args.getLastArgValue(OPT_lto_cs_profile_file);
@@ -1057,6 +1082,7 @@ static void readConfigs(opt::InputArgList &args) {
   config->ltoo = args::getInteger(args, OPT_lto_O, 2);
   config->ltoObjPath = args.getLastArgValue(OPT_lto_obj_path_eq);
   config->ltoPartitions = args::getInteger(args, OPT_lto_partitions, 1);
+  config->ltoPartitionPasses = args.getLastArgValue(OPT_lto_partition_passes);
   config->ltoSampleProfile = args.getLastArgValue(OPT_lto_sample_profile);
   config->ltoBasicBlockSections =
       args.getLastArgValue(OPT_lto_basic_block_sections);
@@ -2223,6 +2249,75 @@ static uint32_t getAndFeatures() {
   return ret;
 }
 
+// Returns a hash of everything the output of this link depends on: the linker
+// version, the working directory, the command line and the contents of all
+// input files. Returns None if that cannot be determined before linking.
+static Optional<uint64_t> computeLinkFingerprint(opt::InputArgList &args) {
+  // --call-graph-ordering-file is otherwise read in the middle of the link.
+  if (auto *arg = args.getLastArg(OPT_call_graph_ordering_file))
+    readFile(arg->getValue());
+
+  // Members of thin archives are read only when they are extracted.
+  for (const std::unique_ptr<MemoryBuffer> &mb : memoryBuffers)
+    if (mb->getBuffer().startswith(ThinArchiveMagic))
+      return None;
+
+  SmallString<128> cwd;
+  sys::fs::current_path(cwd);
+  SmallVector<uint64_t, 0> hashes;
+  hashes.push_back(xxHash64(getLLDVersion()));
+  hashes.push_back(xxHash64(cwd));
+  for (const opt::Arg *arg : args)
+    hashes.push_back(xxHash64(arg->getAsString(args)));
+
+  size_t begin = hashes.size();
+  hashes.resize(begin + memoryBuffers.size() * 2);
+  parallelForEachN(0, memoryBuffers.size(), [&](size_t i) {
+    hashes[begin + i * 2] = xxHash64(memoryBuffers[i]->getBufferIdentifier());
+    hashes[begin + i * 2 + 1] = xxHash64(memoryBuffers[i]->getBuffer());
+  });
+  return xxHash64(StringRef(reinterpret_cast<const char *>(hashes.data()),
+                            hashes.size() * sizeof(uint64_t)));
+}
+
+static std::string getIncrementalStatePath() {
+  return (config->outputFile + ".lld-incremental").str();
+}
+
+// The state file records the fingerprint of the link that produced the output
+// file along with the output's size and modification time, so that we notice
+// if the output has been modified by someone else since.
+static Optional<std::string> getIncrementalState(uint64_t fingerprint) {
+  sys::fs::file_status st;
+  if (sys::fs::status(config->outputFile, st))
+    return None;
+  return (Twine::utohexstr(fingerprint) + " " + Twine(st.getSize()) + " " +
+          Twine(st.getLastModificationTime().time_since_epoch().count()) +
+          "\n")
+      .str();
+}
+
+static bool isOutputUpToDate(uint64_t fingerprint) {
+  auto mbOrErr = MemoryBuffer::getFile(getIncrementalStatePath());
+  if (!mbOrErr)
+    return false;
+  Optional<std::string> state = getIncrementalState(fingerprint);
+  return state && (*mbOrErr)->getBuffer() == *state;
+}
+
+static void writeIncrementalState(uint64_t fingerprint) {
+  std::error_code ec;
+  if (Optional<std::string> state = getIncrementalState(fingerprint)) {
+    raw_fd_ostream os(getIncrementalStatePath(), ec, sys::fs::OF_None);
+    if (!ec)
+      os << *state;
+  } else {
+    ec = std::make_error_code(std::errc::no_such_file_or_directory);
+  }
+  if (ec)
+    warn("cannot write " + getIncrementalStatePath() + ": " + ec.message());
+}
+
 // Do actual linking. Note that when this function is called,
 // all linker scripts have already been parsed.
 void LinkerDriver::link(opt::InputArgList &args) {
@@ -2240,6 +2335,20 @@ void LinkerDriver::link(opt::InputArgList &args) {
   if (config->outputFile.empty())
     config->outputFile = "a.out";
 
+  // With --incremental, there is nothing to do if the output was produced by
+  // a previous link with the same inputs and options and has not been
+  // modified since. Otherwise we do a full link and record its fingerprint.
+  Optional<uint64_t> fingerprint;
+  if (config->incremental && config->outputFile != "-") {
+    llvm::TimeTraceScope timeScope("Check incremental state");
+    fingerprint = computeLinkFingerprint(args);
+    if (fingerprint && isOutputUpToDate(*fingerprint)) {
+      log(config->outputFile + " is up to date");
+      return;
+    }
+    sys::fs::remove(getIncrementalStatePath());
+  }
+
   // Fail early if the output file or map file is not writable. If a user has a
   // long link, e.g. due to a large LTO link, they do not wish to run it and
   // find that it failed because there was a mistake in their command-line.
@@ -2280,6 +2389,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
   // appended to the Files vector.
   {
     llvm::TimeTraceScope timeScope("Parse input files");
+    symtab->prepareForSymbols(files);
     for (size_t i = 0; i < files.size(); ++i) {
       llvm::TimeTraceScope timeScope("Parse input files", files[i]->getName());
       parseFile(files[i]);
@@ -2566,4 +2676,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
 
   // Write the result to the file.
   invokeELFT(writeResult);
+
+  if (fingerprint && !errorCount())
+    writeIncrementalState(*fingerprint);
 }
@@ -406,6 +406,9 @@ void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> fn) {
   // If threading is disabled or the number of sections are
   // too small to use threading, call Fn sequentially.
   if (parallel::strategy.ThreadsRequested == 1 || sections.size() < 1024) {
+    // The number of sections may have dropped below the threshold after
+    // parallel iterations. Continue with the slot which was written last.
+    current = next;
     forEachClassRange(0, sections.size(), fn);
     ++cnt;
     return;
@@ -524,6 +527,29 @@ template <class ELFT> void ICF<ELFT>::run() {
     segregate(begin, end, eqClassBase, true);
   });
 
+  // A section which is alone in its equivalence class at this point cannot be
+  // folded, because the loop below only ever splits classes. Most sections
+  // are unique, so drop them to make each iteration of the loop cheaper. Their
+  // classes no longer change, so make both slots hold the final value. The
+  // IDs of the remaining classes are not affected, but new IDs are based past
+  // the ones assigned above so that they do not collide with dropped ones.
+  size_t numSections = sections.size();
+  auto classOf = [&](size_t i) { return sections[i]->eqClass[next]; };
+  auto isUnique = [&](size_t i) {
+    return (i == 0 || classOf(i - 1) != classOf(i)) &&
+           (i + 1 == numSections || classOf(i + 1) != classOf(i));
+  };
+  SmallVector<InputSection *, 0> kept;
+  for (size_t i = 0; i != numSections; ++i) {
+    InputSection *s = sections[i];
+    if (isUnique(i))
+      s->eqClass[0] = s->eqClass[1] = classOf(i);
+    else
+      kept.push_back(s);
+  }
+  sections = std::move(kept);
+  eqClassBase += numSections;
+
   // Split groups by comparing relocations until convergence is obtained.
   do {
     repeat = false;
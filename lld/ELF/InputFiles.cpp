@@ -376,6 +376,25 @@ template <class ELFT> void ELFFileBase::init() {
   stringTable = CHECK(obj.getStringTableForSymtab(*symtabSec, sections), this);
 }
 
+template <class ELFT>
+void ELFFileBase::hashGlobalSymbolNames(std::atomic<size_t> &numDefined) {
+  ArrayRef<typename ELFT::Sym> eSyms = getGlobalELFSyms<ELFT>();
+  size_t defined = 0;
+  globalNameHashes.resize(eSyms.size());
+  for (size_t i = 0, end = eSyms.size(); i != end; ++i) {
+    // Invalid name offsets are diagnosed later by the usual code path.
+    if (LLVM_UNLIKELY(eSyms[i].st_name >= stringTable.size())) {
+      globalNameHashes.clear();
+      return;
+    }
+    globalNameHashes[i] =
+        SymbolTable::hashName(StringRef(stringTable.data() + eSyms[i].st_name));
+    if (eSyms[i].st_shndx != SHN_UNDEF)
+      ++defined;
+  }
+  numDefined += defined;
+}
+
 template <class ELFT>
 uint32_t ObjFile<ELFT>::getSectionIndex(const Elf_Sym &sym) const {
   return CHECK(
@@ -1021,6 +1040,17 @@ InputSectionBase *ObjFile<ELFT>::createInputSection(uint32_t idx,
   return make<InputSection>(*this, sec, name);
 }
 
+// Inserts the global symbol at index i of the ELF symbol table into symtab,
+// using the precomputed hash of its name if there is one.
+template <class ELFT>
+Symbol *ObjFile<ELFT>::insertGlobal(SymbolTable &symtab, size_t i) {
+  const Elf_Sym &eSym = this->getELFSyms<ELFT>()[i];
+  StringRef name = CHECK(eSym.getName(stringTable), this);
+  if (globalNameHashes.empty())
+    return symtab.insert(name);
+  return symtab.insert(name, globalNameHashes[i - firstGlobal]);
+}
+
 // Initialize this->Symbols. this->Symbols is a parallel array as
 // its corresponding ELF symbol table.
 template <class ELFT>
@@ -1068,7 +1098,8 @@ void ObjFile<ELFT>::initializeSymbols(const object::ELFFile<ELFT> &obj) {
   // Some entries have been filled by LazyObjFile.
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i)
     if (!symbols[i])
-      symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this));
+      symbols[i] = insertGlobal(symtab, i);
+  globalNameHashes = {};
 
   // Perform symbol resolution on non-local symbols.
   SmallVector<unsigned, 32> undefineds;
@@ -1790,7 +1821,7 @@ template <class ELFT> void ObjFile<ELFT>::parseLazy() {
   symbols.resize(eSyms.size());
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i)
     if (eSyms[i].st_shndx != SHN_UNDEF)
-      symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this));
+      symbols[i] = insertGlobal(symtab, i);
 
   // Replace existing symbols with LazyObject symbols.
   //
@@ -1803,6 +1834,10 @@ template <class ELFT> void ObjFile<ELFT>::parseLazy() {
       if (!lazy)
         return;
     }
+
+  // Most lazy files are never extracted. Don't keep the precomputed name
+  // hashes around for them; an extracted file rehashes its symbol names.
+  globalNameHashes = {};
 }
 
 bool InputFile::shouldExtractForCommon(StringRef name) {
@@ -1826,6 +1861,15 @@ template void BitcodeFile::parse<ELF32BE>();
 template void BitcodeFile::parse<ELF64LE>();
 template void BitcodeFile::parse<ELF64BE>();
 
+template void
+ELFFileBase::hashGlobalSymbolNames<ELF32LE>(std::atomic<size_t> &);
+template void
+ELFFileBase::hashGlobalSymbolNames<ELF32BE>(std::atomic<size_t> &);
+template void
+ELFFileBase::hashGlobalSymbolNames<ELF64LE>(std::atomic<size_t> &);
+template void
+ELFFileBase::hashGlobalSymbolNames<ELF64BE>(std::atomic<size_t> &);
+
 template class elf::ObjFile<ELF32LE>;
 template class elf::ObjFile<ELF32BE>;
 template class elf::ObjFile<ELF64LE>;
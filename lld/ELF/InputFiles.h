@@ -21,6 +21,7 @@
 #include "llvm/Object/ELF.h"
 #include "llvm/Object/IRObjectFile.h"
 #include "llvm/Support/Threading.h"
+#include <atomic>
 #include <map>
 
 namespace llvm {
@@ -43,6 +44,7 @@ using llvm::object::Archive;
 
 class InputSection;
 class Symbol;
+class SymbolTable;
 
 // If --reproduce is specified, all input files are written to this tar archive.
 extern std::unique_ptr<llvm::TarWriter> tar;
@@ -199,6 +201,16 @@ public:
     return getELFSyms<ELFT>().slice(firstGlobal);
   }
 
+  // Fills globalNameHashes and adds the number of defined global symbols to
+  // numDefined. This is thread-safe and is called for all object files in
+  // parallel before the (serial) symbol resolution.
+  template <typename ELFT>
+  void hashGlobalSymbolNames(std::atomic<size_t> &numDefined);
+
+  // Precomputed SymbolTable::hashName() values of global symbol names, in
+  // the same order as getGlobalELFSyms(). Empty if not precomputed.
+  SmallVector<uint32_t, 0> globalNameHashes;
+
 protected:
   // Initializes this class's member variables.
   template <typename ELFT> void init();
@@ -284,6 +296,7 @@ private:
                           const llvm::object::ELFFile<ELFT> &obj);
   void initializeSymbols(const llvm::object::ELFFile<ELFT> &obj);
   void initializeJustSymbols();
+  Symbol *insertGlobal(SymbolTable &symtab, size_t i);
 
   InputSectionBase *getRelocTarget(uint32_t idx, const Elf_Shdr &sec,
                                    uint32_t info);
@@ -1354,10 +1354,22 @@ void EhInputSection::split(ArrayRef<RelTy> rels) {
 }
 
 static size_t findNull(StringRef s, size_t entSize) {
-  for (unsigned i = 0, n = s.size(); i != n; i += entSize) {
-    const char *b = s.begin() + i;
-    if (std::all_of(b, b + entSize, [](char c) { return c == 0; }))
-      return i;
+  const char *b = s.begin();
+  size_t n = s.size();
+  // Compare whole characters at once for the common UTF-16 and UTF-32 cases.
+  // The byte order does not matter when comparing against zero.
+  if (entSize == 2) {
+    for (size_t i = 0; i != n; i += 2)
+      if (read16le(b + i) == 0)
+        return i;
+  } else if (entSize == 4) {
+    for (size_t i = 0; i != n; i += 4)
+      if (read32le(b + i) == 0)
+        return i;
+  } else {
+    for (size_t i = 0; i != n; i += entSize)
+      if (std::all_of(b + i, b + i + entSize, [](char c) { return c == 0; }))
+        return i;
   }
   llvm_unreachable("");
 }
@@ -1374,12 +1386,16 @@ void MergeInputSection::splitStrings(StringRef s, size_t entSize) {
   if (!std::all_of(end - entSize, end, [](char c) { return c == 0; }))
     fatal(toString(this) + ": string is not null terminated");
   if (entSize == 1) {
-    // Optimize the common case.
-    do {
+    // Optimize the common case. Counting the null characters first is cheap
+    // (the loop is vectorized) and lets us allocate all pieces at once, which
+    // matters for huge sections such as .debug_str.
+    pieces.resize_for_overwrite(std::count(p, end, '\0'));
+    for (SectionPiece &piece : pieces) {
       size_t size = strlen(p) + 1;
-      pieces.emplace_back(p - s.begin(), xxHash64(StringRef(p, size)), live);
+      piece = {size_t(p - s.begin()), (uint32_t)xxHash64(StringRef(p, size)),
+               live};
       p += size;
-    } while (p != end);
+    }
   } else {
     do {
       size_t size = findNull(StringRef(p, end - p), entSize) + entSize;
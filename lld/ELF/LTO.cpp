@@ -138,6 +138,7 @@ static lto::Config createConfig() {
   // Set up a custom pipeline if we've been asked to.
   c.OptPipeline = std::string(config->ltoNewPmPasses);
   c.AAPipeline = std::string(config->ltoAAPipeline);
+  c.PartitionOptPipeline = std::string(config->ltoPartitionPasses);
 
   // Set up optimization remarks if we've been asked to.
   c.RemarksFilename = std::string(config->optRemarksFilename);
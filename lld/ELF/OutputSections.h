@@ -26,9 +26,8 @@ class InputSection;
 class InputSectionBase;
 
 struct CompressedData {
-  std::unique_ptr<SmallVector<uint8_t, 0>[]> shards;
-  uint32_t numShards = 0;
-  uint32_t checksum = 0;
+  // A zlib stream, or empty if the section is not compressed.
+  SmallVector<char, 0> data;
   uint64_t uncompressedSize;
 };
 
@@ -18,10 +18,12 @@
 #include "LinkerScript.h"
 #include "Symbols.h"
 #include "SyntheticSections.h"
+#include "Target.h"
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace llvm::object;
@@ -56,20 +58,47 @@ void SymbolTable::wrap(Symbol *sym, Symbol *real, Symbol *wrap) {
   real->isUsedInRegularObj = false;
 }
 
+// <name>@@<version> means the symbol is the default version. In that
+// case <name>@@<version> will be used to resolve references to <name>.
+//
+// Since this is a hot path, the following string search code is
+// optimized for speed. StringRef::find(char) is much faster than
+// StringRef::find(StringRef).
+static StringRef getStem(StringRef name, size_t pos) {
+  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
+    return name.take_front(pos);
+  return name;
+}
+
+uint32_t SymbolTable::hashName(StringRef name) {
+  return CachedHashStringRef(getStem(name, name.find('@'))).hash();
+}
+
+void SymbolTable::prepareForSymbols(ArrayRef<InputFile *> files) {
+  std::atomic<size_t> numDefined{0};
+  parallelForEach(files, [&](InputFile *file) {
+    if (file->kind() == InputFile::ObjKind)
+      invokeELFT(cast<ELFFileBase>(file)->hashGlobalSymbolNames, numDefined);
+  });
+  // Most defined global symbols have distinct names while undefined ones are
+  // typically resolved by them, so the number of defined symbols is a good
+  // estimate of the final symbol table size.
+  symMap.reserve(symMap.size() + numDefined);
+  symVector.reserve(symVector.size() + numDefined);
+}
+
 // Find an existing symbol or create a new one.
 Symbol *SymbolTable::insert(StringRef name) {
-  // <name>@@<version> means the symbol is the default version. In that
-  // case <name>@@<version> will be used to resolve references to <name>.
-  //
-  // Since this is a hot path, the following string search code is
-  // optimized for speed. StringRef::find(char) is much faster than
-  // StringRef::find(StringRef).
-  StringRef stem = name;
+  return insert(name, hashName(name));
+}
+
+// Same as insert(StringRef), but with the key hash precomputed by hashName().
+Symbol *SymbolTable::insert(StringRef name, uint32_t stemHash) {
   size_t pos = name.find('@');
-  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
-    stem = name.take_front(pos);
+  StringRef stem = getStem(name, pos);
 
-  auto p = symMap.insert({CachedHashStringRef(stem), (int)symVector.size()});
+  auto p = symMap.insert(
+      {CachedHashStringRef(stem, stemHash), (int)symVector.size()});
   if (!p.second) {
     Symbol *sym = symVector[p.first->second];
     if (stem.size() != name.size()) {
@@ -38,6 +38,16 @@ public:
   void wrap(Symbol *sym, Symbol *real, Symbol *wrap);
 
   Symbol *insert(StringRef name);
+  Symbol *insert(StringRef name, uint32_t stemHash);
+
+  // Returns the hash value insert() uses as the key for a symbol name, i.e.
+  // the hash of the name with any "@@<version>" suffix stripped.
+  static uint32_t hashName(StringRef name);
+
+  // Hashes the global symbol names of input object files in parallel and
+  // reserves room for them, so that the serial symbol resolution which
+  // follows spends less time in hashing and rehashing.
+  void prepareForSymbols(ArrayRef<InputFile *> files);
 
   Symbol *addSymbol(const Symbol &newSym);
 
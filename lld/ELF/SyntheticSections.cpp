@@ -2808,7 +2808,8 @@ readPubNamesAndTypes(const LLDDwarfObj<ELFT> &obj,
 // by uniquifying them by name.
 static SmallVector<GdbIndexSection::GdbSymbol, 0> createSymbols(
     ArrayRef<SmallVector<GdbIndexSection::NameAttrEntry, 0>> nameAttrs,
-    const SmallVector<GdbIndexSection::GdbChunk, 0> &chunks) {
+    const SmallVector<GdbIndexSection::GdbChunk, 0> &chunks,
+    SmallVector<uint32_t, 0> &cuVectors) {
   using GdbSymbol = GdbIndexSection::GdbSymbol;
   using NameAttrEntry = GdbIndexSection::NameAttrEntry;
 
@@ -2834,34 +2835,59 @@ static SmallVector<GdbIndexSection::GdbSymbol, 0> createSymbols(
       std::make_unique<DenseMap<CachedHashStringRef, size_t>[]>(numShards);
   size_t shift = 32 - countTrailingZeros(numShards);
 
-  // Instantiate GdbSymbols while uniqufying them by name.
-  auto symbols = std::make_unique<SmallVector<GdbSymbol, 0>[]>(numShards);
-
-  parallelForEachN(0, concurrency, [&](size_t threadId) {
+  // Calls fn(shardId, entry, cuIndexAndAttrs) for each entry in the shards
+  // handled by the thread threadId, in a deterministic order.
+  auto forEachEntry = [&](size_t threadId, auto fn) {
     uint32_t i = 0;
     for (ArrayRef<NameAttrEntry> entries : nameAttrs) {
       for (const NameAttrEntry &ent : entries) {
         size_t shardId = ent.name.hash() >> shift;
-        if ((shardId & (concurrency - 1)) != threadId)
-          continue;
-
-        uint32_t v = ent.cuIndexAndAttrs + cuIdxs[i];
-        size_t &idx = map[shardId][ent.name];
-        if (idx) {
-          symbols[shardId][idx - 1].cuVector.push_back(v);
-          continue;
-        }
-
-        idx = symbols[shardId].size() + 1;
-        symbols[shardId].push_back({ent.name, {v}, 0, 0});
+        if ((shardId & (concurrency - 1)) == threadId)
+          fn(shardId, ent, ent.cuIndexAndAttrs + cuIdxs[i]);
       }
       ++i;
     }
+  };
+
+  // Instantiate GdbSymbols while uniqufying them by name. Rather than
+  // allocating a CU vector for each symbol, which costs a lot of memory for
+  // millions of symbols, we first count the CU vector sizes and then fill in
+  // the CU vectors in a single flat array.
+  auto symbols = std::make_unique<SmallVector<GdbSymbol, 0>[]>(numShards);
+
+  parallelForEachN(0, concurrency, [&](size_t threadId) {
+    forEachEntry(threadId, [&](size_t shardId, const NameAttrEntry &ent,
+                               uint32_t) {
+      size_t &idx = map[shardId][ent.name];
+      if (idx) {
+        ++symbols[shardId][idx - 1].cuVectorSize;
+        return;
+      }
+      idx = symbols[shardId].size() + 1;
+      symbols[shardId].push_back({ent.name, 0, 1, 0, 0});
+    });
   });
 
   size_t numSymbols = 0;
-  for (ArrayRef<GdbSymbol> v : makeArrayRef(symbols.get(), numShards))
+  size_t numCuVectorEntries = 0;
+  for (MutableArrayRef<GdbSymbol> v :
+       makeMutableArrayRef(symbols.get(), numShards)) {
     numSymbols += v.size();
+    for (GdbSymbol &sym : v) {
+      sym.cuVectorBegin = numCuVectorEntries;
+      numCuVectorEntries += sym.cuVectorSize;
+      sym.cuVectorSize = 0;
+    }
+  }
+
+  cuVectors.resize_for_overwrite(numCuVectorEntries);
+  parallelForEachN(0, concurrency, [&](size_t threadId) {
+    forEachEntry(threadId, [&](size_t shardId, const NameAttrEntry &ent,
+                               uint32_t v) {
+      GdbSymbol &sym = symbols[shardId][map[shardId].lookup(ent.name) - 1];
+      cuVectors[sym.cuVectorBegin + sym.cuVectorSize++] = v;
+    });
+  });
 
   // The return type is a flattened vector, so we'll copy each vector
   // contents to Ret.
@@ -2877,7 +2903,7 @@ static SmallVector<GdbIndexSection::GdbSymbol, 0> createSymbols(
   size_t off = 0;
   for (GdbSymbol &sym : ret) {
     sym.cuVectorOff = off;
-    off += (sym.cuVector.size() + 1) * 4;
+    off += (sym.cuVectorSize + 1) * 4;
   }
   for (GdbSymbol &sym : ret) {
     sym.nameOff = off;
@@ -2934,7 +2960,7 @@ template <class ELFT> GdbIndexSection *GdbIndexSection::create() {
 
   auto *ret = make<GdbIndexSection>();
   ret->chunks = std::move(chunks);
-  ret->symbols = createSymbols(nameAttrs, ret->chunks);
+  ret->symbols = createSymbols(nameAttrs, ret->chunks, ret->cuVectors);
   ret->initOutputSize();
   return ret;
 }
@@ -2999,9 +3025,10 @@ void GdbIndexSection::writeTo(uint8_t *buf) {
 
   // Write the CU vectors.
   for (GdbSymbol &sym : symbols) {
-    write32le(buf, sym.cuVector.size());
+    write32le(buf, sym.cuVectorSize);
     buf += 4;
-    for (uint32_t val : sym.cuVector) {
+    for (uint32_t val : makeArrayRef(cuVectors).slice(sym.cuVectorBegin,
+                                                      sym.cuVectorSize)) {
       write32le(buf, val);
       buf += 4;
     }
@@ -791,7 +791,10 @@ public:
 
   struct GdbSymbol {
     llvm::CachedHashStringRef name;
-    SmallVector<uint32_t, 0> cuVector;
+    // The CU vector of this symbol is cuVectors[cuVectorBegin, cuVectorBegin +
+    // cuVectorSize).
+    uint32_t cuVectorBegin;
+    uint32_t cuVectorSize;
     uint32_t nameOff;
     uint32_t cuVectorOff;
   };
@@ -822,6 +825,9 @@ private:
   // A symbol table for this .gdb_index section.
   SmallVector<GdbSymbol, 0> symbols;
 
+  // The CU vectors of all symbols, concatenated.
+  SmallVector<uint32_t, 0> cuVectors;
+
   size_t size;
 };
 
@@ -597,6 +597,7 @@ template <class ELFT> void Writer<ELFT>::run() {
     if (errorCount())
       return;
 
+    llvm::TimeTraceScope commitTimeScope("Commit output file");
     if (auto e = buffer->commit())
       error("failed to write to the output file: " + toString(std::move(e)));
   }
@@ -2881,8 +2882,69 @@ template <class ELFT> void Writer<ELFT>::writeTrapInstr() {
 }
 
 // Write section contents to a mmap'ed file.
+namespace {
+// For --low-memory. Drops the pages of an input file buffer from memory once
+// all input sections referring to it have been written to the output. The
+// pages are read in again from the file if they are accessed later (e.g. for
+// symbol names when writing .strtab), so this is only an optimization.
+class InputBufferReleaser {
+public:
+  InputBufferReleaser(ArrayRef<OutputSection *> outputSections) {
+    for (const std::unique_ptr<MemoryBuffer> &mb : memoryBuffers)
+      if (mb->getBufferKind() == MemoryBuffer::MemoryBuffer_MMap)
+        buffers.push_back(mb.get());
+    llvm::sort(buffers, [](MemoryBuffer *a, MemoryBuffer *b) {
+      return a->getBufferStart() < b->getBufferStart();
+    });
+    for (OutputSection *sec : outputSections)
+      for (InputSection *isec : getInputSections(*sec))
+        if (MemoryBuffer *mb = getBuffer(isec))
+          ++numPendingSections[mb];
+  }
+
+  // Called after the given output section has been written.
+  void written(const OutputSection &sec) {
+    for (InputSection *isec : getInputSections(sec)) {
+      MemoryBuffer *mb = getBuffer(isec);
+      if (!mb || --numPendingSections[mb] != 0)
+        continue;
+      mb->dontNeedIfMmap();
+      releasedBytes += mb->getBufferSize();
+    }
+  }
+
+  void printStats() const {
+    log("--low-memory: released " + Twine(releasedBytes) +
+        " bytes of input files");
+  }
+
+private:
+  // Returns the buffer containing the contents of isec, if it comes from an
+  // mmap'ed input file. Members of an archive share the archive's buffer.
+  MemoryBuffer *getBuffer(const InputSection *isec) const {
+    if (!isec->file)
+      return nullptr;
+    const char *p = isec->file->mb.getBufferStart();
+    auto it =
+        llvm::upper_bound(buffers, p, [](const char *a, MemoryBuffer *mb) {
+          return a < mb->getBufferStart();
+        });
+    if (it == buffers.begin() || p >= it[-1]->getBufferEnd())
+      return nullptr;
+    return it[-1];
+  }
+
+  SmallVector<MemoryBuffer *, 0> buffers;
+  DenseMap<MemoryBuffer *, size_t> numPendingSections;
+  uint64_t releasedBytes = 0;
+};
+} // namespace
+
 template <class ELFT> void Writer<ELFT>::writeSections() {
   llvm::TimeTraceScope timeScope("Write sections");
+  Optional<InputBufferReleaser> releaser;
+  if (config->lowMemory)
+    releaser.emplace(outputSections);
 
   // In -r or --emit-relocs mode, write the relocation sections first as in
   // ELf_Rel targets we might find out that we need to modify the relocated
@@ -2891,9 +2953,19 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
     if (sec->type == SHT_REL || sec->type == SHT_RELA)
       sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
 
-  for (OutputSection *sec : outputSections)
-    if (sec->type != SHT_REL && sec->type != SHT_RELA)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+  for (OutputSection *sec : outputSections) {
+    if (sec->type == SHT_REL || sec->type == SHT_RELA)
+      continue;
+    sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+    // Let the OS write the finished section to disk while we are working on
+    // the following ones, rather than flushing everything on commit().
+    if (config->earlyWriteBack && sec->type != SHT_NOBITS)
+      buffer->startWriteBack(sec->offset, sec->size);
+    if (releaser)
+      releaser->written(*sec);
+  }
+  if (releaser)
+    releaser->printStats();
 
   // Finally, check that all dynamic relocation addends were written correctly.
   if (config->checkDynamicRelocs && config->writeAddends) {
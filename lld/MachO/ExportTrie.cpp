@@ -42,6 +42,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/BinaryFormat/MachO.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace lld;
@@ -86,32 +87,39 @@ struct macho::TrieNode {
   // This will converge to the true offset when updateOffset() is run to a
   // fixpoint.
   size_t offset = 0;
+  // Size of the node, excluding the uleb128-encoded offsets of its children.
+  // Unlike those, it does not change while the offsets converge.
+  size_t fixedSize = 0;
 
+  void computeFixedSize();
   // Returns whether the new estimated offset differs from the old one.
   bool updateOffset(size_t &nextOffset);
   void writeTo(uint8_t *buf) const;
 };
 
-bool TrieNode::updateOffset(size_t &nextOffset) {
+void TrieNode::computeFixedSize() {
   // Size of the whole node (including the terminalSize and the outgoing edges.)
   // In contrast, terminalSize only records the size of the other data in the
   // node.
-  size_t nodeSize;
   if (info) {
     uint32_t terminalSize =
         getULEB128Size(info->flags) + getULEB128Size(info->address);
     // Overall node size so far is the uleb128 size of the length of the symbol
     // info + the symbol info itself.
-    nodeSize = terminalSize + getULEB128Size(terminalSize);
+    fixedSize = terminalSize + getULEB128Size(terminalSize);
   } else {
-    nodeSize = 1; // Size of terminalSize (which has a value of 0)
+    fixedSize = 1; // Size of terminalSize (which has a value of 0)
   }
+  ++fixedSize; // Byte for number of children.
+  for (const Edge &edge : edges)
+    fixedSize += edge.substring.size() + 1; // String length.
+}
+
+bool TrieNode::updateOffset(size_t &nextOffset) {
   // Compute size of all child edges.
-  ++nodeSize; // Byte for number of children.
-  for (const Edge &edge : edges) {
-    nodeSize += edge.substring.size() + 1             // String length.
-                + getULEB128Size(edge.child->offset); // Offset len.
-  }
+  size_t nodeSize = fixedSize;
+  for (const Edge &edge : edges)
+    nodeSize += getULEB128Size(edge.child->offset); // Offset len.
   // On input, 'nextOffset' is the new preferred location for this node.
   bool result = (offset != nextOffset);
   // Store new location in node object for use by parents.
@@ -224,6 +232,8 @@ size_t TrieBuilder::build() {
   TrieNode *root = makeNode();
   sortAndBuild(exported, root, 0, 0);
 
+  parallelForEach(nodes, [](TrieNode *node) { node->computeFixedSize(); });
+
   // Assign each node in the vector an offset in the trie stream, iterating
   // until all uleb128 sizes have stabilized.
   size_t offset;
@@ -239,8 +249,8 @@ size_t TrieBuilder::build() {
 }
 
 void TrieBuilder::writeTo(uint8_t *buf) const {
-  for (TrieNode *node : nodes)
-    node->writeTo(buf);
+  // Each node is written to its own range of the buffer.
+  parallelForEach(nodes, [&](TrieNode *node) { node->writeTo(buf); });
 }
 
 namespace {
@@ -185,13 +185,19 @@ void CStringInputSection::splitIntoPieces() {
     if (end == StringRef::npos)
       fatal(toString(this) + ": string is not null terminated");
     size_t size = end + 1;
-    uint32_t hash = config->dedupLiterals ? xxHash64(s.substr(0, size)) : 0;
-    pieces.emplace_back(off, hash);
+    // Hashes are computed later by computeHashes(), and only for live pieces.
+    pieces.emplace_back(off, 0);
     s = s.substr(size);
     off += size;
   }
 }
 
+void CStringInputSection::computeHashes() {
+  for (size_t i = 0, e = pieces.size(); i != e; ++i)
+    if (pieces[i].live)
+      pieces[i].hash = static_cast<uint32_t>(xxHash64(getStringRef(i)));
+}
+
 StringPiece &CStringInputSection::getStringPiece(uint64_t off) {
   if (off >= data.size())
     fatal(toString(this) + ": offset is outside the section");
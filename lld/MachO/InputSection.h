@@ -170,7 +170,7 @@ struct StringPiece {
   // Offset from the start of the containing input section.
   uint32_t inSecOff;
   uint32_t live : 1;
-  // Only set if deduplicating literals
+  // Only set if deduplicating literals, after dead-stripping.
   uint32_t hash : 31;
   // Offset from the start of the containing output section.
   uint64_t outSecOff = 0;
@@ -205,6 +205,8 @@ public:
   const StringPiece &getStringPiece(uint64_t off) const;
   // Split at each null byte.
   void splitIntoPieces();
+  // Compute the hashes of the live pieces for deduplication.
+  void computeHashes();
 
   LLVM_ATTRIBUTE_ALWAYS_INLINE
   StringRef getStringRef(size_t i) const {
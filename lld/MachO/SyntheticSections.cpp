@@ -22,6 +22,7 @@
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SHA256.h"
 
@@ -202,12 +203,18 @@ void RebaseSection::finalizeContents() {
 
   os << static_cast<uint8_t>(REBASE_OPCODE_SET_TYPE_IMM | REBASE_TYPE_POINTER);
 
-  llvm::sort(locations, [](const Location &a, const Location &b) {
-    return a.isec->getVA(a.offset) < b.isec->getVA(b.offset);
+  // Computing a VA is not free, so compute each one once, in parallel, rather
+  // than in every comparison of the sort.
+  std::vector<std::pair<uint64_t, const Location *>> sorted(locations.size());
+  parallelForEachN(0, locations.size(), [&](size_t i) {
+    sorted[i] = {locations[i].isec->getVA(locations[i].offset), &locations[i]};
   });
-  for (const Location &loc : locations)
+  parallelSort(sorted, less_first());
+  for (const auto &p : sorted) {
+    const Location &loc = *p.second;
     encodeRebase(loc.isec->parent, loc.isec->getOffset(loc.offset), lastRebase,
                  os);
+  }
   if (lastRebase.consecutiveCount != 0)
     encodeDoRebase(lastRebase, os);
 
@@ -1379,6 +1386,11 @@ DeduplicatedCStringSection::DeduplicatedCStringSection()
     : builder(StringTableBuilder::RAW, /*Alignment=*/16) {}
 
 void DeduplicatedCStringSection::finalizeContents() {
+  // Hashing the strings is the expensive part of deduplication, and it is
+  // independent for each input section.
+  parallelForEach(inputs,
+                  [](CStringInputSection *isec) { isec->computeHashes(); });
+
   // Add all string pieces to the string table builder to create section
   // contents.
   for (CStringInputSection *isec : inputs) {
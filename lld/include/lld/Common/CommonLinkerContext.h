@@ -23,6 +23,8 @@
 #include "lld/Common/Memory.h"
 #include "llvm/CodeGen/CommandFlags.h"
 #include "llvm/Support/StringSaver.h"
+#include <cstdint>
+#include <mutex>
 
 namespace llvm {
 class raw_ostream;
@@ -40,6 +42,11 @@ public:
   llvm::BumpPtrAllocator bAlloc;
   llvm::StringSaver saver{bAlloc};
   llvm::DenseMap<void *, SpecificAllocBase *> instances;
+  // Guards instances, and bAlloc while it allocates them.
+  std::mutex instancesMutex;
+  // Distinguishes this context from earlier ones at the same address; see
+  // getSpecificAllocSingleton().
+  const uint64_t generation;
 
   ErrorHandler e;
 
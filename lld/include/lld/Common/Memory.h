@@ -22,6 +22,9 @@
 #define LLD_COMMON_MEMORY_H
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/PerThreadAllocator.h"
+#include <cstdint>
 
 namespace lld {
 // A base class only used by the CommonLinkerContext to keep track of the
@@ -30,14 +33,18 @@ struct SpecificAllocBase {
   virtual ~SpecificAllocBase() = default;
   static SpecificAllocBase *getOrCreate(void *tag, size_t size, size_t align,
                                         SpecificAllocBase *(&creator)(void *));
+  // Identifies the current CommonLinkerContext; unlike its address, this is
+  // never reused by a later context.
+  static uint64_t getContextGeneration();
 };
 
-// An arena of specific types T, created on-demand.
+// An arena of specific types T, created on-demand. Each thread allocates from
+// an arena of its own, so that make<T>() can be used from parallel code.
 template <class T> struct SpecificAlloc : public SpecificAllocBase {
   static SpecificAllocBase *create(void *storage) {
     return new (storage) SpecificAlloc<T>();
   }
-  llvm::SpecificBumpPtrAllocator<T> alloc;
+  llvm::PerThreadAllocator<llvm::SpecificBumpPtrAllocator<T>> alloc;
   static int tag;
 };
 
@@ -46,13 +53,21 @@ template <class T> struct SpecificAlloc : public SpecificAllocBase {
 template <class T> int SpecificAlloc<T>::tag = 0;
 
 // Creates the arena on-demand on the first call; or returns it, if it was
-// already created.
+// already created. Returns the calling thread's part of the arena.
 template <typename T>
 inline llvm::SpecificBumpPtrAllocator<T> &getSpecificAllocSingleton() {
-  SpecificAllocBase *instance = SpecificAllocBase::getOrCreate(
-      &SpecificAlloc<T>::tag, sizeof(SpecificAlloc<T>),
-      alignof(SpecificAlloc<T>), SpecificAlloc<T>::create);
-  return ((SpecificAlloc<T> *)instance)->alloc;
+  // Remember the arena per thread, so that the lookup in the context, which
+  // takes a lock, is only done once per thread and context.
+  static LLVM_THREAD_LOCAL SpecificAllocBase *cached = nullptr;
+  static LLVM_THREAD_LOCAL uint64_t cachedGeneration = 0;
+  uint64_t generation = SpecificAllocBase::getContextGeneration();
+  if (LLVM_UNLIKELY(cachedGeneration != generation)) {
+    cached = SpecificAllocBase::getOrCreate(
+        &SpecificAlloc<T>::tag, sizeof(SpecificAlloc<T>),
+        alignof(SpecificAlloc<T>), SpecificAlloc<T>::create);
+    cachedGeneration = generation;
+  }
+  return ((SpecificAlloc<T> *)cached)->alloc.get();
 }
 
 // Creates new instances of T off a (almost) contiguous arena/object pool. The
@@ -18,6 +18,13 @@
 #include <memory>
 #include <vector>
 
+namespace llvm {
+class raw_ostream;
+namespace json {
+class OStream;
+} // namespace json
+} // namespace llvm
+
 namespace lld {
 
 class Timer;
@@ -31,6 +38,9 @@ struct ScopedTimer {
 
   std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
 
+  // Process CPU time (user and system, summed over all threads) at start.
+  std::chrono::nanoseconds startCPUTime;
+
   Timer *t = nullptr;
 };
 
@@ -42,14 +52,24 @@ public:
   explicit Timer(llvm::StringRef name);
 
   void addToTotal(std::chrono::nanoseconds time) { total += time.count(); }
+  void addToCPUTotal(std::chrono::nanoseconds time) {
+    cpuTotal += time.count();
+  }
   void print();
 
+  // Prints this timer and its children as a JSON object. For each phase, the
+  // ratio of CPU time to wall time is its effective parallelism.
+  void printJSON(llvm::raw_ostream &os) const;
+
   double millis() const;
+  double cpuMillis() const;
 
 private:
   void print(int depth, double totalDuration, bool recurse = true) const;
+  void printJSON(llvm::json::OStream &j) const;
 
   std::atomic<std::chrono::nanoseconds::rep> total;
+  std::atomic<std::chrono::nanoseconds::rep> cpuTotal;
   std::vector<Timer *> children;
   std::string name;
 };
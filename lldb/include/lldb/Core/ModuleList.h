@@ -462,6 +462,14 @@ public:
   void ForEach(std::function<bool(const lldb::ModuleSP &module_sp)> const
                    &callback) const;
 
+  /// Preload the symbols of all the modules in the list.
+  ///
+  /// \param[in] parallelize
+  ///     If true, the modules are preloaded in parallel. Each module has
+  ///     its own lock, so this scales with the number of modules when many
+  ///     of them are loaded at once, e.g. when attaching to a process.
+  void PreloadSymbols(bool parallelize) const;
+
 protected:
   // Class typedefs.
   typedef std::vector<lldb::ModuleSP>
@@ -44,6 +44,13 @@ public:
                       const lldb::DataBufferSP &data_buffer_sp);
 
 protected:
+  /// Read from the process the cache lines, starting at the one at
+  /// \a line_addr, that hold the next \a byte_size bytes and aren't cached
+  /// yet, and add them to the L2 cache. Returns false if nothing could be
+  /// read.
+  bool ReadL2CacheLines(lldb::addr_t line_addr, size_t byte_size,
+                        Status &error);
+
   typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
   typedef RangeVector<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
   typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
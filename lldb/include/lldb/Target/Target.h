@@ -562,6 +562,18 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// While deferred, GetOrCreateModule doesn't preload the symbols of the
+  /// modules it creates, so that a caller adding many modules at once can
+  /// preload them in parallel with ModuleList::PreloadSymbols().
+  ///
+  /// \return
+  ///     The previous value.
+  bool SetDeferPreloadSymbols(bool defer) {
+    bool old_value = m_defer_preload_symbols;
+    m_defer_preload_symbols = defer;
+    return old_value;
+  }
+
   // Settings accessors
 
   static TargetProperties &GetGlobalProperties();
@@ -1472,6 +1484,7 @@ protected:
   bool m_valid;
   bool m_suppress_stop_hooks; /// Used to not run stop hooks for expressions
   bool m_is_dummy_target;
+  bool m_defer_preload_symbols = false;
   unsigned m_next_persistent_variable_index = 0;
   /// An optional \a lldb_private::Trace object containing processor trace
   /// information of this target.
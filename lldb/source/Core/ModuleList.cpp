@@ -34,6 +34,7 @@
 #include "clang/Driver/Driver.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -1059,3 +1060,22 @@ void ModuleList::ForEach(
       break;
   }
 }
+
+void ModuleList::PreloadSymbols(bool parallelize) const {
+  // Preload from a copy of the list, so that the list isn't locked while the
+  // symbols are parsed.
+  collection modules;
+  {
+    std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+    modules = m_modules;
+  }
+  if (!parallelize || modules.size() < 2) {
+    for (const ModuleSP &module_sp : modules)
+      module_sp->PreloadSymbols();
+    return;
+  }
+  llvm::ThreadPool pool(llvm::optimal_concurrency(modules.size()));
+  for (const ModuleSP &module_sp : modules)
+    pool.async([module_sp]() { module_sp->PreloadSymbols(); });
+  pool.wait();
+}
@@ -605,6 +605,13 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
+  // Attaching to a process can load hundreds of modules at once. Their
+  // symbols are preloaded in parallel once they are all created, rather than
+  // one after the other as each of them is added to the target.
+  Target &target = m_process->GetTarget();
+  const bool preload_symbols = target.GetPreloadSymbols();
+  const bool old_defer = target.SetDeferPreloadSymbols(preload_symbols);
+
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
         LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -621,7 +628,11 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
     }
   }
 
-  m_process->GetTarget().ModulesDidLoad(module_list);
+  target.SetDeferPreloadSymbols(old_defer);
+  if (preload_symbols)
+    module_list.PreloadSymbols(/*parallelize=*/true);
+
+  target.ModulesDidLoad(module_list);
   m_initial_modules_added = true;
 }
 
@@ -363,16 +363,35 @@ public:
       assert(&decl->getASTContext() != origin.ctx &&
              "Trying to set decl origin to its own ASTContext?");
       assert(decl != origin.decl && "Trying to set decl origin to itself?");
-      m_origins[decl] = origin;
+      auto inserted = m_origins.try_emplace(decl, origin);
+      if (!inserted.second) {
+        releaseOriginContext(inserted.first->second.ctx);
+        inserted.first->second = origin;
+      }
+      ++m_origin_counts[origin.ctx];
     }
 
     /// Removes any tracked DeclOrigin for the given decl.
-    void removeOrigin(const clang::Decl *decl) { m_origins.erase(decl); }
+    void removeOrigin(const clang::Decl *decl) {
+      auto iter = m_origins.find(decl);
+      if (iter == m_origins.end())
+        return;
+      releaseOriginContext(iter->second.ctx);
+      m_origins.erase(iter);
+    }
 
     /// Remove all DeclOrigin entries that point to the given ASTContext.
     /// Useful when an ASTContext is about to be deleted and all the dangling
     /// pointers to it need to be removed.
     void removeOriginsWithContext(clang::ASTContext *ctx) {
+      // Every expression forgets its own ASTContext in the scratch AST when it
+      // is done, and the origins of the scratch AST only grow over a debug
+      // session. Most expressions are never the origin of any decl there, so
+      // only walk the origins when some of them point to the context.
+      auto count = m_origin_counts.find(ctx);
+      if (count == m_origin_counts.end())
+        return;
+      m_origin_counts.erase(count);
       for (OriginMap::iterator iter = m_origins.begin();
            iter != m_origins.end();) {
         if (iter->second.ctx == ctx)
@@ -397,12 +416,21 @@ public:
     }
 
   private:
+    void releaseOriginContext(clang::ASTContext *ctx) {
+      auto count = m_origin_counts.find(ctx);
+      assert(count != m_origin_counts.end() && "Origin context not counted?");
+      if (--count->second == 0)
+        m_origin_counts.erase(count);
+    }
+
     /// Maps declarations to the ASTContext/Decl from which they were imported
     /// from. If a declaration is from an ASTContext which has been deleted
     /// since the declaration was imported or the declaration wasn't created by
     /// the ASTImporter, then it doesn't have a DeclOrigin and will not be
     /// tracked here.
     OriginMap m_origins;
+    /// The number of entries in m_origins that point to each ASTContext.
+    llvm::DenseMap<const clang::ASTContext *, unsigned> m_origin_counts;
   };
 
   typedef std::shared_ptr<ASTContextMetadata> ASTContextMetadataSP;
@@ -304,7 +304,9 @@ static void SetupModuleHeaderPaths(CompilerInstance *compiler,
 
 /// Iff the given identifier is a C++ keyword, remove it from the
 /// identifier table (i.e., make the token a normal identifier).
-static void RemoveCppKeyword(IdentifierTable &idents, llvm::StringRef token) {
+static void RemoveCppKeyword(IdentifierTable &idents,
+                             const LangOptions &cpp_lang_opts,
+                             llvm::StringRef token) {
   // FIXME: 'using' is used by LLDB for local variables, so we can't remove
   // this keyword without breaking this functionality.
   if (token == "using")
@@ -313,11 +315,6 @@ static void RemoveCppKeyword(IdentifierTable &idents, llvm::StringRef token) {
   if (token == "__null")
     return;
 
-  LangOptions cpp_lang_opts;
-  cpp_lang_opts.CPlusPlus = true;
-  cpp_lang_opts.CPlusPlus11 = true;
-  cpp_lang_opts.CPlusPlus20 = true;
-
   clang::IdentifierInfo &ii = idents.get(token);
   // The identifier has to be a C++-exclusive keyword. if not, then there is
   // nothing to do.
@@ -333,7 +330,13 @@ static void RemoveCppKeyword(IdentifierTable &idents, llvm::StringRef token) {
 
 /// Remove all C++ keywords from the given identifier table.
 static void RemoveAllCppKeywords(IdentifierTable &idents) {
-#define KEYWORD(NAME, FLAGS) RemoveCppKeyword(idents, llvm::StringRef(#NAME));
+  // Build the options once, rather than once for each of the keywords.
+  LangOptions cpp_lang_opts;
+  cpp_lang_opts.CPlusPlus = true;
+  cpp_lang_opts.CPlusPlus11 = true;
+  cpp_lang_opts.CPlusPlus20 = true;
+#define KEYWORD(NAME, FLAGS)                                                   \
+  RemoveCppKeyword(idents, cpp_lang_opts, llvm::StringRef(#NAME));
 #include "clang/Basic/TokenKinds.def"
 }
 
@@ -100,16 +100,30 @@ bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
   if (identifier != kIdentifierNameToDIE)
     return false;
   const uint32_t count = data.GetU32(offset_ptr);
+  m_map.Reserve(count);
+  // The entries of each name are consecutive, so only intern a name when it
+  // differs from the previous one.
+  uint32_t prev_strtab_offset = UINT32_MAX;
+  ConstString name;
   for (uint32_t i = 0; i < count; ++i) {
-    llvm::StringRef str(strtab.Get(data.GetU32(offset_ptr)));
-    // No empty strings allowed in the name to DIE maps.
-    if (str.empty())
-      return false;
+    const uint32_t strtab_offset = data.GetU32(offset_ptr);
+    if (strtab_offset != prev_strtab_offset) {
+      llvm::StringRef str(strtab.Get(strtab_offset));
+      // No empty strings allowed in the name to DIE maps.
+      if (str.empty())
+        return false;
+      name = ConstString(str);
+      prev_strtab_offset = strtab_offset;
+    }
     if (llvm::Optional<DIERef> die_ref = DIERef::Decode(data, offset_ptr))
-      m_map.Append(ConstString(str), die_ref.getValue());
+      m_map.Append(name, die_ref.getValue());
     else
       return false;
   }
+  // The map is sorted by the addresses of the ConstString objects, which are
+  // not the same in the process that saved the map, so it has to be sorted
+  // again before it can be searched.
+  m_map.Sort(std::less<DIERef>());
   return true;
 }
 
@@ -13,6 +13,7 @@
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/State.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
 
@@ -179,76 +180,88 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
       }
 
       BlockMap::const_iterator pos = m_L2_cache.find(curr_addr);
-      BlockMap::const_iterator end = m_L2_cache.end();
-
-      if (pos != end) {
-        size_t curr_read_size = cache_line_byte_size - cache_offset;
-        if (curr_read_size > bytes_left)
-          curr_read_size = bytes_left;
-
-        memcpy(dst_buf + dst_len - bytes_left,
-               pos->second->GetBytes() + cache_offset, curr_read_size);
-
-        bytes_left -= curr_read_size;
-        curr_addr += curr_read_size + cache_offset;
-        cache_offset = 0;
-
-        if (bytes_left > 0) {
-          // Get sequential cache page hits
-          for (++pos; (pos != end) && (bytes_left > 0); ++pos) {
-            assert((curr_addr % cache_line_byte_size) == 0);
-
-            if (pos->first != curr_addr)
-              break;
-
-            curr_read_size = pos->second->GetByteSize();
-            if (curr_read_size > bytes_left)
-              curr_read_size = bytes_left;
-
-            memcpy(dst_buf + dst_len - bytes_left, pos->second->GetBytes(),
-                   curr_read_size);
-
-            bytes_left -= curr_read_size;
-            curr_addr += curr_read_size;
-
-            // We have a cache page that succeeded to read some bytes but not
-            // an entire page. If this happens, we must cap off how much data
-            // we are able to read...
-            if (pos->second->GetByteSize() != cache_line_byte_size)
-              return dst_len - bytes_left;
-          }
-        }
+      if (pos == m_L2_cache.end()) {
+        // We need to read from the process. Read all the missing cache lines
+        // the request still needs at once, then continue through the loop
+        // again to get the data out of the cache...
+        if (!ReadL2CacheLines(curr_addr, cache_offset + bytes_left, error))
+          return dst_len - bytes_left;
+        continue;
       }
 
-      // We need to read from the process
-
-      if (bytes_left > 0) {
-        assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_up->GetBytes(),
-            data_buffer_heap_up->GetByteSize(), error);
-        if (process_bytes_read == 0)
-          return dst_len - bytes_left;
+      // A cache line that holds less than a full line is where the readable
+      // memory ends.
+      const size_t line_byte_size = pos->second->GetByteSize();
+      if (cache_offset >= line_byte_size)
+        return dst_len - bytes_left;
+      size_t curr_read_size = line_byte_size - cache_offset;
+      if (curr_read_size > bytes_left)
+        curr_read_size = bytes_left;
+
+      memcpy(dst_buf + dst_len - bytes_left,
+             pos->second->GetBytes() + cache_offset, curr_read_size);
+      bytes_left -= curr_read_size;
+      if (line_byte_size != cache_line_byte_size)
+        return dst_len - bytes_left;
 
-        if (process_bytes_read != cache_line_byte_size) {
-          if (process_bytes_read < data_buffer_heap_up->GetByteSize()) {
-            dst_len -= data_buffer_heap_up->GetByteSize() - process_bytes_read;
-            bytes_left = process_bytes_read;
-          }
-          data_buffer_heap_up->SetByteSize(process_bytes_read);
-        }
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_up.release());
-        // We have read data and put it into the cache, continue through the
-        // loop again to get the data out of the cache...
-      }
+      curr_addr += cache_line_byte_size;
+      cache_offset = 0;
     }
   }
 
   return dst_len - bytes_left;
 }
 
+bool MemoryCache::ReadL2CacheLines(addr_t line_addr, size_t byte_size,
+                                   Status &error) {
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+  assert((line_addr % cache_line_byte_size) == 0);
+
+  // A read which straddles two cache lines, or runs into the next uncached
+  // line, would otherwise cost one round trip to the process per line, which
+  // dominates when debugging over a slow link.
+  const size_t max_num_lines =
+      (byte_size + cache_line_byte_size - 1) / cache_line_byte_size;
+  size_t num_lines = 1;
+  while (num_lines < max_num_lines) {
+    const addr_t next_line_addr = line_addr + num_lines * cache_line_byte_size;
+    if (m_L2_cache.count(next_line_addr) ||
+        m_invalid_ranges.FindEntryThatContains(next_line_addr))
+      break;
+    ++num_lines;
+  }
+
+  auto data_buffer_sp = std::make_shared<DataBufferHeap>(
+      num_lines * cache_line_byte_size, 0);
+  size_t process_bytes_read = m_process.ReadMemoryFromInferior(
+      line_addr, data_buffer_sp->GetBytes(), data_buffer_sp->GetByteSize(),
+      error);
+  // Some stubs fail the whole read when only its end isn't readable, so retry
+  // with the first line on its own.
+  if (process_bytes_read == 0 && num_lines > 1) {
+    num_lines = 1;
+    data_buffer_sp->SetByteSize(cache_line_byte_size);
+    process_bytes_read = m_process.ReadMemoryFromInferior(
+        line_addr, data_buffer_sp->GetBytes(), cache_line_byte_size, error);
+  }
+  if (process_bytes_read == 0)
+    return false;
+
+  if (num_lines == 1) {
+    data_buffer_sp->SetByteSize(process_bytes_read);
+    m_L2_cache[line_addr] = data_buffer_sp;
+    return true;
+  }
+  for (size_t offset = 0; offset < process_bytes_read;
+       offset += cache_line_byte_size) {
+    const size_t line_byte_size =
+        std::min<size_t>(cache_line_byte_size, process_bytes_read - offset);
+    m_L2_cache[line_addr + offset] = std::make_shared<DataBufferHeap>(
+        data_buffer_sp->GetBytes() + offset, line_byte_size);
+  }
+  return true;
+}
+
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
                                uint32_t permissions, uint32_t chunk_size)
     : m_range(addr, byte_size), m_permissions(permissions),
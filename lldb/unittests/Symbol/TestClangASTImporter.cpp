@@ -115,6 +115,39 @@ TEST_F(TestClangASTImporter, CompleteFwdDeclWithOtherOrigin) {
   EXPECT_EQ(1U, imported.GetNumFields());
 }
 
+TEST_F(TestClangASTImporter, ForgetSource) {
+  // Tests that ForgetSource only drops the origins pointing to the forgotten
+  // source.
+  clang_utils::SourceASTWithRecord source;
+  std::unique_ptr<TypeSystemClang> other_source = clang_utils::createAST();
+  clang::TagDecl *other_decl = ClangUtil::GetAsTagDecl(
+      clang_utils::createRecord(*other_source, "OtherSource"));
+
+  std::unique_ptr<TypeSystemClang> target_ast = clang_utils::createAST();
+  clang::ASTContext *target_ctx = &target_ast->getASTContext();
+
+  ClangASTImporter importer;
+  clang::Decl *imported = importer.CopyDecl(target_ctx, source.record_decl);
+  ASSERT_NE(nullptr, imported);
+  clang::Decl *other_imported = importer.CopyDecl(target_ctx, other_decl);
+  ASSERT_NE(nullptr, other_imported);
+
+  // Forgetting a context which is the origin of no decl changes nothing.
+  std::unique_ptr<TypeSystemClang> unrelated_ast = clang_utils::createAST();
+  importer.ForgetSource(target_ctx, &unrelated_ast->getASTContext());
+  EXPECT_TRUE(importer.GetDeclOrigin(imported).Valid());
+  EXPECT_TRUE(importer.GetDeclOrigin(other_imported).Valid());
+
+  importer.ForgetSource(target_ctx, &source.ast->getASTContext());
+  EXPECT_FALSE(importer.GetDeclOrigin(imported).Valid());
+  ClangASTImporter::DeclOrigin origin = importer.GetDeclOrigin(other_imported);
+  EXPECT_TRUE(origin.Valid());
+  EXPECT_EQ(origin.ctx, &other_source->getASTContext());
+
+  importer.ForgetSource(target_ctx, &other_source->getASTContext());
+  EXPECT_FALSE(importer.GetDeclOrigin(other_imported).Valid());
+}
+
 TEST_F(TestClangASTImporter, DeportDeclTagDecl) {
   // Tests that the ClangASTImporter::DeportDecl completely copies TagDecls.
   clang_utils::SourceASTWithRecord source;
@@ -83,10 +83,57 @@ TEST(DWARFIndexCachingTest, NameToDIEEncodeDecode) {
              DIERef(llvm::None, DIERef::Section::DebugInfo, 0x11223344));
   map.Insert(ConstString("workd"),
              DIERef(100, DIERef::Section::DebugInfo, 0x11223344));
+  map.Finalize();
   // Make sure a valid NameToDIE map encodes and decodes correctly.
   EncodeDecode(map);
 }
 
+TEST(DWARFIndexCachingTest, NameToDIEDecodeUnsorted) {
+  // A cache file lists the entries in the order of the addresses of the
+  // strings in the process that saved it, which generally differs from
+  // their order in the process that loads it. Make sure that the names can
+  // still be found after decoding.
+  ConstString first("NameToDIEDecodeUnsorted_first");
+  ConstString second("NameToDIEDecodeUnsorted_second");
+  if (first.GetCString() < second.GetCString())
+    std::swap(first, second);
+  const DIERef first_ref(llvm::None, DIERef::Section::DebugInfo, 0x10);
+  const DIERef second_ref(llvm::None, DIERef::Section::DebugInfo, 0x20);
+  NameToDIE map;
+  map.Insert(first, first_ref);
+  map.Insert(first, second_ref);
+  map.Insert(second, second_ref);
+
+  const uint8_t addr_size = 8;
+  DataEncoder encoder(eByteOrderLittle, addr_size);
+  DataEncoder strtab_encoder(eByteOrderLittle, addr_size);
+  ConstStringTable const_strtab;
+  map.Encode(encoder, const_strtab);
+  const_strtab.Encode(strtab_encoder);
+  llvm::ArrayRef<uint8_t> strtab_bytes = strtab_encoder.GetData();
+  DataExtractor strtab_data(strtab_bytes.data(), strtab_bytes.size(),
+                            eByteOrderLittle, addr_size);
+  StringTableReader strtab_reader;
+  offset_t strtab_data_offset = 0;
+  ASSERT_TRUE(strtab_reader.Decode(strtab_data, &strtab_data_offset));
+  llvm::ArrayRef<uint8_t> bytes = encoder.GetData();
+  DataExtractor data(bytes.data(), bytes.size(), eByteOrderLittle, addr_size);
+  NameToDIE decoded_map;
+  offset_t data_offset = 0;
+  ASSERT_TRUE(decoded_map.Decode(data, &data_offset, strtab_reader));
+
+  std::vector<DIERef> refs;
+  auto collect = [&refs](DIERef ref) {
+    refs.push_back(ref);
+    return true;
+  };
+  EXPECT_TRUE(decoded_map.Find(first, collect));
+  EXPECT_THAT(refs, testing::ElementsAre(first_ref, second_ref));
+  refs.clear();
+  EXPECT_TRUE(decoded_map.Find(second, collect));
+  EXPECT_THAT(refs, testing::ElementsAre(second_ref));
+}
+
 static void EncodeDecode(const ManualDWARFIndex::IndexSet &object,
                          ByteOrder byte_order) {
   const uint8_t addr_size = 8;
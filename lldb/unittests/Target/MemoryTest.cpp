@@ -0,0 +1,171 @@
+//===-- MemoryTest.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Target/Memory.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/Reproducer.h"
+#include "gtest/gtest.h"
+
+using namespace lldb_private;
+using namespace lldb_private::repro;
+using namespace lldb;
+
+namespace {
+class MemoryTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    llvm::cantFail(Reproducer::Initialize(ReproducerMode::Off, llvm::None));
+    FileSystem::Initialize();
+    HostInfo::Initialize();
+    platform_linux::PlatformLinux::Initialize();
+  }
+  void TearDown() override {
+    platform_linux::PlatformLinux::Terminate();
+    HostInfo::Terminate();
+    FileSystem::Terminate();
+    Reproducer::Terminate();
+  }
+};
+
+/// A process whose memory is readable below m_readable_end, where each byte
+/// holds the low byte of its address, and which counts the reads it serves.
+class DummyProcess : public Process {
+public:
+  DummyProcess(lldb::TargetSP target_sp, lldb::ListenerSP listener_sp,
+               lldb::addr_t readable_end, bool fails_partial_reads)
+      : Process(target_sp, listener_sp), m_readable_end(readable_end),
+        m_fails_partial_reads(fails_partial_reads) {}
+
+  bool CanDebug(lldb::TargetSP target, bool plugin_specified_by_name) override {
+    return true;
+  }
+  Status DoDestroy() override { return {}; }
+  void RefreshStateAfterStop() override {}
+  size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
+                      Status &error) override {
+    ++m_num_reads;
+    if (vm_addr >= m_readable_end ||
+        (m_fails_partial_reads && vm_addr + size > m_readable_end)) {
+      error.SetErrorString("unreadable");
+      return 0;
+    }
+    size = std::min<size_t>(size, m_readable_end - vm_addr);
+    for (size_t i = 0; i < size; ++i)
+      static_cast<uint8_t *>(buf)[i] = static_cast<uint8_t>(vm_addr + i);
+    error.Clear();
+    return size;
+  }
+  bool DoUpdateThreadList(ThreadList &old_thread_list,
+                          ThreadList &new_thread_list) override {
+    return false;
+  }
+  llvm::StringRef GetPluginName() override { return "Dummy"; }
+
+  lldb::addr_t m_readable_end;
+  bool m_fails_partial_reads;
+  unsigned m_num_reads = 0;
+};
+
+struct MemoryTestTarget {
+  MemoryTestTarget() {
+    ArchSpec arch("x86_64-pc-linux");
+    Platform::SetHostPlatform(
+        platform_linux::PlatformLinux::CreateInstance(true, &arch));
+    debugger_sp = Debugger::CreateInstance();
+    PlatformSP platform_sp;
+    debugger_sp->GetTargetList().CreateTarget(
+        *debugger_sp, "", arch, eLoadDependentsNo, platform_sp, target_sp);
+  }
+
+  std::shared_ptr<DummyProcess> CreateProcess(lldb::addr_t readable_end,
+                                              bool fails_partial_reads) {
+    return std::make_shared<DummyProcess>(target_sp,
+                                          Listener::MakeListener("dummy"),
+                                          readable_end, fails_partial_reads);
+  }
+
+  DebuggerSP debugger_sp;
+  TargetSP target_sp;
+};
+
+void ExpectBytes(const uint8_t *buf, lldb::addr_t addr, size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    ASSERT_EQ(static_cast<uint8_t>(addr + i), buf[i]) << "at offset " << i;
+}
+} // namespace
+
+TEST_F(MemoryTest, ReadStraddlingCacheLines) {
+  MemoryTestTarget test_target;
+  ASSERT_TRUE(test_target.target_sp);
+  auto process_sp = test_target.CreateProcess(0x10000, false);
+  MemoryCache cache(*process_sp);
+  const lldb::addr_t line_size = cache.GetMemoryCacheLineSize();
+
+  // Both missing lines are read at once.
+  uint8_t buf[16];
+  Status error;
+  const lldb::addr_t addr = 0x1000 + line_size - 8;
+  EXPECT_EQ(sizeof(buf), cache.Read(addr, buf, sizeof(buf), error));
+  EXPECT_TRUE(error.Success());
+  EXPECT_EQ(1U, process_sp->m_num_reads);
+  ExpectBytes(buf, addr, sizeof(buf));
+
+  // And are then both cached.
+  EXPECT_EQ(sizeof(buf), cache.Read(0x1000, buf, sizeof(buf), error));
+  EXPECT_EQ(sizeof(buf), cache.Read(0x1000 + line_size, buf, sizeof(buf),
+                                    error));
+  EXPECT_EQ(1U, process_sp->m_num_reads);
+  ExpectBytes(buf, 0x1000 + line_size, sizeof(buf));
+
+  // Only the missing line is read when the first one is cached.
+  EXPECT_EQ(sizeof(buf), cache.Read(0x1000 + 2 * line_size - 8, buf,
+                                    sizeof(buf), error));
+  EXPECT_EQ(2U, process_sp->m_num_reads);
+  ExpectBytes(buf, 0x1000 + 2 * line_size - 8, sizeof(buf));
+}
+
+TEST_F(MemoryTest, ReadUpToUnreadableMemory) {
+  MemoryTestTarget test_target;
+  ASSERT_TRUE(test_target.target_sp);
+  auto process_sp = test_target.CreateProcess(0x1004, false);
+  MemoryCache cache(*process_sp);
+
+  // The read stops where the memory does, in the middle of the second line.
+  uint8_t buf[16];
+  Status error;
+  const lldb::addr_t addr = 0x1000 - 8;
+  EXPECT_EQ(12U, cache.Read(addr, buf, sizeof(buf), error));
+  ExpectBytes(buf, addr, 12);
+
+  // Cached partial lines still end the read.
+  EXPECT_EQ(2U, cache.Read(0x1002, buf, sizeof(buf), error));
+  EXPECT_EQ(0U, cache.Read(0x1008, buf, sizeof(buf), error));
+}
+
+TEST_F(MemoryTest, ReadRetriesFirstLineAlone) {
+  MemoryTestTarget test_target;
+  ASSERT_TRUE(test_target.target_sp);
+  auto process_sp = test_target.CreateProcess(0x1000, true);
+  MemoryCache cache(*process_sp);
+
+  // The read of both lines fails as a whole, the first line alone succeeds,
+  // and the second line alone fails.
+  uint8_t buf[16];
+  Status error;
+  const lldb::addr_t addr = 0x1000 - 8;
+  EXPECT_EQ(8U, cache.Read(addr, buf, sizeof(buf), error));
+  ExpectBytes(buf, addr, 8);
+  EXPECT_EQ(3U, process_sp->m_num_reads);
+}
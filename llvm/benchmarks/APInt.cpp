@@ -0,0 +1,91 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include <vector>
+
+using namespace llvm;
+
+// Arithmetic on values which fit in a word, and on wider values which are
+// stored on the heap, as constant folding and the known bits analyses do.
+
+static std::vector<APInt> makeValues(unsigned BitWidth) {
+  std::vector<APInt> Values;
+  uint64_t Seed = 0x9E3779B97F4A7C15ULL;
+  for (unsigned I = 0; I < 256; ++I) {
+    SmallVector<uint64_t, 4> Words;
+    for (unsigned W = 0; W < (BitWidth + 63) / 64; ++W) {
+      Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      Words.push_back(Seed | 1);
+    }
+    Values.emplace_back(BitWidth, Words);
+  }
+  return Values;
+}
+
+static void BM_APIntAdd(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(State.range(0));
+  for (auto _ : State) {
+    APInt Sum(State.range(0), 0);
+    for (const APInt &Value : Values)
+      Sum += Value;
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_APIntAdd)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_APIntMul(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(State.range(0));
+  for (auto _ : State) {
+    APInt Product(State.range(0), 1);
+    for (const APInt &Value : Values)
+      Product *= Value;
+    benchmark::DoNotOptimize(Product);
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_APIntMul)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_APIntUDiv(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(State.range(0));
+  // Divides by values half as wide, so that the quotients are not trivial.
+  std::vector<APInt> Divisors;
+  for (const APInt &Value : Values)
+    Divisors.push_back(Value.lshr(State.range(0) / 2) | 1);
+  for (auto _ : State) {
+    for (size_t I = 0; I < Values.size(); ++I)
+      benchmark::DoNotOptimize(Values[I].udiv(Divisors[I]));
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_APIntUDiv)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_APIntBitwise(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(State.range(0));
+  for (auto _ : State) {
+    unsigned Count = 0;
+    for (size_t I = 1; I < Values.size(); ++I) {
+      APInt Value = (Values[I] & Values[I - 1]) ^ Values[I].shl(3);
+      Count += Value.countPopulation() + Value.countLeadingZeros();
+    }
+    benchmark::DoNotOptimize(Count);
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_APIntBitwise)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_APIntToString(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(State.range(0));
+  for (auto _ : State) {
+    for (const APInt &Value : Values) {
+      SmallString<80> Str;
+      Value.toString(Str, 10, /*Signed=*/false);
+      benchmark::DoNotOptimize(Str.data());
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * Values.size());
+}
+BENCHMARK(BM_APIntToString)->Arg(64)->Arg(128)->Arg(256);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,187 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+// Measures the compile time of the main phases of the pipeline on a fixed
+// input: reading and writing bitcode, the -O2 optimization pipeline, and code
+// generation down to an object file. The input is a module of small functions
+// with loops, calls and memory accesses, whose size is the benchmark argument.
+
+static std::string makeModuleText(unsigned NumFunctions) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  OS << "declare void @use(i32)\n\n";
+  for (unsigned I = 0; I < NumFunctions; ++I) {
+    OS << "define internal i32 @sum" << I << "(i32* %a, i32 %n) {\n"
+       << "entry:\n"
+       << "  %empty = icmp sle i32 %n, 0\n"
+       << "  br i1 %empty, label %exit, label %loop\n"
+       << "loop:\n"
+       << "  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]\n"
+       << "  %s = phi i32 [ " << I << ", %entry ], [ %s.next, %loop ]\n"
+       << "  %p = getelementptr inbounds i32, i32* %a, i32 %i\n"
+       << "  %v = load i32, i32* %p\n"
+       << "  %m = mul i32 %v, " << (2 * I + 1) << "\n"
+       << "  %s.next = add i32 %s, %m\n"
+       << "  store i32 %s.next, i32* %p\n"
+       << "  %i.next = add nuw nsw i32 %i, 1\n"
+       << "  %done = icmp eq i32 %i.next, %n\n"
+       << "  br i1 %done, label %exit, label %loop\n"
+       << "exit:\n"
+       << "  %r = phi i32 [ " << I << ", %entry ], [ %s.next, %loop ]\n"
+       << "  call void @use(i32 %r)\n"
+       << "  ret i32 %r\n"
+       << "}\n\n";
+  }
+  OS << "define i32 @main(i32* %a, i32 %n) {\n"
+     << "entry:\n";
+  for (unsigned I = 0; I < NumFunctions; ++I)
+    OS << "  %r" << I << " = call i32 @sum" << I << "(i32* %a, i32 %n)\n";
+  OS << "  ret i32 %r" << (NumFunctions - 1) << "\n"
+     << "}\n";
+  return OS.str();
+}
+
+static std::unique_ptr<Module> parseModule(const std::string &Text,
+                                           LLVMContext &Context) {
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(Text, Err, Context);
+  if (!M)
+    report_fatal_error("invalid benchmark input: " + Err.getMessage());
+  return M;
+}
+
+static void BM_BitcodeWrite(benchmark::State &State) {
+  LLVMContext Context;
+  std::unique_ptr<Module> M =
+      parseModule(makeModuleText(State.range(0)), Context);
+  size_t Size = 0;
+  for (auto _ : State) {
+    SmallVector<char, 0> Buffer;
+    raw_svector_ostream OS(Buffer);
+    WriteBitcodeToFile(*M, OS);
+    Size = Buffer.size();
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetBytesProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_BitcodeWrite)->Arg(16)->Arg(256);
+
+static void BM_BitcodeRead(benchmark::State &State) {
+  SmallVector<char, 0> Buffer;
+  {
+    LLVMContext Context;
+    std::unique_ptr<Module> M =
+        parseModule(makeModuleText(State.range(0)), Context);
+    raw_svector_ostream OS(Buffer);
+    WriteBitcodeToFile(*M, OS);
+  }
+  MemoryBufferRef BufferRef(StringRef(Buffer.data(), Buffer.size()), "input");
+  for (auto _ : State) {
+    LLVMContext Context;
+    Expected<std::unique_ptr<Module>> M = parseBitcodeFile(BufferRef, Context);
+    if (!M)
+      report_fatal_error(M.takeError());
+    // Materialize the function bodies, which are read lazily.
+    if (Error Err = (*M)->materializeAll())
+      report_fatal_error(std::move(Err));
+    benchmark::DoNotOptimize(M->get());
+  }
+  State.SetBytesProcessed(State.iterations() * Buffer.size());
+}
+BENCHMARK(BM_BitcodeRead)->Arg(16)->Arg(256);
+
+static void BM_OptO2(benchmark::State &State) {
+  const std::string Text = makeModuleText(State.range(0));
+  for (auto _ : State) {
+    State.PauseTiming();
+    LLVMContext Context;
+    std::unique_ptr<Module> M = parseModule(Text, Context);
+    State.ResumeTiming();
+
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    CGSCCAnalysisManager CGAM;
+    ModuleAnalysisManager MAM;
+    PassBuilder PB;
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    ModulePassManager MPM =
+        PB.buildPerModuleDefaultPipeline(OptimizationLevel::O2);
+    MPM.run(*M, MAM);
+    benchmark::DoNotOptimize(M.get());
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_OptO2)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+
+// Runs the default code generation pipeline of the host target and emits an
+// object file in memory.
+static void BM_CodeGenObject(benchmark::State &State) {
+  const std::string TripleName = sys::getDefaultTargetTriple();
+  std::string Error;
+  const Target *TheTarget = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!TheTarget) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  std::unique_ptr<TargetMachine> TM(TheTarget->createTargetMachine(
+      TripleName, "generic", "", TargetOptions(), Reloc::PIC_));
+  if (!TM) {
+    State.SkipWithError("unable to create the target machine");
+    return;
+  }
+
+  const std::string Text = makeModuleText(State.range(0));
+  for (auto _ : State) {
+    State.PauseTiming();
+    LLVMContext Context;
+    std::unique_ptr<Module> M = parseModule(Text, Context);
+    M->setTargetTriple(TripleName);
+    M->setDataLayout(TM->createDataLayout());
+    State.ResumeTiming();
+
+    SmallVector<char, 0> Buffer;
+    raw_svector_ostream OS(Buffer);
+    legacy::PassManager PM;
+    if (TM->addPassesToEmitFile(PM, OS, nullptr, CGFT_ObjectFile)) {
+      State.SkipWithError("the target can't emit object files");
+      return;
+    }
+    PM.run(*M);
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_CodeGenObject)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/ConcurrentDenseMap.h"
+#include "llvm/ADT/DenseMap.h"
+#include <memory>
+#include <mutex>
+
+using namespace llvm;
+
+// Each thread inserts its own range of keys, then looks up all of them.
+// Compare against a single DenseMap guarded by one mutex, which is what
+// parallel code falls back to without a concurrent map.
+
+static constexpr unsigned NumKeysPerThread = 1 << 14;
+
+static std::unique_ptr<ConcurrentDenseMap<unsigned, unsigned>> Sharded;
+
+static void BM_ConcurrentDenseMapInsertLookup(benchmark::State &State) {
+  if (State.thread_index() == 0)
+    Sharded = std::make_unique<ConcurrentDenseMap<unsigned, unsigned>>();
+  unsigned First = State.thread_index() * NumKeysPerThread;
+  unsigned Round = 0;
+  for (auto _ : State) {
+    unsigned Base = First + Round++ * State.threads() * NumKeysPerThread;
+    for (unsigned I = Base; I != Base + NumKeysPerThread; ++I)
+      Sharded->try_emplace(I, I);
+    for (unsigned I = Base; I != Base + NumKeysPerThread; ++I)
+      benchmark::DoNotOptimize(Sharded->lookup(I));
+  }
+  State.SetItemsProcessed(State.iterations() * NumKeysPerThread);
+  if (State.thread_index() == 0)
+    Sharded.reset();
+}
+BENCHMARK(BM_ConcurrentDenseMapInsertLookup)->ThreadRange(1, 16)->UseRealTime();
+
+static std::mutex GlobalMutex;
+static std::unique_ptr<DenseMap<unsigned, unsigned>> Global;
+
+static void BM_LockedDenseMapInsertLookup(benchmark::State &State) {
+  if (State.thread_index() == 0)
+    Global = std::make_unique<DenseMap<unsigned, unsigned>>();
+  unsigned First = State.thread_index() * NumKeysPerThread;
+  unsigned Round = 0;
+  for (auto _ : State) {
+    unsigned Base = First + Round++ * State.threads() * NumKeysPerThread;
+    for (unsigned I = Base; I != Base + NumKeysPerThread; ++I) {
+      std::lock_guard<std::mutex> Lock(GlobalMutex);
+      Global->try_emplace(I, I);
+    }
+    for (unsigned I = Base; I != Base + NumKeysPerThread; ++I) {
+      std::lock_guard<std::mutex> Lock(GlobalMutex);
+      benchmark::DoNotOptimize(Global->lookup(I));
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * NumKeysPerThread);
+  if (State.thread_index() == 0)
+    Global.reset();
+}
+BENCHMARK(BM_LockedDenseMapInsertLookup)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,118 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include <vector>
+
+using namespace llvm;
+
+// Inserts and looks up integer and pointer keys, the most common keys of the
+// maps in the compiler, in maps from a handful of entries to larger than the
+// caches.
+
+static std::vector<unsigned> makeKeys(size_t Count) {
+  std::vector<unsigned> Keys;
+  // Spread the keys, as the IDs and hashes used as keys are.
+  for (unsigned I = 0; I < Count; ++I)
+    Keys.push_back(I * 2654435761U);
+  return Keys;
+}
+
+static void BM_DenseMapInsert(benchmark::State &State) {
+  std::vector<unsigned> Keys = makeKeys(State.range(0));
+  for (auto _ : State) {
+    DenseMap<unsigned, unsigned> Map;
+    for (unsigned Key : Keys)
+      Map.try_emplace(Key, Key);
+    benchmark::DoNotOptimize(Map.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_DenseMapInsert)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_DenseMapInsertReserved(benchmark::State &State) {
+  std::vector<unsigned> Keys = makeKeys(State.range(0));
+  for (auto _ : State) {
+    DenseMap<unsigned, unsigned> Map;
+    Map.reserve(Keys.size());
+    for (unsigned Key : Keys)
+      Map.try_emplace(Key, Key);
+    benchmark::DoNotOptimize(Map.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_DenseMapInsertReserved)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+// Looks up as many present as missing keys.
+static void BM_DenseMapLookup(benchmark::State &State) {
+  std::vector<unsigned> Keys = makeKeys(2 * State.range(0));
+  DenseMap<unsigned, unsigned> Map;
+  for (size_t I = 0; I < Keys.size(); I += 2)
+    Map.try_emplace(Keys[I], Keys[I]);
+  for (auto _ : State) {
+    size_t Found = 0;
+    for (unsigned Key : Keys)
+      Found += Map.count(Key);
+    benchmark::DoNotOptimize(Found);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_DenseMapLookup)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_DenseMapIterate(benchmark::State &State) {
+  std::vector<unsigned> Keys = makeKeys(State.range(0));
+  DenseMap<unsigned, unsigned> Map;
+  for (unsigned Key : Keys)
+    Map.try_emplace(Key, Key);
+  for (auto _ : State) {
+    unsigned Sum = 0;
+    for (const auto &KV : Map)
+      Sum += KV.second;
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_DenseMapIterate)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+// Pointer keys, as the maps from Values, Types and Decls, which are spaced
+// like objects of that size.
+namespace {
+struct Object {
+  char Bytes[48];
+};
+} // namespace
+
+static void BM_DenseSetPointerInsertLookup(benchmark::State &State) {
+  std::vector<Object> Storage(State.range(0));
+  for (auto _ : State) {
+    DenseSet<const Object *> Set;
+    for (const Object &Element : Storage)
+      Set.insert(&Element);
+    size_t Found = 0;
+    for (const Object &Element : Storage)
+      Found += Set.count(&Element);
+    benchmark::DoNotOptimize(Found);
+  }
+  State.SetItemsProcessed(State.iterations() * Storage.size());
+}
+BENCHMARK(BM_DenseSetPointerInsertLookup)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+
+static void BM_DenseMapEraseInsert(benchmark::State &State) {
+  std::vector<unsigned> Keys = makeKeys(State.range(0));
+  DenseMap<unsigned, unsigned> Map;
+  for (unsigned Key : Keys)
+    Map.try_emplace(Key, Key);
+  // Erasing leaves tombstones, which the following inserts reuse.
+  for (auto _ : State) {
+    for (unsigned Key : Keys) {
+      Map.erase(Key);
+      Map.try_emplace(Key, Key);
+    }
+    benchmark::DoNotOptimize(Map.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_DenseMapEraseInsert)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
+#include <vector>
+
+using namespace llvm;
+
+// Uniques nodes the way SCEV and the SelectionDAG do: each node is profiled
+// into a FoldingSetNodeID from a few operands, and looked up before it is
+// created.
+
+namespace {
+class Node : public FoldingSetNode {
+public:
+  Node(unsigned Opcode, const void *LHS, const void *RHS)
+      : Opcode(Opcode), LHS(LHS), RHS(RHS) {}
+
+  static void Profile(FoldingSetNodeID &ID, unsigned Opcode, const void *LHS,
+                      const void *RHS) {
+    ID.AddInteger(Opcode);
+    ID.AddPointer(LHS);
+    ID.AddPointer(RHS);
+  }
+  void Profile(FoldingSetNodeID &ID) const { Profile(ID, Opcode, LHS, RHS); }
+
+private:
+  unsigned Opcode;
+  const void *LHS;
+  const void *RHS;
+};
+} // namespace
+
+// Builds a chain of nodes, each one using the previous ones. Every node is
+// requested twice, so that half of the requests find an existing node.
+static void BM_FoldingSetUnique(benchmark::State &State) {
+  const unsigned Size = State.range(0);
+  for (auto _ : State) {
+    BumpPtrAllocator Allocator;
+    FoldingSet<Node> Set;
+    std::vector<const Node *> Nodes = {nullptr};
+    for (unsigned I = 0; I < Size; ++I) {
+      const unsigned Opcode = I % 7;
+      const Node *LHS = Nodes[I % Nodes.size()];
+      const Node *RHS = Nodes.back();
+      for (unsigned Request = 0; Request < 2; ++Request) {
+        FoldingSetNodeID ID;
+        Node::Profile(ID, Opcode, LHS, RHS);
+        void *InsertPos = nullptr;
+        if (Set.FindNodeOrInsertPos(ID, InsertPos))
+          continue;
+        Node *N = new (Allocator.Allocate<Node>()) Node(Opcode, LHS, RHS);
+        Set.InsertNode(N, InsertPos);
+        Nodes.push_back(N);
+      }
+    }
+    benchmark::DoNotOptimize(Set.size());
+  }
+  State.SetItemsProcessed(State.iterations() * 2 * Size);
+}
+BENCHMARK(BM_FoldingSetUnique)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+static void BM_FoldingSetNodeIDProfile(benchmark::State &State) {
+  std::vector<unsigned> Operands(State.range(0));
+  for (unsigned I = 0; I < Operands.size(); ++I)
+    Operands[I] = I * 31;
+  for (auto _ : State) {
+    FoldingSetNodeID ID;
+    for (unsigned Operand : Operands)
+      ID.AddInteger(Operand);
+    benchmark::DoNotOptimize(ID.ComputeHash());
+  }
+  State.SetItemsProcessed(State.iterations() * Operands.size());
+}
+BENCHMARK(BM_FoldingSetNodeIDProfile)->Arg(3)->Arg(8)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,54 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+using namespace llvm;
+
+// Formats a batch of integers of various sizes into a string, the way the
+// assembly and IR printers do.
+
+static void BM_FormatDecimal(benchmark::State &State) {
+  std::string Buffer;
+  raw_string_ostream OS(Buffer);
+  uint64_t Scale = State.range(0);
+  for (auto _ : State) {
+    Buffer.clear();
+    for (uint64_t I = 0; I < 1000; ++I)
+      OS << I * Scale << ' ';
+    OS.flush();
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * 1000);
+}
+BENCHMARK(BM_FormatDecimal)->Arg(1)->Arg(1000003)->Arg(1000000000039);
+
+static void BM_FormatSignedDecimal(benchmark::State &State) {
+  std::string Buffer;
+  raw_string_ostream OS(Buffer);
+  for (auto _ : State) {
+    Buffer.clear();
+    for (int64_t I = 0; I < 1000; ++I)
+      OS << (I - 500) * 4099 << ' ';
+    OS.flush();
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * 1000);
+}
+BENCHMARK(BM_FormatSignedDecimal);
+
+static void BM_FormatHex(benchmark::State &State) {
+  std::string Buffer;
+  raw_string_ostream OS(Buffer);
+  for (auto _ : State) {
+    Buffer.clear();
+    for (uint64_t I = 0; I < 1000; ++I)
+      OS << format_hex(I * 0x10001, 10) << ' ';
+    OS.flush();
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * 1000);
+}
+BENCHMARK(BM_FormatHex);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,65 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+using namespace llvm;
+
+// Writes the kind of output the printers and the assembly writers produce:
+// short strings, characters and integers, into memory.
+
+static void BM_RawStringOstreamSmallWrites(benchmark::State &State) {
+  for (auto _ : State) {
+    std::string Buffer;
+    raw_string_ostream OS(Buffer);
+    for (unsigned I = 0; I < 1024; ++I)
+      OS << "  %" << I << " = add i32 %x, " << (I * 7) << '\n';
+    OS.flush();
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * 1024);
+}
+BENCHMARK(BM_RawStringOstreamSmallWrites);
+
+static void BM_RawSvectorOstreamSmallWrites(benchmark::State &State) {
+  for (auto _ : State) {
+    SmallString<256> Buffer;
+    raw_svector_ostream OS(Buffer);
+    for (unsigned I = 0; I < 1024; ++I)
+      OS << "  %" << I << " = add i32 %x, " << (I * 7) << '\n';
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * 1024);
+}
+BENCHMARK(BM_RawSvectorOstreamSmallWrites);
+
+static void BM_RawOstreamFormat(benchmark::State &State) {
+  for (auto _ : State) {
+    std::string Buffer;
+    raw_string_ostream OS(Buffer);
+    for (unsigned I = 0; I < 1024; ++I)
+      OS << format_hex(I * 2654435761U, 10) << ' ' << format("%5.2f", I / 3.0)
+         << '\n';
+    OS.flush();
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * 1024);
+}
+BENCHMARK(BM_RawOstreamFormat);
+
+static void BM_RawOstreamLargeWrites(benchmark::State &State) {
+  const std::string Chunk(State.range(0), 'x');
+  for (auto _ : State) {
+    std::string Buffer;
+    raw_string_ostream OS(Buffer);
+    for (unsigned I = 0; I < 64; ++I)
+      OS << Chunk;
+    OS.flush();
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetBytesProcessed(State.iterations() * 64 * Chunk.size());
+}
+BENCHMARK(BM_RawOstreamLargeWrites)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,79 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallVector.h"
+#include <string>
+
+using namespace llvm;
+
+// Fills vectors which fit in their inline storage, and vectors which grow on
+// the heap, with trivially copyable elements and with elements that are not.
+
+static void BM_SmallVectorPushBackInline(benchmark::State &State) {
+  for (auto _ : State) {
+    SmallVector<unsigned, 16> Vector;
+    for (unsigned I = 0; I < 16; ++I)
+      Vector.push_back(I);
+    benchmark::DoNotOptimize(Vector.data());
+  }
+  State.SetItemsProcessed(State.iterations() * 16);
+}
+BENCHMARK(BM_SmallVectorPushBackInline);
+
+static void BM_SmallVectorPushBackGrow(benchmark::State &State) {
+  const unsigned Size = State.range(0);
+  for (auto _ : State) {
+    SmallVector<unsigned, 4> Vector;
+    for (unsigned I = 0; I < Size; ++I)
+      Vector.push_back(I);
+    benchmark::DoNotOptimize(Vector.data());
+  }
+  State.SetItemsProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_SmallVectorPushBackGrow)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+static void BM_SmallVectorAppend(benchmark::State &State) {
+  SmallVector<unsigned, 0> Source(State.range(0), 1);
+  for (auto _ : State) {
+    SmallVector<unsigned, 8> Vector;
+    Vector.append(Source.begin(), Source.end());
+    benchmark::DoNotOptimize(Vector.data());
+  }
+  State.SetBytesProcessed(State.iterations() * Source.size() *
+                          sizeof(unsigned));
+}
+BENCHMARK(BM_SmallVectorAppend)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+static void BM_SmallVectorPushBackString(benchmark::State &State) {
+  const unsigned Size = State.range(0);
+  const std::string Element = "a string longer than the inline buffer";
+  for (auto _ : State) {
+    SmallVector<std::string, 4> Vector;
+    for (unsigned I = 0; I < Size; ++I)
+      Vector.push_back(Element);
+    benchmark::DoNotOptimize(Vector.data());
+  }
+  State.SetItemsProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_SmallVectorPushBackString)->RangeMultiplier(16)->Range(16, 4096);
+
+// Used as a worklist, as many of the passes do.
+static void BM_SmallVectorWorklist(benchmark::State &State) {
+  const unsigned Size = State.range(0);
+  for (auto _ : State) {
+    SmallVector<unsigned, 32> Worklist;
+    Worklist.push_back(0);
+    unsigned Visited = 0;
+    while (!Worklist.empty()) {
+      unsigned Node = Worklist.pop_back_val();
+      ++Visited;
+      if (2 * Node + 1 < Size)
+        Worklist.push_back(2 * Node + 1);
+      if (2 * Node + 2 < Size)
+        Worklist.push_back(2 * Node + 2);
+    }
+    benchmark::DoNotOptimize(Visited);
+  }
+  State.SetItemsProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_SmallVectorWorklist)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,49 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// Inserts and looks up keys of a given length, from short identifiers up to
+// the length of typical mangled C++ names.
+
+static std::vector<std::string> makeKeys(size_t Length) {
+  std::vector<std::string> Keys;
+  for (unsigned I = 0; I < 4096; ++I) {
+    std::string Key = "_ZN4llvm" + std::to_string(I);
+    Key.resize(Length, 'x');
+    Key += std::to_string(I * 7919);
+    Keys.push_back(std::move(Key));
+  }
+  return Keys;
+}
+
+static void BM_StringMapInsert(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0));
+  for (auto _ : State) {
+    StringMap<unsigned> Map;
+    for (const std::string &Key : Keys)
+      Map.try_emplace(Key, 0);
+    benchmark::DoNotOptimize(Map.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_StringMapInsert)->Arg(8)->Arg(32)->Arg(128);
+
+static void BM_StringMapLookup(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0));
+  StringMap<unsigned> Map;
+  for (const std::string &Key : Keys)
+    Map.try_emplace(Key, 0);
+  for (auto _ : State) {
+    size_t Found = 0;
+    for (const std::string &Key : Keys)
+      Found += Map.count(Key);
+    benchmark::DoNotOptimize(Found);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_StringMapLookup)->Arg(8)->Arg(32)->Arg(128);
+
+BENCHMARK_MAIN();
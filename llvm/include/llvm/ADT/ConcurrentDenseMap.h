@@ -0,0 +1,121 @@
+//===- llvm/ADT/ConcurrentDenseMap.h - Sharded thread-safe map --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines the ConcurrentDenseMap class, an insert-only hash map
+/// that can be used from several threads at the same time.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_CONCURRENTDENSEMAP_H
+#define LLVM_ADT_CONCURRENTDENSEMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/MathExtras.h"
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+
+/// An insert-only hash map that is safe to use from several threads at once.
+///
+/// The map is split into \p NumShards DenseMaps, each guarded by its own
+/// mutex, so that threads inserting different keys rarely contend. Values are
+/// allocated separately and never move or get erased, so the pointers
+/// returned by try_emplace() and lookup() stay valid for the lifetime of the
+/// map, even while other threads keep inserting.
+///
+/// Iteration order of a hash map depends on the order of insertion, which is
+/// not deterministic when several threads insert. Use getEntries() to obtain
+/// the entries in a deterministic order once the parallel phase is over.
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>, unsigned NumShards = 64>
+class ConcurrentDenseMap {
+  static_assert(isPowerOf2_32(NumShards), "NumShards must be a power of 2");
+
+  struct alignas(64) Shard {
+    mutable std::mutex Mutex;
+    DenseMap<KeyT, ValueT *, KeyInfoT> Map;
+    SpecificBumpPtrAllocator<ValueT> Allocator;
+  };
+
+  Shard Shards[NumShards];
+
+  Shard &getShard(const KeyT &Key) {
+    // DenseMap uses the low bits of the hash to pick a bucket, so use the high
+    // bits of a mixed hash to pick the shard.
+    uint64_t Hash = KeyInfoT::getHashValue(Key) * 0x9E3779B97F4A7C15ULL;
+    return Shards[NumShards == 1 ? 0 : Hash >> (64 - Log2_32(NumShards))];
+  }
+  const Shard &getShard(const KeyT &Key) const {
+    return const_cast<ConcurrentDenseMap *>(this)->getShard(Key);
+  }
+
+public:
+  ConcurrentDenseMap() = default;
+  ConcurrentDenseMap(const ConcurrentDenseMap &) = delete;
+  ConcurrentDenseMap &operator=(const ConcurrentDenseMap &) = delete;
+
+  /// Inserts a value constructed from \p Args for \p Key unless the key is
+  /// already present.
+  ///
+  /// \returns The value for \p Key and whether it was inserted by this call.
+  template <typename... Ts>
+  std::pair<ValueT *, bool> try_emplace(const KeyT &Key, Ts &&...Args) {
+    Shard &S = getShard(Key);
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+    auto Inserted = S.Map.try_emplace(Key, nullptr);
+    if (!Inserted.second)
+      return {Inserted.first->second, false};
+    ValueT *Value =
+        new (S.Allocator.Allocate()) ValueT(std::forward<Ts>(Args)...);
+    Inserted.first->second = Value;
+    return {Value, true};
+  }
+
+  /// \returns The value for \p Key, or null if it is not present.
+  ValueT *lookup(const KeyT &Key) const {
+    const Shard &S = getShard(Key);
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+    return S.Map.lookup(Key);
+  }
+
+  bool contains(const KeyT &Key) const { return lookup(Key) != nullptr; }
+
+  /// \returns The number of keys. Not synchronized with concurrent inserts.
+  size_t size() const {
+    size_t Size = 0;
+    for (const Shard &S : Shards)
+      Size += S.Map.size();
+    return Size;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /// \returns All entries, sorted with \p Less. Must not be called while
+  /// other threads insert.
+  template <typename Compare = std::less<std::pair<KeyT, ValueT *>>>
+  std::vector<std::pair<KeyT, ValueT *>>
+  getEntries(Compare Less = Compare()) const {
+    std::vector<std::pair<KeyT, ValueT *>> Entries;
+    Entries.reserve(size());
+    for (const Shard &S : Shards)
+      Entries.insert(Entries.end(), S.Map.begin(), S.Map.end());
+    llvm::sort(Entries, Less);
+    return Entries;
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_CONCURRENTDENSEMAP_H
@@ -103,6 +103,20 @@ constexpr bool isHeuristicInlineCostFeature(InlineCostFeatureIndex Feature) {
     "number of module-internal users of the callee, +1 if the callee is "      \
     "exposed externally")
 
+// Features derived from profile data. They only carry information when
+// inlining for performance, and come last so that models trained without them
+// (e.g. the size model) can simply not be given the tail of the feature list.
+#define INLINE_PROFILE_FEATURE_ITERATOR(M)                                     \
+  M(CallSiteRelativeFrequency, "callsite_relative_frequency",                  \
+    "frequency of the call site relative to the entry of the caller, in "      \
+    "percent")                                                                 \
+  M(CallSiteProfileCount, "callsite_profile_count",                            \
+    "profile count of the call site, or 0 if there is no profile")             \
+  M(IsCallSiteHot, "is_callsite_hot",                                          \
+    "1 if the profile summary considers the call site hot")                    \
+  M(IsCallSiteCold, "is_callsite_cold",                                        \
+    "1 if the profile summary considers the call site cold")
+
 // clang-format off
 enum class FeatureIndex : size_t {
 // InlineCost features - these must come first
@@ -113,6 +127,9 @@ enum class FeatureIndex : size_t {
 // Non-cost features
 #define POPULATE_INDICES(INDEX_NAME, NAME, COMMENT) INDEX_NAME,
   INLINE_FEATURE_ITERATOR(POPULATE_INDICES)
+
+// Profile features - these must come last
+  INLINE_PROFILE_FEATURE_ITERATOR(POPULATE_INDICES)
 #undef POPULATE_INDICES
 
   NumberOfFeatures
@@ -127,6 +144,16 @@ inlineCostFeatureToMlFeature(InlineCostFeatureIndex Feature) {
 constexpr size_t NumberOfFeatures =
     static_cast<size_t>(FeatureIndex::NumberOfFeatures);
 
+#define COUNT_FEATURES(INDEX_NAME, NAME, COMMENT) +1
+constexpr size_t NumberOfProfileFeatures =
+    0 INLINE_PROFILE_FEATURE_ITERATOR(COUNT_FEATURES);
+#undef COUNT_FEATURES
+
+/// \returns The number of features the model is given: all of them when the
+/// ML inliner optimizes for performance, or all but the trailing profile
+/// features when it optimizes for size.
+size_t getNumberOfModelFeatures();
+
 extern const std::array<std::string, NumberOfFeatures> FeatureNameMap;
 
 extern const char *const DecisionName;
@@ -15,6 +15,7 @@
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include <algorithm>
+#include <functional>
 #include <utility>
 
 namespace llvm {
@@ -111,7 +112,7 @@ class PriorityInlineOrder : public InlineOrder<std::pair<CallBase *, int>> {
     do {
       CallBase *CB = Heap.front().first;
       const PriorityT PreviousGoodness = Heap.front().second;
-      const PriorityT CurrentGoodness = PriorityT::evaluate(CB);
+      const PriorityT CurrentGoodness = Evaluate(CB);
       Changed = PriorityT::isMoreDesirable(PreviousGoodness, CurrentGoodness);
       if (Changed) {
         std::pop_heap(Heap.begin(), Heap.end(), cmp);
@@ -123,12 +124,18 @@ class PriorityInlineOrder : public InlineOrder<std::pair<CallBase *, int>> {
   }
 
 public:
+  /// \p Evaluate computes the desirability of a call site. It defaults to
+  /// PriorityT::evaluate, for priorities that need no context.
+  PriorityInlineOrder(
+      std::function<PriorityT(CallBase *)> Evaluate = PriorityT::evaluate)
+      : Evaluate(std::move(Evaluate)) {}
+
   size_t size() override { return Heap.size(); }
 
   void push(const T &Elt) override {
     CallBase *CB = Elt.first;
     const int InlineHistoryID = Elt.second;
-    const PriorityT Goodness = PriorityT::evaluate(CB);
+    const PriorityT Goodness = Evaluate(CB);
 
     Heap.push_back({CB, Goodness});
     std::push_heap(Heap.begin(), Heap.end(), cmp);
@@ -164,6 +171,7 @@ public:
   }
 
 private:
+  std::function<PriorityT(CallBase *)> Evaluate;
   SmallVector<HeapT, 16> Heap;
   DenseMap<CallBase *, int> InlineHistoryMap;
 };
@@ -21,6 +21,7 @@
 namespace llvm {
 class Module;
 class MLInlineAdvice;
+class ProfileSummaryInfo;
 
 class MLInlineAdvisor : public InlineAdvisor {
 public:
@@ -67,6 +68,7 @@ private:
   }
 
   LazyCallGraph &CG;
+  ProfileSummaryInfo &PSI;
 
   int64_t NodeCount = 0;
   int64_t EdgeCount = 0;
@@ -502,11 +502,15 @@ public:
   using const_block_iterator = BasicBlock *const *;
 
   block_iterator block_begin() {
-    return reinterpret_cast<block_iterator>(op_begin() + ReservedSpace);
+    return reinterpret_cast<block_iterator>(
+        reinterpret_cast<char *>(op_begin() + ReservedSpace) +
+        Use::HungOffTrailerSize);
   }
 
   const_block_iterator block_begin() const {
-    return reinterpret_cast<const_block_iterator>(op_begin() + ReservedSpace);
+    return reinterpret_cast<const_block_iterator>(
+        reinterpret_cast<const char *>(op_begin() + ReservedSpace) +
+        Use::HungOffTrailerSize);
   }
 
   block_iterator block_end() { return block_begin() + getNumOperands(); }
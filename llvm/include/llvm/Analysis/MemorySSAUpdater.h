@@ -63,6 +63,11 @@ private:
   SmallPtrSet<BasicBlock *, 8> VisitedBlocks;
   SmallSet<AssertingVH<MemoryPhi>, 8> NonOptPhis;
 
+  /// Defs inserted by insertDefDeferringRename, and the phis whose blocks
+  /// need renaming because of them, until renameDeferredUses is called.
+  SmallVector<WeakVH, 8> DeferredRenameDefs;
+  SmallVector<WeakVH, 8> DeferredRenamePhis;
+
 public:
   MemorySSAUpdater(MemorySSA *MSSA) : MSSA(MSSA) {}
 
@@ -84,6 +89,14 @@ public:
   /// load a
   /// Where a mayalias b, *does* require RenameUses be set to true.
   void insertDef(MemoryDef *Def, bool RenameUses = false);
+  /// Insert a definition like insertDef with RenameUses set, but defer the
+  /// renaming until renameDeferredUses is called. Inserting many defs this way
+  /// and then renaming once visits every block below them at most once,
+  /// instead of once per def. No queries may be made in between.
+  void insertDefDeferringRename(MemoryDef *Def);
+  /// Rename the uses below all defs inserted by insertDefDeferringRename
+  /// since the last call.
+  void renameDeferredUses();
   void insertUse(MemoryUse *Use, bool RenameUses = false);
   /// Update the MemoryPhi in `To` following an edge deletion between `From` and
   /// `To`. If `To` becomes unreachable, a call to removeBlocks should be made.
@@ -263,6 +276,12 @@ private:
   MemoryAccess *tryRemoveTrivialPhi(MemoryPhi *Phi, RangeType &Operands);
   void tryRemoveTrivialPhis(ArrayRef<WeakVH> UpdatedPHIs);
   void fixupDefs(const SmallVectorImpl<WeakVH> &);
+  // Insert Def without renaming uses, and add the phis whose blocks need
+  // renaming to RenamePhis.
+  void insertDefImpl(MemoryDef *Def, SmallVectorImpl<WeakVH> &RenamePhis);
+  // Rename the uses below Defs and in the blocks of Phis, visiting every
+  // block at most once.
+  void renameUsesBelow(ArrayRef<WeakVH> Defs, ArrayRef<WeakVH> Phis);
   // Clone all uses and defs from BB to NewBB given a 1:1 map of all
   // instructions and blocks cloned, and a map of MemoryPhi : Definition
   // (MemoryAccess Phi or Def). VMap maps old instructions to cloned
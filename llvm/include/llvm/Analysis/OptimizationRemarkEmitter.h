@@ -54,6 +54,7 @@ public:
   OptimizationRemarkEmitter &operator=(OptimizationRemarkEmitter &&RHS) {
     F = RHS.F;
     BFI = RHS.BFI;
+    MaxBlockCount = None;
     return *this;
   }
 
@@ -78,8 +79,10 @@ public:
     // Avoid building the remark unless we know there are at least *some*
     // remarks enabled. We can't currently check whether remarks are requested
     // for the calling pass since that requires actually building the remark.
+    // We can however tell when no block of the function is hot enough for any
+    // of its remarks to be kept.
 
-    if (enabled()) {
+    if (enabled() && !isBelowHotnessThreshold()) {
       auto R = RemarkBuilder();
       static_assert(
           std::is_base_of<DiagnosticInfoOptimizationBase, decltype(R)>::value,
@@ -101,10 +104,7 @@ public:
   static bool allowExtraAnalysis(const Function &F, StringRef PassName) {
     return allowExtraAnalysis(F.getContext(), PassName);
   }
-  static bool allowExtraAnalysis(LLVMContext &Ctx, StringRef PassName) {
-    return Ctx.getLLVMRemarkStreamer() ||
-           Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
-  }
+  static bool allowExtraAnalysis(LLVMContext &Ctx, StringRef PassName);
 
 private:
   const Function *F;
@@ -121,6 +121,13 @@ private:
   /// Similar but use value from \p OptDiag and update hotness there.
   void computeHotness(DiagnosticInfoIROptimization &OptDiag);
 
+  /// The largest profile count of the blocks of F, computed on demand.
+  Optional<uint64_t> MaxBlockCount;
+
+  /// Return true if the remarks of F are all dropped by the hotness threshold,
+  /// because no block of F is hot enough.
+  bool isBelowHotnessThreshold();
+
   /// Only allow verbose messages if we know we're filtering by hotness
   /// (BFI is only set in this case).
   bool shouldEmitVerbose() { return BFI != nullptr; }
@@ -1289,6 +1289,10 @@ private:
   /// This is a cache of the values we have analyzed so far.
   ValueExprMapType ValueExprMap;
 
+  /// The number of instructions createSCEV has analyzed so far, which is
+  /// limited by -scalar-evolution-max-analyzed-instructions.
+  unsigned NumAnalyzedInstructions = 0;
+
   /// Mark predicate values currently being processed by isImpliedCond.
   SmallPtrSet<const Value *, 6> PendingLoopPredicates;
 
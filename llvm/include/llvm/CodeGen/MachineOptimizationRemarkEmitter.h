@@ -164,10 +164,8 @@ public:
   /// (1) to filter trivial false positives or (2) to provide more context so
   /// that non-trivial false positives can be quickly detected by the user.
   bool allowExtraAnalysis(StringRef PassName) const {
-    return (
-        MF.getFunction().getContext().getLLVMRemarkStreamer() ||
-        MF.getFunction().getContext().getDiagHandlerPtr()->isAnyRemarkEnabled(
-            PassName));
+    return OptimizationRemarkEmitter::allowExtraAnalysis(MF.getFunction(),
+                                                         PassName);
   }
 
   /// Take a lambda that returns a remark which will be emitted.  Second
@@ -178,6 +176,8 @@ public:
     // remarks enabled. We can't currently check whether remarks are requested
     // for the calling pass since that requires actually building the remark.
 
+    if (isBelowHotnessThreshold())
+      return;
     if (MF.getFunction().getContext().getLLVMRemarkStreamer() ||
         MF.getFunction()
             .getContext()
@@ -205,6 +205,13 @@ private:
   /// Similar but use value from \p OptDiag and update hotness there.
   void computeHotness(DiagnosticInfoMIROptimization &Remark);
 
+  /// Return true if the remarks are all dropped by the hotness threshold,
+  /// because they can't have a hotness without MBFI.
+  bool isBelowHotnessThreshold() const {
+    return !MBFI &&
+           MF.getFunction().getContext().getDiagnosticsHotnessThreshold();
+  }
+
   /// Only allow verbose messages if we know we're filtering by hotness
   /// (BFI is only set in this case).
   bool shouldEmitVerbose() { return MBFI != nullptr; }
@@ -195,6 +195,11 @@ struct MachineSchedPolicy {
   // Compute DFSResult for use in scheduling heuristics.
   bool ComputeDFSResult = false;
 
+  // Apply the resource and latency heuristics of bidirectional scheduling when
+  // scheduling in only one direction, to reduce contention for the busiest
+  // processor resource.
+  bool BalanceResources = false;
+
   MachineSchedPolicy() = default;
 };
 
@@ -11,6 +11,7 @@
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/Threading.h"
 #include <deque>
 #include <vector>
 
@@ -60,7 +61,13 @@ struct CompileUnitIdentifiers {
   const char *DWOName = "";
 };
 
-Error write(MCStreamer &Out, ArrayRef<std::string> Inputs);
+/// Merge the split DWARF of \p Inputs into a DWARF package written to \p Out.
+/// With more than one thread in \p S, the next few inputs are read and
+/// decompressed in parallel while the current one is merged. Inputs are
+/// released as soon as they have been merged, and the output does not depend
+/// on the number of threads.
+Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
+            ThreadPoolStrategy S = hardware_concurrency(1));
 
 unsigned getContributionIndex(DWARFSectionKind Kind, uint32_t IndexVersion);
 
@@ -59,6 +59,9 @@ class DWARFContext : public DIContext {
   std::unique_ptr<DWARFDebugAbbrev> Abbrev;
   std::unique_ptr<DWARFDebugLoc> Loc;
   std::unique_ptr<DWARFDebugAranges> Aranges;
+  /// Aranges read from .debug_aranges alone, used by bounded address lookups
+  /// until the complete Aranges are needed.
+  std::unique_ptr<DWARFDebugAranges> SectionAranges;
   std::unique_ptr<DWARFDebugLine> Line;
   std::unique_ptr<DWARFDebugFrame> DebugFrame;
   std::unique_ptr<DWARFDebugFrame> EHFrame;
@@ -79,6 +82,12 @@ class DWARFContext : public DIContext {
   /// The maximum DWARF version of all units.
   unsigned MaxVersion = 0;
 
+  /// The maximum number of compile units whose DIEs and line tables are kept
+  /// after an address lookup, or 0 for no limit.
+  unsigned MaxAddressLookupUnits = 0;
+  /// Compile units used by address lookups, least recently used first.
+  std::deque<DWARFUnit *> AddressLookupUnits;
+
   struct DWOFile {
     object::OwningBinary<object::ObjectFile> File;
     std::unique_ptr<DWARFContext> Context;
@@ -454,7 +463,24 @@ public:
   ///       into "SectionedAddress Address"
   DWARFCompileUnit *getCompileUnitForAddress(uint64_t Address);
 
+  /// Bound the memory used by address lookups, for one-shot symbolication of
+  /// very large binaries. When \p MaxUnits is non-zero, a compile unit for an
+  /// address is first looked up in .debug_aranges alone, and the address
+  /// ranges of all compile units are only collected for addresses that the
+  /// section does not cover. Once more than \p MaxUnits compile units have
+  /// been used by address lookups, the DIEs and the line table of the least
+  /// recently used one are freed. DIEs and line tables obtained through an
+  /// address lookup are therefore only valid until the next \p MaxUnits
+  /// lookups.
+  void setMaxAddressLookupUnits(unsigned MaxUnits) {
+    MaxAddressLookupUnits = MaxUnits;
+  }
+
 private:
+  /// Record that \p CU was used by an address lookup and free the parsed
+  /// data of the units beyond MaxAddressLookupUnits.
+  void touchAddressLookupUnit(DWARFUnit *CU);
+
   /// Parse a macro[.dwo] or macinfo[.dwo] section.
   std::unique_ptr<DWARFDebugMacro>
   parseMacroOrMacinfo(MacroSecType SectionType);
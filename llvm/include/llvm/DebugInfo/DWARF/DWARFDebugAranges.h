@@ -20,7 +20,9 @@ class DWARFContext;
 
 class DWARFDebugAranges {
 public:
-  void generate(DWARFContext *CTX);
+  /// Build the address map. If \p SectionOnly is set, only .debug_aranges is
+  /// read, so compile units that the section does not describe are not found.
+  void generate(DWARFContext *CTX, bool SectionOnly = false);
   uint64_t findAddress(uint64_t Address) const;
 
 private:
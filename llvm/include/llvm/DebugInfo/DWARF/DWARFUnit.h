@@ -460,6 +460,10 @@ public:
     return getDIEIndex(D.getDebugInfoEntry());
   }
 
+  /// Clear parsed DIEs to keep memory usage low. They are parsed again on the
+  /// next request. All DWARFDie objects of this unit are invalidated.
+  void clearDIEs(bool KeepCUDie);
+
   /// Return the DIE object at the given index.
   DWARFDie getDIEAtIndex(unsigned Index) {
     assert(Index < DieArray.size());
@@ -518,9 +522,6 @@ private:
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
 
-  /// clearDIEs - Clear parsed DIEs to keep memory usage low.
-  void clearDIEs(bool KeepCUDie);
-
   /// parseDWO - Parses .dwo file for current compile unit. Returns true if
   /// it was actually constructed.
   bool parseDWO();
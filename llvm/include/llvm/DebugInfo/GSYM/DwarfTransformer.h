@@ -76,7 +76,11 @@ private:
   /// information.
   ///
   /// \param Die The DWARF debug info entry to parse.
-  void handleDie(raw_ostream &Strm, CUInfo &CUI, DWARFDie Die);
+  ///
+  /// \param Funcs The function infos created for \p Die and its children are
+  /// appended here, so they can be added to the GsymCreator all at once.
+  void handleDie(raw_ostream &Strm, CUInfo &CUI, DWARFDie Die,
+                 std::vector<FunctionInfo> &Funcs);
 
   DWARFContext &DICtx;
   raw_ostream &Log;
@@ -196,6 +196,13 @@ public:
   /// \param   FI The function info object to emplace into our functions list.
   void addFunctionInfo(FunctionInfo &&FI);
 
+  /// Add several function info objects at once, taking the lock only once.
+  /// Multi-threaded producers should accumulate function infos locally and
+  /// add them with this function.
+  ///
+  /// \param   FIs The function info objects to move into our functions list.
+  void addFunctionInfos(std::vector<FunctionInfo> &&FIs);
+
   /// Finalize the data in the GSYM creator prior to saving the data out.
   ///
   /// Finalize must be called after all FunctionInfo objects have been added
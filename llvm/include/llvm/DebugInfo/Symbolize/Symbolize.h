@@ -13,6 +13,7 @@
 #ifndef LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 #define LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 
+#include "llvm/ADT/StringMap.h"
 #include "llvm/DebugInfo/Symbolize/DIFetcher.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/Binary.h"
@@ -21,6 +22,7 @@
 #include "llvm/Support/Error.h"
 #include <algorithm>
 #include <cstdint>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -50,6 +52,10 @@ public:
     std::string FallbackDebugPath;
     std::string DWPName;
     std::vector<std::string> DebugFileDirectory;
+    /// The maximum total size in bytes of the object files of the modules
+    /// kept loaded, or 0 for no limit. When it is exceeded, the least recently
+    /// used modules are unloaded. Useful for long-running symbolizers.
+    uint64_t MaxCacheSize = 0;
   };
 
   LLVMSymbolizer() = default;
@@ -117,6 +123,11 @@ private:
   getOrCreateModuleInfo(const std::string &ModuleName);
   Expected<SymbolizableModule *> getOrCreateModuleInfo(const ObjectFile &Obj);
 
+  /// Mark the module \p ModuleName, whose object files take \p Size bytes, as
+  /// the most recently used one, and unload the least recently used modules
+  /// while the cache is larger than Opts.MaxCacheSize.
+  void recordModuleUse(StringRef ModuleName, uint64_t Size);
+
   Expected<SymbolizableModule *>
   createModuleInfo(const ObjectFile *Obj, std::unique_ptr<DIContext> Context,
                    StringRef ModuleName);
@@ -150,6 +161,13 @@ private:
   std::map<std::string, std::unique_ptr<SymbolizableModule>, std::less<>>
       Modules;
 
+  /// Name and size of the modules loaded by name, most recently used first.
+  /// Only maintained when Opts.MaxCacheSize is set.
+  std::list<std::pair<std::string, uint64_t>> ModuleLRU;
+  StringMap<std::list<std::pair<std::string, uint64_t>>::iterator>
+      ModuleLRUPositions;
+  uint64_t ModuleCacheSize = 0;
+
   /// Contains cached results of getOrCreateObjectPair().
   std::map<std::pair<std::string, std::string>, ObjectPair>
       ObjectPairForPathArch;
@@ -20,10 +20,13 @@
 #define LLVM_DEBUGINFOD_DEBUGINFOD_H
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CachePruning.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 
 #include <chrono>
+#include <vector>
 
 namespace llvm {
 
@@ -43,6 +46,12 @@ Expected<std::string> getDefaultDebuginfodCacheDirectory();
 /// DEBUGINFOD_TIMEOUT environment variable, default is 90 seconds (90000 ms).
 std::chrono::milliseconds getDefaultDebuginfodTimeout();
 
+/// Finds a default pruning policy for the local cache directory by checking
+/// the DEBUGINFOD_CACHE_POLICY environment variable, whose format is the one
+/// accepted by parseCachePruningPolicy(). The cache is pruned after new
+/// artifacts are downloaded into it.
+Expected<CachePruningPolicy> getDefaultDebuginfodCachePruningPolicy();
+
 /// Fetches a specified source file by searching the default local cache
 /// directory and server URLs.
 Expected<std::string> getCachedOrDownloadSource(BuildIDRef ID,
@@ -56,6 +65,13 @@ Expected<std::string> getCachedOrDownloadExecutable(BuildIDRef ID);
 /// server URLs.
 Expected<std::string> getCachedOrDownloadDebuginfo(BuildIDRef ID);
 
+/// Fetches the debug binaries for all of \p IDs by searching the default local
+/// cache directory and server URLs, running up to the number of threads given
+/// by \p S lookups at a time. The result at index I is the one for IDs[I].
+std::vector<Expected<std::string>>
+getCachedOrDownloadDebuginfos(ArrayRef<BuildIDRef> IDs,
+                              ThreadPoolStrategy S = hardware_concurrency());
+
 /// Fetches any debuginfod artifact using the default local cache directory and
 /// server URLs.
 Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
@@ -64,6 +80,12 @@ Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
 /// Fetches any debuginfod artifact using the specified local cache directory,
 /// server URLs, and request timeout (in milliseconds). If the artifact is
 /// found, uses the UniqueKey for the local cache file.
+///
+/// The cache directory can be shared by many clients on one host. While a
+/// client downloads an artifact, it holds a lock file next to the cache entry;
+/// other clients that miss on the same entry wait for the download to finish
+/// instead of downloading the artifact again. Entries are committed with an
+/// atomic rename, so readers never see partially written files.
 Expected<std::string> getCachedOrDownloadArtifact(
     StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
     ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout);
@@ -14,6 +14,7 @@
 #define LLVM_EXECUTIONENGINE_JITLINK_JITLINKMEMORYMANAGER_H
 
 #include "llvm/ADT/FunctionExtras.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ExecutionEngine/JITLink/JITLinkDylib.h"
 #include "llvm/ExecutionEngine/JITLink/MemoryFlags.h"
@@ -27,6 +28,7 @@
 
 #include <cstdint>
 #include <future>
+#include <map>
 #include <mutex>
 
 namespace llvm {
@@ -390,6 +392,123 @@ private:
   RecyclingAllocator<BumpPtrAllocator, FinalizedAllocInfo> FinalizedAllocInfos;
 };
 
+/// A JITLinkMemoryManager that sub-allocates in-process memory from a single
+/// large reservation.
+///
+/// The reservation is divided into slabs (2Mb, the size of an x86-64 huge
+/// page, by default) and each slab holds one kind of memory only: hot code,
+/// other code, or data. Code from all graphs is thereby packed densely into a
+/// few slabs instead of being scattered across the address space, which keeps
+/// the number of TLB entries needed to cover it small. With UseHugePages the
+/// reservation is mapped with MF_HUGE_HINT, so that slabs whose pages all end
+/// up with the same protections can be backed by transparent huge pages.
+///
+/// Memory released by deallocate, e.g. when a ResourceTracker or JITDylib is
+/// removed, goes back to its slab for reuse. Slabs that become empty go back
+/// to the reservation and can be reused for another kind of memory.
+///
+/// The default reservation of 1Gb keeps all code and data allocated through
+/// one manager within range of 32-bit PC-relative fixups.
+class SlabMemoryManager : public JITLinkMemoryManager {
+public:
+  class SlabInFlightAlloc;
+
+  /// Returns true if the code of the given graph should be placed with other
+  /// hot code. Must be thread-safe.
+  using IsHotGraphFunction = unique_function<bool(const LinkGraph &)>;
+
+  static constexpr uint64_t DefaultReservationSize = 1ULL << 30;
+  static constexpr uint64_t DefaultSlabSize = 2ULL << 20;
+
+  /// Reserves \p ReservationSize bytes and creates a manager for them.
+  static Expected<std::unique_ptr<SlabMemoryManager>>
+  Create(uint64_t ReservationSize = DefaultReservationSize,
+         bool UseHugePages = false,
+         IsHotGraphFunction IsHotGraph = IsHotGraphFunction(),
+         uint64_t SlabSize = DefaultSlabSize);
+
+  ~SlabMemoryManager();
+
+  void allocate(const JITLinkDylib *JD, LinkGraph &G,
+                OnAllocatedFunction OnAllocated) override;
+
+  // Use overloads from base class.
+  using JITLinkMemoryManager::allocate;
+
+  void deallocate(std::vector<FinalizedAlloc> Alloc,
+                  OnDeallocatedFunction OnDeallocated) override;
+
+  // Use overloads from base class.
+  using JITLinkMemoryManager::deallocate;
+
+  /// Returns the number of bytes currently allocated to graphs.
+  uint64_t getAllocatedSize();
+
+  /// Returns the number of bytes currently held by slabs.
+  uint64_t getSlabBytes();
+
+private:
+  enum Pool { HotCode, Code, Data, NumPools };
+
+  /// A range of the reservation, as an offset from its base.
+  struct Range {
+    uint64_t Offset = 0;
+    uint64_t Size = 0;
+  };
+
+  /// Free ranges, coalesced, ordered by offset and allocated first-fit.
+  class FreeList {
+  public:
+    void add(Range R);
+    Optional<Range> take(uint64_t Size);
+
+  private:
+    std::map<uint64_t, uint64_t> Ranges;
+  };
+
+  struct Slab {
+    Pool P;
+    uint64_t Size;
+    uint64_t Used = 0;
+    FreeList Free;
+  };
+
+  struct FinalizedAllocInfo {
+    SmallVector<Range, 4> StandardSegments;
+    std::vector<orc::shared::WrapperFunctionCall> DeallocActions;
+  };
+
+  SlabMemoryManager(sys::MemoryBlock Mapping, uint64_t ReservationSize,
+                    uint64_t PageSize, uint64_t SlabSize,
+                    IsHotGraphFunction IsHotGraph);
+
+  Expected<Range> allocateRange(Pool P, uint64_t Size);
+  void releaseRanges(ArrayRef<Range> Ranges);
+  sys::MemoryBlock getMemoryBlock(Range R) const {
+    return sys::MemoryBlock(Base + R.Offset, R.Size);
+  }
+
+  FinalizedAlloc createFinalizedAlloc(
+      SmallVector<Range, 4> StandardSegments,
+      std::vector<orc::shared::WrapperFunctionCall> DeallocActions);
+
+  sys::MemoryBlock Mapping;
+  char *Base;
+  uint64_t ReservationSize;
+  uint64_t PageSize;
+  uint64_t SlabSize;
+  IsHotGraphFunction IsHotGraph;
+
+  std::mutex RangesMutex;
+  FreeList FreeSlabs;
+  std::map<uint64_t, Slab> Slabs;
+  uint64_t AllocatedSize = 0;
+  uint64_t SlabBytes = 0;
+
+  std::mutex FinalizedAllocsMutex;
+  RecyclingAllocator<BumpPtrAllocator, FinalizedAllocInfo> FinalizedAllocInfos;
+};
+
 } // end namespace jitlink
 } // end namespace llvm
 
@@ -698,6 +698,14 @@ public:
   /// Returns the initialization symbol for this MaterializationUnit (if any).
   const SymbolStringPtr &getInitializerSymbol() const { return InitSymbol; }
 
+  /// Returns the priority of the task that materializes this unit.
+  unsigned getPriority() const { return Priority; }
+
+  /// Sets the priority of the task that materializes this unit. Dispatchers
+  /// that support priorities, such as PriorityThreadPoolTaskDispatcher, run
+  /// units with a higher priority first.
+  void setPriority(unsigned NewPriority) { Priority = NewPriority; }
+
   /// Implementations of this method should materialize all symbols
   ///        in the materialzation unit, except for those that have been
   ///        previously discarded.
@@ -716,6 +724,8 @@ protected:
   SymbolStringPtr InitSymbol;
 
 private:
+  unsigned Priority = 0;
+
   virtual void anchor();
 
   /// Implementations of this method should discard the given symbol
@@ -1349,6 +1359,7 @@ public:
       : MU(std::move(MU)), MR(std::move(MR)) {}
   void printDescription(raw_ostream &OS) override;
   void run() override;
+  unsigned getPriority() const override { return MU->getPriority(); }
 
 private:
   std::unique_ptr<MaterializationUnit> MU;
@@ -0,0 +1,88 @@
+//===- PersistentObjectCache.h - On-disk cache of JIT'd objects -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps compiled objects in a directory, so that the JIT
+// can skip code generation for modules it has compiled in an earlier run.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+
+class MemoryBuffer;
+class MemoryBufferRef;
+class Module;
+
+namespace orc {
+
+class JITTargetMachineBuilder;
+
+/// An ObjectCache that stores objects in a directory on disk.
+///
+/// Entries are keyed on a hash of the module's bitcode, the LLVM version and
+/// the target configuration, so a module is only reused when it would have
+/// compiled to the same object. Cached objects are mapped into memory rather
+/// than read, and the directory is pruned according to a CachePruningPolicy
+/// as new objects are added.
+///
+/// Pass the cache to SimpleCompiler or ConcurrentIRCompiler. The cache may be
+/// used by several compile threads at once.
+class PersistentObjectCache : public ObjectCache {
+public:
+  /// Create a cache in \p CacheDir for objects compiled by target machines
+  /// built from \p JTMB. The directory is created if it does not exist.
+  static Expected<std::unique_ptr<PersistentObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  /// Create a cache in an existing directory \p CacheDir. \p TargetKey must
+  /// identify everything other than the module that affects code generation.
+  PersistentObjectCache(std::string CacheDir, std::string TargetKey,
+                        CachePruningPolicy Policy = CachePruningPolicy());
+
+  /// Returns a string identifying the code generation configuration of
+  /// \p JTMB, for use as a TargetKey.
+  static std::string getTargetKey(const JITTargetMachineBuilder &JTMB);
+
+  /// Returns the key under which the object for \p M is stored.
+  std::string getModuleKey(const Module &M) const;
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Prune the cache directory according to the policy now, regardless of
+  /// when it was last pruned.
+  void prune();
+
+private:
+  std::string getEntryPath(StringRef Key) const;
+
+  std::string CacheDir;
+  std::string TargetKey;
+  CachePruningPolicy Policy;
+
+  std::mutex PendingMutex;
+  /// Keys computed by getObject for the modules it missed on, so that they do
+  /// not need to be recomputed from the IR after code generation changed it.
+  DenseMap<const Module *, std::string> PendingKeys;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
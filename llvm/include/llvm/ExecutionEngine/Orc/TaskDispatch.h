@@ -19,12 +19,14 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include <cassert>
+#include <cstdint>
 #include <string>
 
 #if LLVM_ENABLE_THREADS
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
 #endif
 
 namespace llvm {
@@ -43,6 +45,10 @@ public:
   /// Run the task.
   virtual void run() = 0;
 
+  /// Priority of the task. Dispatchers that support priorities start tasks
+  /// with a higher priority first.
+  virtual unsigned getPriority() const { return 0; }
+
 private:
   void anchor() override;
 };
@@ -123,6 +129,46 @@ private:
   std::condition_variable OutstandingCV;
 };
 
+/// Runs tasks on a fixed number of threads. Queued tasks with a higher
+/// priority are started first, tasks with the same priority are started in
+/// the order in which they were dispatched.
+class PriorityThreadPoolTaskDispatcher : public TaskDispatcher {
+public:
+  PriorityThreadPoolTaskDispatcher(unsigned NumThreads);
+  ~PriorityThreadPoolTaskDispatcher() override;
+
+  void dispatch(std::unique_ptr<Task> T) override;
+
+  /// Waits until all queued tasks, including any they dispatch, have run and
+  /// stops the threads. Tasks dispatched afterwards run on the caller's
+  /// thread.
+  void shutdown() override;
+
+private:
+  struct QueuedTask {
+    unsigned Priority;
+    uint64_t Seq;
+    std::unique_ptr<Task> T;
+  };
+
+  static bool runsAfter(const QueuedTask &A, const QueuedTask &B) {
+    return A.Priority < B.Priority ||
+           (A.Priority == B.Priority && A.Seq > B.Seq);
+  }
+
+  void runWorker();
+
+  std::mutex QueueMutex;
+  std::condition_variable QueueCV;
+  std::condition_variable IdleCV;
+  /// A heap ordered by runsAfter.
+  std::vector<QueuedTask> Queue;
+  uint64_t NextSeq = 0;
+  size_t Active = 0;
+  bool Running = true;
+  std::vector<std::thread> Threads;
+};
+
 #endif // LLVM_ENABLE_THREADS
 
 } // End namespace orc
@@ -0,0 +1,131 @@
+//===- TieredCompileLayer.h - Recompile hot functions -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// JIT layer that compiles functions with a fast first tier, counts calls to
+// them and recompiles hot functions with a second, optimizing tier.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
+#include "llvm/ExecutionEngine/Orc/Mangling.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// Compiles modules with \p Tier0Layer and recompiles functions that become
+/// hot with \p Tier1Layer.
+///
+/// Like the CompileOnDemandLayer, this layer moves the definitions into an
+/// implementation JITDylib and makes callable symbols available through lazy
+/// call-through stubs. The first tier instruments every function in the
+/// module to count its calls. Once a function has been called
+/// \p HotCallCount times, it calls back into the layer, which compiles the
+/// original, uninstrumented function with the second tier on the session's
+/// task dispatcher and then points the function's stub at the new code.
+///
+/// Call counting relies on the JIT'd code calling back into this process, so
+/// the layer only works for in-process JITs. addTieringRuntime must be called
+/// for a JITDylib visible to the compiled code before any code runs.
+/// Modules with aliases or with mutable internal globals are only compiled
+/// with the first tier, since a second copy of them would duplicate state.
+class TieredCompileLayer : public IRLayer {
+public:
+  /// Builder for IndirectStubsManagers.
+  using IndirectStubsManagerBuilder =
+      std::function<std::unique_ptr<IndirectStubsManager>()>;
+
+  /// Priority of the materialization of second tier functions, so that they
+  /// are compiled ahead of other work on dispatchers that support priorities.
+  static constexpr unsigned Tier1Priority = 1;
+
+  TieredCompileLayer(ExecutionSession &ES, IRLayer &Tier0Layer,
+                     IRLayer &Tier1Layer, LazyCallThroughManager &LCTMgr,
+                     IndirectStubsManagerBuilder BuildIndirectStubsManager,
+                     uint64_t HotCallCount);
+
+  /// Define the symbols for this layer (__orc_tiered_layer) and the entry
+  /// point called by hot functions (__orc_tier_up) in the given JITDylib.
+  Error addTieringRuntime(JITDylib &JD, MangleAndInterner &Mangle);
+
+  /// Emits the given module. This should not be called by clients: it will be
+  /// called by the JIT when a definition added via the add method is requested.
+  void emit(std::unique_ptr<MaterializationResponsibility> R,
+            ThreadSafeModule TSM) override;
+
+private:
+  struct PerDylibResources {
+  public:
+    PerDylibResources(JITDylib &ImplD,
+                      std::unique_ptr<IndirectStubsManager> ISMgr)
+        : ImplD(ImplD), ISMgr(std::move(ISMgr)) {}
+    JITDylib &getImplDylib() { return ImplD; }
+    IndirectStubsManager &getISManager() { return *ISMgr; }
+
+  private:
+    JITDylib &ImplD;
+    std::unique_ptr<IndirectStubsManager> ISMgr;
+  };
+
+  /// A function instrumented by the first tier.
+  struct TierUpCandidate {
+    JITDylib *TargetD;
+    /// The name of the function's stub in TargetD.
+    SymbolStringPtr StubName;
+    /// The name of the function in the IR.
+    std::string IRName;
+    /// The uninstrumented module defining the function.
+    std::shared_ptr<ThreadSafeModule> Source;
+    bool Promoted = false;
+  };
+
+  using PerDylibResourcesMap = std::map<const JITDylib *, PerDylibResources>;
+
+  PerDylibResources &getPerDylibResources(JITDylib &TargetD);
+
+  /// Returns true if a copy of \p M can be compiled next to \p M.
+  static bool canRecompile(const Module &M);
+
+  /// Instruments functions of \p M with stubs in \p Callables to count their
+  /// calls and records them as candidates for the second tier.
+  void instrumentModule(Module &M, JITDylib &TargetD,
+                        const SymbolAliasMap &Callables,
+                        std::shared_ptr<ThreadSafeModule> Source);
+
+  /// Called by hot functions.
+  void tierUp(uint64_t CandidateId);
+
+  void compileTier1(TierUpCandidate C);
+
+  static void tierUpEntryPoint(TieredCompileLayer *Layer,
+                               uint64_t CandidateId);
+
+  IRLayer &Tier0Layer;
+  IRLayer &Tier1Layer;
+  LazyCallThroughManager &LCTMgr;
+  IndirectStubsManagerBuilder BuildIndirectStubsManager;
+  uint64_t HotCallCount;
+
+  std::mutex LayerMutex;
+  PerDylibResourcesMap DylibResources;
+  std::vector<TierUpCandidate> Candidates;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
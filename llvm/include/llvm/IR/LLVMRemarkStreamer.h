@@ -41,6 +41,8 @@ public:
   LLVMRemarkStreamer(remarks::RemarkStreamer &RS) : RS(RS) {}
   /// Emit a diagnostic through the streamer.
   void emit(const DiagnosticInfoOptimizationBase &Diag);
+  /// Check whether the remarks of \p PassName pass the streamer's filter.
+  bool matchesFilter(StringRef PassName) const;
 };
 
 template <typename ThisError>
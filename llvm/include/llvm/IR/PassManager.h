@@ -587,6 +587,13 @@ extern template class PassManager<Module>;
 /// Convenience typedef for a pass manager over modules.
 using ModulePassManager = PassManager<Module>;
 
+/// Specialization of the run method for function pass managers, which with
+/// -preserve-unchanged-cfg-analyses keeps the CFG analyses of a function when
+/// a pass did not change its CFG, even if the pass did not say so.
+template <>
+PreservedAnalyses
+PassManager<Function>::run(Function &F, AnalysisManager<Function> &AM);
+
 extern template class PassManager<Function>;
 
 /// Convenience typedef for a pass manager over functions.
@@ -11,11 +11,13 @@
 /// instruction or some other User instance which refers to a Value.  The Use
 /// class keeps the "use list" of the referenced value up to date.
 ///
-/// Pointer tagging is used to efficiently find the User corresponding to a Use
-/// without having to store a User pointer in every Use. A User is preceded in
-/// memory by all the Uses corresponding to its operands, and the low bits of
-/// one of the fields (Prev) of the Use class are used to encode offsets to be
-/// able to find that User given a pointer to any Use. For details, see:
+/// By default every Use stores a pointer to its User. When LLVM is built with
+/// LLVM_ENABLE_COMPACT_USES, pointer tagging is used instead to find the User
+/// corresponding to a Use without having to store a User pointer in every
+/// Use. A User is preceded in memory by all the Uses corresponding to its
+/// operands, and the low bits of one of the fields (Prev) of the Use class are
+/// used to encode offsets to be able to find that User given a pointer to any
+/// Use. For details, see:
 ///
 ///   http://www.llvm.org/docs/ProgrammersManual.html#UserLayout
 ///
@@ -27,6 +29,9 @@
 #include "llvm-c/Types.h"
 #include "llvm/Support/CBindingWrapping.h"
 #include "llvm/Support/Compiler.h"
+#ifdef LLVM_COMPACT_USES
+#include "llvm/ADT/PointerIntPair.h"
+#endif
 
 namespace llvm {
 
@@ -48,6 +53,20 @@ public:
   /// that also works with less standard-compliant compilers
   void swap(Use &RHS);
 
+#ifdef LLVM_COMPACT_USES
+  /// Points from the end of a hung-off operand array to its User. The tag is
+  /// set, which tells it apart from the first word of a User that directly
+  /// follows its operands.
+  using UserRef = PointerIntPair<User *, 1, unsigned>;
+#endif
+
+  /// The number of bytes that have to follow a hung-off operand array.
+#ifdef LLVM_COMPACT_USES
+  static constexpr size_t HungOffTrailerSize = sizeof(UserRef);
+#else
+  static constexpr size_t HungOffTrailerSize = 0;
+#endif
+
 private:
   /// Destructor - Only for zap()
   ~Use() {
@@ -55,8 +74,20 @@ private:
       removeFromList();
   }
 
+#ifdef LLVM_COMPACT_USES
+  enum PrevPtrTag { zeroDigitTag, oneDigitTag, stopTag, fullStopTag };
+
+  /// Constructor
+  Use(PrevPtrTag Tag) { Prev.setInt(Tag); }
+#else
   /// Constructor
   Use(User *Parent) : Parent(Parent) {}
+#endif
+
+  /// Constructs the Uses in [Start, Stop), the operands of \p Parent. With
+  /// compact uses, \p Stop must be \p Parent, or the place of a UserRef to
+  /// \p Parent if \p HungOff.
+  static void initOperands(Use *Start, Use *Stop, User *Parent, bool HungOff);
 
 public:
   friend class Value;
@@ -69,7 +100,11 @@ public:
   ///
   /// For an instruction operand, for example, this will return the
   /// instruction.
+#ifdef LLVM_COMPACT_USES
+  User *getUser() const;
+#else
   User *getUser() const { return Parent; };
+#endif
 
   inline void set(Value *Val);
 
@@ -92,21 +127,37 @@ private:
 
   Value *Val = nullptr;
   Use *Next = nullptr;
+#ifdef LLVM_COMPACT_USES
+  /// The tags are the waymarks that lead getUser() to the end of the operand
+  /// array; see initOperands().
+  PointerIntPair<Use **, 2, PrevPtrTag> Prev;
+
+  Use **getPrev() const { return Prev.getPointer(); }
+  void setPrev(Use **NewPrev) { Prev.setPointer(NewPrev); }
+
+  /// Returns the end of the operand array that contains this Use.
+  const Use *getImpliedUser() const;
+#else
   Use **Prev = nullptr;
   User *Parent = nullptr;
 
+  Use **getPrev() const { return Prev; }
+  void setPrev(Use **NewPrev) { Prev = NewPrev; }
+#endif
+
   void addToList(Use **List) {
     Next = *List;
     if (Next)
-      Next->Prev = &Next;
-    Prev = List;
-    *Prev = this;
+      Next->setPrev(&Next);
+    setPrev(List);
+    *List = this;
   }
 
   void removeFromList() {
-    *Prev = Next;
+    Use **StrippedPrev = getPrev();
+    *StrippedPrev = Next;
     if (Next)
-      Next->Prev = Prev;
+      Next->setPrev(StrippedPrev);
   }
 };
 
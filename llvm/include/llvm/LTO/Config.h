@@ -98,6 +98,14 @@ struct Config {
   // conjunction OptPipeline.
   std::string AAPipeline;
 
+  /// If this field is set, every code generation partition of a regular LTO
+  /// backend runs the pass pipeline specified by the string before it is
+  /// compiled. With more than one partition, partitions are optimized in
+  /// parallel, each in its own LLVMContext, so this allows moving function
+  /// passes out of the serial OptPipeline. Passes only see the functions of
+  /// their partition. Only works with the new pass manager.
+  std::string PartitionOptPipeline;
+
   /// Setting this field will replace target triples in input files with this
   /// triple.
   std::string OverrideTriple;
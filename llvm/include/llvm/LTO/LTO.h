@@ -96,6 +96,19 @@ setupStatsFile(StringRef StatsFilename);
 /// ordered indices to elements in the input array.
 std::vector<int> generateModulesOrdering(ArrayRef<BitcodeModule *> R);
 
+/// Same as above, but orders the elements by decreasing estimated cost, using
+/// the bitcode size to break ties.
+std::vector<int> generateModulesOrdering(ArrayRef<BitcodeModule *> R,
+                                         ArrayRef<uint64_t> Costs);
+
+/// Estimates the cost of running the ThinLTO backend on a module from the
+/// combined summary, as the number of IR instructions in the functions the
+/// module defines plus those it imports.
+uint64_t estimateThinLTOBackendCost(
+    const ModuleSummaryIndex &CombinedIndex,
+    const GVSummaryMapTy &DefinedGlobals,
+    const FunctionImporter::ImportMapTy &ImportList);
+
 class LTO;
 struct SymbolResolution;
 class ThinBackendProc;
@@ -89,6 +89,9 @@ private:
 
   bool IsRegistered : 1;
 
+  /// Whether this section has fragments that layout may need to relax.
+  bool HasRelaxableFragments : 1;
+
   MCDummyFragment DummyFragment;
 
   FragmentListType Fragments;
@@ -158,6 +161,9 @@ public:
   bool hasInstructions() const { return HasInstructions; }
   void setHasInstructions(bool Value) { HasInstructions = Value; }
 
+  bool hasRelaxableFragments() const { return HasRelaxableFragments; }
+  void setHasRelaxableFragments(bool Value) { HasRelaxableFragments = Value; }
+
   bool isRegistered() const { return IsRegistered; }
   void setIsRegistered(bool Value) { IsRegistered = Value; }
 
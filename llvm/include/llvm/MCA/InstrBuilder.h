@@ -50,6 +50,7 @@ class InstrBuilder {
 
   Expected<const InstrDesc &> createInstrDescImpl(const MCInst &MCI);
   Expected<const InstrDesc &> getOrCreateInstrDesc(const MCInst &MCI);
+  void checkCallOrReturn(const MCInstrDesc &MCDesc);
 
   InstrBuilder(const InstrBuilder &) = delete;
   InstrBuilder &operator=(const InstrBuilder &) = delete;
@@ -64,6 +65,13 @@ public:
 
   void clear() {
     Descriptors.clear();
+    clearRegionState();
+  }
+
+  /// Reset the state specific to a code region before analyzing the next one.
+  /// Descriptors of non-variant opcodes only depend on the opcode and on the
+  /// subtarget, so they are kept and shared by all the regions.
+  void clearRegionState() {
     VariantDescriptors.clear();
     FirstCallInst = true;
     FirstReturnInst = true;
@@ -17,6 +17,7 @@
 
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/OptBisect.h"
@@ -79,6 +80,24 @@ public:
   void registerCallbacks(PassInstrumentationCallbacks &PIC);
 };
 
+// Skips passes that scale badly with function size on functions that are
+// larger than -compile-time-budget-max-instructions and, with
+// -compile-time-budget-cold, on cold functions, giving those functions a
+// cheaper pipeline. Required passes are never skipped.
+class CompileTimeBudgetInstrumentation {
+public:
+  CompileTimeBudgetInstrumentation(bool DebugLogging)
+      : DebugLogging(DebugLogging) {}
+  ~CompileTimeBudgetInstrumentation();
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+
+private:
+  bool DebugLogging;
+  // How often each pass was skipped, for -compile-time-budget-report.
+  StringMap<unsigned> SkippedPasses;
+  bool shouldRun(StringRef PassID, Any IR);
+};
+
 struct PrintPassOptions {
   /// Print adaptors and pass managers.
   bool Verbose = false;
@@ -499,6 +518,7 @@ class StandardInstrumentations {
   TimePassesHandler TimePasses;
   OptNoneInstrumentation OptNone;
   OptBisectInstrumentation OptBisect;
+  CompileTimeBudgetInstrumentation CompileTimeBudget;
   PreservedCFGCheckerInstrumentation PreservedCFGChecker;
   IRChangedPrinter PrintChangedIR;
   PseudoProbeVerifier PseudoProbeVerification;
@@ -160,6 +160,14 @@ inline StringRef getInstrProfCounterBiasVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_BIAS_VAR);
 }
 
+inline StringRef getInstrProfCounterShardsVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARDS_VAR);
+}
+
+inline StringRef getInstrProfThreadAnchorVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_THREAD_ANCHOR_VAR);
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
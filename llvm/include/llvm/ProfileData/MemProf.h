@@ -0,0 +1,78 @@
+//===- MemProf.h - MemProf support ------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the symbolized representation of MemProf profiles, and
+// the classification of allocation contexts used for profile guided heap
+// optimizations.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_PROFILEDATA_MEMPROF_H_
+#define LLVM_PROFILEDATA_MEMPROF_H_
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ProfileData/MemProfData.inc"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstdint>
+#include <string>
+
+namespace llvm {
+namespace memprof {
+
+// A symbolized frame of an allocation call stack.
+struct Frame {
+  // The linkage name of the function the frame belongs to.
+  std::string Function;
+  // The line of the frame relative to the first line of the function, which
+  // is more stable than the absolute line across source changes.
+  uint32_t LineOffset = 0;
+  uint32_t Column = 0;
+  // Whether the code was inlined into the function of the next frame.
+  bool IsInlineFrame = false;
+
+  bool operator==(const Frame &Other) const {
+    return Function == Other.Function && LineOffset == Other.LineOffset &&
+           Column == Other.Column && IsInlineFrame == Other.IsInlineFrame;
+  }
+  bool operator!=(const Frame &Other) const { return !operator==(Other); }
+};
+
+// The heap profile of an allocation context: the symbolized call stack,
+// starting with the frame of the allocation call, and the characteristics of
+// the allocations made from it.
+struct MemProfRecord {
+  SmallVector<Frame> CallStack;
+  MemInfoBlock Info;
+
+  void print(raw_ostream &OS) const;
+};
+
+// The allocation behavior of a context, as far as the heap optimizations are
+// concerned.
+enum class AllocationType : uint8_t {
+  // No special handling.
+  NotCold,
+  // Long lived and rarely accessed allocations.
+  Cold,
+  // Frequently accessed allocations.
+  Hot,
+};
+
+// Classify the allocations described by \p Info, based on their number of
+// accesses per byte and per second of lifetime, and on their average lifetime.
+AllocationType getAllocType(const MemInfoBlock &Info);
+
+// Return the value of the "memprof" call site attribute for \p Type.
+StringRef getAllocTypeAttributeString(AllocationType Type);
+
+} // namespace memprof
+} // namespace llvm
+
+#endif // LLVM_PROFILEDATA_MEMPROF_H_
@@ -12,9 +12,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
+#include "llvm/Object/Binary.h"
+#include "llvm/ProfileData/MemProf.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
 
+#include <vector>
+
 namespace llvm {
 namespace memprof {
 
@@ -22,9 +27,23 @@ class RawMemProfReader {
 public:
   RawMemProfReader(std::unique_ptr<MemoryBuffer> DataBuffer)
       : DataBuffer(std::move(DataBuffer)) {}
+  // Create a reader which symbolizes the call stacks of the profiles with
+  // \p Symbolizer. \p Symbolizer is queried with the addresses of the profiled
+  // binary, which are its file offsets plus \p FileOffsetToAddress.
+  RawMemProfReader(std::unique_ptr<MemoryBuffer> DataBuffer,
+                   std::unique_ptr<symbolize::SymbolizableModule> Symbolizer,
+                   int64_t FileOffsetToAddress)
+      : DataBuffer(std::move(DataBuffer)), Symbolizer(std::move(Symbolizer)),
+        FileOffsetToAddress(FileOffsetToAddress) {}
   // Prints aggregate counts for each raw profile parsed from the DataBuffer.
   void printSummaries(raw_ostream &OS) const;
 
+  // Returns a record for each allocation context of the raw profiles parsed
+  // from the DataBuffer, with a symbolized call stack. Only the frames of the
+  // profiled binary are kept, without the frames of the memprof runtime, and
+  // the contexts left without any frame are dropped. Requires a symbolizer.
+  Expected<std::vector<MemProfRecord>> readRecords() const;
+
   // Return true if the \p DataBuffer starts with magic bytes indicating it is
   // a raw binary memprof profile.
   static bool hasFormat(const MemoryBuffer &DataBuffer);
@@ -33,8 +52,18 @@ public:
   // \p Path.
   static Expected<std::unique_ptr<RawMemProfReader>> create(const Twine &Path);
 
+  // Create a RawMemProfReader for the file at \p Path which symbolizes the
+  // call stacks with the debug information of \p ProfiledBinary, the
+  // executable which produced the profile.
+  static Expected<std::unique_ptr<RawMemProfReader>>
+  create(const Twine &Path, const StringRef ProfiledBinary);
+
 private:
   std::unique_ptr<MemoryBuffer> DataBuffer;
+  // The profiled binary, which the symbolizer refers to.
+  object::OwningBinary<object::Binary> Binary;
+  std::unique_ptr<symbolize::SymbolizableModule> Symbolizer;
+  int64_t FileOffsetToAddress = 0;
 };
 
 } // namespace memprof
@@ -65,7 +65,7 @@ public:
   /// Returns an error if the regex is invalid.
   Error setFilter(StringRef Filter);
   /// Check wether the string matches the filter.
-  bool matchesFilter(StringRef Str);
+  bool matchesFilter(StringRef Str) const;
   /// Check if the remarks also need to have associated metadata in a section.
   bool needsSection() const;
 };
@@ -226,6 +226,10 @@ private:
     /// Returns a pointer to the end of the buffer.
     uint8_t *getBufferEnd() const { return FileBuffer->getBufferEnd(); }
 
+    void startWriteBack(uint64_t Offset, uint64_t Size) {
+      FileBuffer->startWriteBack(Offset, Size);
+    }
+
   private:
     std::unique_ptr<FileOutputBuffer> FileBuffer;
   };
@@ -263,6 +267,13 @@ public:
   /// Returns a pointer to the end of the buffer.
   uint8_t *getBufferEnd() const { return Impl.getBufferEnd(); }
 
+  /// Hints that the given range of the buffer is complete, so that its pages
+  /// may be written to disk before the stream is committed. See
+  /// FileOutputBuffer::startWriteBack.
+  void startWriteBack(uint64_t Offset, uint64_t Size) {
+    Impl.startWriteBack(Offset, Size);
+  }
+
 private:
   StreamImpl Impl;
 };
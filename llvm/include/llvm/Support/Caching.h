@@ -71,6 +71,19 @@ Expected<FileCache> localCache(
     Twine CacheNameRef, Twine TempFilePrefixRef, Twine CacheDirectoryPathRef,
     AddBufferFn AddBuffer = [](size_t Task, std::unique_ptr<MemoryBuffer> MB) {
     });
+
+/// This type defines the callback to look up an entry in a secondary store,
+/// such as a content-addressed store shared between machines. It returns a
+/// null buffer if the store does not contain the entry.
+///
+/// Lookup callbacks must be thread safe.
+using CacheLookupFn =
+    std::function<Expected<std::unique_ptr<MemoryBuffer>>(StringRef Key)>;
+
+/// Create a file cache which consults \p Lookup for entries that miss in
+/// \p Cache. Entries found by \p Lookup are written to \p Cache, which adds
+/// them to the link, so that later lookups of the same key hit in \p Cache.
+FileCache tieredCache(FileCache Cache, CacheLookupFn Lookup);
 } // namespace llvm
 
 #endif
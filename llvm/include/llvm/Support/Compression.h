@@ -32,6 +32,16 @@ bool isAvailable();
 Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
                int Level = DefaultCompression);
 
+/// Compresses \p InputBuffer like compress(), but splits it into chunks of
+/// \p ChunkSize bytes that are compressed independently and in parallel, then
+/// joined into a single zlib stream that uncompress() accepts. The output is
+/// slightly larger than the one of compress() and does not depend on the
+/// number of threads. Inputs of at most one chunk are passed to compress().
+Error compressParallel(StringRef InputBuffer,
+                       SmallVectorImpl<char> &CompressedBuffer,
+                       int Level = DefaultCompression,
+                       size_t ChunkSize = 1 << 20);
+
 Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
                  size_t &UncompressedSize);
 
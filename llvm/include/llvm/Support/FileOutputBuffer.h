@@ -76,6 +76,11 @@ public:
   /// but keeps the memory mapping alive.
   virtual void discard() {}
 
+  /// Hints that the range [Offset, Offset + Size) of the buffer has been
+  /// filled in, so that it may be written to the file before commit() is
+  /// called. The range can still be modified afterwards.
+  virtual void startWriteBack(size_t Offset, size_t Size) {}
+
 protected:
   FileOutputBuffer(StringRef Path) : FinalPath(Path) {}
 
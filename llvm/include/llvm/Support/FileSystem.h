@@ -426,6 +426,17 @@ inline std::error_code resize_file_before_mapping_readwrite(int FD,
 #endif
 }
 
+/// Start writing dirty pages of the byte range [Offset, Offset + Size) of
+/// \p FD to the underlying storage, without waiting for the I/O to complete.
+/// This is a no-op on platforms that do not support it.
+///
+/// @param FD Input file descriptor.
+/// @param Offset Start of the range.
+/// @param Size Length of the range.
+/// @returns errc::success if write-back was started or is not supported,
+///          otherwise a platform-specific error_code.
+std::error_code start_write_back(int FD, uint64_t Offset, uint64_t Size);
+
 /// Compute an MD5 hash of a file's contents.
 ///
 /// @param FD Input file descriptor.
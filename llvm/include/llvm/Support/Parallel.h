@@ -56,23 +56,32 @@ public:
       Cond.notify_all();
   }
 
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
+
   void sync() const {
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
 };
 
+/// A group of tasks run by the default executor.
+///
+/// Waiting for a group runs its pending tasks on the waiting thread rather
+/// than blocking it, so groups may be nested: a task of one group can spawn
+/// and wait for another group without starving the executor's threads.
 class TaskGroup {
   Latch L;
-  bool Parallel;
 
 public:
-  TaskGroup();
+  TaskGroup() = default;
   ~TaskGroup();
 
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  void sync() const;
 };
 
 const ptrdiff_t MinParallelSize = 1024;
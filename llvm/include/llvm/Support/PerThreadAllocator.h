@@ -0,0 +1,115 @@
+//===- PerThreadAllocator.h - One allocator per thread ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines PerThreadAllocator, which gives every thread its own
+/// instance of an allocator that is not thread-safe, such as
+/// BumpPtrAllocator, so that parallel code can allocate without locking.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_PERTHREADALLOCATOR_H
+#define LLVM_SUPPORT_PERTHREADALLOCATOR_H
+
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compiler.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+
+namespace detail {
+/// Returns a small number identifying the calling thread. Numbers are handed
+/// out in the order in which threads first ask for one, and are not reused.
+inline unsigned getPerThreadAllocatorIndex() {
+  static std::atomic<unsigned> NextIndex{0};
+  static LLVM_THREAD_LOCAL unsigned Index = 0;
+  if (!Index)
+    Index = ++NextIndex;
+  return Index - 1;
+}
+} // end namespace detail
+
+/// Holds one \p AllocatorT per thread that uses it.
+///
+/// get() returns the calling thread's allocator, creating it on first use.
+/// For the first \p NumFastSlots threads this takes no lock. Allocations made
+/// by any thread live until the PerThreadAllocator is reset or destroyed,
+/// which, like forEach(), must not happen while other threads allocate.
+template <typename AllocatorT, unsigned NumFastSlots = 128>
+class PerThreadAllocator {
+public:
+  PerThreadAllocator() = default;
+  PerThreadAllocator(const PerThreadAllocator &) = delete;
+  PerThreadAllocator &operator=(const PerThreadAllocator &) = delete;
+
+  /// Returns the allocator of the calling thread.
+  AllocatorT &get() {
+    unsigned Index = detail::getPerThreadAllocatorIndex();
+    if (Index < NumFastSlots)
+      if (AllocatorT *Alloc = FastSlots[Index].load(std::memory_order_acquire))
+        return *Alloc;
+    return getSlow(Index);
+  }
+
+  /// Allocates from the calling thread's allocator.
+  LLVM_ATTRIBUTE_RETURNS_NONNULL void *Allocate(size_t Size, Align Alignment) {
+    return get().Allocate(Size, Alignment);
+  }
+
+  /// Calls \p Fn on the allocator of every thread.
+  template <typename FnT> void forEach(FnT Fn) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (const std::unique_ptr<AllocatorT> &Alloc : Allocators)
+      Fn(*Alloc);
+  }
+
+  /// Resets the allocators of all threads at once, keeping them for reuse.
+  void Reset() {
+    forEach([](AllocatorT &Alloc) { Alloc.Reset(); });
+  }
+
+  size_t getBytesAllocated() {
+    size_t Bytes = 0;
+    forEach([&](AllocatorT &Alloc) { Bytes += Alloc.getBytesAllocated(); });
+    return Bytes;
+  }
+
+private:
+  AllocatorT &getSlow(unsigned Index) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (Index >= NumFastSlots) {
+      auto It = SlowSlots.find(Index);
+      if (It != SlowSlots.end())
+        return *It->second;
+    }
+    Allocators.push_back(std::make_unique<AllocatorT>());
+    AllocatorT *Alloc = Allocators.back().get();
+    if (Index < NumFastSlots)
+      FastSlots[Index].store(Alloc, std::memory_order_release);
+    else
+      SlowSlots[Index] = Alloc;
+    return *Alloc;
+  }
+
+  std::atomic<AllocatorT *> FastSlots[NumFastSlots] = {};
+  /// Guards everything below; FastSlots are only written with it held.
+  std::mutex Mutex;
+  std::map<unsigned, AllocatorT *> SlowSlots;
+  std::vector<std::unique_ptr<AllocatorT>> Allocators;
+};
+
+/// A BumpPtrAllocator per thread.
+using PerThreadBumpPtrAllocator = PerThreadAllocator<BumpPtrAllocator>;
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_PERTHREADALLOCATOR_H
@@ -44,7 +44,11 @@ struct SuffixTreeNode {
   /// A child existing on an unsigned integer implies that from the mapping
   /// represented by the current node, there is a way to reach another
   /// mapping by tacking that character on the end of the current string.
-  llvm::DenseMap<unsigned, SuffixTreeNode *> Children;
+  ///
+  /// Most internal nodes have two children and leaves have none, so keep a
+  /// couple of entries inline; a DenseMap would allocate 64 buckets for the
+  /// first child of every internal node.
+  llvm::SmallDenseMap<unsigned, SuffixTreeNode *, 4> Children;
 
   /// The start index of this node's substring in the main string.
   unsigned StartIdx = EmptyIdx;
@@ -11,6 +11,7 @@
 
 #include "llvm/Support/Error.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
+#include <functional>
 
 namespace llvm {
 
@@ -25,6 +26,12 @@ TimeTraceProfiler *getTimeTraceProfilerInstance();
 void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
                                  StringRef ProcName);
 
+/// Set a function returning the number of bytes allocated so far, e.g. by an
+/// allocator of interest. When set, every section of the time trace profiler
+/// on the current thread records the bytes allocated while it was open, the
+/// totals include them, and the most memory hungry sections are summarized.
+void timeTraceProfilerSetMemoryCounter(std::function<uint64_t()> Counter);
+
 /// Cleanup the time trace profiler, if it was initialized.
 void timeTraceProfilerCleanup();
 
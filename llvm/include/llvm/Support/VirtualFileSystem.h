@@ -18,7 +18,9 @@
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/Support/Chrono.h"
 #include "llvm/Support/ErrorOr.h"
@@ -29,6 +31,7 @@
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <system_error>
@@ -416,6 +419,61 @@ private:
   virtual void anchor();
 };
 
+/// A file system that remembers the result of every status() call, including
+/// failed ones, made to an underlying file system that is not expected to
+/// change.
+///
+/// Once \p ListingThreshold lookups in the same directory have failed, the
+/// directory is listed, and lookups of names that are not part of the
+/// listing fail without querying the underlying file system. This turns the
+/// misses of a header search into one directory read per search directory.
+///
+/// Changes to the underlying file system must be announced with invalidate()
+/// or invalidateAll(). The cache may be used from several threads at once.
+class CachingFileSystem : public ProxyFileSystem {
+public:
+  explicit CachingFileSystem(IntrusiveRefCntPtr<FileSystem> FS,
+                             unsigned ListingThreshold = 4)
+      : ProxyFileSystem(std::move(FS)), ListingThreshold(ListingThreshold) {}
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+  llvm::ErrorOr<std::unique_ptr<File>>
+  openFileForRead(const Twine &Path) override;
+
+  /// Forgets what is known about \p Path and the listing of its parent
+  /// directory. Call this after \p Path is created, removed or modified.
+  void invalidate(const Twine &Path);
+
+  /// Forgets everything that is cached.
+  void invalidateAll();
+
+private:
+  struct DirectoryInfo {
+    unsigned NumMisses = 0;
+    bool IsListed = false;
+    /// The lowercased names of all entries, if IsListed. They are compared
+    /// case-insensitively so that case-insensitive file systems still get to
+    /// answer for names that differ from an entry only in case.
+    StringSet<> Names;
+  };
+
+  /// Makes \p Path absolute and removes "." components from it.
+  std::error_code makeCacheKey(const Twine &Path, SmallVectorImpl<char> &Key);
+
+  /// Returns true if \p Key is known to be missing from its parent directory
+  /// according to a directory listing.
+  bool isMissingFromListing(StringRef Key);
+
+  /// Records a failed lookup of \p Key, listing its parent directory once it
+  /// has seen enough failures.
+  void noteMiss(StringRef Key);
+
+  const unsigned ListingThreshold;
+  std::mutex Mutex;
+  llvm::StringMap<llvm::ErrorOr<Status>> StatusCache;
+  llvm::StringMap<DirectoryInfo> Directories;
+};
+
 namespace detail {
 
 class InMemoryDirectory;
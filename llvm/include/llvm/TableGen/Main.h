@@ -17,12 +17,21 @@ namespace llvm {
 
 class raw_ostream;
 class RecordKeeper;
+class StringRef;
 
 /// Perform the action using Records, and write output to OS.
 /// Returns true on error, false otherwise.
 using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
-int TableGenMain(const char *argv0, TableGenMainFn *MainFn);
+/// Perform the action of the backend named Backend, as it is named on the
+/// command line without its leading dash, using Records, and write output to
+/// OS. Used for the outputs requested with -extra-output.
+/// Returns true on error, false otherwise.
+using TableGenBackendFn = bool (StringRef Backend, raw_ostream &OS,
+                                RecordKeeper &Records);
+
+int TableGenMain(const char *argv0, TableGenMainFn *MainFn,
+                 TableGenBackendFn *BackendFn = nullptr);
 
 } // end namespace llvm
 
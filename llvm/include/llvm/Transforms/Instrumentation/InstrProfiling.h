@@ -71,6 +71,10 @@ private:
 
   int64_t TotalCountersPromoted = 0;
 
+  // The offset of the counter shard of the current thread, computed once in
+  // the entry block of each function.
+  DenseMap<const Function *, Value *> FunctionToShardOffsetMap;
+
   /// Lower instrumentation intrinsics in the function. Returns true if there
   /// any lowering.
   bool lowerIntrinsics(Function *F);
@@ -81,6 +85,9 @@ private:
   /// Returns true if relocating counters at runtime is enabled.
   bool isRuntimeCounterRelocationEnabled() const;
 
+  /// Returns true if counters are incremented in per-thread shards.
+  bool isCounterShardingEnabled() const;
+
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
@@ -103,6 +110,10 @@ private:
   /// acts on.
   Value *getCounterAddress(InstrProfInstBase *I);
 
+  /// Get the offset from the counters to the counter shard of the current
+  /// thread in function \p F, creating it if necessary.
+  Value *getCounterShardOffset(Function *F);
+
   /// Get the region counters for an increment, creating them if necessary.
   ///
   /// If the counter array doesn't yet exist, the profile data variables
@@ -42,6 +42,25 @@ public:
   static bool isRequired() { return true; }
 };
 
+/// Annotate the allocation calls of the module with the behavior of their
+/// allocations in a raw memory profile, and optionally pass it as a hint to
+/// the allocator.
+///
+/// Each call to operator new matching the allocation frame of a profiled
+/// context gets a "memprof" call site attribute, whose value is "cold" for
+/// long lived and rarely accessed allocations, "hot" for frequently accessed
+/// ones and "notcold" otherwise.
+class MemProfUsePass : public PassInfoMixin<MemProfUsePass> {
+public:
+  explicit MemProfUsePass(std::string MemoryProfileFile = "",
+                          std::string ProfiledBinary = "");
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+private:
+  std::string MemoryProfileFileName;
+  std::string ProfiledBinaryFileName;
+};
+
 // Insert MemProfiler instrumentation
 FunctionPass *createMemProfilerFunctionPass();
 ModulePass *createModuleMemProfilerLegacyPassPass();
@@ -32,6 +32,9 @@
 
 namespace llvm {
 
+class BlockFrequencyInfo;
+class ProfileSummaryInfo;
+
 /// This pass performs function-level constant propagation and merging.
 class SCCPPass : public PassInfoMixin<SCCPPass> {
 public:
@@ -47,7 +50,9 @@ bool runFunctionSpecialization(
     std::function<TargetLibraryInfo &(Function &)> GetTLI,
     std::function<TargetTransformInfo &(Function &)> GetTTI,
     std::function<AssumptionCache &(Function &)> GetAC,
-    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis);
+    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis,
+    std::function<BlockFrequencyInfo &(Function &)> GetBFI = nullptr,
+    ProfileSummaryInfo *PSI = nullptr);
 } // end namespace llvm
 
 #endif // LLVM_TRANSFORMS_SCALAR_SCCP_H
@@ -272,7 +272,7 @@ static const std::vector<TensorSpec> TrainingOnlyFeatures{
 
 static const std::vector<TensorSpec> getInputFeatures() {
   std::vector<TensorSpec> InputSpecs;
-  for (size_t I = 0; I < NumberOfFeatures; ++I)
+  for (size_t I = 0; I < getNumberOfModelFeatures(); ++I)
     InputSpecs.push_back(
         TensorSpec::createSpec<int64_t>(TFFeedPrefix + FeatureNameMap[I], {1}));
   append_range(InputSpecs, TrainingOnlyFeatures);
@@ -289,7 +289,7 @@ TrainingLogger::TrainingLogger(StringRef LogFileName,
     OutputCount = MUTR->outputLoggedFeatureSpecs().size();
   std::vector<LoggedFeatureSpec> FT;
 
-  for (size_t I = 0; I < NumberOfFeatures; ++I)
+  for (size_t I = 0; I < getNumberOfModelFeatures(); ++I)
     FT.push_back(
         {TensorSpec::createSpec<int64_t>(FeatureNameMap.at(I), {1}), None});
   if (MUTR && MUTR->outputLoggedFeatureSpecs().size() > 1)
@@ -311,7 +311,7 @@ TrainingLogger::TrainingLogger(StringRef LogFileName,
 void TrainingLogger::logInlineEvent(const InlineEvent &Event,
                                     const MLModelRunner &ModelRunner) {
   size_t CurrentFeature = 0;
-  for (; CurrentFeature < NumberOfFeatures; ++CurrentFeature) {
+  for (; CurrentFeature < getNumberOfModelFeatures(); ++CurrentFeature) {
     int64_t F = *ModelRunner.getTensor<int64_t>(CurrentFeature);
     L->logInt64Value(CurrentFeature, &F);
   }
@@ -27,7 +27,8 @@
 
 using namespace llvm;
 #define DEBUG_TYPE "inline"
-#ifdef LLVM_HAVE_TF_AOT_INLINERSIZEMODEL
+#if defined(LLVM_HAVE_TF_AOT_INLINERSIZEMODEL) ||                              \
+    defined(LLVM_HAVE_TF_AOT_INLINERPERFMODEL)
 #define LLVM_HAVE_TF_AOT
 #endif
 
@@ -13,6 +13,7 @@
 //===----------------------------------------------------------------------===//
 #include "llvm/Analysis/MLInlineAdvisor.h"
 #include "llvm/ADT/SCCIterator.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/CallGraph.h"
 #include "llvm/Analysis/FunctionPropertiesAnalysis.h"
 #include "llvm/Analysis/InlineCost.h"
@@ -20,6 +21,7 @@
 #include "llvm/Analysis/LazyCallGraph.h"
 #include "llvm/Analysis/MLModelRunner.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/ReleaseModeModelRunner.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
@@ -28,6 +30,7 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
 
 #include <limits>
@@ -36,15 +39,61 @@
 
 using namespace llvm;
 
+namespace {
+enum class MLInlinerObjective { Size, Performance };
+} // namespace
+
+static cl::opt<MLInlinerObjective> Objective(
+    "ml-inliner-objective", cl::Hidden,
+    cl::desc("What the ML inliner policy optimizes for. When optimizing for "
+             "performance, the model is also given profile-derived features, "
+             "and release mode uses the AOT-compiled performance model."),
+    cl::init(MLInlinerObjective::Size),
+    cl::values(clEnumValN(MLInlinerObjective::Size, "size",
+                          "Optimize for native code size"),
+               clEnumValN(MLInlinerObjective::Performance, "performance",
+                          "Optimize for run time performance")));
+
+size_t llvm::getNumberOfModelFeatures() {
+  return Objective == MLInlinerObjective::Performance
+             ? NumberOfFeatures
+             : NumberOfFeatures - NumberOfProfileFeatures;
+}
+
 #if defined(LLVM_HAVE_TF_AOT_INLINERSIZEMODEL)
 // codegen-ed file
 #include "InlinerSizeModel.h" // NOLINT
+#endif
+#if defined(LLVM_HAVE_TF_AOT_INLINERPERFMODEL)
+// codegen-ed file
+#include "InlinerPerfModel.h" // NOLINT
+#endif
 
+#if defined(LLVM_HAVE_TF_AOT_INLINERSIZEMODEL) ||                              \
+    defined(LLVM_HAVE_TF_AOT_INLINERPERFMODEL)
 std::unique_ptr<InlineAdvisor>
 llvm::getReleaseModeAdvisor(Module &M, ModuleAnalysisManager &MAM) {
-  auto AOTRunner =
-      std::make_unique<ReleaseModeModelRunner<llvm::InlinerSizeModel>>(
-          M.getContext(), FeatureNameMap, DecisionName);
+  // Only bind the features the selected model was trained with.
+  const std::vector<std::string> ModelFeatures(FeatureNameMap.begin(),
+                                               FeatureNameMap.begin() +
+                                                   getNumberOfModelFeatures());
+  std::unique_ptr<MLModelRunner> AOTRunner;
+  if (Objective == MLInlinerObjective::Performance) {
+#if defined(LLVM_HAVE_TF_AOT_INLINERPERFMODEL)
+    AOTRunner =
+        std::make_unique<ReleaseModeModelRunner<llvm::InlinerPerfModel>>(
+            M.getContext(), ModelFeatures, DecisionName);
+#endif
+  } else {
+#if defined(LLVM_HAVE_TF_AOT_INLINERSIZEMODEL)
+    AOTRunner =
+        std::make_unique<ReleaseModeModelRunner<llvm::InlinerSizeModel>>(
+            M.getContext(), ModelFeatures, DecisionName);
+#endif
+  }
+  // The model for the requested objective was not compiled in.
+  if (!AOTRunner)
+    return nullptr;
   return std::make_unique<MLInlineAdvisor>(M, MAM, std::move(AOTRunner));
 }
 #endif
@@ -67,6 +116,9 @@ const std::array<std::string, NumberOfFeatures> llvm::FeatureNameMap{
 // Non-cost features
 #define POPULATE_NAMES(INDEX_NAME, NAME, COMMENT) NAME,
   INLINE_FEATURE_ITERATOR(POPULATE_NAMES)
+
+// Profile features - these must come last
+  INLINE_PROFILE_FEATURE_ITERATOR(POPULATE_NAMES)
 #undef POPULATE_NAMES
 };
 // clang-format on
@@ -91,6 +143,7 @@ MLInlineAdvisor::MLInlineAdvisor(Module &M, ModuleAnalysisManager &MAM,
           M, MAM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager()),
       ModelRunner(std::move(Runner)),
       CG(MAM.getResult<LazyCallGraphAnalysis>(M)),
+      PSI(MAM.getResult<ProfileSummaryAnalysis>(M)),
       InitialIRSize(getModuleIRSize()), CurrentIRSize(InitialIRSize) {
   assert(ModelRunner);
 
@@ -331,6 +384,26 @@ std::unique_ptr<InlineAdvice> MLInlineAdvisor::getAdviceImpl(CallBase &CB) {
       CalleeBefore.Uses;
   *ModelRunner->getTensor<int64_t>(FeatureIndex::CostEstimate) = CostEstimate;
 
+  if (getNumberOfModelFeatures() == NumberOfFeatures) {
+    auto &BFI = FAM.getResult<BlockFrequencyAnalysis>(Caller);
+    const uint64_t MaxFeatureValue = std::numeric_limits<int64_t>::max();
+    const uint64_t EntryFreq = BFI.getEntryFreq();
+    const uint64_t RelativeFreq =
+        EntryFreq ? SaturatingMultiply<uint64_t>(
+                        BFI.getBlockFreq(CB.getParent()).getFrequency(), 100) /
+                        EntryFreq
+                  : 0;
+    *ModelRunner->getTensor<int64_t>(FeatureIndex::CallSiteRelativeFrequency) =
+        std::min(RelativeFreq, MaxFeatureValue);
+    *ModelRunner->getTensor<int64_t>(FeatureIndex::CallSiteProfileCount) =
+        std::min(BFI.getBlockProfileCount(CB.getParent()).getValueOr(0),
+                 MaxFeatureValue);
+    *ModelRunner->getTensor<int64_t>(FeatureIndex::IsCallSiteHot) =
+        PSI.isHotCallSite(CB, &BFI);
+    *ModelRunner->getTensor<int64_t>(FeatureIndex::IsCallSiteCold) =
+        PSI.isColdCallSite(CB, &BFI);
+  }
+
   // Add the cost features
   for (size_t I = 0;
        I < static_cast<size_t>(InlineCostFeatureIndex::NumberOfFeatures); ++I) {
@@ -370,7 +443,7 @@ void MLInlineAdvice::reportContextForRemark(
     DiagnosticInfoOptimizationBase &OR) {
   using namespace ore;
   OR << NV("Callee", Callee->getName());
-  for (size_t I = 0; I < NumberOfFeatures; ++I)
+  for (size_t I = 0; I < getNumberOfModelFeatures(); ++I)
     OR << NV(FeatureNameMap[I],
              *getAdvisor()->getModelRunner().getTensor<int64_t>(I));
   OR << NV("ShouldInline", isInliningRecommended());
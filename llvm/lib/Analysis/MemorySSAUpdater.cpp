@@ -311,6 +311,25 @@ static void setMemoryPhiValueForBlock(MemoryPhi *MP, const BasicBlock *BB,
 // point to the correct new defs, to ensure we only have one variable, and no
 // disconnected stores.
 void MemorySSAUpdater::insertDef(MemoryDef *MD, bool RenameUses) {
+  SmallVector<WeakVH, 8> RenamePhis;
+  insertDefImpl(MD, RenamePhis);
+  if (RenameUses)
+    renameUsesBelow(WeakVH(MD), RenamePhis);
+}
+
+void MemorySSAUpdater::insertDefDeferringRename(MemoryDef *MD) {
+  insertDefImpl(MD, DeferredRenamePhis);
+  DeferredRenameDefs.push_back(MD);
+}
+
+void MemorySSAUpdater::renameDeferredUses() {
+  renameUsesBelow(DeferredRenameDefs, DeferredRenamePhis);
+  DeferredRenameDefs.clear();
+  DeferredRenamePhis.clear();
+}
+
+void MemorySSAUpdater::insertDefImpl(MemoryDef *MD,
+                                     SmallVectorImpl<WeakVH> &RenamePhis) {
   InsertedPHIs.clear();
 
   // See if we had a local def, and if not, go hunting.
@@ -427,34 +446,46 @@ void MemorySSAUpdater::insertDef(MemoryDef *MD, bool RenameUses) {
   if (NewPhiSize)
     tryRemoveTrivialPhis(ArrayRef<WeakVH>(&InsertedPHIs[NewPhiIndex], NewPhiSize));
 
-  // Now that all fixups are done, rename all uses if we are asked. Skip
-  // renaming for defs in unreachable blocks.
-  BasicBlock *StartBlock = MD->getBlock();
-  if (RenameUses && MSSA->getDomTree().getNode(StartBlock)) {
-    SmallPtrSet<BasicBlock *, 16> Visited;
+  // Skip renaming for defs in unreachable blocks.
+  if (!MSSA->getDomTree().getNode(MD->getBlock()))
+    return;
+  // The blocks of the phis we inserted need renaming. Existing Phi blocks may
+  // need renaming too, if an access was previously optimized and the inserted
+  // Defs "covers" the Optimized value.
+  RenamePhis.append(InsertedPHIs.begin(), InsertedPHIs.end());
+  RenamePhis.append(ExistingPhis.begin(), ExistingPhis.end());
+}
+
+void MemorySSAUpdater::renameUsesBelow(ArrayRef<WeakVH> Defs,
+                                       ArrayRef<WeakVH> Phis) {
+  // Sharing the visited set between all starting points is fine, as every
+  // starting block holds a def or phi, and renamePass picks up the incoming
+  // value from the last access of any visited block it passes through.
+  SmallPtrSet<BasicBlock *, 16> Visited;
+  for (const WeakVH &Def : Defs) {
+    MemoryDef *MD = cast_or_null<MemoryDef>(Def);
+    if (!MD)
+      continue;
+    BasicBlock *StartBlock = MD->getBlock();
+    // Skip renaming for defs in unreachable blocks.
+    if (!MSSA->getDomTree().getNode(StartBlock))
+      continue;
     // We are guaranteed there is a def in the block, because we just got it
-    // handed to us in this function.
+    // handed to us in insertDef.
     MemoryAccess *FirstDef = &*MSSA->getWritableBlockDefs(StartBlock)->begin();
     // Convert to incoming value if it's a memorydef. A phi *is* already an
     // incoming value.
-    if (auto *MD = dyn_cast<MemoryDef>(FirstDef))
-      FirstDef = MD->getDefiningAccess();
-
-    MSSA->renamePass(MD->getBlock(), FirstDef, Visited);
-    // We just inserted a phi into this block, so the incoming value will become
-    // the phi anyway, so it does not matter what we pass.
-    for (auto &MP : InsertedPHIs) {
-      MemoryPhi *Phi = dyn_cast_or_null<MemoryPhi>(MP);
-      if (Phi)
-        MSSA->renamePass(Phi->getBlock(), nullptr, Visited);
-    }
-    // Existing Phi blocks may need renaming too, if an access was previously
-    // optimized and the inserted Defs "covers" the Optimized value.
-    for (auto &MP : ExistingPhis) {
-      MemoryPhi *Phi = dyn_cast_or_null<MemoryPhi>(MP);
-      if (Phi)
-        MSSA->renamePass(Phi->getBlock(), nullptr, Visited);
-    }
+    if (auto *FirstMD = dyn_cast<MemoryDef>(FirstDef))
+      FirstDef = FirstMD->getDefiningAccess();
+
+    MSSA->renamePass(StartBlock, FirstDef, Visited);
+  }
+  // We just inserted a phi into these blocks, so the incoming value will become
+  // the phi anyway, so it does not matter what we pass.
+  for (const WeakVH &MP : Phis) {
+    MemoryPhi *Phi = dyn_cast_or_null<MemoryPhi>(MP);
+    if (Phi)
+      MSSA->renamePass(Phi->getBlock(), nullptr, Visited);
   }
 }
 
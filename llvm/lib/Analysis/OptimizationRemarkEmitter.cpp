@@ -19,6 +19,7 @@
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LLVMRemarkStreamer.h"
 #include "llvm/InitializePasses.h"
 
 using namespace llvm;
@@ -74,6 +75,22 @@ void OptimizationRemarkEmitter::computeHotness(
     OptDiag.setHotness(computeHotness(V));
 }
 
+bool OptimizationRemarkEmitter::isBelowHotnessThreshold() {
+  uint64_t Threshold = F->getContext().getDiagnosticsHotnessThreshold();
+  if (!Threshold)
+    return false;
+  // Without BFI no remark has a hotness, so they are all below the threshold.
+  if (!BFI)
+    return true;
+  if (!MaxBlockCount) {
+    uint64_t Max = 0;
+    for (const BasicBlock &BB : *F)
+      Max = std::max(Max, BFI->getBlockProfileCount(&BB).getValueOr(0));
+    MaxBlockCount = Max;
+  }
+  return *MaxBlockCount < Threshold;
+}
+
 void OptimizationRemarkEmitter::emit(
     DiagnosticInfoOptimizationBase &OptDiagBase) {
   auto &OptDiag = cast<DiagnosticInfoIROptimization>(OptDiagBase);
@@ -88,6 +105,16 @@ void OptimizationRemarkEmitter::emit(
   F->getContext().diagnose(OptDiag);
 }
 
+bool OptimizationRemarkEmitter::allowExtraAnalysis(LLVMContext &Ctx,
+                                                   StringRef PassName) {
+  // The remarks written to the optimization record are filtered by pass name
+  // too, so that a streamer alone doesn't enable every pass.
+  if (LLVMRemarkStreamer *RS = Ctx.getLLVMRemarkStreamer())
+    if (RS->matchesFilter(PassName))
+      return true;
+  return Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
+}
+
 OptimizationRemarkEmitterWrapperPass::OptimizationRemarkEmitterWrapperPass()
     : FunctionPass(ID) {
   initializeOptimizationRemarkEmitterWrapperPassPass(
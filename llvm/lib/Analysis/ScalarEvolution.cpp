@@ -145,6 +145,10 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumSCEVCacheHits, "Number of values found in the SCEV cache");
+STATISTIC(NumRangeCacheHits, "Number of ranges found in the range cache");
+STATISTIC(NumSCEVBudgetExhausted,
+          "Number of instructions not analyzed because the budget was used up");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -220,6 +224,12 @@ static cl::opt<unsigned>
                   cl::desc("Size of the expression which is considered huge"),
                   cl::init(4096));
 
+static cl::opt<unsigned> MaxAnalyzedInstructions(
+    "scalar-evolution-max-analyzed-instructions", cl::Hidden,
+    cl::desc("Maximum number of instructions analyzed per function, after "
+             "which the remaining ones are treated as unknown (0 = no limit)"),
+    cl::init(0));
+
 static cl::opt<bool>
 ClassifyExpressions("scalar-evolution-classify-expressions",
     cl::Hidden, cl::init(true),
@@ -4364,6 +4374,8 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
           !isa<GetElementPtrInst>(V))
         ExprValueMap[Stripped].insert({V, Offset});
     }
+  } else {
+    ++NumSCEVCacheHits;
   }
   return S;
 }
@@ -6246,8 +6258,10 @@ ScalarEvolution::getRangeRef(const SCEV *S,
 
   // See if we've computed this range already.
   DenseMap<const SCEV *, ConstantRange>::iterator I = Cache.find(S);
-  if (I != Cache.end())
+  if (I != Cache.end()) {
+    ++NumRangeCacheHits;
     return I->second;
+  }
 
   if (const SCEVConstant *C = dyn_cast<SCEVConstant>(S))
     return setRange(C, SignHint, ConstantRange(C->getAPInt()));
@@ -7031,6 +7045,14 @@ const SCEV *ScalarEvolution::createSCEV(Value *V) {
     // analysis depends on.
     if (!DT.isReachableFromEntry(I->getParent()))
       return getUnknown(UndefValue::get(V->getType()));
+    // Huge functions can make building expressions for all of their
+    // instructions very expensive. Once the budget is used up, treat the
+    // remaining instructions as opaque, which is correct but less precise.
+    if (MaxAnalyzedInstructions &&
+        ++NumAnalyzedInstructions > MaxAnalyzedInstructions) {
+      ++NumSCEVBudgetExhausted;
+      return getUnknown(V);
+    }
   } else if (ConstantInt *CI = dyn_cast<ConstantInt>(V))
     return getConstant(CI);
   else if (GlobalAlias *GA = dyn_cast<GlobalAlias>(V))
@@ -12723,6 +12745,7 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
     : F(Arg.F), HasGuards(Arg.HasGuards), TLI(Arg.TLI), AC(Arg.AC), DT(Arg.DT),
       LI(Arg.LI), CouldNotCompute(std::move(Arg.CouldNotCompute)),
       ValueExprMap(std::move(Arg.ValueExprMap)),
+      NumAnalyzedInstructions(Arg.NumAnalyzedInstructions),
       PendingLoopPredicates(std::move(Arg.PendingLoopPredicates)),
       PendingPhiRanges(std::move(Arg.PendingPhiRanges)),
       PendingMerges(std::move(Arg.PendingMerges)),
@@ -754,8 +754,9 @@ class ModuleSummaryIndexBitcodeReader : public BitcodeReaderBase {
   // We save a GUID which refers to the same global as the ValueInfo, but
   // ignoring the linkage, i.e. for values other than local linkage they are
   // identical.
-  DenseMap<unsigned, std::pair<ValueInfo, GlobalValue::GUID>>
-      ValueIdToValueInfoMap;
+  // Value ids are dense, so this is indexed by the id; every reference and
+  // call edge of every summary is looked up here.
+  std::vector<std::pair<ValueInfo, GlobalValue::GUID>> ValueIdToValueInfoMap;
 
   /// Map populated during module path string table parsing, from the
   /// module ID to a string reference owned by the index's module
@@ -788,6 +789,8 @@ private:
   Error parseValueSymbolTable(
       uint64_t Offset,
       DenseMap<unsigned, GlobalValue::LinkageTypes> &ValueIdToLinkageMap);
+  Error setValueInfo(uint64_t ValueID, ValueInfo VI,
+                     GlobalValue::GUID OriginalNameID);
   std::vector<ValueInfo> makeRefList(ArrayRef<uint64_t> Record);
   std::vector<FunctionSummary::EdgeTy> makeCallList(ArrayRef<uint64_t> Record,
                                                     bool IsOldProfileFormat,
@@ -5663,14 +5666,19 @@ Error BitcodeReader::materialize(GlobalValue *GV) {
       }
     }
 
-    // Remove incompatible attributes on function calls.
-    if (auto *CI = dyn_cast<CallBase>(&I)) {
-      CI->removeRetAttrs(AttributeFuncs::typeIncompatible(
-          CI->getFunctionType()->getReturnType()));
+    // Remove incompatible attributes on function calls. Most operands have no
+    // attributes at all, so don't build the incompatible set for them.
+    auto *CI = dyn_cast<CallBase>(&I);
+    if (CI && !CI->getAttributes().isEmpty()) {
+      if (CI->getAttributes().hasRetAttrs())
+        CI->removeRetAttrs(AttributeFuncs::typeIncompatible(
+            CI->getFunctionType()->getReturnType()));
 
       for (unsigned ArgNo = 0; ArgNo < CI->arg_size(); ++ArgNo)
-        CI->removeParamAttrs(ArgNo, AttributeFuncs::typeIncompatible(
-                                        CI->getArgOperand(ArgNo)->getType()));
+        if (CI->getAttributes().hasParamAttrs(ArgNo))
+          CI->removeParamAttrs(ArgNo,
+                               AttributeFuncs::typeIncompatible(
+                                   CI->getArgOperand(ArgNo)->getType()));
     }
   }
 
@@ -5760,9 +5768,24 @@ ModuleSummaryIndexBitcodeReader::getThisModule() {
 
 std::pair<ValueInfo, GlobalValue::GUID>
 ModuleSummaryIndexBitcodeReader::getValueInfoFromValueId(unsigned ValueId) {
-  auto VGI = ValueIdToValueInfoMap[ValueId];
-  assert(VGI.first);
-  return VGI;
+  assert(ValueId < ValueIdToValueInfoMap.size() &&
+         ValueIdToValueInfoMap[ValueId].first && "Unknown value id");
+  if (ValueId >= ValueIdToValueInfoMap.size())
+    return {};
+  return ValueIdToValueInfoMap[ValueId];
+}
+
+Error ModuleSummaryIndexBitcodeReader::setValueInfo(
+    uint64_t ValueID, ValueInfo VI, GlobalValue::GUID OriginalNameID) {
+  if (ValueID >= ValueIdToValueInfoMap.size()) {
+    // Every value id is introduced by a record in the stream, so a larger id
+    // can only come from a malformed file.
+    if (ValueID >= Stream.SizeInBytes() * 8)
+      return error("Invalid value id");
+    ValueIdToValueInfoMap.resize(ValueID + 1);
+  }
+  ValueIdToValueInfoMap[ValueID] = std::make_pair(VI, OriginalNameID);
+  return Error::success();
 }
 
 void ModuleSummaryIndexBitcodeReader::setValueGUID(
@@ -5778,6 +5801,9 @@ void ModuleSummaryIndexBitcodeReader::setValueGUID(
     dbgs() << "GUID " << ValueGUID << "(" << OriginalNameID << ") is "
            << ValueName << "\n";
 
+  if (ValueID >= ValueIdToValueInfoMap.size())
+    ValueIdToValueInfoMap.resize(ValueID + 1);
+
   // UseStrtab is false for legacy summary formats and value names are
   // created on stack. In that case we save the name in a string saver in
   // the index so that the value name can be recorded.
@@ -5873,8 +5899,9 @@ Error ModuleSummaryIndexBitcodeReader::parseValueSymbolTable(
       GlobalValue::GUID RefGUID = Record[1];
       // The "original name", which is the second value of the pair will be
       // overriden later by a FS_COMBINED_ORIGINAL_NAME in the combined index.
-      ValueIdToValueInfoMap[ValueID] =
-          std::make_pair(TheIndex.getOrInsertValueInfo(RefGUID), RefGUID);
+      if (Error Err = setValueInfo(
+              ValueID, TheIndex.getOrInsertValueInfo(RefGUID), RefGUID))
+        return Err;
       break;
     }
     }
@@ -6257,8 +6284,9 @@ Error ModuleSummaryIndexBitcodeReader::parseEntireSummary(unsigned ID) {
     case bitc::FS_VALUE_GUID: { // [valueid, refguid]
       uint64_t ValueID = Record[0];
       GlobalValue::GUID RefGUID = Record[1];
-      ValueIdToValueInfoMap[ValueID] =
-          std::make_pair(TheIndex.getOrInsertValueInfo(RefGUID), RefGUID);
+      if (Error Err = setValueInfo(
+              ValueID, TheIndex.getOrInsertValueInfo(RefGUID), RefGUID))
+        return Err;
       break;
     }
     // FS_PERMODULE: [valueid, flags, instcount, fflags, numrefs,
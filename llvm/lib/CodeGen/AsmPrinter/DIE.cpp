@@ -143,11 +143,25 @@ DIEAbbrevSet::~DIEAbbrevSet() {
     Abbrev->~DIEAbbrev();
 }
 
-DIEAbbrev &DIEAbbrevSet::uniqueAbbreviation(DIE &Die) {
+/// Profile the abbreviation \p Die would get, exactly like
+/// DIEAbbrev::Profile on the result of DIE::generateAbbrev but without
+/// materializing the DIEAbbrev.
+static void profileAbbrev(const DIE &Die, FoldingSetNodeID &ID) {
+  ID.AddInteger(unsigned(Die.getTag()));
+  ID.AddInteger(unsigned(Die.hasChildren()));
+  for (const DIEValue &V : Die.values()) {
+    ID.AddInteger(unsigned(V.getAttribute()));
+    ID.AddInteger(unsigned(V.getForm()));
+    if (V.getForm() == dwarf::DW_FORM_implicit_const)
+      ID.AddInteger(int64_t(V.getDIEInteger().getValue()));
+  }
+}
 
+DIEAbbrev &DIEAbbrevSet::uniqueAbbreviation(DIE &Die) {
+  // Nearly every DIE reuses an existing abbreviation, so only build one for
+  // lookups that miss.
   FoldingSetNodeID ID;
-  DIEAbbrev Abbrev = Die.generateAbbrev();
-  Abbrev.Profile(ID);
+  profileAbbrev(Die, ID);
 
   void *InsertPos;
   if (DIEAbbrev *Existing =
@@ -157,7 +171,7 @@ DIEAbbrev &DIEAbbrevSet::uniqueAbbreviation(DIE &Die) {
   }
 
   // Move the abbreviation to the heap and assign a number.
-  DIEAbbrev *New = new (Alloc) DIEAbbrev(std::move(Abbrev));
+  DIEAbbrev *New = new (Alloc) DIEAbbrev(Die.generateAbbrev());
   Abbreviations.push_back(New);
   New->setNumber(Abbreviations.size());
   Die.setAbbrevNumber(Abbreviations.size());
@@ -13,6 +13,7 @@
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/CodeGen/GlobalISel/GISelChangeObserver.h"
 #include "llvm/CodeGen/GlobalISel/GISelKnownBits.h"
 #include "llvm/CodeGen/GlobalISel/GenericMachineInstrs.h"
@@ -34,6 +35,12 @@
 
 #define DEBUG_TYPE "globalisel-utils"
 
+STATISTIC(NumLegalizerFailures, "Number of GlobalISel legalizer failures");
+STATISTIC(NumRegBankSelectFailures,
+          "Number of GlobalISel register bank selection failures");
+STATISTIC(NumInstructionSelectFailures,
+          "Number of GlobalISel instruction selection failures");
+
 using namespace llvm;
 using namespace MIPatternMatch;
 
@@ -261,6 +268,16 @@ void llvm::reportGISelFailure(MachineFunction &MF, const TargetPassConfig &TPC,
                               MachineOptimizationRemarkEmitter &MORE,
                               MachineOptimizationRemarkMissed &R) {
   MF.getProperties().set(MachineFunctionProperties::Property::FailedISel);
+
+  // Record which stage gave up, so that -stats shows where the fallbacks to
+  // SelectionDAG come from.
+  StringRef PassName = R.getPassName();
+  if (PassName == "legalizer")
+    ++NumLegalizerFailures;
+  else if (PassName == "regbankselect")
+    ++NumRegBankSelectFailures;
+  else if (PassName == "instruction-select")
+    ++NumInstructionSelectFailures;
   reportGISelDiagnostic(DS_Error, MF, TPC, MORE, R);
 }
 
@@ -134,8 +134,12 @@ LiveIntervalUnion::Query::collectInterferingVRegs(unsigned MaxInterferingRegs) {
   if (!CheckedFirstInterference) {
     CheckedFirstInterference = true;
 
-    // Quickly skip interference check for empty sets.
-    if (LR->empty() || LiveUnion->empty()) {
+    // Quickly skip interference check for empty sets, and for sets whose
+    // extents are disjoint. Both extents are available without walking the
+    // segments, which makes this cheap even for huge unions.
+    if (LR->empty() || LiveUnion->empty() ||
+        LR->endIndex() <= LiveUnion->startIndex() ||
+        LiveUnion->endIndex() <= LR->beginIndex()) {
       SeenAllInterferences = true;
       return 0;
     }
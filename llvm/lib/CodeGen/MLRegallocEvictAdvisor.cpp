@@ -60,9 +60,15 @@ static cl::opt<std::string> ModelUnderTraining(
 
 #endif // #ifdef LLVM_HAVE_TF_API
 
+static cl::opt<bool> ReportScore(
+    "regalloc-report-score", cl::Hidden,
+    cl::desc("Print the register allocation score of each function, to "
+             "compare eviction advisors on the same input"));
+
 /// The score injection pass.
-/// This pass calculates the score for a function and inserts it in the log, but
-/// this happens only in development mode. It's a no-op otherwise.
+/// This pass calculates the score for a function and inserts it in the log in
+/// development mode, and prints it with -regalloc-report-score in any mode.
+/// It's a no-op otherwise.
 namespace llvm {
 class RegAllocScoring : public MachineFunctionPass {
 public:
@@ -871,18 +877,6 @@ int64_t DevelopmentModeEvictAdvisor::tryFindEvictionCandidatePosition(
   return Ret;
 }
 
-bool RegAllocScoring::runOnMachineFunction(MachineFunction &MF) {
-  if (auto *DevModeAnalysis = dyn_cast<DevelopmentModeEvictionAdvisorAnalysis>(
-          &getAnalysis<RegAllocEvictionAdvisorAnalysis>()))
-    if (auto *Log = DevModeAnalysis->getLogger(MF))
-      Log->logFloatFinalReward(static_cast<float>(
-          calculateRegAllocScore(
-              MF, getAnalysis<MachineBlockFrequencyInfo>(),
-              getAnalysis<AAResultsWrapperPass>().getAAResults())
-              .getScore()));
-
-  return false;
-}
 #endif // #ifdef LLVM_HAVE_TF_API
 
 #if defined(LLVM_HAVE_TF_AOT_REGALLOCEVICTMODEL)
@@ -891,7 +885,31 @@ RegAllocEvictionAdvisorAnalysis *llvm::createReleaseModeAdvisor() {
 }
 #endif
 
-// In all cases except development mode, we don't need scoring.
-#if !defined(LLVM_HAVE_TF_API)
-bool RegAllocScoring::runOnMachineFunction(MachineFunction &) { return false; }
-#endif
+bool RegAllocScoring::runOnMachineFunction(MachineFunction &MF) {
+  Optional<RegAllocScore> Score;
+  auto GetScore = [&]() -> const RegAllocScore & {
+    if (!Score)
+      Score = calculateRegAllocScore(
+          MF, getAnalysis<MachineBlockFrequencyInfo>(),
+          getAnalysis<AAResultsWrapperPass>().getAAResults());
+    return *Score;
+  };
+
+#ifdef LLVM_HAVE_TF_API
+  if (auto *DevModeAnalysis = dyn_cast<DevelopmentModeEvictionAdvisorAnalysis>(
+          &getAnalysis<RegAllocEvictionAdvisorAnalysis>()))
+    if (auto *Log = DevModeAnalysis->getLogger(MF))
+      Log->logFloatFinalReward(static_cast<float>(GetScore().getScore()));
+#endif // #ifdef LLVM_HAVE_TF_API
+
+  if (ReportScore) {
+    const RegAllocScore &S = GetScore();
+    errs() << "regalloc-score: " << MF.getName() << " score=" << S.getScore()
+           << " copies=" << S.copyCounts() << " loads=" << S.loadCounts()
+           << " stores=" << S.storeCounts()
+           << " loadstores=" << S.loadStoreCounts()
+           << " cheap-remats=" << S.cheapRematCounts()
+           << " expensive-remats=" << S.expensiveRematCounts() << "\n";
+  }
+  return false;
+}
@@ -40,6 +40,14 @@
 
 using namespace llvm;
 
+#define DEBUG_TYPE "machine-function-splitter"
+
+STATISTIC(NumFunctionsSplit, "Number of functions split");
+STATISTIC(NumColdBlocksSplit,
+          "Number of cold blocks moved to the split section");
+STATISTIC(NumColdInstrsSplit,
+          "Number of instructions moved to the split section");
+
 // FIXME: This cutoff value is CPU dependent and should be moved to
 // TargetTransformInfo once we consider enabling this on other platforms.
 // The value is expressed as a ProfileSummaryInfo integer percentile cutoff.
@@ -145,6 +153,17 @@ bool MachineFunctionSplitter::runOnMachineFunction(MachineFunction &MF) {
       LP->setSectionID(MBBSectionID::ColdSectionID);
   }
 
+  bool HasColdBlocks = false;
+  for (const MachineBasicBlock &MBB : MF) {
+    if (MBB.getSectionID() != MBBSectionID::ColdSectionID)
+      continue;
+    HasColdBlocks = true;
+    ++NumColdBlocksSplit;
+    NumColdInstrsSplit += MBB.size();
+  }
+  if (HasColdBlocks)
+    ++NumFunctionsSplit;
+
   auto Comparator = [](const MachineBasicBlock &X, const MachineBasicBlock &Y) {
     return X.getSectionID().Type < Y.getSectionID().Type;
   };
@@ -143,6 +143,21 @@ static cl::opt<unsigned>
                          cl::desc("The threshold for fast cluster"),
                          cl::init(1000));
 
+static cl::opt<bool> ForceResourceBalance(
+    "misched-resource-balance", cl::Hidden,
+    cl::desc("Balance processor resource usage in all small regions"),
+    cl::init(false));
+static cl::opt<bool> HotResourceBalance(
+    "misched-resource-balance-hot", cl::Hidden,
+    cl::desc("Balance processor resource usage in small regions of functions "
+             "that the profile marks hot"),
+    cl::init(false));
+static cl::opt<unsigned> ResourceBalanceMaxRegion(
+    "misched-resource-balance-max-region", cl::Hidden,
+    cl::desc("Only balance processor resources in regions of at most this "
+             "many instructions"),
+    cl::init(64));
+
 // DAG subtrees must have at least this many nodes.
 static const unsigned MinSubtreeSize = 8;
 
@@ -2955,6 +2970,16 @@ void GenericScheduler::initPolicy(MachineBasicBlock::iterator Begin,
   // compile-time optimizations have been implemented in that direction.
   RegionPolicy.OnlyBottomUp = true;
 
+  // Resource balancing is meant for the small regions of hot loops, where port
+  // contention matters most and the extra heuristics are cheap. Functions can
+  // ask for it with the "misched-resource-balance" attribute.
+  const Function &F = MF.getFunction();
+  RegionPolicy.BalanceResources =
+      MF.getSubtarget().getSchedModel().hasInstrSchedModel() &&
+      NumRegionInstrs <= ResourceBalanceMaxRegion &&
+      (ForceResourceBalance || F.hasFnAttribute("misched-resource-balance") ||
+       (HotResourceBalance && F.getSectionPrefix() == StringRef("hot")));
+
   // Allow the subtarget to override default policy.
   MF.getSubtarget().overrideSchedPolicy(RegionPolicy, NumRegionInstrs);
 
@@ -2987,6 +3012,7 @@ void GenericScheduler::dumpPolicy() const {
          << " ShouldTrackPressure=" << RegionPolicy.ShouldTrackPressure
          << " OnlyTopDown=" << RegionPolicy.OnlyTopDown
          << " OnlyBottomUp=" << RegionPolicy.OnlyBottomUp
+         << " BalanceResources=" << RegionPolicy.BalanceResources
          << "\n";
 #endif
 }
@@ -3408,9 +3434,11 @@ SUnit *GenericScheduler::pickNode(bool &IsTopNode) {
     if (RegionPolicy.OnlyTopDown) {
       SU = Top.pickOnlyChoice();
       if (!SU) {
-        CandPolicy NoPolicy;
-        TopCand.reset(NoPolicy);
-        pickNodeFromQueue(Top, NoPolicy, DAG->getTopRPTracker(), TopCand);
+        CandPolicy Policy;
+        if (RegionPolicy.BalanceResources)
+          setPolicy(Policy, /*IsPostRA=*/false, Top, nullptr);
+        TopCand.reset(Policy);
+        pickNodeFromQueue(Top, Policy, DAG->getTopRPTracker(), TopCand);
         assert(TopCand.Reason != NoCand && "failed to find a candidate");
         tracePick(TopCand);
         SU = TopCand.SU;
@@ -3419,9 +3447,11 @@ SUnit *GenericScheduler::pickNode(bool &IsTopNode) {
     } else if (RegionPolicy.OnlyBottomUp) {
       SU = Bot.pickOnlyChoice();
       if (!SU) {
-        CandPolicy NoPolicy;
-        BotCand.reset(NoPolicy);
-        pickNodeFromQueue(Bot, NoPolicy, DAG->getBotRPTracker(), BotCand);
+        CandPolicy Policy;
+        if (RegionPolicy.BalanceResources)
+          setPolicy(Policy, /*IsPostRA=*/false, Bot, nullptr);
+        BotCand.reset(Policy);
+        pickNodeFromQueue(Bot, Policy, DAG->getBotRPTracker(), BotCand);
         assert(BotCand.Reason != NoCand && "failed to find a candidate");
         tracePick(BotCand);
         SU = BotCand.SU;
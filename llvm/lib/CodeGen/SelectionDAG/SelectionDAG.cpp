@@ -106,6 +106,10 @@ static cl::opt<int> MaxLdStGlue("ldstmemcpy-glue-max",
        cl::desc("Number limit for gluing ld/st of memcpy."),
        cl::Hidden, cl::init(0));
 
+/// The number of bytes of operand arrays that SelectionDAG::clear() keeps
+/// around for reuse by the next DAG.
+static constexpr size_t MaxRetainedOperandBytes = 1 << 20;
+
 static void NewSDValueDbgMsg(SDValue V, StringRef Msg, SelectionDAG *G) {
   LLVM_DEBUG(dbgs() << Msg; V.getNode()->dump(G););
 }
@@ -1288,8 +1292,15 @@ SDNode *SelectionDAG::FindNodeOrInsertPos(const FoldingSetNodeID &ID,
 
 void SelectionDAG::clear() {
   allnodes_clear();
-  OperandRecycler.clear(OperandAllocator);
-  OperandAllocator.Reset();
+  // Deleting the nodes handed their operand arrays back to OperandRecycler,
+  // so keep them for the next block rather than freeing the slabs and
+  // allocating them again. Only start over once the allocator has grown large,
+  // as some allocations, e.g. shuffle masks, are never recycled.
+  if (OperandAllocator.getBytesAllocated() > MaxRetainedOperandBytes) {
+    OperandRecycler.clear(OperandAllocator);
+    OperandAllocator.Reset();
+  }
+  // The CSE map keeps its buckets, so it is not rehashed as it refills.
   CSEMap.clear();
 
   ExtendedValueTypeNodes.clear();
@@ -135,6 +135,12 @@ static cl::opt<bool> EnableFastISelFallbackReport(
     cl::desc("Emit a diagnostic when \"fast\" instruction selection "
              "falls back to SelectionDAG."));
 
+static cl::opt<bool> TimeDAGPhases(
+    "time-sdag-phases", cl::Hidden,
+    cl::desc("Time the phases of SelectionDAG instruction selection, from "
+             "building the DAG to emitting it, without timing every pass as "
+             "-time-passes does"));
+
 static cl::opt<bool>
 UseMBPI("use-mbpi",
         cl::desc("use Machine Branch Probability Info"),
@@ -717,18 +723,24 @@ void SelectionDAGISel::SelectBasicBlock(BasicBlock::const_iterator Begin,
   // Allow creating illegal types during DAG building for the basic block.
   CurDAG->NewNodesMustHaveLegalTypes = false;
 
-  // Lower the instructions. If a call is emitted as a tail call, cease emitting
-  // nodes for this block.
-  for (BasicBlock::const_iterator I = Begin; I != End && !SDB->HasTailCall; ++I) {
-    if (!ElidedArgCopyInstrs.count(&*I))
-      SDB->visit(*I);
-  }
+  {
+    NamedRegionTimer T("build", "DAG Building", "sdag",
+                       "Instruction Selection and Scheduling",
+                       TimePassesIsEnabled || TimeDAGPhases);
+    // Lower the instructions. If a call is emitted as a tail call, cease
+    // emitting nodes for this block.
+    for (BasicBlock::const_iterator I = Begin; I != End && !SDB->HasTailCall;
+         ++I) {
+      if (!ElidedArgCopyInstrs.count(&*I))
+        SDB->visit(*I);
+    }
 
-  // Make sure the root of the DAG is up-to-date.
-  CurDAG->setRoot(SDB->getControlRoot());
-  HadTailCall = SDB->HasTailCall;
-  SDB->resolveOrClearDbgInfo();
-  SDB->clear();
+    // Make sure the root of the DAG is up-to-date.
+    CurDAG->setRoot(SDB->getControlRoot());
+    HadTailCall = SDB->HasTailCall;
+    SDB->resolveOrClearDbgInfo();
+    SDB->clear();
+  }
 
   // Final step, emit the lowered DAG as machine code.
   CodeGenAndEmitDAG();
@@ -774,6 +786,7 @@ void SelectionDAGISel::ComputeLiveOutVRegInfo() {
 void SelectionDAGISel::CodeGenAndEmitDAG() {
   StringRef GroupName = "sdag";
   StringRef GroupDescription = "Instruction Selection and Scheduling";
+  const bool TimePhases = TimePassesIsEnabled || TimeDAGPhases;
   std::string BlockName;
   bool MatchFilterBB = false; (void)MatchFilterBB;
 #ifndef NDEBUG
@@ -814,7 +827,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // Run the DAG combiner in pre-legalize mode.
   {
     NamedRegionTimer T("combine1", "DAG Combining 1", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     CurDAG->Combine(BeforeLegalizeTypes, AA, OptLevel);
   }
 
@@ -836,7 +849,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   bool Changed;
   {
     NamedRegionTimer T("legalize_types", "Type Legalization", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     Changed = CurDAG->LegalizeTypes();
   }
 
@@ -860,7 +873,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     // Run the DAG combiner in post-type-legalize mode.
     {
       NamedRegionTimer T("combine_lt", "DAG Combining after legalize types",
-                         GroupName, GroupDescription, TimePassesIsEnabled);
+                         GroupName, GroupDescription, TimePhases);
       CurDAG->Combine(AfterLegalizeTypes, AA, OptLevel);
     }
 
@@ -877,7 +890,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
   {
     NamedRegionTimer T("legalize_vec", "Vector Legalization", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     Changed = CurDAG->LegalizeVectors();
   }
 
@@ -894,7 +907,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
     {
       NamedRegionTimer T("legalize_types2", "Type Legalization 2", GroupName,
-                         GroupDescription, TimePassesIsEnabled);
+                         GroupDescription, TimePhases);
       CurDAG->LegalizeTypes();
     }
 
@@ -914,7 +927,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     // Run the DAG combiner in post-type-legalize mode.
     {
       NamedRegionTimer T("combine_lv", "DAG Combining after legalize vectors",
-                         GroupName, GroupDescription, TimePassesIsEnabled);
+                         GroupName, GroupDescription, TimePhases);
       CurDAG->Combine(AfterLegalizeVectorOps, AA, OptLevel);
     }
 
@@ -934,7 +947,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
   {
     NamedRegionTimer T("legalize", "DAG Legalization", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     CurDAG->Legalize();
   }
 
@@ -954,7 +967,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // Run the DAG combiner in post-legalize mode.
   {
     NamedRegionTimer T("combine2", "DAG Combining 2", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     CurDAG->Combine(AfterLegalizeDAG, AA, OptLevel);
   }
 
@@ -978,7 +991,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // code to the MachineBasicBlock.
   {
     NamedRegionTimer T("isel", "Instruction Selection", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     DoInstructionSelection();
   }
 
@@ -994,7 +1007,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   ScheduleDAGSDNodes *Scheduler = CreateScheduler();
   {
     NamedRegionTimer T("sched", "Instruction Scheduling", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     Scheduler->Run(CurDAG, FuncInfo->MBB);
   }
 
@@ -1006,7 +1019,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   MachineBasicBlock *FirstMBB = FuncInfo->MBB, *LastMBB;
   {
     NamedRegionTimer T("emit", "Instruction Creation", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
 
     // FuncInfo->InsertPt is passed by reference and set to the end of the
     // scheduled instructions.
@@ -1021,7 +1034,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // Free the scheduler state.
   {
     NamedRegionTimer T("cleanup", "Instruction Scheduling Cleanup", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+                       GroupDescription, TimePhases);
     delete Scheduler;
   }
 
@@ -1400,7 +1400,7 @@ bool TargetPassConfig::addRegAssignAndRewriteOptimized() {
   addPass(&VirtRegRewriterID);
 
   // Regalloc scoring for ML-driven eviction - noop except when learning a new
-  // eviction policy.
+  // eviction policy or reporting scores with -regalloc-report-score.
   addPass(createRegAllocScoringPass());
   return true;
 }
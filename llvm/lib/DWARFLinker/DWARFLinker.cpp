@@ -2349,6 +2349,24 @@ bool DWARFLinker::link() {
       Options.TheAccelTableKind = AccelTableKind::Apple;
   }
 
+  // Extracting the DIEs of an object only touches that object's DWARFContext,
+  // so when threads are available do it for all objects up front. The loop
+  // below then finds the DIEs of every unit already extracted.
+  if (Options.Threads != 1) {
+    ThreadPool Pool(hardware_concurrency(Options.Threads));
+    for (LinkContext &OptContext : ObjectContexts) {
+      if (!OptContext.File.Dwarf ||
+          (LLVM_LIKELY(!Options.Update) &&
+           !OptContext.File.Addresses->hasValidRelocs()))
+        continue;
+      Pool.async([&OptContext]() {
+        for (const auto &CU : OptContext.File.Dwarf->compile_units())
+          CU->getUnitDIE(/*ExtractUnitDIEOnly=*/false);
+      });
+    }
+    Pool.wait();
+  }
+
   for (LinkContext &OptContext : ObjectContexts) {
     if (Options.Verbose) {
       if (DwarfLinkerClientID == DwarfLinkerClient::Dsymutil)
@@ -15,7 +15,9 @@
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCObjectFileInfo.h"
 #include "llvm/MC/MCTargetOptionsCommandFlags.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/Object/Decompressor.h"
+#include "llvm/Support/ThreadPool.h"
 
 using namespace llvm;
 using namespace llvm::object;
@@ -464,43 +466,23 @@ Error buildDuplicateError(const std::pair<uint64_t, UnitIndexEntry> &PrevE,
       " and " + buildDWODescription(ID.Name, DWPName, ID.DWOName));
 }
 
-Error handleSection(
+/// Handle the section called \p Name with the (uncompressed) \p Contents.
+static void handleSectionContents(
     const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
     const MCSection *StrSection, const MCSection *StrOffsetSection,
     const MCSection *TypesSection, const MCSection *CUIndexSection,
     const MCSection *TUIndexSection, const MCSection *InfoSection,
-    const SectionRef &Section, MCStreamer &Out,
-    std::deque<SmallString<32>> &UncompressedSections,
-    uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
+    StringRef Name, StringRef Contents, MCStreamer &Out,
     StringRef &CurStrSection, StringRef &CurStrOffsetSection,
     std::vector<StringRef> &CurTypesSection,
     std::vector<StringRef> &CurInfoSection, StringRef &AbbrevSection,
     StringRef &CurCUIndexSection, StringRef &CurTUIndexSection,
     std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength) {
-  if (Section.isBSS())
-    return Error::success();
-
-  if (Section.isVirtual())
-    return Error::success();
-
-  Expected<StringRef> NameOrErr = Section.getName();
-  if (!NameOrErr)
-    return NameOrErr.takeError();
-  StringRef Name = *NameOrErr;
-
-  Expected<StringRef> ContentsOrErr = Section.getContents();
-  if (!ContentsOrErr)
-    return ContentsOrErr.takeError();
-  StringRef Contents = *ContentsOrErr;
-
-  if (auto Err = handleCompressedSection(UncompressedSections, Name, Contents))
-    return Err;
-
   Name = Name.substr(Name.find_first_not_of("._"));
 
   auto SectionPair = KnownSections.find(Name);
   if (SectionPair == KnownSections.end())
-    return Error::success();
+    return;
 
   if (DWARFSectionKind Kind = SectionPair->second.second) {
     if (Kind != DW_SECT_EXT_TYPES && Kind != DW_SECT_INFO) {
@@ -529,10 +511,93 @@ Error handleSection(
     Out.SwitchSection(OutSection);
     Out.emitBytes(Contents);
   }
+}
+
+Error handleSection(
+    const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
+    const MCSection *StrSection, const MCSection *StrOffsetSection,
+    const MCSection *TypesSection, const MCSection *CUIndexSection,
+    const MCSection *TUIndexSection, const MCSection *InfoSection,
+    const SectionRef &Section, MCStreamer &Out,
+    std::deque<SmallString<32>> &UncompressedSections,
+    uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
+    StringRef &CurStrSection, StringRef &CurStrOffsetSection,
+    std::vector<StringRef> &CurTypesSection,
+    std::vector<StringRef> &CurInfoSection, StringRef &AbbrevSection,
+    StringRef &CurCUIndexSection, StringRef &CurTUIndexSection,
+    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength) {
+  if (Section.isBSS())
+    return Error::success();
+
+  if (Section.isVirtual())
+    return Error::success();
+
+  Expected<StringRef> NameOrErr = Section.getName();
+  if (!NameOrErr)
+    return NameOrErr.takeError();
+  StringRef Name = *NameOrErr;
+
+  Expected<StringRef> ContentsOrErr = Section.getContents();
+  if (!ContentsOrErr)
+    return ContentsOrErr.takeError();
+  StringRef Contents = *ContentsOrErr;
+
+  if (auto Err = handleCompressedSection(UncompressedSections, Name, Contents))
+    return Err;
+
+  handleSectionContents(KnownSections, StrSection, StrOffsetSection,
+                        TypesSection, CUIndexSection, TUIndexSection,
+                        InfoSection, Name, Contents, Out, CurStrSection,
+                        CurStrOffsetSection, CurTypesSection, CurInfoSection,
+                        AbbrevSection, CurCUIndexSection, CurTUIndexSection,
+                        SectionLength);
   return Error::success();
 }
+} // namespace llvm
+
+namespace {
+/// An input file whose sections have been read and decompressed.
+struct LoadedInput {
+  OwningBinary<ObjectFile> Obj;
+  std::deque<SmallString<32>> UncompressedSections;
+  /// The names and contents of the sections that occupy space in the file.
+  std::vector<std::pair<StringRef, StringRef>> Sections;
+};
+} // end anonymous namespace
+
+static Expected<std::unique_ptr<LoadedInput>> loadInput(StringRef Input) {
+  auto ErrOrObj = ObjectFile::createObjectFile(Input);
+  if (!ErrOrObj)
+    return ErrOrObj.takeError();
+
+  auto Loaded = std::make_unique<LoadedInput>();
+  Loaded->Obj = std::move(*ErrOrObj);
+  for (const auto &Section : Loaded->Obj.getBinary()->sections()) {
+    if (Section.isBSS() || Section.isVirtual())
+      continue;
+
+    Expected<StringRef> NameOrErr = Section.getName();
+    if (!NameOrErr)
+      return NameOrErr.takeError();
+    StringRef Name = *NameOrErr;
+
+    Expected<StringRef> ContentsOrErr = Section.getContents();
+    if (!ContentsOrErr)
+      return ContentsOrErr.takeError();
+    StringRef Contents = *ContentsOrErr;
+
+    if (auto Err = handleCompressedSection(Loaded->UncompressedSections, Name,
+                                           Contents))
+      return std::move(Err);
+
+    Loaded->Sections.emplace_back(Name, Contents);
+  }
+  return std::move(Loaded);
+}
 
-Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
+namespace llvm {
+Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
+            ThreadPoolStrategy S) {
   const auto &MCOFI = *Out.getContext().getObjectFileInfo();
   MCSection *const StrSection = MCOFI.getDwarfStrDWOSection();
   MCSection *const StrOffsetSection = MCOFI.getDwarfStrOffDWOSection();
@@ -565,18 +630,46 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
 
   DWPStringPool Strings(Out, StrSection);
 
-  SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
-  Objects.reserve(Inputs.size());
-
-  std::deque<SmallString<32>> UncompressedSections;
-
-  for (const auto &Input : Inputs) {
-    auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
-    if (!ErrOrObj)
-      return ErrOrObj.takeError();
+  // With several threads, the inputs following the current one are loaded in
+  // the background. Only a few inputs are held at a time, and each is
+  // released once it has been merged: everything that outlives an input is
+  // copied out of it.
+  std::vector<Optional<Expected<std::unique_ptr<LoadedInput>>>> Loaded(
+      Inputs.size());
+  std::vector<std::shared_future<void>> Loading;
+  std::unique_ptr<ThreadPool> Pool;
+  unsigned NumThreads = S.compute_thread_count();
+  if (NumThreads > 1 && Inputs.size() > 1)
+    Pool = std::make_unique<ThreadPool>(S);
+  const size_t LoadAhead = 2 * NumThreads;
+  auto WaitForLoads = make_scope_exit([&] {
+    if (Pool)
+      Pool->wait();
+    for (auto &LoadedOrErr : Loaded)
+      if (LoadedOrErr)
+        consumeError(LoadedOrErr->takeError());
+  });
+
+  for (size_t InputIndex = 0, NumInputs = Inputs.size();
+       InputIndex != NumInputs; ++InputIndex) {
+    const auto &Input = Inputs[InputIndex];
+    if (Pool) {
+      for (size_t I = Loading.size();
+           I != NumInputs && I <= InputIndex + LoadAhead; ++I)
+        Loading.push_back(
+            Pool->async([&, I] { Loaded[I].emplace(loadInput(Inputs[I])); }));
+      Loading[InputIndex].wait();
+    } else {
+      Loaded[InputIndex].emplace(loadInput(Input));
+    }
 
-    auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+    Expected<std::unique_ptr<LoadedInput>> LoadedOrErr =
+        std::move(*Loaded[InputIndex]);
+    Loaded[InputIndex].reset();
+    if (!LoadedOrErr)
+      return LoadedOrErr.takeError();
+    std::unique_ptr<LoadedInput> CurInput = std::move(*LoadedOrErr);
+    auto &Obj = *CurInput->Obj.getBinary();
 
     UnitIndexEntry CurEntry = {};
 
@@ -593,15 +686,14 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
     // i.e. offset and length, of each compile/type unit to a section.
     std::vector<std::pair<DWARFSectionKind, uint32_t>> SectionLength;
 
-    for (const auto &Section : Obj.sections())
-      if (auto Err = handleSection(
-              KnownSections, StrSection, StrOffsetSection, TypesSection,
-              CUIndexSection, TUIndexSection, InfoSection, Section, Out,
-              UncompressedSections, ContributionOffsets, CurEntry,
-              CurStrSection, CurStrOffsetSection, CurTypesSection,
-              CurInfoSection, AbbrevSection, CurCUIndexSection,
-              CurTUIndexSection, SectionLength))
-        return Err;
+    for (const auto &Section : CurInput->Sections)
+      handleSectionContents(KnownSections, StrSection, StrOffsetSection,
+                            TypesSection, CUIndexSection, TUIndexSection,
+                            InfoSection, Section.first, Section.second, Out,
+                            CurStrSection, CurStrOffsetSection,
+                            CurTypesSection, CurInfoSection, AbbrevSection,
+                            CurCUIndexSection, CurTUIndexSection,
+                            SectionLength);
 
     if (CurInfoSection.empty())
       continue;
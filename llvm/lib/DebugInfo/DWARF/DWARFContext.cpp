@@ -1024,10 +1024,47 @@ DWARFCompileUnit *DWARFContext::getCompileUnitForOffset(uint64_t Offset) {
 }
 
 DWARFCompileUnit *DWARFContext::getCompileUnitForAddress(uint64_t Address) {
-  // First, get the offset of the compile unit.
-  uint64_t CUOffset = getDebugAranges()->findAddress(Address);
-  // Retrieve the compile unit.
-  return getCompileUnitForOffset(CUOffset);
+  if (!MaxAddressLookupUnits) {
+    // First, get the offset of the compile unit.
+    uint64_t CUOffset = getDebugAranges()->findAddress(Address);
+    // Retrieve the compile unit.
+    return getCompileUnitForOffset(CUOffset);
+  }
+
+  // Avoid collecting the address ranges of every compile unit, which may
+  // require parsing all their DIEs, as long as .debug_aranges has the answer.
+  DWARFCompileUnit *CU = nullptr;
+  if (!Aranges) {
+    if (!SectionAranges) {
+      SectionAranges.reset(new DWARFDebugAranges());
+      SectionAranges->generate(this, /*SectionOnly=*/true);
+    }
+    CU = getCompileUnitForOffset(SectionAranges->findAddress(Address));
+  }
+  if (!CU) {
+    SectionAranges.reset();
+    CU = getCompileUnitForOffset(getDebugAranges()->findAddress(Address));
+  }
+  if (CU)
+    touchAddressLookupUnit(CU);
+  return CU;
+}
+
+void DWARFContext::touchAddressLookupUnit(DWARFUnit *CU) {
+  auto It = llvm::find(AddressLookupUnits, CU);
+  if (It != AddressLookupUnits.end())
+    AddressLookupUnits.erase(It);
+  AddressLookupUnits.push_back(CU);
+
+  while (AddressLookupUnits.size() > MaxAddressLookupUnits) {
+    DWARFUnit *U = AddressLookupUnits.front();
+    AddressLookupUnits.pop_front();
+    if (Line)
+      if (auto Offset = toSectionOffset(U->getUnitDIE().find(DW_AT_stmt_list)))
+        Line->clearLineTable(*Offset + U->getLineTableOffset());
+    // Keep the unit DIE, which holds the attributes the unit was set up with.
+    U->clearDIEs(/*KeepCUDie=*/true);
+  }
 }
 
 DWARFContext::DIEsForAddress DWARFContext::getDIEsForAddress(uint64_t Address) {
@@ -42,7 +42,7 @@ void DWARFDebugAranges::extract(
   }
 }
 
-void DWARFDebugAranges::generate(DWARFContext *CTX) {
+void DWARFDebugAranges::generate(DWARFContext *CTX, bool SectionOnly) {
   clear();
   if (!CTX)
     return;
@@ -52,6 +52,11 @@ void DWARFDebugAranges::generate(DWARFContext *CTX) {
                                  CTX->isLittleEndian(), 0);
   extract(ArangesData, CTX->getRecoverableErrorHandler());
 
+  if (SectionOnly) {
+    construct();
+    return;
+  }
+
   // Generate aranges from DIEs: even if .debug_aranges section is present,
   // it may describe only a small subset of compilation units, so we need to
   // manually build aranges for the rest of them.
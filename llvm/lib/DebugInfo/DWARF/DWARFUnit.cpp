@@ -622,6 +622,7 @@ void DWARFUnit::clearDIEs(bool KeepCUDie) {
   DieArray = (KeepCUDie && !DieArray.empty())
                  ? std::vector<DWARFDebugInfoEntry>({DieArray[0]})
                  : std::vector<DWARFDebugInfoEntry>();
+  AddrDieMap.clear();
 }
 
 Expected<DWARFAddressRangesVector>
@@ -10,6 +10,7 @@
 #include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
@@ -194,8 +195,9 @@ llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
     return createStringError(std::errc::invalid_argument, "already finalized");
   Finalized = true;
 
-  // Sort function infos so we can emit sorted functions.
-  llvm::sort(Funcs);
+  // Sort function infos so we can emit sorted functions. There can be millions
+  // of them for large binaries, so sort in parallel.
+  llvm::parallelSort(Funcs.begin(), Funcs.end());
 
   // Don't let the string table indexes change by finalizing in order.
   StrTab.finalizeInOrder();
@@ -327,6 +329,17 @@ void GsymCreator::addFunctionInfo(FunctionInfo &&FI) {
   Funcs.emplace_back(std::move(FI));
 }
 
+void GsymCreator::addFunctionInfos(std::vector<FunctionInfo> &&FIs) {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  for (const FunctionInfo &FI : FIs)
+    Ranges.insert(FI.Range);
+  if (Funcs.empty())
+    Funcs = std::move(FIs);
+  else
+    Funcs.insert(Funcs.end(), std::make_move_iterator(FIs.begin()),
+                 std::make_move_iterator(FIs.end()));
+}
+
 void GsymCreator::forEachFunctionInfo(
     std::function<bool(FunctionInfo &)> const &Callback) {
   std::lock_guard<std::mutex> Guard(Mutex);
@@ -32,9 +32,13 @@ GsymReader::GsymReader(std::unique_ptr<MemoryBuffer> Buffer) :
 GsymReader::~GsymReader() = default;
 
 llvm::Expected<GsymReader> GsymReader::openFile(StringRef Filename) {
-  // Open the input file and return an appropriate error if needed.
+  // Open the input file and return an appropriate error if needed. GSYM files
+  // are meant to be mmap'ed and read in place, so don't ask for a null
+  // terminator, which would force a copy of files whose size is a multiple of
+  // the page size.
   ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
-      MemoryBuffer::getFileOrSTDIN(Filename);
+      MemoryBuffer::getFileOrSTDIN(Filename, /*IsText=*/false,
+                                   /*RequiresNullTerminator=*/false);
   auto Err = BuffOrErr.getError();
   if (Err)
     return llvm::errorCodeToError(Err);
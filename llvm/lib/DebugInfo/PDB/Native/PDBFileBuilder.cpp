@@ -271,6 +271,12 @@ Error PDBFileBuilder::commit(StringRef Filename, codeview::GUID *Guid) {
     return ExpectedMsfBuffer.takeError();
   FileBufferByteStream Buffer = std::move(*ExpectedMsfBuffer);
 
+  // The module symbol streams and the type and symbol record streams make up
+  // most of a PDB. Once each of them has been written, start writing the file
+  // back to disk so that its dirty pages don't accumulate in memory until the
+  // final commit.
+  auto StartWriteBack = [&] { Buffer.startWriteBack(0, Buffer.getLength()); };
+
   auto ExpectedSN = getNamedStreamIndex("/names");
   if (!ExpectedSN)
     return ExpectedSN.takeError();
@@ -300,21 +306,25 @@ Error PDBFileBuilder::commit(StringRef Filename, codeview::GUID *Guid) {
   if (Dbi) {
     if (auto EC = Dbi->commit(Layout, Buffer))
       return EC;
+    StartWriteBack();
   }
 
   if (Tpi) {
     if (auto EC = Tpi->commit(Layout, Buffer))
       return EC;
+    StartWriteBack();
   }
 
   if (Ipi) {
     if (auto EC = Ipi->commit(Layout, Buffer))
       return EC;
+    StartWriteBack();
   }
 
   if (Gsi) {
     if (auto EC = Gsi->commit(Layout, Buffer))
       return EC;
+    StartWriteBack();
   }
 
   auto InfoStreamBlocks = Layout.StreamMap[StreamPDB];
@@ -12,8 +12,6 @@
 
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 
-#include "SymbolizableObjectFile.h"
-
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/Config/config.h"
@@ -21,6 +19,7 @@
 #include "llvm/DebugInfo/PDB/PDB.h"
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/DebugInfo/Symbolize/DIFetcher.h"
+#include "llvm/DebugInfo/Symbolize/SymbolizableObjectFile.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/MachO.h"
@@ -203,6 +202,29 @@ void LLVMSymbolizer::flush() {
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
+  ModuleLRU.clear();
+  ModuleLRUPositions.clear();
+  ModuleCacheSize = 0;
+}
+
+void LLVMSymbolizer::recordModuleUse(StringRef ModuleName, uint64_t Size) {
+  auto Pos = ModuleLRUPositions.find(ModuleName);
+  if (Pos != ModuleLRUPositions.end()) {
+    ModuleLRU.splice(ModuleLRU.begin(), ModuleLRU, Pos->second);
+    return;
+  }
+  ModuleLRU.emplace_front(ModuleName.str(), Size);
+  ModuleLRUPositions[ModuleName] = ModuleLRU.begin();
+  ModuleCacheSize += Size;
+
+  // Never unload the module that is about to be used.
+  while (ModuleCacheSize > Opts.MaxCacheSize && ModuleLRU.size() > 1) {
+    const std::pair<std::string, uint64_t> &Oldest = ModuleLRU.back();
+    Modules.erase(Oldest.first);
+    ModuleLRUPositions.erase(Oldest.first);
+    ModuleCacheSize -= Oldest.second;
+    ModuleLRU.pop_back();
+  }
 }
 
 namespace {
@@ -535,8 +557,11 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
+  if (I != Modules.end()) {
+    if (Opts.MaxCacheSize && I->second)
+      recordModuleUse(ModuleName, 0);
     return I->second.get();
+  }
 
   std::string BinaryName = ModuleName;
   std::string ArchName = Opts.DefaultArch;
@@ -583,7 +608,15 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
     Context = DWARFContext::create(
         *Objects.second, DWARFContext::ProcessDebugRelocations::Process,
         nullptr, Opts.DWPName);
-  return createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  Expected<SymbolizableModule *> InfoOrErr =
+      createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  if (InfoOrErr && Opts.MaxCacheSize) {
+    uint64_t Size = Objects.first->getData().size();
+    if (Objects.second != Objects.first)
+      Size += Objects.second->getData().size();
+    recordModuleUse(ModuleName, Size);
+  }
+  return InfoOrErr;
 }
 
 Expected<SymbolizableModule *>
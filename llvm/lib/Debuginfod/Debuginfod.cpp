@@ -24,7 +24,9 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/LockFileManager.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/xxhash.h"
 
 namespace llvm {
@@ -68,6 +70,11 @@ std::chrono::milliseconds getDefaultDebuginfodTimeout() {
   return std::chrono::milliseconds(90 * 1000);
 }
 
+Expected<CachePruningPolicy> getDefaultDebuginfodCachePruningPolicy() {
+  const char *PolicyEnv = std::getenv("DEBUGINFOD_CACHE_POLICY");
+  return parseCachePruningPolicy(PolicyEnv ? PolicyEnv : "");
+}
+
 /// The following functions fetch a debuginfod artifact to a file in a local
 /// cache and return the cached file path. They first search the local cache,
 /// followed by the debuginfod servers.
@@ -95,6 +102,24 @@ Expected<std::string> getCachedOrDownloadDebuginfo(BuildIDRef ID) {
   return getCachedOrDownloadArtifact(uniqueKey(UrlPath), UrlPath);
 }
 
+std::vector<Expected<std::string>>
+getCachedOrDownloadDebuginfos(ArrayRef<BuildIDRef> IDs, ThreadPoolStrategy S) {
+  // Expected has no empty state, so collect the results in Optionals first.
+  std::vector<Optional<Expected<std::string>>> Slots(IDs.size());
+  {
+    ThreadPool Pool(S);
+    for (size_t I = 0, E = IDs.size(); I != E; ++I)
+      Pool.async([&, I]() { Slots[I] = getCachedOrDownloadDebuginfo(IDs[I]); });
+    Pool.wait();
+  }
+
+  std::vector<Expected<std::string>> Results;
+  Results.reserve(Slots.size());
+  for (Optional<Expected<std::string>> &Slot : Slots)
+    Results.push_back(std::move(*Slot));
+  return Results;
+}
+
 // General fetching function.
 Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
                                                   StringRef UrlPath) {
@@ -149,6 +174,24 @@ Expected<std::string> getCachedOrDownloadArtifact(
         "allow Debuginfod to make HTTP requests, call HTTPClient::initialize() "
         "at the beginning of main.");
 
+  // Only let one client on this host download the artifact at a time. The
+  // others wait for it and then find the artifact in the cache. If the lock
+  // cannot be created, e.g. because the cache directory does not exist yet,
+  // download the artifact without it.
+  Optional<LockFileManager> Lock;
+  if (!DebuginfodUrls.empty()) {
+    Lock.emplace(AbsCachedArtifactPath);
+    if (*Lock == LockFileManager::LFS_Shared) {
+      Lock->waitForUnlock();
+      CacheAddStreamOrErr = Cache(Task, UniqueKey);
+      if (!CacheAddStreamOrErr)
+        return CacheAddStreamOrErr.takeError();
+      if (!CacheAddStream)
+        return std::string(AbsCachedArtifactPath);
+      // The other client failed to download the artifact; try ourselves.
+    }
+  }
+
   HTTPClient Client;
   Client.setTimeout(Timeout);
   for (StringRef ServerUrl : DebuginfodUrls) {
@@ -176,6 +219,14 @@ Expected<std::string> getCachedOrDownloadArtifact(
 
     *FileStream->OS << StringRef(Response.Body->getBufferStart(),
                                  Response.Body->getBufferSize());
+    // Commit the artifact to the cache before pruning it.
+    FileStream.reset();
+
+    Expected<CachePruningPolicy> PolicyOrErr =
+        getDefaultDebuginfodCachePruningPolicy();
+    if (!PolicyOrErr)
+      return PolicyOrErr.takeError();
+    pruneCache(CacheDirectoryPath, *PolicyOrErr);
 
     // Return the path to the artifact on disk.
     return std::string(AbsCachedArtifactPath);
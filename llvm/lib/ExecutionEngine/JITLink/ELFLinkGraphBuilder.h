@@ -273,6 +273,8 @@ template <typename ELFT> Error ELFLinkGraphBuilder<ELFT>::prepare() {
 template <typename ELFT> Error ELFLinkGraphBuilder<ELFT>::graphifySections() {
   LLVM_DEBUG(dbgs() << "  Creating graph sections...\n");
 
+  GraphBlocks.reserve(Sections.size());
+
   // For each section...
   for (ELFSectionIndex SecIndex = 0; SecIndex != Sections.size(); ++SecIndex) {
 
@@ -374,6 +376,7 @@ template <typename ELFT> Error ELFLinkGraphBuilder<ELFT>::graphifySymbols() {
            << "\"\n";
   });
 
+  GraphSymbols.reserve(Symbols->size());
   for (ELFSymbolIndex SymIndex = 0; SymIndex != Symbols->size(); ++SymIndex) {
     auto &Sym = (*Symbols)[SymIndex];
 
@@ -12,14 +12,30 @@
 
 #include "JITLinkGeneric.h"
 
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/BinaryStreamReader.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 
 #define DEBUG_TYPE "jitlink"
 
+STATISTIC(NumGraphsLinked, "Number of link graphs linked");
+STATISTIC(NumBlocksFixedUp, "Number of blocks fixed up");
+STATISTIC(NumFixupsApplied, "Number of relocation edges applied");
+STATISTIC(NumParallelFixUps, "Number of graphs fixed up in parallel");
+STATISTIC(NumDefinedSymbols, "Number of defined symbols kept after pruning");
+STATISTIC(NumExternalSymbols,
+          "Number of external symbols kept after pruning");
+STATISTIC(NumBlocksPruned, "Number of blocks dead-stripped");
+STATISTIC(NumSymbolsPruned, "Number of symbols dead-stripped");
+
 namespace llvm {
 namespace jitlink {
 
+// Below this many relocations, fixing up a graph is cheaper than handing its
+// blocks to other threads.
+static constexpr size_t ParallelFixUpThreshold = 4096;
+
 JITLinkerBase::~JITLinkerBase() {}
 
 void JITLinkerBase::linkPhase1(std::unique_ptr<JITLinkerBase> Self) {
@@ -44,6 +60,13 @@ void JITLinkerBase::linkPhase1(std::unique_ptr<JITLinkerBase> Self) {
     G->dump(dbgs());
   });
 
+  if (AreStatisticsEnabled()) {
+    NumDefinedSymbols += std::distance(G->defined_symbols().begin(),
+                                       G->defined_symbols().end());
+    NumExternalSymbols += std::distance(G->external_symbols().begin(),
+                                        G->external_symbols().end());
+  }
+
   // Run post-pruning passes.
   if (auto Err = runPasses(Passes.PostPrunePasses))
     return Ctx->notifyFailed(std::move(Err));
@@ -177,6 +200,7 @@ void JITLinkerBase::linkPhase4(std::unique_ptr<JITLinkerBase> Self,
     return Ctx->notifyFailed(FR.takeError());
 
   Ctx->notifyFinalized(std::move(*FR));
+  ++NumGraphsLinked;
 
   LLVM_DEBUG({ dbgs() << "Link of graph " << G->getName() << " complete\n"; });
 }
@@ -188,6 +212,33 @@ Error JITLinkerBase::runPasses(LinkGraphPassList &Passes) {
   return Error::success();
 }
 
+Error JITLinkerBase::forEachBlockToFixUp(
+    LinkGraph &G, function_ref<Error(Block &)> FixUpBlock) {
+  std::vector<Block *> Blocks;
+  size_t NumFixups = 0;
+  for (auto *B : G.blocks()) {
+    size_t NumBlockFixups = llvm::count_if(
+        B->edges(), [](const Edge &E) { return E.isRelocation(); });
+    if (!NumBlockFixups)
+      continue;
+    Blocks.push_back(B);
+    NumFixups += NumBlockFixups;
+  }
+  NumBlocksFixedUp += Blocks.size();
+  NumFixupsApplied += NumFixups;
+
+  if (NumFixups < ParallelFixUpThreshold || Blocks.size() < 2) {
+    for (auto *B : Blocks)
+      if (auto Err = FixUpBlock(*B))
+        return Err;
+    return Error::success();
+  }
+
+  ++NumParallelFixUps;
+  return parallelForEachError(Blocks,
+                              [&](Block *B) { return FixUpBlock(*B); });
+}
+
 JITLinkContext::LookupMap JITLinkerBase::getExternalSymbolNames() const {
   // Identify unresolved external symbols.
   JITLinkContext::LookupMap UnresolvedExternals;
@@ -281,6 +332,7 @@ void prune(LinkGraph &G) {
       LLVM_DEBUG(dbgs() << "  " << *Sym << "...\n");
       G.removeDefinedSymbol(*Sym);
     }
+    NumSymbolsPruned += SymbolsToRemove.size();
   }
 
   // Delete any unused blocks.
@@ -294,6 +346,7 @@ void prune(LinkGraph &G) {
       LLVM_DEBUG(dbgs() << "  " << *B << "...\n");
       G.removeBlock(*B);
     }
+    NumBlocksPruned += BlocksToRemove.size();
   }
 
   // Collect all external symbols to remove, then remove them.
@@ -307,6 +360,7 @@ void prune(LinkGraph &G) {
       LLVM_DEBUG(dbgs() << "  " << *Sym << "...\n");
       G.removeExternalSymbol(*Sym);
     }
+    NumSymbolsPruned += SymbolsToRemove.size();
   }
 }
 
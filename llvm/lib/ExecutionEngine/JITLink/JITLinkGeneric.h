@@ -84,6 +84,15 @@ private:
   // Implemented in JITLinker.
   virtual Error fixUpBlocks(LinkGraph &G) const = 0;
 
+protected:
+  // Call FixUpBlock on every block in G. Fixing up a block only writes to
+  // that block's content, so graphs with many relocations have their blocks
+  // fixed up in parallel.
+  static Error forEachBlockToFixUp(LinkGraph &G,
+                                   function_ref<Error(Block &)> FixUpBlock);
+
+private:
+
   JITLinkContext::LookupMap getExternalSymbolNames() const;
   void applyLookupResult(AsyncLookupResult LR);
   void abandonAllocAndBailOut(std::unique_ptr<JITLinkerBase> Self, Error Err);
@@ -123,26 +132,25 @@ private:
   Error fixUpBlocks(LinkGraph &G) const override {
     LLVM_DEBUG(dbgs() << "Fixing up blocks:\n");
 
-    for (auto *B : G.blocks()) {
-      LLVM_DEBUG(dbgs() << "  " << *B << ":\n");
+    return forEachBlockToFixUp(G, [&](Block &B) -> Error {
+      LLVM_DEBUG(dbgs() << "  " << B << ":\n");
 
       // Copy Block data and apply fixups.
       LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
-      assert((!B->isZeroFill() || B->edges_size() == 0) &&
+      assert((!B.isZeroFill() || B.edges_size() == 0) &&
              "Edges in zero-fill block?");
-      for (auto &E : B->edges()) {
+      for (auto &E : B.edges()) {
 
         // Skip non-relocation edges.
         if (!E.isRelocation())
           continue;
 
         // Dispatch to LinkerImpl for fixup.
-        if (auto Err = impl().applyFixup(G, *B, E))
+        if (auto Err = impl().applyFixup(G, B, E))
           return Err;
       }
-    }
-
-    return Error::success();
+      return Error::success();
+    });
   }
 };
 
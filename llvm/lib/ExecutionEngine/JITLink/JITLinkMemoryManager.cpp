@@ -466,5 +466,343 @@ InProcessMemoryManager::createFinalizedAlloc(
   return FinalizedAlloc(orc::ExecutorAddr::fromPtr(FA));
 }
 
+void SlabMemoryManager::FreeList::add(Range R) {
+  auto Next = Ranges.lower_bound(R.Offset);
+  // Merge with the following range.
+  if (Next != Ranges.end() && Next->first == R.Offset + R.Size) {
+    R.Size += Next->second;
+    Next = Ranges.erase(Next);
+  }
+  // Merge with the preceding range.
+  if (Next != Ranges.begin()) {
+    auto Prev = std::prev(Next);
+    assert(Prev->first + Prev->second <= R.Offset && "Overlapping free range");
+    if (Prev->first + Prev->second == R.Offset) {
+      Prev->second += R.Size;
+      return;
+    }
+  }
+  Ranges.insert(Next, {R.Offset, R.Size});
+}
+
+Optional<SlabMemoryManager::Range>
+SlabMemoryManager::FreeList::take(uint64_t Size) {
+  for (auto I = Ranges.begin(), E = Ranges.end(); I != E; ++I) {
+    if (I->second < Size)
+      continue;
+    Range R{I->first, Size};
+    uint64_t Remaining = I->second - Size;
+    Ranges.erase(I);
+    if (Remaining)
+      Ranges.insert({R.Offset + Size, Remaining});
+    return R;
+  }
+  return None;
+}
+
+class SlabMemoryManager::SlabInFlightAlloc
+    : public JITLinkMemoryManager::InFlightAlloc {
+public:
+  SlabInFlightAlloc(SlabMemoryManager &MemMgr, LinkGraph &G, BasicLayout BL,
+                    SmallVector<Range, 4> StandardSegments,
+                    SmallVector<Range, 4> FinalizationSegments)
+      : MemMgr(MemMgr), G(G), BL(std::move(BL)),
+        StandardSegments(std::move(StandardSegments)),
+        FinalizationSegments(std::move(FinalizationSegments)) {}
+
+  void finalize(OnFinalizedFunction OnFinalized) override {
+
+    // Apply memory protections to all segments.
+    if (auto Err = applyProtections()) {
+      OnFinalized(std::move(Err));
+      return;
+    }
+
+    // Run finalization actions.
+    auto DeallocActions = runFinalizeActions(G.allocActions());
+    if (!DeallocActions) {
+      OnFinalized(DeallocActions.takeError());
+      return;
+    }
+
+    // Return the finalize segments to their slabs.
+    MemMgr.releaseRanges(FinalizationSegments);
+
+    // Continue with finalized allocation.
+    OnFinalized(MemMgr.createFinalizedAlloc(std::move(StandardSegments),
+                                            std::move(*DeallocActions)));
+  }
+
+  void abandon(OnAbandonedFunction OnAbandoned) override {
+    MemMgr.releaseRanges(FinalizationSegments);
+    MemMgr.releaseRanges(StandardSegments);
+    OnAbandoned(Error::success());
+  }
+
+private:
+  Error applyProtections() {
+    for (auto &KV : BL.segments()) {
+      const auto &AG = KV.first;
+      auto &Seg = KV.second;
+
+      auto Prot = toSysMemoryProtectionFlags(AG.getMemProt());
+
+      uint64_t SegSize =
+          alignTo(Seg.ContentSize + Seg.ZeroFillSize, MemMgr.PageSize);
+      sys::MemoryBlock MB(Seg.WorkingMem, SegSize);
+      if (auto EC = sys::Memory::protectMappedMemory(MB, Prot))
+        return errorCodeToError(EC);
+      if (Prot & sys::Memory::MF_EXEC)
+        sys::Memory::InvalidateInstructionCache(MB.base(), MB.allocatedSize());
+    }
+    return Error::success();
+  }
+
+  SlabMemoryManager &MemMgr;
+  LinkGraph &G;
+  BasicLayout BL;
+  SmallVector<Range, 4> StandardSegments;
+  SmallVector<Range, 4> FinalizationSegments;
+};
+
+Expected<std::unique_ptr<SlabMemoryManager>>
+SlabMemoryManager::Create(uint64_t ReservationSize, bool UseHugePages,
+                          IsHotGraphFunction IsHotGraph, uint64_t SlabSize) {
+  auto PageSize = sys::Process::getPageSize();
+  if (!PageSize)
+    return PageSize.takeError();
+  if (!isPowerOf2_64(*PageSize))
+    return make_error<StringError>("Page size is not a power of 2",
+                                   inconvertibleErrorCode());
+  if (!isPowerOf2_64(SlabSize) || SlabSize < static_cast<uint64_t>(*PageSize))
+    return make_error<StringError>(
+        "Slab size must be a power of 2 no smaller than the page size",
+        inconvertibleErrorCode());
+
+  ReservationSize = alignTo(ReservationSize, SlabSize);
+  if (ReservationSize + SlabSize > std::numeric_limits<size_t>::max())
+    return make_error<JITLinkError>(
+        "Reservation size " + formatv("{0:x}", ReservationSize) +
+        " exceeds address space");
+
+  unsigned Flags = sys::Memory::MF_READ | sys::Memory::MF_WRITE;
+  if (UseHugePages)
+    Flags |= sys::Memory::MF_HUGE_HINT;
+
+  // Map one extra slab so that slabs can be aligned to their size, which
+  // lets each of them be backed by a huge page.
+  std::error_code EC;
+  auto Mapping = sys::Memory::allocateMappedMemory(ReservationSize + SlabSize,
+                                                   nullptr, Flags, EC);
+  if (EC)
+    return errorCodeToError(EC);
+
+  return std::unique_ptr<SlabMemoryManager>(
+      new SlabMemoryManager(std::move(Mapping), ReservationSize, *PageSize,
+                            SlabSize, std::move(IsHotGraph)));
+}
+
+SlabMemoryManager::SlabMemoryManager(sys::MemoryBlock Mapping,
+                                     uint64_t ReservationSize,
+                                     uint64_t PageSize, uint64_t SlabSize,
+                                     IsHotGraphFunction IsHotGraph)
+    : Mapping(std::move(Mapping)), ReservationSize(ReservationSize),
+      PageSize(PageSize), SlabSize(SlabSize),
+      IsHotGraph(std::move(IsHotGraph)) {
+  Base = reinterpret_cast<char *>(
+      alignTo(reinterpret_cast<uintptr_t>(this->Mapping.base()), SlabSize));
+  FreeSlabs.add({0, ReservationSize});
+}
+
+SlabMemoryManager::~SlabMemoryManager() {
+  sys::Memory::releaseMappedMemory(Mapping);
+}
+
+uint64_t SlabMemoryManager::getAllocatedSize() {
+  std::lock_guard<std::mutex> Lock(RangesMutex);
+  return AllocatedSize;
+}
+
+uint64_t SlabMemoryManager::getSlabBytes() {
+  std::lock_guard<std::mutex> Lock(RangesMutex);
+  return SlabBytes;
+}
+
+Expected<SlabMemoryManager::Range>
+SlabMemoryManager::allocateRange(Pool P, uint64_t Size) {
+  std::lock_guard<std::mutex> Lock(RangesMutex);
+
+  // Fill the slabs of this pool in address order, so that memory of one kind
+  // stays packed together.
+  for (auto &KV : Slabs) {
+    Slab &S = KV.second;
+    if (S.P != P || S.Size - S.Used < Size)
+      continue;
+    if (auto R = S.Free.take(Size)) {
+      S.Used += Size;
+      AllocatedSize += Size;
+      return *R;
+    }
+  }
+
+  // Start a new slab, large enough for the request.
+  auto SlabRange = FreeSlabs.take(alignTo(Size, SlabSize));
+  if (!SlabRange)
+    return make_error<JITLinkError>(
+        "Slab memory manager reservation exhausted: can't allocate " +
+        formatv("{0:x}", Size) + " bytes");
+
+  Slab &S = Slabs[SlabRange->Offset];
+  S.P = P;
+  S.Size = SlabRange->Size;
+  S.Used = Size;
+  if (Size != S.Size)
+    S.Free.add({SlabRange->Offset + Size, S.Size - Size});
+  AllocatedSize += Size;
+  SlabBytes += S.Size;
+  return Range{SlabRange->Offset, Size};
+}
+
+void SlabMemoryManager::releaseRanges(ArrayRef<Range> Ranges) {
+  std::lock_guard<std::mutex> Lock(RangesMutex);
+  for (const Range &R : Ranges) {
+    auto I = Slabs.upper_bound(R.Offset);
+    assert(I != Slabs.begin() && "Range not in a slab");
+    --I;
+    Slab &S = I->second;
+    assert(R.Offset + R.Size <= I->first + S.Size && "Range not in a slab");
+
+    AllocatedSize -= R.Size;
+    S.Used -= R.Size;
+    if (S.Used) {
+      S.Free.add(R);
+      continue;
+    }
+
+    // The slab is empty: return it to the reservation.
+    SlabBytes -= S.Size;
+    FreeSlabs.add({I->first, S.Size});
+    Slabs.erase(I);
+  }
+}
+
+void SlabMemoryManager::allocate(const JITLinkDylib *JD, LinkGraph &G,
+                                 OnAllocatedFunction OnAllocated) {
+  BasicLayout BL(G);
+
+  // Check segment alignments.
+  auto SegsSizes = BL.getContiguousPageBasedLayoutSizes(PageSize);
+  if (!SegsSizes) {
+    OnAllocated(SegsSizes.takeError());
+    return;
+  }
+
+  bool IsHot = IsHotGraph && IsHotGraph(G);
+
+  SmallVector<Range, 4> StandardSegments;
+  SmallVector<Range, 4> FinalizationSegments;
+  auto ReleaseAll = [&]() {
+    releaseRanges(StandardSegments);
+    releaseRanges(FinalizationSegments);
+  };
+
+  const sys::Memory::ProtectionFlags ReadWrite =
+      static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                                sys::Memory::MF_WRITE);
+
+  for (auto &KV : BL.segments()) {
+    auto &AG = KV.first;
+    auto &Seg = KV.second;
+
+    Pool P = Data;
+    if (AG.getMemDeallocPolicy() == MemDeallocPolicy::Standard &&
+        (AG.getMemProt() & MemProt::Exec) != MemProt::None)
+      P = IsHot ? HotCode : Code;
+
+    auto R = allocateRange(
+        P, alignTo(Seg.ContentSize + Seg.ZeroFillSize, PageSize));
+    if (!R) {
+      ReleaseAll();
+      OnAllocated(R.takeError());
+      return;
+    }
+    if (AG.getMemDeallocPolicy() == MemDeallocPolicy::Standard)
+      StandardSegments.push_back(*R);
+    else
+      FinalizationSegments.push_back(*R);
+
+    // The range may have been used by an earlier allocation: make it
+    // writable again and clear it.
+    sys::MemoryBlock MB = getMemoryBlock(*R);
+    if (auto EC = sys::Memory::protectMappedMemory(MB, ReadWrite)) {
+      ReleaseAll();
+      OnAllocated(errorCodeToError(EC));
+      return;
+    }
+    memset(MB.base(), 0, MB.allocatedSize());
+
+    Seg.WorkingMem = static_cast<char *>(MB.base());
+    Seg.Addr = orc::ExecutorAddr::fromPtr(MB.base());
+  }
+
+  LLVM_DEBUG({
+    dbgs() << "SlabMemoryManager allocated " << StandardSegments.size()
+           << " standard and " << FinalizationSegments.size()
+           << " finalize segments for " << G.getName()
+           << (IsHot ? " (hot)" : "") << "\n";
+  });
+
+  if (auto Err = BL.apply()) {
+    ReleaseAll();
+    OnAllocated(std::move(Err));
+    return;
+  }
+
+  OnAllocated(std::make_unique<SlabInFlightAlloc>(
+      *this, G, std::move(BL), std::move(StandardSegments),
+      std::move(FinalizationSegments)));
+}
+
+void SlabMemoryManager::deallocate(std::vector<FinalizedAlloc> Allocs,
+                                   OnDeallocatedFunction OnDeallocated) {
+  std::vector<FinalizedAllocInfo> Infos;
+  {
+    std::lock_guard<std::mutex> Lock(FinalizedAllocsMutex);
+    for (auto &Alloc : Allocs) {
+      auto *FA = Alloc.release().toPtr<FinalizedAllocInfo *>();
+      Infos.push_back(std::move(*FA));
+      FA->~FinalizedAllocInfo();
+      FinalizedAllocInfos.Deallocate(FA);
+    }
+  }
+
+  Error DeallocErr = Error::success();
+
+  // Deallocate in reverse order of allocation.
+  for (auto &Info : llvm::reverse(Infos)) {
+    /// Run any deallocate calls.
+    while (!Info.DeallocActions.empty()) {
+      if (auto Err = Info.DeallocActions.back().runWithSPSRetErrorMerged())
+        DeallocErr = joinErrors(std::move(DeallocErr), std::move(Err));
+      Info.DeallocActions.pop_back();
+    }
+
+    /// Return the standard segments to their slabs.
+    releaseRanges(Info.StandardSegments);
+  }
+
+  OnDeallocated(std::move(DeallocErr));
+}
+
+JITLinkMemoryManager::FinalizedAlloc SlabMemoryManager::createFinalizedAlloc(
+    SmallVector<Range, 4> StandardSegments,
+    std::vector<orc::shared::WrapperFunctionCall> DeallocActions) {
+  std::lock_guard<std::mutex> Lock(FinalizedAllocsMutex);
+  auto *FA = FinalizedAllocInfos.Allocate<FinalizedAllocInfo>();
+  new (FA) FinalizedAllocInfo(
+      {std::move(StandardSegments), std::move(DeallocActions)});
+  return FinalizedAlloc(orc::ExecutorAddr::fromPtr(FA));
+}
+
 } // end namespace jitlink
 } // end namespace llvm
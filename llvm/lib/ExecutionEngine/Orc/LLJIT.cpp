@@ -671,7 +671,7 @@ Error LLJITBuilderState::prepareForConstruction() {
 
 LLJIT::~LLJIT() {
   if (CompileThreads)
-    CompileThreads->wait();
+    CompileThreads->shutdown();
   if (auto Err = ES->endSession())
     ES->reportError(std::move(Err));
 }
@@ -811,17 +811,14 @@ LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
 
   if (S.NumCompileThreads > 0) {
     InitHelperTransformLayer->setCloneToNewContextOnEmit(true);
-    CompileThreads =
-        std::make_unique<ThreadPool>(hardware_concurrency(S.NumCompileThreads));
+#if LLVM_ENABLE_THREADS
+    CompileThreads = std::make_unique<PriorityThreadPoolTaskDispatcher>(
+        S.NumCompileThreads);
+#else
+    CompileThreads = std::make_unique<InPlaceTaskDispatcher>();
+#endif
     ES->setDispatchTask([this](std::unique_ptr<Task> T) {
-      // FIXME: We should be able to use move-capture here, but ThreadPool's
-      // AsyncTaskTys are std::functions rather than unique_functions
-      // (because MSVC's std::packaged_tasks don't support move-only types).
-      // Fix this when all the above gets sorted out.
-      CompileThreads->async([UnownedT = T.release()]() mutable {
-        std::unique_ptr<Task> T(UnownedT);
-        T->run();
-      });
+      CompileThreads->dispatch(std::move(T));
     });
   }
 
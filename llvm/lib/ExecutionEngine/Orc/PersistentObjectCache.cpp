@@ -0,0 +1,192 @@
+//===--- PersistentObjectCache.cpp - On-disk cache of JIT'd objects -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+Expected<std::unique_ptr<PersistentObjectCache>>
+PersistentObjectCache::Create(StringRef CacheDir,
+                              const JITTargetMachineBuilder &JTMB,
+                              CachePruningPolicy Policy) {
+  if (std::error_code EC = sys::fs::create_directories(CacheDir))
+    return createStringError(EC, "can't create object cache directory %s: %s",
+                             CacheDir.str().c_str(), EC.message().c_str());
+  return std::make_unique<PersistentObjectCache>(
+      CacheDir.str(), getTargetKey(JTMB), std::move(Policy));
+}
+
+PersistentObjectCache::PersistentObjectCache(std::string CacheDir,
+                                             std::string TargetKey,
+                                             CachePruningPolicy Policy)
+    : CacheDir(std::move(CacheDir)), TargetKey(std::move(TargetKey)),
+      Policy(std::move(Policy)) {}
+
+std::string
+PersistentObjectCache::getTargetKey(const JITTargetMachineBuilder &JTMB) {
+  SHA1 Hasher;
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  };
+  auto AddUnsigned = [&](unsigned I) {
+    uint8_t Data[4];
+    support::endian::write32le(Data, I);
+    Hasher.update(ArrayRef<uint8_t>{Data, 4});
+  };
+
+  AddString(JTMB.getTargetTriple().str());
+  AddString(JTMB.getCPU());
+  AddString(JTMB.getFeatures().getString());
+  if (JTMB.getRelocationModel())
+    AddUnsigned(*JTMB.getRelocationModel());
+  else
+    AddUnsigned(-1);
+  if (JTMB.getCodeModel())
+    AddUnsigned(*JTMB.getCodeModel());
+  else
+    AddUnsigned(-1);
+  AddUnsigned(JTMB.getCodeGenOptLevel());
+
+  // FIXME: Hash more of Options. These are the ones JIT clients commonly
+  // change.
+  const TargetOptions &Options = JTMB.getOptions();
+  AddUnsigned(Options.EmulatedTLS);
+  AddUnsigned(Options.ExplicitEmulatedTLS);
+  AddUnsigned(Options.RelaxELFRelocations);
+  AddUnsigned(Options.FunctionSections);
+  AddUnsigned(Options.DataSections);
+  AddUnsigned(Options.UnsafeFPMath);
+  AddUnsigned(Options.NoInfsFPMath);
+  AddUnsigned(Options.NoNaNsFPMath);
+  AddUnsigned(Options.NoSignedZerosFPMath);
+  AddUnsigned(Options.GuaranteedTailCallOpt);
+  AddUnsigned(static_cast<unsigned>(Options.AllowFPOpFusion));
+  AddUnsigned(static_cast<unsigned>(Options.FloatABIType));
+  AddUnsigned(static_cast<unsigned>(Options.ExceptionModel));
+  AddUnsigned(static_cast<unsigned>(Options.DebuggerTuning));
+
+  return toHex(Hasher.result());
+}
+
+std::string PersistentObjectCache::getModuleKey(const Module &M) const {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(LLVM_VERSION_STRING);
+#ifdef LLVM_REVISION
+  Hasher.update(LLVM_REVISION);
+#endif
+  Hasher.update(TargetKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+  return toHex(Hasher.result());
+}
+
+std::string PersistentObjectCache::getEntryPath(StringRef Key) const {
+  // pruneCache only considers files named llvmcache-*.
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, "llvmcache-" + Key);
+  return std::string(Path);
+}
+
+std::unique_ptr<MemoryBuffer>
+PersistentObjectCache::getObject(const Module *M) {
+  std::string Key = getModuleKey(*M);
+  std::string EntryPath = getEntryPath(Key);
+
+  // Objects are large and only read by the linker, so map them rather than
+  // copying them into memory.
+  auto ObjOrErr = MemoryBuffer::getFile(EntryPath, /*IsText=*/false,
+                                        /*RequiresNullTerminator=*/false);
+  if (ObjOrErr) {
+    file_magic Magic = identify_magic((*ObjOrErr)->getBuffer());
+    if (Magic == file_magic::elf_relocatable ||
+        Magic == file_magic::macho_object ||
+        Magic == file_magic::coff_object) {
+      LLVM_DEBUG(dbgs() << "Object cache hit for " << M->getModuleIdentifier()
+                        << " in " << EntryPath << "\n");
+      return std::move(*ObjOrErr);
+    }
+    // Don't keep serving a truncated or foreign file.
+    sys::fs::remove(EntryPath);
+  }
+
+  LLVM_DEBUG(dbgs() << "Object cache miss for " << M->getModuleIdentifier()
+                    << "\n");
+  std::lock_guard<std::mutex> Lock(PendingMutex);
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const Module *M,
+                                                 MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(PendingMutex);
+    auto I = PendingKeys.find(M);
+    if (I != PendingKeys.end()) {
+      Key = std::move(I->second);
+      PendingKeys.erase(I);
+    }
+  }
+  if (Key.empty())
+    Key = getModuleKey(*M);
+
+  // Write to a temporary file and rename it into place, so that other
+  // processes sharing the directory never see a partial object.
+  SmallString<128> TempModel(CacheDir);
+  sys::path::append(TempModel, "orcjit-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(TempModel);
+  // Caching is best-effort: failing to store an object only costs a
+  // recompile in the next run.
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    OS << Obj.getBuffer();
+  }
+  if (Error Err = Temp->keep(getEntryPath(Key))) {
+    consumeError(std::move(Err));
+    consumeError(Temp->discard());
+    return;
+  }
+
+  pruneCache(CacheDir, Policy);
+}
+
+void PersistentObjectCache::prune() {
+  CachePruningPolicy Now = Policy;
+  Now.Interval = std::chrono::seconds(0);
+  pruneCache(CacheDir, Now);
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -8,6 +8,8 @@
 
 #include "llvm/ExecutionEngine/Orc/TaskDispatch.h"
 
+#include <algorithm>
+
 namespace llvm {
 namespace orc {
 
@@ -42,6 +44,68 @@ void DynamicThreadPoolTaskDispatcher::shutdown() {
   Running = false;
   OutstandingCV.wait(Lock, [this]() { return Outstanding == 0; });
 }
+
+PriorityThreadPoolTaskDispatcher::PriorityThreadPoolTaskDispatcher(
+    unsigned NumThreads) {
+  assert(NumThreads && "Need at least one thread");
+  Threads.reserve(NumThreads);
+  for (unsigned I = 0; I != NumThreads; ++I)
+    Threads.emplace_back([this]() { runWorker(); });
+}
+
+PriorityThreadPoolTaskDispatcher::~PriorityThreadPoolTaskDispatcher() {
+  shutdown();
+}
+
+void PriorityThreadPoolTaskDispatcher::dispatch(std::unique_ptr<Task> T) {
+  {
+    std::lock_guard<std::mutex> Lock(QueueMutex);
+    if (Running) {
+      unsigned Priority = T->getPriority();
+      Queue.push_back({Priority, NextSeq++, std::move(T)});
+      std::push_heap(Queue.begin(), Queue.end(), runsAfter);
+      QueueCV.notify_one();
+      return;
+    }
+  }
+  T->run();
+}
+
+void PriorityThreadPoolTaskDispatcher::shutdown() {
+  {
+    std::unique_lock<std::mutex> Lock(QueueMutex);
+    IdleCV.wait(Lock, [this]() { return Queue.empty() && Active == 0; });
+    Running = false;
+  }
+  QueueCV.notify_all();
+  for (std::thread &Thread : Threads)
+    Thread.join();
+  Threads.clear();
+}
+
+void PriorityThreadPoolTaskDispatcher::runWorker() {
+  while (true) {
+    std::unique_ptr<Task> T;
+    {
+      std::unique_lock<std::mutex> Lock(QueueMutex);
+      QueueCV.wait(Lock, [this]() { return !Queue.empty() || !Running; });
+      if (Queue.empty())
+        return;
+      std::pop_heap(Queue.begin(), Queue.end(), runsAfter);
+      T = std::move(Queue.back().T);
+      Queue.pop_back();
+      ++Active;
+    }
+
+    T->run();
+    T.reset();
+
+    std::lock_guard<std::mutex> Lock(QueueMutex);
+    --Active;
+    if (Queue.empty() && Active == 0)
+      IdleCV.notify_all();
+  }
+}
 #endif
 
 } // namespace orc
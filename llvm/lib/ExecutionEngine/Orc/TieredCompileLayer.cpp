@@ -0,0 +1,299 @@
+//===----- TieredCompileLayer.cpp - Recompile hot functions ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Type.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+TieredCompileLayer::TieredCompileLayer(
+    ExecutionSession &ES, IRLayer &Tier0Layer, IRLayer &Tier1Layer,
+    LazyCallThroughManager &LCTMgr,
+    IndirectStubsManagerBuilder BuildIndirectStubsManager,
+    uint64_t HotCallCount)
+    : IRLayer(ES, Tier0Layer.getManglingOptions()), Tier0Layer(Tier0Layer),
+      Tier1Layer(Tier1Layer), LCTMgr(LCTMgr),
+      BuildIndirectStubsManager(std::move(BuildIndirectStubsManager)),
+      HotCallCount(HotCallCount) {
+  assert(HotCallCount && "Functions must be called to become hot");
+}
+
+void TieredCompileLayer::tierUpEntryPoint(TieredCompileLayer *Layer,
+                                          uint64_t CandidateId) {
+  assert(Layer && "Null layer received in __orc_tier_up");
+  Layer->tierUp(CandidateId);
+}
+
+Error TieredCompileLayer::addTieringRuntime(JITDylib &JD,
+                                            MangleAndInterner &Mangle) {
+  JITEvaluatedSymbol ThisPtr(pointerToJITTargetAddress(this),
+                             JITSymbolFlags::Exported);
+  JITEvaluatedSymbol TierUpPtr(pointerToJITTargetAddress(&tierUpEntryPoint),
+                               JITSymbolFlags::Exported |
+                                   JITSymbolFlags::Callable);
+  return JD.define(absoluteSymbols({
+      {Mangle("__orc_tiered_layer"), ThisPtr}, // Data Symbol
+      {Mangle("__orc_tier_up"), TierUpPtr}     // Callable Symbol
+  }));
+}
+
+void TieredCompileLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
+                              ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  auto &ES = getExecutionSession();
+  auto &PDR = getPerDylibResources(R->getTargetJITDylib());
+
+  SymbolAliasMap NonCallables;
+  SymbolAliasMap Callables;
+  for (auto &KV : R->getSymbols()) {
+    auto &Name = KV.first;
+    auto &Flags = KV.second;
+    if (Flags.isCallable())
+      Callables[Name] = SymbolAliasMapEntry(Name, Flags);
+    else
+      NonCallables[Name] = SymbolAliasMapEntry(Name, Flags);
+  }
+
+  // Keep an uninstrumented copy of the module for the second tier, then
+  // instrument the module for the first tier.
+  if (!Callables.empty() &&
+      TSM.withModuleDo([](const Module &M) { return canRecompile(M); })) {
+    auto Source = std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+    TSM.withModuleDo([&](Module &M) {
+      instrumentModule(M, R->getTargetJITDylib(), Callables,
+                       std::move(Source));
+    });
+    assert(!TSM.withModuleDo([](const Module &M) { return verifyModule(M); }) &&
+           "Tiering instrumentation breaks IR?");
+  }
+
+  // Lodge the module with the implementation dylib and make its symbols
+  // available through re-exports and lazy call-through stubs.
+  if (auto Err = PDR.getImplDylib().define(
+          std::make_unique<BasicIRLayerMaterializationUnit>(
+              Tier0Layer, *getManglingOptions(), std::move(TSM)))) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  if (!NonCallables.empty())
+    if (auto Err =
+            R->replace(reexports(PDR.getImplDylib(), std::move(NonCallables),
+                                 JITDylibLookupFlags::MatchAllSymbols))) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+      return;
+    }
+  if (!Callables.empty()) {
+    if (auto Err = R->replace(lazyReexports(LCTMgr, PDR.getISManager(),
+                                            PDR.getImplDylib(),
+                                            std::move(Callables)))) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+      return;
+    }
+  }
+}
+
+TieredCompileLayer::PerDylibResources &
+TieredCompileLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(LayerMutex);
+
+  auto I = DylibResources.find(&TargetD);
+  if (I == DylibResources.end()) {
+    auto &ImplD =
+        getExecutionSession().createBareJITDylib(TargetD.getName() + ".tiers");
+    JITDylibSearchOrder NewLinkOrder;
+    TargetD.withLinkOrderDo([&](const JITDylibSearchOrder &TargetLinkOrder) {
+      NewLinkOrder = TargetLinkOrder;
+    });
+
+    assert(!NewLinkOrder.empty() && NewLinkOrder.front().first == &TargetD &&
+           NewLinkOrder.front().second ==
+               JITDylibLookupFlags::MatchAllSymbols &&
+           "TargetD must be at the front of its own search order and match "
+           "non-exported symbol");
+    NewLinkOrder.insert(std::next(NewLinkOrder.begin()),
+                        {&ImplD, JITDylibLookupFlags::MatchAllSymbols});
+    ImplD.setLinkOrder(NewLinkOrder, false);
+    TargetD.setLinkOrder(std::move(NewLinkOrder), false);
+
+    PerDylibResources PDR(ImplD, BuildIndirectStubsManager());
+    I = DylibResources.insert(std::make_pair(&TargetD, std::move(PDR))).first;
+  }
+
+  return I->second;
+}
+
+bool TieredCompileLayer::canRecompile(const Module &M) {
+  if (!M.alias_empty() || !M.ifunc_empty())
+    return false;
+  for (const GlobalVariable &GV : M.globals())
+    if (GV.hasLocalLinkage() && !GV.isConstant())
+      return false;
+  return true;
+}
+
+void TieredCompileLayer::instrumentModule(
+    Module &M, JITDylib &TargetD, const SymbolAliasMap &Callables,
+    std::shared_ptr<ThreadSafeModule> Source) {
+  auto &Ctx = M.getContext();
+  auto *Int64Ty = Type::getInt64Ty(Ctx);
+  auto *LayerTy = StructType::create(Ctx, "Class.TieredCompileLayer");
+  auto *TierUpTy = FunctionType::get(Type::getVoidTy(Ctx),
+                                     {LayerTy->getPointerTo(), Int64Ty}, false);
+  FunctionCallee TierUp = M.getOrInsertFunction("__orc_tier_up", TierUpTy);
+  auto *LayerAddr = new GlobalVariable(M, LayerTy, false,
+                                       GlobalValue::ExternalLinkage, nullptr,
+                                       "__orc_tiered_layer");
+
+  MangleAndInterner Mangle(getExecutionSession(), M.getDataLayout());
+  IRBuilder<> Builder(Ctx);
+  for (Function &F : M) {
+    if (F.isDeclaration() || F.hasLocalLinkage() ||
+        F.hasAvailableExternallyLinkage())
+      continue;
+    SymbolStringPtr StubName = Mangle(F.getName());
+    if (!Callables.count(StubName))
+      continue;
+
+    uint64_t CandidateId;
+    {
+      std::lock_guard<std::mutex> Lock(LayerMutex);
+      CandidateId = Candidates.size();
+      Candidates.push_back(
+          {&TargetD, std::move(StubName), F.getName().str(), Source});
+    }
+
+    auto *Counter = new GlobalVariable(
+        M, Int64Ty, false, GlobalValue::InternalLinkage,
+        ConstantInt::get(Int64Ty, 0), "__orc_tier.count.for." + F.getName());
+    Counter->setAlignment(Align(8));
+
+    // Count the call before the function's entry block, and call back into
+    // the layer when the count reaches the threshold.
+    BasicBlock &ProgramEntry = F.getEntryBlock();
+    BasicBlock *TierUpBlock =
+        BasicBlock::Create(Ctx, "__orc_tier.up.block", &F, &ProgramEntry);
+    BasicBlock *CountBlock =
+        BasicBlock::Create(Ctx, "__orc_tier.count.block", &F, TierUpBlock);
+    assert(CountBlock == &F.getEntryBlock() && "CountBlock not updated?");
+
+    Builder.SetInsertPoint(CountBlock);
+    Value *Count = Builder.CreateAtomicRMW(
+        AtomicRMWInst::Add, Counter, ConstantInt::get(Int64Ty, 1),
+        MaybeAlign(8), AtomicOrdering::Monotonic);
+    Value *IsHot = Builder.CreateICmpEQ(
+        Count, ConstantInt::get(Int64Ty, HotCallCount - 1), "is.hot");
+    Builder.CreateCondBr(IsHot, TierUpBlock, &ProgramEntry);
+
+    Builder.SetInsertPoint(TierUpBlock);
+    Builder.CreateCall(TierUp,
+                       {LayerAddr, ConstantInt::get(Int64Ty, CandidateId)});
+    Builder.CreateBr(&ProgramEntry);
+  }
+}
+
+void TieredCompileLayer::tierUp(uint64_t CandidateId) {
+  TierUpCandidate C;
+  {
+    std::lock_guard<std::mutex> Lock(LayerMutex);
+    if (CandidateId >= Candidates.size() || Candidates[CandidateId].Promoted)
+      return;
+    Candidates[CandidateId].Promoted = true;
+    C = Candidates[CandidateId];
+  }
+
+  LLVM_DEBUG(dbgs() << "Tiering up " << C.IRName << "\n");
+  getExecutionSession().dispatchTask(makeGenericNamedTask(
+      [this, C = std::move(C)]() mutable { compileTier1(std::move(C)); },
+      "Tier-up compilation"));
+}
+
+void TieredCompileLayer::compileTier1(TierUpCandidate C) {
+  auto &ES = getExecutionSession();
+  auto &PDR = getPerDylibResources(*C.TargetD);
+
+  // Keep only the hot function, renamed so it does not clash with the first
+  // tier, and the internal functions it may call. Everything else is
+  // referenced through the existing definitions.
+  std::string Tier1IRName = C.IRName + ".tier1";
+  ThreadSafeModule TSM = cloneToNewContext(*C.Source);
+  SymbolStringPtr Tier1Name = TSM.withModuleDo([&](Module &M) {
+    for (auto *Name : {"llvm.global_ctors", "llvm.global_dtors"})
+      if (GlobalVariable *GV = M.getNamedGlobal(Name))
+        GV->eraseFromParent();
+
+    for (GlobalVariable &GV : M.globals()) {
+      if (GV.isDeclaration() || GV.hasLocalLinkage())
+        continue;
+      GV.setInitializer(nullptr);
+      GV.setLinkage(GlobalValue::ExternalLinkage);
+      GV.setComdat(nullptr);
+    }
+
+    for (Function &F : M) {
+      if (F.isDeclaration() || F.hasLocalLinkage())
+        continue;
+      if (F.getName() == C.IRName) {
+        F.setName(Tier1IRName);
+        F.setLinkage(GlobalValue::ExternalLinkage);
+        F.setVisibility(GlobalValue::HiddenVisibility);
+      } else {
+        F.deleteBody();
+      }
+      F.setComdat(nullptr);
+    }
+
+    assert(!verifyModule(M) && "Tier-up module is broken?");
+    return MangleAndInterner(ES, M.getDataLayout())(Tier1IRName);
+  });
+
+  auto MU = std::make_unique<BasicIRLayerMaterializationUnit>(
+      Tier1Layer, *Tier1Layer.getManglingOptions(), std::move(TSM));
+  MU->setPriority(Tier1Priority);
+  if (auto Err = PDR.getImplDylib().define(std::move(MU))) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+
+  // Point the stub at the second tier once it is ready.
+  IndirectStubsManager &ISM = PDR.getISManager();
+  ES.lookup(
+      LookupKind::Static,
+      makeJITDylibSearchOrder(&PDR.getImplDylib(),
+                              JITDylibLookupFlags::MatchAllSymbols),
+      SymbolLookupSet(Tier1Name), SymbolState::Ready,
+      [&ES, &ISM, Tier1Name, StubName = C.StubName](
+          Expected<SymbolMap> Result) {
+        if (!Result) {
+          ES.reportError(Result.takeError());
+          return;
+        }
+        if (auto Err =
+                ISM.updatePointer(*StubName, (*Result)[Tier1Name].getAddress()))
+          ES.reportError(std::move(Err));
+      },
+      NoDependenciesToRegister);
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -9,10 +9,29 @@
 #include "llvm/IR/PassManager.h"
 #include "llvm/ADT/DenseMapInfo.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/IR/PassManagerImpl.h"
+#include "llvm/Support/CommandLine.h"
 
 using namespace llvm;
 
+cl::opt<bool> PreserveUnchangedCFGAnalyses(
+    "preserve-unchanged-cfg-analyses", cl::Hidden, cl::init(false),
+    cl::desc("Keep the CFG analyses of a function, such as the dominator "
+             "tree and loop info, after any function pass that leaves the "
+             "CFG unchanged"));
+
+/// Records the blocks of \p F and their successors in layout order.
+static void snapshotCFG(const Function &F,
+                        SmallVectorImpl<const BasicBlock *> &Snapshot) {
+  Snapshot.clear();
+  for (const BasicBlock &BB : F) {
+    Snapshot.push_back(&BB);
+    Snapshot.append(succ_begin(&BB), succ_end(&BB));
+    Snapshot.push_back(nullptr);
+  }
+}
+
 namespace llvm {
 // Explicit template instantiations and specialization defininitions for core
 // template typedefs.
@@ -25,6 +44,68 @@ template class AnalysisManager<Function>;
 template class InnerAnalysisManagerProxy<FunctionAnalysisManager, Module>;
 template class OuterAnalysisManagerProxy<ModuleAnalysisManager, Function>;
 
+template <>
+PreservedAnalyses
+PassManager<Function>::run(Function &F, FunctionAnalysisManager &AM) {
+  PreservedAnalyses PA = PreservedAnalyses::all();
+
+  // Request PassInstrumentation from analysis manager, will use it to run
+  // instrumenting callbacks for the passes later.
+  PassInstrumentation PI = AM.getResult<PassInstrumentationAnalysis>(F);
+
+  // Passes often report the CFG analyses as abandoned whenever they change
+  // anything, or whenever they might have changed the CFG. Those analyses
+  // (and nothing else) only depend on the blocks and edges of the function,
+  // so checking that these are unchanged is enough to keep them.
+  SmallVector<const BasicBlock *, 64> CFGBefore, CFGAfter;
+
+  for (unsigned Idx = 0, Size = Passes.size(); Idx != Size; ++Idx) {
+    auto *P = Passes[Idx].get();
+
+    // Check the PassInstrumentation's BeforePass callbacks before running the
+    // pass, skip its execution completely if asked to (callback returns
+    // false).
+    if (!PI.runBeforePass<Function>(*P, F))
+      continue;
+
+    if (PreserveUnchangedCFGAnalyses)
+      snapshotCFG(F, CFGBefore);
+
+    PreservedAnalyses PassPA;
+    {
+      TimeTraceScope TimeScope(P->name(), F.getName());
+      PassPA = P->run(F, AM);
+    }
+
+    if (PreserveUnchangedCFGAnalyses &&
+        !PassPA.allAnalysesInSetPreserved<CFGAnalyses>()) {
+      snapshotCFG(F, CFGAfter);
+      if (CFGBefore == CFGAfter)
+        PassPA.preserveSet<CFGAnalyses>();
+    }
+
+    // Call onto PassInstrumentation's AfterPass callbacks immediately after
+    // running the pass.
+    PI.runAfterPass<Function>(*P, F, PassPA);
+
+    // Update the analysis manager as each pass runs and potentially
+    // invalidates analyses.
+    AM.invalidate(F, PassPA);
+
+    // Finally, intersect the preserved analyses to compute the aggregate
+    // preserved set for this pass manager.
+    PA.intersect(std::move(PassPA));
+  }
+
+  // Invalidation was handled after each pass in the above loop for the
+  // current unit of IR. Therefore, the remaining analysis results in the
+  // AnalysisManager are preserved. We mark this with a set so that we don't
+  // need to inspect each one individually.
+  PA.preserveSet<AllAnalysesOn<Function>>();
+
+  return PA;
+}
+
 template <>
 bool FunctionAnalysisManagerModuleProxy::Result::invalidate(
     Module &M, const PreservedAnalyses &PA,
@@ -19,23 +19,115 @@ void Use::swap(Use &RHS) {
   if (Val == RHS.Val)
     return;
 
+  // Swap only the pointer part of Prev; with compact uses, its tag belongs to
+  // the position of the Use in its operand array.
   std::swap(Val, RHS.Val);
   std::swap(Next, RHS.Next);
-  std::swap(Prev, RHS.Prev);
+  Use **OldPrev = getPrev();
+  setPrev(RHS.getPrev());
+  RHS.setPrev(OldPrev);
 
-  *Prev = this;
+  *getPrev() = this;
   if (Next)
-    Next->Prev = &Next;
+    Next->setPrev(&Next);
 
-  *RHS.Prev = &RHS;
+  *RHS.getPrev() = &RHS;
   if (RHS.Next)
-    RHS.Next->Prev = &RHS.Next;
+    RHS.Next->setPrev(&RHS.Next);
 }
 
 unsigned Use::getOperandNo() const {
   return this - getUser()->op_begin();
 }
 
+#ifdef LLVM_COMPACT_USES
+// The tags of the Uses of an operand array spell out, from its end, a
+// sequence of stops and binary numbers. Starting at any Use, getImpliedUser()
+// scans forward to the next stop; the digits that follow it give the distance
+// from there to the end of the array, or the end is found by reaching the full
+// stop after the last Use. Either way, only a logarithmic number of Uses is
+// visited.
+const Use *Use::getImpliedUser() const {
+  const Use *Current = this;
+
+  while (true) {
+    unsigned Tag = (Current++)->Prev.getInt();
+    switch (Tag) {
+    case zeroDigitTag:
+    case oneDigitTag:
+      continue;
+
+    case stopTag: {
+      ++Current;
+      ptrdiff_t Offset = 1;
+      while (true) {
+        unsigned Tag = Current->Prev.getInt();
+        switch (Tag) {
+        case zeroDigitTag:
+        case oneDigitTag:
+          ++Current;
+          Offset = (Offset << 1) + Tag;
+          continue;
+        default:
+          return Current + Offset;
+        }
+      }
+    }
+
+    case fullStopTag:
+      return Current;
+    }
+  }
+}
+
+User *Use::getUser() const {
+  const Use *End = getImpliedUser();
+  const UserRef *Ref = reinterpret_cast<const UserRef *>(End);
+  return Ref->getInt() ? Ref->getPointer()
+                       : reinterpret_cast<User *>(const_cast<Use *>(End));
+}
+
+void Use::initOperands(Use *Start, Use *Stop, User *Parent, bool HungOff) {
+  assert((HungOff || reinterpret_cast<User *>(Stop) == Parent) &&
+         "the operands of a User must directly precede it");
+  if (HungOff)
+    new (Stop) UserRef(Parent, 1);
+
+  // The last 20 Uses get a fixed pattern, so that arrays of up to that many
+  // operands need no counting at all.
+  ptrdiff_t Done = 0;
+  while (Done < 20) {
+    if (Start == Stop--)
+      return;
+    static const PrevPtrTag Tags[20] = {
+        fullStopTag,  oneDigitTag,  stopTag,      oneDigitTag, oneDigitTag,
+        stopTag,      zeroDigitTag, oneDigitTag,  oneDigitTag, stopTag,
+        zeroDigitTag, oneDigitTag,  zeroDigitTag, oneDigitTag, stopTag,
+        oneDigitTag,  oneDigitTag,  oneDigitTag,  oneDigitTag, stopTag};
+    new (Stop) Use(Tags[Done++]);
+  }
+
+  ptrdiff_t Count = Done;
+  while (Start != Stop) {
+    --Stop;
+    if (!Count) {
+      new (Stop) Use(stopTag);
+      ++Done;
+      Count = Done;
+    } else {
+      new (Stop) Use(PrevPtrTag(Count & 1));
+      Count >>= 1;
+      ++Done;
+    }
+  }
+}
+#else
+void Use::initOperands(Use *Start, Use *Stop, User *Parent, bool HungOff) {
+  for (; Start != Stop; ++Start)
+    new (Start) Use(Parent);
+}
+#endif
+
 void Use::zap(Use *Start, const Use *Stop, bool del) {
   while (Start != Stop)
     (--Stop)->~Use();
@@ -48,14 +48,13 @@ void User::allocHungoffUses(unsigned N, bool IsPhi) {
                 "Alignment is insufficient for 'hung-off-uses' pieces");
 
   // Allocate the array of Uses
-  size_t size = N * sizeof(Use);
+  size_t size = N * sizeof(Use) + Use::HungOffTrailerSize;
   if (IsPhi)
     size += N * sizeof(BasicBlock *);
   Use *Begin = static_cast<Use*>(::operator new(size));
   Use *End = Begin + N;
   setOperandList(Begin);
-  for (; Begin != End; Begin++)
-    new (Begin) Use(this);
+  Use::initOperands(Begin, End, this, /*HungOff=*/true);
 }
 
 void User::growHungoffUses(unsigned NewNumUses, bool IsPhi) {
@@ -76,8 +75,10 @@ void User::growHungoffUses(unsigned NewNumUses, bool IsPhi) {
 
   // If this is a Phi, then we need to copy the BB pointers too.
   if (IsPhi) {
-    auto *OldPtr = reinterpret_cast<char *>(OldOps + OldNumUses);
-    auto *NewPtr = reinterpret_cast<char *>(NewOps + NewNumUses);
+    auto *OldPtr =
+        reinterpret_cast<char *>(OldOps + OldNumUses) + Use::HungOffTrailerSize;
+    auto *NewPtr =
+        reinterpret_cast<char *>(NewOps + NewNumUses) + Use::HungOffTrailerSize;
     std::copy(OldPtr, OldPtr + (OldNumUses * sizeof(BasicBlock *)), NewPtr);
   }
   Use::zap(OldOps, OldOps + OldNumUses, true);
@@ -133,8 +134,7 @@ void *User::allocateFixedOperandUser(size_t Size, unsigned Us,
   Obj->NumUserOperands = Us;
   Obj->HasHungOffUses = false;
   Obj->HasDescriptor = DescBytes != 0;
-  for (; Start != End; Start++)
-    new (Start) Use(Obj);
+  Use::initOperands(Start, End, Obj, /*HungOff=*/false);
 
   if (DescBytes != 0) {
     auto *DescInfo = reinterpret_cast<DescriptorInfo *>(Storage + DescBytes);
@@ -162,7 +162,9 @@ void llvm::computeLTOCacheKey(
 
   // Include the hash for every module we import functions from. The set of
   // imported symbols for each module may affect code generation and is
-  // sensitive to link order, so include that as well.
+  // sensitive to link order, so include that as well. The order in which the
+  // symbols are imported doesn't, so hash them in a canonical order rather
+  // than the iteration order of the set.
   using ImportMapIteratorTy = FunctionImporter::ImportMapTy::const_iterator;
   std::vector<ImportMapIteratorTy> ImportModulesVector;
   ImportModulesVector.reserve(ImportList.size());
@@ -179,7 +181,10 @@ void llvm::computeLTOCacheKey(
     Hasher.update(ArrayRef<uint8_t>((uint8_t *)&ModHash[0], sizeof(ModHash)));
 
     AddUint64(EntryIt->second.size());
-    for (auto &Fn : EntryIt->second)
+    std::vector<GlobalValue::GUID> ImportedGUIDs(EntryIt->second.begin(),
+                                                 EntryIt->second.end());
+    llvm::sort(ImportedGUIDs);
+    for (GlobalValue::GUID Fn : ImportedGUIDs)
       AddUint64(Fn);
   }
 
@@ -1561,15 +1566,23 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
       if (Error E = ProcessOneModule(I))
         return E;
   } else {
-    // When executing in parallel, process largest bitsize modules first to
+    // When executing in parallel, process the most expensive modules first to
     // improve parallelism, and avoid starving the thread pool near the end.
     // This saves about 15 sec on a 36-core machine while link `clang.exe` (out
-    // of 100 sec).
+    // of 100 sec). The cost of a module is estimated from the instruction
+    // counts in the summary, which, unlike the bitcode size, accounts for the
+    // functions imported into it.
     std::vector<BitcodeModule *> ModulesVec;
+    std::vector<uint64_t> Costs;
     ModulesVec.reserve(ModuleMap.size());
-    for (auto &Mod : ModuleMap)
+    Costs.reserve(ModuleMap.size());
+    for (auto &Mod : ModuleMap) {
       ModulesVec.push_back(&Mod.second);
-    for (int I : generateModulesOrdering(ModulesVec))
+      Costs.push_back(estimateThinLTOBackendCost(
+          ThinLTO.CombinedIndex, ModuleToDefinedGVSummaries[Mod.first],
+          ImportLists[Mod.first]));
+    }
+    for (int I : generateModulesOrdering(ModulesVec, Costs))
       if (Error E = ProcessOneModule(I))
         return E;
   }
@@ -1631,3 +1644,40 @@ std::vector<int> lto::generateModulesOrdering(ArrayRef<BitcodeModule *> R) {
   });
   return ModulesOrdering;
 }
+
+std::vector<int> lto::generateModulesOrdering(ArrayRef<BitcodeModule *> R,
+                                              ArrayRef<uint64_t> Costs) {
+  assert(R.size() == Costs.size());
+  std::vector<int> ModulesOrdering;
+  ModulesOrdering.resize(R.size());
+  std::iota(ModulesOrdering.begin(), ModulesOrdering.end(), 0);
+  llvm::sort(ModulesOrdering, [&](int LeftIndex, int RightIndex) {
+    if (Costs[LeftIndex] != Costs[RightIndex])
+      return Costs[LeftIndex] > Costs[RightIndex];
+    auto LSize = R[LeftIndex]->getBuffer().size();
+    auto RSize = R[RightIndex]->getBuffer().size();
+    return LSize > RSize;
+  });
+  return ModulesOrdering;
+}
+
+static uint64_t getInstCount(const GlobalValueSummary *S) {
+  if (const auto *FS = dyn_cast<FunctionSummary>(S->getBaseObject()))
+    return FS->instCount();
+  return 0;
+}
+
+uint64_t lto::estimateThinLTOBackendCost(
+    const ModuleSummaryIndex &CombinedIndex,
+    const GVSummaryMapTy &DefinedGlobals,
+    const FunctionImporter::ImportMapTy &ImportList) {
+  uint64_t Cost = 0;
+  for (const auto &GV : DefinedGlobals)
+    Cost += getInstCount(GV.second);
+  for (const auto &FromModule : ImportList)
+    for (GlobalValue::GUID GUID : FromModule.second)
+      if (const GlobalValueSummary *S =
+              CombinedIndex.findSummaryInModule(GUID, FromModule.first()))
+        Cost += getInstCount(S);
+  return Cost;
+}
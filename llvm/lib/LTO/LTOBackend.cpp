@@ -212,7 +212,8 @@ createTargetMachine(const Config &Conf, const Target *TheTarget, Module &M) {
 static void runNewPMPasses(const Config &Conf, Module &Mod, TargetMachine *TM,
                            unsigned OptLevel, bool IsThinLTO,
                            ModuleSummaryIndex *ExportSummary,
-                           const ModuleSummaryIndex *ImportSummary) {
+                           const ModuleSummaryIndex *ImportSummary,
+                           StringRef OptPipeline) {
   Optional<PGOOptions> PGOOpt;
   if (!Conf.SampleProfile.empty())
     PGOOpt = PGOOptions(Conf.SampleProfile, "", Conf.ProfileRemapping,
@@ -293,10 +294,10 @@ static void runNewPMPasses(const Config &Conf, Module &Mod, TargetMachine *TM,
   }
 
   // Parse a custom pipeline if asked to.
-  if (!Conf.OptPipeline.empty()) {
-    if (auto Err = PB.parsePassPipeline(MPM, Conf.OptPipeline)) {
+  if (!OptPipeline.empty()) {
+    if (auto Err = PB.parsePassPipeline(MPM, OptPipeline)) {
       report_fatal_error(Twine("unable to parse pass pipeline description '") +
-                         Conf.OptPipeline + "': " + toString(std::move(Err)));
+                         OptPipeline + "': " + toString(std::move(Err)));
     }
   } else if (IsThinLTO) {
     MPM.addPass(PB.buildThinLTODefaultPipeline(OL, ImportSummary));
@@ -367,7 +368,7 @@ bool lto::opt(const Config &Conf, TargetMachine *TM, unsigned Task, Module &Mod,
   // FIXME: Plumb the combined index into the new pass manager.
   if (Conf.UseNewPM || !Conf.OptPipeline.empty()) {
     runNewPMPasses(Conf, Mod, TM, Conf.OptLevel, IsThinLTO, ExportSummary,
-                   ImportSummary);
+                   ImportSummary, Conf.OptPipeline);
   } else {
     runOldPMPasses(Conf, Mod, TM, IsThinLTO, ExportSummary, ImportSummary);
   }
@@ -431,6 +432,15 @@ static void codegen(const Config &Conf, TargetMachine *TM,
     DwoOut->keep();
 }
 
+/// Runs Conf.PartitionOptPipeline, if any, on a code generation partition.
+static void optPartition(const Config &Conf, TargetMachine *TM, Module &Mod) {
+  if (Conf.PartitionOptPipeline.empty())
+    return;
+  runNewPMPasses(Conf, Mod, TM, Conf.OptLevel, /*IsThinLTO=*/false,
+                 /*ExportSummary=*/nullptr, /*ImportSummary=*/nullptr,
+                 Conf.PartitionOptPipeline);
+}
+
 static void splitCodeGen(const Config &C, TargetMachine *TM,
                          AddStreamFn AddStream,
                          unsigned ParallelCodeGenParallelismLevel, Module &Mod,
@@ -467,6 +477,7 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
               std::unique_ptr<TargetMachine> TM =
                   createTargetMachine(C, T, *MPartInCtx);
 
+              optPartition(C, TM.get(), *MPartInCtx);
               codegen(C, TM.get(), AddStream, ThreadId, *MPartInCtx,
                       CombinedIndex);
             },
@@ -524,6 +535,7 @@ Error lto::backend(const Config &C, AddStreamFn AddStream,
   }
 
   if (ParallelCodeGenParallelismLevel == 1) {
+    optPartition(C, TM.get(), Mod);
     codegen(C, TM.get(), AddStream, 0, Mod, CombinedIndex);
   } else {
     splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel, Mod,
@@ -21,6 +21,7 @@
 #include "llvm/Object/ModuleSymbolTable.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include <utility>
 using namespace llvm;
@@ -1513,23 +1514,29 @@ Error IRLinker::run() {
   DstM.setTargetTriple(SrcTriple.merge(DstTriple));
 
   // Loop over all of the linked values to compute type mappings.
-  computeTypeMapping();
+  {
+    TimeTraceScope TimeScope("Compute type mapping");
+    computeTypeMapping();
+  }
 
-  std::reverse(Worklist.begin(), Worklist.end());
-  while (!Worklist.empty()) {
-    GlobalValue *GV = Worklist.back();
-    Worklist.pop_back();
+  {
+    TimeTraceScope TimeScope("Link global values");
+    std::reverse(Worklist.begin(), Worklist.end());
+    while (!Worklist.empty()) {
+      GlobalValue *GV = Worklist.back();
+      Worklist.pop_back();
 
-    // Already mapped.
-    if (ValueMap.find(GV) != ValueMap.end() ||
-        IndirectSymbolValueMap.find(GV) != IndirectSymbolValueMap.end())
-      continue;
+      // Already mapped.
+      if (ValueMap.find(GV) != ValueMap.end() ||
+          IndirectSymbolValueMap.find(GV) != IndirectSymbolValueMap.end())
+        continue;
 
-    assert(!GV->isDeclaration());
-    Mapper.mapValue(*GV);
-    if (FoundError)
-      return std::move(*FoundError);
-    flushRAUWWorklist();
+      assert(!GV->isDeclaration());
+      Mapper.mapValue(*GV);
+      if (FoundError)
+        return std::move(*FoundError);
+      flushRAUWWorklist();
+    }
   }
 
   // Note that we are done linking global value bodies. This prevents
@@ -1540,7 +1547,10 @@ Error IRLinker::run() {
   // Remap all of the named MDNodes in Src into the DstM module. We do this
   // after linking GlobalValues so that MDNodes that reference GlobalValues
   // are properly remapped.
-  linkNamedMDNodes();
+  {
+    TimeTraceScope TimeScope("Link named metadata");
+    linkNamedMDNodes();
+  }
 
   if (!IsPerformingImport && !SrcM->getModuleInlineAsm().empty()) {
     // Append the module inline asm string.
@@ -1677,6 +1687,7 @@ Error IRMover::move(
     std::unique_ptr<Module> Src, ArrayRef<GlobalValue *> ValuesToLink,
     std::function<void(GlobalValue &, ValueAdder Add)> AddLazyFor,
     bool IsPerformingImport) {
+  TimeTraceScope TimeScope("Move module", Src->getModuleIdentifier());
   IRLinker TheIRLinker(Composite, SharedMDs, IdentifiedStructTypes,
                        std::move(Src), ValuesToLink, std::move(AddLazyFor),
                        IsPerformingImport);
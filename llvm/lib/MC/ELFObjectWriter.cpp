@@ -39,6 +39,7 @@
 #include "llvm/Support/Alignment.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Error.h"
@@ -46,6 +47,7 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SwapByteOrder.h"
@@ -67,6 +69,12 @@ using namespace llvm;
 
 namespace {
 
+static cl::opt<bool> ParallelCompressDebugSections(
+    "elf-parallel-compress-debug-sections", cl::Hidden,
+    cl::desc("Compress the debug sections of an ELF object in parallel"),
+    cl::init(false));
+
+
 using SectionIndexMapTy = DenseMap<const MCSectionELF *, uint32_t>;
 
 class ELFObjectWriter;
@@ -150,6 +158,28 @@ struct ELFWriter {
                              SmallVectorImpl<char> &CompressedContents,
                              bool ZLibStyle, unsigned Alignment);
 
+  /// The contents of a debug section before and after compression.
+  struct CompressedSectionData {
+    SmallVector<char, 0> Uncompressed;
+    SmallVector<char, 0> Compressed;
+    bool Succeeded = false;
+
+    void compress() {
+      Error E = zlib::compress(
+          StringRef(Uncompressed.data(), Uncompressed.size()), Compressed);
+      Succeeded = !E;
+      consumeError(std::move(E));
+    }
+  };
+
+  /// Debug sections compressed ahead of writeSectionData().
+  DenseMap<const MCSectionELF *, CompressedSectionData> PrecompressedSections;
+
+  bool shouldCompressSection(const MCAssembler &Asm,
+                             const MCSectionELF &Section) const;
+  void precompressDebugSections(const MCAssembler &Asm,
+                                const MCAsmLayout &Layout);
+
 public:
   ELFWriter(ELFObjectWriter &OWriter, raw_pwrite_stream &OS,
             bool IsLittleEndian, DwoMode Mode)
@@ -860,6 +890,38 @@ bool ELFWriter::maybeWriteCompression(
   return true;
 }
 
+bool ELFWriter::shouldCompressSection(const MCAssembler &Asm,
+                                      const MCSectionELF &Section) const {
+  StringRef SectionName = Section.getName();
+  const auto &MAI = Asm.getContext().getAsmInfo();
+
+  // Compressing debug_frame requires handling alignment fragments which is
+  // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
+  // for writing to arbitrary buffers) for little benefit.
+  return MAI->compressDebugSections() != DebugCompressionType::None &&
+         SectionName.startswith(".debug_") && SectionName != ".debug_frame";
+}
+
+void ELFWriter::precompressDebugSections(const MCAssembler &Asm,
+                                         const MCAsmLayout &Layout) {
+  // Serializing the sections reads assembler state, so it stays on this
+  // thread; only the compression itself, which dominates, runs in parallel.
+  std::vector<CompressedSectionData *> Work;
+  for (const MCSection &Sec : Asm) {
+    const auto &Section = static_cast<const MCSectionELF &>(Sec);
+    if ((Mode == NonDwoOnly && isDwoSection(Section)) ||
+        (Mode == DwoOnly && !isDwoSection(Section)) ||
+        !shouldCompressSection(Asm, Section))
+      continue;
+    CompressedSectionData &Data = PrecompressedSections[&Section];
+    raw_svector_ostream VecOS(Data.Uncompressed);
+    Asm.writeSectionData(VecOS, &Section, Layout);
+  }
+  for (auto &Entry : PrecompressedSections)
+    Work.push_back(&Entry.second);
+  parallelForEach(Work, [](CompressedSectionData *Data) { Data->compress(); });
+}
+
 void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
                                  const MCAsmLayout &Layout) {
   MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
@@ -868,13 +930,7 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
   auto &MC = Asm.getContext();
   const auto &MAI = MC.getAsmInfo();
 
-  // Compressing debug_frame requires handling alignment fragments which is
-  // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
-  // for writing to arbitrary buffers) for little benefit.
-  bool CompressionEnabled =
-      MAI->compressDebugSections() != DebugCompressionType::None;
-  if (!CompressionEnabled || !SectionName.startswith(".debug_") ||
-      SectionName == ".debug_frame") {
+  if (!shouldCompressSection(Asm, Section)) {
     Asm.writeSectionData(W.OS, &Section, Layout);
     return;
   }
@@ -883,15 +939,20 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
           MAI->compressDebugSections() == DebugCompressionType::GNU) &&
          "expected zlib or zlib-gnu style compression");
 
-  SmallVector<char, 128> UncompressedData;
-  raw_svector_ostream VecOS(UncompressedData);
-  Asm.writeSectionData(VecOS, &Section, Layout);
+  CompressedSectionData LocalData;
+  CompressedSectionData *Data = &LocalData;
+  auto It = PrecompressedSections.find(&Section);
+  if (It != PrecompressedSections.end()) {
+    Data = &It->second;
+  } else {
+    raw_svector_ostream VecOS(LocalData.Uncompressed);
+    Asm.writeSectionData(VecOS, &Section, Layout);
+    LocalData.compress();
+  }
 
-  SmallVector<char, 128> CompressedContents;
-  if (Error E = zlib::compress(
-          StringRef(UncompressedData.data(), UncompressedData.size()),
-          CompressedContents)) {
-    consumeError(std::move(E));
+  SmallVectorImpl<char> &UncompressedData = Data->Uncompressed;
+  SmallVectorImpl<char> &CompressedContents = Data->Compressed;
+  if (!Data->Succeeded) {
     W.OS << UncompressedData;
     return;
   }
@@ -1101,6 +1162,9 @@ uint64_t ELFWriter::writeObject(MCAssembler &Asm, const MCAsmLayout &Layout) {
   // Write out the ELF header ...
   writeHeader(Asm);
 
+  if (ParallelCompressDebugSections)
+    precompressDebugSections(Asm, Layout);
+
   // ... then the sections ...
   SectionOffsetsTy SectionOffsets;
   std::vector<MCSectionELF *> Groups;
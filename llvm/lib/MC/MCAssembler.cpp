@@ -69,6 +69,8 @@ STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(RelaxationSectionsSkipped,
+          "Number of sections without relaxable fragments");
 
 } // end namespace stats
 } // end anonymous namespace
@@ -805,6 +807,23 @@ MCAssembler::handleFixup(const MCAsmLayout &Layout, MCFragment &F,
   return std::make_tuple(Target, FixedValue, IsResolved);
 }
 
+/// Returns true if relaxFragment() may change the size of \p F.
+static bool mayRelaxFragment(const MCFragment &F) {
+  switch (F.getKind()) {
+  default:
+    return false;
+  case MCFragment::FT_Relaxable:
+  case MCFragment::FT_Dwarf:
+  case MCFragment::FT_DwarfFrame:
+  case MCFragment::FT_LEB:
+  case MCFragment::FT_BoundaryAlign:
+  case MCFragment::FT_CVInlineLines:
+  case MCFragment::FT_CVDefRange:
+  case MCFragment::FT_PseudoProbe:
+    return true;
+  }
+}
+
 void MCAssembler::layout(MCAsmLayout &Layout) {
   assert(getBackendPtr() && "Expected assembler backend");
   DEBUG_WITH_TYPE("mc-dump", {
@@ -828,8 +847,16 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
     Sec->setLayoutOrder(i);
 
     unsigned FragmentIndex = 0;
-    for (MCFragment &Frag : *Sec)
+    bool HasRelaxableFragments = false;
+    for (MCFragment &Frag : *Sec) {
       Frag.setLayoutOrder(FragmentIndex++);
+      HasRelaxableFragments |= mayRelaxFragment(Frag);
+    }
+    // Relaxation only ever changes the size of relaxable fragments, so
+    // sections without any are never visited by the relaxation loop.
+    Sec->setHasRelaxableFragments(HasRelaxableFragments);
+    if (!HasRelaxableFragments)
+      ++stats::RelaxationSectionsSkipped;
   }
 
   // Layout until everything fits.
@@ -1165,6 +1192,7 @@ bool MCAssembler::relaxPseudoProbeAddr(MCAsmLayout &Layout,
 }
 
 bool MCAssembler::relaxFragment(MCAsmLayout &Layout, MCFragment &F) {
+  // Keep in sync with mayRelaxFragment().
   switch(F.getKind()) {
   default:
     return false;
@@ -1216,6 +1244,8 @@ bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
 
   bool WasRelaxed = false;
   for (MCSection &Sec : *this) {
+    if (!Sec.hasRelaxableFragments())
+      continue;
     while (layoutSectionOnce(Layout, Sec))
       WasRelaxed = true;
   }
@@ -12,12 +12,15 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
-#include "llvm/IR/LLVMContext.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Object/Error.h"
+#include "llvm/Object/IRObjectFile.h"
+#include "llvm/Object/IRSymtab.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Object/SymbolicFile.h"
 #include "llvm/Support/Alignment.h"
@@ -25,6 +28,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -366,32 +370,41 @@ static void writeSymbolTable(raw_ostream &Out, object::Archive::Kind Kind,
     Out.write(uint8_t(0));
 }
 
-static Expected<std::vector<unsigned>>
-getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
+// Returns the symbols of a bitcode file from its irsymtab, which lists the
+// symbols of an IRObjectFile with the same flags. The modules are only parsed
+// when the irsymtab is missing or was written by another producer.
+static Expected<std::vector<unsigned>> getIRSymbols(MemoryBufferRef Buf,
+                                                    raw_ostream &SymNames) {
   std::vector<unsigned> Ret;
+  Expected<object::IRSymtabFile> FileOrErr = object::readIRSymtab(Buf);
+  if (!FileOrErr)
+    return FileOrErr.takeError();
+  for (const irsymtab::Reader::SymbolRef &S : FileOrErr->TheReader.symbols()) {
+    if (!S.isGlobal() || S.isFormatSpecific() || S.isUndefined())
+      continue;
+    Ret.push_back(SymNames.tell());
+    SymNames << S.getName() << '\0';
+  }
+  return Ret;
+}
 
-  // In the scenario when LLVMContext is populated SymbolicFile will contain a
-  // reference to it, thus SymbolicFile should be destroyed first.
-  LLVMContext Context;
-  std::unique_ptr<object::SymbolicFile> Obj;
-
+static Expected<std::vector<unsigned>>
+getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
   const file_magic Type = identify_magic(Buf.getBuffer());
-  // Treat unsupported file types as having no symbols.
-  if (!object::SymbolicFile::isSymbolicFile(Type, &Context))
-    return Ret;
   if (Type == file_magic::bitcode) {
-    auto ObjOrErr = object::SymbolicFile::createSymbolicFile(
-        Buf, file_magic::bitcode, &Context);
-    if (!ObjOrErr)
-      return ObjOrErr.takeError();
-    Obj = std::move(*ObjOrErr);
-  } else {
-    auto ObjOrErr = object::SymbolicFile::createSymbolicFile(Buf);
-    if (!ObjOrErr)
-      return ObjOrErr.takeError();
-    Obj = std::move(*ObjOrErr);
+    HasObject = true;
+    return getIRSymbols(Buf, SymNames);
   }
 
+  std::vector<unsigned> Ret;
+  // Treat unsupported file types as having no symbols.
+  if (!object::SymbolicFile::isSymbolicFile(Type, nullptr))
+    return Ret;
+  auto ObjOrErr = object::SymbolicFile::createSymbolicFile(Buf);
+  if (!ObjOrErr)
+    return ObjOrErr.takeError();
+  std::unique_ptr<object::SymbolicFile> Obj = std::move(*ObjOrErr);
+
   HasObject = true;
   for (const object::BasicSymbolRef &S : Obj->symbols()) {
     if (!isArchiveSymbol(S))
@@ -404,6 +417,58 @@ getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
   return Ret;
 }
 
+namespace {
+// The symbols of a member, with their names in a buffer of their own.
+struct MemberSymbols {
+  SmallString<0> Names;
+  std::vector<unsigned> Offsets;
+  bool HasObject = false;
+  Error Err = Error::success();
+};
+} // namespace
+
+// Reads the symbols of the members in parallel: creating a SymbolicFile for
+// each member is most of the time spent on archives with many members. The
+// names are then appended to SymNames in member order, so the output does not
+// depend on the scheduling.
+static Expected<std::vector<std::vector<unsigned>>>
+getMemberSymbols(raw_ostream &SymNames, bool &HasObject,
+                 ArrayRef<NewArchiveMember> NewMembers) {
+  std::vector<MemberSymbols> Symbols(NewMembers.size());
+  parallelForEachN(0, NewMembers.size(), [&](size_t I) {
+    MemberSymbols &MS = Symbols[I];
+    raw_svector_ostream Names(MS.Names);
+    Expected<std::vector<unsigned>> OffsetsOrErr =
+        getSymbols(NewMembers[I].Buf->getMemBufferRef(), Names, MS.HasObject);
+    if (OffsetsOrErr)
+      MS.Offsets = std::move(*OffsetsOrErr);
+    else
+      MS.Err = OffsetsOrErr.takeError();
+  });
+
+  // Report the error of the first member which failed.
+  for (MemberSymbols &MS : Symbols) {
+    if (!MS.Err)
+      continue;
+    Error E = std::move(MS.Err);
+    for (MemberSymbols &Rest : Symbols)
+      consumeError(std::move(Rest.Err));
+    return std::move(E);
+  }
+
+  std::vector<std::vector<unsigned>> Ret;
+  Ret.reserve(Symbols.size());
+  for (MemberSymbols &MS : Symbols) {
+    const uint64_t Base = SymNames.tell();
+    for (unsigned &Offset : MS.Offsets)
+      Offset += Base;
+    SymNames << MS.Names;
+    HasObject |= MS.HasObject;
+    Ret.push_back(std::move(MS.Offsets));
+  }
+  return std::move(Ret);
+}
+
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, bool Deterministic,
@@ -472,7 +537,17 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  std::vector<std::vector<unsigned>> Symbols;
+  if (NeedSymbols) {
+    Expected<std::vector<std::vector<unsigned>>> SymbolsOrErr =
+        getMemberSymbols(SymNames, HasObject, NewMembers);
+    if (auto E = SymbolsOrErr.takeError())
+      return std::move(E);
+    Symbols = std::move(*SymbolsOrErr);
+  }
+
+  for (auto I : llvm::enumerate(NewMembers)) {
+    const NewArchiveMember &M = I.value();
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -508,17 +583,10 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       ModTime, Size);
     Out.flush();
 
-    std::vector<unsigned> Symbols;
-    if (NeedSymbols) {
-      Expected<std::vector<unsigned>> SymbolsOrErr =
-          getSymbols(Buf, SymNames, HasObject);
-      if (auto E = SymbolsOrErr.takeError())
-        return std::move(E);
-      Symbols = std::move(*SymbolsOrErr);
-    }
-
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(Symbols), std::move(Header), Data, Padding});
+    Ret.push_back({NeedSymbols ? std::move(Symbols[I.index()])
+                               : std::vector<unsigned>(),
+                   std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
@@ -158,6 +158,12 @@ static cl::opt<bool> EnableModuleInliner("enable-module-inliner",
                                          cl::init(false), cl::Hidden,
                                          cl::desc("Enable module inliner"));
 
+static cl::opt<bool> EnableModuleInlinerThinLTOPostLink(
+    "enable-module-inliner-thinlto-postlink", cl::init(false), cl::Hidden,
+    cl::desc("Use the module inliner in the ThinLTO post-link pipeline, where "
+             "the imported functions and the profile give it the whole picture "
+             "of the hot call sites"));
+
 static cl::opt<bool> PerformMandatoryInliningsFirst(
     "mandatory-inlining-first", cl::init(true), cl::Hidden, cl::ZeroOrMore,
     cl::desc("Perform mandatory inlinings module-wide, before performing "
@@ -802,6 +808,10 @@ PassBuilder::buildModuleInlinerPipeline(OptimizationLevel Level,
   // inline deferral logic in module inliner.
   IP.EnableDeferral = false;
 
+  // Require the ProfileSummaryAnalysis for the module so we can query it within
+  // the inliner pass.
+  MPM.addPass(RequireAnalysisPass<ProfileSummaryAnalysis, Module>());
+
   MPM.addPass(ModuleInlinerPass(IP, UseInlineAdvisor));
 
   MPM.addPass(createModuleToFunctionPassAdaptor(
@@ -973,7 +983,8 @@ PassBuilder::buildModuleSimplificationPipeline(OptimizationLevel Level,
   if (EnableSyntheticCounts && !PGOOpt)
     MPM.addPass(SyntheticCountsPropagation());
 
-  if (EnableModuleInliner)
+  if (EnableModuleInliner || (EnableModuleInlinerThinLTOPostLink &&
+                              Phase == ThinOrFullLTOPhase::ThinLTOPostLink))
     MPM.addPass(buildModuleInlinerPipeline(Level, Phase));
   else
     MPM.addPass(buildInlinerPipeline(Level, Phase));
@@ -16,6 +16,7 @@
 #include "llvm/ADT/Any.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/LazyCallGraph.h"
 #include "llvm/Analysis/LoopInfo.h"
@@ -164,6 +165,28 @@ static cl::opt<std::string> DotCfgDir(
     cl::desc("Generate dot files into specified directory for changed IRs"),
     cl::Hidden, cl::init("./"));
 
+// Options of the compile-time budget, which gives huge and cold functions a
+// cheaper pipeline by skipping the passes listed by -compile-time-budget-passes
+// on them.
+static cl::opt<unsigned> CompileTimeBudgetMaxInstructions(
+    "compile-time-budget-max-instructions", cl::Hidden, cl::init(0),
+    cl::desc("Skip expensive passes on functions with more instructions than "
+             "this (0 = no limit)"));
+
+static cl::opt<bool> CompileTimeBudgetCold(
+    "compile-time-budget-cold", cl::Hidden, cl::init(false),
+    cl::desc("Skip expensive passes on cold functions"));
+
+static cl::list<std::string> CompileTimeBudgetPasses(
+    "compile-time-budget-passes", cl::value_desc("pass names"),
+    cl::desc("Passes considered expensive by the compile-time budget, "
+             "replacing the default list"),
+    cl::CommaSeparated, cl::Hidden);
+
+static cl::opt<bool> CompileTimeBudgetReport(
+    "compile-time-budget-report", cl::Hidden, cl::init(false),
+    cl::desc("Print the passes skipped by the compile-time budget"));
+
 namespace {
 
 // Perform a system based diff between \p Before and \p After, using
@@ -902,6 +925,83 @@ void OptBisectInstrumentation::registerCallbacks(
   });
 }
 
+// Passes whose running time grows faster than linearly with the size of the
+// function, mostly because of MemorySSA or value numbering queries.
+static bool isExpensivePass(StringRef PassID) {
+  if (!CompileTimeBudgetPasses.empty())
+    return is_contained(CompileTimeBudgetPasses, PassID);
+  return StringSwitch<bool>(PassID)
+      .Cases("GVNPass", "NewGVNPass", "GVNHoistPass", "GVNSinkPass", true)
+      .Cases("DSEPass", "MemCpyOptPass", "MergedLoadStoreMotionPass", true)
+      .Cases("LICMPass", "JumpThreadingPass", "SLPVectorizerPass", true)
+      .Default(false);
+}
+
+// Whether \p F has more than \p Limit instructions, without counting all of
+// them.
+static bool hasMoreInstructionsThan(const Function &F, unsigned Limit) {
+  size_t Count = 0;
+  for (const BasicBlock &BB : F) {
+    Count += BB.size();
+    if (Count > Limit)
+      return true;
+  }
+  return false;
+}
+
+static bool isCold(const Function &F) {
+  if (F.hasFnAttribute(Attribute::Cold))
+    return true;
+  Optional<Function::ProfileCount> EntryCount = F.getEntryCount();
+  return EntryCount && EntryCount->getCount() == 0;
+}
+
+CompileTimeBudgetInstrumentation::~CompileTimeBudgetInstrumentation() {
+  if (!CompileTimeBudgetReport || SkippedPasses.empty())
+    return;
+  std::vector<std::pair<StringRef, unsigned>> Skipped;
+  for (const StringMapEntry<unsigned> &E : SkippedPasses)
+    Skipped.emplace_back(E.getKey(), E.getValue());
+  llvm::sort(Skipped);
+  errs() << "Passes skipped by the compile-time budget:\n";
+  for (const auto &P : Skipped)
+    errs() << formatv("{0,8} {1}\n", P.second, P.first);
+}
+
+void CompileTimeBudgetInstrumentation::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (!CompileTimeBudgetMaxInstructions && !CompileTimeBudgetCold)
+    return;
+  PIC.registerShouldRunOptionalPassCallback(
+      [this](StringRef P, Any IR) { return this->shouldRun(P, IR); });
+}
+
+bool CompileTimeBudgetInstrumentation::shouldRun(StringRef PassID, Any IR) {
+  const Function *F = nullptr;
+  if (any_isa<const Function *>(IR)) {
+    F = any_cast<const Function *>(IR);
+  } else if (any_isa<const Loop *>(IR)) {
+    F = any_cast<const Loop *>(IR)->getHeader()->getParent();
+  }
+  if (!F || !isExpensivePass(PassID))
+    return true;
+
+  const char *Reason = nullptr;
+  if (CompileTimeBudgetMaxInstructions &&
+      hasMoreInstructionsThan(*F, CompileTimeBudgetMaxInstructions))
+    Reason = "its size";
+  else if (CompileTimeBudgetCold && isCold(*F))
+    Reason = "being cold";
+  if (!Reason)
+    return true;
+
+  ++SkippedPasses[PassID];
+  if (DebugLogging)
+    errs() << "Skipping pass " << PassID << " on " << F->getName()
+           << " due to " << Reason << "\n";
+  return false;
+}
+
 raw_ostream &PrintPassInstrumentation::print() {
   if (Opts.Indent) {
     assert(Indent >= 0);
@@ -2107,6 +2207,7 @@ void DotCfgChangeReporter::registerCallbacks(
 StandardInstrumentations::StandardInstrumentations(
     bool DebugLogging, bool VerifyEach, PrintPassOptions PrintPassOpts)
     : PrintPass(DebugLogging, PrintPassOpts), OptNone(DebugLogging),
+      CompileTimeBudget(DebugLogging),
       PrintChangedIR(PrintChanged == ChangePrinter::PrintChangedVerbose),
       PrintChangedDiff(
           PrintChanged == ChangePrinter::PrintChangedDiffVerbose ||
@@ -2124,6 +2225,7 @@ void StandardInstrumentations::registerCallbacks(
   TimePasses.registerCallbacks(PIC);
   OptNone.registerCallbacks(PIC);
   OptBisect.registerCallbacks(PIC);
+  CompileTimeBudget.registerCallbacks(PIC);
   if (FAM)
     PreservedCFGChecker.registerCallbacks(PIC, *FAM);
   PrintChangedIR.registerCallbacks(PIC);
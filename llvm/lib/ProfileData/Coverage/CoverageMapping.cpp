@@ -27,6 +27,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -34,6 +35,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -228,9 +230,40 @@ static unsigned getMaxCounterID(const CounterMappingContext &Ctx,
   return MaxCounterID;
 }
 
-Error CoverageMapping::loadFunctionRecord(
-    const CoverageMappingRecord &Record,
-    IndexedInstrProfReader &ProfileReader) {
+namespace {
+
+/// A coverage mapping record combined with its counts from the profile.
+struct DecodedFunctionRecord {
+  /// The function, or None if the record does not describe one that should
+  /// be reported.
+  Optional<FunctionRecord> Function;
+  /// The hash of the filenames of the record.
+  size_t FilenamesHash = 0;
+  /// The name and hash of the function if the profile has a different hash
+  /// for it.
+  Optional<std::pair<std::string, uint64_t>> HashMismatch;
+
+  DecodedFunctionRecord() = default;
+  DecodedFunctionRecord(DecodedFunctionRecord &&) = default;
+  DecodedFunctionRecord &operator=(DecodedFunctionRecord &&) = default;
+};
+
+/// The decoded function records of one object file.
+struct DecodedObject {
+  /// Whether the object had any coverage data.
+  bool DataFound = false;
+  std::vector<DecodedFunctionRecord> Records;
+};
+
+} // end anonymous namespace
+
+/// Decode \p Record with the counts that \p ProfileReader has for it. If
+/// \p ProfileLock is not null, it is held while the profile is read.
+static Expected<DecodedFunctionRecord>
+decodeFunctionRecord(const CoverageMappingRecord &Record,
+                     IndexedInstrProfReader &ProfileReader,
+                     std::mutex *ProfileLock) {
+  DecodedFunctionRecord Decoded;
   StringRef OrigFuncName = Record.FunctionName;
   if (OrigFuncName.empty())
     return make_error<CoverageMapError>(coveragemap_error::malformed);
@@ -243,13 +276,19 @@ Error CoverageMapping::loadFunctionRecord(
   CounterMappingContext Ctx(Record.Expressions);
 
   std::vector<uint64_t> Counts;
-  if (Error E = ProfileReader.getFunctionCounts(Record.FunctionName,
-                                                Record.FunctionHash, Counts)) {
-    instrprof_error IPE = InstrProfError::take(std::move(E));
+  std::unique_lock<std::mutex> ProfileGuard;
+  if (ProfileLock)
+    ProfileGuard = std::unique_lock<std::mutex>(*ProfileLock);
+  Error CountsErr = ProfileReader.getFunctionCounts(
+      Record.FunctionName, Record.FunctionHash, Counts);
+  if (ProfileGuard)
+    ProfileGuard.unlock();
+  if (CountsErr) {
+    instrprof_error IPE = InstrProfError::take(std::move(CountsErr));
     if (IPE == instrprof_error::hash_mismatch) {
-      FuncHashMismatches.emplace_back(std::string(Record.FunctionName),
-                                      Record.FunctionHash);
-      return Error::success();
+      Decoded.HashMismatch.emplace(std::string(Record.FunctionName),
+                                   Record.FunctionHash);
+      return std::move(Decoded);
     } else if (IPE != instrprof_error::unknown_function)
       return make_error<InstrProfError>(IPE);
     Counts.assign(getMaxCounterID(Ctx, Record) + 1, 0);
@@ -265,28 +304,49 @@ Error CoverageMapping::loadFunctionRecord(
   // when they have non-zero counts in the profile).
   if (Record.MappingRegions.size() == 1 &&
       Record.MappingRegions[0].Count.isZero() && Counts[0] > 0)
-    return Error::success();
+    return std::move(Decoded);
 
   FunctionRecord Function(OrigFuncName, Record.Filenames);
   for (const auto &Region : Record.MappingRegions) {
     Expected<int64_t> ExecutionCount = Ctx.evaluate(Region.Count);
     if (auto E = ExecutionCount.takeError()) {
       consumeError(std::move(E));
-      return Error::success();
+      return std::move(Decoded);
     }
     Expected<int64_t> AltExecutionCount = Ctx.evaluate(Region.FalseCount);
     if (auto E = AltExecutionCount.takeError()) {
       consumeError(std::move(E));
-      return Error::success();
+      return std::move(Decoded);
     }
     Function.pushRegion(Region, *ExecutionCount, *AltExecutionCount);
   }
 
+  Decoded.Function.emplace(std::move(Function));
+  Decoded.FilenamesHash =
+      hash_combine_range(Record.Filenames.begin(), Record.Filenames.end());
+  return std::move(Decoded);
+}
+
+Error CoverageMapping::loadFunctionRecord(
+    const CoverageMappingRecord &Record,
+    IndexedInstrProfReader &ProfileReader) {
+  Expected<DecodedFunctionRecord> DecodedOrErr =
+      decodeFunctionRecord(Record, ProfileReader, /*ProfileLock=*/nullptr);
+  if (!DecodedOrErr)
+    return DecodedOrErr.takeError();
+  if (DecodedOrErr->HashMismatch)
+    FuncHashMismatches.push_back(std::move(*DecodedOrErr->HashMismatch));
+  if (DecodedOrErr->Function)
+    addFunctionRecord(std::move(*DecodedOrErr->Function),
+                      DecodedOrErr->FilenamesHash);
+  return Error::success();
+}
+
+void CoverageMapping::addFunctionRecord(FunctionRecord &&Function,
+                                        size_t FilenamesHash) {
   // Don't create records for (filenames, function) pairs we've already seen.
-  auto FilenamesHash = hash_combine_range(Record.Filenames.begin(),
-                                          Record.Filenames.end());
-  if (!RecordProvenance[FilenamesHash].insert(hash_value(OrigFuncName)).second)
-    return Error::success();
+  if (!RecordProvenance[FilenamesHash].insert(hash_value(Function.Name)).second)
+    return;
 
   Functions.push_back(std::move(Function));
 
@@ -294,7 +354,7 @@ Error CoverageMapping::loadFunctionRecord(
   // which correspond to each filename. This can be used to substantially speed
   // up queries for coverage info in a file.
   unsigned RecordIndex = Functions.size() - 1;
-  for (StringRef Filename : Record.Filenames) {
+  for (StringRef Filename : Functions.back().Filenames) {
     auto &RecordIndices = FilenameHash2RecordIndices[hash_value(Filename)];
     // Note that there may be duplicates in the filename set for a function
     // record, because of e.g. macro expansions in the function in which both
@@ -302,8 +362,6 @@ Error CoverageMapping::loadFunctionRecord(
     if (RecordIndices.empty() || RecordIndices.back() != RecordIndex)
       RecordIndices.push_back(RecordIndex);
   }
-
-  return Error::success();
 }
 
 // This function is for memory optimization by shortening the lifetimes
@@ -342,10 +400,50 @@ static Error handleMaybeNoDataFoundError(Error E) {
       });
 }
 
+/// Read the coverage mapping of \p ObjectFilename and decode its records with
+/// the counts in \p ProfileReader. If \p ProfileLock is not null, it is held
+/// while the profile is read.
+static Expected<DecodedObject>
+decodeObject(StringRef ObjectFilename, StringRef Arch,
+             StringRef CompilationDir, IndexedInstrProfReader &ProfileReader,
+             std::mutex *ProfileLock) {
+  DecodedObject Object;
+  auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(
+      ObjectFilename, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (std::error_code EC = CovMappingBufOrErr.getError())
+    return errorCodeToError(EC);
+  MemoryBufferRef CovMappingBufRef =
+      CovMappingBufOrErr.get()->getMemBufferRef();
+  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
+  auto CoverageReadersOrErr = BinaryCoverageReader::create(
+      CovMappingBufRef, Arch, Buffers, CompilationDir);
+  if (Error E = CoverageReadersOrErr.takeError()) {
+    E = handleMaybeNoDataFoundError(std::move(E));
+    if (E)
+      return std::move(E);
+    // E == success (originally a no_data_found error).
+    return std::move(Object);
+  }
+
+  for (auto &Reader : CoverageReadersOrErr.get()) {
+    Object.DataFound = true;
+    for (auto RecordOrErr : *Reader) {
+      if (Error E = RecordOrErr.takeError())
+        return std::move(E);
+      Expected<DecodedFunctionRecord> DecodedOrErr =
+          decodeFunctionRecord(*RecordOrErr, ProfileReader, ProfileLock);
+      if (!DecodedOrErr)
+        return DecodedOrErr.takeError();
+      Object.Records.push_back(std::move(*DecodedOrErr));
+    }
+  }
+  return std::move(Object);
+}
+
 Expected<std::unique_ptr<CoverageMapping>>
 CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
                       StringRef ProfileFilename, ArrayRef<StringRef> Arches,
-                      StringRef CompilationDir) {
+                      StringRef CompilationDir, ThreadPoolStrategy S) {
   auto ProfileReaderOrErr = IndexedInstrProfReader::create(ProfileFilename);
   if (Error E = ProfileReaderOrErr.takeError())
     return std::move(E);
@@ -353,31 +451,57 @@ CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
   auto Coverage = std::unique_ptr<CoverageMapping>(new CoverageMapping());
   bool DataFound = false;
 
-  for (const auto &File : llvm::enumerate(ObjectFilenames)) {
-    auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(
-        File.value(), /*IsText=*/false, /*RequiresNullTerminator=*/false);
-    if (std::error_code EC = CovMappingBufOrErr.getError())
-      return errorCodeToError(EC);
-    StringRef Arch = Arches.empty() ? StringRef() : Arches[File.index()];
-    MemoryBufferRef CovMappingBufRef =
-        CovMappingBufOrErr.get()->getMemBufferRef();
-    SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
-    auto CoverageReadersOrErr = BinaryCoverageReader::create(
-        CovMappingBufRef, Arch, Buffers, CompilationDir);
-    if (Error E = CoverageReadersOrErr.takeError()) {
-      E = handleMaybeNoDataFoundError(std::move(E));
-      if (E)
-        return std::move(E);
-      // E == success (originally a no_data_found error).
-      continue;
+  // Add the records of an object in the order in which they were read, so
+  // that the result does not depend on how the objects were decoded.
+  auto AddObject = [&](DecodedObject &Object) {
+    DataFound |= Object.DataFound;
+    for (DecodedFunctionRecord &Decoded : Object.Records) {
+      if (Decoded.HashMismatch)
+        Coverage->FuncHashMismatches.push_back(
+            std::move(*Decoded.HashMismatch));
+      if (Decoded.Function)
+        Coverage->addFunctionRecord(std::move(*Decoded.Function),
+                                    Decoded.FilenamesHash);
     }
+  };
+  auto GetArch = [&](size_t I) {
+    return Arches.empty() ? StringRef() : Arches[I];
+  };
 
-    SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
-    for (auto &Reader : CoverageReadersOrErr.get())
-      Readers.push_back(std::move(Reader));
-    DataFound |= !Readers.empty();
-    if (Error E = loadFromReaders(Readers, *ProfileReader, *Coverage))
-      return std::move(E);
+  if (ObjectFilenames.size() > 1 && S.compute_thread_count() > 1) {
+    // Decode the objects in parallel. Only the profile lookups are
+    // serialized, as the profile reader is not thread safe.
+    std::mutex ProfileLock;
+    std::vector<Optional<Expected<DecodedObject>>> Objects(
+        ObjectFilenames.size());
+    ThreadPool Pool(S);
+    for (size_t I = 0, E = ObjectFilenames.size(); I != E; ++I)
+      Pool.async([&, I] {
+        Objects[I].emplace(decodeObject(ObjectFilenames[I], GetArch(I),
+                                        CompilationDir, *ProfileReader,
+                                        &ProfileLock));
+      });
+    Pool.wait();
+
+    for (size_t I = 0, E = Objects.size(); I != E; ++I) {
+      if (Error Err = Objects[I]->takeError()) {
+        // Report the first error, like the serial path does.
+        for (size_t J = I + 1; J != E; ++J)
+          consumeError(Objects[J]->takeError());
+        return std::move(Err);
+      }
+      AddObject(**Objects[I]);
+      Objects[I].reset();
+    }
+  } else {
+    for (size_t I = 0, E = ObjectFilenames.size(); I != E; ++I) {
+      Expected<DecodedObject> ObjectOrErr =
+          decodeObject(ObjectFilenames[I], GetArch(I), CompilationDir,
+                       *ProfileReader, /*ProfileLock=*/nullptr);
+      if (!ObjectOrErr)
+        return ObjectOrErr.takeError();
+      AddObject(*ObjectOrErr);
+    }
   }
   // If no readers were created, either no objects were provided or none of them
   // had coverage data. Return an error in the latter case.
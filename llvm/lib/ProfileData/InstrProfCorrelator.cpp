@@ -11,6 +11,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 
 #define DEBUG_TYPE "correlator"
 
@@ -166,7 +167,9 @@ void InstrProfCorrelatorImpl<IntPtrT>::addProbe(StringRef FunctionName,
       // of the counter.
       maybeSwap<IntPtrT>(CounterOffset),
       maybeSwap<IntPtrT>(FunctionPtr),
-      // TODO: Value profiling is not yet supported.
+      // TODO: Value profiling is not yet supported. The runtime writes the
+      // value profile data while walking the data section, which is not
+      // emitted in this mode.
       /*ValuesPtr=*/maybeSwap<IntPtrT>(0),
       maybeSwap<uint32_t>(NumCounters),
       /*NumValueSites=*/{maybeSwap<uint16_t>(0), maybeSwap<uint16_t>(0)},
@@ -281,6 +284,18 @@ void DwarfInstrProfCorrelator<IntPtrT>::correlateProfileDataImpl() {
     this->addProbe(*FunctionName, *CFGHash, *CounterPtr - CountersStart,
                    FunctionPtr.getValueOr(0), *NumCounters);
   };
+  // Extracting the DIEs is most of the work, do it for all the units in
+  // parallel. The abbreviations are shared between units, so they are parsed
+  // first, sequentially. The probes are then added in unit order, so that the
+  // result doesn't depend on the scheduling.
+  if (DICtx->getNumCompileUnits() > 1) {
+    for (const auto &CU : DICtx->normal_units())
+      CU->getAbbreviations();
+    ThreadPool Pool;
+    for (const auto &CU : DICtx->normal_units())
+      Pool.async([&CU]() { CU->getUnitDIE(/*CUDieOnly=*/false); });
+    Pool.wait();
+  }
   for (auto &CU : DICtx->normal_units())
     for (const auto &Entry : CU->dies())
       maybeAddProbe(DWARFDie(CU.get(), &Entry));
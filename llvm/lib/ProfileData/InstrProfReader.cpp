@@ -60,10 +60,16 @@ static InstrProfKind getProfileKindFromVersion(uint64_t Version) {
   return ProfileKind;
 }
 
+// Binary profiles are opened without requiring a null terminator. This lets
+// MemoryBuffer mmap them whatever their size, rather than reading files whose
+// size is a multiple of the page size into memory. The indexed format is then
+// only paged in as its on-disk hash table is looked up, and the pages are
+// shared between processes reading the same profile, e.g. ThinLTO backends.
 static Expected<std::unique_ptr<MemoryBuffer>>
-setupMemoryBuffer(const Twine &Path) {
+setupMemoryBuffer(const Twine &Path, bool IsText = true) {
   ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
-      MemoryBuffer::getFileOrSTDIN(Path, /*IsText=*/true);
+      MemoryBuffer::getFileOrSTDIN(Path, IsText,
+                                   /*RequiresNullTerminator=*/IsText);
   if (std::error_code EC = BufferOrErr.getError())
     return errorCodeToError(EC);
   return std::move(BufferOrErr.get());
@@ -116,7 +122,7 @@ InstrProfReader::create(std::unique_ptr<MemoryBuffer> Buffer,
 Expected<std::unique_ptr<IndexedInstrProfReader>>
 IndexedInstrProfReader::create(const Twine &Path, const Twine &RemappingPath) {
   // Set up the buffer to read.
-  auto BufferOrError = setupMemoryBuffer(Path);
+  auto BufferOrError = setupMemoryBuffer(Path, /*IsText=*/false);
   if (Error E = BufferOrError.takeError())
     return std::move(E);
 
@@ -0,0 +1,83 @@
+//===- MemProf.cpp - MemProf support --------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the classification of MemProf allocation contexts.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ProfileData/MemProf.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ErrorHandling.h"
+
+#include <algorithm>
+
+using namespace llvm;
+using namespace llvm::memprof;
+
+// The lifetimes recorded by the runtime are in milliseconds, and the access
+// counts are the number of accessed 64 byte granules.
+static cl::opt<float> MemProfColdAccessDensityThreshold(
+    "memprof-cold-access-density-threshold", cl::init(0.05), cl::Hidden,
+    cl::desc("The number of accesses per byte per second of lifetime below "
+             "which long lived allocations are considered cold"));
+
+static cl::opt<unsigned> MemProfColdLifetimeThreshold(
+    "memprof-cold-lifetime-threshold", cl::init(200), cl::Hidden,
+    cl::desc("The average lifetime in seconds above which rarely accessed "
+             "allocations are considered cold"));
+
+static cl::opt<float> MemProfHotAccessDensityThreshold(
+    "memprof-hot-access-density-threshold", cl::init(0), cl::Hidden,
+    cl::desc("The number of accesses per byte per second of lifetime above "
+             "which allocations are considered hot, 0 disables the hot "
+             "classification"));
+
+AllocationType llvm::memprof::getAllocType(const MemInfoBlock &Info) {
+  if (Info.alloc_count == 0 || Info.total_size == 0)
+    return AllocationType::NotCold;
+  // Count the allocations which are freed within the same millisecond as
+  // living for a millisecond, to not divide by zero.
+  const uint64_t TotalLifetime = Info.total_lifetime;
+  const double TotalLifetimeSec = std::max<uint64_t>(TotalLifetime, 1) / 1000.0;
+  const double AccessDensity =
+      Info.total_access_count / (Info.total_size * TotalLifetimeSec);
+  const double AverageLifetimeSec = TotalLifetimeSec / Info.alloc_count;
+
+  if (AccessDensity < MemProfColdAccessDensityThreshold &&
+      AverageLifetimeSec >= MemProfColdLifetimeThreshold)
+    return AllocationType::Cold;
+  if (MemProfHotAccessDensityThreshold > 0 &&
+      AccessDensity >= MemProfHotAccessDensityThreshold)
+    return AllocationType::Hot;
+  return AllocationType::NotCold;
+}
+
+StringRef llvm::memprof::getAllocTypeAttributeString(AllocationType Type) {
+  switch (Type) {
+  case AllocationType::NotCold:
+    return "notcold";
+  case AllocationType::Cold:
+    return "cold";
+  case AllocationType::Hot:
+    return "hot";
+  }
+  llvm_unreachable("invalid alloc type");
+}
+
+void MemProfRecord::print(raw_ostream &OS) const {
+  OS << "  AllocCount: " << Info.alloc_count << "\n";
+  OS << "  TotalAccessCount: " << Info.total_access_count << "\n";
+  OS << "  TotalSize: " << Info.total_size << "\n";
+  OS << "  TotalLifetime: " << Info.total_lifetime << "\n";
+  OS << "  AllocType: " << getAllocTypeAttributeString(getAllocType(Info))
+     << "\n";
+  OS << "  CallStack:\n";
+  for (const Frame &F : CallStack)
+    OS << "    " << F.Function << ":" << F.LineOffset << ":" << F.Column
+       << (F.IsInlineFrame ? " (inlined)" : "") << "\n";
+}
@@ -11,9 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/Symbolize/SymbolizableObjectFile.h"
+#include "llvm/Object/ELFObjectFile.h"
 #include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/MemProf.h"
 #include "llvm/ProfileData/MemProfData.inc"
 #include "llvm/ProfileData/RawMemProfReader.h"
 
@@ -48,6 +54,14 @@ Summary computeSummary(const char *Start) {
   };
 }
 
+// Returns whether the frame belongs to the memprof runtime, whose allocation
+// and interception functions are on top of every profiled call stack.
+bool isRuntimeFrame(const DILineInfo &Info) {
+  StringRef FileName(Info.FileName);
+  return FileName.contains("memprof/memprof_") ||
+         FileName.contains("sanitizer_common/sanitizer_");
+}
+
 } // namespace
 
 Expected<std::unique_ptr<RawMemProfReader>>
@@ -89,6 +103,136 @@ RawMemProfReader::create(const Twine &Path) {
   return std::make_unique<RawMemProfReader>(std::move(Buffer));
 }
 
+Expected<std::unique_ptr<RawMemProfReader>>
+RawMemProfReader::create(const Twine &Path, const StringRef ProfiledBinary) {
+  auto ReaderOr = create(Path);
+  if (Error E = ReaderOr.takeError())
+    return std::move(E);
+  std::unique_ptr<RawMemProfReader> Reader = std::move(ReaderOr.get());
+
+  auto BinaryOr = object::createBinary(ProfiledBinary);
+  if (Error E = BinaryOr.takeError())
+    return std::move(E);
+  Reader->Binary = std::move(BinaryOr.get());
+  const auto *ElfObject =
+      dyn_cast<object::ELFObjectFileBase>(Reader->Binary.getBinary());
+  if (!ElfObject)
+    return make_error<StringError>(
+        Twine("profiled binary '") + ProfiledBinary + "' is not an ELF file",
+        inconvertibleErrorCode());
+
+  // The runtime records the file offsets of the executable mappings, which
+  // map to addresses through the text section.
+  for (const object::ELFSectionRef Section : ElfObject->sections()) {
+    if (Section.isText()) {
+      Reader->FileOffsetToAddress = Section.getAddress() - Section.getOffset();
+      break;
+    }
+  }
+
+  auto SymbolizerOr = symbolize::SymbolizableObjectFile::create(
+      ElfObject, DWARFContext::create(*ElfObject), /*UntagAddresses=*/false);
+  if (Error E = SymbolizerOr.takeError())
+    return std::move(E);
+  Reader->Symbolizer = std::move(SymbolizerOr.get());
+  return std::move(Reader);
+}
+
+Expected<std::vector<MemProfRecord>> RawMemProfReader::readRecords() const {
+  if (!Symbolizer)
+    return make_error<StringError>("no profiled binary to symbolize the raw "
+                                   "memprof profile",
+                                   inconvertibleErrorCode());
+
+  const DILineInfoSpecifier Specifier(
+      DILineInfoSpecifier::FileLineInfoKind::RawValue,
+      DILineInfoSpecifier::FunctionNameKind::LinkageName);
+  std::vector<MemProfRecord> Records;
+  const char *Next = DataBuffer->getBufferStart();
+  while (Next < DataBuffer->getBufferEnd()) {
+    auto *H = reinterpret_cast<const Header *>(Next);
+    const char *End = Next + H->TotalSize;
+    auto CheckSection = [&](uint64_t Offset) {
+      return Offset < H->TotalSize && Offset % sizeof(uint64_t) == 0;
+    };
+    if (!CheckSection(H->SegmentOffset) || !CheckSection(H->MIBOffset) ||
+        !CheckSection(H->StackOffset))
+      return make_error<InstrProfError>(instrprof_error::malformed);
+
+    // Only the first executable mapping, which is the one of the main binary,
+    // is symbolized, since the segments don't record the build ids yet.
+    const char *Ptr = Next + H->SegmentOffset;
+    if (alignedRead(Ptr) == 0) {
+      Next = End;
+      continue;
+    }
+    if (Ptr + sizeof(uint64_t) + sizeof(SegmentEntry) > End)
+      return make_error<InstrProfError>(instrprof_error::truncated);
+    const SegmentEntry Segment =
+        *reinterpret_cast<const SegmentEntry *>(Ptr + sizeof(uint64_t));
+
+    DenseMap<uint64_t, SmallVector<Frame>> CallStacks;
+    Ptr = Next + H->StackOffset;
+    uint64_t NumStacks = alignedRead(Ptr);
+    Ptr += sizeof(uint64_t);
+    for (; NumStacks; --NumStacks) {
+      if (Ptr + 2 * sizeof(uint64_t) > End)
+        return make_error<InstrProfError>(instrprof_error::truncated);
+      const uint64_t StackId = alignedRead(Ptr);
+      const uint64_t NumPCs = alignedRead(Ptr + sizeof(uint64_t));
+      Ptr += 2 * sizeof(uint64_t);
+      if (NumPCs > static_cast<uint64_t>(End - Ptr) / sizeof(uint64_t))
+        return make_error<InstrProfError>(instrprof_error::truncated);
+
+      SmallVector<Frame> &CallStack = CallStacks[StackId];
+      for (uint64_t I = 0; I < NumPCs; ++I, Ptr += sizeof(uint64_t)) {
+        const uint64_t PC = alignedRead(Ptr);
+        if (PC < Segment.Start || PC >= Segment.End)
+          continue;
+        const uint64_t Address =
+            PC - Segment.Start + Segment.Offset + FileOffsetToAddress;
+        const DIInliningInfo Inlined = Symbolizer->symbolizeInlinedCode(
+            {Address, object::SectionedAddress::UndefSection}, Specifier,
+            /*UseSymbolTable=*/false);
+        const uint32_t NumFrames = Inlined.getNumberOfFrames();
+        for (uint32_t J = 0; J < NumFrames; ++J) {
+          const DILineInfo &Info = Inlined.getFrame(J);
+          if (Info.FunctionName == DILineInfo::BadString ||
+              isRuntimeFrame(Info))
+            continue;
+          Frame F;
+          F.Function = Info.FunctionName;
+          F.LineOffset = Info.Line - Info.StartLine;
+          F.Column = Info.Column;
+          F.IsInlineFrame = J != NumFrames - 1;
+          CallStack.push_back(std::move(F));
+        }
+      }
+    }
+
+    Ptr = Next + H->MIBOffset;
+    uint64_t NumMIBs = alignedRead(Ptr);
+    Ptr += sizeof(uint64_t);
+    for (; NumMIBs; --NumMIBs) {
+      if (Ptr + sizeof(uint64_t) + sizeof(MemInfoBlock) > End)
+        return make_error<InstrProfError>(instrprof_error::truncated);
+      const uint64_t StackId = alignedRead(Ptr);
+      MemProfRecord Record;
+      memcpy(&Record.Info, Ptr + sizeof(uint64_t), sizeof(MemInfoBlock));
+      Ptr += sizeof(uint64_t) + sizeof(MemInfoBlock);
+
+      auto It = CallStacks.find(StackId);
+      if (It == CallStacks.end() || It->second.empty())
+        continue;
+      Record.CallStack = It->second;
+      Records.push_back(std::move(Record));
+    }
+
+    Next = End;
+  }
+  return std::move(Records);
+}
+
 bool RawMemProfReader::hasFormat(const MemoryBuffer &Buffer) {
   if (Buffer.getBufferSize() < sizeof(uint64_t))
     return false;
@@ -22,6 +22,7 @@
 #include "llvm/ProfileData/SampleProfReader.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/ProfileCommon.h"
@@ -48,6 +49,10 @@ using namespace sampleprof;
 
 #define DEBUG_TYPE "samplepgo-reader"
 
+STATISTIC(NumFuncProfilesLoaded, "Number of function profiles loaded");
+STATISTIC(NumFuncProfileBytesLoaded,
+          "Number of bytes of function profiles loaded");
+
 // This internal option specifies if the profile uses FS discriminators.
 // It only applies to text, binary and compact binary format profiles.
 // For ext-binary format profiles, the flag is set in the summary.
@@ -604,6 +609,9 @@ SampleProfileReaderBinary::readFuncProfile(const uint8_t *Start) {
 
   if (std::error_code EC = readProfile(FProfile))
     return EC;
+
+  ++NumFuncProfilesLoaded;
+  NumFuncProfileBytesLoaded += Data - Start;
   return sampleprof_error::success;
 }
 
@@ -1755,15 +1763,43 @@ SampleProfileReaderItaniumRemapper::lookUpNameInProfile(StringRef Fname) {
   return None;
 }
 
+/// \returns true if \p Buffer holds a profile in one of the binary formats.
+static bool isBinaryProfile(const MemoryBuffer &Buffer) {
+  return SampleProfileReaderRawBinary::hasFormat(Buffer) ||
+         SampleProfileReaderExtBinary::hasFormat(Buffer) ||
+         SampleProfileReaderCompactBinary::hasFormat(Buffer) ||
+         SampleProfileReaderGCC::hasFormat(Buffer);
+}
+
 /// Prepare a memory buffer for the contents of \p Filename.
 ///
+/// Profiles in a binary format are opened without requiring a null
+/// terminator, so that MemoryBuffer maps them whatever their size instead of
+/// reading some of them into memory. Only the parts of the profile the reader
+/// touches are then paged in, and the pages are shared between concurrent
+/// compiles that use the same profile. Anything else, e.g. text profiles and
+/// remapping files, is opened as null-terminated text, as the line-based
+/// readers need.
+///
 /// \returns an error code indicating the status of the buffer.
 static ErrorOr<std::unique_ptr<MemoryBuffer>>
-setupMemoryBuffer(const Twine &Filename) {
-  auto BufferOrErr = MemoryBuffer::getFileOrSTDIN(Filename, /*IsText=*/true);
-  if (std::error_code EC = BufferOrErr.getError())
-    return EC;
-  auto Buffer = std::move(BufferOrErr.get());
+setupMemoryBuffer(const Twine &Filename, bool MayBeBinary = false) {
+  std::unique_ptr<MemoryBuffer> Buffer;
+  if (MayBeBinary) {
+    auto BufferOrErr = MemoryBuffer::getFileOrSTDIN(
+        Filename, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+    if (std::error_code EC = BufferOrErr.getError())
+      return EC;
+    // Standard input cannot be read twice, but is always null-terminated.
+    if (isBinaryProfile(*BufferOrErr.get()) || Filename.str() == "-")
+      Buffer = std::move(BufferOrErr.get());
+  }
+  if (!Buffer) {
+    auto BufferOrErr = MemoryBuffer::getFileOrSTDIN(Filename, /*IsText=*/true);
+    if (std::error_code EC = BufferOrErr.getError())
+      return EC;
+    Buffer = std::move(BufferOrErr.get());
+  }
 
   // Check the file.
   if (uint64_t(Buffer->getBufferSize()) > std::numeric_limits<uint32_t>::max())
@@ -1787,7 +1823,7 @@ ErrorOr<std::unique_ptr<SampleProfileReader>>
 SampleProfileReader::create(const std::string Filename, LLVMContext &C,
                             FSDiscriminatorPass P,
                             const std::string RemapFilename) {
-  auto BufferOrError = setupMemoryBuffer(Filename);
+  auto BufferOrError = setupMemoryBuffer(Filename, /*MayBeBinary=*/true);
   if (std::error_code EC = BufferOrError.getError())
     return EC;
   return create(BufferOrError.get(), C, P, RemapFilename);
@@ -39,7 +39,7 @@ Error RemarkStreamer::setFilter(StringRef Filter) {
   return Error::success();
 }
 
-bool RemarkStreamer::matchesFilter(StringRef Str) {
+bool RemarkStreamer::matchesFilter(StringRef Str) const {
   if (PassFilter)
     return PassFilter->match(Str);
   // No filter means all strings pass.
@@ -162,3 +162,28 @@ Expected<FileCache> llvm::localCache(Twine CacheNameRef,
     };
   };
 }
+
+FileCache llvm::tieredCache(FileCache Cache, CacheLookupFn Lookup) {
+  return [=](unsigned Task, StringRef Key) -> Expected<AddStreamFn> {
+    Expected<AddStreamFn> AddStreamOrErr = Cache(Task, Key);
+    // Return errors and hits in the first tier as is.
+    if (!AddStreamOrErr || !*AddStreamOrErr)
+      return AddStreamOrErr;
+
+    Expected<std::unique_ptr<MemoryBuffer>> MBOrErr = Lookup(Key);
+    if (!MBOrErr)
+      return MBOrErr.takeError();
+    if (!*MBOrErr)
+      return AddStreamOrErr;
+
+    // Copy the entry into the first tier. Committing the stream adds the file
+    // to the link.
+    Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+        (*AddStreamOrErr)(Task);
+    if (!StreamOrErr)
+      return StreamOrErr.takeError();
+    *(*StreamOrErr)->OS << (*MBOrErr)->getBuffer();
+    StreamOrErr->reset();
+    return AddStreamFn();
+  };
+}
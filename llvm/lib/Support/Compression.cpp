@@ -17,6 +17,9 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
+#include <vector>
 #if LLVM_ENABLE_ZLIB
 #include <zlib.h>
 #endif
@@ -60,6 +63,80 @@ Error zlib::compress(StringRef InputBuffer,
   return Res ? createError(convertZlibCodeToString(Res)) : Error::success();
 }
 
+// Compresses one chunk into raw deflate data without a zlib header or trailer.
+// All chunks but the last end with a sync flush, which pads the output to a
+// byte boundary so that it can be followed by the next chunk. Returns a zlib
+// status code.
+static int deflateChunk(StringRef Input, SmallVectorImpl<char> &Output,
+                        int Level, bool IsLast) {
+  z_stream S = {};
+  // A negative windowBits asks for raw deflate data; 15 and 8 are defaults.
+  int Res = deflateInit2(&S, Level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+  if (Res != Z_OK)
+    return Res;
+  S.next_in = (Bytef *)Input.data();
+  S.avail_in = Input.size();
+
+  // deflateBound() does not account for the sync flush marker.
+  size_t Pos = 0;
+  Output.resize_for_overwrite(deflateBound(&S, Input.size()) + 8);
+  do {
+    if (Pos == Output.size())
+      Output.resize_for_overwrite(Output.size() * 3 / 2);
+    S.next_out = (Bytef *)Output.data() + Pos;
+    S.avail_out = Output.size() - Pos;
+    Res = deflate(&S, IsLast ? Z_FINISH : Z_SYNC_FLUSH);
+    Pos = (char *)S.next_out - Output.data();
+  } while (S.avail_out == 0);
+  deflateEnd(&S);
+  __msan_unpoison(Output.data(), Pos);
+  Output.truncate(Pos);
+  return Res == Z_STREAM_END ? Z_OK : Res;
+}
+
+Error zlib::compressParallel(StringRef InputBuffer,
+                             SmallVectorImpl<char> &CompressedBuffer,
+                             int Level, size_t ChunkSize) {
+  assert(ChunkSize > 0 && "chunks must not be empty");
+  if (InputBuffer.size() <= ChunkSize)
+    return compress(InputBuffer, CompressedBuffer, Level);
+
+  size_t NumChunks = divideCeil(InputBuffer.size(), ChunkSize);
+  std::vector<SmallVector<char, 0>> Chunks(NumChunks);
+  std::vector<uint32_t> Checksums(NumChunks);
+  std::vector<int> Results(NumChunks);
+  parallelForEachN(0, NumChunks, [&](size_t I) {
+    StringRef In = InputBuffer.substr(I * ChunkSize, ChunkSize);
+    Results[I] = deflateChunk(In, Chunks[I], Level, I == NumChunks - 1);
+    Checksums[I] = ::adler32(1, (const Bytef *)In.data(), In.size());
+  });
+  for (int Res : Results)
+    if (Res != Z_OK)
+      return createError(convertZlibCodeToString(Res));
+
+  // The zlib header: deflate with a 32 KiB window, FLEVEL derived from Level,
+  // and the check bits that make the header a multiple of 31.
+  unsigned Flags = (Level < 2 ? 0 : Level < 6 ? 1 : Level == 6 ? 2 : 3) << 6;
+  Flags += 31 - ((0x78 << 8 | Flags) % 31);
+  uint32_t Checksum = 1;
+  size_t Size = 2 + 4;
+  for (size_t I = 0; I != NumChunks; ++I) {
+    Size += Chunks[I].size();
+    size_t ChunkLen = std::min(ChunkSize, InputBuffer.size() - I * ChunkSize);
+    Checksum = ::adler32_combine(Checksum, Checksums[I], ChunkLen);
+  }
+
+  CompressedBuffer.clear();
+  CompressedBuffer.reserve(Size);
+  CompressedBuffer.push_back(0x78);
+  CompressedBuffer.push_back(Flags);
+  for (const SmallVector<char, 0> &Chunk : Chunks)
+    CompressedBuffer.append(Chunk.begin(), Chunk.end());
+  for (int Shift = 24; Shift >= 0; Shift -= 8)
+    CompressedBuffer.push_back((Checksum >> Shift) & 0xff);
+  return Error::success();
+}
+
 Error zlib::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
                        size_t &UncompressedSize) {
   int Res =
@@ -91,6 +168,11 @@ Error zlib::compress(StringRef InputBuffer,
                      SmallVectorImpl<char> &CompressedBuffer, int Level) {
   llvm_unreachable("zlib::compress is unavailable");
 }
+Error zlib::compressParallel(StringRef InputBuffer,
+                             SmallVectorImpl<char> &CompressedBuffer,
+                             int Level, size_t ChunkSize) {
+  llvm_unreachable("zlib::compressParallel is unavailable");
+}
 Error zlib::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
                        size_t &UncompressedSize) {
   llvm_unreachable("zlib::uncompress is unavailable");
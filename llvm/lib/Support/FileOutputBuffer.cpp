@@ -63,6 +63,12 @@ public:
     consumeError(Temp.discard());
   }
 
+  void startWriteBack(size_t Offset, size_t Size) override {
+    // This is just a hint, so errors are ignored.
+    if (Temp.FD != -1)
+      (void)fs::start_write_back(Temp.FD, Offset, Size);
+  }
+
 private:
   fs::mapped_file_region Buffer;
   fs::TempFile Temp;
@@ -7,13 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Parallel.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Threading.h"
 
 #include <atomic>
 #include <future>
-#include <stack>
 #include <thread>
 #include <vector>
 
@@ -31,7 +31,15 @@ namespace {
 class Executor {
 public:
   virtual ~Executor() = default;
-  virtual void add(std::function<void()> func) = 0;
+  virtual void add(std::function<void()> func, const TaskGroup *Group) = 0;
+
+  /// Runs the pending closures of \p Group on the calling thread until
+  /// \p Done returns true.
+  virtual void helpUntil(const TaskGroup *Group,
+                         function_ref<bool()> Done) = 0;
+
+  /// Must be called when a closure has finished, to wake up helping threads.
+  virtual void taskDone() = 0;
 
   static Executor *getDefaultExecutor();
 };
@@ -86,12 +94,49 @@ public:
     static void call(void *Ptr) { ((ThreadPoolExecutor *)Ptr)->stop(); }
   };
 
-  void add(std::function<void()> F) override {
+  void add(std::function<void()> F, const TaskGroup *Group) override {
+    bool HasHelpers;
     {
       std::lock_guard<std::mutex> Lock(Mutex);
-      WorkStack.push(F);
+      WorkStack.push_back({std::move(F), Group});
+      HasHelpers = NumHelpers != 0;
     }
     Cond.notify_one();
+    if (HasHelpers)
+      HelperCond.notify_all();
+  }
+
+  void helpUntil(const TaskGroup *Group, function_ref<bool()> Done) override {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    ++NumHelpers;
+    while (!Stop && !Done()) {
+      // Only run closures of the awaited group: they are what we wait for,
+      // and running unrelated work here could deadlock on locks held by the
+      // caller.
+      auto It = llvm::find_if(llvm::reverse(WorkStack), [&](const Work &W) {
+        return W.Group == Group;
+      });
+      if (It == WorkStack.rend()) {
+        HelperCond.wait(Lock);
+        continue;
+      }
+      std::function<void()> Task = std::move(It->Task);
+      WorkStack.erase(std::next(It).base());
+      Lock.unlock();
+      Task();
+      Lock.lock();
+    }
+    --NumHelpers;
+  }
+
+  void taskDone() override {
+    bool HasHelpers;
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      HasHelpers = NumHelpers != 0;
+    }
+    if (HasHelpers)
+      HelperCond.notify_all();
   }
 
 private:
@@ -102,17 +147,26 @@ private:
       Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
       if (Stop)
         break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
+      auto Task = std::move(WorkStack.back().Task);
+      WorkStack.pop_back();
       Lock.unlock();
       Task();
     }
   }
 
+  struct Work {
+    std::function<void()> Task;
+    const TaskGroup *Group;
+  };
+
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
+  /// Pending closures, run in filo order.
+  std::vector<Work> WorkStack;
+  /// The number of threads in helpUntil().
+  unsigned NumHelpers = 0;
   std::mutex Mutex;
   std::condition_variable Cond;
+  std::condition_variable HelperCond;
   std::promise<void> ThreadsCreated;
   std::vector<std::thread> Threads;
 };
@@ -144,30 +198,28 @@ Executor *Executor::getDefaultExecutor() {
 }
 } // namespace
 
-static std::atomic<int> TaskGroupInstances;
+// Waiting threads run the pending tasks of their group instead of blocking.
+// Thus nested groups, e.g. a parallelForEach() inside a task of another one,
+// cannot deadlock by blocking all threads of the default executor, and run in
+// parallel as well.
+TaskGroup::~TaskGroup() { sync(); }
 
-// Latch::sync() called by the dtor may cause one thread to block. If is a dead
-// lock if all threads in the default executor are blocked. To prevent the dead
-// lock, only allow the first TaskGroup to run tasks parallelly. In the scenario
-// of nested parallel_for_each(), only the outermost one runs parallelly.
-TaskGroup::TaskGroup() : Parallel(TaskGroupInstances++ == 0) {}
-TaskGroup::~TaskGroup() {
-  // We must ensure that all the workloads have finished before decrementing the
-  // instances count.
+void TaskGroup::sync() const {
+  if (!L.isDone())
+    Executor::getDefaultExecutor()->helpUntil(this, [&] { return L.isDone(); });
   L.sync();
-  --TaskGroupInstances;
 }
 
 void TaskGroup::spawn(std::function<void()> F) {
-  if (Parallel) {
-    L.inc();
-    Executor::getDefaultExecutor()->add([&, F] {
-      F();
-      L.dec();
-    });
-  } else {
-    F();
-  }
+  L.inc();
+  Executor::getDefaultExecutor()->add(
+      [&, F] {
+        F();
+        L.dec();
+        // This group may be gone already; only the executor is left to touch.
+        Executor::getDefaultExecutor()->taskDone();
+      },
+      this);
 }
 
 } // namespace detail
@@ -178,9 +230,7 @@ void TaskGroup::spawn(std::function<void()> F) {
 void llvm::parallelForEachN(size_t Begin, size_t End,
                             llvm::function_ref<void(size_t)> Fn) {
   // If we have zero or one items, then do not incur the overhead of spinning up
-  // a task group.  They are surprisingly expensive, and because they do not
-  // support nested parallelism, a single entry task group can block parallel
-  // execution underneath them.
+  // a task group.  They are surprisingly expensive.
 #if LLVM_ENABLE_THREADS
   auto NumItems = End - Begin;
   if (NumItems > 1 && parallel::strategy.ThreadsRequested != 1) {
@@ -13,9 +13,24 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/xxhash.h"
 
 using namespace llvm;
 
+/// Returns the hash of \p Key used to find its bucket.
+///
+/// The DJB hash is cheap for short keys but consumes one byte per step; with
+/// LLVM_ENABLE_STRINGMAP_XXHASH, xxHash64 is used instead, which is much
+/// faster for long keys such as mangled names. The choice changes the
+/// iteration order of every StringMap.
+static inline unsigned hashKey(StringRef Key) {
+#ifdef LLVM_STRINGMAP_XXHASH
+  return static_cast<unsigned>(xxHash64(Key));
+#else
+  return djbHash(Key, 0);
+#endif
+}
+
 /// Returns the number of buckets to allocate to ensure that the DenseMap can
 /// accommodate \p NumEntries without need to grow().
 static unsigned getMinBucketToReserveForEntries(unsigned NumEntries) {
@@ -76,7 +91,7 @@ unsigned StringMapImpl::LookupBucketFor(StringRef Name) {
     init(16);
     HTSize = NumBuckets;
   }
-  unsigned FullHashValue = djbHash(Name, 0);
+  unsigned FullHashValue = hashKey(Name);
   unsigned BucketNo = FullHashValue & (HTSize - 1);
   unsigned *HashTable = (unsigned *)(TheTable + NumBuckets + 1);
 
@@ -132,7 +147,7 @@ int StringMapImpl::FindKey(StringRef Key) const {
   unsigned HTSize = NumBuckets;
   if (HTSize == 0)
     return -1; // Really empty table?
-  unsigned FullHashValue = djbHash(Key, 0);
+  unsigned FullHashValue = hashKey(Key);
   unsigned BucketNo = FullHashValue & (HTSize - 1);
   unsigned *HashTable = (unsigned *)(TheTable + NumBuckets + 1);
 
@@ -51,6 +51,10 @@ struct Entry {
   TimePointType End;
   const std::string Name;
   const std::string Detail;
+  /// Value of the memory counter when the section was opened, and the number
+  /// of bytes allocated until it was closed.
+  uint64_t StartBytes = 0;
+  uint64_t Bytes = 0;
 
   Entry(TimePointType &&S, TimePointType &&E, std::string &&N, std::string &&Dt)
       : Start(std::move(S)), End(std::move(E)), Name(std::move(N)),
@@ -71,8 +75,18 @@ struct Entry {
         .count();
   }
 };
+
+/// Memory allocated by all the sections with the same name and detail.
+struct MemoryUsage {
+  size_t Count = 0;
+  DurationType Duration = DurationType::zero();
+  uint64_t Bytes = 0;
+};
 } // namespace
 
+/// The number of sections reported as top memory consumers.
+static const size_t NumTopMemoryConsumers = 20;
+
 struct llvm::TimeTraceProfiler {
   TimeTraceProfiler(unsigned TimeTraceGranularity = 0, StringRef ProcName = "")
       : BeginningOfTime(system_clock::now()), StartTime(steady_clock::now()),
@@ -84,6 +98,8 @@ struct llvm::TimeTraceProfiler {
   void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
     Stack.emplace_back(steady_clock::now(), TimePointType(), std::move(Name),
                        Detail());
+    if (MemoryCounter)
+      Stack.back().StartBytes = MemoryCounter();
   }
 
   void end() {
@@ -101,6 +117,13 @@ struct llvm::TimeTraceProfiler {
     // Calculate duration at full precision for overall counts.
     DurationType Duration = E.End - E.Start;
 
+    if (MemoryCounter) {
+      // The counter may go backwards, e.g. if the allocator it reads from is
+      // replaced while the section is open.
+      uint64_t EndBytes = MemoryCounter();
+      E.Bytes = EndBytes > E.StartBytes ? EndBytes - E.StartBytes : 0;
+    }
+
     // Only include sections longer or equal to TimeTraceGranularity msec.
     if (duration_cast<microseconds>(Duration).count() >= TimeTraceGranularity)
       Entries.emplace_back(E);
@@ -115,6 +138,21 @@ struct llvm::TimeTraceProfiler {
       auto &CountAndTotal = CountAndTotalPerName[E.Name];
       CountAndTotal.first++;
       CountAndTotal.second += Duration;
+      BytesPerName[E.Name] += E.Bytes;
+    }
+
+    // Attribute memory to individual headers, templates etc. Nested sections
+    // with the same name but a different detail are counted separately, as
+    // the detail is what tells them apart.
+    if (MemoryCounter && !E.Detail.empty() &&
+        llvm::none_of(llvm::drop_begin(llvm::reverse(Stack)),
+                      [&](const Entry &Val) {
+                        return Val.Name == E.Name && Val.Detail == E.Detail;
+                      })) {
+      MemoryUsage &Usage = MemoryPerNameAndDetail[E.Name + '\0' + E.Detail];
+      ++Usage.Count;
+      Usage.Duration += Duration;
+      Usage.Bytes += E.Bytes;
     }
 
     Stack.pop_back();
@@ -148,8 +186,13 @@ struct llvm::TimeTraceProfiler {
         J.attribute("ts", StartUs);
         J.attribute("dur", DurUs);
         J.attribute("name", E.Name);
-        if (!E.Detail.empty()) {
-          J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
+        if (!E.Detail.empty() || MemoryCounter) {
+          J.attributeObject("args", [&] {
+            if (!E.Detail.empty())
+              J.attribute("detail", E.Detail);
+            if (MemoryCounter)
+              J.attribute("bytes", int64_t(E.Bytes));
+          });
         }
       });
     };
@@ -181,6 +224,13 @@ struct llvm::TimeTraceProfiler {
       for (const auto &Stat : TTP->CountAndTotalPerName)
         combineStat(Stat);
 
+    StringMap<uint64_t> AllBytesPerName;
+    for (const auto &Stat : BytesPerName)
+      AllBytesPerName[Stat.getKey()] += Stat.getValue();
+    for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+      for (const auto &Stat : TTP->BytesPerName)
+        AllBytesPerName[Stat.getKey()] += Stat.getValue();
+
     std::vector<NameAndCountAndDurationType> SortedTotals;
     SortedTotals.reserve(AllCountAndTotalPerName.size());
     for (const auto &Total : AllCountAndTotalPerName)
@@ -207,12 +257,64 @@ struct llvm::TimeTraceProfiler {
         J.attributeObject("args", [&] {
           J.attribute("count", int64_t(Count));
           J.attribute("avg ms", int64_t(DurUs / Count / 1000));
+          if (MemoryCounter)
+            J.attribute("bytes", int64_t(AllBytesPerName[Total.first]));
         });
       });
 
       ++TotalTid;
     }
 
+    // Report the sections that allocated the most memory, after the totals.
+    if (MemoryCounter) {
+      StringMap<MemoryUsage> AllMemoryPerNameAndDetail;
+      auto combineUsage = [&](const auto &Stat) {
+        MemoryUsage &Usage = AllMemoryPerNameAndDetail[Stat.getKey()];
+        Usage.Count += Stat.getValue().Count;
+        Usage.Duration += Stat.getValue().Duration;
+        Usage.Bytes += Stat.getValue().Bytes;
+      };
+      for (const auto &Stat : MemoryPerNameAndDetail)
+        combineUsage(Stat);
+      for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+        for (const auto &Stat : TTP->MemoryPerNameAndDetail)
+          combineUsage(Stat);
+
+      std::vector<const StringMapEntry<MemoryUsage> *> SortedUsages;
+      SortedUsages.reserve(AllMemoryPerNameAndDetail.size());
+      for (const auto &Usage : AllMemoryPerNameAndDetail)
+        SortedUsages.push_back(&Usage);
+      llvm::sort(SortedUsages, [](const StringMapEntry<MemoryUsage> *A,
+                                  const StringMapEntry<MemoryUsage> *B) {
+        return A->getValue().Bytes > B->getValue().Bytes;
+      });
+      if (SortedUsages.size() > NumTopMemoryConsumers)
+        SortedUsages.resize(NumTopMemoryConsumers);
+
+      for (const StringMapEntry<MemoryUsage> *Usage : SortedUsages) {
+        StringRef Name, Detail;
+        std::tie(Name, Detail) = Usage->getKey().split('\0');
+        const MemoryUsage &Value = Usage->getValue();
+
+        J.object([&] {
+          J.attribute("pid", Pid);
+          J.attribute("tid", int64_t(TotalTid));
+          J.attribute("ph", "X");
+          J.attribute("ts", 0);
+          J.attribute("dur",
+                      duration_cast<microseconds>(Value.Duration).count());
+          J.attribute("name", "Top memory " + Name.str());
+          J.attributeObject("args", [&] {
+            J.attribute("detail", Detail);
+            J.attribute("count", int64_t(Value.Count));
+            J.attribute("bytes", int64_t(Value.Bytes));
+          });
+        });
+
+        ++TotalTid;
+      }
+    }
+
     auto writeMetadataEvent = [&](const char *Name, uint64_t Tid,
                                   StringRef arg) {
       J.object([&] {
@@ -248,6 +350,9 @@ struct llvm::TimeTraceProfiler {
   SmallVector<Entry, 16> Stack;
   SmallVector<Entry, 128> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
+  StringMap<uint64_t> BytesPerName;
+  StringMap<MemoryUsage> MemoryPerNameAndDetail;
+  std::function<uint64_t()> MemoryCounter;
   const time_point<system_clock> BeginningOfTime;
   const TimePointType StartTime;
   const std::string ProcName;
@@ -267,6 +372,15 @@ void llvm::timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
       TimeTraceGranularity, llvm::sys::path::filename(ProcName));
 }
 
+void llvm::timeTraceProfilerSetMemoryCounter(
+    std::function<uint64_t()> Counter) {
+  assert(TimeTraceProfilerInstance != nullptr &&
+         "Profiler object can't be null");
+  assert(TimeTraceProfilerInstance->Stack.empty() &&
+         "Memory counter must be set outside of any profiler section");
+  TimeTraceProfilerInstance->MemoryCounter = std::move(Counter);
+}
+
 // Removes all TimeTraceProfilerInstances.
 // Called from main thread.
 void llvm::timeTraceProfilerCleanup() {
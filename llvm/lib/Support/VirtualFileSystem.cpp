@@ -552,6 +552,110 @@ directory_iterator OverlayFileSystem::dir_begin(const Twine &Dir,
 
 void ProxyFileSystem::anchor() {}
 
+//===-----------------------------------------------------------------------===/
+// CachingFileSystem implementation
+//===-----------------------------------------------------------------------===/
+
+std::error_code CachingFileSystem::makeCacheKey(const Twine &Path,
+                                                SmallVectorImpl<char> &Key) {
+  Path.toVector(Key);
+  if (std::error_code EC = makeAbsolute(Key))
+    return EC;
+  sys::path::remove_dots(Key, /*remove_dot_dot=*/false);
+  return {};
+}
+
+bool CachingFileSystem::isMissingFromListing(StringRef Key) {
+  auto It = Directories.find(sys::path::parent_path(Key));
+  return It != Directories.end() && It->second.IsListed &&
+         !It->second.Names.count(sys::path::filename(Key).lower());
+}
+
+void CachingFileSystem::noteMiss(StringRef Key) {
+  StringRef Dir = sys::path::parent_path(Key);
+  if (Dir.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (++Directories[Dir].NumMisses != ListingThreshold)
+      return;
+  }
+
+  // List the directory without holding the lock. If this fails, the directory
+  // is simply never listed, and lookups keep going to the underlying FS.
+  StringSet<> Names;
+  std::error_code EC;
+  for (directory_iterator I = getUnderlyingFS().dir_begin(Dir, EC), E;
+       !EC && I != E; I.increment(EC))
+    Names.insert(sys::path::filename(I->path()).lower());
+  if (EC)
+    return;
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  DirectoryInfo &Info = Directories[Dir];
+  Info.IsListed = true;
+  Info.Names = std::move(Names);
+}
+
+llvm::ErrorOr<Status> CachingFileSystem::status(const Twine &Path) {
+  SmallString<256> Key;
+  if (makeCacheKey(Path, Key))
+    return ProxyFileSystem::status(Path);
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = StatusCache.find(Key);
+    if (It == StatusCache.end() && isMissingFromListing(Key)) {
+      std::error_code EC = make_error_code(errc::no_such_file_or_directory);
+      StatusCache.try_emplace(Key, EC);
+      return EC;
+    }
+    if (It != StatusCache.end()) {
+      if (!It->second)
+        return It->second.getError();
+      return Status::copyWithNewName(*It->second, Path);
+    }
+  }
+
+  llvm::ErrorOr<Status> Result = ProxyFileSystem::status(Path);
+  if (!Result)
+    noteMiss(Key);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  StatusCache.try_emplace(Key, Result);
+  return Result;
+}
+
+llvm::ErrorOr<std::unique_ptr<File>>
+CachingFileSystem::openFileForRead(const Twine &Path) {
+  // Files have to be opened for real, but known misses can fail right away.
+  SmallString<256> Key;
+  if (!makeCacheKey(Path, Key)) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = StatusCache.find(Key);
+    if (It != StatusCache.end() && !It->second)
+      return It->second.getError();
+    if (It == StatusCache.end() && isMissingFromListing(Key))
+      return make_error_code(errc::no_such_file_or_directory);
+  }
+  return ProxyFileSystem::openFileForRead(Path);
+}
+
+void CachingFileSystem::invalidate(const Twine &Path) {
+  SmallString<256> Key;
+  if (makeCacheKey(Path, Key))
+    return invalidateAll();
+  std::lock_guard<std::mutex> Lock(Mutex);
+  StatusCache.erase(Key);
+  Directories.erase(Key);
+  Directories.erase(sys::path::parent_path(Key));
+}
+
+void CachingFileSystem::invalidateAll() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  StatusCache.clear();
+  Directories.clear();
+}
+
 namespace llvm {
 namespace vfs {
 
@@ -16,6 +16,8 @@
 
 #include "llvm/TableGen/Main.h"
 #include "TGParser.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -57,6 +59,13 @@ static cl::opt<bool> NoWarnOnUnusedTemplateArgs(
     "no-warn-on-unused-template-args",
     cl::desc("Disable unused template argument warnings."));
 
+static cl::list<std::string> ExtraOutputs(
+    "extra-output",
+    cl::desc("Also run the named backend on the records parsed for the main "
+             "output, and write its output to the file, e.g. "
+             "-extra-output=gen-instr-info=GenInstrInfo.inc"),
+    cl::value_desc("backend=filename"));
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
@@ -85,9 +94,46 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
-int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
+/// Write Contents to Filename, or leave the file alone if -write-if-changed is
+/// given and it already holds Contents.
+static int writeOutput(const char *argv0, StringRef Filename,
+                       StringRef Contents) {
+  if (WriteIfChanged) {
+    // Only updates the real output file if there are any differences.
+    // This prevents recompilation of all the files depending on it if there
+    // aren't any.
+    if (auto ExistingOrErr = MemoryBuffer::getFile(Filename, /*IsText=*/true))
+      if (std::move(ExistingOrErr.get())->getBuffer() == Contents)
+        return 0;
+  }
+  std::error_code EC;
+  ToolOutputFile OutFile(Filename, EC, sys::fs::OF_Text);
+  if (EC)
+    return reportError(argv0, "error opening " + Filename + ": " +
+                                  EC.message() + "\n");
+  OutFile.os() << Contents;
+  if (ErrorsPrinted == 0)
+    OutFile.keep();
+  return 0;
+}
+
+int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn,
+                       TableGenBackendFn *BackendFn) {
   RecordKeeper Records;
 
+  // Check the extra outputs before spending time on parsing.
+  SmallVector<std::pair<StringRef, StringRef>, 4> Extras;
+  for (StringRef Extra : ExtraOutputs) {
+    if (!BackendFn)
+      return reportError(argv0, "this tool does not support -extra-output\n");
+    std::pair<StringRef, StringRef> BackendAndFile = Extra.split('=');
+    if (BackendAndFile.first.empty() || BackendAndFile.second.empty() ||
+        BackendAndFile.second == "-")
+      return reportError(argv0, "-extra-output expects backend=filename, got '" +
+                                    Extra + "'\n");
+    Extras.push_back(BackendAndFile);
+  }
+
   if (TimePhases)
     Records.startPhaseTiming();
 
@@ -134,28 +180,30 @@ int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
   }
 
   Records.startTimer("Write output");
-  bool WriteFile = true;
-  if (WriteIfChanged) {
-    // Only updates the real output file if there are any differences.
-    // This prevents recompilation of all the files depending on it if there
-    // aren't any.
-    if (auto ExistingOrErr =
-            MemoryBuffer::getFile(OutputFilename, /*IsText=*/true))
-      if (std::move(ExistingOrErr.get())->getBuffer() == Out.str())
-        WriteFile = false;
-  }
-  if (WriteFile) {
-    std::error_code EC;
-    ToolOutputFile OutFile(OutputFilename, EC, sys::fs::OF_Text);
-    if (EC)
-      return reportError(argv0, "error opening " + OutputFilename + ": " +
-                                    EC.message() + "\n");
-    OutFile.os() << Out.str();
-    if (ErrorsPrinted == 0)
-      OutFile.keep();
-  }
-  
+  if (int Ret = writeOutput(argv0, OutputFilename, Out.str()))
+    return Ret;
   Records.stopTimer();
+
+  // Run the other backends on the same records, which saves parsing the whole
+  // input again for each of them. The backends run one after the other, as
+  // they resolve and unique new values in tables shared by all the records.
+  // The dependency file above names the main output only, the extra outputs
+  // have the same dependencies.
+  for (const auto &BackendAndFile : Extras) {
+    Records.startBackendTimer(("Backend " + BackendAndFile.first).str());
+    std::string ExtraString;
+    raw_string_ostream ExtraOut(ExtraString);
+    status = BackendFn(BackendAndFile.first, ExtraOut, Records);
+    Records.stopBackendTimer();
+    if (status)
+      return 1;
+
+    Records.startTimer(("Write " + BackendAndFile.second).str());
+    if (int Ret = writeOutput(argv0, BackendAndFile.second, ExtraOut.str()))
+      return Ret;
+    Records.stopTimer();
+  }
+
   Records.stopPhaseTiming();
 
   if (ErrorsPrinted > 0)
@@ -105,6 +105,8 @@ private:
                      MachineFunction &MF) const;
   bool selectCondBranch(MachineInstr &I, MachineRegisterInfo &MRI,
                         MachineFunction &MF) const;
+  bool selectSelect(MachineInstr &I, MachineRegisterInfo &MRI,
+                    MachineFunction &MF) const;
   bool selectTurnIntoCOPY(MachineInstr &I, MachineRegisterInfo &MRI,
                           const unsigned DstReg,
                           const TargetRegisterClass *DstRC,
@@ -377,6 +379,8 @@ bool X86InstructionSelector::select(MachineInstr &I) {
     return selectInsert(I, MRI, MF);
   case TargetOpcode::G_BRCOND:
     return selectCondBranch(I, MRI, MF);
+  case TargetOpcode::G_SELECT:
+    return selectSelect(I, MRI, MF);
   case TargetOpcode::G_IMPLICIT_DEF:
   case TargetOpcode::G_PHI:
     return selectImplicitDefOrPHI(I, MRI);
@@ -1376,6 +1380,52 @@ bool X86InstructionSelector::selectCondBranch(MachineInstr &I,
   return true;
 }
 
+bool X86InstructionSelector::selectSelect(MachineInstr &I,
+                                          MachineRegisterInfo &MRI,
+                                          MachineFunction &MF) const {
+  assert((I.getOpcode() == TargetOpcode::G_SELECT) && "unexpected instruction");
+
+  const Register DstReg = I.getOperand(0).getReg();
+  const Register CondReg = I.getOperand(1).getReg();
+  const Register TrueReg = I.getOperand(2).getReg();
+  const Register FalseReg = I.getOperand(3).getReg();
+
+  if (RBI.getRegBank(DstReg, MRI, TRI)->getID() != X86::GPRRegBankID)
+    return false;
+
+  unsigned CMovOpc;
+  switch (MRI.getType(DstReg).getSizeInBits()) {
+  default:
+    return false;
+  case 16:
+    CMovOpc = X86::CMOV16rr;
+    break;
+  case 32:
+    CMovOpc = X86::CMOV32rr;
+    break;
+  case 64:
+    CMovOpc = X86::CMOV64rr;
+    break;
+  }
+
+  MachineInstr &TestInst =
+      *BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(X86::TEST8ri))
+           .addReg(CondReg)
+           .addImm(1);
+  // CMOV keeps its first source unless the condition holds.
+  MachineInstr &CMovInst =
+      *BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(CMovOpc), DstReg)
+           .addReg(FalseReg)
+           .addReg(TrueReg)
+           .addImm(X86::COND_NE);
+
+  constrainSelectedInstRegOperands(TestInst, TII, TRI, RBI);
+  constrainSelectedInstRegOperands(CMovInst, TII, TRI, RBI);
+
+  I.eraseFromParent();
+  return true;
+}
+
 bool X86InstructionSelector::materializeFP(MachineInstr &I,
                                            MachineRegisterInfo &MRI,
                                            MachineFunction &MF) const {
@@ -171,6 +171,17 @@ void X86LegalizerInfo::setLegalizerInfo32bit() {
   // Control-flow
   LegacyInfo.setAction({G_BRCOND, s1}, LegacyLegalizeActions::Legal);
 
+  // Selects are implemented with CMOV, which has no 8-bit form.
+  if (Subtarget.hasCMov()) {
+    auto &SelectActions = getActionDefinitionsBuilder(G_SELECT);
+    if (Subtarget.is64Bit())
+      SelectActions.legalFor({{s16, s1}, {s32, s1}, {s64, s1}, {p0, s1}});
+    else
+      SelectActions.legalFor({{s16, s1}, {s32, s1}, {p0, s1}});
+    SelectActions.widenScalarToNextPow2(0, /*Min*/ 16)
+        .clampScalar(0, s16, Subtarget.is64Bit() ? s64 : s32);
+  }
+
   // Constants
   for (auto Ty : {s8, s16, s32, p0})
     LegacyInfo.setAction({TargetOpcode::G_CONSTANT, Ty},
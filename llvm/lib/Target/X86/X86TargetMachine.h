@@ -46,6 +46,8 @@ public:
 
   TargetTransformInfo getTargetTransformInfo(const Function &F) override;
 
+  void registerPassBuilderCallbacks(PassBuilder &PB) override;
+
   // Set up the pass pipeline.
   TargetPassConfig *createPassConfig(PassManagerBase &PM) override;
 
@@ -45,12 +45,20 @@
 #include "llvm/CodeGen/TargetLowering.h"
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/MC/MCSchedule.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 
 using namespace llvm;
 
 #define DEBUG_TYPE "x86tti"
 
+static cl::opt<bool> UseSchedModelShuffleCost(
+    "x86-sched-model-shuffle-cost", cl::init(false), cl::Hidden,
+    cl::desc("Cost single source shuffles that lower to one instruction with "
+             "the reciprocal throughput the subtarget's scheduling model "
+             "gives that instruction"));
+
 //===----------------------------------------------------------------------===//
 //
 // X86 cost model.
@@ -1082,6 +1090,64 @@ InstructionCost X86TTIImpl::getArithmeticInstrCost(
   return BaseT::getArithmeticInstrCost(Opcode, Ty, CostKind, Op1Info, Op2Info);
 }
 
+/// \returns The instruction that permutes the elements of a single register
+/// of type \p VT with an arbitrary mask, or 0 if there is no such instruction.
+static unsigned getSingleSourcePermuteOpcode(MVT VT, const X86Subtarget &ST) {
+  switch (VT.SimpleTy) {
+  case MVT::v16i8:
+  case MVT::v8i16:
+  case MVT::v8f16:
+    if (!ST.hasSSSE3())
+      return 0;
+    return ST.hasAVX() ? X86::VPSHUFBrr : X86::PSHUFBrr;
+  case MVT::v4i32:
+  case MVT::v2i64:
+    return ST.hasAVX() ? X86::VPSHUFDri : X86::PSHUFDri;
+  case MVT::v4f32:
+    return ST.hasAVX() ? X86::VPERMILPSri : X86::SHUFPSrri;
+  case MVT::v2f64:
+    return ST.hasAVX() ? X86::VPERMILPDri : X86::SHUFPDrri;
+  case MVT::v8i32:
+    return ST.hasAVX2() ? X86::VPERMDYrr : 0;
+  case MVT::v8f32:
+    return ST.hasAVX2() ? X86::VPERMPSYrr : 0;
+  case MVT::v4i64:
+    return ST.hasAVX2() ? X86::VPERMQYri : 0;
+  case MVT::v4f64:
+    return ST.hasAVX2() ? X86::VPERMPDYri : 0;
+  case MVT::v16i32:
+    return ST.hasAVX512() ? X86::VPERMDZrr : 0;
+  case MVT::v16f32:
+    return ST.hasAVX512() ? X86::VPERMPSZrr : 0;
+  case MVT::v8i64:
+    return ST.hasAVX512() ? X86::VPERMQZri : 0;
+  case MVT::v8f64:
+    return ST.hasAVX512() ? X86::VPERMPDZri : 0;
+  case MVT::v32i16:
+    return ST.hasBWI() ? X86::VPERMWZrr : 0;
+  case MVT::v64i8:
+    return ST.hasVBMI() ? X86::VPERMBZrr : 0;
+  default:
+    return 0;
+  }
+}
+
+/// \returns The reciprocal throughput of \p Opcode in the scheduling model of
+/// \p ST, rounded to a whole cost of at least 1, or None if the model does not
+/// describe the instruction.
+static Optional<InstructionCost> getSchedModelCost(unsigned Opcode,
+                                                   const X86Subtarget &ST) {
+  const MCSchedModel &SM = ST.getSchedModel();
+  if (!SM.hasInstrSchedModel())
+    return None;
+  unsigned SchedClass = ST.getInstrInfo()->get(Opcode).getSchedClass();
+  const MCSchedClassDesc *SCDesc = SM.getSchedClassDesc(SchedClass);
+  if (!SCDesc->isValid() || SCDesc->isVariant())
+    return None;
+  double RThroughput = MCSchedModel::getReciprocalThroughput(ST, *SCDesc);
+  return InstructionCost(std::max<int64_t>(1, std::llround(RThroughput)));
+}
+
 InstructionCost X86TTIImpl::getShuffleCost(TTI::ShuffleKind Kind,
                                            VectorType *BaseTp,
                                            ArrayRef<int> Mask, int Index,
@@ -1239,6 +1305,15 @@ InstructionCost X86TTIImpl::getShuffleCost(TTI::ShuffleKind Kind,
     LT.first = NumOfDests * NumOfShufflesPerDest;
   }
 
+  // The cost tables below are written for the first CPU to support each
+  // feature level. With a scheduling model for the actual CPU we can use what
+  // it says about the instruction a single source permute lowers to instead.
+  if (UseSchedModelShuffleCost &&
+      (Kind == TTI::SK_PermuteSingleSrc || Kind == TTI::SK_Reverse))
+    if (unsigned Opcode = getSingleSourcePermuteOpcode(LT.second, *ST))
+      if (Optional<InstructionCost> Cost = getSchedModelCost(Opcode, *ST))
+        return LT.first * *Cost;
+
   static const CostTblEntry AVX512FP16ShuffleTbl[] = {
       {TTI::SK_Broadcast, MVT::v32f16, 1}, // vpbroadcastw
       {TTI::SK_Broadcast, MVT::v16f16, 1}, // vpbroadcastw
@@ -5280,6 +5355,11 @@ X86TTIImpl::enableMemCmpExpansion(bool OptSize, bool IsZeroCmp) const {
     if (PreferredWidth >= 512 && ST->hasAVX512()) Options.LoadSizes.push_back(64);
     if (PreferredWidth >= 256 && ST->hasAVX()) Options.LoadSizes.push_back(32);
     if (PreferredWidth >= 128 && ST->hasSSE2()) Options.LoadSizes.push_back(16);
+    // Each pair of vector loads is compared with a single ptest or movmsk, so
+    // allow enough of them to cover 64 bytes, e.g. four 16-byte loads.
+    if (!OptSize && !Options.LoadSizes.empty())
+      Options.MaxNumLoads =
+          std::max(Options.MaxNumLoads, 64 / Options.LoadSizes.front());
   }
   if (ST->is64Bit()) {
     Options.LoadSizes.push_back(8);
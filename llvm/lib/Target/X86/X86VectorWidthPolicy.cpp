@@ -0,0 +1,107 @@
+//===- X86VectorWidthPolicy.cpp - Choose the vector width of functions ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The CPUs with the prefer-256-bit tuning, such as skylake-avx512 and
+// icelake-server, support 512-bit vectors but lower their frequency while they
+// run them. This only pays off in loops which run for long and are mostly made
+// of vector work, elsewhere 256-bit vectors are faster.
+//
+// This pass runs before the vectorizers. It gives a function a
+// "prefer-vector-width"="512" attribute when one of its innermost loops has a
+// profiled trip count and a density of vectorizable instructions above the
+// thresholds. The subtarget, and so the legal types, the vectorizer costs and
+// the code generation, are per function, so the whole function then uses
+// 512-bit vectors. Functions which already have the attribute are left alone.
+//
+//===----------------------------------------------------------------------===//
+
+#include "X86VectorWidthPolicy.h"
+#include "X86Subtarget.h"
+#include "X86TargetMachine.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/VectorUtils.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/Utils/LoopUtils.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "x86-vector-width-policy"
+
+static cl::opt<unsigned> ZmmLoopMinTripCount(
+    "x86-zmm-loop-min-trip-count", cl::init(0), cl::Hidden,
+    cl::desc("Let the functions use 512-bit vectors on CPUs preferring 256-bit "
+             "ones when one of their loops has at least this profiled trip "
+             "count (0 disables)"));
+
+static cl::opt<unsigned> ZmmLoopMinDensity(
+    "x86-zmm-loop-min-density", cl::init(60), cl::Hidden,
+    cl::desc("The minimum percentage of vectorizable instructions of a loop "
+             "for x86-zmm-loop-min-trip-count"));
+
+// Returns the percentage of the instructions of the loop which do vector work
+// once vectorized: memory accesses, arithmetic, conversions and vectorizable
+// intrinsics. Phis, terminators and address computations, which the vector
+// loop keeps scalar or folds, are not counted.
+static unsigned getVectorDensity(const Loop &L) {
+  unsigned NumInsts = 0, NumVectorInsts = 0;
+  for (const BasicBlock *BB : L.blocks()) {
+    for (const Instruction &I : *BB) {
+      if (isa<PHINode>(I) || I.isTerminator() || isa<GetElementPtrInst>(I) ||
+          isa<DbgInfoIntrinsic>(I))
+        continue;
+      ++NumInsts;
+      if (isa<LoadInst>(I) || isa<StoreInst>(I) || isa<BinaryOperator>(I) ||
+          isa<UnaryOperator>(I) || isa<CastInst>(I) || isa<SelectInst>(I) ||
+          isa<CmpInst>(I))
+        ++NumVectorInsts;
+      else if (const auto *II = dyn_cast<IntrinsicInst>(&I))
+        NumVectorInsts += isTriviallyVectorizable(II->getIntrinsicID());
+    }
+  }
+  return NumInsts ? NumVectorInsts * 100 / NumInsts : 0;
+}
+
+PreservedAnalyses X86VectorWidthPolicyPass::run(Function &F,
+                                                FunctionAnalysisManager &FAM) {
+  if (!ZmmLoopMinTripCount || F.hasFnAttribute("prefer-vector-width"))
+    return PreservedAnalyses::all();
+  const X86Subtarget *ST = TM.getSubtargetImpl(F);
+  if (!ST->hasAVX512() || ST->getPreferVectorWidth() != 256)
+    return PreservedAnalyses::all();
+
+  LoopInfo &LI = FAM.getResult<LoopAnalysis>(F);
+  bool UseZmm = false;
+  for (Loop *L : LI.getLoopsInPreorder()) {
+    if (!L->isInnermost())
+      continue;
+    // The trip count comes from the branch weights of the profile.
+    Optional<unsigned> TripCount = getLoopEstimatedTripCount(L);
+    if (!TripCount || *TripCount < ZmmLoopMinTripCount)
+      continue;
+    unsigned Density = getVectorDensity(*L);
+    LLVM_DEBUG(dbgs() << "X86VectorWidthPolicy: loop " << L->getName()
+                      << " in " << F.getName() << ": trip count " << *TripCount
+                      << ", vector density " << Density << "%\n");
+    if (Density >= ZmmLoopMinDensity) {
+      UseZmm = true;
+      break;
+    }
+  }
+  if (!UseZmm)
+    return PreservedAnalyses::all();
+
+  F.addFnAttr("prefer-vector-width", "512");
+  // TargetTransformInfo is never invalidated, while the cached one still uses
+  // the subtarget of the old attributes. Drop the results for the function so
+  // that the vectorizers get the new subtarget.
+  FAM.clear(F, F.getName());
+  return PreservedAnalyses::all();
+}
@@ -0,0 +1,36 @@
+//===- X86VectorWidthPolicy.h - Choose the vector width of functions ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// On the CPUs which prefer 256-bit vectors to avoid the frequency drop of
+// 512-bit instructions, this pass lets the functions whose loops run long
+// enough with mostly vector work use 512-bit vectors.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_TARGET_X86_X86VECTORWIDTHPOLICY_H
+#define LLVM_LIB_TARGET_X86_X86VECTORWIDTHPOLICY_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class X86TargetMachine;
+
+class X86VectorWidthPolicyPass
+    : public PassInfoMixin<X86VectorWidthPolicyPass> {
+  const X86TargetMachine &TM;
+
+public:
+  explicit X86VectorWidthPolicyPass(const X86TargetMachine &TM) : TM(TM) {}
+
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &FAM);
+};
+
+} // end namespace llvm
+
+#endif // LLVM_LIB_TARGET_X86_X86VECTORWIDTHPOLICY_H
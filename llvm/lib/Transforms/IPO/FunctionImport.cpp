@@ -1243,7 +1243,10 @@ Expected<bool> FunctionImporter::importFunctions(
     // Find the globals to import
     SetVector<GlobalValue *> GlobalsToImport;
     for (Function &F : *SrcModule) {
-      if (!F.hasName())
+      // Only definitions can be imported. Skip declarations before computing
+      // their GUID, which hashes the name: every importer of a source module
+      // would otherwise hash all of the declarations in it.
+      if (!F.hasName() || F.isDeclaration())
         continue;
       auto GUID = F.getGUID();
       auto Import = ImportGUIDs.count(GUID);
@@ -50,10 +50,12 @@
 
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/CodeMetrics.h"
 #include "llvm/Analysis/DomTreeUpdater.h"
 #include "llvm/Analysis/InlineCost.h"
 #include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Transforms/Scalar/SCCP.h"
@@ -66,6 +68,8 @@ using namespace llvm;
 #define DEBUG_TYPE "function-specialization"
 
 STATISTIC(NumFuncSpecialized, "Number of functions specialized");
+STATISTIC(NumSpecializationsOverBudget,
+          "Number of specializations skipped for the module size budget");
 
 static cl::opt<bool> ForceFunctionSpecialization(
     "force-function-specialization", cl::init(false), cl::Hidden,
@@ -98,6 +102,21 @@ static cl::opt<bool> SpecializeOnAddresses(
     "func-specialization-on-address", cl::init(false), cl::Hidden,
     cl::desc("Enable function specialization on the address of global values"));
 
+static cl::opt<bool> SpecializeOnConstantAggregates(
+    "func-specialization-on-constant-aggregates", cl::init(true), cl::Hidden,
+    cl::desc("Enable function specialization on the address of constant "
+             "global variables of aggregate type, e.g. tables of callbacks"));
+
+static cl::opt<bool> SpecializeOnlyHotCallSites(
+    "func-specialization-only-hot-callsites", cl::init(true), cl::Hidden,
+    cl::desc("When a profile is available, only specialize on a constant "
+             "if a hot call site passes it"));
+
+static cl::opt<unsigned> ModuleGrowthBudget(
+    "func-specialization-max-module-growth", cl::init(0), cl::Hidden,
+    cl::desc("The maximum growth of the module, in percent of its initial "
+             "instruction count, that specializations may add (0 = no limit)"));
+
 // TODO: This needs checking to see the impact on compile-times, which is why
 // this is off by default for now.
 static cl::opt<bool> EnableSpecializationForLiteralConstant(
@@ -274,15 +293,31 @@ class FunctionSpecializer {
   std::function<AssumptionCache &(Function &)> GetAC;
   std::function<TargetTransformInfo &(Function &)> GetTTI;
   std::function<TargetLibraryInfo &(Function &)> GetTLI;
+  std::function<BlockFrequencyInfo &(Function &)> GetBFI;
+  ProfileSummaryInfo *PSI;
 
   SmallPtrSet<Function *, 2> SpecializedFuncs;
 
+  /// The number of instructions that specializations may still add to the
+  /// module, if the growth of the module is limited.
+  Optional<uint64_t> SizeBudget;
+
 public:
   FunctionSpecializer(SCCPSolver &Solver,
                       std::function<AssumptionCache &(Function &)> GetAC,
                       std::function<TargetTransformInfo &(Function &)> GetTTI,
-                      std::function<TargetLibraryInfo &(Function &)> GetTLI)
-      : Solver(Solver), GetAC(GetAC), GetTTI(GetTTI), GetTLI(GetTLI) {}
+                      std::function<TargetLibraryInfo &(Function &)> GetTLI,
+                      std::function<BlockFrequencyInfo &(Function &)> GetBFI,
+                      ProfileSummaryInfo *PSI, Module &M)
+      : Solver(Solver), GetAC(GetAC), GetTTI(GetTTI), GetTLI(GetTLI),
+        GetBFI(GetBFI), PSI(PSI) {
+    if (ModuleGrowthBudget) {
+      uint64_t ModuleSize = 0;
+      for (Function &F : M)
+        ModuleSize += F.getInstructionCount();
+      SizeBudget = ModuleSize * ModuleGrowthBudget / 100;
+    }
+  }
 
   /// Attempt to specialize functions in the module to enable constant
   /// propagation across function boundaries.
@@ -309,6 +344,20 @@ public:
         continue;
       }
 
+      // Drop the candidates that the module size budget has no room for. The
+      // original function has to stay around for the calls they leave behind.
+      size_t NumWithinBudget = 0;
+      while (NumWithinBudget < ConstArgs.size() && consumeSizeBudget(F))
+        ++NumWithinBudget;
+      if (NumWithinBudget < ConstArgs.size()) {
+        LLVM_DEBUG(dbgs() << "FnSpecialization: module size budget "
+                          << "exhausted\n");
+        NumSpecializationsOverBudget += ConstArgs.size() - NumWithinBudget;
+        ConstArgs.truncate(NumWithinBudget);
+        for (auto &CA : ConstArgs)
+          CA.Partial = true;
+      }
+
       for (auto &CA : ConstArgs) {
         specializeFunction(CA, CurrentSpecializations);
         Changed = true;
@@ -396,6 +445,11 @@ private:
 
         if (Gain <= 0)
           continue;
+        if (!isPassedAtHotCallSite(&FormalArg, ActualArg)) {
+          LLVM_DEBUG(dbgs() << "FnSpecialization: no hot call site passes "
+                            << ActualArg->getName() << "\n");
+          continue;
+        }
         Worklist.push_back({F, &FormalArg, ActualArg, Gain});
       }
 
@@ -483,6 +537,38 @@ private:
       Solver.markFunctionUnreachable(AI.Fn);
   }
 
+  /// Take the size of a clone of \p F out of the module size budget.
+  ///
+  /// \returns false if the budget does not allow for another clone of \p F.
+  bool consumeSizeBudget(Function *F) {
+    if (!SizeBudget)
+      return true;
+    uint64_t Size = F->getInstructionCount();
+    if (Size > *SizeBudget)
+      return false;
+    *SizeBudget -= Size;
+    return true;
+  }
+
+  /// \returns true unless the profile shows that specializing on \p C is not
+  /// worth it, because no hot call site passes \p C as argument \p A.
+  bool isPassedAtHotCallSite(Argument *A, Constant *C) {
+    if (!SpecializeOnlyHotCallSites || !PSI || !PSI->hasProfileSummary() ||
+        !GetBFI)
+      return true;
+    Function *F = A->getParent();
+    for (User *U : F->users()) {
+      if (!isa<CallInst>(U) && !isa<InvokeInst>(U))
+        continue;
+      auto &CS = *cast<CallBase>(U);
+      if (CS.getCalledFunction() != F || CS.getArgOperand(A->getArgNo()) != C)
+        continue;
+      if (PSI->isHotCallSite(CS, &GetBFI(*CS.getFunction())))
+        return true;
+    }
+    return false;
+  }
+
   /// Compute and return the cost of specializing function \p F.
   InstructionCost getSpecializationCost(Function *F) {
     // Compute the code metrics for the function.
@@ -551,19 +637,15 @@ private:
 
     // The below heuristic is only concerned with exposing inlining
     // opportunities via indirect call promotion. If the argument is not a
-    // function pointer, give up.
-    if (!isa<PointerType>(A->getType()) ||
-        !isa<FunctionType>(A->getType()->getPointerElementType()))
+    // pointer, give up.
+    if (!isa<PointerType>(A->getType()))
       return TotalCost;
 
-    // Since the argument is a function pointer, its incoming constant values
-    // should be functions or constant expressions. The code below attempts to
-    // look through cast expressions to find the function that will be called.
-    Value *CalledValue = C;
-    while (isa<ConstantExpr>(CalledValue) &&
-           cast<ConstantExpr>(CalledValue)->isCast())
-      CalledValue = cast<User>(CalledValue)->getOperand(0);
-    Function *CalledFunction = dyn_cast<Function>(CalledValue);
+    // The incoming constant value of a function pointer should be a function
+    // or a constant expression. Look through casts, which also covers callbacks
+    // passed through a generic pointer type, to find the function that will be
+    // called.
+    Function *CalledFunction = dyn_cast<Function>(C->stripPointerCasts());
     if (!CalledFunction)
       return TotalCost;
 
@@ -580,7 +662,7 @@ private:
       if (!isa<CallInst>(U) && !isa<InvokeInst>(U))
         continue;
       auto *CS = cast<CallBase>(U);
-      if (CS->getCalledOperand() != A)
+      if (CS->getCalledOperand()->stripPointerCasts() != A)
         continue;
 
       // Get the cost of inlining the called function at this call site. Note
@@ -700,7 +782,10 @@ private:
           if (!SpecializeOnAddresses)
             return false;
 
-        if (!GV->getValueType()->isSingleValueType())
+        // The address of a constant aggregate, e.g. a table of callbacks, is
+        // fine to specialize on: loads from it fold in the specialization.
+        if (!GV->getValueType()->isSingleValueType() &&
+            !(GV->isConstant() && SpecializeOnConstantAggregates))
           return false;
       }
 
@@ -775,9 +860,11 @@ bool llvm::runFunctionSpecialization(
     std::function<TargetLibraryInfo &(Function &)> GetTLI,
     std::function<TargetTransformInfo &(Function &)> GetTTI,
     std::function<AssumptionCache &(Function &)> GetAC,
-    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis) {
+    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis,
+    std::function<BlockFrequencyInfo &(Function &)> GetBFI,
+    ProfileSummaryInfo *PSI) {
   SCCPSolver Solver(DL, GetTLI, M.getContext());
-  FunctionSpecializer FS(Solver, GetAC, GetTTI, GetTLI);
+  FunctionSpecializer FS(Solver, GetAC, GetTTI, GetTLI, GetBFI, PSI, M);
   bool Changed = false;
 
   // Loop over all functions, marking arguments to those with their addresses
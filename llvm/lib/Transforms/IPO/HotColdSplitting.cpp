@@ -29,6 +29,7 @@
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/BranchProbabilityInfo.h"
 #include "llvm/Analysis/CFG.h"
@@ -75,6 +76,8 @@
 
 STATISTIC(NumColdRegionsFound, "Number of cold regions found.");
 STATISTIC(NumColdRegionsOutlined, "Number of cold regions outlined.");
+STATISTIC(NumColdInstructionsOutlined,
+          "Number of instructions moved out of hot functions.");
 
 using namespace llvm;
 
@@ -97,6 +100,13 @@ static cl::opt<std::string>
                     cl::desc("Name for the section containing cold functions "
                              "extracted by hot-cold splitting."));
 
+static cl::opt<bool> UseSplitSection(
+    "hotcoldsplit-split-section", cl::init(false), cl::Hidden,
+    cl::desc("On ELF targets, place extracted cold functions in a "
+             ".text.split.<name> section, like the cold parts of functions "
+             "split by the machine function splitter, so that the linker "
+             "groups both together."));
+
 static cl::opt<int> MaxParametersForSplit(
     "hotcoldsplit-max-params", cl::init(4), cl::Hidden,
     cl::desc("Maximum number of parameters for a split function"));
@@ -380,10 +390,13 @@ Function *HotColdSplitting::extractColdRegion(
 
     if (EnableColdSection)
       OutF->setSection(ColdSectionName);
-    else {
-      if (OrigF->hasSection())
-        OutF->setSection(OrigF->getSection());
-    }
+    else if (OrigF->hasSection())
+      OutF->setSection(OrigF->getSection());
+    else if (UseSplitSection &&
+             Triple(OrigF->getParent()->getTargetTriple()).isOSBinFormatELF())
+      OutF->setSection((".text.split." + OutF->getName()).str());
+
+    NumColdInstructionsOutlined += OutF->getInstructionCount();
 
     markFunctionCold(*OutF, BFI != nullptr);
 
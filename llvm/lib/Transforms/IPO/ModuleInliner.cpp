@@ -44,6 +44,7 @@
 #include "llvm/IR/Value.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/CallPromotionUtils.h"
 #include "llvm/Transforms/Utils/Cloning.h"
@@ -63,6 +64,76 @@ static cl::opt<bool> InlineEnablePriorityOrder(
     "module-inline-enable-priority-order", cl::Hidden, cl::init(true),
     cl::desc("Enable the priority inline order for the module inliner"));
 
+namespace {
+enum class InlinePriorityMode { Size, ProfileWeighted };
+} // namespace
+
+static cl::opt<InlinePriorityMode> UseInlinePriority(
+    "module-inline-priority-mode", cl::Hidden,
+    cl::init(InlinePriorityMode::Size),
+    cl::desc("Choose the priority of the priority inline order"),
+    cl::values(clEnumValN(InlinePriorityMode::Size, "size",
+                          "Inline smaller callees first"),
+               clEnumValN(InlinePriorityMode::ProfileWeighted, "profile",
+                          "Inline the call sites with the highest product of "
+                          "hotness and estimated inlining benefit first")));
+
+namespace {
+/// Prefers call sites that are both hot and cheap to inline. The goodness of
+/// a call site is its hotness - its profile count, or its block frequency
+/// relative to the caller's entry without a profile - times the amount by
+/// which the estimated inline cost stays below the inline threshold. Ties go
+/// to the smaller callee.
+class ProfileWeightedPriority {
+public:
+  ProfileWeightedPriority(uint64_t Goodness, int Size)
+      : Goodness(Goodness), Size(Size) {}
+
+  static bool isMoreDesirable(const ProfileWeightedPriority &P1,
+                              const ProfileWeightedPriority &P2) {
+    if (P1.Goodness != P2.Goodness)
+      return P1.Goodness > P2.Goodness;
+    return P1.Size < P2.Size;
+  }
+
+  static ProfileWeightedPriority evaluate(CallBase *CB,
+                                          FunctionAnalysisManager &FAM,
+                                          ProfileSummaryInfo *PSI,
+                                          int Threshold) {
+    Function &Caller = *CB->getCaller();
+    Function &Callee = *CB->getCalledFunction();
+    const int Size = Callee.getInstructionCount();
+
+    auto GetAssumptionCache = [&](Function &F) -> AssumptionCache & {
+      return FAM.getResult<AssumptionAnalysis>(F);
+    };
+    Optional<int> Cost = getInliningCostEstimate(
+        *CB, FAM.getResult<TargetIRAnalysis>(Callee), GetAssumptionCache);
+    // Calls that cannot be inlined go last.
+    if (!Cost)
+      return ProfileWeightedPriority(0, Size);
+    const uint64_t Benefit = std::max<int64_t>(
+        static_cast<int64_t>(Threshold) - *Cost, 1);
+
+    auto &BFI = FAM.getResult<BlockFrequencyAnalysis>(Caller);
+    uint64_t Hotness = 0;
+    if (PSI && PSI->hasProfileSummary()) {
+      Hotness = PSI->getProfileCount(*CB, &BFI).getValueOr(0);
+    } else if (uint64_t EntryFreq = BFI.getEntryFreq()) {
+      Hotness = SaturatingMultiply<uint64_t>(
+                    BFI.getBlockFreq(CB->getParent()).getFrequency(), 100) /
+                EntryFreq;
+    }
+    // Keep cold call sites ordered by their benefit.
+    Hotness = SaturatingAdd<uint64_t>(Hotness, 1);
+    return ProfileWeightedPriority(SaturatingMultiply(Hotness, Benefit), Size);
+  }
+
+  uint64_t Goodness;
+  int Size;
+};
+} // namespace
+
 /// Return true if the specified inline history ID
 /// indicates an inline history that includes the specified function.
 static bool inlineHistoryIncludes(
@@ -152,7 +223,14 @@ PreservedAnalyses ModuleInlinerPass::run(Module &M,
   // TODO: Here is a huge amount duplicate code between the module inliner and
   // the SCC inliner, which need some refactoring.
   std::unique_ptr<InlineOrder<std::pair<CallBase *, int>>> Calls;
-  if (InlineEnablePriorityOrder)
+  if (InlineEnablePriorityOrder &&
+      UseInlinePriority == InlinePriorityMode::ProfileWeighted) {
+    const int Threshold = Params.DefaultThreshold;
+    Calls = std::make_unique<PriorityInlineOrder<ProfileWeightedPriority>>(
+        [&FAM, PSI, Threshold](CallBase *CB) {
+          return ProfileWeightedPriority::evaluate(CB, FAM, PSI, Threshold);
+        });
+  } else if (InlineEnablePriorityOrder)
     Calls = std::make_unique<PriorityInlineOrder<InlineSizePriority>>();
   else
     Calls = std::make_unique<DefaultInlineOrder<std::pair<CallBase *, int>>>();
@@ -12,7 +12,9 @@
 
 #include "llvm/Transforms/IPO/SCCP.h"
 #include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/PostDominators.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/InitializePasses.h"
@@ -124,8 +126,13 @@ PreservedAnalyses FunctionSpecializationPass::run(Module &M,
                 F, DT, FAM.getResult<AssumptionAnalysis>(F)),
             &DT, FAM.getCachedResult<PostDominatorTreeAnalysis>(F)};
   };
+  auto GetBFI = [&FAM](Function &F) -> BlockFrequencyInfo & {
+    return FAM.getResult<BlockFrequencyAnalysis>(F);
+  };
+  auto *PSI = &AM.getResult<ProfileSummaryAnalysis>(M);
 
-  if (!runFunctionSpecialization(M, DL, GetTLI, GetTTI, GetAC, GetAnalysis))
+  if (!runFunctionSpecialization(M, DL, GetTLI, GetTTI, GetAC, GetAnalysis,
+                                 GetBFI, PSI))
     return PreservedAnalyses::all();
 
   PreservedAnalyses PA;
@@ -52,6 +52,7 @@ class DataLayout;
 class DominatorTree;
 class GEPOperator;
 class GlobalVariable;
+struct InstCombineVisitProfile;
 class LoopInfo;
 class OptimizationRemarkEmitter;
 class ProfileSummaryInfo;
@@ -73,6 +74,10 @@ public:
 
   virtual ~InstCombinerImpl() {}
 
+  /// If set, the time spent in and the number of combines made by visit() are
+  /// recorded here for every instruction visited.
+  InstCombineVisitProfile *VisitProfile = nullptr;
+
   /// Run the combiner over the entire worklist until it is empty.
   ///
   /// \returns true if the IR is changed.
@@ -98,12 +98,14 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/DebugCounter.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
 #include "llvm/Transforms/Utils/Local.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -117,6 +119,10 @@ using namespace llvm::PatternMatch;
 
 STATISTIC(NumWorklistIterations,
           "Number of instruction combining iterations performed");
+STATISTIC(NumNoChangeIterations,
+          "Number of instruction combining iterations that changed nothing");
+STATISTIC(NumIterationLimitReached,
+          "Number of functions where the iteration limit was reached");
 
 STATISTIC(NumCombined , "Number of insts combined");
 STATISTIC(NumConstProp, "Number of constant folds");
@@ -151,6 +157,11 @@ static cl::opt<unsigned> InfiniteLoopDetectionThreshold(
              "infinite loop"),
     cl::init(InstCombineDefaultInfiniteLoopThreshold), cl::Hidden);
 
+static cl::opt<bool> ProfileVisits(
+    "instcombine-profile-visits", cl::Hidden, cl::init(false),
+    cl::desc("Print the time spent and the number of combines made per "
+             "opcode for every function instcombine runs on"));
+
 static cl::opt<unsigned>
 MaxArraySize("instcombine-maxarray-size", cl::init(1024),
              cl::desc("Maximum array size considered when doing a combine"));
@@ -3959,6 +3970,46 @@ static bool TryToSinkInstruction(Instruction *I, BasicBlock *DestBlock,
   return true;
 }
 
+namespace llvm {
+/// Time spent in and combines made by InstCombinerImpl::visit(), per opcode.
+struct InstCombineVisitProfile {
+  struct Entry {
+    unsigned Visits = 0;
+    unsigned Combines = 0;
+    std::chrono::nanoseconds Time{0};
+  };
+  Entry Opcodes[Instruction::OtherOpsEnd];
+
+  void record(unsigned Opcode, bool Combined, std::chrono::nanoseconds Time) {
+    Entry &E = Opcodes[Opcode];
+    ++E.Visits;
+    E.Combines += Combined;
+    E.Time += Time;
+  }
+
+  /// Prints the opcodes that were visited, most expensive first.
+  void print(raw_ostream &OS, const Function &F, unsigned Iterations) const {
+    SmallVector<unsigned, 32> Visited;
+    for (unsigned Opcode = 0; Opcode != Instruction::OtherOpsEnd; ++Opcode)
+      if (Opcodes[Opcode].Visits)
+        Visited.push_back(Opcode);
+    llvm::stable_sort(Visited, [&](unsigned LHS, unsigned RHS) {
+      return Opcodes[LHS].Time > Opcodes[RHS].Time;
+    });
+
+    OS << "InstCombine visits in '" << F.getName() << "' (" << Iterations
+       << " iterations):\n";
+    OS << "  Opcode               Visits   Combines    Time (ms)\n";
+    for (unsigned Opcode : Visited) {
+      const Entry &E = Opcodes[Opcode];
+      OS << format("  %-16s %10u %10u %12.3f\n",
+                   Instruction::getOpcodeName(Opcode), E.Visits, E.Combines,
+                   std::chrono::duration<double, std::milli>(E.Time).count());
+    }
+  }
+};
+} // end namespace llvm
+
 bool InstCombinerImpl::run() {
   while (!Worklist.isEmpty()) {
     // Walk deferred instructions in reverse order, and push them to the
@@ -4085,7 +4136,18 @@ bool InstCombinerImpl::run() {
     LLVM_DEBUG(raw_string_ostream SS(OrigI); I->print(SS); OrigI = SS.str(););
     LLVM_DEBUG(dbgs() << "IC: Visiting: " << OrigI << '\n');
 
-    if (Instruction *Result = visit(*I)) {
+    Instruction *Result;
+    if (LLVM_UNLIKELY(VisitProfile)) {
+      unsigned Opcode = I->getOpcode();
+      auto Start = std::chrono::steady_clock::now();
+      Result = visit(*I);
+      VisitProfile->record(Opcode, Result != nullptr,
+                           std::chrono::steady_clock::now() - Start);
+    } else {
+      Result = visit(*I);
+    }
+
+    if (Result) {
       ++NumCombined;
       // Should we replace the old instruction with a new one?
       if (Result != I) {
@@ -4345,6 +4407,10 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
+  std::unique_ptr<InstCombineVisitProfile> VisitProfile;
+  if (ProfileVisits)
+    VisitProfile = std::make_unique<InstCombineVisitProfile>();
+
   // Iterate while there is work to do.
   unsigned Iteration = 0;
   while (true) {
@@ -4361,6 +4427,7 @@ static bool combineInstructionsOverFunction(
       LLVM_DEBUG(dbgs() << "\n\n[IC] Iteration limit #" << MaxIterations
                         << " on " << F.getName()
                         << " reached; stopping before reaching a fixpoint\n");
+      ++NumIterationLimitReached;
       break;
     }
 
@@ -4372,13 +4439,19 @@ static bool combineInstructionsOverFunction(
     InstCombinerImpl IC(Worklist, Builder, F.hasMinSize(), AA, AC, TLI, TTI, DT,
                         ORE, BFI, PSI, DL, LI);
     IC.MaxArraySizeForCombine = MaxArraySize;
+    IC.VisitProfile = VisitProfile.get();
 
-    if (!IC.run())
+    if (!IC.run()) {
+      ++NumNoChangeIterations;
       break;
+    }
 
     MadeIRChange = true;
   }
 
+  if (VisitProfile)
+    VisitProfile->print(errs(), F, std::min(Iteration, MaxIterations));
+
   return MadeIRChange;
 }
 
@@ -79,6 +79,13 @@ cl::opt<bool>
                              cl::desc("Enable relocating counters at runtime."),
                              cl::init(false));
 
+cl::opt<bool> CounterSharding(
+    "instrprof-counter-shards", cl::ZeroOrMore,
+    cl::desc("Increment the counters in per-thread shards which the runtime "
+             "folds into the counters before dumping the profile, to avoid "
+             "contention on hot counters in multi-threaded programs"),
+    cl::init(false));
+
 cl::opt<bool> ValueProfileStaticAlloc(
     "vp-static-alloc",
     cl::desc("Do static counter allocation for value profiler"),
@@ -485,6 +492,14 @@ bool InstrProfiling::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+bool InstrProfiling::isCounterShardingEnabled() const {
+  // The runtime detects the use of shards through a weak external reference,
+  // like with runtime counter relocation which takes precedence.
+  if (!TT.isOSBinFormatELF() || isRuntimeCounterRelocationEnabled())
+    return false;
+  return CounterSharding;
+}
+
 bool InstrProfiling::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -555,6 +570,7 @@ bool InstrProfiling::run(
   NamesVar = nullptr;
   NamesSize = 0;
   ProfileDataMap.clear();
+  FunctionToShardOffsetMap.clear();
   CompilerUsedVars.clear();
   UsedVars.clear();
   TT = Triple(M.getTargetTriple());
@@ -731,6 +747,56 @@ Value *InstrProfiling::getCounterAddress(InstrProfInstBase *I) {
   return Builder.CreateIntToPtr(Add, Addr->getType());
 }
 
+Value *InstrProfiling::getCounterShardOffset(Function *F) {
+  Value *&Offset = FunctionToShardOffsetMap[F];
+  if (Offset)
+    return Offset;
+
+  Type *Int64Ty = Type::getInt64Ty(M->getContext());
+  auto *ShardsTy = ArrayType::get(Int64Ty, 3);
+  auto *Shards = M->getGlobalVariable(getInstrProfCounterShardsVarName());
+  if (!Shards) {
+    // Like the counter bias, the compiler must define this variable and the
+    // runtime has a weak external reference to check whether that's the case.
+    // The runtime sets it to {bias, size, mask} once the shards are allocated;
+    // until then every thread uses the counters themselves.
+    Shards = new GlobalVariable(*M, ShardsTy, false,
+                                GlobalValue::LinkOnceODRLinkage,
+                                Constant::getNullValue(ShardsTy),
+                                getInstrProfCounterShardsVarName());
+    Shards->setVisibility(GlobalVariable::HiddenVisibility);
+    if (TT.supportsCOMDAT())
+      Shards->setComdat(M->getOrInsertComdat(Shards->getName()));
+  }
+  auto *Anchor = M->getGlobalVariable(getInstrProfThreadAnchorVarName());
+  if (!Anchor) {
+    Type *Int8Ty = Type::getInt8Ty(M->getContext());
+    Anchor = new GlobalVariable(
+        *M, Int8Ty, false, GlobalValue::LinkOnceODRLinkage,
+        Constant::getNullValue(Int8Ty), getInstrProfThreadAnchorVarName(),
+        nullptr, GlobalValue::GeneralDynamicTLSModel);
+    Anchor->setVisibility(GlobalVariable::HiddenVisibility);
+    if (TT.supportsCOMDAT())
+      Anchor->setComdat(M->getOrInsertComdat(Anchor->getName()));
+  }
+
+  IRBuilder<> Builder(&*F->getEntryBlock().getFirstInsertionPt());
+  auto *Bias = Builder.CreateLoad(
+      Int64Ty, Builder.CreateConstInBoundsGEP2_32(ShardsTy, Shards, 0, 0));
+  auto *Size = Builder.CreateLoad(
+      Int64Ty, Builder.CreateConstInBoundsGEP2_32(ShardsTy, Shards, 0, 1));
+  auto *Mask = Builder.CreateLoad(
+      Int64Ty, Builder.CreateConstInBoundsGEP2_32(ShardsTy, Shards, 0, 2));
+  // The thread local anchor has a distinct address in every thread. Hash its
+  // page number to spread the threads over the shards.
+  Value *Hash = Builder.CreateLShr(Builder.CreatePtrToInt(Anchor, Int64Ty), 12);
+  Hash = Builder.CreateLShr(
+      Builder.CreateMul(Hash, Builder.getInt64(0x9E3779B97F4A7C15ULL)), 32);
+  Value *Shard = Builder.CreateAnd(Hash, Mask);
+  Offset = Builder.CreateAdd(Bias, Builder.CreateMul(Shard, Size));
+  return Offset;
+}
+
 void InstrProfiling::lowerCover(InstrProfCoverInst *CoverInstruction) {
   auto *Addr = getCounterAddress(CoverInstruction);
   IRBuilder<> Builder(CoverInstruction);
@@ -740,9 +806,16 @@ void InstrProfiling::lowerCover(InstrProfCoverInst *CoverInstruction) {
 }
 
 void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
-  auto *Addr = getCounterAddress(Inc);
+  Value *Addr = getCounterAddress(Inc);
 
   IRBuilder<> Builder(Inc);
+  if (isCounterShardingEnabled()) {
+    Type *Int64Ty = Builder.getInt64Ty();
+    Value *Offset = getCounterShardOffset(Inc->getFunction());
+    Addr = Builder.CreateIntToPtr(
+        Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty), Offset),
+        Addr->getType());
+  }
   if (Options.Atomic || AtomicCounterUpdateAll ||
       (Inc->getIndex()->isZeroValue() && AtomicFirstCounter)) {
     Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, Inc->getStep(),
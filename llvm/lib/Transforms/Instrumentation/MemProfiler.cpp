@@ -19,12 +19,16 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/LLVMContext.h"
@@ -33,12 +37,17 @@
 #include "llvm/IR/Value.h"
 #include "llvm/InitializePasses.h"
 #include "llvm/Pass.h"
+#include "llvm/ProfileData/MemProf.h"
+#include "llvm/ProfileData/RawMemProfReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Transforms/Instrumentation.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
 
+#include <map>
+#include <tuple>
+
 using namespace llvm;
 
 #define DEBUG_TYPE "memprof"
@@ -113,6 +122,34 @@ static cl::opt<bool> ClStack("memprof-instrument-stack",
                              cl::desc("Instrument scalar stack variables"),
                              cl::Hidden, cl::init(false));
 
+static cl::opt<std::string>
+    ClMemoryProfileFile("memprof-use-file",
+                        cl::desc("The raw memory profile to annotate the "
+                                 "allocation calls with"),
+                        cl::Hidden);
+
+static cl::opt<std::string>
+    ClProfiledBinary("memprof-profiled-binary",
+                     cl::desc("The binary which produced the raw memory "
+                              "profile, to symbolize its call stacks"),
+                     cl::Hidden);
+
+static cl::opt<bool> ClOptimizeHotColdNew(
+    "memprof-optimize-hot-cold-new",
+    cl::desc("Pass the profiled behavior of the allocations as a hint to the "
+             "__hot_cold_t variants of operator new"),
+    cl::Hidden, cl::init(false));
+
+static cl::opt<unsigned>
+    ClColdNewHintValue("memprof-cold-new-hint-value",
+                       cl::desc("The hint passed for cold allocations"),
+                       cl::Hidden, cl::init(1));
+
+static cl::opt<unsigned>
+    ClHotNewHintValue("memprof-hot-new-hint-value",
+                      cl::desc("The hint passed for hot allocations"),
+                      cl::Hidden, cl::init(254));
+
 // Debug flags.
 
 static cl::opt<int> ClDebug("memprof-debug", cl::desc("debug"), cl::Hidden,
@@ -131,6 +168,9 @@ STATISTIC(NumInstrumentedReads, "Number of instrumented reads");
 STATISTIC(NumInstrumentedWrites, "Number of instrumented writes");
 STATISTIC(NumSkippedStackReads, "Number of non-instrumented stack reads");
 STATISTIC(NumSkippedStackWrites, "Number of non-instrumented stack writes");
+STATISTIC(NumColdAllocations, "Number of allocations annotated as cold");
+STATISTIC(NumHotAllocations, "Number of allocations annotated as hot");
+STATISTIC(NumNotColdAllocations, "Number of allocations annotated as notcold");
 
 namespace {
 
@@ -649,3 +689,175 @@ bool MemProfiler::instrumentFunction(Function &F) {
 
   return FunctionModified;
 }
+
+namespace {
+
+// The key of the allocation frame of a profiled context: the linkage name of
+// the function, and the line offset and column of the call.
+using AllocSiteKey = std::tuple<std::string, uint32_t, uint32_t>;
+
+} // namespace
+
+// Return the name of the variant of the operator new \p LF taking an
+// additional __hot_cold_t hint, as provided by tcmalloc, or an empty string.
+static StringRef getHotColdNewName(LibFunc LF) {
+  switch (LF) {
+  case LibFunc_Znwm:
+    return "_Znwm12__hot_cold_t";
+  case LibFunc_ZnwmRKSt9nothrow_t:
+    return "_ZnwmRKSt9nothrow_t12__hot_cold_t";
+  case LibFunc_ZnwmSt11align_val_t:
+    return "_ZnwmSt11align_val_t12__hot_cold_t";
+  case LibFunc_ZnwmSt11align_val_tRKSt9nothrow_t:
+    return "_ZnwmSt11align_val_tRKSt9nothrow_t12__hot_cold_t";
+  case LibFunc_Znam:
+    return "_Znam12__hot_cold_t";
+  case LibFunc_ZnamRKSt9nothrow_t:
+    return "_ZnamRKSt9nothrow_t12__hot_cold_t";
+  case LibFunc_ZnamSt11align_val_t:
+    return "_ZnamSt11align_val_t12__hot_cold_t";
+  case LibFunc_ZnamSt11align_val_tRKSt9nothrow_t:
+    return "_ZnamSt11align_val_tRKSt9nothrow_t12__hot_cold_t";
+  default:
+    return "";
+  }
+}
+
+// Replace the allocation call \p CB with a call to \p HotColdName, passing
+// \p Hint as the additional last argument.
+static void replaceWithHotColdNew(CallBase *CB, StringRef HotColdName,
+                                  uint8_t Hint) {
+  Module *M = CB->getModule();
+  FunctionType *OrigTy = CB->getFunctionType();
+  SmallVector<Type *, 4> Params(OrigTy->params().begin(),
+                                OrigTy->params().end());
+  Params.push_back(Type::getInt8Ty(M->getContext()));
+  FunctionType *FTy =
+      FunctionType::get(OrigTy->getReturnType(), Params, /*isVarArg=*/false);
+  FunctionCallee Callee = M->getOrInsertFunction(HotColdName, FTy);
+
+  IRBuilder<> IRB(CB);
+  SmallVector<Value *, 4> Args(CB->args());
+  Args.push_back(IRB.getInt8(Hint));
+  SmallVector<OperandBundleDef, 1> Bundles;
+  CB->getOperandBundlesAsDefs(Bundles);
+  CallBase *NewCB;
+  if (auto *II = dyn_cast<InvokeInst>(CB))
+    NewCB = IRB.CreateInvoke(Callee, II->getNormalDest(), II->getUnwindDest(),
+                             Args, Bundles);
+  else
+    NewCB = IRB.CreateCall(Callee, Args, Bundles);
+  // The return and parameter attributes, e.g. noalias and nonnull, still hold
+  // for the new call.
+  NewCB->setAttributes(CB->getAttributes());
+  NewCB->setCallingConv(CB->getCallingConv());
+  NewCB->setDebugLoc(CB->getDebugLoc());
+  NewCB->takeName(CB);
+  CB->replaceAllUsesWith(NewCB);
+  CB->eraseFromParent();
+}
+
+MemProfUsePass::MemProfUsePass(std::string MemoryProfileFile,
+                               std::string ProfiledBinary)
+    : MemoryProfileFileName(std::move(MemoryProfileFile)),
+      ProfiledBinaryFileName(std::move(ProfiledBinary)) {
+  if (!ClMemoryProfileFile.empty())
+    MemoryProfileFileName = ClMemoryProfileFile;
+  if (!ClProfiledBinary.empty())
+    ProfiledBinaryFileName = ClProfiledBinary;
+}
+
+PreservedAnalyses MemProfUsePass::run(Module &M, ModuleAnalysisManager &AM) {
+  LLVMContext &Ctx = M.getContext();
+  auto ReaderOr = memprof::RawMemProfReader::create(MemoryProfileFileName,
+                                                    ProfiledBinaryFileName);
+  if (Error E = ReaderOr.takeError()) {
+    Ctx.diagnose(DiagnosticInfoPGOProfile(MemoryProfileFileName.data(),
+                                          toString(std::move(E))));
+    return PreservedAnalyses::all();
+  }
+  auto RecordsOr = ReaderOr.get()->readRecords();
+  if (Error E = RecordsOr.takeError()) {
+    Ctx.diagnose(DiagnosticInfoPGOProfile(MemoryProfileFileName.data(),
+                                          toString(std::move(E))));
+    return PreservedAnalyses::all();
+  }
+
+  // The contexts are only told apart by their allocation frame, so the
+  // contexts allocating from the same call are merged.
+  std::map<AllocSiteKey, memprof::MemInfoBlock> AllocSites;
+  for (const memprof::MemProfRecord &Record : *RecordsOr) {
+    const memprof::Frame &Leaf = Record.CallStack.front();
+    AllocSiteKey Key(Leaf.Function, Leaf.LineOffset, Leaf.Column);
+    auto Inserted = AllocSites.emplace(Key, Record.Info);
+    if (!Inserted.second)
+      Inserted.first->second.Merge(Record.Info);
+  }
+  if (AllocSites.empty())
+    return PreservedAnalyses::all();
+
+  auto &FAM = AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  bool Changed = false;
+  for (Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+    const TargetLibraryInfo &TLI = FAM.getResult<TargetLibraryAnalysis>(F);
+    SmallVector<std::pair<CallBase *, memprof::AllocationType>, 4> Annotated;
+    for (Instruction &I : instructions(F)) {
+      auto *CB = dyn_cast<CallBase>(&I);
+      if (!CB)
+        continue;
+      Function *Callee = CB->getCalledFunction();
+      LibFunc LF;
+      if (!Callee || !TLI.getLibFunc(*Callee, LF) ||
+          getHotColdNewName(LF).empty())
+        continue;
+      // The frames of inlined code are named after the inlined function.
+      const DILocation *DIL = CB->getDebugLoc();
+      if (!DIL)
+        continue;
+      const DISubprogram *SP = DIL->getScope()->getSubprogram();
+      if (!SP)
+        continue;
+      StringRef Name = SP->getLinkageName();
+      if (Name.empty())
+        Name = SP->getName();
+      auto It = AllocSites.find(AllocSiteKey(
+          Name.str(), DIL->getLine() - SP->getLine(), DIL->getColumn()));
+      if (It == AllocSites.end())
+        continue;
+
+      const memprof::AllocationType Type = memprof::getAllocType(It->second);
+      CB->addFnAttr(Attribute::get(
+          Ctx, "memprof", memprof::getAllocTypeAttributeString(Type)));
+      switch (Type) {
+      case memprof::AllocationType::Cold:
+        ++NumColdAllocations;
+        break;
+      case memprof::AllocationType::Hot:
+        ++NumHotAllocations;
+        break;
+      case memprof::AllocationType::NotCold:
+        ++NumNotColdAllocations;
+        break;
+      }
+      Annotated.push_back({CB, Type});
+      Changed = true;
+    }
+
+    if (!ClOptimizeHotColdNew)
+      continue;
+    for (auto &Alloc : Annotated) {
+      if (Alloc.second == memprof::AllocationType::NotCold)
+        continue;
+      LibFunc LF;
+      TLI.getLibFunc(*Alloc.first->getCalledFunction(), LF);
+      replaceWithHotColdNew(Alloc.first, getHotColdNewName(LF),
+                            Alloc.second == memprof::AllocationType::Cold
+                                ? ClColdNewHintValue
+                                : ClHotNewHintValue);
+    }
+  }
+
+  return Changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
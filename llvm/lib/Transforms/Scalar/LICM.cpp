@@ -1897,9 +1897,12 @@ public:
             MSSAU->createMemoryAccessAfter(NewSI, nullptr, MSSAInsertPoint);
       }
       MSSAInsertPts[i] = NewMemAcc;
-      MSSAU->insertDef(cast<MemoryDef>(NewMemAcc), true);
-      // FIXME: true for safety, false may still be correct.
+      MSSAU->insertDefDeferringRename(cast<MemoryDef>(NewMemAcc));
+      // FIXME: renaming for safety, not renaming may still be correct.
     }
+    // Rename the uses below all exit blocks at once, rather than once per
+    // exit block.
+    MSSAU->renameDeferredUses();
   }
 
   void doExtraRewritesBeforeFinalDeletion() override {
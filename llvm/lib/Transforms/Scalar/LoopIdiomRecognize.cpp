@@ -110,6 +110,8 @@ using namespace llvm;
 STATISTIC(NumMemSet, "Number of memset's formed from loop stores");
 STATISTIC(NumMemCpy, "Number of memcpy's formed from loop load+stores");
 STATISTIC(NumMemMove, "Number of memmove's formed from loop load+stores");
+STATISTIC(NumMemChr, "Number of memchr's formed from loop searches");
+STATISTIC(NumStrLen, "Number of strlen's formed from loop searches");
 STATISTIC(
     NumShiftUntilBitTest,
     "Number of uncountable loops recognized as 'shift until bitttest' idiom");
@@ -139,6 +141,22 @@ static cl::opt<bool, true>
                       cl::location(DisableLIRP::Memcpy), cl::init(false),
                       cl::ReallyHidden);
 
+bool DisableLIRP::Memchr;
+static cl::opt<bool, true>
+    DisableLIRPMemchr("disable-" DEBUG_TYPE "-memchr",
+                      cl::desc("Proceed with loop idiom recognize pass, but do "
+                               "not convert loop(s) to memchr."),
+                      cl::location(DisableLIRP::Memchr), cl::init(false),
+                      cl::ReallyHidden);
+
+bool DisableLIRP::Strlen;
+static cl::opt<bool, true>
+    DisableLIRPStrlen("disable-" DEBUG_TYPE "-strlen",
+                      cl::desc("Proceed with loop idiom recognize pass, but do "
+                               "not convert loop(s) to strlen."),
+                      cl::location(DisableLIRP::Strlen), cl::init(false),
+                      cl::ReallyHidden);
+
 static cl::opt<bool> UseLIRCodeSizeHeurs(
     "use-lir-code-size-heurs",
     cl::desc("Use loop idiom recognition code size heuristics when compiling"
@@ -252,6 +270,8 @@ private:
 
   bool recognizeShiftUntilBitTest();
   bool recognizeShiftUntilZero();
+  bool recognizeMemchr();
+  bool recognizeStrlen();
 
   /// @}
 };
@@ -365,7 +385,8 @@ bool LoopIdiomRecognize::runOnLoop(Loop *L) {
 
   // Disable loop idiom recognition if the function's name is a common idiom.
   StringRef Name = L->getHeader()->getParent()->getName();
-  if (Name == "memset" || Name == "memcpy")
+  if (Name == "memset" || Name == "memcpy" || Name == "memchr" ||
+      Name == "strlen")
     return false;
 
   // Determine if code size heuristics need to be applied.
@@ -1573,7 +1594,8 @@ bool LoopIdiomRecognize::runOnNoncountableLoop() {
                     << CurLoop->getHeader()->getName() << "\n");
 
   return recognizePopcount() || recognizeAndInsertFFS() ||
-         recognizeShiftUntilBitTest() || recognizeShiftUntilZero();
+         recognizeShiftUntilBitTest() || recognizeShiftUntilZero() ||
+         recognizeMemchr() || recognizeStrlen();
 }
 
 /// Check if the given conditional branch is based on the comparison between
@@ -2937,3 +2959,316 @@ bool LoopIdiomRecognize::recognizeShiftUntilZero() {
   ++NumShiftUntilZero;
   return MadeChange;
 }
+
+/// Return true if the value \p V, live out of the search loop \p L, can be
+/// recomputed from the iteration in which the loop exits.
+static bool canComputeSearchExitValue(Value *V, Loop *L, ScalarEvolution &SE) {
+  if (L->isLoopInvariant(V))
+    return true;
+  if (!SE.isSCEVable(V->getType()))
+    return false;
+  const SCEV *S = SE.getSCEV(V);
+  if (auto *AR = dyn_cast<SCEVAddRecExpr>(S))
+    return AR->getLoop() == L && AR->isAffine() &&
+           isSafeToExpand(AR->getStart(), SE) &&
+           isSafeToExpand(AR->getStepRecurrence(SE), SE);
+  return SE.isLoopInvariant(S, L) && isSafeToExpand(S, SE);
+}
+
+/// Expand at \p InsertPt the value that \p V, live out of the search loop
+/// \p L, has in iteration \p Iteration.
+static Value *expandSearchExitValue(Value *V, const SCEV *Iteration, Loop *L,
+                                    ScalarEvolution &SE,
+                                    SCEVExpander &Expander,
+                                    Instruction *InsertPt) {
+  if (L->isLoopInvariant(V))
+    return V;
+  const SCEV *S = SE.getSCEV(V);
+  if (auto *AR = dyn_cast<SCEVAddRecExpr>(S)) {
+    const SCEV *Step = AR->getStepRecurrence(SE);
+    S = SE.getAddExpr(
+        AR->getStart(),
+        SE.getMulExpr(SE.getTruncateOrZeroExtend(Iteration, Step->getType()),
+                      Step));
+  }
+  return Expander.expandCodeFor(S, V->getType(), InsertPt);
+}
+
+/// Make the header of the search loop \p L leave it in the first iteration,
+/// once its exit values have been recomputed in the preheader.
+static void exitSearchLoopInFirstIteration(Loop *L,
+                                           const TargetLibraryInfo *TLI,
+                                           MemorySSAUpdater *MSSAU) {
+  BasicBlock *Header = L->getHeader();
+  auto *HeaderBI = cast<BranchInst>(Header->getTerminator());
+  Value *OldCond = HeaderBI->getCondition();
+  HeaderBI->setCondition(ConstantInt::getBool(
+      Header->getContext(), !L->contains(HeaderBI->getSuccessor(0))));
+  RecursivelyDeleteTriviallyDeadInstructions(OldCond, TLI, MSSAU);
+  if (MSSAU && VerifyMemorySSA)
+    MSSAU->getMemorySSA()->verifyMemorySSA();
+}
+
+/// Recognize a loop that searches a range of bytes for the first occurrence of
+/// a loop-invariant byte, e.g.
+/// \code
+///   while (P != End && *P != C)
+///     ++P;
+/// \endcode
+/// The loop has two exiting blocks: one leaves when the byte is found, and the
+/// other has a computable exit count, which bounds the number of bytes read.
+/// The search is replaced with a call to memchr in the preheader. The values
+/// live out of the loop are recomputed from its result, and the header is made
+/// to exit in the first iteration, so that later passes delete the loop without
+/// this pass having to change the CFG.
+bool LoopIdiomRecognize::recognizeMemchr() {
+  if (DisableLIRP::Memchr || !TLI->has(LibFunc_memchr))
+    return false;
+
+  using namespace PatternMatch;
+
+  BasicBlock *Preheader = CurLoop->getLoopPreheader();
+  BasicBlock *Header = CurLoop->getHeader();
+  BasicBlock *Latch = CurLoop->getLoopLatch();
+  BasicBlock *ExitBB = CurLoop->getUniqueExitBlock();
+  if (!CurLoop->isInnermost() || CurLoop->getNumBlocks() != 2 || !Latch ||
+      !ExitBB || !CurLoop->hasDedicatedExits())
+    return false;
+
+  // Find the exiting block that leaves when the loaded byte equals the needle.
+  BasicBlock *SearchBB = nullptr;
+  LoadInst *Load = nullptr;
+  Value *Needle = nullptr;
+  for (BasicBlock *BB : {Header, Latch}) {
+    auto *BI = dyn_cast<BranchInst>(BB->getTerminator());
+    if (!BI || !BI->isConditional())
+      return false;
+    ICmpInst::Predicate Pred;
+    Value *LHS, *RHS;
+    if (!match(BI->getCondition(), m_ICmp(Pred, m_Value(LHS), m_Value(RHS))))
+      continue;
+    if (!isa<LoadInst>(LHS))
+      std::swap(LHS, RHS);
+    auto *L = dyn_cast<LoadInst>(LHS);
+    if (!L || !L->isSimple() || !L->getType()->isIntegerTy(8) ||
+        L->getPointerAddressSpace() != 0 || !CurLoop->isLoopInvariant(RHS))
+      continue;
+    bool ExitOnTrue = !CurLoop->contains(BI->getSuccessor(0));
+    if (!ICmpInst::isEquality(Pred) ||
+        (Pred == ICmpInst::ICMP_EQ) != ExitOnTrue)
+      continue;
+    if (SearchBB)
+      return false;
+    SearchBB = BB;
+    Load = L;
+    Needle = RHS;
+  }
+  if (!SearchBB)
+    return false;
+
+  BasicBlock *CountBB = SearchBB == Header ? Latch : Header;
+  const SCEV *ExitCount = SE->getExitCount(CurLoop, CountBB);
+  if (isa<SCEVCouldNotCompute>(ExitCount) || !isSafeToExpand(ExitCount, *SE))
+    return false;
+
+  for (BasicBlock *BB : CurLoop->blocks())
+    for (Instruction &I : *BB)
+      if (I.mayHaveSideEffects() || (I.mayReadFromMemory() && &I != Load))
+        return false;
+
+  auto *PtrEv =
+      dyn_cast<SCEVAddRecExpr>(SE->getSCEV(Load->getPointerOperand()));
+  if (!PtrEv || PtrEv->getLoop() != CurLoop || !PtrEv->isAffine() ||
+      !PtrEv->getStepRecurrence(*SE)->isOne() ||
+      !isSafeToExpand(PtrEv->getStart(), *SE))
+    return false;
+
+  // Every value live out of the loop must be computable from the iteration in
+  // which the loop exits.
+  for (PHINode &PN : ExitBB->phis())
+    if (!all_of(PN.incoming_values(), [&](Value *V) {
+          return canComputeSearchExitValue(V, CurLoop, *SE);
+        }))
+      return false;
+
+  LLVM_DEBUG(dbgs() << DEBUG_TYPE " memchr idiom found in loop %"
+                    << Header->getName() << "\n");
+
+  SE->forgetLoop(CurLoop);
+
+  // If the header searches, the loop reads one byte more than the number of
+  // times the count exit lets the backedge be taken.
+  Instruction *InsertPt = Preheader->getTerminator();
+  IRBuilder<> Builder(InsertPt);
+  SCEVExpander Expander(*SE, *DL, "memchr");
+  Type *IntPtrTy = DL->getIntPtrType(Load->getPointerOperandType());
+  Value *Start = Expander.expandCodeFor(
+      PtrEv->getStart(), Load->getPointerOperandType(), InsertPt);
+  const SCEV *NumBytes = SE->getTruncateOrZeroExtend(ExitCount, IntPtrTy);
+  if (SearchBB == Header)
+    NumBytes = SE->getAddExpr(NumBytes, SE->getOne(IntPtrTy), SCEV::FlagNUW);
+  Value *Len = Expander.expandCodeFor(NumBytes, IntPtrTy, InsertPt);
+  Value *Char = Builder.CreateZExt(Needle, Builder.getInt32Ty());
+  Value *Result = emitMemChr(Start, Char, Len, Builder, *DL, TLI);
+  assert(Result && "memchr is available");
+  auto *NewCall = cast<CallInst>(Result);
+  NewCall->setDebugLoc(Load->getDebugLoc());
+  if (MSSAU) {
+    MemoryAccess *NewMemAcc = MSSAU->createMemoryAccessInBB(
+        NewCall, nullptr, Preheader, MemorySSA::BeforeTerminator);
+    if (auto *NewMemUse = dyn_cast<MemoryUse>(NewMemAcc))
+      MSSAU->insertUse(NewMemUse, true);
+    else
+      MSSAU->insertDef(cast<MemoryDef>(NewMemAcc), true);
+  }
+
+  Value *Found = Builder.CreateICmpNE(
+      Result, Constant::getNullValue(Result->getType()), "memchr.found");
+  Value *Index = Builder.CreateSub(Builder.CreatePtrToInt(Result, IntPtrTy),
+                                   Builder.CreatePtrToInt(Start, IntPtrTy),
+                                   "memchr.index");
+  const SCEV *FoundIteration = SE->getSCEV(Index);
+
+  auto ExpandExitValue = [&](Value *V, const SCEV *Iteration) {
+    return expandSearchExitValue(V, Iteration, CurLoop, *SE, Expander,
+                                 InsertPt);
+  };
+
+  // The value leaving through the search exit is the one of the iteration
+  // memchr stopped at; if nothing was found, the loop leaves through the count
+  // exit in the iteration given by its exit count. Expanding the first one
+  // when nothing was found can only produce poison, which the select drops.
+  for (PHINode &PN : ExitBB->phis()) {
+    SE->forgetValue(&PN);
+    Value *FoundValue = ExpandExitValue(PN.getIncomingValueForBlock(SearchBB),
+                                        FoundIteration);
+    Value *EndValue =
+        ExpandExitValue(PN.getIncomingValueForBlock(CountBB), ExitCount);
+    Value *Exit = FoundValue == EndValue
+                      ? FoundValue
+                      : Builder.CreateSelect(Found, FoundValue, EndValue,
+                                             PN.getName() + ".memchr");
+    for (unsigned I = 0, E = PN.getNumIncomingValues(); I != E; ++I)
+      PN.setIncomingValue(I, Exit);
+  }
+
+  exitSearchLoopInFirstIteration(CurLoop, TLI, MSSAU.get());
+
+  ORE.emit([&]() {
+    return OptimizationRemark(DEBUG_TYPE, "ProcessLoopMemchr",
+                              NewCall->getDebugLoc(), Preheader)
+           << "Transformed loop search in "
+           << ore::NV("Function", Header->getParent())
+           << " function into a call to "
+           << ore::NV("NewFunction", NewCall->getCalledFunction()) << "()";
+  });
+
+  ++NumMemChr;
+  return true;
+}
+
+/// Recognize a loop that searches for the terminator of a string, e.g.
+/// \code
+///   while (*P)
+///     ++P;
+/// \endcode
+/// Unlike the memchr idiom the loop has a single exit, which the header takes
+/// when the loaded byte is zero. The search is replaced with a call to strlen
+/// in the preheader and, as for memchr, the values live out of the loop are
+/// recomputed from its result and the header is made to exit in the first
+/// iteration.
+bool LoopIdiomRecognize::recognizeStrlen() {
+  if (DisableLIRP::Strlen || !TLI->has(LibFunc_strlen))
+    return false;
+
+  using namespace PatternMatch;
+
+  BasicBlock *Preheader = CurLoop->getLoopPreheader();
+  BasicBlock *Header = CurLoop->getHeader();
+  BasicBlock *ExitBB = CurLoop->getUniqueExitBlock();
+  if (!CurLoop->isInnermost() || CurLoop->getExitingBlock() != Header ||
+      !ExitBB || !CurLoop->hasDedicatedExits())
+    return false;
+
+  auto *BI = dyn_cast<BranchInst>(Header->getTerminator());
+  if (!BI || !BI->isConditional())
+    return false;
+  ICmpInst::Predicate Pred;
+  Value *LoadedByte;
+  if (!match(BI->getCondition(), m_ICmp(Pred, m_Value(LoadedByte), m_Zero())))
+    return false;
+  auto *Load = dyn_cast<LoadInst>(LoadedByte);
+  if (!Load || !CurLoop->contains(Load) || !Load->isSimple() ||
+      !Load->getType()->isIntegerTy(8) || Load->getPointerAddressSpace() != 0)
+    return false;
+  bool ExitOnTrue = !CurLoop->contains(BI->getSuccessor(0));
+  if (!ICmpInst::isEquality(Pred) || (Pred == ICmpInst::ICMP_EQ) != ExitOnTrue)
+    return false;
+
+  for (BasicBlock *BB : CurLoop->blocks())
+    for (Instruction &I : *BB)
+      if (I.mayHaveSideEffects() || (I.mayReadFromMemory() && &I != Load))
+        return false;
+
+  auto *PtrEv =
+      dyn_cast<SCEVAddRecExpr>(SE->getSCEV(Load->getPointerOperand()));
+  if (!PtrEv || PtrEv->getLoop() != CurLoop || !PtrEv->isAffine() ||
+      !PtrEv->getStepRecurrence(*SE)->isOne() ||
+      !isSafeToExpand(PtrEv->getStart(), *SE))
+    return false;
+
+  for (PHINode &PN : ExitBB->phis())
+    if (!all_of(PN.incoming_values(), [&](Value *V) {
+          return canComputeSearchExitValue(V, CurLoop, *SE);
+        }))
+      return false;
+
+  LLVM_DEBUG(dbgs() << DEBUG_TYPE " strlen idiom found in loop %"
+                    << Header->getName() << "\n");
+
+  SE->forgetLoop(CurLoop);
+
+  Instruction *InsertPt = Preheader->getTerminator();
+  IRBuilder<> Builder(InsertPt);
+  SCEVExpander Expander(*SE, *DL, "strlen");
+  Value *Start = Expander.expandCodeFor(
+      PtrEv->getStart(), Load->getPointerOperandType(), InsertPt);
+  Value *Result = emitStrLen(Start, Builder, *DL, TLI);
+  assert(Result && "strlen is available");
+  auto *NewCall = cast<CallInst>(Result);
+  NewCall->setDebugLoc(Load->getDebugLoc());
+  if (MSSAU) {
+    MemoryAccess *NewMemAcc = MSSAU->createMemoryAccessInBB(
+        NewCall, nullptr, Preheader, MemorySSA::BeforeTerminator);
+    if (auto *NewMemUse = dyn_cast<MemoryUse>(NewMemAcc))
+      MSSAU->insertUse(NewMemUse, true);
+    else
+      MSSAU->insertDef(cast<MemoryDef>(NewMemAcc), true);
+  }
+
+  // The header leaves in the iteration that loads the terminator, which is
+  // the length of the string.
+  const SCEV *ExitIteration = SE->getSCEV(Result);
+  for (PHINode &PN : ExitBB->phis()) {
+    SE->forgetValue(&PN);
+    Value *Exit =
+        expandSearchExitValue(PN.getIncomingValueForBlock(Header),
+                              ExitIteration, CurLoop, *SE, Expander, InsertPt);
+    for (unsigned I = 0, E = PN.getNumIncomingValues(); I != E; ++I)
+      PN.setIncomingValue(I, Exit);
+  }
+
+  exitSearchLoopInFirstIteration(CurLoop, TLI, MSSAU.get());
+
+  ORE.emit([&]() {
+    return OptimizationRemark(DEBUG_TYPE, "ProcessLoopStrlen",
+                              NewCall->getDebugLoc(), Preheader)
+           << "Transformed loop search in "
+           << ore::NV("Function", Header->getParent())
+           << " function into a call to "
+           << ore::NV("NewFunction", NewCall->getCalledFunction()) << "()";
+  });
+
+  ++NumStrLen;
+  return true;
+}
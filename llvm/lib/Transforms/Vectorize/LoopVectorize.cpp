@@ -346,6 +346,12 @@ cl::opt<bool> EnableVPlanNativePath(
     cl::desc("Enable VPlan-native vectorization path with "
              "support for outer loop vectorization."));
 
+static cl::opt<bool> VPlanNativePathCostModel(
+    "vplan-native-path-cost-model", cl::init(true), cl::Hidden,
+    cl::desc("In the VPlan-native path, only vectorize outer loops without a "
+             "user-specified vectorization factor if a cost estimate finds it "
+             "profitable."));
+
 // FIXME: Remove this switch once we have divergence analysis. Currently we
 // assume divergent non-backedge branches when this switch is true.
 cl::opt<bool> EnableVPlanPredication(
@@ -7751,6 +7757,57 @@ static unsigned determineVPlanVF(const unsigned WidestVectorRegBits,
   return WidestVectorRegBits / WidestType;
 }
 
+/// Estimates the cost of one iteration of the outer loop \p L when it runs
+/// \p VF iterations at once in the VPlan-native path, which widens every
+/// instruction of the loop nest and accesses memory with gathers and scatters.
+/// \returns The cost of running \p VF scalar iterations and the cost of the
+/// single vector iteration. Instructions the estimate does not model are
+/// assumed to be scalarized.
+static std::pair<InstructionCost, InstructionCost>
+estimateOuterLoopCost(Loop *L, ElementCount VF,
+                      const TargetTransformInfo &TTI) {
+  const TTI::TargetCostKind CostKind = TTI::TCK_RecipThroughput;
+  InstructionCost ScalarCost = 0;
+  InstructionCost VectorCost = 0;
+  for (BasicBlock *BB : L->blocks()) {
+    for (Instruction &I : *BB) {
+      if (isa<PHINode>(I) || isa<DbgInfoIntrinsic>(I))
+        continue;
+      InstructionCost Cost = TTI.getInstructionCost(&I, CostKind);
+      // Control flow in the loop nest stays uniform.
+      if (I.isTerminator()) {
+        ScalarCost += Cost * VF.getKnownMinValue();
+        VectorCost += Cost;
+        continue;
+      }
+      ScalarCost += Cost * VF.getKnownMinValue();
+
+      bool IsMemoryAccess = isa<LoadInst>(I) || isa<StoreInst>(I);
+      Type *VecTy =
+          ToVectorTy(IsMemoryAccess ? getLoadStoreType(&I) : I.getType(), VF);
+      if (IsMemoryAccess) {
+        VectorCost += TTI.getGatherScatterOpCost(
+            I.getOpcode(), VecTy, getLoadStorePointerOperand(&I),
+            /*VariableMask=*/false, getLoadStoreAlignment(&I), CostKind, &I);
+      } else if (isa<BinaryOperator>(I) || isa<UnaryOperator>(I)) {
+        VectorCost += TTI.getArithmeticInstrCost(I.getOpcode(), VecTy,
+                                                 CostKind);
+      } else if (auto *CI = dyn_cast<CastInst>(&I)) {
+        VectorCost += TTI.getCastInstrCost(
+            CI->getOpcode(), VecTy, ToVectorTy(CI->getSrcTy(), VF),
+            TTI::CastContextHint::None, CostKind, CI);
+      } else if (auto *Cmp = dyn_cast<CmpInst>(&I)) {
+        VectorCost += TTI.getCmpSelInstrCost(
+            Cmp->getOpcode(), ToVectorTy(Cmp->getOperand(0)->getType(), VF),
+            VecTy, Cmp->getPredicate(), CostKind, Cmp);
+      } else {
+        VectorCost += Cost * VF.getKnownMinValue();
+      }
+    }
+  }
+  return {ScalarCost, VectorCost};
+}
+
 VectorizationFactor
 LoopVectorizationPlanner::planInVPlanNativePath(ElementCount UserVF) {
   assert(!UserVF.isScalable() && "scalable vectors not yet supported");
@@ -7787,7 +7844,22 @@ LoopVectorizationPlanner::planInVPlanNativePath(ElementCount UserVF) {
     if (VPlanBuildStressTest)
       return VectorizationFactor::Disabled();
 
-    return {VF, 0 /*Cost*/};
+    if (!UserVF.isZero() || !VPlanNativePathCostModel)
+      return {VF, 0 /*Cost*/};
+
+    InstructionCost ScalarCost, VectorCost;
+    std::tie(ScalarCost, VectorCost) =
+        estimateOuterLoopCost(OrigLoop, VF, *TTI);
+    LLVM_DEBUG(dbgs() << "LV: Outer loop costs " << ScalarCost
+                      << " for VF scalar iterations and " << VectorCost
+                      << " for one vector iteration.\n");
+    if (!VectorCost.isValid() || !ScalarCost.isValid() ||
+        VectorCost >= ScalarCost) {
+      LLVM_DEBUG(dbgs() << "LV: Not vectorizing outer loop: not profitable "
+                           "for VF " << VF << ".\n");
+      return VectorizationFactor::Disabled();
+    }
+    return {VF, VectorCost};
   }
 
   LLVM_DEBUG(
@@ -108,6 +108,10 @@ using namespace slpvectorizer;
 #define DEBUG_TYPE "SLP"
 
 STATISTIC(NumVectorInstructions, "Number of vector instructions generated");
+STATISTIC(NumCachedGatherRoots,
+          "Number of trees not rebuilt because their roots are only gathered");
+STATISTIC(NumTreesOverBudget,
+          "Number of trees not built because the tree budget was exhausted");
 
 cl::opt<bool> RunSLPVectorization("vectorize-slp", cl::init(true), cl::Hidden,
                                   cl::desc("Run the SLP vectorization passes"));
@@ -146,6 +150,14 @@ static cl::opt<int>
 ScheduleRegionSizeBudget("slp-schedule-budget", cl::init(100000), cl::Hidden,
     cl::desc("Limit the size of the SLP scheduling region per block"));
 
+/// Limits the number of bundles examined while building trees in a function.
+/// Many overlapping seeds in large straight-line code can otherwise make tree
+/// building take a very long time.
+static cl::opt<unsigned> TreeBuildBudget(
+    "slp-tree-build-budget", cl::init(100000), cl::Hidden,
+    cl::desc("Limit the number of bundles examined while building SLP trees "
+             "in a function (0 = unlimited)"));
+
 static cl::opt<int> MinVectorRegSizeOption(
     "slp-min-reg-size", cl::init(128), cl::Hidden,
     cl::desc("Attempt to vectorize for this register size in bits"));
@@ -2222,6 +2234,19 @@ private:
   /// Holds all of the tree entries.
   TreeEntry::VecTreeTy VectorizableTree;
 
+  /// Roots, built without a user ignore list, whose tree was a single gather
+  /// node. Building the same roots gives the same tree until the IR changes,
+  /// so these are not rebuilt until the next call to vectorizeTree().
+  std::set<SmallVector<Value *, 8>> GatheredRoots;
+
+  /// The number of bundles buildTree_rec() examined in this function, checked
+  /// against the tree build budget.
+  unsigned NumBundlesBuilt = 0;
+
+  bool isTreeBuildBudgetExhausted() const {
+    return TreeBuildBudget && NumBundlesBuilt >= TreeBuildBudget;
+  }
+
 #ifndef NDEBUG
   /// Debug printer.
   LLVM_DUMP_METHOD void dumpVectorizableTree() const {
@@ -3501,7 +3526,25 @@ void BoUpSLP::buildTree(ArrayRef<Value *> Roots,
   UserIgnoreList = UserIgnoreLst;
   if (!allSameType(Roots))
     return;
+  if (isTreeBuildBudgetExhausted()) {
+    LLVM_DEBUG(dbgs() << "SLP: Not building a tree, budget exhausted.\n");
+    ++NumTreesOverBudget;
+    return;
+  }
+
+  bool CacheGatheredRoots = UserIgnoreLst.empty();
+  SmallVector<Value *, 8> Key(Roots.begin(), Roots.end());
+  if (CacheGatheredRoots && GatheredRoots.count(Key)) {
+    LLVM_DEBUG(dbgs() << "SLP: Not rebuilding a tree of gathered roots.\n");
+    ++NumCachedGatherRoots;
+    return;
+  }
+
   buildTree_rec(Roots, 0, EdgeInfo());
+
+  if (CacheGatheredRoots && VectorizableTree.size() == 1 &&
+      VectorizableTree.front()->State == TreeEntry::NeedToGather)
+    GatheredRoots.insert(std::move(Key));
 }
 
 namespace {
@@ -3622,6 +3665,15 @@ void BoUpSLP::buildTree_rec(ArrayRef<Value *> VL, unsigned Depth,
     return;
   }
 
+  if (isTreeBuildBudgetExhausted()) {
+    LLVM_DEBUG(dbgs() << "SLP: Gathering due to tree build budget.\n");
+    if (TryToFindDuplicates(S))
+      newTreeEntry(VL, None /*not vectorized*/, S, UserTreeIdx,
+                   ReuseShuffleIndicies);
+    return;
+  }
+  ++NumBundlesBuilt;
+
   // Don't handle scalable vectors
   if (S.getOpcode() == Instruction::ExtractElement &&
       isa<ScalableVectorType>(
@@ -6903,6 +6955,10 @@ Value *BoUpSLP::vectorizeTree() {
 
 Value *
 BoUpSLP::vectorizeTree(ExtraValueToDebugLocsMap &ExternallyUsedValues) {
+  // Vectorizing changes the IR, so trees that were only gathered may now be
+  // built differently.
+  GatheredRoots.clear();
+
   // All blocks must be scheduled before any instructions are inserted.
   for (auto &BSIter : BlocksSchedules) {
     scheduleBlock(BSIter.second.get());
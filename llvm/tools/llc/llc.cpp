@@ -14,6 +14,7 @@
 
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/CodeGen/CommandFlags.h"
@@ -22,6 +23,7 @@
 #include "llvm/CodeGen/MIRParser/MIRParser.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/AutoUpgrade.h"
@@ -84,6 +86,12 @@ TimeCompilations("time-compilations", cl::Hidden, cl::init(1u),
                  cl::value_desc("N"),
                  cl::desc("Repeat compilation N times for timing"));
 
+static cl::opt<unsigned> CodeGenPartitions(
+    "codegen-partitions", cl::init(1u), cl::value_desc("N"),
+    cl::desc("Split the module into N partitions and generate code for them "
+             "in parallel. Partition 0 is written to the output file and "
+             "partition I to <output>.I"));
+
 static cl::opt<bool> TimeTrace("time-trace", cl::desc("Record time trace"));
 
 static cl::opt<unsigned> TimeTraceGranularity(
@@ -641,6 +649,64 @@ static int compileModule(char **argv, LLVMContext &Context) {
     WithColor::warning(errs(), argv[0])
         << ": warning: ignoring -mc-relax-all because filetype != obj";
 
+  if (CodeGenPartitions > 1) {
+    if (MIR || !RunPassNames->empty() || CompileTwice || DwoOut) {
+      WithColor::error(errs(), argv[0])
+          << "-codegen-partitions cannot be used with MIR input, -run-pass, "
+             "-compile-twice or -split-dwarf-output\n";
+      return 1;
+    }
+    if (Out->outputFilename() == "-") {
+      WithColor::error(errs(), argv[0])
+          << "-codegen-partitions needs an output file\n";
+      return 1;
+    }
+
+    // Each partition is compiled in its own context by its own target
+    // machine, so nothing in the codegen pipeline is shared between threads.
+    std::vector<std::unique_ptr<ToolOutputFile>> PartOuts;
+    std::vector<std::unique_ptr<buffer_ostream>> PartBOSs;
+    SmallVector<raw_pwrite_stream *, 8> PartOSs;
+    for (unsigned I = 0; I != CodeGenPartitions; ++I) {
+      ToolOutputFile *PartOut = Out.get();
+      if (I) {
+        std::error_code EC;
+        PartOuts.push_back(std::make_unique<ToolOutputFile>(
+            Out->outputFilename() + "." + utostr(I), EC,
+            codegen::getFileType() == CGFT_AssemblyFile
+                ? sys::fs::OF_TextWithCRLF
+                : sys::fs::OF_None));
+        if (EC)
+          reportError(EC.message(), PartOuts.back()->outputFilename());
+        PartOut = PartOuts.back().get();
+      }
+      PartBOSs.push_back(std::make_unique<buffer_ostream>(PartOut->os()));
+      PartOSs.push_back(PartBOSs.back().get());
+    }
+
+    cl::PrintOptionValues();
+    splitCodeGen(
+        *M, PartOSs, {},
+        [&]() {
+          return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
+              TheTriple.getTriple(), CPUStr, FeaturesStr, Options, RM,
+              codegen::getExplicitCodeModel(), OLvl));
+        },
+        codegen::getFileType());
+
+    auto HasError =
+        ((const LLCDiagnosticHandler *)(Context.getDiagHandlerPtr()))->HasError;
+    if (*HasError)
+      return 1;
+
+    // Flush the buffers before the files are closed.
+    PartBOSs.clear();
+    Out->keep();
+    for (std::unique_ptr<ToolOutputFile> &PartOut : PartOuts)
+      PartOut->keep();
+    return 0;
+  }
+
   {
     raw_pwrite_stream *OS = &Out->os();
 
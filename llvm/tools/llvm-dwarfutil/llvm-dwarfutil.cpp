@@ -0,0 +1,259 @@
+//===- llvm-dwarfutil.cpp - Optimize debug info of linked ELF files -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This program runs the DWARFLinker over the debug info of an already linked
+// ELF executable or shared library. Type descriptions duplicated across
+// compile units are merged (ODR deduplication) and debug info describing code
+// that the linker discarded is removed. The result is written as an ELF
+// object that only holds the new debug sections, suitable for use as a
+// separate debug file.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/DWARFLinker/DWARFLinker.h"
+#include "llvm/DWARFLinker/DWARFStreamer.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFExpression.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace llvm::object;
+
+namespace {
+cl::OptionCategory DwarfUtilCategory("llvm-dwarfutil options");
+
+cl::opt<std::string> InputFilename(cl::Positional, cl::desc("<input file>"),
+                                   cl::Required, cl::cat(DwarfUtilCategory));
+
+cl::opt<std::string> OutputFilename("o", cl::desc("Output file name"),
+                                    cl::value_desc("filename"), cl::Required,
+                                    cl::cat(DwarfUtilCategory));
+
+cl::opt<bool> NoODR("no-odr",
+                    cl::desc("Do not use ODR (One Definition Rule) for type "
+                             "uniquing"),
+                    cl::init(false), cl::cat(DwarfUtilCategory));
+
+cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Number of threads to use for linking debug info, "
+                        "0 for the number of hardware threads"),
+               cl::init(0), cl::cat(DwarfUtilCategory));
+
+cl::opt<bool> Verbose("verbose", cl::desc("Verbosity level"), cl::init(false),
+                      cl::cat(DwarfUtilCategory));
+
+StringRef ToolName;
+
+void warning(const Twine &Message, StringRef Context) {
+  WithColor::warning(errs(), ToolName) << Context << ": " << Message << '\n';
+}
+
+void error(const Twine &Message, StringRef Context) {
+  WithColor::error(errs(), ToolName) << Context << ": " << Message << '\n';
+}
+
+/// Address map for a linked ELF file. All relocations have already been
+/// applied by the static linker, so an address is live if it points into an
+/// allocated section. lld resolves references to discarded code to a
+/// tombstone value (0, or -1 for DWARF v5), which falls outside of any
+/// section and is therefore treated as dead.
+class ObjFileAddressMap : public AddressesMap {
+public:
+  ObjFileAddressMap(const ELFObjectFileBase &Obj) {
+    for (const ELFSectionRef &Sect : Obj.sections()) {
+      if (!Sect.getSize() || !(Sect.getFlags() & ELF::SHF_ALLOC))
+        continue;
+      uint64_t Start = Sect.getAddress();
+      AddressRange Range{Start, Start + Sect.getSize()};
+      if (Sect.isText())
+        TextRanges.push_back(Range);
+      AllocatedRanges.push_back(Range);
+    }
+    llvm::sort(TextRanges);
+    llvm::sort(AllocatedRanges);
+  }
+
+  bool areRelocationsResolved() const override { return true; }
+
+  bool hasValidRelocs() override { return true; }
+
+  bool hasLiveMemoryLocation(const DWARFDie &DIE,
+                             CompileUnit::DIEInfo &Info) override {
+    Optional<DWARFFormValue> Location = DIE.find(dwarf::DW_AT_location);
+    if (!Location || !Location->isFormClass(DWARFFormValue::FC_Block))
+      return false;
+
+    const DWARFUnit *U = DIE.getDwarfUnit();
+    ArrayRef<uint8_t> Expr = *Location->getAsBlock();
+    DataExtractor Data(toStringRef(Expr), U->getContext().isLittleEndian(),
+                       U->getAddressByteSize());
+    for (const DWARFExpression::Operation &Op :
+         DWARFExpression(Data, U->getAddressByteSize(),
+                         U->getFormParams().Format)) {
+      if (Op.isError())
+        return false;
+      if (Op.getCode() == dwarf::DW_OP_addr &&
+          contains(AllocatedRanges, Op.getRawOperand(0))) {
+        Info.AddrAdjust = 0;
+        Info.InDebugMap = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool hasLiveAddressRange(const DWARFDie &DIE,
+                           CompileUnit::DIEInfo &Info) override {
+    Optional<uint64_t> LowPC = dwarf::toAddress(DIE.find(dwarf::DW_AT_low_pc));
+    if (!LowPC || !contains(TextRanges, *LowPC))
+      return false;
+    Info.AddrAdjust = 0;
+    Info.InDebugMap = true;
+    return true;
+  }
+
+  bool applyValidRelocs(MutableArrayRef<char>, uint64_t, bool) override {
+    // Nothing to relocate: the input is a linked file.
+    return false;
+  }
+
+  llvm::Expected<uint64_t> relocateIndexedAddr(uint64_t, uint64_t) override {
+    return createStringError(inconvertibleErrorCode(),
+                             "indexed addresses are not supported");
+  }
+
+  RangesTy &getValidAddressRanges() override { return AddressRanges; }
+
+  void clear() override { AddressRanges.clear(); }
+
+private:
+  struct AddressRange {
+    uint64_t Start;
+    uint64_t End;
+    bool operator<(const AddressRange &RHS) const { return Start < RHS.Start; }
+  };
+
+  static bool contains(ArrayRef<AddressRange> Ranges, uint64_t Addr) {
+    auto It = llvm::upper_bound(Ranges, Addr,
+                                [](uint64_t Addr, const AddressRange &Range) {
+                                  return Addr < Range.Start;
+                                });
+    if (It == Ranges.begin())
+      return false;
+    return Addr < std::prev(It)->End;
+  }
+
+  SmallVector<AddressRange, 8> TextRanges;
+  SmallVector<AddressRange, 16> AllocatedRanges;
+  RangesTy AddressRanges;
+};
+
+bool optimizeDebugInfo(ELFObjectFileBase &Obj, raw_pwrite_stream &OutStream) {
+  std::unique_ptr<DWARFContext> Context = DWARFContext::create(
+      Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
+      [&](Error Err) {
+        error(toString(std::move(Err)), Obj.getFileName());
+      },
+      [&](Error Err) {
+        warning(toString(std::move(Err)), Obj.getFileName());
+      });
+
+  // The DWARFLinker only knows how to produce DWARF versions up to 4.
+  for (const std::unique_ptr<DWARFUnit> &CU : Context->compile_units()) {
+    if (CU->getVersion() >= 5) {
+      error("DWARF v5 input is not supported", Obj.getFileName());
+      return false;
+    }
+  }
+
+  bool HasErrors = false;
+  messageHandler WarningHandler = [&](const Twine &Message, StringRef Context,
+                                      const DWARFDie *) {
+    warning(Message, Context);
+  };
+  messageHandler ErrorHandler = [&](const Twine &Message, StringRef Context,
+                                    const DWARFDie *) {
+    HasErrors = true;
+    error(Message, Context);
+  };
+
+  DwarfStreamer Streamer(OutputFileType::Object, OutStream, nullptr,
+                         ErrorHandler, WarningHandler);
+  if (!Streamer.init(Obj.makeTriple(), ""))
+    return false;
+
+  DWARFLinker Linker(&Streamer, DwarfLinkerClient::General);
+  Linker.setVerbosity(Verbose);
+  Linker.setNoODR(NoODR);
+  Linker.setNumThreads(
+      NumThreads ? NumThreads : hardware_concurrency().compute_thread_count());
+  Linker.setAccelTableKind(AccelTableKind::Dwarf);
+  Linker.setWarningHandler(WarningHandler);
+  Linker.setErrorHandler(ErrorHandler);
+
+  ObjFileAddressMap AddressMap(Obj);
+  std::vector<std::string> EmptyWarnings;
+  DWARFFile File(Obj.getFileName(), Context.get(), &AddressMap, EmptyWarnings);
+  Linker.addObjectFile(File);
+
+  if (!Linker.link())
+    return false;
+  Streamer.finish();
+  return !HasErrors;
+}
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+  ToolName = argv[0];
+
+  cl::HideUnrelatedOptions({&DwarfUtilCategory, &getColorCategory()});
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "Deduplicate and garbage collect the debug info of a linked ELF file\n");
+
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllTargets();
+  InitializeAllAsmPrinters();
+
+  Expected<OwningBinary<Binary>> BinOrErr = createBinary(InputFilename);
+  if (!BinOrErr) {
+    error(toString(BinOrErr.takeError()), InputFilename);
+    return EXIT_FAILURE;
+  }
+  auto *Obj = dyn_cast<ELFObjectFileBase>(BinOrErr->getBinary());
+  if (!Obj) {
+    error("unsupported input file, expected an ELF object", InputFilename);
+    return EXIT_FAILURE;
+  }
+
+  std::error_code EC;
+  ToolOutputFile Out(OutputFilename, EC, sys::fs::OF_None);
+  if (EC) {
+    error(EC.message(), OutputFilename);
+    return EXIT_FAILURE;
+  }
+
+  if (!optimizeDebugInfo(*Obj, Out.os()))
+    return EXIT_FAILURE;
+
+  Out.keep();
+  return EXIT_SUCCESS;
+}
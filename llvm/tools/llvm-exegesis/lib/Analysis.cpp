@@ -8,10 +8,13 @@
 
 #include "Analysis.h"
 #include "BenchmarkResult.h"
+#include "Error.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/MC/MCTargetOptions.h"
 #include "llvm/Support/FormatVariadic.h"
+#include <cmath>
 #include <limits>
 #include <unordered_set>
 #include <vector>
@@ -250,6 +253,36 @@ Analysis::makePointsPerSchedClass() const {
   return Entries;
 }
 
+std::vector<Analysis::SchedClassCluster> Analysis::makeSchedClassClusters(
+    const ResolvedSchedClassAndPoints &RSCAndPoints) const {
+  std::vector<SchedClassCluster> SchedClassClusters;
+  for (const size_t PointId : RSCAndPoints.PointIds) {
+    const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
+    if (!ClusterId.isValid())
+      continue; // Ignore noise and errors. FIXME: take noise into account ?
+    if (ClusterId.isUnstable() ^ AnalysisDisplayUnstableOpcodes_)
+      continue; // Either display stable or unstable clusters only.
+    auto SchedClassClusterIt = llvm::find_if(
+        SchedClassClusters, [ClusterId](const SchedClassCluster &C) {
+          return C.id() == ClusterId;
+        });
+    if (SchedClassClusterIt == SchedClassClusters.end()) {
+      SchedClassClusters.emplace_back();
+      SchedClassClusterIt = std::prev(SchedClassClusters.end());
+    }
+    SchedClassClusterIt->addPoint(PointId, Clustering_);
+  }
+  return SchedClassClusters;
+}
+
+bool Analysis::allClustersMatch(const std::vector<SchedClassCluster> &Clusters,
+                                const ResolvedSchedClass &RSC) const {
+  return all_of(Clusters, [this, &RSC](const SchedClassCluster &C) {
+    return C.measurementsMatch(*SubtargetInfo_, RSC, Clustering_,
+                               AnalysisInconsistencyEpsilonSquared_);
+  });
+}
+
 // Parallel benchmarks repeat the same opcode multiple times. Just show this
 // opcode and show the whole snippet only on hover.
 static void writeParallelSnippetHtml(raw_ostream &OS,
@@ -553,33 +586,12 @@ Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
     if (!RSCAndPoints.RSC.SCDesc)
       continue;
-    // Bucket sched class points into sched class clusters.
-    std::vector<SchedClassCluster> SchedClassClusters;
-    for (const size_t PointId : RSCAndPoints.PointIds) {
-      const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
-      if (!ClusterId.isValid())
-        continue; // Ignore noise and errors. FIXME: take noise into account ?
-      if (ClusterId.isUnstable() ^ AnalysisDisplayUnstableOpcodes_)
-        continue; // Either display stable or unstable clusters only.
-      auto SchedClassClusterIt = llvm::find_if(
-          SchedClassClusters, [ClusterId](const SchedClassCluster &C) {
-            return C.id() == ClusterId;
-          });
-      if (SchedClassClusterIt == SchedClassClusters.end()) {
-        SchedClassClusters.emplace_back();
-        SchedClassClusterIt = std::prev(SchedClassClusters.end());
-      }
-      SchedClassClusterIt->addPoint(PointId, Clustering_);
-    }
+    const std::vector<SchedClassCluster> SchedClassClusters =
+        makeSchedClassClusters(RSCAndPoints);
 
     // Print any scheduling class that has at least one cluster that does not
     // match the checked-in data.
-    if (all_of(SchedClassClusters, [this,
-                                    &RSCAndPoints](const SchedClassCluster &C) {
-          return C.measurementsMatch(*SubtargetInfo_, RSCAndPoints.RSC,
-                                     Clustering_,
-                                     AnalysisInconsistencyEpsilonSquared_);
-        }))
+    if (allClustersMatch(SchedClassClusters, RSCAndPoints.RSC))
       continue; // Nothing weird.
 
     OS << "<div class=\"inconsistency\"><p>Sched Class <span "
@@ -604,5 +616,131 @@ Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   return Error::success();
 }
 
+// Writes the name of the sched class, which is only known in debug builds.
+static void writeSchedClassName(raw_ostream &OS,
+                                const ResolvedSchedClass &RSC) {
+#if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
+  OS << RSC.SCDesc->Name;
+#else
+  OS << "sched class " << RSC.SchedClassId;
+#endif
+}
+
+// Prints a SchedWriteRes holding the data of the sched class, with the
+// measured latency or number of micro-ops of the cluster, and the InstRW that
+// assigns it to the opcodes of the cluster.
+void Analysis::printSchedClassOverrideTd(const SchedClassCluster &Cluster,
+                                         const ResolvedSchedClass &RSC,
+                                         unsigned WriteId,
+                                         raw_ostream &OS) const {
+  const auto &Points = Clustering_.getPoints();
+  const InstructionBenchmark::ModeE Mode = Points[0].Mode;
+  const auto &SM = SubtargetInfo_->getSchedModel();
+
+  unsigned Latency = 0;
+  for (unsigned I = 0; I < RSC.SCDesc->NumWriteLatencyEntries; ++I)
+    Latency = std::max<unsigned>(
+        Latency, SubtargetInfo_->getWriteLatencyEntry(RSC.SCDesc, I)->Cycles);
+  unsigned NumMicroOps = RSC.SCDesc->NumMicroOps;
+
+  OS << "// ";
+  writeSchedClassName(OS, RSC);
+  OS << " (Latency = " << Latency << ", NumMicroOps = " << NumMicroOps
+     << "), measured:";
+  for (const auto &Stats : Cluster.getCentroid().getStats()) {
+    OS << " " << Stats.key() << " = " << formatv("{0:F}", Stats.avg());
+    if (Mode == InstructionBenchmark::Latency)
+      Latency = std::lround(Stats.avg());
+    else if (Mode == InstructionBenchmark::Uops && Stats.key() == "NumMicroOps")
+      NumMicroOps = std::lround(Stats.avg());
+  }
+  OS << "\n";
+  if (RSC.SCDesc->NumWriteLatencyEntries > 1)
+    OS << "// FIXME: only the first of the "
+       << RSC.SCDesc->NumWriteLatencyEntries << " defs is described.\n";
+
+  OS << "def ExegesisWrite" << WriteId << " : SchedWriteRes<[";
+  ListSeparator LS;
+  for (const auto &WPR : RSC.NonRedundantWriteProcRes)
+    OS << LS << SM.getProcResource(WPR.ProcResourceIdx)->Name;
+  OS << "]> {\n";
+  OS << "  let Latency = " << Latency << ";\n";
+  OS << "  let NumMicroOps = " << NumMicroOps << ";\n";
+  if (!RSC.NonRedundantWriteProcRes.empty()) {
+    OS << "  let ResourceCycles = [";
+    ListSeparator CyclesLS;
+    for (const auto &WPR : RSC.NonRedundantWriteProcRes)
+      OS << CyclesLS << WPR.Cycles;
+    OS << "];\n";
+  }
+  OS << "}\n";
+
+  // A cluster holds a point per configuration of each opcode.
+  std::set<StringRef> OpcodeNames;
+  for (const size_t PointId : Cluster.getPointIds())
+    OpcodeNames.insert(
+        InstrInfo_->getName(Points[PointId].keyInstruction().getOpcode()));
+  OS << "def : InstRW<[ExegesisWrite" << WriteId << "], (instrs ";
+  ListSeparator OpcodesLS;
+  for (const StringRef Name : OpcodeNames)
+    OS << OpcodesLS << Name;
+  OS << ")>;\n";
+}
+
+template <>
+Error Analysis::run<Analysis::PrintSchedClassOverrides>(raw_ostream &OS) const {
+  if (Clustering_.getPoints().empty())
+    return Error::success();
+  if (AnalysisDisplayUnstableOpcodes_)
+    return make_error<Failure>(
+        "sched class overrides are only computed for stable clusters");
+
+  const auto &FirstPoint = Clustering_.getPoints()[0];
+  if (FirstPoint.Mode == InstructionBenchmark::InverseThroughput)
+    return make_error<Failure>(
+        "sched class overrides need latency or uops measurements");
+
+  OS << "// Scheduling data measured by llvm-exegesis on "
+     << SubtargetInfo_->getCPU() << " (" << FirstPoint.LLVMTriple << ").\n";
+  OS << "// The opcodes below belong to sched classes which do not match their "
+        "measurements.\n";
+  OS << "// Each definition starts from the data of the scheduling model, with "
+        "the measured\n";
+  OS << "// values. Review them, then include this file in the "
+        "`let SchedModel = ... in`\n";
+  OS << "// block of the model.\n";
+
+  unsigned WriteId = 0;
+  for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
+    const ResolvedSchedClass &RSC = RSCAndPoints.RSC;
+    if (!RSC.SCDesc)
+      continue;
+    const std::vector<SchedClassCluster> SchedClassClusters =
+        makeSchedClassClusters(RSCAndPoints);
+    if (allClustersMatch(SchedClassClusters, RSC))
+      continue;
+
+    OS << "\n";
+    if (!RSC.SCDesc->isValid() || RSC.WasVariant) {
+      // An InstRW would replace all the variants, or data we can't start from.
+      OS << "// ";
+      writeSchedClassName(OS, RSC);
+      OS << (RSC.WasVariant ? " is a variant" : " is not a valid")
+         << " sched class, it is not overridden.\n";
+      continue;
+    }
+    for (const SchedClassCluster &Cluster : SchedClassClusters) {
+      // Clusters whose measurements can't be compared to the model are left
+      // for the inconsistencies report.
+      if (!Cluster.getCentroid().validate(FirstPoint.Mode) ||
+          Cluster.measurementsMatch(*SubtargetInfo_, RSC, Clustering_,
+                                    AnalysisInconsistencyEpsilonSquared_))
+        continue;
+      printSchedClassOverrideTd(Cluster, RSC, WriteId++, OS);
+    }
+  }
+  return Error::success();
+}
+
 } // namespace exegesis
 } // namespace llvm
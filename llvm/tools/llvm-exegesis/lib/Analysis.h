@@ -47,6 +47,9 @@ public:
   struct PrintClusters {};
   // Find potential errors in the scheduling information given measurements.
   struct PrintSchedClassInconsistencies {};
+  // Propose scheduling data for the sched classes whose measurements do not
+  // match, as TableGen definitions to include in the scheduling model.
+  struct PrintSchedClassOverrides {};
 
   template <typename Pass> Error run(raw_ostream &OS) const;
 
@@ -108,6 +111,20 @@ private:
   // Builds a list of ResolvedSchedClassAndPoints.
   std::vector<ResolvedSchedClassAndPoints> makePointsPerSchedClass() const;
 
+  // Buckets the points of a sched class into sched class clusters, ignoring
+  // noise and errors.
+  std::vector<SchedClassCluster>
+  makeSchedClassClusters(const ResolvedSchedClassAndPoints &RSCAndPoints) const;
+
+  // Returns true if the measurements of all the clusters match the sched
+  // class data.
+  bool allClustersMatch(const std::vector<SchedClassCluster> &Clusters,
+                        const ResolvedSchedClass &RSC) const;
+
+  void printSchedClassOverrideTd(const SchedClassCluster &Cluster,
+                                 const ResolvedSchedClass &RSC,
+                                 unsigned WriteId, raw_ostream &OS) const;
+
   template <typename EscapeTag, EscapeTag Tag>
   void writeSnippet(raw_ostream &OS, ArrayRef<uint8_t> Bytes,
                     const char *Separator) const;
@@ -31,12 +31,14 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/SystemUtils.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Transforms/IPO/FunctionImport.h"
 #include "llvm/Transforms/IPO/Internalize.h"
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 
+#include <atomic>
 #include <memory>
 #include <utility>
 using namespace llvm;
@@ -88,6 +90,13 @@ static cl::opt<bool> OnlyNeeded("only-needed",
                                 cl::desc("Link only needed symbols"),
                                 cl::cat(LinkCategory));
 
+static cl::opt<unsigned>
+    Jobs("j",
+         cl::desc("Link groups of the input files on this many threads, then "
+                  "link the groups together (not with -internalize or "
+                  "-only-needed)"),
+         cl::init(1), cl::value_desc("N"), cl::cat(LinkCategory));
+
 static cl::opt<bool> Force("f", cl::desc("Enable binary output on terminals"),
                            cl::cat(LinkCategory));
 
@@ -362,7 +371,7 @@ static bool importFunctions(const char *argv0, Module &DestModule) {
 }
 
 static bool linkFiles(const char *argv0, LLVMContext &Context, Linker &L,
-                      const cl::list<std::string> &Files, unsigned Flags) {
+                      ArrayRef<std::string> Files, unsigned Flags) {
   // Filter out flags that don't apply to the first file we load.
   unsigned ApplicableFlags = Flags & Linker::Flags::OverrideFromSrc;
   // Similar to some flags, internalization doesn't apply to the first file.
@@ -440,6 +449,63 @@ static bool linkFiles(const char *argv0, LLVMContext &Context, Linker &L,
   return true;
 }
 
+/// Links contiguous groups of \p Files in contexts of their own on separate
+/// threads, and then links the results into \p L in command line order. The
+/// first definition of a symbol wins either way, so the result is the same
+/// program as linking the files one at a time.
+static bool linkFilesInGroups(const char *argv0, LLVMContext &Context,
+                              Linker &L, ArrayRef<std::string> Files,
+                              unsigned Flags) {
+  size_t GroupSize = divideCeil(Files.size(), Jobs);
+  size_t NumGroups = divideCeil(Files.size(), GroupSize);
+  std::vector<SmallVector<char, 0>> Bitcode(NumGroups);
+  std::atomic<bool> Failed{false};
+  {
+    ThreadPool Pool(hardware_concurrency(NumGroups));
+    for (size_t I = 0; I != NumGroups; ++I) {
+      ArrayRef<std::string> Group =
+          Files.drop_front(I * GroupSize).take_front(GroupSize);
+      Pool.async([&, I, Group] {
+        LLVMContext GroupContext;
+        GroupContext.setDiagnosticHandler(
+            std::make_unique<LLVMLinkDiagnosticHandler>(), true);
+        if (!DisableDITypeMap)
+          GroupContext.enableDebugTypeODRUniquing();
+        Module GroupModule("llvm-link", GroupContext);
+        Linker GroupLinker(GroupModule);
+        if (!linkFiles(argv0, GroupContext, GroupLinker, Group, Flags)) {
+          Failed = true;
+          return;
+        }
+        raw_svector_ostream OS(Bitcode[I]);
+        WriteBitcodeToFile(GroupModule, OS, PreserveBitcodeUseListOrder);
+      });
+    }
+  }
+  if (Failed)
+    return false;
+
+  for (size_t I = 0; I != NumGroups; ++I) {
+    std::unique_ptr<Module> M = loadFile(
+        argv0,
+        MemoryBuffer::getMemBuffer(
+            StringRef(Bitcode[I].data(), Bitcode[I].size()),
+            ("llvm-link group " + Twine(I)).str(),
+            /*RequiresNullTerminator=*/false),
+        Context);
+    if (!M.get()) {
+      errs() << argv0 << ": ";
+      WithColor::error() << " loading group " << I << "\n";
+      return false;
+    }
+    if (Verbose)
+      errs() << "Linking in group " << I << "\n";
+    if (L.linkInModule(std::move(M), Flags))
+      return false;
+  }
+  return true;
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
   ExitOnErr.setBanner(std::string(argv[0]) + ": ");
@@ -461,8 +527,12 @@ int main(int argc, char **argv) {
     Flags |= Linker::Flags::LinkOnlyNeeded;
 
   // First add all the regular input files
-  if (!linkFiles(argv[0], Context, L, InputFilenames, Flags))
+  if (Jobs > 1 && InputFilenames.size() > 1 && !Internalize && !OnlyNeeded) {
+    if (!linkFilesInGroups(argv[0], Context, L, InputFilenames, Flags))
+      return 1;
+  } else if (!linkFiles(argv[0], Context, L, InputFilenames, Flags)) {
     return 1;
+  }
 
   // Next the -override ones.
   if (!linkFiles(argv[0], Context, L, OverridingInputs,
@@ -64,6 +64,11 @@ static cl::opt<std::string> AAPipeline("aa-pipeline",
                                        cl::desc("Alias Analysis Pipeline"),
                                        cl::value_desc("aapipeline"));
 
+static cl::opt<std::string> PartitionOptPipeline(
+    "partition-opt-pipeline",
+    cl::desc("Optimizer pipeline to run on each codegen partition"),
+    cl::value_desc("pipeline"));
+
 static cl::opt<bool> SaveTemps("save-temps", cl::desc("Save temporary files"));
 
 static cl::opt<bool>
@@ -265,6 +270,7 @@ static int run(int argc, char **argv) {
   // Run a custom pipeline, if asked for.
   Conf.OptPipeline = OptPipeline;
   Conf.AAPipeline = AAPipeline;
+  Conf.PartitionOptPipeline = PartitionOptPipeline;
 
   Conf.OptLevel = OptLevel - '0';
   Conf.UseNewPM = UseNewPM;
@@ -20,6 +20,7 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <cstddef>
@@ -570,7 +571,7 @@ CompressedSection::CompressedSection(const SectionBase &Sec,
       DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align) {
   ErrorAsOutParameter EAO(&OutErr);
 
-  if (Error Err = zlib::compress(
+  if (Error Err = zlib::compressParallel(
           StringRef(reinterpret_cast<const char *>(OriginalData.data()),
                     OriginalData.size()),
           CompressedData)) {
@@ -2099,15 +2100,20 @@ template <class ELFT> void ELFWriter<ELFT>::writeShdrs() {
 }
 
 template <class ELFT> Error ELFWriter<ELFT>::writeSectionData() {
-  for (SectionBase &Sec : Obj.sections())
-    // Segments are responsible for writing their contents, so only write the
-    // section data if the section is not in a segment. Note that this renders
-    // sections in segments effectively immutable.
-    if (Sec.ParentSegment == nullptr)
-      if (Error Err = Sec.accept(*SecWriter))
-        return Err;
+  // Segments are responsible for writing their contents, so only write the
+  // section data if the section is not in a segment. Note that this renders
+  // sections in segments effectively immutable. Sections that are passed
+  // through are written by write() directly from the input.
+  std::vector<const SectionBase *> ToWrite;
+  for (const SectionBase &Sec : Obj.sections())
+    if (Sec.ParentSegment == nullptr && !PassthroughSet.count(&Sec))
+      ToWrite.push_back(&Sec);
 
-  return Error::success();
+  // Each section is written to its own part of Buf, so they can be written,
+  // and in particular decompressed, in parallel.
+  return parallelForEachError(ToWrite, [&](const SectionBase *Sec) {
+    return Sec->accept(*SecWriter);
+  });
 }
 
 template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
@@ -2521,12 +2527,47 @@ template <class ELFT> Error ELFWriter<ELFT>::write() {
   if (WriteSectionHeaders)
     writeShdrs();
 
-  // TODO: Implement direct writing to the output stream (without intermediate
-  // memory buffer Buf).
-  Out.write(Buf->getBufferStart(), Buf->getBufferSize());
+  // Write Buf, with the contents of the passthrough sections taken straight
+  // from the input.
+  uint64_t Pos = 0;
+  for (const SectionBase *Sec : PassthroughSections) {
+    Out.write(Buf->getBufferStart() + Pos, Sec->Offset - Pos);
+    ArrayRef<uint8_t> Contents = Sec->getUnmodifiedContents();
+    Out.write(reinterpret_cast<const char *>(Contents.data()), Contents.size());
+    Pos = Sec->Offset + Sec->Size;
+  }
+  Out.write(Buf->getBufferStart() + Pos, Buf->getBufferSize() - Pos);
   return Error::success();
 }
 
+template <class ELFT>
+void ELFWriter<ELFT>::findPassthroughSections(uint64_t TotalSize) {
+  PassthroughSections.clear();
+  PassthroughSet.clear();
+  // The headers are written after the section data, so sections that overlap
+  // them are left to the buffer. Sections outside of segments are laid out
+  // one after the other, so they do not overlap each other.
+  uint64_t Begin = sizeof(Elf_Ehdr);
+  if (size_t NumSegments = llvm::size(Obj.segments()))
+    Begin = std::max<uint64_t>(Begin, Obj.ProgramHdrSegment.Offset +
+                                          NumSegments * sizeof(Elf_Phdr));
+  uint64_t End = WriteSectionHeaders ? Obj.SHOff : TotalSize;
+  for (const SectionBase &Sec : Obj.sections()) {
+    if (Sec.ParentSegment != nullptr)
+      continue;
+    ArrayRef<uint8_t> Contents = Sec.getUnmodifiedContents();
+    if (Contents.empty() || Contents.size() != Sec.Size ||
+        Sec.Offset < Begin || Sec.Offset + Sec.Size > End)
+      continue;
+    PassthroughSections.push_back(&Sec);
+    PassthroughSet.insert(&Sec);
+  }
+  llvm::sort(PassthroughSections,
+             [](const SectionBase *Lhs, const SectionBase *Rhs) {
+               return Lhs->Offset < Rhs->Offset;
+             });
+}
+
 static Error removeUnneededSections(Object &Obj) {
   // We can remove an empty symbol table from non-relocatable objects.
   // Relocatable objects typically have relocation sections whose
@@ -2646,12 +2687,22 @@ template <class ELFT> Error ELFWriter<ELFT>::finalize() {
   }
 
   size_t TotalSize = totalSize();
-  Buf = WritableMemoryBuffer::getNewMemBuffer(TotalSize);
+  findPassthroughSections(TotalSize);
+  Buf = WritableMemoryBuffer::getNewUninitMemBuffer(TotalSize);
   if (!Buf)
     return createStringError(errc::not_enough_memory,
                              "failed to allocate memory buffer of " +
                                  Twine::utohexstr(TotalSize) + " bytes");
 
+  // Zero the buffer, except for the parts that belong to passthrough sections,
+  // which are never read, so that their pages are not touched.
+  uint64_t Pos = 0;
+  for (const SectionBase *Sec : PassthroughSections) {
+    std::memset(Buf->getBufferStart() + Pos, 0, Sec->Offset - Pos);
+    Pos = Sec->Offset + Sec->Size;
+  }
+  std::memset(Buf->getBufferStart() + Pos, 0, TotalSize - Pos);
+
   SecWriter = std::make_unique<ELFSectionWriter<ELFT>>(*Buf);
   return Error::success();
 }
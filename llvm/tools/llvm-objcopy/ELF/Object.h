@@ -11,6 +11,7 @@
 
 #include "CommonConfig.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/BinaryFormat/ELF.h"
@@ -337,9 +338,15 @@ private:
   void writeSegmentData();
 
   void assignOffsets();
+  void findPassthroughSections(uint64_t TotalSize);
 
   std::unique_ptr<ELFSectionWriter<ELFT>> SecWriter;
 
+  // Sections outside of segments that are written to the output straight from
+  // the input instead of being copied into Buf, sorted by offset.
+  std::vector<const SectionBase *> PassthroughSections;
+  DenseSet<const SectionBase *> PassthroughSet;
+
   size_t totalSize() const;
 
 public:
@@ -430,6 +437,9 @@ public:
   virtual void
   replaceSectionReferences(const DenseMap<SectionBase *, SectionBase *> &);
   virtual bool hasContents() const { return false; }
+  // Returns the contents of the section if they are written out exactly as
+  // they were read from the input, and an empty array otherwise.
+  virtual ArrayRef<uint8_t> getUnmodifiedContents() const { return {}; }
   // Notify the section that it is subject to removal.
   virtual void onRemove();
 };
@@ -497,6 +507,9 @@ public:
   bool hasContents() const override {
     return Type != ELF::SHT_NOBITS && Type != ELF::SHT_NULL;
   }
+  ArrayRef<uint8_t> getUnmodifiedContents() const override {
+    return hasContents() ? Contents : ArrayRef<uint8_t>();
+  }
 };
 
 class OwnedDataSection : public SectionBase {
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -234,6 +235,27 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
+/// Add the record \p I read from \p Input to the writer of \p WC, whose lock
+/// must be held, reporting merge errors once per record.
+static void addRecordFromInput(WriterContext *WC, NamedInstrProfRecord &&I,
+                               const WeightedFile &Input) {
+  const StringRef FuncName = I.Name;
+  bool Reported = false;
+  WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
+    if (Reported) {
+      consumeError(std::move(E));
+      return;
+    }
+    Reported = true;
+    // Only show hint the first time an error occurs.
+    instrprof_error IPE = InstrProfError::take(std::move(E));
+    std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
+    bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
+    handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
+                           FuncName, firstTime);
+  });
+}
+
 /// Load an input into a writer context.
 static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
                       const InstrProfCorrelator *Correlator,
@@ -268,27 +290,84 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   for (auto &I : *Reader) {
     if (Remapper)
       I.Name = (*Remapper)(I.Name);
-    const StringRef FuncName = I.Name;
-    bool Reported = false;
-    WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
-      if (Reported) {
-        consumeError(std::move(E));
-        return;
-      }
-      Reported = true;
-      // Only show hint the first time an error occurs.
-      instrprof_error IPE = InstrProfError::take(std::move(E));
-      std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
-      bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
-      handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
-                             FuncName, firstTime);
-    });
+    addRecordFromInput(WC, std::move(I), Input);
   }
   if (Reader->hasError())
     if (Error E = Reader->getError())
       WC->Errors.emplace_back(std::move(E), Filename);
 }
 
+/// Load an input, sending every function record to the writer context of the
+/// shard that its name hashes to, so that each function is merged in exactly
+/// one context. \p Main records the profile kind and the errors; its writer
+/// does not receive any records.
+static void
+loadInputIntoShards(const WeightedFile &Input, SymbolRemapper *Remapper,
+                    const InstrProfCorrelator *Correlator, WriterContext *Main,
+                    ArrayRef<std::unique_ptr<WriterContext>> Shards) {
+  // Copy the filename, because llvm::ThreadPool copied the input "const
+  // WeightedFile &" by value, making a reference to the filename within it
+  // invalid outside of this packaged task.
+  std::string Filename = Input.Filename;
+
+  auto ReaderOrErr = InstrProfReader::create(Input.Filename, Correlator);
+  if (Error E = ReaderOrErr.takeError()) {
+    // Skip the empty profiles by returning sliently.
+    instrprof_error IPE = InstrProfError::take(std::move(E));
+    if (IPE != instrprof_error::empty_raw_profile) {
+      std::unique_lock<std::mutex> CtxGuard{Main->Lock};
+      Main->Errors.emplace_back(make_error<InstrProfError>(IPE), Filename);
+    }
+    return;
+  }
+
+  auto Reader = std::move(ReaderOrErr.get());
+  {
+    std::unique_lock<std::mutex> CtxGuard{Main->Lock};
+    if (Error E = Main->Writer.mergeProfileKind(Reader->getProfileKind())) {
+      consumeError(std::move(E));
+      Main->Errors.emplace_back(
+          make_error<StringError>(
+              "Merge IR generated profile with Clang generated profile.",
+              std::error_code()),
+          Filename);
+      return;
+    }
+  }
+
+  // Hand records to the shards in batches, so that a shard's lock is taken
+  // once per batch instead of once per record. The records refer to the
+  // reader's data, so all of them are flushed before the reader goes away.
+  const size_t BatchSize = 256;
+  std::vector<std::vector<NamedInstrProfRecord>> Pending(Shards.size());
+  auto Flush = [&](size_t Shard) {
+    WriterContext *WC = Shards[Shard].get();
+    std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+    for (NamedInstrProfRecord &I : Pending[Shard])
+      addRecordFromInput(WC, std::move(I), Input);
+    Pending[Shard].clear();
+  };
+
+  for (auto &I : *Reader) {
+    if (Remapper)
+      I.Name = (*Remapper)(I.Name);
+    size_t Shard = hash_value(I.Name) % Shards.size();
+    Pending[Shard].push_back(std::move(I));
+    if (Pending[Shard].size() >= BatchSize)
+      Flush(Shard);
+  }
+  for (size_t Shard = 0, E = Shards.size(); Shard != E; ++Shard)
+    if (!Pending[Shard].empty())
+      Flush(Shard);
+
+  if (Reader->hasError()) {
+    if (Error E = Reader->getError()) {
+      std::unique_lock<std::mutex> CtxGuard{Main->Lock};
+      Main->Errors.emplace_back(std::move(E), Filename);
+    }
+  }
+}
+
 /// Merge the \p Src writer context into \p Dst.
 static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   for (auto &ErrorPair : Src->Errors)
@@ -351,48 +430,38 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   if (NumThreads == 0)
     NumThreads = std::min(hardware_concurrency().compute_thread_count(),
                           unsigned((Inputs.size() + 1) / 2));
-  // FIXME: There's a bug here, where setting NumThreads = Inputs.size() fails
-  // the merge_empty_profile.test because the InstrProfWriter.ProfileKind isn't
-  // merged, thus the emitted file ends up with a PF_Unknown kind.
 
-  // Initialize the writer contexts.
+  // Contexts[0] receives the merged profile.
   SmallVector<std::unique_ptr<WriterContext>, 4> Contexts;
-  for (unsigned I = 0; I < NumThreads; ++I)
-    Contexts.emplace_back(std::make_unique<WriterContext>(
-        OutputSparse, ErrorLock, WriterErrorCodes));
+  Contexts.emplace_back(std::make_unique<WriterContext>(
+      OutputSparse, ErrorLock, WriterErrorCodes));
 
   if (NumThreads == 1) {
     for (const auto &Input : Inputs)
       loadInput(Input, Remapper, Correlator.get(), Contexts[0].get());
   } else {
-    ThreadPool Pool(hardware_concurrency(NumThreads));
+    // Partition the functions into shards by name and give each shard its own
+    // writer context. Every thread streams whole inputs and sends each record
+    // to its shard, so a function is only held and merged once no matter how
+    // many threads there are. Use more shards than threads to keep lock
+    // contention low.
+    SmallVector<std::unique_ptr<WriterContext>, 16> Shards;
+    for (unsigned I = 0; I < 4 * NumThreads; ++I)
+      Shards.emplace_back(std::make_unique<WriterContext>(
+          OutputSparse, ErrorLock, WriterErrorCodes));
 
-    // Load the inputs in parallel (N/NumThreads serial steps).
-    unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
-      Pool.async(loadInput, Input, Remapper, Correlator.get(),
-                 Contexts[Ctx].get());
-      Ctx = (Ctx + 1) % NumThreads;
-    }
+    ThreadPool Pool(hardware_concurrency(NumThreads));
+    for (const auto &Input : Inputs)
+      Pool.async(loadInputIntoShards, Input, Remapper, Correlator.get(),
+                 Contexts[0].get(), makeArrayRef(Shards));
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
-      }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    // The shards hold disjoint sets of functions, so collecting them into the
+    // final writer does not merge any counters.
+    for (std::unique_ptr<WriterContext> &Shard : Shards) {
+      mergeWriterContexts(Contexts[0].get(), Shard.get());
+      Shard.reset();
+    }
   }
 
   // Handle deferred errors encountered during merging. If the number of errors
@@ -2480,14 +2549,31 @@ static int showSampleProfile(const std::string &Filename, bool ShowCounts,
   return 0;
 }
 
-static int showMemProfProfile(const std::string &Filename, raw_fd_ostream &OS) {
-  auto ReaderOr = llvm::memprof::RawMemProfReader::create(Filename);
+static int showMemProfProfile(const std::string &Filename,
+                              const std::string &ProfiledBinary,
+                              raw_fd_ostream &OS) {
+  auto ReaderOr = ProfiledBinary.empty()
+                      ? llvm::memprof::RawMemProfReader::create(Filename)
+                      : llvm::memprof::RawMemProfReader::create(
+                            Filename, ProfiledBinary);
   if (Error E = ReaderOr.takeError())
     exitWithError(std::move(E), Filename);
 
   std::unique_ptr<llvm::memprof::RawMemProfReader> Reader(
       ReaderOr.get().release());
   Reader->printSummaries(OS);
+  if (ProfiledBinary.empty())
+    return 0;
+
+  // Print the symbolized allocation contexts.
+  auto RecordsOr = Reader->readRecords();
+  if (Error E = RecordsOr.takeError())
+    exitWithError(std::move(E), Filename);
+  int Count = 0;
+  for (const llvm::memprof::MemProfRecord &Record : *RecordsOr) {
+    OS << "Allocation Context " << ++Count << "\n";
+    Record.print(OS);
+  }
   return 0;
 }
 
@@ -2587,6 +2673,10 @@ static int show_main(int argc, const char *argv[]) {
   cl::opt<bool> ShowCovered(
       "covered", cl::init(false),
       cl::desc("Show only the functions that have been executed."));
+  cl::opt<std::string> ProfiledBinary(
+      "profiled-binary", cl::init(""),
+      cl::desc("The binary which produced the memory profile, to show the "
+               "symbolized allocation contexts."));
 
   cl::ParseCommandLineOptions(argc, argv, "LLVM profile data summary\n");
 
@@ -2624,7 +2714,7 @@ static int show_main(int argc, const char *argv[]) {
                              ShowAllFunctions, ShowDetailedSummary,
                              ShowFunction, ShowProfileSymbolList,
                              ShowSectionInfoOnly, ShowHotFuncList, OS);
-  return showMemProfProfile(Filename, OS);
+  return showMemProfProfile(Filename, ProfiledBinary, OS);
 }
 
 int main(int argc, const char *argv[]) {
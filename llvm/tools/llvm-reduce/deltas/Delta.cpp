@@ -264,26 +264,31 @@ void runDeltaPassInt(
     increaseGranularity(ChunksStillConsideredInteresting);
   }
 
+  // MIR can't be round-tripped through bitcode, so it is always reduced with
+  // a single thread.
+  bool RunInParallel = NumJobs > 1 && !Test.getProgram().isMIR();
+
   std::atomic<bool> AnyReduced;
   std::unique_ptr<ThreadPool> ChunkThreadPoolPtr;
-  if (NumJobs > 1)
+  if (RunInParallel)
     ChunkThreadPoolPtr =
         std::make_unique<ThreadPool>(hardware_concurrency(NumJobs));
 
+  // When running with more than one thread, serialize the original bitcode
+  // to OriginalBC. Every chunk is checked against the original program, which
+  // is only replaced once the pass is done, so this is done once.
+  SmallString<0> OriginalBC;
+  if (RunInParallel) {
+    raw_svector_ostream BCOS(OriginalBC);
+    WriteBitcodeToFile(*Test.getProgram().M, BCOS);
+  }
+
   bool FoundAtLeastOneNewUninterestingChunkWithCurrentGranularity;
   do {
     FoundAtLeastOneNewUninterestingChunkWithCurrentGranularity = false;
 
     std::set<Chunk> UninterestingChunks;
 
-    // When running with more than one thread, serialize the original bitcode
-    // to OriginalBC.
-    SmallString<0> OriginalBC;
-    if (NumJobs > 1) {
-      raw_svector_ostream BCOS(OriginalBC);
-      WriteBitcodeToFile(*Test.getProgram().M, BCOS);
-    }
-
     std::deque<std::shared_future<SmallString<0>>> TaskQueue;
     for (auto I = ChunksStillConsideredInteresting.rbegin(),
               E = ChunksStillConsideredInteresting.rend();
@@ -293,7 +298,7 @@ void runDeltaPassInt(
 
       // Run in parallel mode, if the user requested more than one thread and
       // there are at least a few chunks to process.
-      if (NumJobs > 1 && WorkLeft > 1) {
+      if (RunInParallel && WorkLeft > 1) {
         unsigned NumInitialTasks = std::min(WorkLeft, unsigned(NumJobs));
         unsigned NumChunksProcessed = 0;
 
@@ -320,7 +325,9 @@ void runDeltaPassInt(
 
         // Start processing results of the queued tasks. We wait for the first
         // task in the queue to finish. If it reduced a chunk, we parse the
-        // result and exit the loop.
+        // result and exit the loop. The tasks are queued in chunk order, so the
+        // first chunk which reduces the input is picked, as when running with a
+        // single thread.
         //  Otherwise we will try to schedule a new task, if
         //  * no other pending job reduced a chunk and
         //  * we have not reached the end of the chunk.
@@ -358,6 +365,10 @@ void runDeltaPassInt(
           Result->M = std::move(MOrErr.get());
           break;
         }
+        // The tasks queued after the one which reduced the input read
+        // UninterestingChunks, wait for them before it is updated. Their
+        // results are dropped.
+        ChunkThreadPool.wait();
         // Forward I to the last chunk processed in parallel.
         I += NumChunksProcessed - 1;
       } else {
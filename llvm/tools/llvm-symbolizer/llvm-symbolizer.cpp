@@ -105,7 +105,8 @@ enum class Command {
 
 static bool parseCommand(StringRef BinaryName, bool IsAddr2Line,
                          StringRef InputString, Command &Cmd,
-                         std::string &ModuleName, uint64_t &ModuleOffset) {
+                         std::string &ModuleName,
+                         SmallVectorImpl<uint64_t> &ModuleOffsets) {
   const char kDelimiters[] = " \n\r";
   ModuleName = "";
   if (InputString.consume_front("CODE ")) {
@@ -138,30 +139,30 @@ static bool parseCommand(StringRef BinaryName, bool IsAddr2Line,
   } else {
     ModuleName = BinaryName.str();
   }
-  // Skip delimiters and parse module offset.
-  Pos += strspn(Pos, kDelimiters);
-  int OffsetLength = strcspn(Pos, kDelimiters);
-  StringRef Offset(Pos, OffsetLength);
-  // GNU addr2line assumes the offset is hexadecimal and allows a redundant
-  // "0x" or "0X" prefix; do the same for compatibility.
-  if (IsAddr2Line)
-    Offset.consume_front("0x") || Offset.consume_front("0X");
-  return !Offset.getAsInteger(IsAddr2Line ? 16 : 0, ModuleOffset);
-}
-
-static void symbolizeInput(const opt::InputArgList &Args, uint64_t AdjustVMA,
-                           bool IsAddr2Line, OutputStyle Style,
-                           StringRef InputString, LLVMSymbolizer &Symbolizer,
-                           DIPrinter &Printer) {
-  Command Cmd;
-  std::string ModuleName;
-  uint64_t Offset = 0;
-  if (!parseCommand(Args.getLastArgValue(OPT_obj_EQ), IsAddr2Line,
-                    StringRef(InputString), Cmd, ModuleName, Offset)) {
-    Printer.printInvalidCommand({ModuleName, None}, InputString);
-    return;
+  // Skip delimiters and parse module offsets. Several offsets into the same
+  // module can be batched on one line; parsing stops at the first token that
+  // is not an offset.
+  while (true) {
+    Pos += strspn(Pos, kDelimiters);
+    int OffsetLength = strcspn(Pos, kDelimiters);
+    StringRef Offset(Pos, OffsetLength);
+    // GNU addr2line assumes the offset is hexadecimal and allows a redundant
+    // "0x" or "0X" prefix; do the same for compatibility.
+    if (IsAddr2Line)
+      Offset.consume_front("0x") || Offset.consume_front("0X");
+    uint64_t ModuleOffset;
+    if (Offset.getAsInteger(IsAddr2Line ? 16 : 0, ModuleOffset))
+      break;
+    ModuleOffsets.push_back(ModuleOffset);
+    Pos += OffsetLength;
   }
+  return !ModuleOffsets.empty();
+}
 
+static void symbolizeOffset(const opt::InputArgList &Args, uint64_t AdjustVMA,
+                            bool IsAddr2Line, OutputStyle Style, Command Cmd,
+                            const std::string &ModuleName, uint64_t Offset,
+                            LLVMSymbolizer &Symbolizer, DIPrinter &Printer) {
   uint64_t AdjustedOffset = Offset - AdjustVMA;
   if (Cmd == Command::Data) {
     Expected<DIGlobal> ResOrErr = Symbolizer.symbolizeData(
@@ -197,6 +198,24 @@ static void symbolizeInput(const opt::InputArgList &Args, uint64_t AdjustVMA,
   }
 }
 
+static void symbolizeInput(const opt::InputArgList &Args, uint64_t AdjustVMA,
+                           bool IsAddr2Line, OutputStyle Style,
+                           StringRef InputString, LLVMSymbolizer &Symbolizer,
+                           DIPrinter &Printer) {
+  Command Cmd;
+  std::string ModuleName;
+  SmallVector<uint64_t, 1> Offsets;
+  if (!parseCommand(Args.getLastArgValue(OPT_obj_EQ), IsAddr2Line,
+                    StringRef(InputString), Cmd, ModuleName, Offsets)) {
+    Printer.printInvalidCommand({ModuleName, None}, InputString);
+    return;
+  }
+
+  for (uint64_t Offset : Offsets)
+    symbolizeOffset(Args, AdjustVMA, IsAddr2Line, Style, Cmd, ModuleName,
+                    Offset, Symbolizer, Printer);
+}
+
 static void printHelp(StringRef ToolName, const SymbolizerOptTable &Tbl,
                       raw_ostream &OS) {
   const char HelpText[] = " [options] addresses...";
@@ -283,6 +302,7 @@ int main(int argc, char **argv) {
   } else {
     Opts.PathStyle = DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath;
   }
+  parseIntArg(Args, OPT_cache_size_EQ, Opts.MaxCacheSize);
   Opts.DebugFileDirectory = Args.getAllArgValues(OPT_debug_file_directory_EQ);
   Opts.DefaultArch = Args.getLastArgValue(OPT_default_arch_EQ).str();
   Opts.Demangle = Args.hasFlag(OPT_demangle, OPT_no_demangle, !IsAddr2Line);
@@ -0,0 +1,84 @@
+//===- ConcurrentDenseMapTest.cpp - ConcurrentDenseMap unit tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ConcurrentDenseMap.h"
+#include "llvm/Config/llvm-config.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentDenseMapTest, InsertAndLookup) {
+  ConcurrentDenseMap<unsigned, std::string> Map;
+  EXPECT_TRUE(Map.empty());
+  EXPECT_EQ(nullptr, Map.lookup(1));
+
+  auto Inserted = Map.try_emplace(1, "one");
+  EXPECT_TRUE(Inserted.second);
+  EXPECT_EQ("one", *Inserted.first);
+
+  // An existing value is not replaced.
+  auto Existing = Map.try_emplace(1, "uno");
+  EXPECT_FALSE(Existing.second);
+  EXPECT_EQ(Inserted.first, Existing.first);
+  EXPECT_EQ("one", *Map.lookup(1));
+  EXPECT_TRUE(Map.contains(1));
+  EXPECT_FALSE(Map.contains(2));
+  EXPECT_EQ(1u, Map.size());
+}
+
+TEST(ConcurrentDenseMapTest, SortedEntries) {
+  ConcurrentDenseMap<unsigned, unsigned, DenseMapInfo<unsigned>, 4> Map;
+  for (unsigned I : {5u, 3u, 9u, 1u})
+    Map.try_emplace(I, I * 10);
+  auto Entries = Map.getEntries();
+  ASSERT_EQ(4u, Entries.size());
+  EXPECT_EQ(1u, Entries[0].first);
+  EXPECT_EQ(3u, Entries[1].first);
+  EXPECT_EQ(5u, Entries[2].first);
+  EXPECT_EQ(9u, Entries[3].first);
+  EXPECT_EQ(90u, *Entries[3].second);
+
+  using Entry = std::pair<unsigned, unsigned *>;
+  auto Descending = Map.getEntries(
+      [](const Entry &A, const Entry &B) { return A.first > B.first; });
+  EXPECT_EQ(9u, Descending[0].first);
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(ConcurrentDenseMapTest, ParallelInsert) {
+  ConcurrentDenseMap<unsigned, unsigned> Map;
+  const unsigned NumThreads = 4;
+  const unsigned NumKeys = 10000;
+  std::atomic<unsigned> NumInserted{0};
+  std::vector<std::thread> Threads;
+  // All threads insert the same keys; each key is inserted exactly once.
+  for (unsigned T = 0; T < NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      for (unsigned I = 0; I < NumKeys; ++I)
+        if (Map.try_emplace(I, T).second)
+          ++NumInserted;
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  EXPECT_EQ(NumKeys, NumInserted);
+  EXPECT_EQ(NumKeys, Map.size());
+  auto Entries = Map.getEntries();
+  for (unsigned I = 0; I < NumKeys; ++I) {
+    EXPECT_EQ(I, Entries[I].first);
+    EXPECT_LT(*Entries[I].second, NumThreads);
+  }
+}
+#endif
+
+} // end anonymous namespace
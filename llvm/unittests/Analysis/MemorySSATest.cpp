@@ -200,6 +200,55 @@ TEST_F(MemorySSATest, CreateLoadsAndStoreUpdater) {
   MSSA.verifyMemorySSA();
 }
 
+TEST_F(MemorySSATest, InsertStoresDeferringRename) {
+  // We create a diamond with a store in the entry and a load in the merge
+  // point, then insert stores on both sides and rename the uses below them
+  // once.
+  F = Function::Create(
+      FunctionType::get(B.getVoidTy(), {B.getInt8PtrTy()}, false),
+      GlobalValue::ExternalLinkage, "F", &M);
+  BasicBlock *Entry(BasicBlock::Create(C, "", F));
+  BasicBlock *Left(BasicBlock::Create(C, "", F));
+  BasicBlock *Right(BasicBlock::Create(C, "", F));
+  BasicBlock *Merge(BasicBlock::Create(C, "", F));
+  Argument *PointerArg = &*F->arg_begin();
+  B.SetInsertPoint(Entry);
+  StoreInst *EntryStore = B.CreateStore(B.getInt8(16), PointerArg);
+  B.CreateCondBr(B.getTrue(), Left, Right);
+  B.SetInsertPoint(Left);
+  B.CreateBr(Merge);
+  B.SetInsertPoint(Right);
+  B.CreateBr(Merge);
+  B.SetInsertPoint(Merge);
+  LoadInst *Load = B.CreateLoad(B.getInt8Ty(), PointerArg);
+
+  setupAnalyses();
+  MemorySSA &MSSA = *Analyses->MSSA;
+  MemorySSAUpdater Updater(&MSSA);
+  MemoryUse *LoadAccess = cast<MemoryUse>(MSSA.getMemoryAccess(Load));
+  EXPECT_EQ(LoadAccess->getDefiningAccess(), MSSA.getMemoryAccess(EntryStore));
+
+  SmallVector<MemoryAccess *, 2> NewAccesses;
+  for (BasicBlock *BB : {Left, Right}) {
+    B.SetInsertPoint(BB, BB->begin());
+    StoreInst *SI = B.CreateStore(B.getInt8(16), PointerArg);
+    MemoryAccess *NewAccess = Updater.createMemoryAccessInBB(
+        SI, nullptr, BB, MemorySSA::Beginning);
+    Updater.insertDefDeferringRename(cast<MemoryDef>(NewAccess));
+    NewAccesses.push_back(NewAccess);
+  }
+  // The uses are only renamed on request.
+  EXPECT_EQ(LoadAccess->getDefiningAccess(), MSSA.getMemoryAccess(EntryStore));
+  Updater.renameDeferredUses();
+
+  MemoryPhi *MergePhi = dyn_cast<MemoryPhi>(LoadAccess->getDefiningAccess());
+  ASSERT_NE(MergePhi, nullptr);
+  EXPECT_EQ(MergePhi, MSSA.getMemoryAccess(Merge));
+  EXPECT_EQ(MergePhi->getIncomingValueForBlock(Left), NewAccesses[0]);
+  EXPECT_EQ(MergePhi->getIncomingValueForBlock(Right), NewAccesses[1]);
+  MSSA.verifyMemorySSA();
+}
+
 TEST_F(MemorySSATest, CreateALoadUpdater) {
   // We create a diamond, then build memoryssa with no memory accesses, and
   // incrementally update it by inserting a store in one of the branches, and a
@@ -2541,3 +2541,30 @@ TEST(GSYMTest, TestGsymCreatorMultipleSymbolsWithNoSize) {
                    1, // NumAddresses
                    ArrayRef<uint8_t>(UUID));
 }
+
+TEST(GSYMTest, TestGsymCreatorAddFunctionInfos) {
+  // Function infos added in batches, out of order, must end up sorted and
+  // combined with those added one at a time.
+  uint8_t UUID[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  GsymCreator GC;
+  GC.setUUID(UUID);
+  constexpr uint64_t BaseAddr = 0x1000;
+  constexpr uint8_t AddrOffSize = 1;
+  const uint32_t Func1Name = GC.insertString("foo");
+  const uint32_t Func2Name = GC.insertString("bar");
+  const uint32_t Func3Name = GC.insertString("baz");
+  std::vector<FunctionInfo> Batch;
+  Batch.emplace_back(BaseAddr + 0x40, 0x10, Func3Name);
+  Batch.emplace_back(BaseAddr + 0x00, 0x10, Func1Name);
+  GC.addFunctionInfos(std::move(Batch));
+  GC.addFunctionInfo(FunctionInfo(BaseAddr + 0x20, 0x10, Func2Name));
+  EXPECT_EQ(GC.getNumFunctionInfos(), 3u);
+  EXPECT_TRUE(GC.hasFunctionInfoForAddress(BaseAddr + 0x48));
+  EXPECT_FALSE(GC.hasFunctionInfoForAddress(BaseAddr + 0x30));
+  Error Err = GC.finalize(llvm::nulls());
+  ASSERT_FALSE(Err);
+  TestEncodeDecode(GC, llvm::support::little, GSYM_VERSION, AddrOffSize,
+                   BaseAddr,
+                   3, // NumAddresses
+                   ArrayRef<uint8_t>(UUID));
+}
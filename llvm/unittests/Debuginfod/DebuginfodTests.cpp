@@ -67,3 +67,24 @@ TEST(DebuginfodClient, CacheMiss) {
   // A cache miss with no possible URLs should not create the cache directory.
   EXPECT_FALSE(sys::fs::exists(CacheDir));
 }
+
+// Check that a batched lookup returns one result per build ID, in order.
+TEST(DebuginfodClient, BatchedCacheMiss) {
+  SmallString<32> CacheDir;
+  ASSERT_NO_ERROR(
+      sys::fs::createUniqueDirectory("debuginfod-unittest", CacheDir));
+  setenv("DEBUGINFOD_CACHE_PATH", CacheDir.c_str(),
+         /*replace=*/1);
+  // Ensure there are no urls to guarantee a cache miss.
+  setenv("DEBUGINFOD_URLS", "", /*replace=*/1);
+  HTTPClient::initialize();
+  const uint8_t ID1[] = {0x01, 0x23};
+  const uint8_t ID2[] = {0x45, 0x67};
+  const uint8_t ID3[] = {0x89, 0xab};
+  BuildIDRef IDs[] = {ID1, ID2, ID3};
+  std::vector<Expected<std::string>> Results =
+      getCachedOrDownloadDebuginfos(IDs, hardware_concurrency(2));
+  ASSERT_EQ(Results.size(), 3u);
+  for (Expected<std::string> &PathOrErr : Results)
+    EXPECT_THAT_EXPECTED(PathOrErr, Failed<StringError>());
+}
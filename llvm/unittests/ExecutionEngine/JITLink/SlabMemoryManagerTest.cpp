@@ -0,0 +1,117 @@
+//===---- SlabMemoryManagerTest.cpp - Unit tests for SlabMemoryManager ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::orc;
+
+namespace {
+
+SimpleSegmentAlloc::SegmentMap makeSegments(uint64_t CodeSize,
+                                            uint64_t DataSize) {
+  SimpleSegmentAlloc::SegmentMap Segs;
+  Segs[MemProt::Read | MemProt::Exec] = {CodeSize, Align(16)};
+  Segs[MemProt::Read | MemProt::Write] = {DataSize, Align(8)};
+  return Segs;
+}
+
+TEST(SlabMemoryManagerTest, PacksCodeAndReusesMemory) {
+  uint64_t PageSize = sys::Process::getPageSizeEstimate();
+  auto MemMgr = SlabMemoryManager::Create(
+      16 * SlabMemoryManager::DefaultSlabSize);
+  ASSERT_THAT_EXPECTED(MemMgr, Succeeded());
+
+  auto A1 = SimpleSegmentAlloc::Create(**MemMgr, nullptr, makeSegments(8, 8));
+  ASSERT_THAT_EXPECTED(A1, Succeeded());
+  auto A2 = SimpleSegmentAlloc::Create(**MemMgr, nullptr, makeSegments(8, 8));
+  ASSERT_THAT_EXPECTED(A2, Succeeded());
+
+  // Code from different allocations is packed together, away from data.
+  ExecutorAddr Code1 = A1->getSegInfo(MemProt::Read | MemProt::Exec).Addr;
+  ExecutorAddr Code2 = A2->getSegInfo(MemProt::Read | MemProt::Exec).Addr;
+  ExecutorAddr Data1 = A1->getSegInfo(MemProt::Read | MemProt::Write).Addr;
+  EXPECT_EQ(Code2, Code1 + PageSize);
+  EXPECT_EQ(Code1.getValue() % SlabMemoryManager::DefaultSlabSize, 0u);
+  EXPECT_EQ(Data1.getValue() % SlabMemoryManager::DefaultSlabSize, 0u);
+  EXPECT_EQ((*MemMgr)->getAllocatedSize(), 4 * PageSize);
+  EXPECT_EQ((*MemMgr)->getSlabBytes(), 2 * SlabMemoryManager::DefaultSlabSize);
+
+  auto FA1 = A1->finalize();
+  ASSERT_THAT_EXPECTED(FA1, Succeeded());
+  auto FA2 = A2->finalize();
+  ASSERT_THAT_EXPECTED(FA2, Succeeded());
+
+  // Memory released by one allocation is reused by the next one, which gets
+  // writable, zeroed memory.
+  EXPECT_THAT_ERROR((*MemMgr)->deallocate(std::move(*FA1)), Succeeded());
+  auto A3 = SimpleSegmentAlloc::Create(**MemMgr, nullptr, makeSegments(8, 8));
+  ASSERT_THAT_EXPECTED(A3, Succeeded());
+  auto CodeSeg3 = A3->getSegInfo(MemProt::Read | MemProt::Exec);
+  EXPECT_EQ(CodeSeg3.Addr, Code1);
+  EXPECT_EQ(CodeSeg3.WorkingMem[0], 0);
+  CodeSeg3.WorkingMem[0] = 1;
+
+  auto FA3 = A3->finalize();
+  ASSERT_THAT_EXPECTED(FA3, Succeeded());
+  EXPECT_THAT_ERROR((*MemMgr)->deallocate(std::move(*FA2)), Succeeded());
+  EXPECT_THAT_ERROR((*MemMgr)->deallocate(std::move(*FA3)), Succeeded());
+
+  // Empty slabs go back to the reservation.
+  EXPECT_EQ((*MemMgr)->getAllocatedSize(), 0u);
+  EXPECT_EQ((*MemMgr)->getSlabBytes(), 0u);
+}
+
+TEST(SlabMemoryManagerTest, SeparatesHotCode) {
+  auto MemMgr = SlabMemoryManager::Create(
+      16 * SlabMemoryManager::DefaultSlabSize, /*UseHugePages=*/true,
+      [](const LinkGraph &G) { return G.getName() == "hot"; });
+  ASSERT_THAT_EXPECTED(MemMgr, Succeeded());
+
+  static const char Content[] = {0x0f, 0x0b};
+  auto MakeGraph = [&](StringRef Name) {
+    auto G = std::make_unique<LinkGraph>(
+        Name.str(), Triple("x86_64-unknown-linux"), 8, support::little,
+        getGenericEdgeKindName);
+    auto &Sec = G->createSection(".text", MemProt::Read | MemProt::Exec);
+    G->createContentBlock(Sec, Content, ExecutorAddr(), 16, 0);
+    return G;
+  };
+  auto Cold1 = MakeGraph("cold1");
+  auto Hot = MakeGraph("hot");
+  auto Cold2 = MakeGraph("cold2");
+
+  auto AllocCold1 = (*MemMgr)->allocate(nullptr, *Cold1);
+  ASSERT_THAT_EXPECTED(AllocCold1, Succeeded());
+  auto AllocHot = (*MemMgr)->allocate(nullptr, *Hot);
+  ASSERT_THAT_EXPECTED(AllocHot, Succeeded());
+  auto AllocCold2 = (*MemMgr)->allocate(nullptr, *Cold2);
+  ASSERT_THAT_EXPECTED(AllocCold2, Succeeded());
+
+  auto GetAddr = [](LinkGraph &G) {
+    return (*G.blocks().begin())->getAddress();
+  };
+  uint64_t PageSize = sys::Process::getPageSizeEstimate();
+  EXPECT_EQ(GetAddr(*Cold2), GetAddr(*Cold1) + PageSize);
+  EXPECT_NE(GetAddr(*Hot).getValue() / SlabMemoryManager::DefaultSlabSize,
+            GetAddr(*Cold1).getValue() / SlabMemoryManager::DefaultSlabSize);
+
+  for (auto *Alloc : {&*AllocCold1, &*AllocHot, &*AllocCold2}) {
+    auto FA = (*Alloc)->finalize();
+    ASSERT_THAT_EXPECTED(FA, Succeeded());
+    EXPECT_THAT_ERROR((*MemMgr)->deallocate(std::move(*FA)), Succeeded());
+  }
+  EXPECT_EQ((*MemMgr)->getSlabBytes(), 0u);
+}
+
+} // namespace
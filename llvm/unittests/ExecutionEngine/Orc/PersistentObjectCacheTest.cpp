@@ -0,0 +1,81 @@
+//===- PersistentObjectCacheTest.cpp - Test the on-disk object cache ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+// The start of a little-endian 64-bit ELF relocatable file, which is enough
+// for the cache to recognize it as an object.
+std::string makeFakeObject() {
+  std::string Obj(64, '\0');
+  Obj[0] = 0x7f;
+  Obj[1] = 'E';
+  Obj[2] = 'L';
+  Obj[3] = 'F';
+  Obj[4] = 2; // ELFCLASS64
+  Obj[5] = 1; // ELFDATA2LSB
+  Obj[6] = 1; // EV_CURRENT
+  Obj[16] = 1; // ET_REL
+  return Obj;
+}
+
+TEST(PersistentObjectCacheTest, ReusesObjectsAcrossInstances) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      sys::fs::createUniqueDirectory("orc-object-cache-test", CacheDir));
+
+  LLVMContext Ctx;
+  Module M("M", Ctx);
+  Function::Create(FunctionType::get(Type::getVoidTy(Ctx), false),
+                   GlobalValue::ExternalLinkage, "foo", M);
+  std::string Obj = makeFakeObject();
+
+  {
+    PersistentObjectCache Cache(std::string(CacheDir), "target");
+    EXPECT_EQ(Cache.getObject(&M), nullptr);
+    Cache.notifyObjectCompiled(&M, MemoryBufferRef(Obj, "M"));
+  }
+
+  // A new cache for the same directory and target finds the object.
+  {
+    PersistentObjectCache Cache(std::string(CacheDir), "target");
+    std::unique_ptr<MemoryBuffer> Cached = Cache.getObject(&M);
+    ASSERT_NE(Cached, nullptr);
+    EXPECT_EQ(Cached->getBuffer(), Obj);
+  }
+
+  // A different target configuration does not.
+  {
+    PersistentObjectCache Cache(std::string(CacheDir), "other-target");
+    EXPECT_EQ(Cache.getObject(&M), nullptr);
+  }
+
+  // Neither does a changed module.
+  {
+    Function::Create(FunctionType::get(Type::getVoidTy(Ctx), false),
+                     GlobalValue::ExternalLinkage, "bar", M);
+    PersistentObjectCache Cache(std::string(CacheDir), "target");
+    EXPECT_EQ(Cache.getObject(&M), nullptr);
+  }
+
+  ASSERT_FALSE(sys::fs::remove_directories(CacheDir));
+}
+
+} // namespace
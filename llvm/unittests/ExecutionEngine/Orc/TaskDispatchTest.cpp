@@ -32,4 +32,54 @@ TEST(DynamicThreadPoolDispatchTest, GenericNamedTask) {
   EXPECT_TRUE(F.get());
   D->shutdown();
 }
+
+namespace {
+class PrioritizedTask : public RTTIExtends<PrioritizedTask, Task> {
+public:
+  static char ID;
+
+  PrioritizedTask(unsigned Priority, std::function<void()> Fn)
+      : Priority(Priority), Fn(std::move(Fn)) {}
+  void printDescription(raw_ostream &OS) override { OS << "Prioritized"; }
+  void run() override { Fn(); }
+  unsigned getPriority() const override { return Priority; }
+
+private:
+  unsigned Priority;
+  std::function<void()> Fn;
+};
+
+char PrioritizedTask::ID = 0;
+} // namespace
+
+TEST(PriorityThreadPoolDispatchTest, RunsHigherPriorityFirst) {
+  auto D = std::make_unique<PriorityThreadPoolTaskDispatcher>(1);
+
+  // Keep the only thread busy until all other tasks are queued.
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  D->dispatch(makeGenericNamedTask([Released]() { Released.wait(); }));
+
+  std::mutex OrderMutex;
+  std::vector<unsigned> Order;
+  auto Record = [&](unsigned Id) {
+    return [&, Id]() {
+      std::lock_guard<std::mutex> Lock(OrderMutex);
+      Order.push_back(Id);
+    };
+  };
+  D->dispatch(std::make_unique<PrioritizedTask>(0, Record(1)));
+  D->dispatch(std::make_unique<PrioritizedTask>(2, Record(2)));
+  D->dispatch(std::make_unique<PrioritizedTask>(1, Record(3)));
+  D->dispatch(std::make_unique<PrioritizedTask>(2, Record(4)));
+  Release.set_value();
+  D->shutdown();
+
+  EXPECT_EQ(Order, std::vector<unsigned>({2, 4, 3, 1}));
+
+  // After shutdown tasks run on the calling thread.
+  bool B = false;
+  D->dispatch(makeGenericNamedTask([&]() { B = true; }));
+  EXPECT_TRUE(B);
+}
 #endif
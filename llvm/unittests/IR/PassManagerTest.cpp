@@ -22,6 +22,8 @@
 
 using namespace llvm;
 
+extern cl::opt<bool> PreserveUnchangedCFGAnalyses;
+
 namespace {
 
 class TestFunctionAnalysis : public AnalysisInfoMixin<TestFunctionAnalysis> {
@@ -950,4 +952,71 @@ TEST_F(PassManagerTest, FunctionPassCFGCheckerWrapped) {
   FPM.addPass(TestSimplifyCFGWrapperPass(InnerFPM));
   FPM.run(*F, FAM);
 }
+
+// A function analysis that, like the dominator tree, only depends on the CFG.
+class TestCFGAnalysis : public AnalysisInfoMixin<TestCFGAnalysis> {
+public:
+  struct Result {
+    bool invalidate(Function &, const PreservedAnalyses &PA,
+                    FunctionAnalysisManager::Invalidator &) {
+      auto PAC = PA.getChecker<TestCFGAnalysis>();
+      return !(PAC.preserved() || PAC.preservedSet<AllAnalysesOn<Function>>() ||
+               PAC.preservedSet<CFGAnalyses>());
+    }
+  };
+
+  TestCFGAnalysis(int &Runs) : Runs(Runs) {}
+
+  Result run(Function &F, FunctionAnalysisManager &AM) {
+    ++Runs;
+    return Result();
+  }
+
+private:
+  friend AnalysisInfoMixin<TestCFGAnalysis>;
+  static AnalysisKey Key;
+
+  int &Runs;
+};
+
+AnalysisKey TestCFGAnalysis::Key;
+
+TEST_F(PassManagerTest, PreserveUnchangedCFGAnalyses) {
+  Function *F = M->getFunction("f");
+  FunctionAnalysisManager FAM;
+  PassInstrumentationCallbacks PIC;
+  FAM.registerPass([&] { return PassInstrumentationAnalysis(&PIC); });
+  int CFGAnalysisRuns = 0, FunctionAnalysisRuns = 0;
+  FAM.registerPass([&] { return TestCFGAnalysis(CFGAnalysisRuns); });
+  FAM.registerPass([&] { return TestFunctionAnalysis(FunctionAnalysisRuns); });
+
+  FunctionPassManager FPM;
+  auto UseAnalyses = [](Function &F, FunctionAnalysisManager &AM) {
+    AM.getResult<TestCFGAnalysis>(F);
+    AM.getResult<TestFunctionAnalysis>(F);
+    return PreservedAnalyses::none();
+  };
+  FPM.addPass(LambdaPass(UseAnalyses));
+  FPM.addPass(LambdaPass(UseAnalyses));
+  // Splitting a block changes the CFG.
+  FPM.addPass(LambdaPass([](Function &F, FunctionAnalysisManager &AM) {
+    BasicBlock &Entry = F.getEntryBlock();
+    Entry.splitBasicBlock(Entry.getTerminator());
+    return PreservedAnalyses::none();
+  }));
+  FPM.addPass(LambdaPass(UseAnalyses));
+
+  FPM.run(*F, FAM);
+  EXPECT_EQ(3, CFGAnalysisRuns);
+  EXPECT_EQ(3, FunctionAnalysisRuns);
+
+  FAM.clear();
+  CFGAnalysisRuns = FunctionAnalysisRuns = 0;
+  PreserveUnchangedCFGAnalyses = true;
+  FPM.run(*F, FAM);
+  PreserveUnchangedCFGAnalyses = false;
+  // Only the pass that split a block invalidates the CFG analysis.
+  EXPECT_EQ(2, CFGAnalysisRuns);
+  EXPECT_EQ(3, FunctionAnalysisRuns);
+}
 }
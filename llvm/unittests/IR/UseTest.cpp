@@ -8,6 +8,7 @@
 
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/User.h"
@@ -107,4 +108,48 @@ TEST(UseTest, reverse) {
   ASSERT_EQ(8u, I);
 }
 
+TEST(UseTest, getUser) {
+  LLVMContext C;
+
+  const char *ModuleString = "define i32 @f(i32 %x) {\n"
+                             "entry:\n"
+                             "  br label %loop\n"
+                             "loop:\n"
+                             "  %p = phi i32 [ %x, %entry ]\n"
+                             "  %s = add i32 %p, %x\n"
+                             "  br label %loop\n"
+                             "}\n";
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(ModuleString, Err, C);
+  Function *F = M->getFunction("f");
+  ASSERT_TRUE(F);
+  Argument &X = *F->arg_begin();
+  BasicBlock &Entry = F->getEntryBlock();
+  auto *P = cast<PHINode>(&F->back().front());
+
+  // Grow the hung-off operands of the phi well past their initial size.
+  for (unsigned I = 0; I < 100; ++I)
+    P->addIncoming(&X, &Entry);
+  ASSERT_EQ(101u, P->getNumIncomingValues());
+  for (unsigned I = 0; I < P->getNumIncomingValues(); ++I) {
+    EXPECT_EQ(&X, P->getIncomingValue(I));
+    EXPECT_EQ(&Entry, P->getIncomingBlock(I));
+    EXPECT_EQ(P, P->getOperandUse(I).getUser());
+    EXPECT_EQ(I, P->getOperandUse(I).getOperandNo());
+  }
+
+  auto *S = cast<BinaryOperator>(P->getNextNode());
+  ASSERT_FALSE(S->swapOperands());
+  EXPECT_EQ(&X, S->getOperand(0));
+  for (Use &U : S->operands())
+    EXPECT_EQ(S, U.getUser());
+
+  unsigned NumUses = 0;
+  for (Use &U : X.uses()) {
+    EXPECT_TRUE(U.getUser() == P || U.getUser() == S);
+    ++NumUses;
+  }
+  EXPECT_EQ(102u, NumUses);
+}
+
 } // end anonymous namespace
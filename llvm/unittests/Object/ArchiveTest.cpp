@@ -7,6 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Object/Archive.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Object/ArchiveWriter.h"
+#include "llvm/ObjectYAML/yaml2obj.h"
+#include "llvm/Support/YAMLTraits.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
 
@@ -91,3 +95,61 @@ TEST_F(ArchiveTestsFixture, ArchiveChildGetBuffer) {
   EXPECT_EQ(MemberSize, Buffer->size());
   EXPECT_EQ(ArchiveWithMember + sizeof(ArchiveWithMember) - 1, Buffer->data());
 }
+
+static Error yamlToMember(SmallVectorImpl<char> &Storage, StringRef Yaml) {
+  raw_svector_ostream OS(Storage);
+  yaml::Input YIn(Yaml);
+  if (!yaml::convertYAML(YIn, OS, [](const Twine &Msg) {}))
+    return createStringError(std::errc::invalid_argument,
+                             "unable to convert YAML");
+  return Error::success();
+}
+
+// The symbols of the members are read in parallel. Check that the symbol table
+// still lists them in member order.
+TEST(ArchiveWriterTest, SymbolTableOrder) {
+  static const unsigned NumMembers = 16;
+  SmallVector<SmallString<0>, 0> Objects(NumMembers);
+  SmallVector<std::string, 0> Names;
+  std::vector<NewArchiveMember> Members;
+  for (unsigned I = 0; I != NumMembers; ++I) {
+    ASSERT_THAT_ERROR(yamlToMember(Objects[I], (Twine(R"(
+--- !ELF
+FileHeader:
+  Class: ELFCLASS64
+  Data:  ELFDATA2LSB
+  Type:  ET_REL
+Sections:
+  - Name: .text
+    Type: SHT_PROGBITS
+Symbols:
+  - Name:    sym)") + Twine(I) + R"(
+    Section: .text
+    Binding: STB_GLOBAL
+)").str()),
+                      Succeeded());
+    Names.push_back(("member" + Twine(I) + ".o").str());
+  }
+  for (unsigned I = 0; I != NumMembers; ++I)
+    Members.emplace_back(MemoryBufferRef(Objects[I], Names[I]));
+
+  Expected<std::unique_ptr<MemoryBuffer>> Buf =
+      writeArchiveToBuffer(Members, /*WriteSymtab=*/true, Archive::K_GNU,
+                           /*Deterministic=*/true, /*Thin=*/false);
+  ASSERT_THAT_EXPECTED(Buf, Succeeded());
+  Expected<std::unique_ptr<Archive>> A = Archive::create(**Buf);
+  ASSERT_THAT_EXPECTED(A, Succeeded());
+
+  unsigned I = 0;
+  for (const Archive::Symbol &S : (*A)->symbols()) {
+    ASSERT_LT(I, NumMembers);
+    EXPECT_EQ(("sym" + Twine(I)).str(), S.getName());
+    Expected<Archive::Child> C = S.getMember();
+    ASSERT_THAT_EXPECTED(C, Succeeded());
+    Expected<StringRef> Name = C->getName();
+    ASSERT_THAT_EXPECTED(Name, Succeeded());
+    EXPECT_EQ(Names[I], *Name);
+    ++I;
+  }
+  EXPECT_EQ(NumMembers, I);
+}
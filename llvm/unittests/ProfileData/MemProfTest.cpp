@@ -0,0 +1,197 @@
+//===- unittest/ProfileData/MemProfTest.cpp ---------------------------------=//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ProfileData/MemProf.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
+#include "llvm/ProfileData/RawMemProfReader.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::memprof;
+
+namespace {
+
+constexpr uint64_t SegmentStart = 0x400000;
+constexpr uint64_t SegmentEnd = 0x500000;
+constexpr uint64_t FileOffsetToAddress = 0x1000;
+
+// The PCs of the profiled stacks.
+constexpr uint64_t RuntimePC = 0x400100;
+constexpr uint64_t InlinedPC = 0x400200;
+constexpr uint64_t PlainPC = 0x400300;
+constexpr uint64_t LibraryPC = 0x7f0000001000;
+
+uint64_t toAddress(uint64_t PC) {
+  return PC - SegmentStart + FileOffsetToAddress;
+}
+
+DILineInfo makeInfo(StringRef Function, StringRef File, uint32_t Line,
+                    uint32_t Column, uint32_t StartLine) {
+  DILineInfo Info;
+  Info.FunctionName = Function.str();
+  Info.FileName = File.str();
+  Info.Line = Line;
+  Info.Column = Column;
+  Info.StartLine = StartLine;
+  return Info;
+}
+
+// A symbolizer returning canned frames for the addresses of the PCs above.
+class MockSymbolizer : public symbolize::SymbolizableModule {
+public:
+  DIInliningInfo symbolizeInlinedCode(object::SectionedAddress Address,
+                                      DILineInfoSpecifier,
+                                      bool) const override {
+    DIInliningInfo Result;
+    if (Address.Address == toAddress(RuntimePC)) {
+      Result.addFrame(makeInfo("_Znwm", "compiler-rt/lib/memprof/memprof.cpp",
+                               10, 3, 8));
+    } else if (Address.Address == toAddress(InlinedPC)) {
+      Result.addFrame(makeInfo("_Z3foov", "foo.cpp", 12, 5, 10));
+      Result.addFrame(makeInfo("_Z3barv", "foo.cpp", 24, 7, 20));
+    } else if (Address.Address == toAddress(PlainPC)) {
+      Result.addFrame(makeInfo("_Z3bazv", "baz.cpp", 31, 9, 30));
+    } else {
+      Result.addFrame(DILineInfo());
+    }
+    return Result;
+  }
+
+  DILineInfo symbolizeCode(object::SectionedAddress, DILineInfoSpecifier,
+                           bool) const override {
+    llvm_unreachable("unused");
+  }
+  DIGlobal symbolizeData(object::SectionedAddress) const override {
+    llvm_unreachable("unused");
+  }
+  std::vector<DILocal> symbolizeFrame(object::SectionedAddress) const override {
+    llvm_unreachable("unused");
+  }
+  bool isWin32Module() const override { return false; }
+  uint64_t getModulePreferredBase() const override { return 0; }
+};
+
+template <class T> void append(std::string &Buffer, const T &Value) {
+  Buffer.append(reinterpret_cast<const char *>(&Value), sizeof(T));
+}
+
+void alignTo8(std::string &Buffer) {
+  Buffer.resize(alignTo(Buffer.size(), sizeof(uint64_t)));
+}
+
+MemInfoBlock makeMIB(uint32_t AllocCount, uint64_t AccessCount, uint64_t Size,
+                     uint64_t Lifetime) {
+  MemInfoBlock Info;
+  std::memset(&Info, 0, sizeof(Info));
+  Info.alloc_count = AllocCount;
+  Info.total_access_count = AccessCount;
+  Info.total_size = Size;
+  Info.total_lifetime = Lifetime;
+  return Info;
+}
+
+// Serialize a raw profile in the layout of the memprof runtime.
+std::string makeRawProfile(
+    ArrayRef<std::pair<uint64_t, MemInfoBlock>> MIBs,
+    ArrayRef<std::pair<uint64_t, std::vector<uint64_t>>> Stacks) {
+  std::string Buffer(sizeof(Header), '\0');
+
+  const uint64_t SegmentOffset = Buffer.size();
+  append<uint64_t>(Buffer, 1);
+  append(Buffer, SegmentEntry(SegmentStart, SegmentEnd, 0));
+  alignTo8(Buffer);
+
+  const uint64_t MIBOffset = Buffer.size();
+  append<uint64_t>(Buffer, MIBs.size());
+  for (const auto &MIB : MIBs) {
+    append(Buffer, MIB.first);
+    append(Buffer, MIB.second);
+  }
+  alignTo8(Buffer);
+
+  const uint64_t StackOffset = Buffer.size();
+  append<uint64_t>(Buffer, Stacks.size());
+  for (const auto &Stack : Stacks) {
+    append(Buffer, Stack.first);
+    append<uint64_t>(Buffer, Stack.second.size());
+    for (uint64_t PC : Stack.second)
+      append(Buffer, PC);
+  }
+  alignTo8(Buffer);
+
+  Header H{MEMPROF_RAW_MAGIC_64, MEMPROF_RAW_VERSION, Buffer.size(),
+           SegmentOffset,        MIBOffset,           StackOffset};
+  std::memcpy(&Buffer[0], &H, sizeof(H));
+  return Buffer;
+}
+
+TEST(MemProfTest, GetAllocType) {
+  // Allocations living 10 minutes on average with few accesses are cold.
+  EXPECT_EQ(getAllocType(makeMIB(2, 10, 1024, 1200 * 1000)),
+            AllocationType::Cold);
+  // They are not if they are short lived...
+  EXPECT_EQ(getAllocType(makeMIB(2, 10, 1024, 2 * 1000)),
+            AllocationType::NotCold);
+  // ... or frequently accessed.
+  EXPECT_EQ(getAllocType(makeMIB(2, 1000000, 1024, 1200 * 1000)),
+            AllocationType::NotCold);
+  EXPECT_EQ(getAllocType(MemInfoBlock()), AllocationType::NotCold);
+
+  EXPECT_EQ(getAllocTypeAttributeString(AllocationType::Cold), "cold");
+  EXPECT_EQ(getAllocTypeAttributeString(AllocationType::NotCold), "notcold");
+  EXPECT_EQ(getAllocTypeAttributeString(AllocationType::Hot), "hot");
+}
+
+TEST(MemProfTest, ReadRecords) {
+  const MemInfoBlock ColdMIB = makeMIB(2, 10, 1024, 1200 * 1000);
+  const MemInfoBlock HotMIB = makeMIB(4, 4096, 512, 40);
+  std::string Raw = makeRawProfile({{1, ColdMIB}, {2, HotMIB}, {3, HotMIB}},
+                                   {{1, {RuntimePC, InlinedPC}},
+                                    {2, {LibraryPC}},
+                                    {3, {PlainPC, LibraryPC}}});
+
+  RawMemProfReader Reader(MemoryBuffer::getMemBufferCopy(Raw),
+                          std::make_unique<MockSymbolizer>(),
+                          FileOffsetToAddress);
+  auto RecordsOr = Reader.readRecords();
+  ASSERT_THAT_EXPECTED(RecordsOr, Succeeded());
+  const std::vector<MemProfRecord> &Records = *RecordsOr;
+
+  // The context without frames in the binary is dropped, as well as the
+  // frames of the runtime and of the libraries.
+  ASSERT_EQ(Records.size(), 2U);
+
+  ASSERT_EQ(Records[0].CallStack.size(), 2U);
+  EXPECT_EQ(Records[0].CallStack[0].Function, "_Z3foov");
+  EXPECT_EQ(Records[0].CallStack[0].LineOffset, 2U);
+  EXPECT_EQ(Records[0].CallStack[0].Column, 5U);
+  EXPECT_TRUE(Records[0].CallStack[0].IsInlineFrame);
+  EXPECT_EQ(Records[0].CallStack[1].Function, "_Z3barv");
+  EXPECT_EQ(Records[0].CallStack[1].LineOffset, 4U);
+  EXPECT_FALSE(Records[0].CallStack[1].IsInlineFrame);
+  EXPECT_EQ(uint32_t(Records[0].Info.alloc_count), 2U);
+  EXPECT_EQ(uint64_t(Records[0].Info.total_lifetime), 1200U * 1000);
+  EXPECT_EQ(getAllocType(Records[0].Info), AllocationType::Cold);
+
+  ASSERT_EQ(Records[1].CallStack.size(), 1U);
+  EXPECT_EQ(Records[1].CallStack[0].Function, "_Z3bazv");
+  EXPECT_EQ(Records[1].CallStack[0].LineOffset, 1U);
+  EXPECT_EQ(uint64_t(Records[1].Info.total_access_count), 4096U);
+}
+
+TEST(MemProfTest, ReadRecordsRequiresSymbolizer) {
+  std::string Raw = makeRawProfile({}, {});
+  RawMemProfReader Reader(MemoryBuffer::getMemBufferCopy(Raw));
+  EXPECT_THAT_EXPECTED(Reader.readRecords(), Failed());
+}
+
+} // end anonymous namespace
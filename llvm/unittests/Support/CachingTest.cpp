@@ -0,0 +1,66 @@
+//===- CachingTest.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+TEST(CachingTest, TieredCache) {
+  SmallString<128> TestDirectory;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("caching-test", TestDirectory));
+
+  std::vector<std::string> Added;
+  Expected<FileCache> LocalOrErr =
+      localCache("test", "test", TestDirectory,
+                 [&](unsigned Task, std::unique_ptr<MemoryBuffer> MB) {
+                   Added.push_back(MB->getBuffer().str());
+                 });
+  ASSERT_THAT_EXPECTED(LocalOrErr, Succeeded());
+
+  unsigned Lookups = 0;
+  FileCache Cache = tieredCache(
+      *LocalOrErr,
+      [&](StringRef Key) -> Expected<std::unique_ptr<MemoryBuffer>> {
+        ++Lookups;
+        if (Key == "remote")
+          return MemoryBuffer::getMemBuffer("remote contents");
+        return nullptr;
+      });
+
+  // A hit in the second tier is added to the link and to the first tier.
+  Expected<AddStreamFn> AddStreamOrErr = Cache(0, "remote");
+  ASSERT_THAT_EXPECTED(AddStreamOrErr, Succeeded());
+  EXPECT_FALSE(*AddStreamOrErr);
+  ASSERT_EQ(1u, Added.size());
+  EXPECT_EQ("remote contents", Added[0]);
+  EXPECT_EQ(1u, Lookups);
+
+  AddStreamOrErr = Cache(0, "remote");
+  ASSERT_THAT_EXPECTED(AddStreamOrErr, Succeeded());
+  EXPECT_FALSE(*AddStreamOrErr);
+  ASSERT_EQ(2u, Added.size());
+  EXPECT_EQ("remote contents", Added[1]);
+  EXPECT_EQ(1u, Lookups);
+
+  // A miss in both tiers returns a stream for the first tier.
+  AddStreamOrErr = Cache(0, "missing");
+  ASSERT_THAT_EXPECTED(AddStreamOrErr, Succeeded());
+  EXPECT_TRUE(*AddStreamOrErr);
+  EXPECT_EQ(2u, Lookups);
+  EXPECT_EQ(2u, Added.size());
+
+  ASSERT_FALSE(sys::fs::remove_directories(TestDirectory));
+}
+
+} // namespace
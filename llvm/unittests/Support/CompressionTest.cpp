@@ -65,6 +65,28 @@ TEST(CompressionTest, Zlib) {
   TestZlibCompression(BinaryDataStr, zlib::DefaultCompression);
 }
 
+TEST(CompressionTest, ZlibParallel) {
+  std::string Input;
+  for (unsigned I = 0; I < 100000; ++I)
+    Input += std::to_string(I * 2654435761u % 1000);
+
+  for (int Level : {zlib::NoCompression, zlib::BestSpeedCompression,
+                    zlib::DefaultCompression, zlib::BestSizeCompression}) {
+    SmallString<32> Compressed;
+    SmallString<32> Uncompressed;
+    EXPECT_FALSE(zlib::compressParallel(Input, Compressed, Level, 4096));
+    EXPECT_FALSE(zlib::uncompress(Compressed, Uncompressed, Input.size()));
+    EXPECT_EQ(Input, Uncompressed);
+  }
+
+  // Inputs of a single chunk are compressed like with compress().
+  SmallString<32> Compressed;
+  SmallString<32> Expected;
+  EXPECT_FALSE(zlib::compressParallel("hello, world!", Compressed));
+  EXPECT_FALSE(zlib::compress("hello, world!", Expected));
+  EXPECT_EQ(Expected, Compressed);
+}
+
 TEST(CompressionTest, ZlibCRC32) {
   EXPECT_EQ(
       0x414FA339U,
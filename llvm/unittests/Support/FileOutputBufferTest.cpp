@@ -155,6 +155,31 @@ TEST(FileOutputBuffer, Test) {
   ASSERT_EQ(File6Size, 0ULL);
   ASSERT_NO_ERROR(fs::remove(File6.str()));
 
+  // TEST 7: Verify that content modified after startWriteBack() is committed.
+  SmallString<128> File7(TestDirectory);
+  File7.append("/file7");
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File7, 8192);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    memset(Buffer->getBufferStart(), 'A', 8192);
+    Buffer->startWriteBack(0, 4096);
+    memcpy(Buffer->getBufferStart(), "BBBB", 4);
+    Buffer->startWriteBack(4096, 4096);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+  {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+        MemoryBuffer::getFile(File7);
+    ASSERT_NO_ERROR(BufferOrErr.getError());
+    StringRef Data = (*BufferOrErr)->getBuffer();
+    ASSERT_EQ(Data.size(), 8192U);
+    EXPECT_EQ(Data.substr(0, 5), "BBBBA");
+    EXPECT_EQ(Data.back(), 'A');
+  }
+  ASSERT_NO_ERROR(fs::remove(File7.str()));
+
   // Clean up.
   ASSERT_NO_ERROR(fs::remove(TestDirectory.str()));
 }
@@ -14,6 +14,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -49,6 +50,18 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, NestedParallelFor) {
+  // Every outer task runs an inner parallel loop; this must neither deadlock
+  // nor lose any work.
+  std::atomic<unsigned> Count{0};
+  parallelForEachN(0, 64, [&](size_t) {
+    parallelForEachN(0, 64, [&](size_t) {
+      parallelForEachN(0, 4, [&](size_t) { ++Count; });
+    });
+  });
+  EXPECT_EQ(64u * 64u * 4u, Count);
+}
+
 TEST(Parallel, TransformReduce) {
   // Sum an empty list, check that it works.
   auto identity = [](uint32_t v) { return v; };
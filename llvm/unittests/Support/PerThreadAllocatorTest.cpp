@@ -0,0 +1,55 @@
+//===- PerThreadAllocatorTest.cpp - PerThreadAllocator tests --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/PerThreadAllocator.h"
+#include "llvm/Config/llvm-config.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+using namespace llvm;
+
+namespace {
+
+TEST(PerThreadAllocatorTest, SameThreadSameAllocator) {
+  PerThreadBumpPtrAllocator Alloc;
+  EXPECT_EQ(&Alloc.get(), &Alloc.get());
+  void *P = Alloc.Allocate(16, Align(8));
+  EXPECT_NE(nullptr, P);
+  EXPECT_EQ(16u, Alloc.getBytesAllocated());
+
+  Alloc.Reset();
+  EXPECT_EQ(0u, Alloc.getBytesAllocated());
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(PerThreadAllocatorTest, AllocatorPerThread) {
+  // Use a single fast slot, so that the locked path is tested as well.
+  PerThreadAllocator<BumpPtrAllocator, 1> Alloc;
+  const unsigned NumThreads = 4;
+  BumpPtrAllocator *Used[NumThreads];
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T < NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      Used[T] = &Alloc.get();
+      for (unsigned I = 0; I < 100; ++I) {
+        void *P = Alloc.Allocate(sizeof(unsigned), Align(4));
+        *static_cast<unsigned *>(P) = I;
+      }
+      EXPECT_EQ(Used[T], &Alloc.get());
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned T = 0; T < NumThreads; ++T)
+    for (unsigned U = T + 1; U < NumThreads; ++U)
+      EXPECT_NE(Used[T], Used[U]);
+  EXPECT_EQ(NumThreads * 100 * sizeof(unsigned), Alloc.getBytesAllocated());
+}
+#endif
+
+} // end anonymous namespace
@@ -885,6 +885,100 @@ TEST(ProxyFileSystemTest, Basic) {
   EXPECT_FALSE(Local);
 }
 
+namespace {
+/// Counts the calls that reach the file system below a CachingFileSystem.
+struct CountingFileSystem : public vfs::ProxyFileSystem {
+  unsigned NumStatus = 0;
+  unsigned NumDirBegin = 0;
+
+  explicit CountingFileSystem(IntrusiveRefCntPtr<vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  ErrorOr<vfs::Status> status(const Twine &Path) override {
+    ++NumStatus;
+    return ProxyFileSystem::status(Path);
+  }
+  vfs::directory_iterator dir_begin(const Twine &Dir,
+                                    std::error_code &EC) override {
+    ++NumDirBegin;
+    return ProxyFileSystem::dir_begin(Dir, EC);
+  }
+};
+} // end anonymous namespace
+
+TEST(CachingFileSystemTest, CachesStatus) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  Base->addFile("/dir/a", 0, MemoryBuffer::getMemBuffer("a"));
+  IntrusiveRefCntPtr<CountingFileSystem> Counter(new CountingFileSystem(Base));
+  vfs::CachingFileSystem FS(Counter, /*ListingThreshold=*/100);
+  ASSERT_FALSE(FS.setCurrentWorkingDirectory("/dir"));
+
+  auto Stat = FS.status("/dir/a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("/dir/a", Stat->getName());
+  EXPECT_EQ(1u, Counter->NumStatus);
+
+  // Hits keep the spelling of the query.
+  Stat = FS.status("./a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("./a", Stat->getName());
+  EXPECT_EQ(1u, Counter->NumStatus);
+
+  // Misses are cached, and known misses fail to open right away.
+  EXPECT_TRUE(FS.status("/dir/b").getError());
+  EXPECT_TRUE(FS.status("b").getError());
+  EXPECT_EQ(2u, Counter->NumStatus);
+  EXPECT_TRUE(FS.openFileForRead("/dir/b").getError());
+
+  // The cache goes stale until it is invalidated.
+  Base->addFile("/dir/b", 0, MemoryBuffer::getMemBuffer("b"));
+  EXPECT_TRUE(FS.status("/dir/b").getError());
+  FS.invalidate("/dir/b");
+  EXPECT_FALSE(FS.status("/dir/b").getError());
+  auto File = FS.openFileForRead("/dir/b");
+  ASSERT_FALSE(File.getError());
+  EXPECT_EQ("b", (*(*File)->getBuffer("ignored"))->getBuffer());
+  EXPECT_EQ(3u, Counter->NumStatus);
+  EXPECT_EQ(0u, Counter->NumDirBegin);
+
+  FS.invalidateAll();
+  EXPECT_FALSE(FS.status("/dir/a").getError());
+  EXPECT_EQ(4u, Counter->NumStatus);
+}
+
+TEST(CachingFileSystemTest, ListsDirectoriesWithManyMisses) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  Base->addFile("/inc/Foo.h", 0, MemoryBuffer::getMemBuffer("foo"));
+  IntrusiveRefCntPtr<CountingFileSystem> Counter(new CountingFileSystem(Base));
+  vfs::CachingFileSystem FS(Counter, /*ListingThreshold=*/2);
+
+  EXPECT_TRUE(FS.status("/inc/a.h").getError());
+  EXPECT_EQ(0u, Counter->NumDirBegin);
+  EXPECT_TRUE(FS.status("/inc/b.h").getError());
+  EXPECT_EQ(1u, Counter->NumDirBegin);
+  EXPECT_EQ(2u, Counter->NumStatus);
+
+  // Names that are not listed fail without a stat.
+  EXPECT_TRUE(FS.status("/inc/c.h").getError());
+  EXPECT_TRUE(FS.openFileForRead("/inc/d.h").getError());
+  EXPECT_EQ(2u, Counter->NumStatus);
+
+  // Listed names, and names that only differ from them in case, are still
+  // looked up.
+  EXPECT_FALSE(FS.status("/inc/Foo.h").getError());
+  EXPECT_TRUE(FS.status("/inc/foo.h").getError());
+  EXPECT_EQ(4u, Counter->NumStatus);
+
+  // Invalidating an entry drops the listing of its directory.
+  Base->addFile("/inc/c.h", 0, MemoryBuffer::getMemBuffer("c"));
+  FS.invalidate("/inc/c.h");
+  EXPECT_FALSE(FS.status("/inc/c.h").getError());
+  EXPECT_FALSE(FS.openFileForRead("/inc/c.h").getError());
+  EXPECT_EQ(5u, Counter->NumStatus);
+}
+
 class InMemoryFileSystemTest : public ::testing::Test {
 protected:
   llvm::vfs::InMemoryFileSystem FS;
@@ -145,8 +145,8 @@ cl::opt<std::string> Class("class", cl::desc("Print Enum list for this class"),
                            cl::value_desc("class name"),
                            cl::cat(PrintEnumsCat));
 
-bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
-  switch (Action) {
+bool runAction(ActionType A, raw_ostream &OS, RecordKeeper &Records) {
+  switch (A) {
   case PrintRecords:
     OS << Records;              // No argument, dump all contents
     break;
@@ -276,13 +276,30 @@ bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
 
   return false;
 }
+
+bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
+  return runAction(Action, OS, Records);
+}
+
+bool LLVMTableGenBackend(StringRef Backend, raw_ostream &OS,
+                         RecordKeeper &Records) {
+  auto &Parser = Action.getParser();
+  if (Parser.findOption(Backend) == Parser.getNumOptions()) {
+    errs() << "llvm-tblgen: unknown backend '" << Backend
+           << "' for -extra-output\n";
+    return true;
+  }
+  ActionType A;
+  Parser.parse(Action, Backend, "", A);
+  return runAction(A, OS, Records);
+}
 }
 
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
   cl::ParseCommandLineOptions(argc, argv);
 
-  return TableGenMain(argv[0], &LLVMTableGenMain);
+  return TableGenMain(argv[0], &LLVMTableGenMain, &LLVMTableGenBackend);
 }
 
 #ifndef __has_feature
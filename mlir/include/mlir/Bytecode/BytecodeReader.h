@@ -0,0 +1,91 @@
+//===- BytecodeReader.h - MLIR Bytecode Reader ------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header defines interfaces to read MLIR bytecode files/streams.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_BYTECODE_BYTECODEREADER_H
+#define MLIR_BYTECODE_BYTECODEREADER_H
+
+#include "mlir/Support/LLVM.h"
+#include "mlir/Support/LogicalResult.h"
+#include <memory>
+
+namespace llvm {
+class MemoryBuffer;
+class MemoryBufferRef;
+} // namespace llvm
+
+namespace mlir {
+class Block;
+class MLIRContext;
+class Operation;
+
+/// Returns true if the given buffer starts with the magic bytes that signal
+/// MLIR bytecode.
+bool isBytecode(llvm::MemoryBufferRef buffer);
+
+/// Read the operations defined within the given memory buffer, containing MLIR
+/// bytecode, into the provided block. Errors are emitted through the
+/// diagnostic handlers of `context`.
+LogicalResult readBytecodeFile(llvm::MemoryBufferRef buffer, Block *block,
+                               MLIRContext *context);
+
+/// Read the operations defined within the given memory buffer, containing MLIR
+/// bytecode, into the provided block. The data of resource attributes, such as
+/// DenseResourceElementsAttr, is referenced in place instead of being copied,
+/// and keeps the buffer alive for as long as it is used.
+LogicalResult
+readBytecodeFile(const std::shared_ptr<llvm::MemoryBuffer> &buffer,
+                 Block *block, MLIRContext *context);
+
+/// A reader of MLIR bytecode that can leave the regions of operations that are
+/// IsolatedFromAbove unread until they are needed.
+///
+/// When lazy loading is enabled, such operations are created with empty
+/// regions and are said to be materializable. Their regions are read by
+/// materialize(), which may in turn expose new materializable operations
+/// nested inside them. The buffer must outlive the reader, and the reader must
+/// outlive the materializable operations, which must not be erased or cloned
+/// before they have been materialized.
+class BytecodeReader {
+public:
+  BytecodeReader(llvm::MemoryBufferRef buffer, MLIRContext *context,
+                 bool lazyLoading = false);
+  /// Construct a reader that references the data of resource attributes in
+  /// `buffer` instead of copying it, see readBytecodeFile.
+  BytecodeReader(std::shared_ptr<llvm::MemoryBuffer> buffer,
+                 MLIRContext *context, bool lazyLoading = false);
+  ~BytecodeReader();
+
+  /// Read the top-level operations of the buffer into `block`. This may only
+  /// be called once.
+  LogicalResult read(Block *block);
+
+  /// Returns true if the regions of `op` have not been read yet.
+  bool isMaterializable(Operation *op) const;
+
+  /// Returns the number of operations whose regions have not been read yet.
+  unsigned getNumMaterializable() const;
+
+  /// Read the regions of the given materializable operation.
+  LogicalResult materialize(Operation *op);
+
+  /// Read the regions of all of the materializable operations, including the
+  /// ones that are exposed while doing so.
+  LogicalResult materializeAll();
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl;
+};
+
+} // namespace mlir
+
+#endif // MLIR_BYTECODE_BYTECODEREADER_H
@@ -22,17 +22,20 @@ namespace mlir {
 class TypeConverter;
 
 /// Defines a parallelization strategy. Any independent loop is a candidate
-/// for parallelization. The loop is made parallel if (1) allowed by the
-/// strategy (e.g., AnyStorageOuterLoop considers either a dense or sparse
-/// outermost loop only), and (2) the generated code is an actual for-loop
-/// (and not a co-iterating while-loop).
+/// for parallelization, and so is any reduction loop that updates a scalarized
+/// reduction (i.e., after all indices of the output tensor have been visited).
+/// The loop is made parallel if (1) allowed by the strategy (e.g.,
+/// AnyStorageOuterLoop considers either a dense or sparse outermost loop only),
+/// and (2) the generated code is an actual for-loop (and not a co-iterating
+/// while-loop). Parallel reductions combine the partial values of the
+/// iterations in an unspecified order, which reassociates floating-point
+/// reductions.
 enum class SparseParallelizationStrategy {
   kNone,
   kDenseOuterLoop,
   kAnyStorageOuterLoop,
   kDenseAnyLoop,
   kAnyStorageAnyLoop
-  // TODO: support reduction parallelization too?
 };
 
 /// Converts command-line parallelization flag to the strategy enum.
@@ -10,6 +10,7 @@
 #define MLIR_IR_BUILTINATTRIBUTES_H
 
 #include "mlir/IR/BuiltinAttributeInterfaces.h"
+#include "mlir/IR/ResourceBlobManager.h"
 #include "mlir/IR/SubElementInterfaces.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/Sequence.h"
@@ -729,6 +730,42 @@ public:
     return denseAttr && denseAttr.isSplat();
   }
 };
+
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsHandle
+//===----------------------------------------------------------------------===//
+
+/// A reference to an entry of the ResourceBlobManager of a context, which
+/// holds the data of a DenseResourceElementsAttr. Handles compare and hash by
+/// the identity of the entry, so the data is never hashed.
+class DenseResourceElementsHandle {
+public:
+  DenseResourceElementsHandle(ResourceBlobManager::BlobEntry *entry = nullptr)
+      : entry(entry) {}
+
+  /// Return the entry referenced by this handle.
+  ResourceBlobManager::BlobEntry *getEntry() const { return entry; }
+
+  /// Return the name of the referenced entry.
+  StringRef getKey() const { return entry->getKey(); }
+
+  /// Return the blob of the referenced entry, or null if it has none.
+  ResourceBlob *getBlob() const { return entry->getBlob(); }
+
+  bool operator==(const DenseResourceElementsHandle &other) const {
+    return entry == other.entry;
+  }
+  bool operator!=(const DenseResourceElementsHandle &other) const {
+    return !(*this == other);
+  }
+
+  friend ::llvm::hash_code hash_value(const DenseResourceElementsHandle &h) {
+    return ::llvm::hash_value(h.entry);
+  }
+
+private:
+  ResourceBlobManager::BlobEntry *entry;
+};
 } // namespace mlir
 
 //===----------------------------------------------------------------------===//
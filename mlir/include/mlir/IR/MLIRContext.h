@@ -28,6 +28,7 @@ class InFlightDiagnostic;
 class Location;
 class MLIRContextImpl;
 class RegisteredOperationName;
+class ResourceBlobManager;
 class StorageUniquer;
 
 /// MLIRContext is the top-level object for a collection of MLIR operations. It
@@ -205,6 +206,10 @@ public:
   /// Returns the manager of debug actions within the context.
   DebugActionManager &getDebugActionManager();
 
+  /// Returns the manager of the blobs of data referenced by resource
+  /// attributes, such as DenseResourceElementsAttr, within the context.
+  ResourceBlobManager &getResourceBlobManager();
+
   /// These APIs are tracking whether the context will be used in a
   /// multithreading environment: this has no effect other than enabling
   /// assertions on misuses of some APIs.
@@ -0,0 +1,141 @@
+//===- ResourceBlobManager.h - Out-of-line data blobs -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines utilities for managing blobs of data, such as the payload
+// of large constants, that are referenced by attributes but are not stored in
+// the attribute uniquer.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_IR_RESOURCEBLOBMANAGER_H
+#define MLIR_IR_RESOURCEBLOBMANAGER_H
+
+#include "mlir/Support/LLVM.h"
+#include "llvm/ADT/FunctionExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/RWMutex.h"
+#include <memory>
+
+namespace llvm {
+class MemoryBuffer;
+} // namespace llvm
+
+namespace mlir {
+
+//===----------------------------------------------------------------------===//
+// ResourceBlob
+//===----------------------------------------------------------------------===//
+
+/// A blob of data with an optional deleter, which is invoked when the blob is
+/// destroyed or replaced. The data may be owned, e.g. by a heap allocation or
+/// a memory mapped file, or borrowed from memory that outlives the blob.
+class ResourceBlob {
+public:
+  /// A deleter function that releases the given data.
+  using DeleterFn =
+      llvm::unique_function<void(const char *data, size_t size, size_t align)>;
+
+  ResourceBlob() = default;
+  ResourceBlob(ArrayRef<char> data, size_t dataAlignment, DeleterFn deleter)
+      : data(data), dataAlignment(dataAlignment), deleter(std::move(deleter)) {}
+  ResourceBlob(ResourceBlob &&other) { *this = std::move(other); }
+  ResourceBlob &operator=(ResourceBlob &&other);
+  ResourceBlob(const ResourceBlob &) = delete;
+  ResourceBlob &operator=(const ResourceBlob &) = delete;
+  ~ResourceBlob() { release(); }
+
+  /// Return the raw data of this blob.
+  ArrayRef<char> getData() const { return data; }
+
+  /// Return the alignment of the data of this blob.
+  size_t getDataAlignment() const { return dataAlignment; }
+
+  /// Create a blob that owns a copy of `data`, aligned to `alignment`.
+  static ResourceBlob allocateAndCopy(ArrayRef<char> data, size_t alignment);
+
+  /// Create a blob that refers to `data` without owning it. The data must
+  /// outlive the blob.
+  static ResourceBlob createUnowned(ArrayRef<char> data, size_t alignment) {
+    return ResourceBlob(data, alignment, /*deleter=*/nullptr);
+  }
+
+  /// Create a blob that refers to `data`, which lies within `buffer`, e.g. a
+  /// memory mapped file. The buffer is kept alive as long as the blob.
+  static ResourceBlob
+  createFromBuffer(std::shared_ptr<llvm::MemoryBuffer> buffer,
+                   ArrayRef<char> data, size_t alignment);
+
+private:
+  /// Release the data of this blob.
+  void release();
+
+  ArrayRef<char> data;
+  size_t dataAlignment = 1;
+  DeleterFn deleter;
+};
+
+//===----------------------------------------------------------------------===//
+// ResourceBlobManager
+//===----------------------------------------------------------------------===//
+
+/// This class manages a set of named blobs of data. Entries are never removed,
+/// so that attributes can refer to them by pointer; the blob of an entry can
+/// however be replaced or released at any time. The data of all of the blobs
+/// is released when the manager is destroyed.
+///
+/// Looking up and inserting entries is thread-safe. Replacing the blob of an
+/// entry must not race with uses of its data.
+class ResourceBlobManager {
+public:
+  /// A named entry of the manager, holding an optional blob.
+  class BlobEntry {
+  public:
+    /// Return the name of this entry.
+    StringRef getKey() const { return key; }
+
+    /// Return the blob of this entry, or null if it has none.
+    const ResourceBlob *getBlob() const {
+      return blob ? blob.getPointer() : nullptr;
+    }
+    ResourceBlob *getBlob() { return blob ? blob.getPointer() : nullptr; }
+
+    /// Replace the blob of this entry, releasing the previous one.
+    void setBlob(ResourceBlob &&newBlob) { blob = std::move(newBlob); }
+
+    /// Release the blob of this entry.
+    void releaseBlob() { blob.reset(); }
+
+  private:
+    /// The name of this entry, owned by the manager.
+    StringRef key;
+
+    /// The blob of this entry.
+    Optional<ResourceBlob> blob;
+
+    friend class ResourceBlobManager;
+  };
+
+  /// Return the entry with the given name, or null if there is none.
+  BlobEntry *lookup(StringRef name);
+
+  /// Insert a new entry with the given name and blob. If the name is already
+  /// taken, a unique name is formed by appending a counter to it.
+  BlobEntry &insert(StringRef name, Optional<ResourceBlob> blob = llvm::None);
+
+  /// Return the entry with the given name, inserting an entry without a blob
+  /// if there is none.
+  BlobEntry &getOrInsert(StringRef name);
+
+private:
+  llvm::sys::SmartRWMutex<true> blobMapLock;
+  llvm::StringMap<BlobEntry> blobMap;
+};
+
+} // namespace mlir
+
+#endif // MLIR_IR_RESOURCEBLOBMANAGER_H
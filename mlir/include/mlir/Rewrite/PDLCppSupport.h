@@ -0,0 +1,100 @@
+//===- PDLCppSupport.h - PDL patterns compiled to C++ ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the utilities used by the native rewrite patterns that
+// `mlir-translate -pdl-to-cpp` generates from PDL patterns. It must be included
+// before the generated code.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_REWRITE_PDLCPPSUPPORT_H
+#define MLIR_REWRITE_PDLCPPSUPPORT_H
+
+#include "mlir/IR/OperationSupport.h"
+#include "mlir/IR/PatternMatch.h"
+
+namespace mlir {
+namespace pdl_cpp {
+
+//===----------------------------------------------------------------------===//
+// Pattern Construction
+//===----------------------------------------------------------------------===//
+
+/// Parse the given constant attribute or type of a generated pattern. These
+/// abort if the constant is malformed, or one of its dialects isn't loaded.
+Attribute parseConstantAttr(StringRef attrStr, MLIRContext *context);
+Type parseConstantType(StringRef typeStr, MLIRContext *context);
+
+/// Return the native constraint or rewrite function registered under `name`
+/// in the given module. These abort if no function was registered.
+const PDLConstraintFunction &
+lookupConstraintFunction(const PDLPatternModule &functions, StringRef name);
+const PDLRewriteFunction &
+lookupRewriteFunction(const PDLPatternModule &functions, StringRef name);
+
+//===----------------------------------------------------------------------===//
+// Matching
+//===----------------------------------------------------------------------===//
+
+/// Return the values of the operand, or result, group `index` of `op`, or
+/// None if the group can't be computed.
+Optional<ValueRange> getOperandGroup(Operation *op, unsigned index);
+Optional<ValueRange> getResultGroup(Operation *op, unsigned index);
+
+/// Return the single value of the given range, or null if the range doesn't
+/// contain exactly one value.
+inline Value getSingleValue(Optional<ValueRange> values) {
+  return values && values->size() == 1 ? values->front() : Value();
+}
+
+/// Return the types of the given values.
+inline Optional<TypeRange> getTypes(const Optional<ValueRange> &values) {
+  if (!values)
+    return llvm::None;
+  return TypeRange(*values);
+}
+
+/// Append the users of the given value, or values, to `users`.
+void appendUsers(SmallVectorImpl<Operation *> &users, Value value);
+void appendUsers(SmallVectorImpl<Operation *> &users,
+                 const Optional<ValueRange> &values);
+
+/// Return the PDL value of a range passed to a native function. Ranges are
+/// passed by pointer, and null ranges are passed as a null pointer.
+inline PDLValue toPDLValue(Optional<TypeRange> &value) {
+  return PDLValue(value ? value.getPointer() : (TypeRange *)nullptr);
+}
+inline PDLValue toPDLValue(Optional<ValueRange> &value) {
+  return PDLValue(value ? value.getPointer() : (ValueRange *)nullptr);
+}
+
+//===----------------------------------------------------------------------===//
+// Rewriting
+//===----------------------------------------------------------------------===//
+
+/// Infer the result types of the operation described by `state`, replacing
+/// any types already provided.
+LogicalResult inferResultTypes(OperationState &state);
+
+/// The list of results populated by a native rewrite function. The results
+/// refer to storage held by the list, which must thus outlive their uses.
+class RewriteResultList : public PDLResultList {
+public:
+  RewriteResultList(unsigned maxNumResults) : PDLResultList(maxNumResults) {}
+
+  /// Return the result at the given index.
+  template <typename T>
+  T getResult(unsigned index) const {
+    return results[index].cast<T>();
+  }
+};
+
+} // namespace pdl_cpp
+} // namespace mlir
+
+#endif // MLIR_REWRITE_PDLCPPSUPPORT_H
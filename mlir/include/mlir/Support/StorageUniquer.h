@@ -132,12 +132,47 @@ public:
     llvm::BumpPtrAllocator allocator;
   };
 
+  /// Counters describing how the lookups of parametric storage instances were
+  /// resolved, which help diagnose lock contention in multi-threaded contexts.
+  /// These are only recorded while multi-threading is enabled.
+  struct Statistics {
+    /// The number of lookups resolved by the lookup cache of the calling
+    /// thread, without acquiring any lock. Only the threads that are still
+    /// alive are accounted for.
+    uint64_t numLocalCacheHits = 0;
+
+    /// The number of lookups resolved under the reader lock of a shared shard.
+    uint64_t numSharedHits = 0;
+
+    /// The number of lookups that acquired the writer lock of a shared shard
+    /// to create a new instance.
+    uint64_t numWriterLocks = 0;
+
+    /// The number of writer lock acquisitions that found the instance already
+    /// created by another thread, i.e. that raced with another lookup.
+    uint64_t numRacedInsertions = 0;
+
+    /// The total number of lookups.
+    uint64_t getNumLookups() const {
+      return numLocalCacheHits + numSharedHits + numWriterLocks;
+    }
+
+    Statistics &operator+=(const Statistics &other);
+  };
+
   StorageUniquer();
   ~StorageUniquer();
 
   /// Set the flag specifying if multi-threading is disabled within the uniquer.
   void disableMultithreading(bool disable = true);
 
+  /// Return the statistics of the parametric storage class registered with the
+  /// given type identifier.
+  Statistics getStatistics(TypeID id) const;
+
+  /// Return the statistics of all of the parametric storage classes.
+  Statistics getStatistics() const;
+
   /// Register a new parametric storage class, this is necessary to create
   /// instances of this class type. `id` is the type identifier that will be
   /// used to identify this type when creating instances of it via 'get'.
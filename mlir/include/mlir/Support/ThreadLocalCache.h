@@ -80,6 +80,15 @@ public:
   ValueT &operator*() { return get(); }
   ValueT *operator->() { return &get(); }
 
+  /// Invoke `fn` on the instance of each thread that is still alive. The other
+  /// threads may be using their instances concurrently, so `fn` must only
+  /// access the parts of the values that are safe to share, e.g. atomics.
+  void forEachInstance(function_ref<void(ValueT &)> fn) {
+    llvm::sys::SmartScopedLock<true> threadInstanceLock(instanceMutex);
+    for (std::shared_ptr<ValueT> &instance : instances)
+      fn(*instance);
+  }
+
 private:
   ThreadLocalCache(ThreadLocalCache &&) = delete;
   ThreadLocalCache(const ThreadLocalCache &) = delete;
@@ -0,0 +1,44 @@
+//===- PDLCppEmitter.h - Emit C++ rewrite patterns from PDL -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines helpers to compile PDL patterns into native C++ rewrite
+// patterns, which avoid the overhead of interpreting the patterns at rewrite
+// time.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_TARGET_PDLCPP_PDLCPPEMITTER_H
+#define MLIR_TARGET_PDLCPP_PDLCPPEMITTER_H
+
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir {
+class ModuleOp;
+
+namespace pdl {
+
+/// Translates the `pdl.pattern` operations within `module` to C++ code. Each
+/// pattern becomes a native `mlir::RewritePattern`, and a function named
+/// `populateFnName` is emitted to add all of them to a pattern set:
+///
+///   void populateFnName(RewritePatternSet &patterns,
+///                       const PDLPatternModule &functions);
+///
+/// The native constraint and rewrite functions used by the patterns are looked
+/// up in `functions` when the patterns are constructed. The generated code is
+/// meant to be included into a C++ file, after
+/// "mlir/Rewrite/PDLCppSupport.h".
+LogicalResult translateToCpp(ModuleOp module, llvm::raw_ostream &os,
+                             llvm::StringRef populateFnName);
+
+} // namespace pdl
+} // namespace mlir
+
+#endif // MLIR_TARGET_PDLCPP_PDLCPPEMITTER_H
@@ -892,6 +892,19 @@ private:
 /// ConversionPatternRewriter, to see what additional constraints are imposed on
 /// the use of the PatternRewriter.
 
+/// This class allows control over how the conversion driver applies patterns.
+class ConversionConfig {
+public:
+  /// When set to false, the patterns are expected to never fail after updating
+  /// an operation in place, and the operations they update in place are
+  /// expected to be legalizable. The driver then doesn't record the original
+  /// state of these operations, which it otherwise needs to roll back failed
+  /// patterns, making large one-shot conversions cheaper. Attempting to roll
+  /// back such an update is a fatal error, and operations that were updated in
+  /// place are not restored if the conversion fails.
+  bool allowPatternRollback = true;
+};
+
 /// Apply a partial conversion on the given operations and all nested
 /// operations. This method converts as many operations to the target as
 /// possible, ignoring operations that failed to legalize. This method only
@@ -903,11 +916,13 @@ private:
 LogicalResult
 applyPartialConversion(ArrayRef<Operation *> ops, ConversionTarget &target,
                        const FrozenRewritePatternSet &patterns,
-                       DenseSet<Operation *> *unconvertedOps = nullptr);
+                       DenseSet<Operation *> *unconvertedOps = nullptr,
+                       ConversionConfig config = ConversionConfig());
 LogicalResult
 applyPartialConversion(Operation *op, ConversionTarget &target,
                        const FrozenRewritePatternSet &patterns,
-                       DenseSet<Operation *> *unconvertedOps = nullptr);
+                       DenseSet<Operation *> *unconvertedOps = nullptr,
+                       ConversionConfig config = ConversionConfig());
 
 /// Apply a complete conversion on the given operations, and all nested
 /// operations. This method returns failure if the conversion of any operation
@@ -915,9 +930,11 @@ applyPartialConversion(Operation *op, ConversionTarget &target,
 /// within 'ops'.
 LogicalResult applyFullConversion(ArrayRef<Operation *> ops,
                                   ConversionTarget &target,
-                                  const FrozenRewritePatternSet &patterns);
+                                  const FrozenRewritePatternSet &patterns,
+                                  ConversionConfig config = ConversionConfig());
 LogicalResult applyFullConversion(Operation *op, ConversionTarget &target,
-                                  const FrozenRewritePatternSet &patterns);
+                                  const FrozenRewritePatternSet &patterns,
+                                  ConversionConfig config = ConversionConfig());
 
 /// Apply an analysis conversion on the given operations, and all nested
 /// operations. This method analyzes which operations would be successfully
@@ -926,7 +943,8 @@ LogicalResult applyFullConversion(Operation *op, ConversionTarget &target,
 /// provided 'convertedOps' set; note that no actual rewrites are applied to the
 /// operations on success and only pre-existing operations are added to the set.
 /// This method only returns failure if there are unreachable blocks in any of
-/// the regions nested within 'ops'. There's an additional argument
+/// the regions nested within 'ops'. The patterns are always rolled back during
+/// an analysis. There's an additional argument
 /// `notifyCallback` which is used for collecting match failure diagnostics
 /// generated during the conversion. Diagnostics are only reported to this
 /// callback may only be available in debug mode.
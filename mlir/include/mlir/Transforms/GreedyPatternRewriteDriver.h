@@ -15,9 +15,29 @@
 #define MLIR_TRANSFORMS_GREEDYPATTERNREWRITEDRIVER_H_
 
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
+#include <atomic>
 
 namespace mlir {
 
+/// Counts of the work done by the GreedyPatternRewriteDriver. The counts are
+/// accumulated over all drivers, possibly running in parallel, that are given
+/// the same instance.
+struct GreedyRewriteStatistics {
+  /// The number of times the worklist was seeded from the regions.
+  std::atomic<uint64_t> numIterations{0};
+  /// The number of patterns that were applied successfully.
+  std::atomic<uint64_t> numPatternsApplied{0};
+  /// The number of operations that were folded.
+  std::atomic<uint64_t> numFolded{0};
+  /// The number of operations that were erased because they were dead.
+  std::atomic<uint64_t> numErasedDead{0};
+  /// The number of operations added to the worklist.
+  std::atomic<uint64_t> numWorklistAdditions{0};
+  /// The number of additions skipped because the operation was already in the
+  /// worklist.
+  std::atomic<uint64_t> numWorklistDuplicates{0};
+};
+
 /// This class allows control over how the GreedyPatternRewriteDriver works.
 class GreedyRewriteConfig {
 public:
@@ -37,6 +57,17 @@ public:
   /// to disable this iteration limit.
   int64_t maxIterations = 10;
 
+  /// When set, and multithreading is enabled on the context, the operations
+  /// directly nested in the given regions that are IsolatedFromAbove (e.g.
+  /// the functions of a module) are simplified in parallel by independent
+  /// drivers before the remaining operations are simplified. Patterns must
+  /// then not modify operations outside of the isolated operation they are
+  /// applied in.
+  bool parallelizeIsolatedRegions = false;
+
+  /// If set, counts of the work done are added to this instance.
+  GreedyRewriteStatistics *statistics = nullptr;
+
   static constexpr int64_t kNoIterationLimit = -1;
 };
 
@@ -0,0 +1,141 @@
+//===- Encoding.h - MLIR binary format encoding information -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header defines enum values describing the structure of MLIR bytecode
+// files. It is shared by the bytecode reader and writer.
+//
+// A bytecode file has the following layout:
+//
+//   magic[4] "ML\xefR"
+//   version: varint
+//   producer: varint length, bytes
+//   section*: u8 section id, u64 payload length, payload
+//
+// Variable width integers are ULEB128 encoded. Fixed width integers are
+// little-endian. Every entity that is referenced more than once (strings,
+// operation names, attributes and types) is stored once in a table and
+// referred to by its index in the table.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIB_MLIR_BYTECODE_ENCODING_H
+#define LIB_MLIR_BYTECODE_ENCODING_H
+
+#include <cstdint>
+
+namespace mlir {
+namespace bytecode {
+
+//===----------------------------------------------------------------------===//
+// General constants
+//===----------------------------------------------------------------------===//
+
+enum {
+  /// The current bytecode version.
+  kVersion = 0,
+
+  /// The alignment, relative to the start of the file, of the data of every
+  /// blob. This allows the data to be used in place when the file is mapped
+  /// into memory.
+  kBlobAlignment = 64,
+};
+
+/// The four bytes every bytecode file starts with.
+static constexpr char kMagic[4] = {'M', 'L', '\xef', 'R'};
+
+//===----------------------------------------------------------------------===//
+// Sections
+//===----------------------------------------------------------------------===//
+
+namespace Section {
+enum ID : uint8_t {
+  /// This section contains the strings referenced within the bytecode:
+  ///   numStrings: varint, stringLength: varint[numStrings], data: bytes
+  kString = 0,
+
+  /// This section contains the names of the operations in the IR, each
+  /// encoded as the index of a string.
+  kOpName = 1,
+
+  /// This section contains the attributes and types referenced within the IR:
+  ///   numAttrs: varint, numTypes: varint,
+  ///   attr: (length: varint, kind: varint, payload: bytes)[numAttrs],
+  ///   type: (string: varint)[numTypes]
+  kAttrType = 2,
+
+  /// This section contains the IR, as the list of top-level operations.
+  kIR = 3,
+
+  /// This section contains the raw data of large constants:
+  ///   numBlobs: u64, (offset: u64, size: u64)[numBlobs], data: bytes
+  /// Offsets are relative to the start of the file.
+  kBlob = 4,
+
+  /// The total number of section types.
+  kNumSections = 5,
+};
+} // namespace Section
+
+//===----------------------------------------------------------------------===//
+// Attributes
+//===----------------------------------------------------------------------===//
+
+/// The encoding used for an entry of the attribute table.
+namespace AttrKind {
+enum ID : uint64_t {
+  /// The textual form of the attribute: string: varint
+  kText = 0,
+
+  /// A DenseIntOrFPElementsAttr whose raw data is stored in the blob section:
+  ///   type: varint, blob: varint, isSplat: u8
+  kDenseElements = 1,
+
+  /// An UnknownLoc, with no payload.
+  kUnknownLoc = 2,
+
+  /// A FileLineColLoc: filename: varint (string), line: varint, col: varint
+  kFileLineColLoc = 3,
+
+  /// A NameLoc: name: varint (string), childLoc: varint
+  kNameLoc = 4,
+
+  /// A CallSiteLoc: callee: varint, caller: varint
+  kCallSiteLoc = 5,
+
+  /// A FusedLoc: metadata: varint (attribute index + 1, or 0 if there is no
+  /// metadata), numLocations: varint, location: varint[numLocations]
+  kFusedLoc = 6,
+
+  /// A DenseResourceElementsAttr:
+  ///   type: varint, key: varint (string),
+  ///   blob: varint (blob index + 1, or 0 if the resource has no data)
+  /// Readers reuse the resource of the context with the same key if it has no
+  /// data yet, and otherwise create one with a unique key.
+  kDenseResource = 7,
+};
+} // namespace AttrKind
+
+//===----------------------------------------------------------------------===//
+// Operations
+//===----------------------------------------------------------------------===//
+
+/// The bits of the mask describing which parts an encoded operation has.
+namespace OpEncodingMask {
+enum : uint8_t {
+  kHasAttrs = 1 << 0,
+  kHasResults = 1 << 1,
+  kHasOperands = 1 << 2,
+  kHasSuccessors = 1 << 3,
+  kHasRegions = 1 << 4,
+};
+} // namespace OpEncodingMask
+
+} // namespace bytecode
+} // namespace mlir
+
+#endif // LIB_MLIR_BYTECODE_ENCODING_H
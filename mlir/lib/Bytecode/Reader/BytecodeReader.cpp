@@ -0,0 +1,931 @@
+//===- BytecodeReader.cpp - MLIR Bytecode Reader --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Bytecode/BytecodeReader.h"
+#include "../Encoding.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/Dialect.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/Parser.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Alignment.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstring>
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// EncodingReader
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class reads the primitive encodings of the bytecode from a range of
+/// bytes, emitting an error when the encoding is malformed.
+class EncodingReader {
+public:
+  EncodingReader(ArrayRef<uint8_t> contents, Location fileLoc)
+      : dataIt(contents.begin()), dataEnd(contents.end()), fileLoc(fileLoc) {}
+
+  /// Returns true if the entire range has been read.
+  bool empty() const { return dataIt == dataEnd; }
+
+  /// Returns the number of bytes left to read.
+  size_t size() const { return dataEnd - dataIt; }
+
+  /// Emit an error at the location of the file being read.
+  InFlightDiagnostic emitError(const Twine &msg = {}) {
+    return ::emitError(fileLoc, msg);
+  }
+
+  LogicalResult parseByte(uint8_t &value) {
+    if (empty())
+      return emitError("attempting to parse a byte at the end of the bytecode");
+    value = *dataIt++;
+    return success();
+  }
+
+  LogicalResult parseBytes(size_t length, ArrayRef<uint8_t> &result) {
+    if (length > size()) {
+      return emitError("attempting to parse ")
+             << length << " bytes when only " << size() << " remain";
+    }
+    result = {dataIt, length};
+    dataIt += length;
+    return success();
+  }
+
+  /// Parse a variable width integer.
+  LogicalResult parseVarInt(uint64_t &value) {
+    unsigned numBytes = 0;
+    const char *error = nullptr;
+    value = llvm::decodeULEB128(dataIt, &numBytes, dataEnd, &error);
+    if (error)
+      return emitError("malformed varint: ") << error;
+    dataIt += numBytes;
+    return success();
+  }
+
+  /// Parse a variable width integer that is used as an index into a table
+  /// with `tableSize` entries.
+  LogicalResult parseIndex(uint64_t tableSize, uint64_t &index,
+                           StringRef tableName) {
+    if (failed(parseVarInt(index)))
+      return failure();
+    if (index >= tableSize) {
+      return emitError("invalid ")
+             << tableName << " index: " << index << ", must be less than "
+             << tableSize;
+    }
+    return success();
+  }
+
+  /// Parse a fixed width, little-endian, 64-bit integer.
+  LogicalResult parseFixed64(uint64_t &value) {
+    ArrayRef<uint8_t> bytes;
+    if (failed(parseBytes(8, bytes)))
+      return failure();
+    value = llvm::support::endian::read64le(bytes.data());
+    return success();
+  }
+
+  /// Parse a section header and the contents of the section.
+  LogicalResult parseSection(bytecode::Section::ID &sectionID,
+                             ArrayRef<uint8_t> &sectionData) {
+    uint8_t id;
+    uint64_t length;
+    if (failed(parseByte(id)) || failed(parseFixed64(length)))
+      return failure();
+    if (id >= bytecode::Section::kNumSections)
+      return emitError("invalid section ID: ") << unsigned(id);
+    sectionID = static_cast<bytecode::Section::ID>(id);
+    return parseBytes(static_cast<size_t>(length), sectionData);
+  }
+
+private:
+  const uint8_t *dataIt, *dataEnd;
+  Location fileLoc;
+};
+
+/// The values of a single numbering scope, i.e. the top-level operations or
+/// the regions of an IsolatedFromAbove operation. Values may be used before
+/// they are defined, in which case a placeholder is used until the definition
+/// is read.
+struct ValueScope {
+  ValueScope() = default;
+  ValueScope(const ValueScope &) = delete;
+  ~ValueScope() {
+    // Drop any placeholders left because of an error.
+    for (unsigned i = nextValueID, e = values.size(); i < e; ++i) {
+      if (Value placeholder = values[i]) {
+        placeholder.dropAllUses();
+        placeholder.getDefiningOp()->destroy();
+      }
+    }
+  }
+
+  /// The values of the scope, indexed by id. The entries at or past
+  /// `nextValueID` are placeholders.
+  std::vector<Value> values;
+  unsigned nextValueID = 0;
+};
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// BytecodeReader::Impl
+//===----------------------------------------------------------------------===//
+
+static bool isIsolatedScope(Operation *op) {
+  return op->getNumRegions() != 0 &&
+         op->hasTrait<OpTrait::IsIsolatedFromAbove>();
+}
+
+class BytecodeReader::Impl {
+public:
+  Impl(llvm::MemoryBufferRef buffer, MLIRContext *context, bool lazyLoading,
+       std::shared_ptr<llvm::MemoryBuffer> ownedBuffer = nullptr)
+      : buffer(buffer), context(context), lazyLoading(lazyLoading),
+        fileLoc(FileLineColLoc::get(context, buffer.getBufferIdentifier(),
+                                    /*line=*/0, /*column=*/0)),
+        ownedBuffer(std::move(ownedBuffer)) {}
+
+  LogicalResult read(Block *block);
+
+  bool isMaterializable(Operation *op) const { return lazyOps.count(op); }
+  unsigned getNumMaterializable() const { return lazyOps.size(); }
+  LogicalResult materialize(Operation *op);
+  LogicalResult materializeAll();
+
+private:
+  //===--------------------------------------------------------------------===//
+  // Sections
+
+  LogicalResult parseStringSection(ArrayRef<uint8_t> sectionData);
+  LogicalResult parseOpNameSection(ArrayRef<uint8_t> sectionData);
+  LogicalResult parseAttrTypeSection(ArrayRef<uint8_t> sectionData);
+  LogicalResult parseBlobSection(ArrayRef<uint8_t> sectionData);
+
+  //===--------------------------------------------------------------------===//
+  // Tables
+
+  LogicalResult parseString(EncodingReader &reader, StringRef &result);
+  FailureOr<OperationName> parseOpName(EncodingReader &reader);
+  LogicalResult parseAttribute(EncodingReader &reader, Attribute &result);
+  LogicalResult parseLocation(EncodingReader &reader, LocationAttr &result);
+  LogicalResult parseType(EncodingReader &reader, Type &result);
+
+  /// Resolve the attribute or type with the given index, reading its entry
+  /// if it hasn't been used before.
+  Attribute resolveAttribute(size_t index);
+  Type resolveType(size_t index);
+  Attribute parseAttrEntry(EncodingReader &reader, uint64_t kind);
+
+  /// Parse the payload of a DenseResourceElementsAttr entry.
+  Attribute parseDenseResourceEntry(EncodingReader &reader);
+
+  //===--------------------------------------------------------------------===//
+  // IR
+
+  LogicalResult parseOperation(EncodingReader &reader, Block *block,
+                               ArrayRef<Block *> regionBlocks,
+                               ValueScope &scope);
+  LogicalResult parseRegion(EncodingReader &reader, Region &region,
+                            ValueScope &scope);
+  LogicalResult parseBlock(EncodingReader &reader, Block *block,
+                           ArrayRef<Block *> regionBlocks, ValueScope &scope);
+
+  /// Parse the regions of an IsolatedFromAbove operation.
+  LogicalResult parseIsolatedRegions(ArrayRef<uint8_t> regionData,
+                                     Operation *op);
+
+  /// Define the next value of `scope`, resolving the uses of its placeholder.
+  void defineValue(ValueScope &scope, Value value);
+  LogicalResult parseOperand(EncodingReader &reader, ValueScope &scope,
+                             Value &result);
+
+  /// Verify that all of the placeholders of `scope` have been resolved.
+  LogicalResult finalizeScope(ValueScope &scope);
+
+  /// The buffer being read and the context to read it into.
+  llvm::MemoryBufferRef buffer;
+  MLIRContext *context;
+
+  /// If true, the regions of IsolatedFromAbove operations are read on demand.
+  bool lazyLoading;
+
+  /// The location used for errors.
+  Location fileLoc;
+
+  /// The shared buffer being read, if any. Resource blobs reference their data
+  /// in this buffer instead of copying it.
+  std::shared_ptr<llvm::MemoryBuffer> ownedBuffer;
+
+  /// The tables of the bytecode.
+  std::vector<StringRef> strings;
+  std::vector<StringRef> opNameStrings;
+  std::vector<Optional<OperationName>> opNames;
+  struct AttrEntry {
+    Attribute attr;
+    ArrayRef<uint8_t> data;
+  };
+  std::vector<AttrEntry> attrs;
+  std::vector<std::pair<Type, StringRef>> types;
+  std::vector<ArrayRef<uint8_t>> blobs;
+
+  /// The encoded regions of the operations that have not been materialized,
+  /// and the order in which these operations were read.
+  DenseMap<Operation *, ArrayRef<uint8_t>> lazyOps;
+  std::vector<Operation *> lazyOpOrder;
+};
+
+LogicalResult BytecodeReader::Impl::read(Block *block) {
+  EncodingReader reader(llvm::arrayRefFromStringRef(buffer.getBuffer()),
+                        fileLoc);
+
+  // Parse the header.
+  ArrayRef<uint8_t> magic;
+  if (failed(reader.parseBytes(4, magic)))
+    return failure();
+  if (std::memcmp(magic.data(), bytecode::kMagic, 4) != 0)
+    return reader.emitError("input buffer is not an MLIR bytecode file");
+
+  uint64_t version, producerLength;
+  ArrayRef<uint8_t> producer;
+  if (failed(reader.parseVarInt(version)))
+    return failure();
+  if (version != bytecode::kVersion) {
+    return reader.emitError("bytecode version ")
+           << version << " is not supported, expected version "
+           << unsigned(bytecode::kVersion);
+  }
+  if (failed(reader.parseVarInt(producerLength)) ||
+      failed(reader.parseBytes(producerLength, producer)))
+    return failure();
+
+  // Collect the sections.
+  Optional<ArrayRef<uint8_t>> sectionDatas[bytecode::Section::kNumSections];
+  while (!reader.empty()) {
+    bytecode::Section::ID sectionID;
+    ArrayRef<uint8_t> sectionData;
+    if (failed(reader.parseSection(sectionID, sectionData)))
+      return failure();
+    if (sectionDatas[sectionID]) {
+      return reader.emitError("duplicate top-level section: ")
+             << unsigned(sectionID);
+    }
+    sectionDatas[sectionID] = sectionData;
+  }
+  for (unsigned i = 0; i < bytecode::Section::kNumSections; ++i) {
+    if (!sectionDatas[i] && i != bytecode::Section::kBlob)
+      return reader.emitError("missing data for top-level section: ") << i;
+  }
+
+  if (failed(parseStringSection(*sectionDatas[bytecode::Section::kString])) ||
+      failed(parseOpNameSection(*sectionDatas[bytecode::Section::kOpName])) ||
+      failed(
+          parseAttrTypeSection(*sectionDatas[bytecode::Section::kAttrType])))
+    return failure();
+  if (sectionDatas[bytecode::Section::kBlob] &&
+      failed(parseBlobSection(*sectionDatas[bytecode::Section::kBlob])))
+    return failure();
+
+  // Parse the top-level operations.
+  EncodingReader irReader(*sectionDatas[bytecode::Section::kIR], fileLoc);
+  ValueScope scope;
+  uint64_t numOps;
+  if (failed(irReader.parseVarInt(numOps)))
+    return failure();
+  for (uint64_t i = 0; i < numOps; ++i)
+    if (failed(parseOperation(irReader, block, /*regionBlocks=*/{}, scope)))
+      return failure();
+  if (!irReader.empty())
+    return irReader.emitError("unexpected trailing data in the IR section");
+  return finalizeScope(scope);
+}
+
+LogicalResult BytecodeReader::Impl::materialize(Operation *op) {
+  auto it = lazyOps.find(op);
+  if (it == lazyOps.end())
+    return ::emitError(op->getLoc(), "operation is not materializable");
+  ArrayRef<uint8_t> regionData = it->second;
+  lazyOps.erase(it);
+  return parseIsolatedRegions(regionData, op);
+}
+
+LogicalResult BytecodeReader::Impl::materializeAll() {
+  // Materialize in the order the operations were read, so that diagnostics
+  // and dialect loading are deterministic. Materializing appends the newly
+  // exposed operations to the list.
+  for (size_t i = 0; i < lazyOpOrder.size(); ++i) {
+    Operation *op = lazyOpOrder[i];
+    if (isMaterializable(op) && failed(materialize(op)))
+      return failure();
+  }
+  lazyOpOrder.clear();
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Sections
+
+LogicalResult
+BytecodeReader::Impl::parseStringSection(ArrayRef<uint8_t> sectionData) {
+  EncodingReader reader(sectionData, fileLoc);
+  uint64_t numStrings;
+  if (failed(reader.parseVarInt(numStrings)))
+    return failure();
+  if (numStrings > reader.size())
+    return reader.emitError("invalid number of strings: ") << numStrings;
+
+  SmallVector<uint64_t> lengths(numStrings);
+  for (uint64_t &length : lengths)
+    if (failed(reader.parseVarInt(length)))
+      return failure();
+
+  // The strings refer directly to the data of the buffer.
+  strings.reserve(numStrings);
+  for (uint64_t length : lengths) {
+    ArrayRef<uint8_t> data;
+    if (failed(reader.parseBytes(length, data)))
+      return failure();
+    strings.push_back(llvm::toStringRef(data));
+  }
+  if (!reader.empty())
+    return reader.emitError("unexpected trailing data in the string section");
+  return success();
+}
+
+LogicalResult
+BytecodeReader::Impl::parseOpNameSection(ArrayRef<uint8_t> sectionData) {
+  EncodingReader reader(sectionData, fileLoc);
+  uint64_t numOpNames;
+  if (failed(reader.parseVarInt(numOpNames)))
+    return failure();
+  if (numOpNames > reader.size())
+    return reader.emitError("invalid number of operation names: ")
+           << numOpNames;
+
+  // The names are only turned into OperationNames when they are used, which
+  // avoids loading dialects that are not needed when loading lazily.
+  opNameStrings.resize(numOpNames);
+  opNames.resize(numOpNames);
+  for (StringRef &name : opNameStrings)
+    if (failed(parseString(reader, name)))
+      return failure();
+  if (!reader.empty())
+    return reader.emitError("unexpected trailing data in the op name section");
+  return success();
+}
+
+LogicalResult
+BytecodeReader::Impl::parseAttrTypeSection(ArrayRef<uint8_t> sectionData) {
+  EncodingReader reader(sectionData, fileLoc);
+  uint64_t numAttrs, numTypes;
+  if (failed(reader.parseVarInt(numAttrs)) ||
+      failed(reader.parseVarInt(numTypes)))
+    return failure();
+  if (numAttrs > reader.size() || numTypes > reader.size())
+    return reader.emitError("invalid number of attributes or types");
+
+  // Only record the entries here, they are resolved when they are used.
+  attrs.resize(numAttrs);
+  for (AttrEntry &entry : attrs) {
+    uint64_t length;
+    if (failed(reader.parseVarInt(length)) ||
+        failed(reader.parseBytes(length, entry.data)))
+      return failure();
+  }
+  types.resize(numTypes);
+  for (auto &entry : types)
+    if (failed(parseString(reader, entry.second)))
+      return failure();
+  if (!reader.empty())
+    return reader.emitError("unexpected trailing data in the attr section");
+  return success();
+}
+
+LogicalResult
+BytecodeReader::Impl::parseBlobSection(ArrayRef<uint8_t> sectionData) {
+  EncodingReader reader(sectionData, fileLoc);
+  uint64_t numBlobs;
+  if (failed(reader.parseFixed64(numBlobs)))
+    return failure();
+  if (numBlobs > reader.size() / 16)
+    return reader.emitError("invalid number of blobs: ") << numBlobs;
+
+  // The blob offsets are relative to the start of the file, but must lie
+  // within the section.
+  const uint8_t *bufferStart =
+      reinterpret_cast<const uint8_t *>(buffer.getBufferStart());
+  uint64_t sectionStart = sectionData.begin() - bufferStart;
+  uint64_t sectionEnd = sectionData.end() - bufferStart;
+  blobs.reserve(numBlobs);
+  for (uint64_t i = 0; i < numBlobs; ++i) {
+    uint64_t offset, size;
+    if (failed(reader.parseFixed64(offset)) ||
+        failed(reader.parseFixed64(size)))
+      return failure();
+    if (offset < sectionStart || offset > sectionEnd ||
+        size > sectionEnd - offset)
+      return reader.emitError("invalid blob range for blob ") << i;
+    blobs.emplace_back(bufferStart + offset, size);
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Tables
+
+LogicalResult BytecodeReader::Impl::parseString(EncodingReader &reader,
+                                                StringRef &result) {
+  uint64_t index;
+  if (failed(reader.parseIndex(strings.size(), index, "string")))
+    return failure();
+  result = strings[index];
+  return success();
+}
+
+FailureOr<OperationName>
+BytecodeReader::Impl::parseOpName(EncodingReader &reader) {
+  uint64_t index;
+  if (failed(reader.parseIndex(opNames.size(), index, "operation name")))
+    return failure();
+  if (opNames[index])
+    return *opNames[index];
+
+  // Load the dialect of the operation if it is available, as the text parser
+  // does.
+  StringRef name = opNameStrings[index];
+  StringRef dialectName = name.split('.').first;
+  if (!context->getLoadedDialect(dialectName) &&
+      !context->getOrLoadDialect(dialectName) &&
+      !context->allowsUnregisteredDialects()) {
+    reader.emitError("operation '")
+        << name
+        << "' has an unregistered dialect. If this is intended, please "
+           "use -allow-unregistered-dialect with the MLIR tool used";
+    return failure();
+  }
+  opNames[index] = OperationName(name, context);
+  return *opNames[index];
+}
+
+LogicalResult BytecodeReader::Impl::parseAttribute(EncodingReader &reader,
+                                                   Attribute &result) {
+  uint64_t index;
+  if (failed(reader.parseIndex(attrs.size(), index, "attribute")))
+    return failure();
+  result = resolveAttribute(index);
+  return success(static_cast<bool>(result));
+}
+
+LogicalResult BytecodeReader::Impl::parseLocation(EncodingReader &reader,
+                                                  LocationAttr &result) {
+  Attribute attr;
+  if (failed(parseAttribute(reader, attr)))
+    return failure();
+  result = attr.dyn_cast<LocationAttr>();
+  if (!result)
+    return reader.emitError("expected a location, but got: ") << attr;
+  return success();
+}
+
+LogicalResult BytecodeReader::Impl::parseType(EncodingReader &reader,
+                                              Type &result) {
+  uint64_t index;
+  if (failed(reader.parseIndex(types.size(), index, "type")))
+    return failure();
+  result = resolveType(index);
+  return success(static_cast<bool>(result));
+}
+
+Attribute BytecodeReader::Impl::resolveAttribute(size_t index) {
+  AttrEntry &entry = attrs[index];
+  if (entry.attr)
+    return entry.attr;
+  EncodingReader reader(entry.data, fileLoc);
+  uint64_t kind;
+  if (failed(reader.parseVarInt(kind)))
+    return nullptr;
+  entry.attr = parseAttrEntry(reader, kind);
+  if (entry.attr && !reader.empty()) {
+    reader.emitError("unexpected trailing data in attribute entry ") << index;
+    entry.attr = nullptr;
+  }
+  return entry.attr;
+}
+
+Type BytecodeReader::Impl::resolveType(size_t index) {
+  auto &entry = types[index];
+  // The parser expects null terminated input, which the string table does not
+  // provide.
+  if (!entry.first)
+    entry.first = mlir::parseType(entry.second.str(), context);
+  return entry.first;
+}
+
+Attribute BytecodeReader::Impl::parseAttrEntry(EncodingReader &reader,
+                                               uint64_t kind) {
+  switch (kind) {
+  case bytecode::AttrKind::kText: {
+    StringRef str;
+    if (failed(parseString(reader, str)))
+      return nullptr;
+    return mlir::parseAttribute(str.str(), context);
+  }
+  case bytecode::AttrKind::kDenseElements: {
+    Type type;
+    uint64_t blobIndex;
+    uint8_t isSplat;
+    if (failed(parseType(reader, type)) ||
+        failed(reader.parseIndex(blobs.size(), blobIndex, "blob")) ||
+        failed(reader.parseByte(isSplat)))
+      return nullptr;
+    auto shapedType = type.dyn_cast<ShapedType>();
+    ArrayRef<char> rawData(
+        reinterpret_cast<const char *>(blobs[blobIndex].data()),
+        blobs[blobIndex].size());
+    bool detectedSplat;
+    if (!shapedType ||
+        !DenseElementsAttr::isValidRawBuffer(shapedType, rawData,
+                                             detectedSplat) ||
+        detectedSplat != bool(isSplat)) {
+      reader.emitError("invalid dense elements data for type ") << type;
+      return nullptr;
+    }
+    return DenseElementsAttr::getFromRawBuffer(shapedType, rawData, isSplat);
+  }
+  case bytecode::AttrKind::kDenseResource:
+    return parseDenseResourceEntry(reader);
+  case bytecode::AttrKind::kUnknownLoc:
+    return UnknownLoc::get(context);
+  case bytecode::AttrKind::kFileLineColLoc: {
+    StringRef filename;
+    uint64_t line, column;
+    if (failed(parseString(reader, filename)) ||
+        failed(reader.parseVarInt(line)) || failed(reader.parseVarInt(column)))
+      return nullptr;
+    return FileLineColLoc::get(context, filename, line, column);
+  }
+  case bytecode::AttrKind::kNameLoc: {
+    StringRef name;
+    LocationAttr childLoc;
+    if (failed(parseString(reader, name)) ||
+        failed(parseLocation(reader, childLoc)))
+      return nullptr;
+    return NameLoc::get(StringAttr::get(context, name), childLoc);
+  }
+  case bytecode::AttrKind::kCallSiteLoc: {
+    LocationAttr callee, caller;
+    if (failed(parseLocation(reader, callee)) ||
+        failed(parseLocation(reader, caller)))
+      return nullptr;
+    return CallSiteLoc::get(callee, caller);
+  }
+  case bytecode::AttrKind::kFusedLoc: {
+    uint64_t metadataIndex, numLocations;
+    if (failed(reader.parseIndex(attrs.size() + 1, metadataIndex,
+                                 "attribute")) ||
+        failed(reader.parseVarInt(numLocations)))
+      return nullptr;
+    Attribute metadata;
+    if (metadataIndex && !(metadata = resolveAttribute(metadataIndex - 1)))
+      return nullptr;
+    if (numLocations > reader.size()) {
+      reader.emitError("invalid number of fused locations: ") << numLocations;
+      return nullptr;
+    }
+    SmallVector<Location> locations;
+    for (uint64_t i = 0; i < numLocations; ++i) {
+      LocationAttr loc;
+      if (failed(parseLocation(reader, loc)))
+        return nullptr;
+      locations.push_back(loc);
+    }
+    return FusedLoc::get(locations, metadata, context);
+  }
+  default:
+    reader.emitError("unknown attribute encoding: ") << kind;
+    return nullptr;
+  }
+}
+
+Attribute
+BytecodeReader::Impl::parseDenseResourceEntry(EncodingReader &reader) {
+  Type type;
+  StringRef key;
+  uint64_t blobIndex;
+  if (failed(parseType(reader, type)) || failed(parseString(reader, key)) ||
+      failed(reader.parseIndex(blobs.size() + 1, blobIndex, "blob")))
+    return nullptr;
+  auto shapedType = type.dyn_cast<ShapedType>();
+  if (!shapedType) {
+    reader.emitError("invalid dense resource type ") << type;
+    return nullptr;
+  }
+
+  // Resources without data refer to the entry of the context with the same
+  // key, which may be provided by the user.
+  ResourceBlobManager &manager = context->getResourceBlobManager();
+  if (blobIndex == 0) {
+    return DenseResourceElementsAttr::getChecked(
+        [&] { return reader.emitError(); }, shapedType,
+        &manager.getOrInsert(key));
+  }
+
+  // Otherwise, reference the data in place when the buffer can be kept alive
+  // and the data is suitably aligned in memory, and copy it if not.
+  ArrayRef<uint8_t> blobData = blobs[blobIndex - 1];
+  ArrayRef<char> data(reinterpret_cast<const char *>(blobData.data()),
+                      blobData.size());
+  ResourceBlob blob;
+  if (ownedBuffer &&
+      llvm::isAddrAligned(llvm::Align(bytecode::kBlobAlignment), data.data()))
+    blob = ResourceBlob::createFromBuffer(ownedBuffer, data,
+                                          bytecode::kBlobAlignment);
+  else
+    blob = ResourceBlob::allocateAndCopy(data, bytecode::kBlobAlignment);
+
+  // Fill in the entry with the same key if it has no data yet, and create a
+  // new uniquely named entry otherwise.
+  ResourceBlobManager::BlobEntry *entry = &manager.getOrInsert(key);
+  if (entry->getBlob())
+    entry = &manager.insert(key, std::move(blob));
+  else
+    entry->setBlob(std::move(blob));
+  return DenseResourceElementsAttr::getChecked(
+      [&] { return reader.emitError(); }, shapedType, entry);
+}
+
+//===----------------------------------------------------------------------===//
+// IR
+
+LogicalResult BytecodeReader::Impl::parseOperation(
+    EncodingReader &reader, Block *block, ArrayRef<Block *> regionBlocks,
+    ValueScope &scope) {
+  FailureOr<OperationName> name = parseOpName(reader);
+  LocationAttr loc;
+  uint8_t opEncodingMask;
+  if (failed(name) || failed(parseLocation(reader, loc)) ||
+      failed(reader.parseByte(opEncodingMask)))
+    return failure();
+
+  uint64_t count;
+  NamedAttrList attributes;
+  if (opEncodingMask & bytecode::OpEncodingMask::kHasAttrs) {
+    if (failed(reader.parseVarInt(count)))
+      return failure();
+    for (uint64_t i = 0; i < count; ++i) {
+      StringRef attrName;
+      Attribute attr;
+      if (failed(parseString(reader, attrName)) ||
+          failed(parseAttribute(reader, attr)))
+        return failure();
+      attributes.append(StringAttr::get(context, attrName), attr);
+    }
+  }
+
+  SmallVector<Type> resultTypes;
+  if (opEncodingMask & bytecode::OpEncodingMask::kHasResults) {
+    if (failed(reader.parseVarInt(count)))
+      return failure();
+    resultTypes.resize(count);
+    for (Type &type : resultTypes)
+      if (failed(parseType(reader, type)))
+        return failure();
+  }
+
+  SmallVector<Value> operands;
+  if (opEncodingMask & bytecode::OpEncodingMask::kHasOperands) {
+    if (failed(reader.parseVarInt(count)))
+      return failure();
+    operands.resize(count);
+    for (Value &operand : operands)
+      if (failed(parseOperand(reader, scope, operand)))
+        return failure();
+  }
+
+  SmallVector<Block *> successors;
+  if (opEncodingMask & bytecode::OpEncodingMask::kHasSuccessors) {
+    if (failed(reader.parseVarInt(count)))
+      return failure();
+    for (uint64_t i = 0; i < count; ++i) {
+      uint64_t index;
+      if (failed(reader.parseIndex(regionBlocks.size(), index, "successor")))
+        return failure();
+      successors.push_back(regionBlocks[index]);
+    }
+  }
+
+  uint64_t numRegions = 0;
+  uint8_t isIsolated = 0;
+  if (opEncodingMask & bytecode::OpEncodingMask::kHasRegions) {
+    if (failed(reader.parseVarInt(numRegions)) ||
+        failed(reader.parseByte(isIsolated)))
+      return failure();
+  }
+
+  // The attributes were written in the order of the dictionary, which is
+  // sorted.
+  Operation *op = Operation::create(
+      loc, *name, resultTypes, operands,
+      DictionaryAttr::getWithSorted(context, attributes), successors,
+      numRegions);
+  block->push_back(op);
+  for (Value result : op->getResults())
+    defineValue(scope, result);
+  if (!numRegions)
+    return success();
+
+  if (!isIsolated) {
+    for (Region &region : op->getRegions())
+      if (failed(parseRegion(reader, region, scope)))
+        return failure();
+    return success();
+  }
+
+  uint64_t length;
+  ArrayRef<uint8_t> regionData;
+  if (failed(reader.parseVarInt(length)) ||
+      failed(reader.parseBytes(length, regionData)))
+    return failure();
+  if (!isIsolatedScope(op)) {
+    return ::emitError(loc)
+           << "'" << *name << "' has isolated regions in the bytecode, but "
+           << "is not IsolatedFromAbove";
+  }
+  if (lazyLoading) {
+    lazyOps.try_emplace(op, regionData);
+    lazyOpOrder.push_back(op);
+    return success();
+  }
+  return parseIsolatedRegions(regionData, op);
+}
+
+LogicalResult BytecodeReader::Impl::parseRegion(EncodingReader &reader,
+                                                Region &region,
+                                                ValueScope &scope) {
+  uint64_t numBlocks;
+  if (failed(reader.parseVarInt(numBlocks)))
+    return failure();
+  if (numBlocks > reader.size())
+    return reader.emitError("invalid number of blocks: ") << numBlocks;
+
+  // Create all of the blocks up front, so that successors can refer to them.
+  SmallVector<Block *> blocks;
+  for (uint64_t i = 0; i < numBlocks; ++i) {
+    blocks.push_back(new Block());
+    region.push_back(blocks.back());
+  }
+  for (Block *block : blocks)
+    if (failed(parseBlock(reader, block, blocks, scope)))
+      return failure();
+  return success();
+}
+
+LogicalResult BytecodeReader::Impl::parseBlock(EncodingReader &reader,
+                                               Block *block,
+                                               ArrayRef<Block *> regionBlocks,
+                                               ValueScope &scope) {
+  uint64_t numArgs;
+  if (failed(reader.parseVarInt(numArgs)))
+    return failure();
+  for (uint64_t i = 0; i < numArgs; ++i) {
+    Type type;
+    LocationAttr loc;
+    if (failed(parseType(reader, type)) || failed(parseLocation(reader, loc)))
+      return failure();
+    defineValue(scope, block->addArgument(type, loc));
+  }
+
+  uint64_t numOps;
+  if (failed(reader.parseVarInt(numOps)))
+    return failure();
+  for (uint64_t i = 0; i < numOps; ++i)
+    if (failed(parseOperation(reader, block, regionBlocks, scope)))
+      return failure();
+  return success();
+}
+
+LogicalResult
+BytecodeReader::Impl::parseIsolatedRegions(ArrayRef<uint8_t> regionData,
+                                           Operation *op) {
+  EncodingReader reader(regionData, fileLoc);
+  ValueScope scope;
+  for (Region &region : op->getRegions())
+    if (failed(parseRegion(reader, region, scope)))
+      return failure();
+  if (!reader.empty())
+    return reader.emitError("unexpected trailing data in isolated regions");
+  return finalizeScope(scope);
+}
+
+void BytecodeReader::Impl::defineValue(ValueScope &scope, Value value) {
+  unsigned id = scope.nextValueID++;
+  if (id >= scope.values.size()) {
+    scope.values.resize(id + 1);
+  } else if (Value placeholder = scope.values[id]) {
+    Operation *placeholderOp = placeholder.getDefiningOp();
+    placeholder.replaceAllUsesWith(value);
+    placeholderOp->destroy();
+  }
+  scope.values[id] = value;
+}
+
+LogicalResult BytecodeReader::Impl::parseOperand(EncodingReader &reader,
+                                                 ValueScope &scope,
+                                                 Value &result) {
+  uint64_t id;
+  if (failed(reader.parseVarInt(id)))
+    return failure();
+  if (id < scope.nextValueID) {
+    result = scope.values[id];
+    return success();
+  }
+
+  // This is a forward reference. Forward references are created as
+  // operations, because we just need something with a def/use chain.
+  if (id > reader.size() + scope.values.size())
+    return reader.emitError("invalid value index: ") << id;
+  if (id >= scope.values.size())
+    scope.values.resize(id + 1);
+  Value &value = scope.values[id];
+  if (!value) {
+    OperationName castName("builtin.unrealized_conversion_cast", context);
+    value = Operation::create(fileLoc, castName, NoneType::get(context),
+                              /*operands=*/{}, /*attributes=*/llvm::None,
+                              /*successors=*/{}, /*numRegions=*/0)
+                ->getResult(0);
+  }
+  result = value;
+  return success();
+}
+
+LogicalResult BytecodeReader::Impl::finalizeScope(ValueScope &scope) {
+  for (unsigned i = scope.nextValueID, e = scope.values.size(); i < e; ++i)
+    if (scope.values[i])
+      return ::emitError(fileLoc, "use of undefined value ") << i;
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// BytecodeReader
+//===----------------------------------------------------------------------===//
+
+BytecodeReader::BytecodeReader(llvm::MemoryBufferRef buffer,
+                               MLIRContext *context, bool lazyLoading)
+    : impl(std::make_unique<Impl>(buffer, context, lazyLoading)) {}
+
+BytecodeReader::BytecodeReader(std::shared_ptr<llvm::MemoryBuffer> buffer,
+                               MLIRContext *context, bool lazyLoading)
+    : impl(std::make_unique<Impl>(buffer->getMemBufferRef(), context,
+                                  lazyLoading, buffer)) {}
+
+BytecodeReader::~BytecodeReader() = default;
+
+LogicalResult BytecodeReader::read(Block *block) { return impl->read(block); }
+
+bool BytecodeReader::isMaterializable(Operation *op) const {
+  return impl->isMaterializable(op);
+}
+
+unsigned BytecodeReader::getNumMaterializable() const {
+  return impl->getNumMaterializable();
+}
+
+LogicalResult BytecodeReader::materialize(Operation *op) {
+  return impl->materialize(op);
+}
+
+LogicalResult BytecodeReader::materializeAll() {
+  return impl->materializeAll();
+}
+
+//===----------------------------------------------------------------------===//
+// Entry Points
+//===----------------------------------------------------------------------===//
+
+bool mlir::isBytecode(llvm::MemoryBufferRef buffer) {
+  return buffer.getBuffer().startswith(
+      StringRef(bytecode::kMagic, sizeof(bytecode::kMagic)));
+}
+
+LogicalResult mlir::readBytecodeFile(llvm::MemoryBufferRef buffer,
+                                     Block *block, MLIRContext *context) {
+  return BytecodeReader(buffer, context).read(block);
+}
+
+LogicalResult
+mlir::readBytecodeFile(const std::shared_ptr<llvm::MemoryBuffer> &buffer,
+                       Block *block, MLIRContext *context) {
+  return BytecodeReader(buffer, context).read(block);
+}
@@ -0,0 +1,478 @@
+//===- BytecodeWriter.cpp - MLIR Bytecode Writer --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Bytecode/BytecodeWriter.h"
+#include "../Encoding.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Operation.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+#include <vector>
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// EncodingEmitter
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class emits the primitive encodings of the bytecode into a byte
+/// buffer.
+class EncodingEmitter {
+public:
+  /// Returns the bytes emitted so far.
+  ArrayRef<uint8_t> getBytes() const { return buffer; }
+  size_t size() const { return buffer.size(); }
+
+  /// Write the current contents to the provided stream.
+  void writeTo(raw_ostream &os) const {
+    os.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+  }
+
+  void emitByte(uint8_t byte) { buffer.push_back(byte); }
+
+  void emitBytes(ArrayRef<uint8_t> bytes) {
+    buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+  }
+
+  /// Emit zero bytes until the size is a multiple of `alignment`.
+  void alignTo(uint64_t alignment) {
+    buffer.resize(llvm::alignTo(buffer.size(), alignment), 0);
+  }
+
+  /// Emit a variable width integer.
+  void emitVarInt(uint64_t value) {
+    uint8_t bytes[16];
+    unsigned numBytes = llvm::encodeULEB128(value, bytes);
+    emitBytes(llvm::makeArrayRef(bytes, numBytes));
+  }
+
+  /// Emit a fixed width, little-endian, 64-bit integer.
+  void emitFixed64(uint64_t value) {
+    uint8_t bytes[8];
+    llvm::support::endian::write64le(bytes, value);
+    emitBytes(bytes);
+  }
+
+  /// Emit the given section with its id and length.
+  void emitSection(bytecode::Section::ID id, const EncodingEmitter &section) {
+    emitByte(id);
+    emitFixed64(section.size());
+    emitBytes(section.buffer);
+  }
+
+private:
+  std::vector<uint8_t> buffer;
+};
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// BytecodeWriter
+//===----------------------------------------------------------------------===//
+
+/// Returns true if the regions of `op` form their own value numbering scope,
+/// which also allows the reader to load them lazily.
+static bool isIsolatedScope(Operation *op) {
+  return op->getNumRegions() != 0 &&
+         op->hasTrait<OpTrait::IsIsolatedFromAbove>();
+}
+
+namespace {
+class BytecodeWriter {
+public:
+  void write(Operation *rootOp, raw_ostream &os, StringRef producer);
+
+private:
+  //===--------------------------------------------------------------------===//
+  // Numbering
+
+  /// Assign ids to the results of `op`, and to the values defined in its
+  /// regions if they are not a scope of their own. The reader defines values
+  /// in the same order.
+  void numberValues(Operation *op, unsigned &nextValueID);
+  void numberValues(Region &region, unsigned &nextValueID);
+
+  //===--------------------------------------------------------------------===//
+  // IR
+
+  void writeOperation(EncodingEmitter &emitter, Operation *op);
+  void writeRegion(EncodingEmitter &emitter, Region &region);
+  void writeBlock(EncodingEmitter &emitter, Block &block);
+
+  //===--------------------------------------------------------------------===//
+  // Tables
+
+  unsigned getStringID(StringRef str);
+  unsigned getOpNameID(OperationName name);
+  unsigned getAttrID(Attribute attr);
+  unsigned getTypeID(Type type);
+
+  /// Encode the attribute table entry for `attr`.
+  void writeAttrEntry(EncodingEmitter &emitter, Attribute attr);
+
+  void writeStringSection(EncodingEmitter &emitter);
+  void writeOpNameSection(EncodingEmitter &emitter);
+  void writeAttrTypeSection(EncodingEmitter &emitter);
+  void writeBlobSection(EncodingEmitter &emitter);
+
+  /// The uniqued strings, in the order of their ids. The strings are owned by
+  /// the keys of `stringIDs`.
+  llvm::StringMap<unsigned> stringIDs;
+  std::vector<StringRef> strings;
+
+  /// The string id of every uniqued operation name.
+  llvm::DenseMap<const void *, unsigned> opNameIDs;
+  std::vector<unsigned> opNames;
+
+  /// The uniqued attributes and types, along with the encoding of the
+  /// attribute entries.
+  llvm::DenseMap<Attribute, unsigned> attrIDs;
+  std::vector<EncodingEmitter> attrEntries;
+  llvm::DenseMap<Type, unsigned> typeIDs;
+  std::vector<unsigned> types;
+
+  /// The raw data stored in the blob section.
+  std::vector<ArrayRef<char>> blobs;
+
+  /// The ids of the values within their numbering scope, and of the blocks
+  /// within their region.
+  llvm::DenseMap<Value, unsigned> valueIDs;
+  llvm::DenseMap<Block *, unsigned> blockIDs;
+};
+} // namespace
+
+void BytecodeWriter::write(Operation *rootOp, raw_ostream &os,
+                           StringRef producer) {
+  // Encode the IR first, which populates the tables referenced by it.
+  EncodingEmitter irEmitter;
+  unsigned nextValueID = 0;
+  numberValues(rootOp, nextValueID);
+  irEmitter.emitVarInt(/*numOps=*/1);
+  writeOperation(irEmitter, rootOp);
+
+  EncodingEmitter stringEmitter, opNameEmitter, attrTypeEmitter;
+  writeStringSection(stringEmitter);
+  writeOpNameSection(opNameEmitter);
+  writeAttrTypeSection(attrTypeEmitter);
+
+  EncodingEmitter emitter;
+  emitter.emitBytes(llvm::makeArrayRef(
+      reinterpret_cast<const uint8_t *>(bytecode::kMagic), 4));
+  emitter.emitVarInt(bytecode::kVersion);
+  emitter.emitVarInt(producer.size());
+  emitter.emitBytes(llvm::arrayRefFromStringRef(producer));
+  emitter.emitSection(bytecode::Section::kString, stringEmitter);
+  emitter.emitSection(bytecode::Section::kOpName, opNameEmitter);
+  emitter.emitSection(bytecode::Section::kAttrType, attrTypeEmitter);
+  emitter.emitSection(bytecode::Section::kIR, irEmitter);
+
+  // The blob section goes last, as its data is aligned relative to the start
+  // of the file.
+  writeBlobSection(emitter);
+  emitter.writeTo(os);
+}
+
+void BytecodeWriter::numberValues(Operation *op, unsigned &nextValueID) {
+  for (Value result : op->getResults())
+    valueIDs[result] = nextValueID++;
+
+  // Isolated regions are numbered when they are written.
+  if (isIsolatedScope(op))
+    return;
+  for (Region &region : op->getRegions())
+    numberValues(region, nextValueID);
+}
+
+void BytecodeWriter::numberValues(Region &region, unsigned &nextValueID) {
+  for (Block &block : region) {
+    for (BlockArgument arg : block.getArguments())
+      valueIDs[arg] = nextValueID++;
+    for (Operation &op : block)
+      numberValues(&op, nextValueID);
+  }
+}
+
+void BytecodeWriter::writeOperation(EncodingEmitter &emitter, Operation *op) {
+  emitter.emitVarInt(getOpNameID(op->getName()));
+  emitter.emitVarInt(getAttrID(LocationAttr(op->getLoc())));
+
+  uint8_t opEncodingMask = 0;
+  ArrayRef<NamedAttribute> attrs = op->getAttrs();
+  if (!attrs.empty())
+    opEncodingMask |= bytecode::OpEncodingMask::kHasAttrs;
+  if (op->getNumResults())
+    opEncodingMask |= bytecode::OpEncodingMask::kHasResults;
+  if (op->getNumOperands())
+    opEncodingMask |= bytecode::OpEncodingMask::kHasOperands;
+  if (op->getNumSuccessors())
+    opEncodingMask |= bytecode::OpEncodingMask::kHasSuccessors;
+  if (op->getNumRegions())
+    opEncodingMask |= bytecode::OpEncodingMask::kHasRegions;
+  emitter.emitByte(opEncodingMask);
+
+  // The attributes are stored individually, so that large elements attributes
+  // nested in the dictionary still end up in the blob section.
+  if (!attrs.empty()) {
+    emitter.emitVarInt(attrs.size());
+    for (const NamedAttribute &attr : attrs) {
+      emitter.emitVarInt(getStringID(attr.getName().getValue()));
+      emitter.emitVarInt(getAttrID(attr.getValue()));
+    }
+  }
+  if (op->getNumResults()) {
+    emitter.emitVarInt(op->getNumResults());
+    for (Type type : op->getResultTypes())
+      emitter.emitVarInt(getTypeID(type));
+  }
+  if (op->getNumOperands()) {
+    emitter.emitVarInt(op->getNumOperands());
+    for (Value operand : op->getOperands())
+      emitter.emitVarInt(valueIDs.lookup(operand));
+  }
+  if (op->getNumSuccessors()) {
+    emitter.emitVarInt(op->getNumSuccessors());
+    for (Block *successor : op->getSuccessors())
+      emitter.emitVarInt(blockIDs.lookup(successor));
+  }
+  if (!op->getNumRegions())
+    return;
+
+  emitter.emitVarInt(op->getNumRegions());
+  if (!isIsolatedScope(op)) {
+    emitter.emitByte(0);
+    for (Region &region : op->getRegions())
+      writeRegion(emitter, region);
+    return;
+  }
+
+  // The regions of an isolated operation start a new numbering scope, and are
+  // prefixed with their size so that the reader can skip them.
+  unsigned nextValueID = 0;
+  for (Region &region : op->getRegions())
+    numberValues(region, nextValueID);
+  EncodingEmitter regionEmitter;
+  for (Region &region : op->getRegions())
+    writeRegion(regionEmitter, region);
+  emitter.emitByte(1);
+  emitter.emitVarInt(regionEmitter.size());
+  emitter.emitBytes(regionEmitter.getBytes());
+}
+
+void BytecodeWriter::writeRegion(EncodingEmitter &emitter, Region &region) {
+  unsigned numBlocks = 0;
+  for (Block &block : region)
+    blockIDs[&block] = numBlocks++;
+
+  emitter.emitVarInt(numBlocks);
+  for (Block &block : region)
+    writeBlock(emitter, block);
+}
+
+void BytecodeWriter::writeBlock(EncodingEmitter &emitter, Block &block) {
+  emitter.emitVarInt(block.getNumArguments());
+  for (BlockArgument arg : block.getArguments()) {
+    emitter.emitVarInt(getTypeID(arg.getType()));
+    emitter.emitVarInt(getAttrID(LocationAttr(arg.getLoc())));
+  }
+
+  emitter.emitVarInt(block.getOperations().size());
+  for (Operation &op : block)
+    writeOperation(emitter, &op);
+}
+
+//===----------------------------------------------------------------------===//
+// Tables
+
+unsigned BytecodeWriter::getStringID(StringRef str) {
+  auto it = stringIDs.try_emplace(str, strings.size());
+  if (it.second)
+    strings.push_back(it.first->getKey());
+  return it.first->second;
+}
+
+unsigned BytecodeWriter::getOpNameID(OperationName name) {
+  auto it = opNameIDs.try_emplace(name.getAsOpaquePointer(), opNames.size());
+  if (it.second)
+    opNames.push_back(getStringID(name.getStringRef()));
+  return it.first->second;
+}
+
+unsigned BytecodeWriter::getAttrID(Attribute attr) {
+  auto it = attrIDs.find(attr);
+  if (it != attrIDs.end())
+    return it->second;
+
+  // Encode the entry before assigning the id, as the entry may reference
+  // other attributes.
+  EncodingEmitter entry;
+  writeAttrEntry(entry, attr);
+  unsigned id = attrEntries.size();
+  attrIDs.try_emplace(attr, id);
+  attrEntries.push_back(std::move(entry));
+  return id;
+}
+
+unsigned BytecodeWriter::getTypeID(Type type) {
+  auto it = typeIDs.try_emplace(type, types.size());
+  if (!it.second)
+    return it.first->second;
+
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  type.print(os);
+  unsigned stringID = getStringID(os.str());
+  types.push_back(stringID);
+  return it.first->second;
+}
+
+void BytecodeWriter::writeAttrEntry(EncodingEmitter &emitter, Attribute attr) {
+  // Locations make up a large part of most IR, so they are encoded
+  // structurally. The textual form would also depend on the printing flags.
+  if (attr.isa<UnknownLoc>()) {
+    emitter.emitVarInt(bytecode::AttrKind::kUnknownLoc);
+    return;
+  }
+  if (auto loc = attr.dyn_cast<FileLineColLoc>()) {
+    emitter.emitVarInt(bytecode::AttrKind::kFileLineColLoc);
+    emitter.emitVarInt(getStringID(loc.getFilename().getValue()));
+    emitter.emitVarInt(loc.getLine());
+    emitter.emitVarInt(loc.getColumn());
+    return;
+  }
+  if (auto loc = attr.dyn_cast<NameLoc>()) {
+    unsigned childLoc = getAttrID(LocationAttr(loc.getChildLoc()));
+    emitter.emitVarInt(bytecode::AttrKind::kNameLoc);
+    emitter.emitVarInt(getStringID(loc.getName().getValue()));
+    emitter.emitVarInt(childLoc);
+    return;
+  }
+  if (auto loc = attr.dyn_cast<CallSiteLoc>()) {
+    unsigned callee = getAttrID(LocationAttr(loc.getCallee()));
+    unsigned caller = getAttrID(LocationAttr(loc.getCaller()));
+    emitter.emitVarInt(bytecode::AttrKind::kCallSiteLoc);
+    emitter.emitVarInt(callee);
+    emitter.emitVarInt(caller);
+    return;
+  }
+  if (auto loc = attr.dyn_cast<FusedLoc>()) {
+    unsigned metadata =
+        loc.getMetadata() ? getAttrID(loc.getMetadata()) + 1 : 0;
+    SmallVector<unsigned, 4> locations;
+    for (Location fusedLoc : loc.getLocations())
+      locations.push_back(getAttrID(LocationAttr(fusedLoc)));
+    emitter.emitVarInt(bytecode::AttrKind::kFusedLoc);
+    emitter.emitVarInt(metadata);
+    emitter.emitVarInt(locations.size());
+    for (unsigned fusedLoc : locations)
+      emitter.emitVarInt(fusedLoc);
+    return;
+  }
+  // Opaque locations can't be serialized, only their fallback can.
+  if (auto loc = attr.dyn_cast<OpaqueLoc>())
+    return writeAttrEntry(emitter, loc.getFallbackLocation());
+
+  // The data of int and float elements attributes is stored raw, so that the
+  // reader does not have to parse and convert it.
+  if (auto elements = attr.dyn_cast<DenseIntOrFPElementsAttr>()) {
+    unsigned type = getTypeID(elements.getType());
+    emitter.emitVarInt(bytecode::AttrKind::kDenseElements);
+    emitter.emitVarInt(type);
+    emitter.emitVarInt(blobs.size());
+    emitter.emitByte(elements.isSplat());
+    blobs.push_back(elements.getRawData());
+    return;
+  }
+  if (auto elements = attr.dyn_cast<DenseResourceElementsAttr>()) {
+    unsigned type = getTypeID(elements.getType());
+    unsigned key = getStringID(elements.getBlobKey());
+    unsigned blob = 0;
+    if (Optional<ArrayRef<char>> data = elements.getRawData()) {
+      blob = blobs.size() + 1;
+      blobs.push_back(*data);
+    }
+    emitter.emitVarInt(bytecode::AttrKind::kDenseResource);
+    emitter.emitVarInt(type);
+    emitter.emitVarInt(key);
+    emitter.emitVarInt(blob);
+    return;
+  }
+
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  attr.print(os);
+  emitter.emitVarInt(bytecode::AttrKind::kText);
+  emitter.emitVarInt(getStringID(os.str()));
+}
+
+void BytecodeWriter::writeStringSection(EncodingEmitter &emitter) {
+  emitter.emitVarInt(strings.size());
+  for (StringRef str : strings)
+    emitter.emitVarInt(str.size());
+  for (StringRef str : strings)
+    emitter.emitBytes(llvm::arrayRefFromStringRef(str));
+}
+
+void BytecodeWriter::writeOpNameSection(EncodingEmitter &emitter) {
+  emitter.emitVarInt(opNames.size());
+  for (unsigned name : opNames)
+    emitter.emitVarInt(name);
+}
+
+void BytecodeWriter::writeAttrTypeSection(EncodingEmitter &emitter) {
+  emitter.emitVarInt(attrEntries.size());
+  emitter.emitVarInt(types.size());
+  for (const EncodingEmitter &entry : attrEntries) {
+    emitter.emitVarInt(entry.size());
+    emitter.emitBytes(entry.getBytes());
+  }
+  for (unsigned type : types)
+    emitter.emitVarInt(type);
+}
+
+void BytecodeWriter::writeBlobSection(EncodingEmitter &emitter) {
+  if (blobs.empty())
+    return;
+
+  // Lay out the data after the section header and the blob table.
+  uint64_t sectionStart = emitter.size() + /*id=*/1 + /*length=*/8;
+  uint64_t offset = sectionStart + 8 + 16 * blobs.size();
+  SmallVector<uint64_t> offsets;
+  for (ArrayRef<char> blob : blobs) {
+    offset = llvm::alignTo(offset, bytecode::kBlobAlignment);
+    offsets.push_back(offset);
+    offset += blob.size();
+  }
+
+  emitter.emitByte(bytecode::Section::kBlob);
+  emitter.emitFixed64(offset - sectionStart);
+  emitter.emitFixed64(blobs.size());
+  for (unsigned i = 0, e = blobs.size(); i != e; ++i) {
+    emitter.emitFixed64(offsets[i]);
+    emitter.emitFixed64(blobs[i].size());
+  }
+  for (ArrayRef<char> blob : blobs) {
+    emitter.alignTo(bytecode::kBlobAlignment);
+    emitter.emitBytes(llvm::makeArrayRef(
+        reinterpret_cast<const uint8_t *>(blob.data()), blob.size()));
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Entry Points
+//===----------------------------------------------------------------------===//
+
+void mlir::writeBytecodeToFile(Operation *op, raw_ostream &os,
+                               StringRef producer) {
+  BytecodeWriter().write(op, os, producer);
+}
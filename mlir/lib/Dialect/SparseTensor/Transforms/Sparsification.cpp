@@ -433,6 +433,51 @@ static Value genVectorReducEnd(CodeGen &codegen, PatternRewriter &rewriter,
                                               codegen.redVal, ValueRange{});
 }
 
+/// Generates the identity of the current reduction, which is the value each
+/// iteration of a parallel reduction loop starts from.
+static Value genReducIdentity(CodeGen &codegen, PatternRewriter &rewriter,
+                              Location loc, Type tp) {
+  switch (codegen.redKind) {
+  case kNoReduc:
+    break;
+  case kSum:
+  case kOr:
+  case kXor:
+    return constantZero(rewriter, loc, tp);
+  case kProduct:
+    return constantOne(rewriter, loc, tp);
+  case kAnd:
+    return rewriter.create<arith::ConstantOp>(loc, tp,
+                                              rewriter.getIntegerAttr(tp, -1));
+  }
+  llvm_unreachable("unknown reduction kind");
+}
+
+/// Generates the combination of two partial values of the current reduction.
+static Value genReducCombine(CodeGen &codegen, OpBuilder &builder,
+                             Location loc, Value lhs, Value rhs) {
+  bool isFloat = lhs.getType().isa<FloatType>();
+  switch (codegen.redKind) {
+  case kNoReduc:
+    break;
+  case kSum:
+    if (isFloat)
+      return builder.create<arith::AddFOp>(loc, lhs, rhs);
+    return builder.create<arith::AddIOp>(loc, lhs, rhs);
+  case kProduct:
+    if (isFloat)
+      return builder.create<arith::MulFOp>(loc, lhs, rhs);
+    return builder.create<arith::MulIOp>(loc, lhs, rhs);
+  case kAnd:
+    return builder.create<arith::AndIOp>(loc, lhs, rhs);
+  case kOr:
+    return builder.create<arith::OrIOp>(loc, lhs, rhs);
+  case kXor:
+    return builder.create<arith::XOrIOp>(loc, lhs, rhs);
+  }
+  llvm_unreachable("unknown reduction kind");
+}
+
 /// Updates scalarized reduction value.
 static void updateReduc(Merger &merger, CodeGen &codegen, Value reduc) {
   assert(codegen.redKind != kNoReduc);
@@ -1056,10 +1101,17 @@ static bool isVectorFor(CodeGen &codegen, bool isInner, bool isSparse) {
 }
 
 /// Returns parallelization strategy. Any implicit loop in the Linalg operation
-/// that is marked "parallel" is a candidate. Whether it is actually converted
-/// to a parallel operation depends on the requested strategy.
+/// that is marked "parallel" is a candidate, as well as any loop that only
+/// updates a scalarized reduction. Whether it is actually converted to a
+/// parallel operation depends on the requested strategy.
 static bool isParallelFor(CodeGen &codegen, bool isOuter, bool isReduction,
                           bool isSparse, bool isVector) {
+  // A scalarized reduction is carried by the loop, and combined across its
+  // iterations with a parallel reduction. Any other reduction would update
+  // the same elements of the output tensor in different iterations.
+  if (isReduction && codegen.redVal &&
+      !codegen.redVal.getType().isa<VectorType>())
+    isReduction = false;
   switch (codegen.options.parallelizationStrategy) {
   case SparseParallelizationStrategy::kNone:
     return false;
@@ -1128,15 +1180,25 @@ static Operation *genFor(Merger &merger, CodeGen &codegen,
   Value hi = isSparse ? codegen.highs[tensor][idx] : codegen.sizes[idx];
   Value step = constantIndex(rewriter, loc, codegen.curVecLength);
 
-  // Emit a parallel loop.
+  // Emit a parallel loop. A scalarized reduction becomes the initial value
+  // of a parallel reduction, while each iteration computes its partial value
+  // starting from the identity of the reduction.
   if (isParallel) {
     assert(!isVector);
-    scf::ParallelOp parOp = rewriter.create<scf::ParallelOp>(loc, lo, hi, step);
+    SmallVector<Value, 1> initVals;
+    if (codegen.redVal)
+      initVals.push_back(codegen.redVal);
+    scf::ParallelOp parOp =
+        rewriter.create<scf::ParallelOp>(loc, lo, hi, step, initVals);
     if (isSparse)
       codegen.pidxs[tensor][idx] = parOp.getInductionVars()[0];
     else
       codegen.loops[idx] = parOp.getInductionVars()[0];
     rewriter.setInsertionPointToStart(parOp.getBody());
+    if (codegen.redVal)
+      updateReduc(merger, codegen,
+                  genReducIdentity(codegen, rewriter, loc,
+                                   codegen.redVal.getType()));
     return parOp;
   }
 
@@ -1390,6 +1452,21 @@ static void genForInduction(Merger &merger, CodeGen &codegen,
                             PatternRewriter &rewriter, linalg::GenericOp op,
                             Operation *loop) {
   Location loc = op.getLoc();
+  // Combine the partial value of a parallel reduction.
+  if (auto parOp = dyn_cast<scf::ParallelOp>(loop)) {
+    assert(!codegen.expValues);
+    if (codegen.redVal) {
+      rewriter.create<scf::ReduceOp>(
+          loc, codegen.redVal,
+          [&](OpBuilder &builder, Location nestedLoc, Value lhs, Value rhs) {
+            Value red = genReducCombine(codegen, builder, nestedLoc, lhs, rhs);
+            builder.create<scf::ReduceReturnOp>(nestedLoc, red);
+          });
+      updateReduc(merger, codegen, parOp.getResult(0));
+    }
+    rewriter.setInsertionPointAfter(loop);
+    return;
+  }
   unsigned o = 0;
   SmallVector<Value, 4> operands;
   if (codegen.redVal) {
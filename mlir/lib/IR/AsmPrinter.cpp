@@ -1714,6 +1714,11 @@ void AsmPrinter::Impl::printAttribute(Attribute attr,
       os << '>';
     }
 
+  } else if (auto resourceAttr = attr.dyn_cast<DenseResourceElementsAttr>()) {
+    os << "dense_resource<\"";
+    printEscapedString(resourceAttr.getBlobKey(), os);
+    os << "\">";
+
   } else if (auto strEltAttr = attr.dyn_cast<DenseStringElementsAttr>()) {
     if (printerFlags.shouldElideElementsAttr(strEltAttr)) {
       printElidedElementsAttr(os);
@@ -36,7 +36,8 @@ using namespace mlir::detail;
 
 void BuiltinDialect::registerAttributes() {
   addAttributes<AffineMapAttr, ArrayAttr, DenseIntOrFPElementsAttr,
-                DenseStringElementsAttr, DictionaryAttr, FloatAttr,
+                DenseResourceElementsAttr, DenseStringElementsAttr,
+                DictionaryAttr, FloatAttr,
                 SymbolRefAttr, IntegerAttr, IntegerSetAttr, OpaqueAttr,
                 OpaqueElementsAttr, SparseElementsAttr, StringAttr, TypeAttr,
                 UnitAttr>();
@@ -1228,6 +1229,31 @@ bool DenseIntElementsAttr::classof(Attribute attr) {
          attr.getType().cast<ShapedType>().getElementType().isIntOrIndex();
 }
 
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr
+//===----------------------------------------------------------------------===//
+
+Optional<ArrayRef<char>> DenseResourceElementsAttr::getRawData() const {
+  if (ResourceBlob *blob = getRawHandle().getBlob())
+    return blob->getData();
+  return llvm::None;
+}
+
+LogicalResult DenseResourceElementsAttr::verify(
+    function_ref<InFlightDiagnostic()> emitError, ShapedType type,
+    DenseResourceElementsHandle handle) {
+  if (!type.hasStaticShape())
+    return emitError() << "expected a statically shaped type, but got "
+                       << type;
+  if (!type.getElementType().isIntOrFloat())
+    return emitError() << "expected an integer or floating point element "
+                          "type, but got "
+                       << type.getElementType();
+  if (!handle.getEntry())
+    return emitError() << "expected a non-null resource handle";
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // OpaqueElementsAttr
 //===----------------------------------------------------------------------===//
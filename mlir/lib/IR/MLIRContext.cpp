@@ -21,6 +21,7 @@
 #include "mlir/IR/IntegerSet.h"
 #include "mlir/IR/Location.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/ResourceBlobManager.h"
 #include "mlir/IR/Types.h"
 #include "mlir/Support/DebugAction.h"
 #include "llvm/ADT/DenseMap.h"
@@ -125,6 +126,13 @@ public:
   /// An action manager for use within the context.
   DebugActionManager debugActionManager;
 
+  //===--------------------------------------------------------------------===//
+  // Resources
+  //===--------------------------------------------------------------------===//
+
+  /// The blobs of data referenced by resource attributes.
+  ResourceBlobManager resourceBlobManager;
+
   //===--------------------------------------------------------------------===//
   // Diagnostics
   //===--------------------------------------------------------------------===//
@@ -339,6 +347,14 @@ DebugActionManager &MLIRContext::getDebugActionManager() {
   return getImpl().debugActionManager;
 }
 
+//===----------------------------------------------------------------------===//
+// Resources
+//===----------------------------------------------------------------------===//
+
+ResourceBlobManager &MLIRContext::getResourceBlobManager() {
+  return getImpl().resourceBlobManager;
+}
+
 //===----------------------------------------------------------------------===//
 // Diagnostic Handlers
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,105 @@
+//===- ResourceBlobManager.cpp - Out-of-line data blobs -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/ResourceBlobManager.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MemAlloc.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstring>
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// ResourceBlob
+//===----------------------------------------------------------------------===//
+
+ResourceBlob &ResourceBlob::operator=(ResourceBlob &&other) {
+  if (this == &other)
+    return *this;
+  release();
+  data = other.data;
+  dataAlignment = other.dataAlignment;
+  deleter = std::move(other.deleter);
+  other.data = llvm::None;
+  other.deleter = nullptr;
+  return *this;
+}
+
+void ResourceBlob::release() {
+  if (deleter)
+    deleter(data.data(), data.size(), dataAlignment);
+  deleter = nullptr;
+  data = llvm::None;
+}
+
+ResourceBlob ResourceBlob::allocateAndCopy(ArrayRef<char> data,
+                                           size_t alignment) {
+  char *buffer =
+      static_cast<char *>(llvm::allocate_buffer(data.size(), alignment));
+  std::memcpy(buffer, data.data(), data.size());
+  return ResourceBlob(ArrayRef<char>(buffer, data.size()), alignment,
+                      [](const char *data, size_t size, size_t align) {
+                        llvm::deallocate_buffer(const_cast<char *>(data), size,
+                                                align);
+                      });
+}
+
+ResourceBlob
+ResourceBlob::createFromBuffer(std::shared_ptr<llvm::MemoryBuffer> buffer,
+                               ArrayRef<char> data, size_t alignment) {
+  assert(data.begin() >= buffer->getBufferStart() &&
+         data.end() <= buffer->getBufferEnd() &&
+         "expected the data to lie within the buffer");
+  // The deleter keeps the buffer alive until the blob is released.
+  return ResourceBlob(data, alignment,
+                      [buffer = std::move(buffer)](const char *, size_t,
+                                                   size_t) mutable {
+                        buffer.reset();
+                      });
+}
+
+//===----------------------------------------------------------------------===//
+// ResourceBlobManager
+//===----------------------------------------------------------------------===//
+
+auto ResourceBlobManager::lookup(StringRef name) -> BlobEntry * {
+  llvm::sys::SmartScopedReader<true> reader(blobMapLock);
+  auto it = blobMap.find(name);
+  return it != blobMap.end() ? &it->second : nullptr;
+}
+
+auto ResourceBlobManager::insert(StringRef name, Optional<ResourceBlob> blob)
+    -> BlobEntry & {
+  llvm::sys::SmartScopedWriter<true> writer(blobMapLock);
+
+  // Try the name as is, then with a counter appended until it is unique.
+  SmallString<32> uniqueName(name);
+  auto it = blobMap.try_emplace(uniqueName);
+  for (unsigned counter = 0; !it.second; ++counter) {
+    uniqueName.resize(name.size());
+    uniqueName += '_';
+    uniqueName += std::to_string(counter);
+    it = blobMap.try_emplace(uniqueName);
+  }
+
+  BlobEntry &entry = it.first->second;
+  entry.key = it.first->getKey();
+  entry.blob = std::move(blob);
+  return entry;
+}
+
+auto ResourceBlobManager::getOrInsert(StringRef name) -> BlobEntry & {
+  if (BlobEntry *entry = lookup(name))
+    return *entry;
+
+  llvm::sys::SmartScopedWriter<true> writer(blobMapLock);
+  auto it = blobMap.try_emplace(name);
+  BlobEntry &entry = it.first->second;
+  entry.key = it.first->getKey();
+  return entry;
+}
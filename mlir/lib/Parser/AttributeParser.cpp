@@ -90,6 +90,10 @@ Attribute Parser::parseAttribute(Type type) {
   case Token::kw_dense:
     return parseDenseElementsAttr(type);
 
+  // Parse a dense resource elements attribute.
+  case Token::kw_dense_resource:
+    return parseDenseResourceElementsAttr(type);
+
   // Parse a dictionary attribute.
   case Token::l_brace: {
     NamedAttrList elements;
@@ -222,6 +226,7 @@ OptionalParseResult Parser::parseOptionalAttribute(Attribute &attribute,
   case Token::kw_affine_map:
   case Token::kw_affine_set:
   case Token::kw_dense:
+  case Token::kw_dense_resource:
   case Token::kw_false:
   case Token::kw_loc:
   case Token::kw_opaque:
@@ -831,6 +836,37 @@ Attribute Parser::parseDenseElementsAttr(Type attrType) {
   return literalParser.getAttr(loc, type);
 }
 
+/// Parse a dense resource elements attribute.
+///
+///   dense-resource-elements-attribute ::=
+///     `dense_resource` `<` string-literal `>` `:` elements-literal-type
+///
+/// The data of the attribute is not part of the textual form; the attribute
+/// refers to the blob with the given name in the context, which is created
+/// without data if it doesn't exist yet.
+Attribute Parser::parseDenseResourceElementsAttr(Type attrType) {
+  SMLoc loc = getToken().getLoc();
+  consumeToken(Token::kw_dense_resource);
+  if (parseToken(Token::less, "expected '<' after 'dense_resource'"))
+    return nullptr;
+
+  if (getToken().isNot(Token::string))
+    return (emitError("expected resource name"), nullptr);
+  std::string name = getToken().getStringValue();
+  consumeToken(Token::string);
+
+  if (parseToken(Token::greater, "expected '>'"))
+    return nullptr;
+  auto type = parseElementsLiteralType(attrType);
+  if (!type)
+    return nullptr;
+
+  ResourceBlobManager::BlobEntry &entry =
+      getContext()->getResourceBlobManager().getOrInsert(name);
+  return getChecked<DenseResourceElementsAttr>(
+      loc, type, DenseResourceElementsHandle(&entry));
+}
+
 /// Parse an opaque elements attribute.
 Attribute Parser::parseOpaqueElementsAttr(Type attrType) {
   SMLoc loc = getToken().getLoc();
@@ -257,6 +257,7 @@ public:
 
   /// Parse a dense elements attribute.
   Attribute parseDenseElementsAttr(Type attrType);
+  Attribute parseDenseResourceElementsAttr(Type attrType);
   ShapedType parseElementsLiteralType(Type type);
 
   /// Parse a sparse elements attribute.
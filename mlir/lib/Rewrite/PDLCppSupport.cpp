@@ -0,0 +1,124 @@
+//===- PDLCppSupport.cpp - PDL patterns compiled to C++ -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Rewrite/PDLCppSupport.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/Interfaces/InferTypeOpInterface.h"
+#include "mlir/Parser.h"
+#include <numeric>
+
+using namespace mlir;
+using namespace mlir::pdl_cpp;
+
+//===----------------------------------------------------------------------===//
+// Pattern Construction
+//===----------------------------------------------------------------------===//
+
+Attribute pdl_cpp::parseConstantAttr(StringRef attrStr, MLIRContext *context) {
+  Attribute attr = parseAttribute(attrStr, context);
+  if (!attr)
+    llvm::report_fatal_error("failed to parse the attribute `" + attrStr +
+                             "` of a generated PDL pattern");
+  return attr;
+}
+
+Type pdl_cpp::parseConstantType(StringRef typeStr, MLIRContext *context) {
+  Type type = parseType(typeStr, context);
+  if (!type)
+    llvm::report_fatal_error("failed to parse the type `" + typeStr +
+                             "` of a generated PDL pattern");
+  return type;
+}
+
+const PDLConstraintFunction &
+pdl_cpp::lookupConstraintFunction(const PDLPatternModule &functions,
+                                  StringRef name) {
+  auto it = functions.getConstraintFunctions().find(name);
+  if (it == functions.getConstraintFunctions().end())
+    llvm::report_fatal_error("PDL constraint function `" + name +
+                             "` was not registered");
+  return it->second;
+}
+
+const PDLRewriteFunction &
+pdl_cpp::lookupRewriteFunction(const PDLPatternModule &functions,
+                               StringRef name) {
+  auto it = functions.getRewriteFunctions().find(name);
+  if (it == functions.getRewriteFunctions().end())
+    llvm::report_fatal_error("PDL rewrite function `" + name +
+                             "` was not registered");
+  return it->second;
+}
+
+//===----------------------------------------------------------------------===//
+// Matching
+//===----------------------------------------------------------------------===//
+
+/// Return the values of the group `index` of the given operand or result
+/// range of `op`. This mirrors the interpretation of `pdl_interp.get_operands`
+/// and `pdl_interp.get_results` in the bytecode.
+template <template <typename> class AttrSizedSegmentsT>
+static Optional<ValueRange> getValueGroup(ValueRange values, Operation *op,
+                                          unsigned index,
+                                          StringRef attrSizedSegments) {
+  if (op->hasTrait<AttrSizedSegmentsT>()) {
+    auto segmentAttr = op->getAttrOfType<DenseElementsAttr>(attrSizedSegments);
+    if (!segmentAttr || segmentAttr.getNumElements() <= index)
+      return llvm::None;
+
+    auto segments = segmentAttr.getValues<int32_t>();
+    unsigned startIndex =
+        std::accumulate(segments.begin(), segments.begin() + index, 0);
+    return values.slice(startIndex, *std::next(segments.begin(), index));
+  }
+
+  // Otherwise, assume this is the last group of the operation.
+  if (values.size() >= index)
+    return values.drop_front(index);
+  return llvm::None;
+}
+
+Optional<ValueRange> pdl_cpp::getOperandGroup(Operation *op, unsigned index) {
+  return getValueGroup<OpTrait::AttrSizedOperandSegments>(
+      op->getOperands(), op, index, "operand_segment_sizes");
+}
+
+Optional<ValueRange> pdl_cpp::getResultGroup(Operation *op, unsigned index) {
+  return getValueGroup<OpTrait::AttrSizedResultSegments>(
+      op->getResults(), op, index, "result_segment_sizes");
+}
+
+void pdl_cpp::appendUsers(SmallVectorImpl<Operation *> &users, Value value) {
+  if (value)
+    users.append(value.user_begin(), value.user_end());
+}
+
+void pdl_cpp::appendUsers(SmallVectorImpl<Operation *> &users,
+                          const Optional<ValueRange> &values) {
+  if (!values)
+    return;
+  for (Value value : *values)
+    users.append(value.user_begin(), value.user_end());
+}
+
+//===----------------------------------------------------------------------===//
+// Rewriting
+//===----------------------------------------------------------------------===//
+
+LogicalResult pdl_cpp::inferResultTypes(OperationState &state) {
+  Optional<RegisteredOperationName> info = state.name.getRegisteredInfo();
+  auto *concept = info ? info->getInterface<InferTypeOpInterface>() : nullptr;
+  if (!concept)
+    return failure();
+
+  state.types.clear();
+  return concept->inferReturnTypes(
+      state.getContext(), state.location, state.operands,
+      state.attributes.getDictionary(state.getContext()), state.regions,
+      state.types);
+}
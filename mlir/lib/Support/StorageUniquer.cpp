@@ -12,6 +12,8 @@
 #include "mlir/Support/ThreadLocalCache.h"
 #include "mlir/Support/TypeID.h"
 #include "llvm/Support/RWMutex.h"
+#include "llvm/Support/Threading.h"
+#include <atomic>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -26,6 +28,7 @@ class ParametricStorageUniquer {
 public:
   using BaseStorage = StorageUniquer::BaseStorage;
   using StorageAllocator = StorageUniquer::StorageAllocator;
+  using Statistics = StorageUniquer::Statistics;
 
   /// A lookup key for derived instances of storage objects.
   struct LookupKey {
@@ -88,18 +91,27 @@ private:
 #if LLVM_ENABLE_THREADS != 0
     /// A mutex to keep uniquing thread-safe.
     llvm::sys::SmartRWMutex<true> mutex;
+
+    /// The number of lookups that used this shard. These are only updated
+    /// while holding the mutex, which already owns the cache line.
+    std::atomic<uint64_t> numSharedHits{0};
+    std::atomic<uint64_t> numWriterLocks{0};
+    std::atomic<uint64_t> numRacedInsertions{0};
 #endif
   };
 
   /// Get or create an instance of a param derived type in an thread-unsafe
-  /// fashion.
+  /// fashion. `inserted` is set to whether a new instance was created.
   BaseStorage *
   getOrCreateUnsafe(Shard &shard, LookupKey &key,
-                    function_ref<BaseStorage *(StorageAllocator &)> ctorFn) {
+                    function_ref<BaseStorage *(StorageAllocator &)> ctorFn,
+                    bool *inserted = nullptr) {
     auto existing = shard.instances.insert_as({key.hashValue}, key);
     BaseStorage *&storage = existing.first->storage;
     if (existing.second)
       storage = ctorFn(shard.allocator);
+    if (inserted)
+      *inserted = existing.second;
     return storage;
   }
 
@@ -113,11 +125,21 @@ private:
 
 public:
 #if LLVM_ENABLE_THREADS != 0
+  /// Return the default number of shards. It scales with the number of
+  /// hardware threads, so that threads creating new instances rarely contend
+  /// for the same shard. Shards are allocated lazily, so unused ones are cheap.
+  static size_t getDefaultNumShards() {
+    static const size_t numShards = std::min<uint64_t>(
+        64, llvm::PowerOf2Ceil(std::max(
+                8u, 2 * llvm::hardware_concurrency().compute_thread_count())));
+    return numShards;
+  }
+
   /// Initialize the storage uniquer with a given number of storage shards to
   /// use. The provided shard number is required to be a valid power of 2. The
   /// destructor function is used to destroy any allocated storage instances.
   ParametricStorageUniquer(function_ref<void(BaseStorage *)> destructorFn,
-                           size_t numShards = 8)
+                           size_t numShards = getDefaultNumShards())
       : shards(new std::atomic<Shard *>[numShards]), numShards(numShards),
         destructorFn(destructorFn) {
     assert(llvm::isPowerOf2_64(numShards) &&
@@ -144,24 +166,52 @@ public:
     if (!threadingIsEnabled)
       return getOrCreateUnsafe(shard, lookupKey, ctorFn);
 
-    // Check for a instance of this object in the local cache.
-    auto localIt = localCache->insert_as({hashValue}, lookupKey);
+    // Check for a instance of this object in the local cache. The hit counter
+    // is only written by this thread, so it doesn't need an atomic increment.
+    LocalCache &cache = *localCache;
+    auto localIt = cache.instances.insert_as({hashValue}, lookupKey);
     BaseStorage *&localInst = localIt.first->storage;
-    if (localInst)
+    if (localInst) {
+      cache.numHits.store(cache.numHits.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
       return localInst;
+    }
 
     // Check for an existing instance in read-only mode.
     {
       llvm::sys::SmartScopedReader<true> typeLock(shard.mutex);
       auto it = shard.instances.find_as(lookupKey);
-      if (it != shard.instances.end())
+      if (it != shard.instances.end()) {
+        shard.numSharedHits.fetch_add(1, std::memory_order_relaxed);
         return localInst = it->storage;
+      }
     }
 
     // Acquire a writer-lock so that we can safely create the new storage
-    // instance.
+    // instance. Another thread may have created it since the lookup above.
     llvm::sys::SmartScopedWriter<true> typeLock(shard.mutex);
-    return localInst = getOrCreateUnsafe(shard, lookupKey, ctorFn);
+    shard.numWriterLocks.fetch_add(1, std::memory_order_relaxed);
+    bool inserted;
+    localInst = getOrCreateUnsafe(shard, lookupKey, ctorFn, &inserted);
+    if (!inserted)
+      shard.numRacedInsertions.fetch_add(1, std::memory_order_relaxed);
+    return localInst;
+  }
+  /// Add the statistics of this uniquer to `stats`.
+  void addStatistics(Statistics &stats) {
+    for (size_t i = 0; i != numShards; ++i) {
+      if (Shard *shard = shards[i].load(std::memory_order_acquire)) {
+        stats.numSharedHits +=
+            shard->numSharedHits.load(std::memory_order_relaxed);
+        stats.numWriterLocks +=
+            shard->numWriterLocks.load(std::memory_order_relaxed);
+        stats.numRacedInsertions +=
+            shard->numRacedInsertions.load(std::memory_order_relaxed);
+      }
+    }
+    localCache.forEachInstance([&](LocalCache &cache) {
+      stats.numLocalCacheHits += cache.numHits.load(std::memory_order_relaxed);
+    });
   }
   /// Run a mutation function on the provided storage object in a thread-safe
   /// way.
@@ -209,9 +259,19 @@ private:
     llvm_unreachable("expected storage object to have a valid shard");
   }
 
+  /// The lookup cache of a single thread.
+  struct LocalCache {
+    /// The storage objects already looked up by the thread.
+    StorageTypeSet instances;
+
+    /// The number of lookups resolved by this cache. This is only written by
+    /// the owning thread, but may be read by any thread.
+    std::atomic<uint64_t> numHits{0};
+  };
+
   /// A thread local cache for storage objects. This helps to reduce the lock
   /// contention when an object already existing in the cache.
-  ThreadLocalCache<StorageTypeSet> localCache;
+  ThreadLocalCache<LocalCache> localCache;
 
   /// A set of uniquer shards to allow for further bucketing accesses for
   /// instances of this storage type. Each shard is lazily initialized to reduce
@@ -248,6 +308,8 @@ private:
          function_ref<LogicalResult(StorageAllocator &)> mutationFn) {
     return mutationFn(shard.allocator);
   }
+  /// Statistics are only recorded when multi-threading is enabled.
+  void addStatistics(Statistics &stats) {}
 
 private:
   /// The main uniquer shard that is used for allocating storage instances.
@@ -296,6 +358,19 @@ struct StorageUniquerImpl {
     return storageUniquer.mutate(threadingIsEnabled, storage, mutationFn);
   }
 
+  /// Add the statistics of the parametric storage class with the given id, or
+  /// of all of them if `id` is null, to `stats`.
+  void addStatistics(Optional<TypeID> id, StorageUniquer::Statistics &stats) {
+    if (id) {
+      auto it = parametricUniquers.find(*id);
+      if (it != parametricUniquers.end())
+        it->second->addStatistics(stats);
+      return;
+    }
+    for (auto &it : parametricUniquers)
+      it.second->addStatistics(stats);
+  }
+
   //===--------------------------------------------------------------------===//
   // Singleton Storage
   //===--------------------------------------------------------------------===//
@@ -339,6 +414,27 @@ void StorageUniquer::disableMultithreading(bool disable) {
   impl->threadingIsEnabled = !disable;
 }
 
+auto StorageUniquer::Statistics::operator+=(const Statistics &other)
+    -> Statistics & {
+  numLocalCacheHits += other.numLocalCacheHits;
+  numSharedHits += other.numSharedHits;
+  numWriterLocks += other.numWriterLocks;
+  numRacedInsertions += other.numRacedInsertions;
+  return *this;
+}
+
+auto StorageUniquer::getStatistics(TypeID id) const -> Statistics {
+  Statistics stats;
+  impl->addStatistics(id, stats);
+  return stats;
+}
+
+auto StorageUniquer::getStatistics() const -> Statistics {
+  Statistics stats;
+  impl->addStatistics(llvm::None, stats);
+  return stats;
+}
+
 /// Implementation for getting/creating an instance of a derived type with
 /// parametric storage.
 auto StorageUniquer::getParametricStorageTypeImpl(
@@ -0,0 +1,42 @@
+//===- TranslateRegistration.cpp - Register translation -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/PDL/IR/PDL.h"
+#include "mlir/Dialect/PDLInterp/IR/PDLInterp.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Dialect.h"
+#include "mlir/Target/PDLCpp/PDLCppEmitter.h"
+#include "mlir/Translation.h"
+#include "llvm/Support/CommandLine.h"
+
+using namespace mlir;
+
+namespace mlir {
+
+//===----------------------------------------------------------------------===//
+// PDL to Cpp registration
+//===----------------------------------------------------------------------===//
+
+void registerPDLToCppTranslation() {
+  static llvm::cl::opt<std::string> populateFnName(
+      "pdl-populate-fn-name",
+      llvm::cl::desc("Name of the function populating a pattern set with the "
+                     "patterns generated from PDL"),
+      llvm::cl::init("populatePDLPatterns"));
+
+  TranslateFromMLIRRegistration reg(
+      "pdl-to-cpp",
+      [](ModuleOp module, raw_ostream &output) {
+        return pdl::translateToCpp(module, output, populateFnName);
+      },
+      [](DialectRegistry &registry) {
+        registry.insert<pdl::PDLDialect, pdl_interp::PDLInterpDialect>();
+      });
+}
+
+} // namespace mlir
@@ -0,0 +1,955 @@
+//===- TranslateToCpp.cpp - Translating PDL patterns to C++ ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the compilation of PDL patterns into native C++ rewrite
+// patterns. Each pattern is lowered on its own to the PDL interpreter dialect,
+// whose matcher and rewriter functions are then emitted as the methods of a
+// `RewritePattern`. The blocks of the matcher become labels, and the
+// interpreter operations become the C++ statements that the bytecode would
+// otherwise interpret when matching.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Target/PDLCpp/PDLCppEmitter.h"
+#include "mlir/Conversion/PDLToPDLInterp/PDLToPDLInterp.h"
+#include "mlir/Dialect/PDL/IR/PDLOps.h"
+#include "mlir/Dialect/PDL/IR/PDLTypes.h"
+#include "mlir/Dialect/PDLInterp/IR/PDLInterp.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Support/IndentedOstream.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/FormatVariadic.h"
+
+using namespace mlir;
+using llvm::formatv;
+
+//===----------------------------------------------------------------------===//
+// Utilities
+//===----------------------------------------------------------------------===//
+
+/// Return the C++ type used to hold values of the given PDL type within the
+/// generated code.
+static StringRef getCppType(Type type) {
+  if (auto rangeType = type.dyn_cast<pdl::RangeType>()) {
+    Type elementType = rangeType.getElementType();
+    if (elementType.isa<pdl::OperationType>())
+      return "::llvm::SmallVector<::mlir::Operation *, 4>";
+    if (elementType.isa<pdl::TypeType>())
+      return "::llvm::Optional<::mlir::TypeRange>";
+    return "::llvm::Optional<::mlir::ValueRange>";
+  }
+  return llvm::TypeSwitch<Type, StringRef>(type)
+      .Case([](pdl::AttributeType) { return "::mlir::Attribute"; })
+      .Case([](pdl::OperationType) { return "::mlir::Operation *"; })
+      .Case([](pdl::TypeType) { return "::mlir::Type"; })
+      .Case([](pdl::ValueType) { return "::mlir::Value"; });
+}
+
+/// Return the C++ type of the given PDL type when it is returned by a native
+/// function.
+static StringRef getNativeResultCppType(Type type) {
+  if (auto rangeType = type.dyn_cast<pdl::RangeType>())
+    return rangeType.getElementType().isa<pdl::TypeType>()
+               ? "::mlir::TypeRange"
+               : "::mlir::ValueRange";
+  return getCppType(type);
+}
+
+/// Return the declaration of a C++ variable holding values of the given PDL
+/// type.
+static std::string getDecl(Type type, StringRef name) {
+  StringRef cppType = getCppType(type);
+  return (cppType + (cppType.endswith("*") ? "" : " ") + name).str();
+}
+
+/// Return true if values of the given type are held by an optional range.
+static bool isOptionalRange(Type type) {
+  auto rangeType = type.dyn_cast<pdl::RangeType>();
+  return rangeType && !rangeType.getElementType().isa<pdl::OperationType>();
+}
+
+/// Return a C++ string literal holding the given string.
+static std::string getStringLiteral(StringRef str) {
+  std::string literal;
+  llvm::raw_string_ostream os(literal);
+  os << '"';
+  os.write_escaped(str);
+  os << '"';
+  return os.str();
+}
+
+/// Return the textual form of the given attribute or type.
+template <typename T>
+static std::string print(T value) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  value.print(os);
+  return os.str();
+}
+
+/// Return a C++ class name derived from the name of a pattern, e.g.
+/// `fold_add_of_zero` becomes `FoldAddOfZero`.
+static std::string getClassName(StringRef patternName) {
+  std::string name;
+  bool capitalize = true;
+  for (char c : patternName) {
+    if (!llvm::isAlnum(c)) {
+      capitalize = true;
+      continue;
+    }
+    name += capitalize ? llvm::toUpper(c) : c;
+    capitalize = false;
+  }
+  if (name.empty() || llvm::isDigit(name.front()))
+    name.insert(0, "Pattern");
+  return name;
+}
+
+//===----------------------------------------------------------------------===//
+// PatternEmitter
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class emits the native C++ rewrite pattern corresponding to a single
+/// PDL pattern, from its matcher and rewriter functions in the PDL interpreter
+/// dialect.
+class PatternEmitter {
+public:
+  PatternEmitter(FuncOp matcherFunc, FuncOp rewriterFunc,
+                 pdl_interp::RecordMatchOp matchOp)
+      : matcherFunc(matcherFunc), rewriterFunc(rewriterFunc),
+        matchOp(matchOp) {}
+
+  /// Emit the pattern as a class with the given name.
+  void emit(raw_indented_ostream &os, StringRef className,
+            Optional<StringRef> debugName);
+
+private:
+  /// A member of the pattern holding a constant, and the expression used to
+  /// initialize it.
+  struct Constant {
+    std::string cppType, name, initializer;
+  };
+
+  /// Emit the body of the given function, which is either the matcher or the
+  /// rewriter of the pattern.
+  std::string emitFunctionBody(FuncOp func, bool isMatcher);
+
+  /// Emit the blocks of the given region.
+  void emitBlocks(Region &region);
+
+  /// Emit a branch to the given block.
+  void emitBranch(Block *dest);
+
+  /// Emit a conditional branch, taking `trueDest` when `cond` holds.
+  void emitCondBranch(const Twine &cond, Block *trueDest, Block *falseDest);
+
+  /// Emit a switch that compares `value` with each of the given case values,
+  /// using the given comparator.
+  void emitSwitch(StringRef value, ArrayRef<std::string> caseValues,
+                  Block *defaultDest, SuccessorRange caseDests,
+                  StringRef comparator = "{0} == {1}");
+  void emitSwitch(StringRef value, DenseIntElementsAttr caseValues,
+                  Block *defaultDest, SuccessorRange caseDests);
+
+  /// Emit the code of the given operation.
+  void emitOp(Operation *op);
+  void emit(pdl_interp::ApplyConstraintOp op);
+  void emit(pdl_interp::ApplyRewriteOp op);
+  void emit(pdl_interp::AreEqualOp op);
+  void emit(pdl_interp::BranchOp op);
+  void emit(pdl_interp::CheckAttributeOp op);
+  void emit(pdl_interp::CheckOperandCountOp op);
+  void emit(pdl_interp::CheckOperationNameOp op);
+  void emit(pdl_interp::CheckResultCountOp op);
+  void emit(pdl_interp::CheckTypeOp op);
+  void emit(pdl_interp::CheckTypesOp op);
+  void emit(pdl_interp::ContinueOp op);
+  void emit(pdl_interp::CreateAttributeOp op);
+  void emit(pdl_interp::CreateOperationOp op);
+  void emit(pdl_interp::CreateTypeOp op);
+  void emit(pdl_interp::CreateTypesOp op);
+  void emit(pdl_interp::EraseOp op);
+  void emit(pdl_interp::ExtractOp op);
+  void emit(pdl_interp::FinalizeOp op);
+  void emit(pdl_interp::ForEachOp op);
+  void emit(pdl_interp::GetAttributeOp op);
+  void emit(pdl_interp::GetAttributeTypeOp op);
+  void emit(pdl_interp::GetDefiningOpOp op);
+  void emit(pdl_interp::GetOperandOp op);
+  void emit(pdl_interp::GetOperandsOp op);
+  void emit(pdl_interp::GetResultOp op);
+  void emit(pdl_interp::GetResultsOp op);
+  void emit(pdl_interp::GetUsersOp op);
+  void emit(pdl_interp::GetValueTypeOp op);
+  void emit(pdl_interp::InferredTypesOp op) {}
+  void emit(pdl_interp::IsNotNullOp op);
+  void emit(pdl_interp::RecordMatchOp op);
+  void emit(pdl_interp::ReplaceOp op);
+  void emit(pdl_interp::SwitchAttributeOp op);
+  void emit(pdl_interp::SwitchOperandCountOp op);
+  void emit(pdl_interp::SwitchOperationNameOp op);
+  void emit(pdl_interp::SwitchResultCountOp op);
+  void emit(pdl_interp::SwitchTypeOp op);
+  void emit(pdl_interp::SwitchTypesOp op);
+
+  /// Emit the assignment of `expr` to `value`, if the value is used.
+  void emitAssign(Value value, const Twine &expr);
+
+  /// Return the name of the C++ variable holding the given value.
+  StringRef getName(Value value) {
+    auto it = valueNames.find(value);
+    assert(it != valueNames.end() && "expected value to be named");
+    return it->second;
+  }
+
+  /// Return the expression used to pass `value` to a native function.
+  std::string getNativeArg(Value value);
+  std::string getNativeArgs(ValueRange values);
+
+  /// Return the name of the member holding a constant of the given C++ type,
+  /// initialized with `initializer`. The member is created if necessary.
+  StringRef getConstant(StringRef prefix, StringRef cppType,
+                        const Twine &initializer);
+  StringRef getAttrConstant(Attribute attr);
+  StringRef getArrayAttrConstant(ArrayAttr attr);
+  StringRef getTypeConstant(Type type);
+  StringRef getTypesConstant(ArrayAttr types);
+  StringRef getOperationNameConstant(StringRef name);
+  StringRef getStringAttrConstant(StringRef str);
+  StringRef getConstParamsConstant(Optional<ArrayAttr> constParams);
+
+  /// The functions of the pattern, and the operation recording its match.
+  FuncOp matcherFunc, rewriterFunc;
+  pdl_interp::RecordMatchOp matchOp;
+
+  /// The stream that the body of the current function is emitted to.
+  raw_indented_ostream *os = nullptr;
+
+  /// The names of the values and the labels of the blocks of the current
+  /// function.
+  DenseMap<Value, std::string> valueNames;
+  DenseMap<Block *, unsigned> blockIds;
+
+  /// The constants of the pattern, and their index keyed by type and
+  /// initializer.
+  std::vector<Constant> constants;
+  llvm::StringMap<unsigned> constantIndices;
+  llvm::StringMap<unsigned> numConstantsPerPrefix;
+
+  /// The number of native results lists created in the current function.
+  unsigned numResultLists = 0;
+};
+} // namespace
+
+void PatternEmitter::emit(raw_indented_ostream &classOS, StringRef className,
+                          Optional<StringRef> debugName) {
+  // Emit the functions first, to collect the constants they use.
+  std::string matcherBody = emitFunctionBody(matcherFunc, /*isMatcher=*/true);
+  std::string rewriterBody =
+      emitFunctionBody(rewriterFunc, /*isMatcher=*/false);
+
+  // Emit the constructor.
+  classOS << formatv("struct {0} : public ::mlir::RewritePattern {{\n",
+                     className);
+  classOS.indent();
+  classOS << formatv("{0}(::mlir::MLIRContext *context,\n", className);
+  classOS << std::string(className.size() + 1, ' ')
+          << "const ::mlir::PDLPatternModule &functions)\n";
+  classOS.indent().indent();
+  classOS << ": ::mlir::RewritePattern(";
+  if (Optional<StringRef> rootKind = matchOp.rootKind())
+    classOS << getStringLiteral(*rootKind);
+  else
+    classOS << "MatchAnyOpTypeTag()";
+  classOS << ", " << matchOp.benefit() << ", context, {";
+  if (Optional<ArrayAttr> generatedOps = matchOp.generatedOps()) {
+    llvm::interleaveComma(generatedOps->getAsValueRange<StringAttr>(), classOS,
+                          [&](StringRef name) {
+                            classOS << getStringLiteral(name);
+                          });
+  }
+  classOS << "})";
+  for (const Constant &constant : constants)
+    classOS << ",\n  " << constant.name << "(" << constant.initializer << ")";
+  classOS << " {\n";
+  classOS.unindent();
+  if (debugName)
+    classOS << "setDebugName(" << getStringLiteral(*debugName) << ");\n";
+  classOS.unindent();
+  classOS << "}\n\n";
+
+  // Emit the matcher.
+  classOS << "::mlir::LogicalResult\n"
+          << "matchAndRewrite(::mlir::Operation *root,\n"
+          << "                ::mlir::PatternRewriter &rewriter) const final "
+             "{\n";
+  classOS.indent().printReindented(matcherBody).unindent();
+  classOS << "}\n\n";
+
+  // Emit the rewriter, which is invoked with the inputs of the match.
+  classOS.unindent();
+  classOS << "private:\n";
+  classOS.indent();
+  classOS << "::mlir::LogicalResult\n"
+          << "applyRewrite(::mlir::PatternRewriter &rewriter, "
+             "::mlir::Location loc";
+  for (BlockArgument arg : rewriterFunc.getArguments()) {
+    std::string name = ("arg" + Twine(arg.getArgNumber())).str();
+    classOS << ",\n             " << getDecl(arg.getType(), name);
+  }
+  classOS << ") const {\n";
+  classOS.indent().printReindented(rewriterBody).unindent();
+  classOS << "}\n";
+
+  // Emit the constants.
+  if (!constants.empty())
+    classOS << "\n";
+  for (const Constant &constant : constants)
+    classOS << constant.cppType << " " << constant.name << ";\n";
+  classOS.unindent();
+  classOS << "};\n\n";
+}
+
+std::string PatternEmitter::emitFunctionBody(FuncOp func, bool isMatcher) {
+  std::string body;
+  llvm::raw_string_ostream bodyStream(body);
+  raw_indented_ostream bodyOS(bodyStream);
+  os = &bodyOS;
+  valueNames.clear();
+  blockIds.clear();
+  numResultLists = 0;
+
+  // Name the arguments of the function, and the values defined within it.
+  for (BlockArgument arg : func.getArguments()) {
+    valueNames[arg] =
+        isMatcher ? "root" : ("arg" + Twine(arg.getArgNumber())).str();
+  }
+  unsigned numValues = 0;
+  func.walk([&](Block *block) {
+    blockIds.try_emplace(block, blockIds.size());
+    if (block->isEntryBlock() && block->getParentOp() == func)
+      return;
+    for (BlockArgument arg : block->getArguments())
+      valueNames[arg] = ("v" + Twine(numValues++)).str();
+  });
+  func.walk([&](Operation *op) {
+    for (Value result : op->getResults())
+      valueNames[result] = ("v" + Twine(numValues++)).str();
+  });
+
+  // Declare all of the values upfront, so that branches between the blocks
+  // don't cross their initialization.
+  bool hasDecls = false;
+  func.walk([&](Operation *op) {
+    if (isa<pdl_interp::InferredTypesOp>(op))
+      return;
+    for (Value result : op->getResults()) {
+      if (result.use_empty())
+        continue;
+      bodyOS << getDecl(result.getType(), getName(result));
+      if (result.getType().isa<pdl::OperationType>())
+        bodyOS << " = nullptr";
+      bodyOS << ";\n";
+      hasDecls = true;
+    }
+  });
+  if (hasDecls)
+    bodyOS << "\n";
+
+  emitBlocks(func.getBody());
+  os = nullptr;
+  return bodyStream.str();
+}
+
+void PatternEmitter::emitBlocks(Region &region) {
+  for (Block &block : region) {
+    if (!block.hasNoPredecessors())
+      *os << "bb" << blockIds.lookup(&block) << ":\n";
+    for (Operation &op : block)
+      emitOp(&op);
+  }
+}
+
+void PatternEmitter::emitBranch(Block *dest) {
+  *os << "goto bb" << blockIds.lookup(dest) << ";\n";
+}
+
+void PatternEmitter::emitCondBranch(const Twine &cond, Block *trueDest,
+                                    Block *falseDest) {
+  *os << "if (" << cond << ")\n";
+  os->indent();
+  emitBranch(trueDest);
+  os->unindent();
+  emitBranch(falseDest);
+}
+
+void PatternEmitter::emitSwitch(StringRef value,
+                                ArrayRef<std::string> caseValues,
+                                Block *defaultDest, SuccessorRange caseDests,
+                                StringRef comparator) {
+  for (auto it : llvm::zip(caseValues, caseDests)) {
+    *os << "if (" << formatv(comparator.data(), value, std::get<0>(it))
+        << ")\n";
+    os->indent();
+    emitBranch(std::get<1>(it));
+    os->unindent();
+  }
+  emitBranch(defaultDest);
+}
+
+void PatternEmitter::emitSwitch(StringRef value,
+                                DenseIntElementsAttr caseValues,
+                                Block *defaultDest, SuccessorRange caseDests) {
+  *os << "switch (" << value << ") {\n";
+  for (auto it : llvm::zip(caseValues.getValues<uint32_t>(), caseDests)) {
+    *os << "case " << std::get<0>(it) << ":\n";
+    os->indent();
+    emitBranch(std::get<1>(it));
+    os->unindent();
+  }
+  *os << "default:\n";
+  os->indent();
+  emitBranch(defaultDest);
+  os->unindent();
+  *os << "}\n";
+}
+
+void PatternEmitter::emitOp(Operation *op) {
+  llvm::TypeSwitch<Operation *>(op)
+      .Case<pdl_interp::ApplyConstraintOp, pdl_interp::ApplyRewriteOp,
+            pdl_interp::AreEqualOp, pdl_interp::BranchOp,
+            pdl_interp::CheckAttributeOp, pdl_interp::CheckOperandCountOp,
+            pdl_interp::CheckOperationNameOp, pdl_interp::CheckResultCountOp,
+            pdl_interp::CheckTypeOp, pdl_interp::CheckTypesOp,
+            pdl_interp::ContinueOp, pdl_interp::CreateAttributeOp,
+            pdl_interp::CreateOperationOp, pdl_interp::CreateTypeOp,
+            pdl_interp::CreateTypesOp, pdl_interp::EraseOp,
+            pdl_interp::ExtractOp, pdl_interp::FinalizeOp,
+            pdl_interp::ForEachOp, pdl_interp::GetAttributeOp,
+            pdl_interp::GetAttributeTypeOp, pdl_interp::GetDefiningOpOp,
+            pdl_interp::GetOperandOp, pdl_interp::GetOperandsOp,
+            pdl_interp::GetResultOp, pdl_interp::GetResultsOp,
+            pdl_interp::GetUsersOp, pdl_interp::GetValueTypeOp,
+            pdl_interp::InferredTypesOp, pdl_interp::IsNotNullOp,
+            pdl_interp::RecordMatchOp, pdl_interp::ReplaceOp,
+            pdl_interp::SwitchAttributeOp, pdl_interp::SwitchTypeOp,
+            pdl_interp::SwitchTypesOp, pdl_interp::SwitchOperandCountOp,
+            pdl_interp::SwitchOperationNameOp,
+            pdl_interp::SwitchResultCountOp>([&](auto interpOp) {
+        this->emit(interpOp);
+      })
+      .Default([](Operation *) {
+        llvm_unreachable("unknown `pdl_interp` operation");
+      });
+}
+
+void PatternEmitter::emitAssign(Value value, const Twine &expr) {
+  if (!value.use_empty())
+    *os << getName(value) << " = " << expr << ";\n";
+}
+
+std::string PatternEmitter::getNativeArg(Value value) {
+  if (isOptionalRange(value.getType()))
+    return ("::mlir::pdl_cpp::toPDLValue(" + getName(value) + ")").str();
+  return getName(value).str();
+}
+
+std::string PatternEmitter::getNativeArgs(ValueRange values) {
+  std::string args;
+  llvm::raw_string_ostream argsOS(args);
+  argsOS << "{";
+  llvm::interleaveComma(values, argsOS,
+                        [&](Value value) { argsOS << getNativeArg(value); });
+  argsOS << "}";
+  return argsOS.str();
+}
+
+//===----------------------------------------------------------------------===//
+// Constants
+
+StringRef PatternEmitter::getConstant(StringRef prefix, StringRef cppType,
+                                      const Twine &initializer) {
+  std::string init = initializer.str();
+  auto it = constantIndices.try_emplace((cppType + "\n" + init).str(),
+                                        constants.size());
+  if (it.second) {
+    unsigned index = numConstantsPerPrefix[prefix]++;
+    constants.push_back(
+        {cppType.str(), (prefix + Twine(index)).str(), std::move(init)});
+  }
+  return constants[it.first->second].name;
+}
+
+StringRef PatternEmitter::getAttrConstant(Attribute attr) {
+  return getConstant(
+      "attr", "::mlir::Attribute",
+      "::mlir::pdl_cpp::parseConstantAttr(" + getStringLiteral(print(attr)) +
+          ", context)");
+}
+
+StringRef PatternEmitter::getArrayAttrConstant(ArrayAttr attr) {
+  return getConstant(
+      "arrayAttr", "::mlir::ArrayAttr",
+      "::mlir::pdl_cpp::parseConstantAttr(" + getStringLiteral(print(attr)) +
+          ", context).cast<::mlir::ArrayAttr>()");
+}
+
+StringRef PatternEmitter::getTypeConstant(Type type) {
+  return getConstant(
+      "type", "::mlir::Type",
+      "::mlir::pdl_cpp::parseConstantType(" + getStringLiteral(print(type)) +
+          ", context)");
+}
+
+StringRef PatternEmitter::getTypesConstant(ArrayAttr types) {
+  std::string init;
+  llvm::raw_string_ostream initOS(init);
+  initOS << "::llvm::SmallVector<::mlir::Type, 4>{";
+  llvm::interleaveComma(types.getAsValueRange<TypeAttr>(), initOS,
+                        [&](Type type) { initOS << getTypeConstant(type); });
+  initOS << "}";
+  return getConstant("types", "::llvm::SmallVector<::mlir::Type, 4>",
+                     initOS.str());
+}
+
+StringRef PatternEmitter::getOperationNameConstant(StringRef name) {
+  return getConstant("opName", "::mlir::OperationName",
+                     "::mlir::OperationName(" + getStringLiteral(name) +
+                         ", context)");
+}
+
+StringRef PatternEmitter::getStringAttrConstant(StringRef str) {
+  return getConstant("name", "::mlir::StringAttr",
+                     "::mlir::StringAttr::get(context, " +
+                         getStringLiteral(str) + ")");
+}
+
+StringRef
+PatternEmitter::getConstParamsConstant(Optional<ArrayAttr> constParams) {
+  if (!constParams)
+    return "::mlir::ArrayAttr()";
+  return getArrayAttrConstant(*constParams);
+}
+
+//===----------------------------------------------------------------------===//
+// Operations
+
+void PatternEmitter::emit(pdl_interp::ApplyConstraintOp op) {
+  StringRef fn = getConstant(
+      "constraint", "::mlir::PDLConstraintFunction",
+      "::mlir::pdl_cpp::lookupConstraintFunction(functions, " +
+          getStringLiteral(op.name()) + ")");
+  emitCondBranch(formatv("::mlir::succeeded({0}({1}, {2}, rewriter))", fn,
+                         getNativeArgs(op.args()),
+                         getConstParamsConstant(op.constParams())),
+                 op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::ApplyRewriteOp op) {
+  StringRef fn = getConstant(
+      "rewrite", "::mlir::PDLRewriteFunction",
+      "::mlir::pdl_cpp::lookupRewriteFunction(functions, " +
+          getStringLiteral(op.name()) + ")");
+
+  // The results refer to the storage of the list, which is kept alive until
+  // the end of the rewrite.
+  std::string results = ("results" + Twine(numResultLists++)).str();
+  *os << formatv("::mlir::pdl_cpp::RewriteResultList {0}({1});\n", results,
+                 op.getNumResults());
+  *os << formatv("{0}({1}, {2}, rewriter, {3});\n", fn,
+                 getNativeArgs(op.args()),
+                 getConstParamsConstant(op.constParams()), results);
+  for (OpResult result : op.getResults()) {
+    emitAssign(result,
+               formatv("{0}.getResult<{1}>({2})", results,
+                       getNativeResultCppType(result.getType()),
+                       result.getResultNumber()));
+  }
+}
+
+void PatternEmitter::emit(pdl_interp::AreEqualOp op) {
+  StringRef lhs = getName(op.lhs()), rhs = getName(op.rhs());
+  if (isOptionalRange(op.lhs().getType())) {
+    emitCondBranch(formatv("{0} && {1} && *{0} == *{1}", lhs, rhs),
+                   op.trueDest(), op.falseDest());
+  } else {
+    emitCondBranch(lhs + " == " + rhs, op.trueDest(), op.falseDest());
+  }
+}
+
+void PatternEmitter::emit(pdl_interp::BranchOp op) { emitBranch(op.dest()); }
+
+void PatternEmitter::emit(pdl_interp::CheckAttributeOp op) {
+  emitCondBranch(getName(op.attribute()) + " == " +
+                     getAttrConstant(op.constantValue()),
+                 op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::CheckOperandCountOp op) {
+  emitCondBranch(formatv("{0}->getNumOperands() {1} {2}",
+                         getName(op.operation()),
+                         op.compareAtLeast() ? ">=" : "==", op.count()),
+                 op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::CheckOperationNameOp op) {
+  emitCondBranch(getName(op.operation()) + "->getName() == " +
+                     getOperationNameConstant(op.name()),
+                 op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::CheckResultCountOp op) {
+  emitCondBranch(formatv("{0}->getNumResults() {1} {2}",
+                         getName(op.operation()),
+                         op.compareAtLeast() ? ">=" : "==", op.count()),
+                 op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::CheckTypeOp op) {
+  emitCondBranch(getName(op.value()) + " == " + getTypeConstant(op.type()),
+                 op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::CheckTypesOp op) {
+  emitCondBranch(formatv("{0} && *{0} == ::mlir::TypeRange({1})",
+                         getName(op.value()), getTypesConstant(op.types())),
+                 op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::ContinueOp op) {
+  *os << "continue;\n";
+}
+
+void PatternEmitter::emit(pdl_interp::CreateAttributeOp op) {
+  emitAssign(op.attribute(), getAttrConstant(op.value()));
+}
+
+void PatternEmitter::emit(pdl_interp::CreateOperationOp op) {
+  *os << "{\n";
+  os->indent();
+  *os << formatv("::mlir::OperationState state(loc, {0});\n",
+                 getOperationNameConstant(op.name()));
+  for (Value operand : op.operands()) {
+    if (isOptionalRange(operand.getType()))
+      *os << formatv("state.addOperands(*{0});\n", getName(operand));
+    else
+      *os << formatv("state.addOperands({0});\n", getName(operand));
+  }
+  for (auto it : llvm::zip(op.attributeNames(), op.attributes())) {
+    *os << formatv("if ({0})\n", getName(std::get<1>(it)));
+    *os << formatv("  state.addAttribute({0}, {1});\n",
+                   getStringAttrConstant(
+                       std::get<0>(it).cast<StringAttr>().getValue()),
+                   getName(std::get<1>(it)));
+  }
+  for (Value type : op.types()) {
+    // A range of inferred types signals that the result types are inferred
+    // from the rest of the operation.
+    if (type.getDefiningOp<pdl_interp::InferredTypesOp>()) {
+      *os << "if (::mlir::failed(::mlir::pdl_cpp::inferResultTypes(state)))\n"
+          << "  return ::mlir::failure();\n";
+      break;
+    }
+    if (isOptionalRange(type.getType()))
+      *os << formatv("state.types.append({0}->begin(), {0}->end());\n",
+                     getName(type));
+    else
+      *os << formatv("state.types.push_back({0});\n", getName(type));
+  }
+  if (op.operation().use_empty())
+    *os << "rewriter.createOperation(state);\n";
+  else
+    emitAssign(op.operation(), "rewriter.createOperation(state)");
+  os->unindent();
+  *os << "}\n";
+}
+
+void PatternEmitter::emit(pdl_interp::CreateTypeOp op) {
+  emitAssign(op.result(), getTypeConstant(op.value()));
+}
+
+void PatternEmitter::emit(pdl_interp::CreateTypesOp op) {
+  emitAssign(op.result(),
+             "::mlir::TypeRange(" + getTypesConstant(op.value()) + ")");
+}
+
+void PatternEmitter::emit(pdl_interp::EraseOp op) {
+  *os << formatv("rewriter.eraseOp({0});\n", getName(op.operation()));
+}
+
+void PatternEmitter::emit(pdl_interp::ExtractOp op) {
+  StringRef range = getName(op.range());
+  if (!isOptionalRange(op.range().getType())) {
+    emitAssign(op.result(), formatv("{0} < {1}.size() ? {1}[{0}] : nullptr",
+                                    op.index(), range));
+    return;
+  }
+  emitAssign(op.result(),
+             formatv("{1} && {0} < {1}->size() ? (*{1})[{0}] : {2}()",
+                     op.index(), range, getCppType(op.result().getType())));
+}
+
+void PatternEmitter::emit(pdl_interp::FinalizeOp op) {
+  // Finalizing the matcher signals that the pattern didn't match, while
+  // finalizing the rewriter signals the successful end of the rewrite.
+  if (op->getParentOp() == matcherFunc.getOperation())
+    *os << "return ::mlir::failure();\n";
+  else
+    *os << "return ::mlir::success();\n";
+}
+
+void PatternEmitter::emit(pdl_interp::ForEachOp op) {
+  Block *body = &op.region().front();
+  BlockArgument arg = body->getArgument(0);
+  *os << formatv("for ({0} : {1}) {{\n", getDecl(arg.getType(), getName(arg)),
+                 getName(op.values()));
+  os->indent();
+  emitBlocks(op.region());
+  os->unindent();
+  *os << "}\n";
+  emitBranch(op.successor());
+}
+
+void PatternEmitter::emit(pdl_interp::GetAttributeOp op) {
+  emitAssign(op.attribute(),
+             formatv("{0}->getAttr({1})", getName(op.operation()),
+                     getStringAttrConstant(op.name())));
+}
+
+void PatternEmitter::emit(pdl_interp::GetAttributeTypeOp op) {
+  emitAssign(op.result(), formatv("{0} ? {0}.getType() : ::mlir::Type()",
+                                  getName(op.value())));
+}
+
+void PatternEmitter::emit(pdl_interp::GetDefiningOpOp op) {
+  StringRef value = getName(op.value());
+  if (isOptionalRange(op.value().getType())) {
+    emitAssign(op.operation(),
+               formatv("{0} && !{0}->empty() ? {0}->front().getDefiningOp() "
+                       ": nullptr",
+                       value));
+  } else {
+    emitAssign(op.operation(),
+               formatv("{0} ? {0}.getDefiningOp() : nullptr", value));
+  }
+}
+
+void PatternEmitter::emit(pdl_interp::GetOperandOp op) {
+  emitAssign(op.value(),
+             formatv("{0} < {1}->getNumOperands() ? {1}->getOperand({0}) "
+                     ": ::mlir::Value()",
+                     op.index(), getName(op.operation())));
+}
+
+void PatternEmitter::emit(pdl_interp::GetOperandsOp op) {
+  std::string values;
+  if (Optional<uint32_t> index = op.index())
+    values = formatv("::mlir::pdl_cpp::getOperandGroup({0}, {1})",
+                     getName(op.operation()), *index);
+  else
+    values = formatv("::mlir::ValueRange({0}->getOperands())",
+                     getName(op.operation()));
+  if (isOptionalRange(op.value().getType()))
+    emitAssign(op.value(), values);
+  else
+    emitAssign(op.value(), "::mlir::pdl_cpp::getSingleValue(" + values + ")");
+}
+
+void PatternEmitter::emit(pdl_interp::GetResultOp op) {
+  emitAssign(op.value(),
+             formatv("{0} < {1}->getNumResults() ? {1}->getResult({0}) "
+                     ": ::mlir::Value()",
+                     op.index(), getName(op.operation())));
+}
+
+void PatternEmitter::emit(pdl_interp::GetResultsOp op) {
+  std::string values;
+  if (Optional<uint32_t> index = op.index())
+    values = formatv("::mlir::pdl_cpp::getResultGroup({0}, {1})",
+                     getName(op.operation()), *index);
+  else
+    values = formatv("::mlir::ValueRange({0}->getResults())",
+                     getName(op.operation()));
+  if (isOptionalRange(op.value().getType()))
+    emitAssign(op.value(), values);
+  else
+    emitAssign(op.value(), "::mlir::pdl_cpp::getSingleValue(" + values + ")");
+}
+
+void PatternEmitter::emit(pdl_interp::GetUsersOp op) {
+  if (op.operations().use_empty())
+    return;
+  StringRef users = getName(op.operations());
+  *os << users << ".clear();\n";
+  *os << formatv("::mlir::pdl_cpp::appendUsers({0}, {1});\n", users,
+                 getName(op.value()));
+}
+
+void PatternEmitter::emit(pdl_interp::GetValueTypeOp op) {
+  StringRef value = getName(op.value());
+  if (isOptionalRange(op.value().getType()))
+    emitAssign(op.result(), "::mlir::pdl_cpp::getTypes(" + value + ")");
+  else
+    emitAssign(op.result(),
+               formatv("{0} ? {0}.getType() : ::mlir::Type()", value));
+}
+
+void PatternEmitter::emit(pdl_interp::IsNotNullOp op) {
+  emitCondBranch(getName(op.value()), op.trueDest(), op.falseDest());
+}
+
+void PatternEmitter::emit(pdl_interp::RecordMatchOp op) {
+  // A successful match is rewritten immediately, with a location fused from
+  // the locations of the matched operations.
+  *os << "{\n";
+  os->indent();
+  *os << "::mlir::Location loc = rewriter.getFusedLoc({";
+  llvm::interleaveComma(op.matchedOps(), *os, [&](Value matchedOp) {
+    *os << getName(matchedOp) << "->getLoc()";
+  });
+  *os << "});\n";
+  *os << "return applyRewrite(rewriter, loc";
+  for (Value input : op.inputs())
+    *os << ", " << getName(input);
+  *os << ");\n";
+  os->unindent();
+  *os << "}\n";
+}
+
+void PatternEmitter::emit(pdl_interp::ReplaceOp op) {
+  *os << "{\n";
+  os->indent();
+  *os << "::llvm::SmallVector<::mlir::Value, 4> replValues;\n";
+  for (Value value : op.replValues()) {
+    if (isOptionalRange(value.getType()))
+      *os << formatv("replValues.append({0}->begin(), {0}->end());\n",
+                     getName(value));
+    else
+      *os << formatv("replValues.push_back({0});\n", getName(value));
+  }
+  *os << formatv("rewriter.replaceOp({0}, replValues);\n",
+                 getName(op.operation()));
+  os->unindent();
+  *os << "}\n";
+}
+
+void PatternEmitter::emit(pdl_interp::SwitchAttributeOp op) {
+  SmallVector<std::string> caseValues = llvm::to_vector(
+      llvm::map_range(op.caseValues(), [&](Attribute attr) {
+        return getAttrConstant(attr).str();
+      }));
+  emitSwitch(getName(op.attribute()), caseValues, op.defaultDest(),
+             op.cases());
+}
+
+void PatternEmitter::emit(pdl_interp::SwitchOperandCountOp op) {
+  emitSwitch((getName(op.operation()) + "->getNumOperands()").str(),
+             op.caseValues(), op.defaultDest(), op.cases());
+}
+
+void PatternEmitter::emit(pdl_interp::SwitchOperationNameOp op) {
+  SmallVector<std::string> caseValues = llvm::to_vector(llvm::map_range(
+      op.caseValues().getAsValueRange<StringAttr>(), [&](StringRef name) {
+        return getOperationNameConstant(name).str();
+      }));
+  emitSwitch((getName(op.operation()) + "->getName()").str(), caseValues,
+             op.defaultDest(), op.cases());
+}
+
+void PatternEmitter::emit(pdl_interp::SwitchResultCountOp op) {
+  emitSwitch((getName(op.operation()) + "->getNumResults()").str(),
+             op.caseValues(), op.defaultDest(), op.cases());
+}
+
+void PatternEmitter::emit(pdl_interp::SwitchTypeOp op) {
+  SmallVector<std::string> caseValues = llvm::to_vector(llvm::map_range(
+      op.caseValues().getAsValueRange<TypeAttr>(),
+      [&](Type type) { return getTypeConstant(type).str(); }));
+  emitSwitch(getName(op.value()), caseValues, op.defaultDest(), op.cases());
+}
+
+void PatternEmitter::emit(pdl_interp::SwitchTypesOp op) {
+  SmallVector<std::string> caseValues = llvm::to_vector(
+      llvm::map_range(op.caseValues().getAsRange<ArrayAttr>(),
+                      [&](ArrayAttr types) {
+                        return getTypesConstant(types).str();
+                      }));
+  emitSwitch(getName(op.value()), caseValues, op.defaultDest(), op.cases(),
+             "{0} && *{0} == ::mlir::TypeRange({1})");
+}
+
+//===----------------------------------------------------------------------===//
+// Translation
+//===----------------------------------------------------------------------===//
+
+LogicalResult pdl::translateToCpp(ModuleOp module, raw_ostream &os,
+                                  StringRef populateFnName) {
+  MLIRContext *context = module.getContext();
+  raw_indented_ostream classOS(os);
+  classOS << "// Native rewrite patterns generated from PDL patterns. Do not "
+             "edit!\n\n"
+          << "namespace {\n";
+
+  SmallVector<std::string> classNames;
+  llvm::StringSet<> usedClassNames;
+  for (auto it : llvm::enumerate(module.getOps<pdl::PatternOp>())) {
+    pdl::PatternOp pattern = it.value();
+
+    // Lower the pattern on its own, so that it can be matched independently
+    // of the other patterns.
+    OwningOpRef<ModuleOp> patternModule = ModuleOp::create(pattern.getLoc());
+    patternModule->push_back(pattern->clone());
+    PassManager pm(context);
+    pm.addPass(createPDLToPDLInterpPass());
+    if (failed(pm.run(*patternModule)))
+      return pattern.emitError("failed to lower pattern to the PDL "
+                               "interpreter dialect");
+
+    auto matcherFunc = patternModule->lookupSymbol<FuncOp>(
+        pdl_interp::PDLInterpDialect::getMatcherFunctionName());
+    pdl_interp::RecordMatchOp matchOp;
+    matcherFunc.walk([&](pdl_interp::RecordMatchOp op) { matchOp = op; });
+    if (!matchOp)
+      return pattern.emitError("pattern doesn't record any match");
+    auto rewriterFunc = SymbolTable::lookupNearestSymbolFrom<FuncOp>(
+        matchOp, matchOp.rewriter());
+
+    // Name the class after the pattern, making sure that the name is unique.
+    Optional<StringRef> patternName = pattern.sym_name();
+    std::string className =
+        patternName ? getClassName(*patternName) + "Pattern"
+                    : ("GeneratedPDLPattern" + Twine(it.index())).str();
+    while (!usedClassNames.insert(className).second)
+      className += "_";
+
+    classOS << "// Generated from the PDL pattern at " << pattern.getLoc()
+            << ".\n";
+    PatternEmitter(matcherFunc, rewriterFunc, matchOp)
+        .emit(classOS, className, patternName);
+    classNames.push_back(std::move(className));
+  }
+  classOS << "} // namespace\n\n";
+
+  // Emit the function populating a pattern set with the generated patterns.
+  classOS << formatv("static void LLVM_ATTRIBUTE_UNUSED {0}(\n"
+                     "    ::mlir::RewritePatternSet &patterns,\n"
+                     "    const ::mlir::PDLPatternModule &functions = "
+                     "::mlir::PDLPatternModule()) {{\n",
+                     populateFnName);
+  for (StringRef className : classNames)
+    classOS << formatv("  patterns.add<{0}>(patterns.getContext(), "
+                       "functions);\n",
+                       className);
+  classOS << "}\n";
+  return success();
+}
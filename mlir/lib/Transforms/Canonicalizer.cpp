@@ -40,6 +40,9 @@ struct Canonicalizer : public CanonicalizerBase<Canonicalizer> {
   /// Initialize the canonicalizer by building the set of patterns used during
   /// execution.
   LogicalResult initialize(MLIRContext *context) override {
+    if (parallelizeIsolatedRegions)
+      config.parallelizeIsolatedRegions = true;
+
     RewritePatternSet owningPatterns(context);
     for (auto *dialect : context->getLoadedDialects())
       dialect->getCanonicalizationPatterns(owningPatterns);
@@ -51,8 +54,18 @@ struct Canonicalizer : public CanonicalizerBase<Canonicalizer> {
     return success();
   }
   void runOnOperation() override {
+    GreedyRewriteStatistics stats;
+    GreedyRewriteConfig runConfig = config;
+    runConfig.statistics = &stats;
     (void)applyPatternsAndFoldGreedily(getOperation()->getRegions(), patterns,
-                                       config);
+                                       runConfig);
+
+    numIterations += stats.numIterations;
+    numRewrites += stats.numPatternsApplied;
+    numFolded += stats.numFolded;
+    numErasedDead += stats.numErasedDead;
+    numWorklistAdditions += stats.numWorklistAdditions;
+    numWorklistDuplicates += stats.numWorklistDuplicates;
   }
 
   GreedyRewriteConfig config;
@@ -236,18 +236,32 @@ struct RewriterState {
 
 /// The state of an operation that was updated by a pattern in-place. This
 /// contains all of the necessary information to reconstruct an operation that
-/// was updated in place.
+/// was updated in place, unless the state wasn't saved because patterns are
+/// not rolled back.
 class OperationTransactionState {
 public:
   OperationTransactionState() = default;
-  OperationTransactionState(Operation *op)
-      : op(op), loc(op->getLoc()), attrs(op->getAttrDictionary()),
-        operands(op->operand_begin(), op->operand_end()),
-        successors(op->successor_begin(), op->successor_end()) {}
+  OperationTransactionState(Operation *op, bool saveState = true) : op(op) {
+    if (!saveState)
+      return;
+    loc = op->getLoc();
+    attrs = op->getAttrDictionary();
+    operands.assign(op->operand_begin(), op->operand_end());
+    successors.assign(op->successor_begin(), op->successor_end());
+  }
+
+  /// Returns true if the original state of the operation was saved, and can
+  /// thus be restored.
+  bool canResetOperation() const { return static_cast<bool>(attrs); }
 
   /// Discard the transaction state and reset the state of the original
   /// operation.
   void resetOperation() const {
+    if (!canResetOperation())
+      llvm::report_fatal_error(
+          "unable to roll back the in-place update of operation '" +
+          op->getName().getStringRef() +
+          "', as pattern rollback is disabled for this conversion");
     op->setLoc(loc);
     op->setAttrs(attrs);
     op->setOperands(operands);
@@ -999,6 +1013,10 @@ struct ConversionPatternRewriterImpl {
   /// A transaction state for each of operations that were updated in-place.
   SmallVector<OperationTransactionState, 4> rootUpdates;
 
+  /// Whether the changes of the patterns may be rolled back. If not, the
+  /// original state of operations updated in place is not recorded.
+  bool allowPatternRollback = true;
+
   /// A vector of indices into `replacements` of operations that were replaced
   /// with values with different result types than the original operation, e.g.
   /// 1->N conversion of some kind.
@@ -1045,9 +1063,10 @@ static void detachNestedAndErase(Operation *op) {
 }
 
 void ConversionPatternRewriterImpl::discardRewrites() {
-  // Reset any operations that were updated in place.
+  // Reset any operations that were updated in place, if their state was saved.
   for (auto &state : rootUpdates)
-    state.resetOperation();
+    if (state.canResetOperation())
+      state.resetOperation();
 
   undoBlockActions();
 
@@ -1645,7 +1664,7 @@ void ConversionPatternRewriter::startRootUpdate(Operation *op) {
 #ifndef NDEBUG
   impl->pendingRootUpdates.insert(op);
 #endif
-  impl->rootUpdates.emplace_back(op);
+  impl->rootUpdates.emplace_back(op, impl->allowPatternRollback);
 }
 
 void ConversionPatternRewriter::finalizeRootUpdate(Operation *op) {
@@ -1667,7 +1686,10 @@ void ConversionPatternRewriter::cancelRootUpdate(Operation *op) {
   auto &rootUpdates = impl->rootUpdates;
   auto it = llvm::find_if(llvm::reverse(rootUpdates), stateHasOp);
   assert(it != rootUpdates.rend() && "no root update started on op");
-  (*it).resetOperation();
+  // Without a saved state, the pattern is expected to have restored the
+  // operation itself, as with other pattern rewriters.
+  if (it->canResetOperation())
+    it->resetOperation();
   int updateIdx = std::prev(rootUpdates.rend()) - it;
   rootUpdates.erase(rootUpdates.begin() + updateIdx);
 }
@@ -2347,8 +2369,14 @@ struct OperationConverter {
   explicit OperationConverter(ConversionTarget &target,
                               const FrozenRewritePatternSet &patterns,
                               OpConversionMode mode,
-                              DenseSet<Operation *> *trackedOps = nullptr)
-      : opLegalizer(target, patterns), mode(mode), trackedOps(trackedOps) {}
+                              DenseSet<Operation *> *trackedOps = nullptr,
+                              ConversionConfig config = ConversionConfig())
+      : opLegalizer(target, patterns), mode(mode), trackedOps(trackedOps),
+        config(config) {
+    assert((mode != OpConversionMode::Analysis ||
+            config.allowPatternRollback) &&
+           "analysis conversions must roll back patterns");
+  }
 
   /// Converts the given operations to the conversion target.
   LogicalResult
@@ -2398,6 +2426,9 @@ private:
   /// When mode == OpConversionMode::Partial, this is populated with ops found
   /// *not* to be legalizable to the target.
   DenseSet<Operation *> *trackedOps;
+
+  /// The configuration of the conversion.
+  ConversionConfig config;
 };
 } // namespace
 
@@ -2451,11 +2482,18 @@ LogicalResult OperationConverter::convertOperations(
   ConversionPatternRewriter rewriter(ops.front()->getContext());
   ConversionPatternRewriterImpl &rewriterImpl = rewriter.getImpl();
   rewriterImpl.notifyCallback = notifyCallback;
+  rewriterImpl.allowPatternRollback = config.allowPatternRollback;
 
-  for (auto *op : toConvert)
+  for (auto *op : toConvert) {
     if (failed(convert(rewriter, op)))
       return rewriterImpl.discardRewrites(), failure();
 
+    // Without rollback, the operations updated in place only need to be
+    // tracked until the operation that triggered the updates is legalized.
+    if (!config.allowPatternRollback)
+      rewriterImpl.rootUpdates.clear();
+  }
+
   // Now that all of the operations have been converted, finalize the conversion
   // process to ensure any lingering conversion artifacts are cleaned up and
   // legalized.
@@ -3259,17 +3297,19 @@ LogicalResult
 mlir::applyPartialConversion(ArrayRef<Operation *> ops,
                              ConversionTarget &target,
                              const FrozenRewritePatternSet &patterns,
-                             DenseSet<Operation *> *unconvertedOps) {
+                             DenseSet<Operation *> *unconvertedOps,
+                             ConversionConfig config) {
   OperationConverter opConverter(target, patterns, OpConversionMode::Partial,
-                                 unconvertedOps);
+                                 unconvertedOps, config);
   return opConverter.convertOperations(ops);
 }
 LogicalResult
 mlir::applyPartialConversion(Operation *op, ConversionTarget &target,
                              const FrozenRewritePatternSet &patterns,
-                             DenseSet<Operation *> *unconvertedOps) {
+                             DenseSet<Operation *> *unconvertedOps,
+                             ConversionConfig config) {
   return applyPartialConversion(llvm::makeArrayRef(op), target, patterns,
-                                unconvertedOps);
+                                unconvertedOps, config);
 }
 
 //===----------------------------------------------------------------------===//
@@ -3277,14 +3317,17 @@ mlir::applyPartialConversion(Operation *op, ConversionTarget &target,
 
 LogicalResult
 mlir::applyFullConversion(ArrayRef<Operation *> ops, ConversionTarget &target,
-                          const FrozenRewritePatternSet &patterns) {
-  OperationConverter opConverter(target, patterns, OpConversionMode::Full);
+                          const FrozenRewritePatternSet &patterns,
+                          ConversionConfig config) {
+  OperationConverter opConverter(target, patterns, OpConversionMode::Full,
+                                 /*trackedOps=*/nullptr, config);
   return opConverter.convertOperations(ops);
 }
 LogicalResult
 mlir::applyFullConversion(Operation *op, ConversionTarget &target,
-                          const FrozenRewritePatternSet &patterns) {
-  return applyFullConversion(llvm::makeArrayRef(op), target, patterns);
+                          const FrozenRewritePatternSet &patterns,
+                          ConversionConfig config) {
+  return applyFullConversion(llvm::makeArrayRef(op), target, patterns, config);
 }
 
 //===----------------------------------------------------------------------===//
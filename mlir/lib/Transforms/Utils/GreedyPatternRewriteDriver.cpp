@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Rewrite/PatternApplicator.h"
 #include "mlir/Transforms/FoldUtils.h"
@@ -38,8 +39,11 @@ public:
                                       const FrozenRewritePatternSet &patterns,
                                       const GreedyRewriteConfig &config);
 
-  /// Simplify the operations within the given regions.
-  bool simplify(MutableArrayRef<Region> regions);
+  /// Simplify the operations within the given regions. If
+  /// `skipIsolatedChildren` is set, the regions of the IsolatedFromAbove
+  /// operations directly nested in `regions` are not visited.
+  bool simplify(MutableArrayRef<Region> regions,
+                bool skipIsolatedChildren = false);
 
   /// Add the given operation to the worklist.
   void addToWorklist(Operation *op);
@@ -96,6 +100,14 @@ private:
   /// Configuration information for how to simplify.
   GreedyRewriteConfig config;
 
+  /// Counts of the work done, added to config.statistics when done.
+  uint64_t numIterations = 0;
+  uint64_t numPatternsApplied = 0;
+  uint64_t numFolded = 0;
+  uint64_t numErasedDead = 0;
+  uint64_t numWorklistAdditions = 0;
+  uint64_t numWorklistDuplicates = 0;
+
 #ifndef NDEBUG
   /// A logger used to emit information during the application process.
   llvm::ScopedPrinter logger{llvm::dbgs()};
@@ -113,7 +125,14 @@ GreedyPatternRewriteDriver::GreedyPatternRewriteDriver(
   matcher.applyDefaultCostModel();
 }
 
-bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
+/// Returns true if `op` is simplified by its own driver in parallel mode.
+static bool isIsolatedChild(Operation &op) {
+  return op.getNumRegions() != 0 &&
+         op.hasTrait<OpTrait::IsIsolatedFromAbove>();
+}
+
+bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions,
+                                          bool skipIsolatedChildren) {
 #ifndef NDEBUG
   const char *logLineComment =
       "//===-------------------------------------------===//\n";
@@ -137,8 +156,32 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
   do {
     worklist.clear();
     worklistMap.clear();
-
-    if (!config.useTopDownTraversal) {
+    ++numIterations;
+
+    if (skipIsolatedChildren) {
+      // Add the isolated children themselves, but not their nested
+      // operations, which have been simplified already.
+      auto addOp = [this](Operation *op) { addToWorklist(op); };
+      for (auto &region : regions) {
+        for (Block &block : region) {
+          for (Operation &op : block) {
+            if (isIsolatedChild(op))
+              addToWorklist(&op);
+            else if (!config.useTopDownTraversal)
+              op.walk(addOp);
+            else
+              op.walk<WalkOrder::PreOrder>(addOp);
+          }
+        }
+      }
+      // Reverse the top-down list so our pop-back loop processes the
+      // operations in order.
+      if (config.useTopDownTraversal) {
+        std::reverse(worklist.begin(), worklist.end());
+        for (size_t i = 0, e = worklist.size(); i != e; ++i)
+          worklistMap[worklist[i]] = i;
+      }
+    } else if (!config.useTopDownTraversal) {
       // Add operations to the worklist in postorder.
       for (auto &region : regions)
         region.walk([this](Operation *op) { addToWorklist(op); });
@@ -147,6 +190,7 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
       for (auto &region : regions)
         region.walk<WalkOrder::PreOrder>(
             [this](Operation *op) { worklist.push_back(op); });
+      numWorklistAdditions += worklist.size();
 
       // Reverse the list so our pop-back loop processes them in-order.
       std::reverse(worklist.begin(), worklist.end());
@@ -188,6 +232,7 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
         notifyOperationRemoved(op);
         op->erase();
         changed = true;
+        ++numErasedDead;
 
         LLVM_DEBUG(logResultWithLine("success", "operation is trivially dead"));
         continue;
@@ -219,6 +264,7 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
         LLVM_DEBUG(logResultWithLine("success", "operation was folded"));
 
         changed = true;
+        ++numFolded;
         if (!inPlaceUpdate)
           continue;
       }
@@ -255,7 +301,10 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
 #else
       LogicalResult matchResult = matcher.matchAndRewrite(op, *this);
 #endif
-      changed |= succeeded(matchResult);
+      if (succeeded(matchResult)) {
+        changed = true;
+        ++numPatternsApplied;
+      }
     }
 
     // After applying patterns, make sure that the CFG of each of the regions
@@ -266,17 +315,29 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
            (++iteration < config.maxIterations ||
             config.maxIterations == GreedyRewriteConfig::kNoIterationLimit));
 
+  if (GreedyRewriteStatistics *stats = config.statistics) {
+    stats->numIterations += numIterations;
+    stats->numPatternsApplied += numPatternsApplied;
+    stats->numFolded += numFolded;
+    stats->numErasedDead += numErasedDead;
+    stats->numWorklistAdditions += numWorklistAdditions;
+    stats->numWorklistDuplicates += numWorklistDuplicates;
+  }
+
   // Whether the rewrite converges, i.e. wasn't changed in the last iteration.
   return !changed;
 }
 
 void GreedyPatternRewriteDriver::addToWorklist(Operation *op) {
   // Check to see if the worklist already contains this op.
-  if (worklistMap.count(op))
+  if (worklistMap.count(op)) {
+    ++numWorklistDuplicates;
     return;
+  }
 
   worklistMap[op] = worklist.size();
   worklist.push_back(op);
+  ++numWorklistAdditions;
 }
 
 Operation *GreedyPatternRewriteDriver::popFromWorklist() {
@@ -380,9 +441,34 @@ mlir::applyPatternsAndFoldGreedily(MutableArrayRef<Region> regions,
   assert(llvm::all_of(regions, regionIsIsolated) &&
          "patterns can only be applied to operations IsolatedFromAbove");
 
+  MLIRContext *ctx = regions[0].getContext();
+  bool converged = true;
+  bool skipIsolatedChildren = false;
+  if (config.parallelizeIsolatedRegions && ctx->isMultithreadingEnabled()) {
+    SmallVector<Operation *> isolatedChildren;
+    for (Region &region : regions)
+      for (Block &block : region)
+        for (Operation &op : block)
+          if (isIsolatedChild(op))
+            isolatedChildren.push_back(&op);
+
+    // The isolated children can't refer to each other's values, so each of
+    // them can be simplified by its own driver.
+    if (isolatedChildren.size() > 1) {
+      std::atomic<bool> allConverged(true);
+      parallelForEach(ctx, isolatedChildren, [&](Operation *op) {
+        GreedyPatternRewriteDriver driver(ctx, patterns, config);
+        if (!driver.simplify(op->getRegions()))
+          allConverged = false;
+      });
+      converged = allConverged;
+      skipIsolatedChildren = true;
+    }
+  }
+
   // Start the pattern driver.
-  GreedyPatternRewriteDriver driver(regions[0].getContext(), patterns, config);
-  bool converged = driver.simplify(regions);
+  GreedyPatternRewriteDriver driver(ctx, patterns, config);
+  converged &= driver.simplify(regions, skipIsolatedChildren);
   LLVM_DEBUG(if (!converged) {
     llvm::dbgs() << "The pattern rewrite doesn't converge after scanning "
                  << config.maxIterations << " times\n";
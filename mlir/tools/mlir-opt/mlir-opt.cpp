@@ -108,6 +108,7 @@ void registerTestPreparationPassWithAllowedMemrefResults();
 void registerTestRecursiveTypesPass();
 void registerTestSCFUtilsPass();
 void registerTestSliceAnalysisPass();
+void registerTestStorageUniquingPass();
 void registerTestVectorLowerings();
 } // namespace test
 } // namespace mlir
@@ -198,6 +199,7 @@ void registerTestPasses() {
   mlir::test::registerTestRecursiveTypesPass();
   mlir::test::registerTestSCFUtilsPass();
   mlir::test::registerTestSliceAnalysisPass();
+  mlir::test::registerTestStorageUniquingPass();
   mlir::test::registerTestVectorLowerings();
 }
 #endif
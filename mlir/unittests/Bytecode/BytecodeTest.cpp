@@ -0,0 +1,215 @@
+//===- BytecodeTest.cpp - MLIR bytecode unit tests ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Bytecode/BytecodeReader.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Parser.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <numeric>
+
+using namespace mlir;
+
+static const char *const irWithCFG = R"mlir(
+module {
+  func @cfg(%arg0: i32) -> i32 {
+    "test.br"(%arg0)[^bb2] : (i32) -> ()
+  ^bb1(%0: i32):
+    "test.return"(%1) : (i32) -> ()
+  ^bb2(%2: i32):
+    %1 = "test.add"(%2, %2) {attr = dense<[1, 2, 3, 4]> : tensor<4xi32>}
+        : (i32, i32) -> i32
+        loc(fused<"cse">["a.mlir":1:2, callsite("f"("b.mlir":3:4) at "c":5:6)])
+    "test.br"(%1)[^bb1] : (i32) -> ()
+  }
+  module @nested {
+    "test.op"() {splat = dense<1.0> : tensor<8xf32>, str = "text", unit}
+        : () -> ()
+  }
+}
+)mlir";
+
+static std::string print(Operation *op) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  op->print(os, OpPrintingFlags().enableDebugInfo());
+  return os.str();
+}
+
+static std::string writeBytecode(Operation *op) {
+  std::string bytecode;
+  llvm::raw_string_ostream os(bytecode);
+  writeBytecodeToFile(op, os);
+  return os.str();
+}
+
+namespace {
+TEST(BytecodeTest, RoundTrip) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString(irWithCFG, &context);
+  ASSERT_TRUE(module);
+
+  std::string bytecode = writeBytecode(*module);
+  llvm::MemoryBufferRef buffer(bytecode, "test");
+  EXPECT_TRUE(isBytecode(buffer));
+
+  Block block;
+  ASSERT_TRUE(succeeded(readBytecodeFile(buffer, &block, &context)));
+  ASSERT_TRUE(llvm::hasSingleElement(block));
+  OwningOpRef<ModuleOp> readModule = cast<ModuleOp>(block.front());
+  readModule->getOperation()->remove();
+  EXPECT_EQ(print(*module), print(*readModule));
+}
+
+TEST(BytecodeTest, BlobAlignment) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString(irWithCFG, &context);
+  ASSERT_TRUE(module);
+
+  // The raw data of the elements attribute is stored aligned in the file.
+  std::string bytecode = writeBytecode(*module);
+  const int32_t data[] = {1, 2, 3, 4};
+  size_t pos =
+      StringRef(bytecode).find(StringRef((const char *)data, sizeof(data)));
+  ASSERT_NE(pos, StringRef::npos);
+  EXPECT_EQ(pos % 64, 0u);
+}
+
+TEST(BytecodeTest, LazyLoading) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString(irWithCFG, &context);
+  ASSERT_TRUE(module);
+
+  std::string bytecode = writeBytecode(*module);
+  BytecodeReader reader(llvm::MemoryBufferRef(bytecode, "test"), &context,
+                        /*lazyLoading=*/true);
+  Block block;
+  ASSERT_TRUE(succeeded(reader.read(&block)));
+
+  // Only the top-level module has been read.
+  ASSERT_TRUE(llvm::hasSingleElement(block));
+  OwningOpRef<ModuleOp> readModule = cast<ModuleOp>(block.front());
+  Operation *topLevel = readModule->getOperation();
+  topLevel->remove();
+  EXPECT_TRUE(reader.isMaterializable(topLevel));
+  EXPECT_TRUE(topLevel->getRegion(0).empty());
+  EXPECT_EQ(reader.getNumMaterializable(), 1u);
+
+  // Reading it exposes the function and the nested module.
+  ASSERT_TRUE(succeeded(reader.materialize(topLevel)));
+  EXPECT_FALSE(reader.isMaterializable(topLevel));
+  EXPECT_EQ(reader.getNumMaterializable(), 2u);
+
+  ASSERT_TRUE(succeeded(reader.materializeAll()));
+  EXPECT_EQ(reader.getNumMaterializable(), 0u);
+  EXPECT_EQ(print(*module), print(topLevel));
+}
+
+TEST(BytecodeTest, DenseResource) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString(
+      R"mlir(
+    "test.op"() {attr = dense_resource<"weights"> : tensor<16384xi32>}
+        : () -> ()
+  )mlir",
+      &context);
+  ASSERT_TRUE(module);
+
+  // Provide the data of the resource, which the bytecode stores. It is large
+  // enough for the file to be memory mapped when read.
+  std::vector<int32_t> data(16384);
+  std::iota(data.begin(), data.end(), 0);
+  ResourceBlobManager &manager = context.getResourceBlobManager();
+  manager.lookup("weights")->setBlob(ResourceBlob::createUnowned(
+      ArrayRef<char>(reinterpret_cast<const char *>(data.data()),
+                     data.size() * sizeof(int32_t)),
+      alignof(int32_t)));
+  std::string bytecode = writeBytecode(*module);
+
+  SmallString<128> path;
+  int fd;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("bytecode", "mlirbc", fd,
+                                                  path));
+  llvm::FileRemover remover(path);
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << bytecode;
+  }
+
+  // Read the file into a fresh context. The data is used in place.
+  MLIRContext readContext;
+  readContext.allowUnregisteredDialects();
+  auto fileOrErr = llvm::MemoryBuffer::getFile(
+      path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  ASSERT_TRUE(bool(fileOrErr));
+  std::shared_ptr<llvm::MemoryBuffer> buffer = std::move(*fileOrErr);
+  Block block;
+  ASSERT_TRUE(succeeded(readBytecodeFile(buffer, &block, &readContext)));
+  auto attr = cast<ModuleOp>(block.front())
+                  .getBody()
+                  ->front()
+                  .getAttrOfType<DenseResourceElementsAttr>("attr");
+  ASSERT_TRUE(attr);
+  EXPECT_EQ(attr.getBlobKey(), "weights");
+  Optional<ArrayRef<int32_t>> values = attr.tryGetAsArrayRef<int32_t>();
+  ASSERT_TRUE(values.hasValue());
+  EXPECT_EQ(*values, llvm::makeArrayRef(data));
+  StringRef bufferData = buffer->getBuffer();
+  EXPECT_GE(attr.getRawData()->data(), bufferData.begin());
+  EXPECT_LT(attr.getRawData()->data(), bufferData.end());
+
+  // The blob keeps the buffer alive.
+  buffer.reset();
+  EXPECT_EQ(*attr.tryGetAsArrayRef<int32_t>(), llvm::makeArrayRef(data));
+
+  // Reading the bytecode again doesn't clobber the existing data.
+  Block otherBlock;
+  ASSERT_TRUE(succeeded(readBytecodeFile(
+      llvm::MemoryBufferRef(bytecode, "test"), &otherBlock, &readContext)));
+  auto otherAttr = cast<ModuleOp>(otherBlock.front())
+                       .getBody()
+                       ->front()
+                       .getAttrOfType<DenseResourceElementsAttr>("attr");
+  EXPECT_NE(attr, otherAttr);
+  EXPECT_EQ(*otherAttr.tryGetAsArrayRef<int32_t>(), llvm::makeArrayRef(data));
+}
+
+TEST(BytecodeTest, Malformed) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString(irWithCFG, &context);
+  ASSERT_TRUE(module);
+  std::string bytecode = writeBytecode(*module);
+
+  unsigned numErrors = 0;
+  ScopedDiagnosticHandler handler(&context, [&](Diagnostic &) {
+    ++numErrors;
+    return success();
+  });
+
+  // Truncated files are rejected with an error.
+  for (size_t size : {size_t(2), size_t(10), bytecode.size() / 2,
+                      bytecode.size() - 1}) {
+    Block block;
+    llvm::MemoryBufferRef buffer(StringRef(bytecode).take_front(size), "test");
+    EXPECT_TRUE(failed(readBytecodeFile(buffer, &block, &context)));
+  }
+  EXPECT_EQ(numErrors, 4u);
+}
+} // namespace
@@ -8,6 +8,7 @@
 
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Diagnostics.h"
 #include "gtest/gtest.h"
 
 using namespace mlir;
@@ -250,4 +251,75 @@ TEST(SparseElementsAttrTest, GetZero) {
   EXPECT_TRUE(zeroStringValue.getType() == stringTy);
 }
 
+TEST(DenseResourceElementsAttrTest, DataAccess) {
+  MLIRContext context;
+  ShapedType type =
+      RankedTensorType::get({4}, IntegerType::get(&context, 32));
+
+  // The attribute refers to the data without copying it.
+  int32_t data[] = {1, 2, 3, 4};
+  ArrayRef<char> rawData(reinterpret_cast<const char *>(data), sizeof(data));
+  auto attr = DenseResourceElementsAttr::get(
+      type, "weights", ResourceBlob::createUnowned(rawData, alignof(int32_t)));
+  EXPECT_EQ(attr.getBlobKey(), "weights");
+  ASSERT_TRUE(attr.getRawData().hasValue());
+  EXPECT_EQ(attr.getRawData()->data(), rawData.data());
+
+  Optional<ArrayRef<int32_t>> values = attr.tryGetAsArrayRef<int32_t>();
+  ASSERT_TRUE(values.hasValue());
+  EXPECT_EQ(*values, llvm::makeArrayRef(data));
+  EXPECT_FALSE(attr.tryGetAsArrayRef<int64_t>().hasValue());
+}
+
+TEST(DenseResourceElementsAttrTest, Uniquing) {
+  MLIRContext context;
+  ShapedType type = RankedTensorType::get({2}, FloatType::getF32(&context));
+  ResourceBlobManager &manager = context.getResourceBlobManager();
+
+  // Attributes are uniqued by the identity of their entry, not by their data.
+  float data[] = {1.0f, 2.0f};
+  ArrayRef<char> rawData(reinterpret_cast<const char *>(data), sizeof(data));
+  auto attr = DenseResourceElementsAttr::get(
+      type, "blob", ResourceBlob::allocateAndCopy(rawData, alignof(float)));
+  auto sameAttr =
+      DenseResourceElementsAttr::get(type, &manager.getOrInsert("blob"));
+  EXPECT_EQ(attr, sameAttr);
+
+  // Inserting data under a taken name creates a distinct entry.
+  auto otherAttr = DenseResourceElementsAttr::get(
+      type, "blob", ResourceBlob::allocateAndCopy(rawData, alignof(float)));
+  EXPECT_NE(attr, otherAttr);
+  EXPECT_NE(attr.getBlobKey(), otherAttr.getBlobKey());
+  EXPECT_EQ(manager.lookup(otherAttr.getBlobKey()),
+            otherAttr.getRawHandle().getEntry());
+}
+
+TEST(DenseResourceElementsAttrTest, Release) {
+  MLIRContext context;
+  ShapedType type = RankedTensorType::get({2}, IndexType::get(&context));
+  ShapedType i8Type = RankedTensorType::get({2}, IntegerType::get(&context, 8));
+
+  // Only integer and floating point elements are supported.
+  ScopedDiagnosticHandler handler(&context, [](Diagnostic &) {
+    return success();
+  });
+  EXPECT_FALSE(DenseResourceElementsAttr::getChecked(
+      [&] { return emitError(UnknownLoc::get(&context)); }, type,
+      &context.getResourceBlobManager().getOrInsert("index")));
+
+  // The deleter runs when the data is released, and the attribute remains
+  // valid without its data.
+  bool released = false;
+  char data[] = {1, 2};
+  auto attr = DenseResourceElementsAttr::get(
+      i8Type, "released",
+      ResourceBlob(data, /*dataAlignment=*/1,
+                   [&](const char *, size_t, size_t) { released = true; }));
+  EXPECT_FALSE(released);
+  attr.getRawHandle().getEntry()->releaseBlob();
+  EXPECT_TRUE(released);
+  EXPECT_FALSE(attr.getRawData().hasValue());
+  EXPECT_EQ(attr.getBlobKey(), "released");
+}
+
 } // namespace
@@ -0,0 +1,126 @@
+//===- PDLCppTest.cpp - PDL patterns compiled to C++ unit tests -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser.h"
+#include "mlir/Rewrite/FrozenRewritePatternSet.h"
+#include "mlir/Rewrite/PDLCppSupport.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+// Generated from PDLCppTestPatterns.mlir.
+#include "PDLCppTestPatterns.cpp.inc"
+
+namespace {
+
+/// Register the native functions used by the test patterns.
+static PDLPatternModule getNativeFunctions() {
+  PDLPatternModule functions;
+  functions.registerConstraintFunction(
+      "isZero", [](PDLValue value, ArrayAttr, PatternRewriter &) {
+        auto attr = value.cast<Attribute>().dyn_cast<IntegerAttr>();
+        return success(attr && attr.getValue().isZero());
+      });
+  functions.registerRewriteFunction(
+      "rewritePack", [](ArrayRef<PDLValue> args, ArrayAttr,
+                        PatternRewriter &rewriter, PDLResultList &) {
+        rewriter.replaceOp(args[0].cast<Operation *>(),
+                           args[1].cast<ValueRange>());
+      });
+  return functions;
+}
+
+/// Return the operations named `name` within `module`.
+static SmallVector<Operation *> getOps(ModuleOp module, StringRef name) {
+  SmallVector<Operation *> ops;
+  module.walk([&](Operation *op) {
+    if (op->getName().getStringRef() == name)
+      ops.push_back(op);
+  });
+  return ops;
+}
+
+TEST(PDLCppTest, PopulatePatterns) {
+  MLIRContext context;
+  RewritePatternSet patterns(&context);
+  populatePDLPatterns(patterns, getNativeFunctions());
+  ASSERT_EQ(patterns.getNativePatterns().size(), 4u);
+
+  // Named patterns keep their name for debugging, and patterns are dispatched
+  // on their root operation.
+  SmallVector<StringRef> debugNames;
+  for (const std::unique_ptr<RewritePattern> &pattern :
+       patterns.getNativePatterns()) {
+    debugNames.push_back(pattern->getDebugName());
+    EXPECT_TRUE(pattern->getRootKind().hasValue());
+  }
+  EXPECT_TRUE(llvm::is_contained(debugNames, "foo_to_bar"));
+  EXPECT_TRUE(llvm::is_contained(debugNames, "erase_dead"));
+  EXPECT_TRUE(llvm::is_contained(debugNames, "pack"));
+}
+
+TEST(PDLCppTest, ApplyPatterns) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+
+  const char *source = R"mlir(
+    %i32 = "test.arg"() : () -> i32
+    %f32 = "test.arg"() : () -> f32
+    %foo = "test.foo"(%f32) : (f32) -> f32
+    "test.dead"() {value = 0 : i64} : () -> ()
+    "test.dead"() {value = 1 : i64} : () -> ()
+    %neg = "test.neg"(%i32) : (i32) -> i32
+    %negNeg = "test.neg"(%neg) : (i32) -> i32
+    %negF32 = "test.neg"(%f32) : (f32) -> f32
+    %negNegF32 = "test.neg"(%negF32) : (f32) -> f32
+    %pack:2 = "test.pack"(%i32, %f32) : (i32, f32) -> (i32, f32)
+    "test.use"(%foo, %negNeg, %negNegF32, %pack#0, %pack#1)
+      : (f32, i32, f32, i32, f32) -> ()
+  )mlir";
+  OwningOpRef<ModuleOp> module = parseSourceString(source, &context);
+  ASSERT_TRUE(module);
+
+  RewritePatternSet patterns(&context);
+  populatePDLPatterns(patterns, getNativeFunctions());
+  FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+  (void)applyPatternsAndFoldGreedily(*module, frozenPatterns);
+
+  // `test.foo` is replaced by a tagged `test.bar`.
+  EXPECT_TRUE(getOps(*module, "test.foo").empty());
+  SmallVector<Operation *> barOps = getOps(*module, "test.bar");
+  ASSERT_EQ(barOps.size(), 1u);
+  auto tag = barOps.front()->getAttrOfType<StringAttr>("tag");
+  ASSERT_TRUE(tag);
+  EXPECT_EQ(tag.getValue(), "converted");
+
+  // Only the `test.dead` operation satisfying the native constraint is erased.
+  SmallVector<Operation *> deadOps = getOps(*module, "test.dead");
+  ASSERT_EQ(deadOps.size(), 1u);
+  EXPECT_EQ(deadOps.front()->getAttrOfType<IntegerAttr>("value").getInt(), 1);
+
+  // The uses are rewired to the original values, except for the negation of
+  // f32 values which doesn't match the pattern.
+  SmallVector<Operation *> argOps = getOps(*module, "test.arg");
+  ASSERT_EQ(argOps.size(), 2u);
+  Value i32Arg = argOps[0]->getResult(0), f32Arg = argOps[1]->getResult(0);
+  SmallVector<Operation *> useOps = getOps(*module, "test.use");
+  ASSERT_EQ(useOps.size(), 1u);
+  Operation *use = useOps.front();
+  EXPECT_EQ(use->getOperand(0).getDefiningOp(), barOps.front());
+  EXPECT_EQ(use->getOperand(1), i32Arg);
+  Operation *negNegF32 = use->getOperand(2).getDefiningOp();
+  ASSERT_TRUE(negNegF32);
+  EXPECT_EQ(negNegF32->getName().getStringRef(), "test.neg");
+  EXPECT_EQ(use->getOperand(3), i32Arg);
+  EXPECT_EQ(use->getOperand(4), f32Arg);
+  EXPECT_TRUE(getOps(*module, "test.pack").empty());
+}
+
+} // namespace
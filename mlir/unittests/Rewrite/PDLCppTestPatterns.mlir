@@ -0,0 +1,45 @@
+// Patterns compiled to C++ with `mlir-translate -pdl-to-cpp` for PDLCppTest.
+
+// Replace `test.foo` with `test.bar`, keeping its operand and result type.
+pdl.pattern @foo_to_bar : benefit(1) {
+  %type = pdl.type
+  %operand = pdl.operand
+  %root = pdl.operation "test.foo"(%operand : !pdl.value) -> (%type : !pdl.type)
+  pdl.rewrite %root {
+    %attr = pdl.attribute "converted"
+    %op = pdl.operation "test.bar"(%operand : !pdl.value) {"tag" = %attr} -> (%type : !pdl.type)
+    %result = pdl.result 0 of %op
+    pdl.replace %root with (%result : !pdl.value)
+  }
+}
+
+// Erase `test.dead` operations whose value is zero, according to a native
+// constraint.
+pdl.pattern @erase_dead : benefit(2) {
+  %attr = pdl.attribute
+  %root = pdl.operation "test.dead" {"value" = %attr}
+  pdl.apply_native_constraint "isZero"(%attr : !pdl.attribute)
+  pdl.rewrite %root {
+    pdl.erase %root
+  }
+}
+
+// Fold `test.neg` of `test.neg` of i32 values.
+pdl.pattern : benefit(1) {
+  %i32 = pdl.type : i32
+  %input = pdl.operand : %i32
+  %inner = pdl.operation "test.neg"(%input : !pdl.value) -> (%i32 : !pdl.type)
+  %innerResult = pdl.result 0 of %inner
+  %root = pdl.operation "test.neg"(%innerResult : !pdl.value) -> (%i32 : !pdl.type)
+  pdl.rewrite %root {
+    pdl.replace %root with (%input : !pdl.value)
+  }
+}
+
+// Rewrite variadic `test.pack` operations with a native rewrite.
+pdl.pattern @pack : benefit(1) {
+  %operands = pdl.operands
+  %types = pdl.types
+  %root = pdl.operation "test.pack"(%operands : !pdl.range<value>) -> (%types : !pdl.range<type>)
+  pdl.rewrite %root with "rewritePack"(%operands : !pdl.range<value>)
+}
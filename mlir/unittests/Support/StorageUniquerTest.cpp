@@ -8,6 +8,7 @@
 
 #include "mlir/Support/StorageUniquer.h"
 #include "gmock/gmock.h"
+#include <thread>
 
 using namespace mlir;
 
@@ -58,3 +59,42 @@ TEST(StorageUniquerTest, NonTrivialDestructor) {
 
   EXPECT_TRUE(wasDestructed);
 }
+
+TEST(StorageUniquerTest, Statistics) {
+  struct IntStorage : public SimpleStorage<IntStorage, int> {
+    using Base::Base;
+  };
+  struct OtherIntStorage : public SimpleStorage<OtherIntStorage, int> {
+    using Base::Base;
+  };
+
+  StorageUniquer uniquer;
+  uniquer.registerParametricStorageType<IntStorage>();
+  uniquer.registerParametricStorageType<OtherIntStorage>();
+
+  // The first lookup creates the instance, and the second one is resolved by
+  // the cache of this thread.
+  IntStorage *storage = IntStorage::get(uniquer, 1);
+  EXPECT_EQ(IntStorage::get(uniquer, 1), storage);
+  OtherIntStorage::get(uniquer, 1);
+
+  // Another thread finds the instance in the shared uniquer.
+  std::thread([&] { EXPECT_EQ(IntStorage::get(uniquer, 1), storage); }).join();
+
+  StorageUniquer::Statistics stats =
+      uniquer.getStatistics(TypeID::get<IntStorage>());
+  EXPECT_EQ(stats.numLocalCacheHits, 1u);
+  EXPECT_EQ(stats.numSharedHits, 1u);
+  EXPECT_EQ(stats.numWriterLocks, 1u);
+  EXPECT_EQ(stats.numRacedInsertions, 0u);
+  EXPECT_EQ(stats.getNumLookups(), 3u);
+
+  StorageUniquer::Statistics totalStats = uniquer.getStatistics();
+  EXPECT_EQ(totalStats.numWriterLocks, 2u);
+  EXPECT_EQ(totalStats.getNumLookups(), 4u);
+
+  // Nothing is recorded without multi-threading.
+  uniquer.disableMultithreading();
+  IntStorage::get(uniquer, 2);
+  EXPECT_EQ(uniquer.getStatistics().getNumLookups(), 4u);
+}
@@ -81,4 +81,48 @@ TEST(CanonicalizerTest, TestDisablePatterns) {
   EXPECT_FALSE(module->lookupSymbol("A"));
 }
 
+TEST(CanonicalizerTest, TestParallelIsolatedRegions) {
+  MLIRContext context;
+  context.getOrLoadDialect<TestDialect>();
+
+  const char *const code = R"mlir(
+    module @A {
+      %0:2 = "test.foo"() : () -> (i32, i32)
+    }
+    module @B {
+      %0:2 = "test.foo"() : () -> (i32, i32)
+      %1:2 = "test.foo"() : () -> (i32, i32)
+    }
+    module @C {
+    }
+    %0:2 = "test.foo"() : () -> (i32, i32)
+  )mlir";
+
+  OwningOpRef<ModuleOp> module = mlir::parseSourceString(code, &context);
+  ASSERT_TRUE(module);
+
+  RewritePatternSet owningPatterns(&context);
+  owningPatterns.insert<EnabledPattern>(&context);
+  FrozenRewritePatternSet patterns(std::move(owningPatterns));
+
+  GreedyRewriteStatistics stats;
+  GreedyRewriteConfig config;
+  config.parallelizeIsolatedRegions = true;
+  config.statistics = &stats;
+  ASSERT_TRUE(succeeded(
+      applyPatternsAndFoldGreedily(module->getOperation(), patterns, config)));
+
+  // Only the nested modules are left.
+  WalkResult result = module->walk([](Operation *op) {
+    return op->getName().getStringRef() == "test.foo" ? WalkResult::interrupt()
+                                                      : WalkResult::advance();
+  });
+  EXPECT_FALSE(result.wasInterrupted());
+  EXPECT_EQ(stats.numPatternsApplied, 4u);
+  // With threads, the modules with ops and the top level take two iterations
+  // each, and @C takes one.
+  if (context.isMultithreadingEnabled())
+    EXPECT_EQ(stats.numIterations, 7u);
+}
+
 } // end anonymous namespace
@@ -7,6 +7,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Transforms/DialectConversion.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser.h"
 #include "gtest/gtest.h"
 
 using namespace mlir;
@@ -129,4 +131,120 @@ TEST(DialectConversionTest, DynamicallyLegalUnknownReturnNone) {
 
   op->destroy();
 }
+
+struct TestBOp {
+  static StringRef getOperationName() { return "test.b"; }
+};
+struct TestCOp {
+  static StringRef getOperationName() { return "test.c"; }
+};
+
+/// Replace `test.a` operations with `test.b` operations.
+struct ReplaceAPattern : public ConversionPattern {
+  ReplaceAPattern(MLIRContext *context)
+      : ConversionPattern("test.a", /*benefit=*/1, context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const final {
+    OperationState state(op->getLoc(), TestBOp::getOperationName());
+    state.addOperands(operands);
+    state.addTypes(op->getResultTypes());
+    rewriter.replaceOp(op, rewriter.createOperation(state)->getResults());
+    return success();
+  }
+};
+
+/// Mark `test.c` operations as converted by updating them in place.
+struct UpdateCPattern : public ConversionPattern {
+  UpdateCPattern(MLIRContext *context)
+      : ConversionPattern("test.c", /*benefit=*/1, context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const final {
+    rewriter.updateRootInPlace(
+        op, [&] { op->setAttr("converted", rewriter.getUnitAttr()); });
+    return success();
+  }
+};
+
+/// A pattern on `test.c` operations that fails before modifying the IR.
+struct FailingCPattern : public ConversionPattern {
+  FailingCPattern(MLIRContext *context)
+      : ConversionPattern("test.c", /*benefit=*/2, context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const final {
+    return rewriter.notifyMatchFailure(op, "always fails");
+  }
+};
+
+TEST(DialectConversionTest, FullConversionWithoutRollback) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString(R"mlir(
+    %0 = "test.a"() : () -> i32
+    "test.c"(%0) : (i32) -> ()
+  )mlir",
+                                                   &context);
+  ASSERT_TRUE(module);
+
+  ConversionTarget target(context);
+  target.addLegalOp<ModuleOp, TestBOp>();
+  target.addDynamicallyLegalOp<TestCOp>(
+      [](Operation *op) { return op->hasAttr("converted"); });
+
+  RewritePatternSet patterns(&context);
+  patterns.add<ReplaceAPattern, UpdateCPattern, FailingCPattern>(&context);
+  FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+
+  ConversionConfig config;
+  config.allowPatternRollback = false;
+  ASSERT_TRUE(
+      succeeded(applyFullConversion(*module, target, frozenPatterns, config)));
+
+  Block *body = module->getBody();
+  ASSERT_EQ(body->getOperations().size(), 2u);
+  Operation &bOp = body->front(), &cOp = body->back();
+  EXPECT_EQ(bOp.getName().getStringRef(), TestBOp::getOperationName());
+  EXPECT_TRUE(cOp.hasAttr("converted"));
+  EXPECT_EQ(cOp.getOperand(0), bOp.getResult(0));
+}
+
+TEST(DialectConversionTest, FailedConversionWithoutRollback) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString(R"mlir(
+    %0 = "test.a"() : () -> i32
+    "test.c"(%0) : (i32) -> ()
+    "test.d"() : () -> ()
+  )mlir",
+                                                   &context);
+  ASSERT_TRUE(module);
+
+  ConversionTarget target(context);
+  target.addLegalOp<ModuleOp, TestBOp>();
+  target.addDynamicallyLegalOp<TestCOp>(
+      [](Operation *op) { return op->hasAttr("converted"); });
+
+  RewritePatternSet patterns(&context);
+  patterns.add<ReplaceAPattern, UpdateCPattern>(&context);
+  FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+
+  // `test.d` can't be legalized. The replacement of `test.a` is discarded, but
+  // the in-place update of `test.c` isn't rolled back.
+  ConversionConfig config;
+  config.allowPatternRollback = false;
+  context.getDiagEngine().registerHandler([](Diagnostic &) {});
+  ASSERT_TRUE(
+      failed(applyFullConversion(*module, target, frozenPatterns, config)));
+
+  Block *body = module->getBody();
+  ASSERT_EQ(body->getOperations().size(), 3u);
+  auto it = body->begin();
+  EXPECT_EQ(it->getName().getStringRef(), "test.a");
+  EXPECT_TRUE((++it)->hasAttr("converted"));
+}
 } // namespace
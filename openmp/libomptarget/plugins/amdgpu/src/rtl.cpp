@@ -31,6 +31,7 @@
 #include "rt.h"
 
 #include "DeviceEnvironment.h"
+#include "MemoryManager.h"
 #include "get_elf_mach_gfx_name.h"
 #include "omptargetplugin.h"
 #include "print_tracing.h"
@@ -218,20 +219,36 @@ struct KernelTy {
   void *CallStackAddr = nullptr;
   const char *Name;
 
+  // Looked up by name when the kernel is loaded, so that launches do not
+  // need to. HasKernelInfo is false if the kernel was missing from the image.
+  bool HasKernelInfo = false;
+  atl_kernel_info_t KernelInfoEntry = {};
+  KernelArgPool *ArgPool = nullptr;
+
   KernelTy(llvm::omp::OMPTgtExecModeFlags _ExecutionMode, int16_t _ConstWGSize,
            int32_t _device_id, void *_CallStackAddr, const char *_Name,
+           const atl_kernel_info_t *_KernelInfoEntry,
            uint32_t _kernarg_segment_size,
            hsa_amd_memory_pool_t &KernArgMemoryPool)
       : ExecutionMode(_ExecutionMode), ConstWGSize(_ConstWGSize),
         device_id(_device_id), CallStackAddr(_CallStackAddr), Name(_Name) {
     DP("Construct kernelinfo: ExecMode %d\n", ExecutionMode);
 
+    if (_KernelInfoEntry) {
+      HasKernelInfo = true;
+      KernelInfoEntry = *_KernelInfoEntry;
+    }
+
     std::string N(_Name);
-    if (KernelArgPoolMap.find(N) == KernelArgPoolMap.end()) {
-      KernelArgPoolMap.insert(
-          std::make_pair(N, std::unique_ptr<KernelArgPool>(new KernelArgPool(
-                                _kernarg_segment_size, KernArgMemoryPool))));
+    auto It = KernelArgPoolMap.find(N);
+    if (It == KernelArgPoolMap.end()) {
+      It = KernelArgPoolMap
+               .insert(std::make_pair(
+                   N, std::unique_ptr<KernelArgPool>(new KernelArgPool(
+                          _kernarg_segment_size, KernArgMemoryPool))))
+               .first;
     }
+    ArgPool = It->second.get();
   }
 };
 
@@ -485,6 +502,38 @@ public:
   std::vector<hsa_amd_memory_pool_t> DeviceFineGrainedMemoryPools;
   std::vector<hsa_amd_memory_pool_t> DeviceCoarseGrainedMemoryPools;
 
+  /// Allocates the device memory of the mappings from the coarse-grained pool
+  /// of a device, on behalf of its memory manager.
+  class AMDGPUDeviceAllocatorTy : public DeviceAllocatorTy {
+    hsa_amd_memory_pool_t MemoryPool;
+
+  public:
+    AMDGPUDeviceAllocatorTy(hsa_amd_memory_pool_t MemoryPool)
+        : MemoryPool(MemoryPool) {}
+
+    void *allocate(size_t Size, void *, TargetAllocTy) override {
+      void *Ptr = nullptr;
+      hsa_status_t Err =
+          hsa_amd_memory_pool_allocate(MemoryPool, Size, 0, &Ptr);
+      return Err == HSA_STATUS_SUCCESS ? Ptr : nullptr;
+    }
+
+    int free(void *TgtPtr) override {
+      hsa_status_t Err = core::Runtime::Memfree(TgtPtr);
+      return Err == HSA_STATUS_SUCCESS ? OFFLOAD_SUCCESS : OFFLOAD_FAIL;
+    }
+  };
+
+  /// A vector of device allocators, referenced by the memory managers
+  std::vector<AMDGPUDeviceAllocatorTy> DeviceAllocators;
+
+  /// A vector of memory managers, which keep the freed small blocks of each
+  /// device for reuse, as the HSA allocations are slow.
+  std::vector<std::unique_ptr<MemoryManagerTy>> MemoryManagers;
+
+  /// Whether use memory manager
+  bool UseMemoryManager = true;
+
   struct implFreePtrDeletor {
     void operator()(void *p) {
       core::Runtime::Memfree(p); // ignore failure to free
@@ -777,6 +826,19 @@ public:
       return;
     }
 
+    for (int i = 0; i < NumberOfDevices; i++)
+      DeviceAllocators.emplace_back(DeviceCoarseGrainedMemoryPools[i]);
+
+    // Get the size threshold from environment variable
+    std::pair<size_t, bool> Res = MemoryManagerTy::getSizeThresholdFromEnv();
+    UseMemoryManager = Res.second;
+    size_t MemoryManagerThreshold = Res.first;
+
+    if (UseMemoryManager)
+      for (int i = 0; i < NumberOfDevices; i++)
+        MemoryManagers.emplace_back(std::make_unique<MemoryManagerTy>(
+            DeviceAllocators[i], MemoryManagerThreshold));
+
     for (int i = 0; i < NumberOfDevices; i++) {
       uint32_t queue_size = 0;
       {
@@ -830,6 +892,7 @@ public:
     }
     // Run destructors on types that use HSA before
     // impl_finalize removes access to it
+    MemoryManagers.clear();
     deviceStateStore.clear();
     KernelArgPoolMap.clear();
     // Terminate hostrpc before finalizing hsa
@@ -1100,29 +1163,20 @@ int32_t runRegionLocked(int32_t device_id, void *tgt_entry_ptr, void **tgt_args,
 
   DP("Run target team region thread_limit %d\n", thread_limit);
 
-  // All args are references.
-  std::vector<void *> args(arg_num);
-  std::vector<void *> ptrs(arg_num);
-
   DP("Arg_num: %d\n", arg_num);
   for (int32_t i = 0; i < arg_num; ++i) {
-    ptrs[i] = (void *)((intptr_t)tgt_args[i] + tgt_offsets[i]);
-    args[i] = &ptrs[i];
-    DP("Offseted base: arg[%d]:" DPxMOD "\n", i, DPxPTR(ptrs[i]));
+    DP("Offseted base: arg[%d]:" DPxMOD "\n", i,
+       DPxPTR((intptr_t)tgt_args[i] + tgt_offsets[i]));
   }
 
   KernelTy *KernelInfo = (KernelTy *)tgt_entry_ptr;
 
-  std::string kernel_name = std::string(KernelInfo->Name);
-  auto &KernelInfoTable = DeviceInfo.KernelInfoTable;
-  if (KernelInfoTable[device_id].find(kernel_name) ==
-      KernelInfoTable[device_id].end()) {
-    DP("Kernel %s not found\n", kernel_name.c_str());
+  if (!KernelInfo->HasKernelInfo) {
+    DP("Kernel %s not found\n", KernelInfo->Name);
     return OFFLOAD_FAIL;
   }
 
-  const atl_kernel_info_t KernelInfoEntry =
-      KernelInfoTable[device_id][kernel_name];
+  const atl_kernel_info_t &KernelInfoEntry = KernelInfo->KernelInfoEntry;
   const uint32_t group_segment_size = KernelInfoEntry.group_segment_size;
   const uint32_t sgpr_count = KernelInfoEntry.sgpr_count;
   const uint32_t vgpr_count = KernelInfoEntry.vgpr_count;
@@ -1188,14 +1242,8 @@ int32_t runRegionLocked(int32_t device_id, void *tgt_entry_ptr, void **tgt_args,
     packet->reserved2 = 0;           // impl writes id_ here
     packet->completion_signal = {0}; // may want a pool of signals
 
-    KernelArgPool *ArgPool = nullptr;
+    KernelArgPool *ArgPool = KernelInfo->ArgPool;
     void *kernarg = nullptr;
-    {
-      auto it = KernelArgPoolMap.find(std::string(KernelInfo->Name));
-      if (it != KernelArgPoolMap.end()) {
-        ArgPool = (it->second).get();
-      }
-    }
     if (!ArgPool) {
       DP("Warning: No ArgPool for %s on device %d\n", KernelInfo->Name,
          device_id);
@@ -1210,9 +1258,10 @@ int32_t runRegionLocked(int32_t device_id, void *tgt_entry_ptr, void **tgt_args,
         return OFFLOAD_FAIL;
       }
 
-      // Copy explicit arguments
+      // Copy explicit arguments, which are all references
       for (int i = 0; i < arg_num; i++) {
-        memcpy((char *)kernarg + sizeof(void *) * i, args[i], sizeof(void *));
+        void *ptr = (void *)((intptr_t)tgt_args[i] + tgt_offsets[i]);
+        memcpy((char *)kernarg + sizeof(void *) * i, &ptr, sizeof(void *));
       }
 
       // Initialize implicit arguments. TODO: Which of these can be dropped
@@ -2031,6 +2080,7 @@ __tgt_target_table *__tgt_rtl_load_binary_locked(int32_t device_id,
 
     // errors in kernarg_segment_size previously treated as = 0 (or as undef)
     uint32_t kernarg_segment_size = 0;
+    const atl_kernel_info_t *KernelInfoEntry = nullptr;
     auto &KernelInfoMap = DeviceInfo.KernelInfoTable[device_id];
     hsa_status_t err = HSA_STATUS_SUCCESS;
     if (!e->name) {
@@ -2039,8 +2089,8 @@ __tgt_target_table *__tgt_rtl_load_binary_locked(int32_t device_id,
       std::string kernelStr = std::string(e->name);
       auto It = KernelInfoMap.find(kernelStr);
       if (It != KernelInfoMap.end()) {
-        atl_kernel_info_t info = It->second;
-        kernarg_segment_size = info.kernel_segment_size;
+        KernelInfoEntry = &It->second;
+        kernarg_segment_size = KernelInfoEntry->kernel_segment_size;
       } else {
         err = HSA_STATUS_ERROR;
       }
@@ -2177,7 +2227,8 @@ __tgt_target_table *__tgt_rtl_load_binary_locked(int32_t device_id,
     check("Loading computation property", err);
 
     KernelsList.push_back(KernelTy(ExecModeVal, WGSizeVal, device_id,
-                                   CallStackAddr, e->name, kernarg_segment_size,
+                                   CallStackAddr, e->name, KernelInfoEntry,
+                                   kernarg_segment_size,
                                    DeviceInfo.KernArgPool));
     __tgt_offload_entry entry = *e;
     entry.addr = (void *)&KernelsList.back();
@@ -2198,11 +2249,13 @@ void *__tgt_rtl_data_alloc(int device_id, int64_t size, void *, int32_t kind) {
     return NULL;
   }
 
-  hsa_amd_memory_pool_t MemoryPool = DeviceInfo.getDeviceMemoryPool(device_id);
-  hsa_status_t err = hsa_amd_memory_pool_allocate(MemoryPool, size, 0, &ptr);
+  if (DeviceInfo.UseMemoryManager)
+    ptr = DeviceInfo.MemoryManagers[device_id]->allocate(size, nullptr);
+  else
+    ptr = DeviceInfo.DeviceAllocators[device_id].allocate(size, nullptr,
+                                                          TARGET_ALLOC_DEVICE);
   DP("Tgt alloc data %ld bytes, (tgt:%016llx).\n", size,
      (long long unsigned)(Elf64_Addr)ptr);
-  ptr = (err == HSA_STATUS_SUCCESS) ? ptr : NULL;
   return ptr;
 }
 
@@ -2252,6 +2305,8 @@ int32_t __tgt_rtl_data_delete(int device_id, void *tgt_ptr) {
   assert(device_id < DeviceInfo.NumberOfDevices && "Device ID too large");
   hsa_status_t err;
   DP("Tgt free data (tgt:%016llx).\n", (long long unsigned)(Elf64_Addr)tgt_ptr);
+  if (DeviceInfo.UseMemoryManager)
+    return DeviceInfo.MemoryManagers[device_id]->free(tgt_ptr);
   err = core::Runtime::Memfree(tgt_ptr);
   if (err != HSA_STATUS_SUCCESS) {
     DP("Error when freeing CUDA memory\n");
@@ -1074,9 +1074,17 @@ public:
     if (!checkResult(Err, "Error returned from cuCtxSetCurrent\n"))
       return OFFLOAD_FAIL;
 
-    // All args are references.
-    std::vector<void *> Args(ArgNum);
-    std::vector<void *> Ptrs(ArgNum);
+    // All args are references. Kernels rarely take many arguments, so the
+    // argument arrays are kept on the stack unless they do not fit.
+    constexpr int InlineArgNum = 16;
+    void *InlineArgs[2 * InlineArgNum];
+    std::vector<void *> HeapArgs;
+    void **Ptrs = InlineArgs;
+    if (ArgNum > InlineArgNum) {
+      HeapArgs.resize(2 * ArgNum);
+      Ptrs = HeapArgs.data();
+    }
+    void **Args = Ptrs + ArgNum;
 
     for (int I = 0; I < ArgNum; ++I) {
       Ptrs[I] = (void *)((intptr_t)TgtArgs[I] + TgtOffsets[I]);
@@ -1193,7 +1201,7 @@ public:
     Err = cuLaunchKernel(KernelInfo->Func, CudaBlocksPerGrid, /* gridDimY */ 1,
                          /* gridDimZ */ 1, CudaThreadsPerBlock,
                          /* blockDimY */ 1, /* blockDimZ */ 1,
-                         DynamicMemorySize, Stream, &Args[0], nullptr);
+                         DynamicMemorySize, Stream, Args, nullptr);
     if (!checkResult(Err, "Error returned from cuLaunchKernel\n"))
       return OFFLOAD_FAIL;
 
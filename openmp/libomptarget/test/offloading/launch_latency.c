@@ -0,0 +1,53 @@
+// RUN: %libomptarget-compile-run-and-check-generic
+
+// Launches many empty and small target regions back to back, so that the time
+// spent in the runtime and the plugin per launch dominates. The average launch
+// latency is reported on stderr.
+
+#include <omp.h>
+#include <stdio.h>
+
+#define NUM_LAUNCHES 1000
+
+int main() {
+  int data[4] = {0, 0, 0, 0};
+
+  // The first launch loads the image, it is not timed.
+#pragma omp target map(tofrom : data)
+  { data[0] = 0; }
+
+  double start = omp_get_wtime();
+  for (int i = 0; i < NUM_LAUNCHES; ++i) {
+#pragma omp target
+    {}
+  }
+  double empty = omp_get_wtime() - start;
+
+#pragma omp target enter data map(to : data)
+  start = omp_get_wtime();
+  for (int i = 0; i < NUM_LAUNCHES; ++i) {
+#pragma omp target map(always, tofrom : data) firstprivate(i)
+    {
+      data[0] += 1;
+      data[1] += i;
+      data[2] = data[0] + data[1];
+      data[3] = i;
+    }
+  }
+  double small = omp_get_wtime() - start;
+#pragma omp target exit data map(from : data)
+
+  fprintf(stderr, "empty target region: %.2f us per launch\n",
+          empty * 1e6 / NUM_LAUNCHES);
+  fprintf(stderr, "small target region: %.2f us per launch\n",
+          small * 1e6 / NUM_LAUNCHES);
+
+  int sum = NUM_LAUNCHES * (NUM_LAUNCHES - 1) / 2;
+  int ok = data[0] == NUM_LAUNCHES && data[1] == sum &&
+           data[2] == NUM_LAUNCHES + sum && data[3] == NUM_LAUNCHES - 1;
+
+  // CHECK: PASS
+  if (ok)
+    printf("PASS\n");
+  return !ok;
+}
@@ -1009,6 +1009,7 @@ typedef struct kmp_allocator_t {
   kmp_allocator_t *fb_data;
   kmp_uint64 pool_size;
   kmp_uint64 pool_used;
+  omp_alloctrait_value_t partition;
 } kmp_allocator_t;
 
 extern omp_allocator_handle_t __kmpc_init_allocator(int gtid,
@@ -2255,6 +2256,10 @@ typedef enum kmp_tasking_mode {
 extern kmp_tasking_mode_t
     __kmp_tasking_mode; /* determines how/when to execute tasks */
 extern int __kmp_task_stealing_constraint;
+#if KMP_AFFINITY_SUPPORTED
+// Number of extra draws made to find a victim in the thief's NUMA domain
+extern int __kmp_task_steal_local_tries;
+#endif
 extern int __kmp_enable_task_throttling;
 extern kmp_int32 __kmp_default_device; // Set via OMP_DEFAULT_DEVICE if
 // specified, defaults to 0 otherwise
@@ -2679,6 +2684,7 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
   int th_new_place; /* place to bind to in par reg */
   int th_first_place; /* first place in partition */
   int th_last_place; /* last place in partition */
+  int th_locality_domain; /* NUMA domain of the mask, -1 if none or several */
 #endif
   int th_prev_level; /* previous level for affinity format */
   int th_prev_num_threads; /* previous num_threads for affinity format */
@@ -2818,6 +2824,20 @@ typedef int (*launch_t)(int gtid);
 #endif
 #define KMP_INLINE_ARGV_ENTRIES (int)(KMP_INLINE_ARGV_BYTES / KMP_PTR_SKIP)
 
+// Number of patterns tried by the adaptive selection of the plain barrier
+#define KMP_BAR_ADAPTIVE_CANDIDATES 3
+
+// State of the adaptive selection of the plain barrier pattern, written by the
+// primary thread of the team. See __kmp_barrier_adaptive_select().
+typedef struct kmp_bar_adaptive {
+  kmp_bar_pat_e pattern; // pattern of the next plain barriers of the team
+  int nproc; // team size the state was built for
+  int trial; // candidate being measured, or -1 once a pattern is selected
+  int samples; // number of barriers measured for the candidate
+  kmp_uint64 start; // time the primary thread entered the measured barrier
+  kmp_uint64 best[KMP_BAR_ADAPTIVE_CANDIDATES]; // shortest time seen
+} kmp_bar_adaptive_t;
+
 typedef struct KMP_ALIGN_CACHE kmp_base_team {
   // Synchronization Data
   // ---------------------------------------------------------------------------
@@ -2845,6 +2865,7 @@ typedef struct KMP_ALIGN_CACHE kmp_base_team {
 #if USE_ITT_BUILD
   kmp_uint64 t_region_time; // region begin timestamp
 #endif /* USE_ITT_BUILD */
+  kmp_bar_adaptive_t t_bar_adaptive; // also read by workers at barriers
 
   // Primary thread write, workers read
   // --------------------------------------------------------------------------
@@ -3066,6 +3087,7 @@ extern kmp_uint32 __kmp_barrier_gather_branch_bits[bs_last_barrier];
 extern kmp_uint32 __kmp_barrier_release_branch_bits[bs_last_barrier];
 extern kmp_bar_pat_e __kmp_barrier_gather_pattern[bs_last_barrier];
 extern kmp_bar_pat_e __kmp_barrier_release_pattern[bs_last_barrier];
+extern int __kmp_barrier_adaptive;
 extern char const *__kmp_barrier_branch_bit_env_name[bs_last_barrier];
 extern char const *__kmp_barrier_pattern_env_name[bs_last_barrier];
 extern char const *__kmp_barrier_type_name[bs_last_barrier];
@@ -4534,6 +4534,35 @@ void __kmp_affinity_uninitialize(void) {
   KMPAffinity::destroy_api();
 }
 
+// Returns the NUMA domain holding all the processors of 'mask', as the index of
+// the first hardware thread of the domain, or -1 if the processors span several
+// domains. Without NUMA information in the topology, the packages are used.
+static int __kmp_affinity_find_domain(const kmp_affin_mask_t *mask) {
+  if (__kmp_topology == nullptr)
+    return -1;
+  int level = __kmp_topology->get_level(KMP_HW_NUMA);
+  if (level < 0)
+    level = __kmp_topology->get_level(KMP_HW_SOCKET);
+  if (level < 0)
+    return -1;
+  const int hw_level = __kmp_topology->get_depth() - level - 1;
+  int first = -1;
+  for (int i = 0; i < __kmp_topology->get_num_hw_threads(); ++i) {
+    if (!KMP_CPU_ISSET(__kmp_topology->at(i).os_id, mask))
+      continue;
+    if (first < 0)
+      first = i;
+    else if (!__kmp_topology->is_close(first, i, hw_level))
+      return -1;
+  }
+  if (first < 0)
+    return -1;
+  // The hardware threads are sorted by ids, those of a domain are contiguous.
+  while (first > 0 && __kmp_topology->is_close(first - 1, first, hw_level))
+    --first;
+  return first;
+}
+
 void __kmp_affinity_set_init_mask(int gtid, int isa_root) {
   if (!KMP_AFFINITY_CAPABLE()) {
     return;
@@ -4613,6 +4642,7 @@ void __kmp_affinity_set_init_mask(int gtid, int isa_root) {
   }
 
   KMP_CPU_COPY(th->th.th_affin_mask, mask);
+  th->th.th_locality_domain = __kmp_affinity_find_domain(mask);
 
   if (__kmp_affinity_verbose && !KMP_HIDDEN_HELPER_THREAD(gtid)
       /* to avoid duplicate printing (will be correctly printed on barrier) */
@@ -4676,6 +4706,7 @@ void __kmp_affinity_set_place(int gtid) {
       KMP_CPU_INDEX(__kmp_affinity_masks, th->th.th_new_place);
   KMP_CPU_COPY(th->th.th_affin_mask, mask);
   th->th.th_current_place = th->th.th_new_place;
+  th->th.th_locality_domain = __kmp_affinity_find_domain(mask);
 
   if (__kmp_affinity_verbose) {
     char buf[KMP_AFFIN_MASK_PRINT_LEN];
@@ -4740,6 +4771,8 @@ int __kmp_aux_set_affinity(void **mask) {
   retval = __kmp_set_system_affinity((kmp_affin_mask_t *)(*mask), FALSE);
   if (retval == 0) {
     KMP_CPU_COPY(th->th.th_affin_mask, (kmp_affin_mask_t *)(*mask));
+    th->th.th_locality_domain =
+        __kmp_affinity_find_domain(th->th.th_affin_mask);
   }
 
   th->th.th_current_place = KMP_PLACE_UNDEFINED;
@@ -14,6 +14,11 @@
 #include "kmp_io.h"
 #include "kmp_wrapper_malloc.h"
 
+#if KMP_OS_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 // Disable bget when it is not used
 #if KMP_USE_BGET
 
@@ -1399,6 +1404,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       al->fb_data = RCAST(kmp_allocator_t *, traits[i].value);
       break;
     case omp_atk_partition:
+      al->partition = (omp_alloctrait_value_t)traits[i].value;
       al->memkind = RCAST(void **, traits[i].value);
       break;
     default:
@@ -1529,6 +1535,29 @@ void __kmpc_free(int gtid, void *ptr, omp_allocator_handle_t allocator) {
   return;
 }
 
+// Moves the pages of a block allocated for the omp_atv_nearest partition to
+// the NUMA node of the calling thread. Only the pages fully inside the block
+// are bound, since the others may be shared with unrelated allocations. This
+// is a hint: the block stays usable wherever its pages are if it fails.
+static void __kmp_bind_to_local_node(void *ptr, size_t size) {
+#if KMP_OS_LINUX && defined(__NR_getcpu) && defined(__NR_mbind)
+  enum { MPOL_PREFERRED = 1, MPOL_MF_MOVE = 2, MAX_NODES = 1024 };
+  const kmp_uintptr_t page = (kmp_uintptr_t)getpagesize();
+  kmp_uintptr_t begin = ((kmp_uintptr_t)ptr + page - 1) & ~(page - 1);
+  kmp_uintptr_t end = ((kmp_uintptr_t)ptr + size) & ~(page - 1);
+  if (begin >= end)
+    return;
+  unsigned cpu, node;
+  if (syscall(__NR_getcpu, &cpu, &node, NULL) != 0 || node >= MAX_NODES)
+    return;
+  const int bits_per_long = 8 * sizeof(unsigned long);
+  unsigned long nodemask[MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+  nodemask[node / bits_per_long] = 1UL << (node % bits_per_long);
+  syscall(__NR_mbind, (void *)begin, end - begin, MPOL_PREFERRED, nodemask,
+          (unsigned long)MAX_NODES + 1, MPOL_MF_MOVE);
+#endif
+}
+
 // internal implementation, called from inside the library
 void *__kmp_alloc(int gtid, size_t algn, size_t size,
                   omp_allocator_handle_t allocator) {
@@ -1686,6 +1715,11 @@ void *__kmp_alloc(int gtid, size_t algn, size_t size,
   if (ptr == NULL)
     return NULL;
 
+  // al was replaced by the predefined default allocator on fallbacks
+  if ((omp_allocator_handle_t)al > kmp_max_mem_alloc &&
+      al->partition == omp_atv_nearest)
+    __kmp_bind_to_local_node(ptr, desc.size_a);
+
   addr = (kmp_uintptr_t)ptr;
   addr_align = (addr + sz_desc + align - 1) & ~(align - 1);
   addr_descr = addr_align - sz_desc;
@@ -1755,6 +1755,95 @@ template <> struct is_cancellable<false> {
   constexpr operator bool() const { return false; }
 };
 
+// Adaptive selection of the plain barrier pattern (KMP_ADAPTIVE_BARRIER).
+// The primary thread of each team measures KMP_BAR_ADAPTIVE_SAMPLES barriers
+// with every candidate pattern and keeps the shortest time it spent in them.
+// Load imbalance only makes a barrier longer, so the shortest time approaches
+// the latency of the pattern when all the threads arrive together. The fastest
+// candidate is then used until the team size changes. The candidates need no
+// setup in the team, so that the pattern can change between two barriers.
+#define KMP_BAR_ADAPTIVE_SAMPLES 16
+
+static const kmp_bar_pat_e
+    __kmp_bar_adaptive_candidates[KMP_BAR_ADAPTIVE_CANDIDATES] = {
+        bp_linear_bar, bp_tree_bar, bp_hyper_bar};
+
+#if KMP_ARCH_X86 || KMP_ARCH_X86_64
+#define __kmp_bar_adaptive_now() __kmp_hardware_timestamp()
+#else
+extern kmp_uint64 __kmp_now_nsec();
+#define __kmp_bar_adaptive_now() __kmp_now_nsec()
+#endif
+
+// Tells whether this barrier uses the pattern selected for its team. Split
+// barriers are released later by __kmp_end_split_barrier(), they keep the
+// pattern of the environment.
+static inline bool __kmp_barrier_is_adaptive(enum barrier_type bt,
+                                             int is_split) {
+  return __kmp_barrier_adaptive && bt == bs_plain_barrier && !is_split &&
+         __kmp_barrier_gather_pattern[bt] != bp_dist_bar;
+}
+
+static inline bool __kmp_bar_adaptive_usable(kmp_bar_pat_e pattern) {
+  // The tree and hyper patterns need branch bits
+  return pattern == bp_linear_bar ||
+         (__kmp_barrier_gather_branch_bits[bs_plain_barrier] &&
+          __kmp_barrier_release_branch_bits[bs_plain_barrier]);
+}
+
+// Called by the primary thread after the gather phase: the workers only read
+// the pattern when they enter a barrier, so a new one applies from the next
+// barrier on.
+static void __kmp_barrier_adaptive_select(kmp_team_t *team) {
+  kmp_bar_adaptive_t *state = &team->t.t_bar_adaptive;
+  if (state->nproc != team->t.t_nproc) {
+    // New team, or new size: start the measures over
+    state->nproc = team->t.t_nproc;
+    state->trial = 0;
+    state->samples = 0;
+    for (int i = 0; i < KMP_BAR_ADAPTIVE_CANDIDATES; ++i)
+      state->best[i] = ~(kmp_uint64)0;
+    state->pattern = __kmp_bar_adaptive_candidates[0];
+    return;
+  }
+  if (state->trial < 0 || state->samples < KMP_BAR_ADAPTIVE_SAMPLES)
+    return;
+  state->samples = 0;
+  do {
+    ++state->trial;
+  } while (state->trial < KMP_BAR_ADAPTIVE_CANDIDATES &&
+           !__kmp_bar_adaptive_usable(
+               __kmp_bar_adaptive_candidates[state->trial]));
+  if (state->trial < KMP_BAR_ADAPTIVE_CANDIDATES) {
+    state->pattern = __kmp_bar_adaptive_candidates[state->trial];
+    return;
+  }
+  int fastest = 0;
+  for (int i = 1; i < KMP_BAR_ADAPTIVE_CANDIDATES; ++i)
+    if (state->best[i] < state->best[fastest])
+      fastest = i;
+  state->trial = -1;
+  state->pattern = __kmp_bar_adaptive_candidates[fastest];
+  KA_TRACE(10, ("__kmp_barrier_adaptive_select: team %d of %d threads "
+                "selected the %s pattern\n",
+                team->t.t_id, state->nproc,
+                __kmp_barrier_pattern_name[state->pattern]));
+}
+
+// Called by the primary thread when it leaves a barrier it entered with the
+// given trial, at time start.
+static void __kmp_barrier_adaptive_sample(kmp_team_t *team, int trial,
+                                          kmp_uint64 start) {
+  kmp_bar_adaptive_t *state = &team->t.t_bar_adaptive;
+  // The barrier used the candidate being measured unless the trial changed
+  if (trial < 0 || trial != state->trial)
+    return;
+  kmp_uint64 elapsed = __kmp_bar_adaptive_now() - start;
+  if (elapsed < state->best[trial])
+    state->best[trial] = elapsed;
+  ++state->samples;
+}
+
 // Internal function to do a barrier.
 /* If is_split is true, do a split barrier, otherwise, do a plain barrier
    If reduce is non-NULL, do a split reduction barrier, otherwise, do a split
@@ -1818,6 +1907,19 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
       itt_sync_obj = __kmp_itt_barrier_object(gtid, bt, 1);
 #endif
 #endif /* USE_ITT_BUILD */
+    kmp_bar_pat_e gather_pattern = __kmp_barrier_gather_pattern[bt];
+    kmp_bar_pat_e release_pattern = __kmp_barrier_release_pattern[bt];
+    const bool adaptive =
+        !cancellable && __kmp_barrier_is_adaptive(bt, is_split);
+    int adaptive_trial = -1;
+    kmp_uint64 adaptive_start = 0;
+    if (adaptive) {
+      gather_pattern = release_pattern = team->t.t_bar_adaptive.pattern;
+      if (KMP_MASTER_TID(tid)) {
+        adaptive_trial = team->t.t_bar_adaptive.trial;
+        adaptive_start = __kmp_bar_adaptive_now();
+      }
+    }
     if (__kmp_tasking_mode == tskm_extra_barrier) {
       __kmp_tasking_barrier(team, this_thr, gtid);
       KA_TRACE(15,
@@ -1861,11 +1963,14 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
       // use 0 to only setup the current team if nthreads > 1
       __kmp_task_team_setup(this_thr, team, 0);
 
+#if KMP_STATS_ENABLED
+    tsc_tick_count gather_start = tsc_tick_count::now();
+#endif
     if (cancellable) {
       cancelled = __kmp_linear_barrier_gather_cancellable(
           bt, this_thr, gtid, tid, reduce USE_ITT_BUILD_ARG(itt_sync_obj));
     } else {
-      switch (__kmp_barrier_gather_pattern[bt]) {
+      switch (gather_pattern) {
       case bp_dist_bar: {
         __kmp_dist_barrier_gather(bt, this_thr, gtid, tid,
                                   reduce USE_ITT_BUILD_ARG(itt_sync_obj));
@@ -1897,10 +2002,17 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
       }
     }
 
+#if KMP_STATS_ENABLED
+    KMP_COUNT_VALUE(OMP_plain_barrier_gather,
+                    (tsc_tick_count::now() - gather_start).ticks());
+#endif
+
     KMP_MB();
 
     if (KMP_MASTER_TID(tid)) {
       status = 0;
+      if (adaptive)
+        __kmp_barrier_adaptive_select(team);
       if (__kmp_tasking_mode != tskm_immediate_exec && !cancelled) {
         __kmp_task_team_wait(this_thr, team USE_ITT_BUILD_ARG(itt_sync_obj));
       }
@@ -1979,11 +2091,14 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
 #endif /* USE_ITT_BUILD */
     }
     if ((status == 1 || !is_split) && !cancelled) {
+#if KMP_STATS_ENABLED
+      tsc_tick_count release_start = tsc_tick_count::now();
+#endif
       if (cancellable) {
         cancelled = __kmp_linear_barrier_release_cancellable(
             bt, this_thr, gtid, tid, FALSE USE_ITT_BUILD_ARG(itt_sync_obj));
       } else {
-        switch (__kmp_barrier_release_pattern[bt]) {
+        switch (release_pattern) {
         case bp_dist_bar: {
           KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
           __kmp_dist_barrier_release(bt, this_thr, gtid, tid,
@@ -2013,10 +2128,16 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
         }
         }
       }
+#if KMP_STATS_ENABLED
+      KMP_COUNT_VALUE(OMP_plain_barrier_release,
+                      (tsc_tick_count::now() - release_start).ticks());
+#endif
       if (__kmp_tasking_mode != tskm_immediate_exec && !cancelled) {
         __kmp_task_team_sync(this_thr, team);
       }
     }
+    if (adaptive && KMP_MASTER_TID(tid))
+      __kmp_barrier_adaptive_sample(team, adaptive_trial, adaptive_start);
 
 #if USE_ITT_BUILD
     /* GEH: TODO: Move this under if-condition above and also include in
@@ -1318,6 +1318,21 @@ static void __kmp_stg_print_task_stealing(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_task_stealing_constraint);
 } // __kmp_stg_print_task_stealing
 
+#if KMP_AFFINITY_SUPPORTED
+static void __kmp_stg_parse_task_steal_local_tries(char const *name,
+                                                   char const *value,
+                                                   void *data) {
+  __kmp_stg_parse_int(name, value, 0, KMP_MAX_NTH,
+                      &__kmp_task_steal_local_tries);
+} // __kmp_stg_parse_task_steal_local_tries
+
+static void __kmp_stg_print_task_steal_local_tries(kmp_str_buf_t *buffer,
+                                                   char const *name,
+                                                   void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_task_steal_local_tries);
+} // __kmp_stg_print_task_steal_local_tries
+#endif
+
 static void __kmp_stg_parse_max_active_levels(char const *name,
                                               char const *value, void *data) {
   kmp_uint64 tmp_dflt = 0;
@@ -1790,6 +1805,19 @@ static void __kmp_stg_print_barrier_pattern(kmp_str_buf_t *buffer,
   }
 } // __kmp_stg_print_barrier_pattern
 
+// -----------------------------------------------------------------------------
+// KMP_ADAPTIVE_BARRIER
+
+static void __kmp_stg_parse_barrier_adaptive(char const *name,
+                                             char const *value, void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_barrier_adaptive);
+} // __kmp_stg_parse_barrier_adaptive
+
+static void __kmp_stg_print_barrier_adaptive(kmp_str_buf_t *buffer,
+                                             char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_barrier_adaptive);
+} // __kmp_stg_print_barrier_adaptive
+
 // -----------------------------------------------------------------------------
 // KMP_ABORT_DELAY
 
@@ -5335,6 +5363,10 @@ static kmp_setting_t __kmp_stg_table[] = {
      0},
     {"KMP_TASK_STEALING_CONSTRAINT", __kmp_stg_parse_task_stealing,
      __kmp_stg_print_task_stealing, NULL, 0, 0},
+#if KMP_AFFINITY_SUPPORTED
+    {"KMP_TASK_STEAL_LOCAL_TRIES", __kmp_stg_parse_task_steal_local_tries,
+     __kmp_stg_print_task_steal_local_tries, NULL, 0, 0},
+#endif
     {"OMP_MAX_ACTIVE_LEVELS", __kmp_stg_parse_max_active_levels,
      __kmp_stg_print_max_active_levels, NULL, 0, 0},
     {"OMP_DEFAULT_DEVICE", __kmp_stg_parse_default_device,
@@ -5413,6 +5445,8 @@ static kmp_setting_t __kmp_stg_table[] = {
      __kmp_stg_print_barrier_branch_bit, NULL, 0, 0},
     {"KMP_PLAIN_BARRIER_PATTERN", __kmp_stg_parse_barrier_pattern,
      __kmp_stg_print_barrier_pattern, NULL, 0, 0},
+    {"KMP_ADAPTIVE_BARRIER", __kmp_stg_parse_barrier_adaptive,
+     __kmp_stg_print_barrier_adaptive, NULL, 0, 0},
     {"KMP_FORKJOIN_BARRIER", __kmp_stg_parse_barrier_branch_bit,
      __kmp_stg_print_barrier_branch_bit, NULL, 0, 0},
     {"KMP_FORKJOIN_BARRIER_PATTERN", __kmp_stg_parse_barrier_pattern,
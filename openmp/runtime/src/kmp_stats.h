@@ -160,6 +160,8 @@ enum stats_state_e {
   macro (OMP_task_plain_bar, 0, arg)                                           \
   macro (OMP_taskloop_scheduling, 0, arg)                                      \
   macro (OMP_plain_barrier, stats_flags_e::logEvent, arg)                      \
+  macro (OMP_plain_barrier_gather, 0, arg)                                     \
+  macro (OMP_plain_barrier_release, 0, arg)                                    \
   macro (OMP_idle, stats_flags_e::logEvent, arg)                               \
   macro (OMP_fork_barrier, stats_flags_e::logEvent, arg)                       \
   macro (OMP_join_barrier, stats_flags_e::logEvent, arg)                       \
@@ -216,6 +218,12 @@ enum stats_state_e {
 // OMP_plain_barrier      -- Time spent in a #pragma omp barrier construct or
 //                           inside implicit barrier at end of worksharing
 //                           construct
+// OMP_plain_barrier_gather -- Time a thread waits in the gather phase of a
+//                             barrier construct, for the threads it gathers to
+//                             arrive. The primary thread waits for all of them.
+// OMP_plain_barrier_release -- Time a thread spends in the release phase of a
+//                              barrier construct, waiting for its release and
+//                              then releasing the threads below it
 // OMP_idle               -- Time worker threads spend waiting for next
 //                           parallel region
 // OMP_fork_barrier       -- Time spent in a the fork barrier surrounding a
@@ -2868,6 +2868,33 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_select_victim: Pick a random thread other than tid to steal from.
+// When the thief is bound within a NUMA domain, a few more draws are made to
+// find a victim in the same domain, whose tasks are likely to use local memory.
+// A remote victim is still accepted after that, so that no thread starves.
+static inline kmp_int32 __kmp_select_victim(kmp_info_t *thread,
+                                            kmp_thread_data_t *threads_data,
+                                            kmp_int32 nthreads, kmp_int32 tid) {
+  kmp_int32 victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+  if (victim_tid >= tid) {
+    ++victim_tid; // Adjusts random distribution to exclude self
+  }
+#if KMP_AFFINITY_SUPPORTED
+  const int domain = thread->th.th_locality_domain;
+  if (domain < 0)
+    return victim_tid;
+  for (int i = 0; i < __kmp_task_steal_local_tries; ++i) {
+    if (threads_data[victim_tid].td.td_thr->th.th_locality_domain == domain)
+      break;
+    victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+    if (victim_tid >= tid) {
+      ++victim_tid;
+    }
+  }
+#endif
+  return victim_tid;
+}
+
 // __kmp_execute_tasks_template: Choose and execute tasks until either the
 // condition is statisfied (return true) or there are none left (return false).
 //
@@ -2937,10 +2964,8 @@ static inline int __kmp_execute_tasks_template(
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
             // and failed.  Arch says that's not such a great idea.
-            victim_tid = __kmp_get_random(thread) % (nthreads - 1);
-            if (victim_tid >= tid) {
-              ++victim_tid; // Adjusts random distribution to exclude self
-            }
+            victim_tid =
+                __kmp_select_victim(thread, threads_data, nthreads, tid);
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
             // There is a slight chance that __kmp_enable_tasking() did not wake
@@ -406,7 +406,18 @@ static void registerPollyPasses(llvm::legacy::PassManagerBase &PM,
     PM.add(llvm::createCFGPrinterLegacyPassPass());
 }
 
-static bool shouldEnablePollyForOptimization() { return PollyEnabled; }
+/// Returns whether Polly optimizes at \p OptLevel. Builds configured with
+/// POLLY_ENABLE_AT_O3 run Polly at -O3 unless -polly=false is given, the others
+/// only when -polly is given.
+static bool shouldEnablePollyForOptimization(unsigned OptLevel) {
+  if (PollyEnabled.getNumOccurrences())
+    return PollyEnabled;
+#ifdef POLLY_ENABLE_AT_O3
+  return OptLevel >= 3;
+#else
+  return false;
+#endif
+}
 
 static bool shouldEnablePollyForDiagnostic() {
   // FIXME: PollyTrackFailures is user-controlled, should not be set
@@ -424,7 +435,7 @@ registerPollyEarlyAsPossiblePasses(const llvm::PassManagerBuilder &Builder,
   if (PassPosition != POSITION_EARLY)
     return;
 
-  bool EnableForOpt = shouldEnablePollyForOptimization() &&
+  bool EnableForOpt = shouldEnablePollyForOptimization(Builder.OptLevel) &&
                       Builder.OptLevel >= 1 && Builder.SizeLevel == 0;
   if (!shouldEnablePollyForDiagnostic() && !EnableForOpt)
     return;
@@ -439,7 +450,7 @@ registerPollyLoopOptimizerEndPasses(const llvm::PassManagerBuilder &Builder,
   if (PassPosition != POSITION_AFTER_LOOPOPT)
     return;
 
-  bool EnableForOpt = shouldEnablePollyForOptimization() &&
+  bool EnableForOpt = shouldEnablePollyForOptimization(Builder.OptLevel) &&
                       Builder.OptLevel >= 1 && Builder.SizeLevel == 0;
   if (!shouldEnablePollyForDiagnostic() && !EnableForOpt)
     return;
@@ -455,7 +466,7 @@ registerPollyScalarOptimizerLatePasses(const llvm::PassManagerBuilder &Builder,
   if (PassPosition != POSITION_BEFORE_VECTORIZER)
     return;
 
-  bool EnableForOpt = shouldEnablePollyForOptimization() &&
+  bool EnableForOpt = shouldEnablePollyForOptimization(Builder.OptLevel) &&
                       Builder.OptLevel >= 1 && Builder.SizeLevel == 0;
   if (!shouldEnablePollyForDiagnostic() && !EnableForOpt)
     return;
@@ -576,7 +587,8 @@ static void buildCommonPollyPipeline(FunctionPassManager &PM,
 static void buildEarlyPollyPipeline(ModulePassManager &MPM,
                                     OptimizationLevel Level) {
   bool EnableForOpt =
-      shouldEnablePollyForOptimization() && Level.isOptimizingForSpeed();
+      shouldEnablePollyForOptimization(Level.getSpeedupLevel()) &&
+      Level.isOptimizingForSpeed();
   if (!shouldEnablePollyForDiagnostic() && !EnableForOpt)
     return;
 
@@ -605,7 +617,8 @@ static void buildEarlyPollyPipeline(ModulePassManager &MPM,
 static void buildLatePollyPipeline(FunctionPassManager &PM,
                                    OptimizationLevel Level) {
   bool EnableForOpt =
-      shouldEnablePollyForOptimization() && Level.isOptimizingForSpeed();
+      shouldEnablePollyForOptimization(Level.getSpeedupLevel()) &&
+      Level.isOptimizingForSpeed();
   if (!shouldEnablePollyForDiagnostic() && !EnableForOpt)
     return;
 
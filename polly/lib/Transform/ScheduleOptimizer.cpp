@@ -52,6 +52,8 @@
 #include "polly/MatmulOptimizer.h"
 #include "polly/Options.h"
 #include "polly/ScheduleTreeTransform.h"
+#include "polly/ScopDetectionDiagnostic.h"
+#include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLOStream.h"
 #include "polly/Support/ISLTools.h"
 #include "llvm/ADT/Sequence.h"
@@ -59,6 +61,7 @@
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Timer.h"
 #include "isl/options.h"
 
 using namespace llvm;
@@ -197,8 +200,17 @@ static cl::opt<bool> OptimizedScops(
              "transformations is applied on the schedule tree"),
     cl::init(false), cl::ZeroOrMore, cl::cat(PollyCategory));
 
+static cl::opt<int> ScheduleComputeOut(
+    "polly-schedule-computeout",
+    cl::desc("Bound the scheduler of each SCoP by a maximal amount of "
+             "computational steps, keeping the original schedule of the SCoPs "
+             "which exceed it (0 means no bound)"),
+    cl::Hidden, cl::init(300000), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 STATISTIC(ScopsProcessed, "Number of scops processed");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
+STATISTIC(ScopsScheduleOutOfQuota,
+          "Number of scops whose rescheduling exceeded the computeout");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
 
 STATISTIC(NumAffineLoopsOptimized, "Number of affine loops optimized");
@@ -842,9 +854,32 @@ static bool runIslScheduleOptimizer(
     SC = SC.set_proximity(Proximity);
     SC = SC.set_validity(Validity);
     SC = SC.set_coincidence(Validity);
-    Schedule = SC.compute_schedule();
+    bool OutOfQuota;
+    {
+      NamedRegionTimer T("compute-schedule", "Compute the isl schedule",
+                         "polly", "Polly", TimePassesIsEnabled);
+      IslMaxOperationsGuard MaxOpGuard(Ctx, ScheduleComputeOut);
+      Schedule = SC.compute_schedule();
+      OutOfQuota = MaxOpGuard.hasQuotaExceeded();
+    }
     isl_options_set_on_error(Ctx, OnErrorStatus);
 
+    if (OutOfQuota) {
+      // Keep the original schedule, which the code generator still uses.
+      ScopsScheduleOutOfQuota++;
+      LLVM_DEBUG(
+          dbgs() << "Schedule optimizer calculation exceeds ISL quota\n");
+      if (ORE) {
+        DebugLoc Begin, End;
+        getDebugLocations(getBBPairForRegion(&S.getRegion()), Begin, End);
+        ORE->emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "OutOfQuota", Begin,
+                                             S.getEntry())
+                  << "maximal number of operations exceeded during "
+                     "rescheduling, keeping the original schedule");
+      }
+      return false;
+    }
+
     ScopsRescheduled++;
     LLVM_DEBUG(printSchedule(dbgs(), Schedule, "After rescheduling"));
   }
@@ -870,6 +905,9 @@ static bool runIslScheduleOptimizer(
       /*Postopts=*/!HasUserTransformation && EnablePostopts,
       /*Prevect=*/PollyVectorizerChoice != VECTORIZER_NONE};
   if (OAI.PatternOpts || OAI.Postopts || OAI.Prevect) {
+    NamedRegionTimer T("post-optimizations",
+                       "Apply the post-rescheduling optimizations", "polly",
+                       "Polly", TimePassesIsEnabled);
     Schedule = ScheduleTreeOptimizer::optimizeSchedule(Schedule, &OAI);
     Schedule = hoistExtensionNodes(Schedule);
     LLVM_DEBUG(printSchedule(dbgs(), Schedule, "After post-optimizations"));
@@ -39,11 +39,16 @@ struct __tbb_backend_tag
 struct __openmp_backend_tag
 {
 };
+struct __std_thread_backend_tag
+{
+};
 
 #if defined(_PSTL_PAR_BACKEND_TBB)
 using __par_backend_tag = __tbb_backend_tag;
 #elif defined(_PSTL_PAR_BACKEND_OPENMP)
 using __par_backend_tag = __openmp_backend_tag;
+#elif defined(_PSTL_PAR_BACKEND_STD_THREAD)
+using __par_backend_tag = __std_thread_backend_tag;
 #elif defined(_PSTL_PAR_BACKEND_SERIAL)
 using __par_backend_tag = __serial_backend_tag;
 #else
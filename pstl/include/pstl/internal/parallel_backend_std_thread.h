@@ -0,0 +1,649 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_STD_THREAD_H
+#define _PSTL_PARALLEL_BACKEND_STD_THREAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "parallel_backend_utils.h"
+#include "pstl_config.h"
+
+// A parallel backend with no dependency but the standard library: a pool of
+// std::thread workers, created on first use, runs the tasks forked by the
+// algorithms. A thread waiting for a task to complete runs the pending tasks in
+// the meantime, so nested parallel algorithms don't deadlock or oversubscribe.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __std_thread_backend
+{
+
+//! Raw memory buffer with automatic freeing and no exceptions.
+template <typename _Tp>
+class __buffer
+{
+    std::allocator<_Tp> __allocator_;
+    _Tp* __ptr_;
+    const std::size_t __buf_size_;
+    __buffer(const __buffer&) = delete;
+    void
+    operator=(const __buffer&) = delete;
+
+  public:
+    __buffer(std::size_t __n) : __allocator_(), __ptr_(__allocator_.allocate(__n)), __buf_size_(__n) {}
+
+    operator bool() const { return __ptr_ != nullptr; }
+    _Tp*
+    get() const
+    {
+        return __ptr_;
+    }
+    ~__buffer() { __allocator_.deallocate(__ptr_, __buf_size_); }
+};
+
+inline void
+__cancel_execution()
+{
+}
+
+//------------------------------------------------------------------------
+// thread pool
+//------------------------------------------------------------------------
+
+class __task
+{
+    std::atomic<bool> __done_{false};
+    std::exception_ptr __exception_;
+
+  protected:
+    ~__task() = default;
+    virtual void
+    __execute() = 0;
+
+  public:
+    void
+    __run() noexcept
+    {
+        try
+        {
+            __execute();
+        }
+        catch (...)
+        {
+            __exception_ = std::current_exception();
+        }
+        __done_.store(true, std::memory_order_release);
+    }
+
+    bool
+    __is_done() const
+    {
+        return __done_.load(std::memory_order_acquire);
+    }
+
+    void
+    __rethrow_exception() const
+    {
+        if (__exception_)
+            std::rethrow_exception(__exception_);
+    }
+};
+
+template <typename _Fp>
+class __task_impl final : public __task
+{
+    _Fp& __f_;
+
+    void
+    __execute() override
+    {
+        __f_();
+    }
+
+  public:
+    explicit __task_impl(_Fp& __f) : __f_(__f) {}
+};
+
+class __thread_pool
+{
+    std::mutex __mutex_;
+    std::condition_variable __cv_;
+    // The tasks which are not running yet. The workers take the oldest ones,
+    // which are the largest, and the waiting threads the newest ones, which are
+    // most likely their own.
+    std::deque<__task*> __queue_;
+    bool __stop_ = false;
+    std::vector<std::thread> __workers_;
+
+    void
+    __work()
+    {
+        for (;;)
+        {
+            __task* __t;
+            {
+                std::unique_lock<std::mutex> __lock(__mutex_);
+                __cv_.wait(__lock, [this] { return __stop_ || !__queue_.empty(); });
+                if (__queue_.empty())
+                    return;
+                __t = __queue_.front();
+                __queue_.pop_front();
+            }
+            __t->__run();
+        }
+    }
+
+    __thread_pool()
+    {
+        // The threads calling the algorithms take part in the work.
+        const unsigned __n = std::thread::hardware_concurrency();
+        for (unsigned __i = 1; __i < __n; ++__i)
+            __workers_.emplace_back([this] { __work(); });
+    }
+
+  public:
+    ~__thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __stop_ = true;
+        }
+        __cv_.notify_all();
+        for (auto& __worker : __workers_)
+            __worker.join();
+    }
+
+    static __thread_pool&
+    __instance()
+    {
+        static __thread_pool __pool;
+        return __pool;
+    }
+
+    std::size_t
+    __num_threads() const
+    {
+        return __workers_.size() + 1;
+    }
+
+    void
+    __submit(__task& __t)
+    {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __queue_.push_back(&__t);
+        }
+        __cv_.notify_one();
+    }
+
+    //! Run the pending tasks until __t completes.
+    void
+    __wait(__task& __t)
+    {
+        while (!__t.__is_done())
+        {
+            __task* __other = nullptr;
+            {
+                std::lock_guard<std::mutex> __lock(__mutex_);
+                if (!__queue_.empty())
+                {
+                    __other = __queue_.back();
+                    __queue_.pop_back();
+                }
+            }
+            if (__other)
+                __other->__run();
+            else
+                std::this_thread::yield();
+        }
+    }
+};
+
+//! Evaluate __f1 and __f2, in parallel if a worker is available.
+template <typename _F1, typename _F2>
+void
+__invoke(_F1&& __f1, _F2&& __f2)
+{
+    __thread_pool& __pool = __thread_pool::__instance();
+    __task_impl<std::remove_reference_t<_F2>> __t(__f2);
+    __pool.__submit(__t);
+    // __t refers to this frame: it must complete before leaving it.
+    try
+    {
+        __f1();
+    }
+    catch (...)
+    {
+        __pool.__wait(__t);
+        throw;
+    }
+    __pool.__wait(__t);
+    __t.__rethrow_exception();
+}
+
+// The minimal sizes of the ranges sorted and merged by the leaf functions.
+constexpr std::size_t __stable_sort_cut_off = 500;
+constexpr std::size_t __merge_cut_off = 2000;
+
+//! Whether the work is better done by the calling thread only.
+inline bool
+__run_serial()
+{
+    return __thread_pool::__instance().__num_threads() == 1;
+}
+
+//! The size of the ranges which are not split any further, to give each
+//! thread a few of them for load balancing.
+inline std::size_t
+__grain_size(std::size_t __n, std::size_t __min_grain = 1)
+{
+    const std::size_t __leaves = 4 * __thread_pool::__instance().__num_threads();
+    return std::max(__min_grain, (__n + __leaves - 1) / __leaves);
+}
+
+//------------------------------------------------------------------------
+// parallel_for
+//------------------------------------------------------------------------
+
+template <class _Index, class _Fp>
+void
+__parallel_for_body(_Index __first, _Index __last, _Fp& __f, std::size_t __grain)
+{
+    const std::size_t __n = __last - __first;
+    if (__n <= __grain)
+    {
+        __f(__first, __last);
+        return;
+    }
+    const _Index __mid = __first + __n / 2;
+    __std_thread_backend::__invoke([&] { __std_thread_backend::__parallel_for_body(__first, __mid, __f, __grain); },
+                                   [&] { __std_thread_backend::__parallel_for_body(__mid, __last, __f, __grain); });
+}
+
+template <class _ExecutionPolicy, class _Index, class _Fp>
+void
+__parallel_for(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __first, _Index __last,
+               _Fp __f)
+{
+    if (__first == __last)
+        return;
+    if (__std_thread_backend::__run_serial())
+    {
+        __f(__first, __last);
+        return;
+    }
+    __std_thread_backend::__parallel_for_body(__first, __last, __f,
+                                              __std_thread_backend::__grain_size(__last - __first));
+}
+
+//------------------------------------------------------------------------
+// parallel_reduce
+//------------------------------------------------------------------------
+
+template <class _Value, class _Index, typename _RealBody, typename _Reduction>
+_Value
+__parallel_reduce_body(_Index __first, _Index __last, const _Value& __identity, const _RealBody& __real_body,
+                       const _Reduction& __reduction, std::size_t __grain)
+{
+    const std::size_t __n = __last - __first;
+    if (__n <= __grain)
+        return __real_body(__first, __last, __identity);
+    const _Index __mid = __first + __n / 2;
+    std::optional<_Value> __left, __right;
+    __std_thread_backend::__invoke(
+        [&] {
+            __left.emplace(__std_thread_backend::__parallel_reduce_body(__first, __mid, __identity, __real_body,
+                                                                        __reduction, __grain));
+        },
+        [&] {
+            __right.emplace(__std_thread_backend::__parallel_reduce_body(__mid, __last, __identity, __real_body,
+                                                                         __reduction, __grain));
+        });
+    return __reduction(std::move(*__left), std::move(*__right));
+}
+
+template <class _ExecutionPolicy, class _Value, class _Index, typename _RealBody, typename _Reduction>
+_Value
+__parallel_reduce(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __first, _Index __last,
+                  const _Value& __identity, const _RealBody& __real_body, const _Reduction& __reduction)
+{
+    if (__first == __last)
+        return __identity;
+    if (__std_thread_backend::__run_serial())
+        return __real_body(__first, __last, __identity);
+    return __std_thread_backend::__parallel_reduce_body(__first, __last, __identity, __real_body, __reduction,
+                                                        __std_thread_backend::__grain_size(__last - __first));
+}
+
+//------------------------------------------------------------------------
+// parallel_transform_reduce
+//
+// Notation:
+//      r(i,j,init) returns reduction of init with reduction over [i,j)
+//      u(i) returns f(i,i+1,identity) for a hypothetical left identity element
+//      of r c(x,y) combines values x and y that were the result of r or u.
+//------------------------------------------------------------------------
+
+template <class _Index, class _Up, class _Tp, class _Cp, class _Rp>
+_Tp
+__parallel_transform_reduce_body(_Index __first, _Index __last, _Up& __u, _Tp __init, _Cp& __combine,
+                                 _Rp& __brick_reduce, std::size_t __grain)
+{
+    const std::size_t __n = __last - __first;
+    if (__n <= __grain)
+        return __brick_reduce(__first, __last, __init);
+    const _Index __mid = __first + __n / 2;
+    std::optional<_Tp> __left, __right;
+    __std_thread_backend::__invoke(
+        [&] {
+            __left.emplace(__std_thread_backend::__parallel_transform_reduce_body(
+                __first, __mid, __u, std::move(__init), __combine, __brick_reduce, __grain));
+        },
+        [&] {
+            // The right part starts from its first transformed element.
+            __right.emplace(__std_thread_backend::__parallel_transform_reduce_body(
+                __mid + 1, __last, __u, __u(__mid), __combine, __brick_reduce, __grain));
+        });
+    return __combine(std::move(*__left), std::move(*__right));
+}
+
+template <class _ExecutionPolicy, class _Index, class _Up, class _Tp, class _Cp, class _Rp>
+_Tp
+__parallel_transform_reduce(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __first,
+                            _Index __last, _Up __u, _Tp __init, _Cp __combine, _Rp __brick_reduce)
+{
+    if (__std_thread_backend::__run_serial())
+        return __brick_reduce(__first, __last, __init);
+    return __std_thread_backend::__parallel_transform_reduce_body(
+        __first, __last, __u, std::move(__init), __combine, __brick_reduce,
+        __std_thread_backend::__grain_size(__last - __first));
+}
+
+//------------------------------------------------------------------------
+// parallel_scan
+//
+// The range is split in blocks: their sums are computed in parallel, then
+// prefixed serially, and the blocks are scanned in parallel from their prefix.
+//------------------------------------------------------------------------
+
+template <typename _Index>
+struct __scan_blocks
+{
+    _Index __n_;
+    _Index __size_;
+    _Index __count_;
+
+    explicit __scan_blocks(_Index __n)
+        : __n_(__n), __size_(static_cast<_Index>(__std_thread_backend::__grain_size(__n))),
+          __count_((__n + __size_ - 1) / __size_)
+    {
+    }
+
+    _Index
+    __begin(_Index __block) const
+    {
+        return __block * __size_;
+    }
+
+    _Index
+    __length(_Index __block) const
+    {
+        return std::min(__size_, __n_ - __begin(__block));
+    }
+};
+
+template <class _ExecutionPolicy, typename _Index, typename _Tp, typename _Rp, typename _Cp, typename _Sp,
+          typename _Ap>
+void
+__parallel_strict_scan(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __n, _Tp __initial,
+                       _Rp __reduce, _Cp __combine, _Sp __scan, _Ap __apex)
+{
+    if (__n <= 1 || __std_thread_backend::__run_serial())
+    {
+        _Tp __sum = __initial;
+        if (__n)
+            __sum = __combine(__sum, __reduce(_Index(0), __n));
+        __apex(__sum);
+        if (__n)
+            __scan(_Index(0), __n, __initial);
+        return;
+    }
+
+    const __scan_blocks<_Index> __blocks(__n);
+    std::vector<std::optional<_Tp>> __prefixes(__blocks.__count_);
+    auto __reduce_blocks = [&](_Index __i, _Index __j) {
+        for (; __i != __j; ++__i)
+            __prefixes[__i].emplace(__reduce(__blocks.__begin(__i), __blocks.__length(__i)));
+    };
+    __std_thread_backend::__parallel_for_body(_Index(0), __blocks.__count_, __reduce_blocks, 1);
+
+    _Tp __sum = __initial;
+    for (auto& __prefix : __prefixes)
+    {
+        _Tp __next = __combine(__sum, std::move(*__prefix));
+        *__prefix = std::move(__sum);
+        __sum = std::move(__next);
+    }
+    __apex(__sum);
+
+    auto __scan_blocks = [&](_Index __i, _Index __j) {
+        for (; __i != __j; ++__i)
+            __scan(__blocks.__begin(__i), __blocks.__length(__i), *__prefixes[__i]);
+    };
+    __std_thread_backend::__parallel_for_body(_Index(0), __blocks.__count_, __scan_blocks, 1);
+}
+
+template <class _ExecutionPolicy, class _Index, class _Up, class _Tp, class _Cp, class _Rp, class _Sp>
+_Tp
+__parallel_transform_scan(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __n, _Up __u,
+                          _Tp __init, _Cp __combine, _Rp __brick_reduce, _Sp __scan)
+{
+    if (__n <= 1 || __std_thread_backend::__run_serial())
+        return __scan(_Index(0), __n, __init);
+
+    const __scan_blocks<_Index> __blocks(__n);
+    // The sum of the last block is not needed to compute the prefixes.
+    std::vector<std::optional<_Tp>> __prefixes(__blocks.__count_);
+    auto __reduce_blocks = [&](_Index __i, _Index __j) {
+        for (; __i != __j; ++__i)
+        {
+            const _Index __begin = __blocks.__begin(__i);
+            __prefixes[__i + 1].emplace(__brick_reduce(__begin + 1, __begin + __blocks.__length(__i), __u(__begin)));
+        }
+    };
+    __std_thread_backend::__parallel_for_body(_Index(0), __blocks.__count_ - 1, __reduce_blocks, 1);
+
+    __prefixes[0].emplace(std::move(__init));
+    for (_Index __i = 1; __i < __blocks.__count_; ++__i)
+        __prefixes[__i] = __combine(*__prefixes[__i - 1], std::move(*__prefixes[__i]));
+
+    // Only the sum of the last block is returned.
+    std::optional<_Tp> __result;
+    auto __scan_blocks = [&](_Index __i, _Index __j) {
+        for (; __i != __j; ++__i)
+        {
+            const _Index __begin = __blocks.__begin(__i);
+            _Tp __sum = __scan(__begin, __begin + __blocks.__length(__i), std::move(*__prefixes[__i]));
+            if (__i == __blocks.__count_ - 1)
+                __result.emplace(std::move(__sum));
+        }
+    };
+    __std_thread_backend::__parallel_for_body(_Index(0), __blocks.__count_, __scan_blocks, 1);
+    return std::move(*__result);
+}
+
+//------------------------------------------------------------------------
+// parallel_merge
+//------------------------------------------------------------------------
+
+template <typename _RandomAccessIterator1, typename _RandomAccessIterator2, typename _RandomAccessIterator3,
+          typename _Compare, typename _LeafMerge>
+void
+__parallel_merge_body(_RandomAccessIterator1 __xs, _RandomAccessIterator1 __xe, _RandomAccessIterator2 __ys,
+                      _RandomAccessIterator2 __ye, _RandomAccessIterator3 __zs, _Compare __comp,
+                      _LeafMerge& __leaf_merge, std::size_t __grain)
+{
+    const std::size_t __size_x = __xe - __xs;
+    const std::size_t __size_y = __ye - __ys;
+    if (__size_x + __size_y <= __grain)
+    {
+        __leaf_merge(__xs, __xe, __ys, __ye, __zs, __comp);
+        return;
+    }
+
+    // Split the larger range in the middle, and the other one at the same
+    // value, keeping the elements of the first range first for stability.
+    _RandomAccessIterator1 __xm;
+    _RandomAccessIterator2 __ym;
+    if (__size_x < __size_y)
+    {
+        __ym = __ys + __size_y / 2;
+        __xm = std::upper_bound(__xs, __xe, *__ym, __comp);
+    }
+    else
+    {
+        __xm = __xs + __size_x / 2;
+        __ym = std::lower_bound(__ys, __ye, *__xm, __comp);
+    }
+    const _RandomAccessIterator3 __zm = __zs + (__xm - __xs) + (__ym - __ys);
+    __std_thread_backend::__invoke(
+        [&] {
+            __std_thread_backend::__parallel_merge_body(__xs, __xm, __ys, __ym, __zs, __comp, __leaf_merge, __grain);
+        },
+        [&] {
+            __std_thread_backend::__parallel_merge_body(__xm, __xe, __ym, __ye, __zm, __comp, __leaf_merge, __grain);
+        });
+}
+
+template <class _ExecutionPolicy, typename _RandomAccessIterator1, typename _RandomAccessIterator2,
+          typename _RandomAccessIterator3, typename _Compare, typename _LeafMerge>
+void
+__parallel_merge(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _RandomAccessIterator1 __xs,
+                 _RandomAccessIterator1 __xe, _RandomAccessIterator2 __ys, _RandomAccessIterator2 __ye,
+                 _RandomAccessIterator3 __zs, _Compare __comp, _LeafMerge __leaf_merge)
+{
+    const std::size_t __n = (__xe - __xs) + (__ye - __ys);
+    if (__std_thread_backend::__run_serial())
+    {
+        __leaf_merge(__xs, __xe, __ys, __ye, __zs, __comp);
+        return;
+    }
+    __std_thread_backend::__parallel_merge_body(__xs, __xe, __ys, __ye, __zs, __comp, __leaf_merge,
+                                                __std_thread_backend::__grain_size(__n, __merge_cut_off));
+}
+
+//------------------------------------------------------------------------
+// parallel_stable_sort
+//
+// Merge sort: the sorted halves are merged into raw memory, then moved back.
+//------------------------------------------------------------------------
+
+template <typename _RandomAccessIterator, typename _Compare, typename _LeafSort>
+void
+__parallel_stable_sort_body(_RandomAccessIterator __xs, _RandomAccessIterator __xe,
+                            typename std::iterator_traits<_RandomAccessIterator>::value_type* __zs, _Compare __comp,
+                            _LeafSort& __leaf_sort, std::size_t __grain)
+{
+    using _ValueType = typename std::iterator_traits<_RandomAccessIterator>::value_type;
+
+    const std::size_t __n = __xe - __xs;
+    if (__n <= __grain)
+    {
+        __leaf_sort(__xs, __xe, __comp);
+        return;
+    }
+    const _RandomAccessIterator __xm = __xs + __n / 2;
+    __std_thread_backend::__invoke(
+        [&] { __std_thread_backend::__parallel_stable_sort_body(__xs, __xm, __zs, __comp, __leaf_sort, __grain); },
+        [&] {
+            __std_thread_backend::__parallel_stable_sort_body(__xm, __xe, __zs + (__xm - __xs), __comp, __leaf_sort,
+                                                              __grain);
+        });
+
+    auto __move_value_construct = [](_RandomAccessIterator __x, _ValueType* __z) {
+        ::new (__z) _ValueType(std::move(*__x));
+    };
+    auto __move_range_construct = [](_RandomAccessIterator __first, _RandomAccessIterator __last, _ValueType* __z) {
+        for (; __first != __last; ++__first, ++__z)
+            ::new (__z) _ValueType(std::move(*__first));
+        return __z;
+    };
+    auto __leaf_merge = [&](_RandomAccessIterator __as, _RandomAccessIterator __ae, _RandomAccessIterator __bs,
+                            _RandomAccessIterator __be, _ValueType* __cs, _Compare __cmp) {
+        __utils::__serial_move_merge(__ae - __as + __be - __bs)(__as, __ae, __bs, __be, __cs, __cmp,
+                                                                __move_value_construct, __move_value_construct,
+                                                                __move_range_construct, __move_range_construct);
+    };
+    const std::size_t __merge_grain = std::max(__merge_cut_off, __grain);
+    __std_thread_backend::__parallel_merge_body(__xs, __xm, __xm, __xe, __zs, __comp, __leaf_merge, __merge_grain);
+
+    auto __move_back = [&](std::size_t __i, std::size_t __j) {
+        std::move(__zs + __i, __zs + __j, __xs + __i);
+        __utils::__serial_destroy()(__zs + __i, __zs + __j);
+    };
+    __std_thread_backend::__parallel_for_body(std::size_t(0), __n, __move_back, __merge_grain);
+}
+
+template <class _ExecutionPolicy, typename _RandomAccessIterator, typename _Compare, typename _LeafSort>
+void
+__parallel_stable_sort(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _RandomAccessIterator __xs,
+                       _RandomAccessIterator __xe, _Compare __comp, _LeafSort __leaf_sort, std::size_t __nsort = 0)
+{
+    using _ValueType = typename std::iterator_traits<_RandomAccessIterator>::value_type;
+
+    const std::size_t __n = __xe - __xs;
+    // A partial sort is done by the leaf sort on the whole range.
+    if (__n <= __stable_sort_cut_off || (__nsort != 0 && __nsort < __n) || __std_thread_backend::__run_serial())
+    {
+        __leaf_sort(__xs, __xe, __comp);
+        return;
+    }
+    __buffer<_ValueType> __buf(__n);
+    __std_thread_backend::__parallel_stable_sort_body(__xs, __xe, __buf.get(), __comp, __leaf_sort,
+                                                      __std_thread_backend::__grain_size(__n, __stable_sort_cut_off));
+}
+
+//------------------------------------------------------------------------
+// parallel_invoke
+//------------------------------------------------------------------------
+
+template <class _ExecutionPolicy, typename _F1, typename _F2>
+void
+__parallel_invoke(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _F1&& __f1, _F2&& __f2)
+{
+    if (__std_thread_backend::__run_serial())
+    {
+        std::forward<_F1>(__f1)();
+        std::forward<_F2>(__f2)();
+        return;
+    }
+    __std_thread_backend::__invoke(std::forward<_F1>(__f1), std::forward<_F2>(__f2));
+}
+
+} // namespace __std_thread_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_PARALLEL_BACKEND_STD_THREAD_H */